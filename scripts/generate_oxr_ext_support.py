@@ -45,11 +45,13 @@ EXTENSIONS = (
     ['XR_KHR_D3D12_enable', 'XR_USE_GRAPHICS_API_D3D12'],
     ['XR_KHR_loader_init', 'XR_USE_PLATFORM_ANDROID'],
     ['XR_KHR_loader_init_android', 'OXR_HAVE_KHR_loader_init', 'XR_USE_PLATFORM_ANDROID'],
+    ['XR_KHR_locate_spaces'],
     ['XR_KHR_opengl_enable', 'XR_USE_GRAPHICS_API_OPENGL'],
     ['XR_KHR_opengl_es_enable', 'XR_USE_GRAPHICS_API_OPENGL_ES'],
     ['XR_KHR_swapchain_usage_input_attachment_bit'],
     ['XR_KHR_vulkan_enable', 'XR_USE_GRAPHICS_API_VULKAN'],
     ['XR_KHR_vulkan_enable2', 'XR_USE_GRAPHICS_API_VULKAN'],
+    ['XR_KHR_vulkan_swapchain_format_list', 'XR_USE_GRAPHICS_API_VULKAN'],
     ['XR_KHR_win32_convert_performance_counter_time', 'XR_USE_PLATFORM_WIN32'],
     ['XR_EXT_debug_utils', 'XRT_FEATURE_OPENXR_DEBUG_UTILS'],
     ['XR_EXT_dpad_binding'],
@@ -58,13 +60,26 @@ EXTENSIONS = (
     ['XR_EXT_hand_tracking'],
     ['XR_EXT_hp_mixed_reality_controller'],
     ['XR_EXT_palm_pose', 'ALWAYS_DISABLED'],
+    ['XR_EXT_performance_settings'],
     ['XR_EXT_samsung_odyssey_controller'],
+    ['XR_FB_composition_layer_settings'],
     ['XR_FB_display_refresh_rate'],
+    ['XR_FB_foveation', 'XR_USE_GRAPHICS_API_VULKAN'],
+    ['XR_FB_foveation_configuration', 'XR_USE_GRAPHICS_API_VULKAN'],
+    ['XR_FB_foveation_vulkan', 'XR_USE_GRAPHICS_API_VULKAN'],
+    ['XR_FB_haptic_pcm'],
+    ['XR_FB_passthrough'],
+    ['XR_FB_space_warp', 'XRT_FEATURE_OPENXR_LAYER_DEPTH'],
+    ['XR_FB_swapchain_update_state'],
+    ['XR_META_foveation_eye_tracked', 'XR_USE_GRAPHICS_API_VULKAN'],
+    ['XR_META_recommended_layer_resolution'],
     ['XR_ML_ml2_controller_interaction'],
     ['XR_MND_headless'],
     ['XR_MND_swapchain_usage_input_attachment_bit'],
     ['XR_MSFT_hand_interaction', 'ALWAYS_DISABLED'],
     ['XR_OPPO_controller_interaction'],
+    ['XR_VARJO_foveated_rendering'],
+    ['XR_VARJO_quad_views'],
     ['XR_EXTX_overlay'],
     ['XR_HTCX_vive_tracker_interaction', 'ALWAYS_DISABLED'],
     ['XR_MNDX_ball_on_a_stick_controller'],
@@ -147,6 +147,7 @@ def get_device_cmds():
         Cmd("vkImportSemaphoreWin32HandleKHR", requires=("VK_USE_PLATFORM_WIN32_KHR",)),
         None,
         Cmd("vkGetMemoryFdKHR", requires=("!defined(VK_USE_PLATFORM_WIN32_KHR)",)),
+        Cmd("vkGetMemoryFdPropertiesKHR", requires=("!defined(VK_USE_PLATFORM_WIN32_KHR)",)),
         Cmd("vkGetFenceFdKHR", requires=("!defined(VK_USE_PLATFORM_WIN32_KHR)",)),
         Cmd("vkGetSemaphoreFdKHR", requires=("!defined(VK_USE_PLATFORM_WIN32_KHR)",)),
         Cmd("vkImportFenceFdKHR", requires=("!defined(VK_USE_PLATFORM_WIN32_KHR)",)),
@@ -213,6 +214,11 @@ def get_instance_cmds():
             requires=("VK_EXT_calibrated_timestamps",),
         ),
         None,
+        Cmd(
+            "vkGetPhysicalDeviceFragmentShadingRatesKHR",
+            requires=("VK_KHR_fragment_shading_rate",),
+        ),
+        None,
         Cmd(
             "vkCreateDisplayPlaneSurfaceKHR", requires=("VK_USE_PLATFORM_DISPLAY_KHR",)
         ),
@@ -267,6 +273,7 @@ DEVICE_EXTENSIONS_TO_CHECK = [
     "VK_KHR_external_fence_fd",
     "VK_KHR_external_semaphore_fd",
     "VK_KHR_format_feature_flags2",
+    "VK_KHR_fragment_shading_rate",
     "VK_KHR_global_priority",
     "VK_KHR_image_format_list",
     "VK_KHR_maintenance1",
@@ -0,0 +1,64 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Preview header for XR_META_recommended_layer_resolution extension
+ * @author agent <agent@local>
+ * @ingroup external_openxr
+ */
+#ifndef XR_META_RECOMMENDED_LAYER_RESOLUTION_H
+#define XR_META_RECOMMENDED_LAYER_RESOLUTION_H 1
+
+#include <openxr/openxr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Newer OpenXR headers already have this extension.
+#ifndef XR_META_recommended_layer_resolution
+
+#define XR_META_recommended_layer_resolution 1
+#define XR_META_recommended_layer_resolution_SPEC_VERSION 1
+#define XR_META_RECOMMENDED_LAYER_RESOLUTION_EXTENSION_NAME "XR_META_recommended_layer_resolution"
+
+#define XR_TYPE_RECOMMENDED_LAYER_RESOLUTION_META ((XrStructureType)1000254000U)
+#define XR_TYPE_RECOMMENDED_LAYER_RESOLUTION_GET_INFO_META ((XrStructureType)1000254001U)
+
+typedef struct XrRecommendedLayerResolutionMETA
+{
+	XrStructureType type;
+	void *XR_MAY_ALIAS next;
+	XrExtent2Di recommendedImageDimensions;
+	XrBool32 isValid;
+} XrRecommendedLayerResolutionMETA;
+
+typedef struct XrRecommendedLayerResolutionGetInfoMETA
+{
+	XrStructureType type;
+	const void *XR_MAY_ALIAS next;
+	const XrCompositionLayerBaseHeader *layer;
+	XrTime predictedDisplayTime;
+} XrRecommendedLayerResolutionGetInfoMETA;
+
+typedef XrResult(XRAPI_PTR *PFN_xrGetRecommendedLayerResolutionMETA)(
+    XrSession session,
+    const XrRecommendedLayerResolutionGetInfoMETA *info,
+    XrRecommendedLayerResolutionMETA *resolution);
+
+#ifndef XR_NO_PROTOTYPES
+#ifdef XR_EXTENSION_PROTOTYPES
+XRAPI_ATTR XrResult XRAPI_CALL
+xrGetRecommendedLayerResolutionMETA(XrSession session,
+                                    const XrRecommendedLayerResolutionGetInfoMETA *info,
+                                    XrRecommendedLayerResolutionMETA *resolution);
+#endif /* XR_EXTENSION_PROTOTYPES */
+#endif /* !XR_NO_PROTOTYPES */
+
+#endif // XR_META_recommended_layer_resolution
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -518,12 +518,42 @@ def generate_verify_functions(f, profile):
     write_verify_func(f, profile, "dpad_emulators_by_length", "_dpad_emulator")
 
 
+def write_name_enum_lookup(f, enum_name, arg_name, sorted_names, fallback):
+    """Generate a string to enum function that binary searches a sorted table."""
+    f.write(f'static const struct {{ const char *str; enum {enum_name} value; }} {enum_name}_lookup[] = {{\n')
+    for name in sorted_names:
+        f.write(f'\t{{"{name}", {name}}},\n')
+    f.write('};\n\n')
+
+    f.write(f'enum {enum_name}\n')
+    f.write(f'{enum_name}_enum(const char *{arg_name})\n')
+    f.write('{\n')
+    f.write('\tsize_t low = 0;\n')
+    f.write(f'\tsize_t high = ARRAY_SIZE({enum_name}_lookup);\n')
+    f.write('\twhile (low < high) {\n')
+    f.write('\t\tsize_t mid = low + (high - low) / 2;\n')
+    f.write(f'\t\tint cmp = strcmp({arg_name}, {enum_name}_lookup[mid].str);\n')
+    f.write('\t\tif (cmp == 0) {\n')
+    f.write(f'\t\t\treturn {enum_name}_lookup[mid].value;\n')
+    f.write('\t\t} else if (cmp < 0) {\n')
+    f.write('\t\t\thigh = mid;\n')
+    f.write('\t\t} else {\n')
+    f.write('\t\t\tlow = mid + 1;\n')
+    f.write('\t\t}\n')
+    f.write('\t}\n')
+    f.write(f'\treturn {fallback};\n')
+    f.write('}\n')
+
+
 def generate_bindings_c(file, p):
     """Generate the file to verify subpaths on a interaction profile."""
     f = open(file, "w")
     f.write(header.format(brief='Generated bindings data', group='oxr_main'))
     f.write('''
 #include "b_generated_bindings.h"
+#include "xrt/xrt_compiler.h"
+
+#include <stdlib.h>
 #include <string.h>
 
 // clang-format off
@@ -603,6 +633,20 @@ def generate_bindings_c(file, p):
 
         f.write('\t\t}, // /array of binding_template\n')
 
+        # Sorted so the runtime can binary search a suggested binding path.
+        path_lookup = []
+        for idx, component in enumerate(profile.components):
+            for path_idx, path in enumerate(component.get_full_openxr_paths()):
+                path_lookup.append((path, idx, path_idx))
+        path_lookup.sort()
+
+        f.write(f'\t\t.path_lookup_count = {len(path_lookup)},\n')
+        f.write(
+            f'\t\t.path_lookup = (const struct binding_path_lookup[]){{ // array of binding_path_lookup\n')
+        for path, idx, path_idx in path_lookup:
+            f.write(f'\t\t\t{{"{path}", {idx}, {path_idx}}},\n')
+        f.write('\t\t}, // /array of binding_path_lookup\n')
+
         dpads = []
         for idx, identifier in enumerate(profile.identifiers):
             if identifier.dpad:
@@ -638,6 +682,52 @@ def generate_bindings_c(file, p):
 
     f.write('}; // /array of profile_template\n\n')
 
+    sorted_profiles = sorted((profile.name, idx) for idx, profile in enumerate(p.profiles))
+    f.write(f'static const struct profile_template_lookup profile_template_lookup[{len(sorted_profiles)}] = {{\n')
+    for name, idx in sorted_profiles:
+        f.write(f'\t{{"{name}", {idx}}},\n')
+    f.write('};\n\n')
+
+    f.write('''static int
+compare_profile_template_lookup(const void *key, const void *elem)
+{
+\treturn strcmp((const char *)key, ((const struct profile_template_lookup *)elem)->path);
+}
+
+struct profile_template *
+profile_template_find(const char *path)
+{
+\tconst struct profile_template_lookup *l = bsearch(path, profile_template_lookup, NUM_PROFILE_TEMPLATES,
+\t                                                 sizeof(*l), compare_profile_template_lookup);
+\treturn l != NULL ? &profile_templates[l->index] : NULL;
+}
+
+const struct binding_path_lookup *
+profile_template_find_binding_paths(const struct profile_template *templ, const char *path, size_t *out_count)
+{
+\t// Lower bound, the same path can be in more then one binding.
+\tsize_t low = 0;
+\tsize_t high = templ->path_lookup_count;
+\twhile (low < high) {
+\t\tsize_t mid = low + (high - low) / 2;
+\t\tif (strcmp(templ->path_lookup[mid].path, path) < 0) {
+\t\t\tlow = mid + 1;
+\t\t} else {
+\t\t\thigh = mid;
+\t\t}
+\t}
+
+\tsize_t end = low;
+\twhile (end < templ->path_lookup_count && strcmp(templ->path_lookup[end].path, path) == 0) {
+\t\tend++;
+\t}
+
+\t*out_count = end - low;
+\treturn end > low ? &templ->path_lookup[low] : NULL;
+}
+
+''')
+
     inputs = set()
     outputs = set()
     for profile in p.profiles:
@@ -670,13 +760,7 @@ def generate_bindings_c(file, p):
     f.write('\t}\n')
     f.write('}\n')
 
-    f.write('enum xrt_input_name\n')
-    f.write('xrt_input_name_enum(const char *input)\n')
-    f.write('{\n')
-    for input in inputs:
-        f.write(f'\tif(strcmp("{input}", input) == 0) return {input};\n')
-    f.write(f'\treturn XRT_INPUT_GENERIC_TRACKER_POSE;\n')
-    f.write('}\n')
+    write_name_enum_lookup(f, 'xrt_input_name', 'input', sorted(inputs), 'XRT_INPUT_GENERIC_TRACKER_POSE')
 
     f.write('const char *\n')
     f.write('xrt_output_name_string(enum xrt_output_name output)\n')
@@ -689,13 +773,7 @@ def generate_bindings_c(file, p):
     f.write('\t}\n')
     f.write('}\n')
 
-    f.write('enum xrt_output_name\n')
-    f.write('xrt_output_name_enum(const char *output)\n')
-    f.write('{\n')
-    for output in outputs:
-        f.write(f'\tif(strcmp("{output}", output) == 0) return {output};\n')
-    f.write(f'\treturn XRT_OUTPUT_NAME_SIMPLE_VIBRATION;\n')
-    f.write('}\n')
+    write_name_enum_lookup(f, 'xrt_output_name', 'output', sorted(outputs), 'XRT_OUTPUT_NAME_SIMPLE_VIBRATION')
 
     f.write("\n// clang-format on\n")
 
@@ -757,6 +835,16 @@ struct binding_template
 \tenum xrt_output_name output;
 }};
 
+/*!
+ * Where a path is found in a profile template, the table is sorted on the path.
+ */
+struct binding_path_lookup
+{{
+\tconst char *path;
+\tuint32_t binding_index;
+\tuint32_t path_index;
+}};
+
 struct profile_template
 {{
 \tenum xrt_device_name name;
@@ -768,11 +856,32 @@ struct profile_template
 \tsize_t binding_count;
 \tstruct dpad_emulation *dpads;
 \tsize_t dpad_count;
+\tconst struct binding_path_lookup *path_lookup;
+\tsize_t path_lookup_count;
+}};
+
+struct profile_template_lookup
+{{
+\tconst char *path;
+\tsize_t index;
 }};
 
 #define NUM_PROFILE_TEMPLATES {len(p.profiles)}
 extern struct profile_template profile_templates[NUM_PROFILE_TEMPLATES];
 
+/*!
+ * Find the template for an interaction profile path, NULL if there is none.
+ */
+struct profile_template *
+profile_template_find(const char *path);
+
+/*!
+ * Find all of the bindings in @p templ that have @p path, they are next to
+ * each other in the returned array, NULL if there are none.
+ */
+const struct binding_path_lookup *
+profile_template_find_binding_paths(const struct profile_template *templ, const char *path, size_t *out_count);
+
 ''')
 
     f.write('const char *\n')
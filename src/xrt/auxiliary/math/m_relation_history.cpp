@@ -235,6 +235,25 @@ m_relation_history_get_latest(struct m_relation_history *rh,
 	return true;
 }
 
+uint32_t
+m_relation_history_get_newest(struct m_relation_history *rh,
+                              uint32_t max_count,
+                              uint64_t *out_timestamps_ns,
+                              struct xrt_space_relation *out_relations)
+{
+	std::unique_lock<os::Mutex> lock(rh->mutex);
+	uint32_t count = (uint32_t)std::min<size_t>(max_count, rh->impl.size());
+
+	// Age zero is the newest entry, it goes last.
+	for (uint32_t i = 0; i < count; i++) {
+		const relation_history_entry *rhe = rh->impl.get_at_age(i);
+		out_timestamps_ns[count - 1 - i] = rhe->timestamp;
+		out_relations[count - 1 - i] = rhe->relation;
+	}
+
+	return count;
+}
+
 uint32_t
 m_relation_history_get_size(const struct m_relation_history *rh)
 {
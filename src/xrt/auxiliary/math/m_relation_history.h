@@ -103,6 +103,25 @@ m_relation_history_get_latest(struct m_relation_history *rh,
                               uint64_t *out_time_ns,
                               struct xrt_space_relation *out_relation);
 
+/*!
+ * Copies out the newest entries in the history, oldest first, these are the
+ * entries @ref m_relation_history_get interpolates between.
+ *
+ * @param rh self
+ * @param max_count Size of the out arrays.
+ * @param[out] out_timestamps_ns Populated with the timestamps of the entries.
+ * @param[out] out_relations Populated with the relations of the entries.
+ *
+ * @return The number of entries copied, zero if the history is empty.
+ *
+ * @public @memberof m_relation_history
+ */
+uint32_t
+m_relation_history_get_newest(struct m_relation_history *rh,
+                              uint32_t max_count,
+                              uint64_t *out_timestamps_ns,
+                              struct xrt_space_relation *out_relations);
+
 /*!
  * Returns the number of items in the history.
  *
@@ -195,6 +214,15 @@ public:
 		return m_relation_history_get_latest(mPtr, out_time_ns, out_relation);
 	}
 
+	/*!
+	 * @copydoc m_relation_history_get_newest
+	 */
+	uint32_t
+	get_newest(uint32_t max_count, uint64_t *out_timestamps_ns, xrt_space_relation *out_relations) noexcept
+	{
+		return m_relation_history_get_newest(mPtr, max_count, out_timestamps_ns, out_relations);
+	}
+
 	/*!
 	 * @copydoc m_relation_history_get_size
 	 */
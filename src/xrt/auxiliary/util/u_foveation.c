@@ -0,0 +1,174 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Helpers for building fixed and eye tracked foveation patterns.
+ * @author agent <agent@local>
+ * @ingroup aux_util
+ */
+
+#include "util/u_foveation.h"
+
+#include <math.h>
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static inline float
+clamp_ndc(float v)
+{
+	return v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);
+}
+
+/*!
+ * Place a range of @p size inside of [@p min, @p max] centred on @p center,
+ * moved inwards if it would go outside, returns the start of the range.
+ */
+static inline float
+place_range(float min, float max, float center, float size)
+{
+	float start = center - size * 0.5f;
+	if (start < min) {
+		start = min;
+	}
+	if (start + size > max) {
+		start = max - size;
+	}
+	return start;
+}
+
+static inline uint8_t
+rate_for_log2(uint32_t log2)
+{
+	switch (log2) {
+	case 0: return U_FOVEATION_RATE_1X1;
+	case 1: return U_FOVEATION_RATE_2X2;
+	default: return U_FOVEATION_RATE_4X4;
+	}
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+uint8_t
+u_foveation_rate_for_distance(enum xrt_foveation_level level, float distance, uint32_t max_rate_log2)
+{
+	// Radius in NDC of the full rate and the 2x2 rings, beyond is 4x4.
+	float full_radius;
+	float half_radius;
+
+	switch (level) {
+	case XRT_FOVEATION_LEVEL_LOW:
+		full_radius = 0.7f;
+		half_radius = INFINITY;
+		break;
+	case XRT_FOVEATION_LEVEL_MEDIUM:
+		full_radius = 0.5f;
+		half_radius = 0.9f;
+		break;
+	case XRT_FOVEATION_LEVEL_HIGH:
+		full_radius = 0.35f;
+		half_radius = 0.65f;
+		break;
+	case XRT_FOVEATION_LEVEL_NONE:
+	default: return U_FOVEATION_RATE_1X1;
+	}
+
+	uint32_t log2 = 2;
+	if (distance < full_radius) {
+		log2 = 0;
+	} else if (distance < half_radius) {
+		log2 = 1;
+	}
+
+	if (log2 > max_rate_log2) {
+		log2 = max_rate_log2;
+	}
+
+	return rate_for_log2(log2);
+}
+
+void
+u_foveation_fill_shading_rate(enum xrt_foveation_level level,
+                              const struct xrt_vec2 *center,
+                              uint32_t max_rate_log2,
+                              uint32_t width,
+                              uint32_t height,
+                              uint8_t *out,
+                              size_t stride)
+{
+	for (uint32_t y = 0; y < height; y++) {
+		uint8_t *row = out + y * stride;
+		float ndc_y = 1.0f - 2.0f * ((float)y + 0.5f) / (float)height;
+		float dy = ndc_y - center->y;
+
+		for (uint32_t x = 0; x < width; x++) {
+			float ndc_x = 2.0f * ((float)x + 0.5f) / (float)width - 1.0f;
+			float dx = ndc_x - center->x;
+
+			row[x] = u_foveation_rate_for_distance(level, sqrtf(dx * dx + dy * dy), max_rate_log2);
+		}
+	}
+}
+
+void
+u_foveation_center_from_direction(const struct xrt_fov *fov,
+                                  const struct xrt_vec3 *direction,
+                                  struct xrt_vec2 *out_center)
+{
+	// Forward is -Z, anything not in front of the view can't be projected.
+	if (direction->z >= 0.0f) {
+		out_center->x = 0.0f;
+		out_center->y = 0.0f;
+		return;
+	}
+
+	float tan_x = direction->x / -direction->z;
+	float tan_y = direction->y / -direction->z;
+
+	float tan_left = tanf(fov->angle_left);
+	float tan_right = tanf(fov->angle_right);
+	float tan_up = tanf(fov->angle_up);
+	float tan_down = tanf(fov->angle_down);
+
+	out_center->x = clamp_ndc(2.0f * (tan_x - tan_left) / (tan_right - tan_left) - 1.0f);
+	out_center->y = clamp_ndc(2.0f * (tan_y - tan_down) / (tan_up - tan_down) - 1.0f);
+}
+
+void
+u_foveation_inset_fov(const struct xrt_fov *fov,
+                      const struct xrt_vec2 *center,
+                      float scale,
+                      struct xrt_fov *out_inset)
+{
+	float tan_left = tanf(fov->angle_left);
+	float tan_right = tanf(fov->angle_right);
+	float tan_up = tanf(fov->angle_up);
+	float tan_down = tanf(fov->angle_down);
+
+	float width = tan_right - tan_left;
+	float height = tan_up - tan_down;
+
+	// From NDC to tangent space.
+	float tan_x = tan_left + (clamp_ndc(center->x) + 1.0f) * 0.5f * width;
+	float tan_y = tan_down + (clamp_ndc(center->y) + 1.0f) * 0.5f * height;
+
+	float inset_width = width * scale;
+	float inset_height = height * scale;
+
+	float inset_left = place_range(tan_left, tan_right, tan_x, inset_width);
+	float inset_down = place_range(tan_down, tan_up, tan_y, inset_height);
+
+	out_inset->angle_left = atanf(inset_left);
+	out_inset->angle_right = atanf(inset_left + inset_width);
+	out_inset->angle_down = atanf(inset_down);
+	out_inset->angle_up = atanf(inset_down + inset_height);
+}
@@ -0,0 +1,104 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Helpers for building fixed and eye tracked foveation patterns.
+ * @author agent <agent@local>
+ * @ingroup aux_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_defines.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Full rate, one fragment per pixel. Rates use the Vulkan fragment shading
+ * rate attachment encoding, `(log2(width) << 2) | log2(height)`.
+ *
+ * @ingroup aux_util
+ */
+#define U_FOVEATION_RATE_1X1 (0)
+
+/*!
+ * One fragment per 2x2 pixels.
+ *
+ * @ingroup aux_util
+ */
+#define U_FOVEATION_RATE_2X2 (5)
+
+/*!
+ * One fragment per 4x4 pixels.
+ *
+ * @ingroup aux_util
+ */
+#define U_FOVEATION_RATE_4X4 (10)
+
+/*!
+ * Get the shading rate for a point @p distance away from the foveation centre,
+ * both in NDC units. The rate is clamped to @p max_rate_log2, where 1 is 2x2
+ * and 2 is 4x4, a value of 0 always gives full rate.
+ *
+ * @ingroup aux_util
+ */
+uint8_t
+u_foveation_rate_for_distance(enum xrt_foveation_level level, float distance, uint32_t max_rate_log2);
+
+/*!
+ * Fill a shading rate image of @p width by @p height texels, the first row is
+ * the top of the view. The @p center is in NDC with y up.
+ *
+ * @param level         Foveation level, none fills the image with full rate.
+ * @param center        Centre of the full rate region.
+ * @param max_rate_log2 Largest rate supported by the device.
+ * @param width         Width of the image in texels.
+ * @param height        Height of the image in texels.
+ * @param out           Output, one byte per texel.
+ * @param stride        Bytes between each row in @p out.
+ *
+ * @ingroup aux_util
+ */
+void
+u_foveation_fill_shading_rate(enum xrt_foveation_level level,
+                              const struct xrt_vec2 *center,
+                              uint32_t max_rate_log2,
+                              uint32_t width,
+                              uint32_t height,
+                              uint8_t *out,
+                              size_t stride);
+
+/*!
+ * Project a gaze direction in view space into NDC for the given fov, used to
+ * place the full rate region where the user is looking. The result is
+ * clamped to the view, directions pointing away from the view give the centre.
+ *
+ * @ingroup aux_util
+ */
+void
+u_foveation_center_from_direction(const struct xrt_fov *fov,
+                                  const struct xrt_vec3 *direction,
+                                  struct xrt_vec2 *out_center);
+
+/*!
+ * Get the fov of a high resolution inset inside of @p fov, used for quad
+ * views. The inset covers @p scale of the view along each axis in tangent
+ * space and is centred on @p center, in NDC with y up, but kept inside the
+ * view.
+ *
+ * @ingroup aux_util
+ */
+void
+u_foveation_inset_fov(const struct xrt_fov *fov,
+                      const struct xrt_vec2 *center,
+                      float scale,
+                      struct xrt_fov *out_inset);
+
+
+#ifdef __cplusplus
+}
+#endif
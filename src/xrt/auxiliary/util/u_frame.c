@@ -141,5 +141,10 @@ u_frame_create_roi(struct xrt_frame *original, struct xrt_rect roi, struct xrt_f
 	xf->source_sequence = original->source_sequence;
 	xf->source_id = original->source_id;
 
+	// The ROI keeps the original alive, so it can share its buffer handle.
+	xf->buffer_handle = original->buffer_handle;
+	xf->buffer_offset = original->buffer_offset + offset;
+	xf->has_buffer_handle = original->has_buffer_handle;
+
 	xrt_frame_reference(out_frame, xf);
 }
@@ -0,0 +1,76 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Smoothed estimate of how much of a time budget some work uses.
+ * @author agent <agent@local>
+ * @ingroup aux_pacing
+ */
+
+#include "util/u_headroom.h"
+
+#include <math.h>
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+u_headroom_init(struct u_headroom *uh)
+{
+	uh->ratio = 0.0;
+	uh->sample_count = 0;
+	uh->samples_since_change = 0;
+	uh->restart_average = false;
+}
+
+bool
+u_headroom_push(struct u_headroom *uh, uint64_t used_ns, uint64_t budget_ns, uint32_t min_samples)
+{
+	if (budget_ns == 0) {
+		return false;
+	}
+
+	double sample = (double)used_ns / (double)budget_ns;
+
+	if (uh->sample_count == 0 || uh->restart_average) {
+		uh->ratio = sample;
+		uh->restart_average = false;
+	} else {
+		uh->ratio += (sample - uh->ratio) * U_HEADROOM_SMOOTHING;
+	}
+
+	uh->sample_count++;
+	if (uh->samples_since_change < UINT32_MAX) {
+		uh->samples_since_change++;
+	}
+
+	// Don't change too often, this also covers the warm up period.
+	return uh->samples_since_change >= min_samples;
+}
+
+bool
+u_headroom_is_above(const struct u_headroom *uh, double threshold, bool was_above)
+{
+	if (was_above) {
+		return uh->ratio >= threshold - U_HEADROOM_HYSTERESIS;
+	}
+
+	return uh->ratio >= threshold;
+}
+
+bool
+u_headroom_is_near(const struct u_headroom *uh, double target)
+{
+	return fabs(uh->ratio - target) < U_HEADROOM_HYSTERESIS;
+}
+
+void
+u_headroom_changed(struct u_headroom *uh, bool restart_average)
+{
+	uh->samples_since_change = 0;
+	uh->restart_average = restart_average;
+}
@@ -0,0 +1,116 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Smoothed estimate of how much of a time budget some work uses.
+ * @author agent <agent@local>
+ * @ingroup aux_pacing
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Weight given to each new sample in the exponential moving average.
+ *
+ * @ingroup aux_pacing
+ */
+#define U_HEADROOM_SMOOTHING (0.1)
+
+/*!
+ * How far the smoothed ratio has to move past a threshold before it counts as
+ * having crossed back, stops decisions from flapping around a threshold.
+ *
+ * @ingroup aux_pacing
+ */
+#define U_HEADROOM_HYSTERESIS (0.1)
+
+/*!
+ * Exponentially smoothed ratio of used time over budget, shared by the
+ * performance notifications and the recommended layer resolution so they
+ * react to the same load in the same way.
+ *
+ * Not thread safe, the owner is responsible for locking.
+ *
+ * @ingroup aux_pacing
+ */
+struct u_headroom
+{
+	//! Exponentially smoothed ratio of used time over budget.
+	double ratio;
+
+	//! Total number of samples pushed.
+	uint64_t sample_count;
+
+	//! Number of samples pushed since the owner last acted on the ratio.
+	uint32_t samples_since_change;
+
+	//! The next sample replaces the average, see @ref u_headroom_changed.
+	bool restart_average;
+};
+
+/*!
+ * Reset the estimate with no samples.
+ *
+ * @public @memberof u_headroom
+ * @ingroup aux_pacing
+ */
+void
+u_headroom_init(struct u_headroom *uh);
+
+/*!
+ * Push a new timing sample, returns true once @p min_samples samples have been
+ * pushed since the last change, which also covers the warm up period.
+ *
+ * @param      uh          The estimate.
+ * @param[in]  used_ns     How long the work took.
+ * @param[in]  budget_ns   How long the work was allowed to take, samples with
+ *                         a zero budget are ignored.
+ * @param[in]  min_samples Samples needed before the ratio is acted on again.
+ *
+ * @public @memberof u_headroom
+ * @ingroup aux_pacing
+ */
+bool
+u_headroom_push(struct u_headroom *uh, uint64_t used_ns, uint64_t budget_ns, uint32_t min_samples);
+
+/*!
+ * Is the smoothed ratio at or above @p threshold, if it @p was_above it has to
+ * drop @ref U_HEADROOM_HYSTERESIS below the threshold to count as below.
+ *
+ * @public @memberof u_headroom
+ * @ingroup aux_pacing
+ */
+bool
+u_headroom_is_above(const struct u_headroom *uh, double threshold, bool was_above);
+
+/*!
+ * Is the smoothed ratio within @ref U_HEADROOM_HYSTERESIS of @p target.
+ *
+ * @public @memberof u_headroom
+ * @ingroup aux_pacing
+ */
+bool
+u_headroom_is_near(const struct u_headroom *uh, double target);
+
+/*!
+ * The owner acted on the ratio, restarts the count of samples needed before
+ * acting again. With @p restart_average the next sample replaces the average,
+ * for changes that make the old samples stale.
+ *
+ * @public @memberof u_headroom
+ * @ingroup aux_pacing
+ */
+void
+u_headroom_changed(struct u_headroom *uh, bool restart_average);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,89 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Recommended layer resolution scale from measured GPU headroom.
+ * @author agent <agent@local>
+ * @ingroup aux_pacing
+ */
+
+#include "util/u_layer_resolution.h"
+
+#include <math.h>
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static float
+get_target_scale(const struct u_headroom *uh, float current)
+{
+	double ratio = uh->ratio;
+
+	// Within the dead band, keep what we have.
+	if (u_headroom_is_near(uh, U_LAYER_RESOLUTION_TARGET_RATIO)) {
+		return current;
+	}
+
+	// Already at full resolution and under budget, nothing to gain.
+	if (ratio < U_LAYER_RESOLUTION_TARGET_RATIO && current >= 1.0f) {
+		return current;
+	}
+
+	/*
+	 * GPU time is assumed to scale with the pixel count, which is the
+	 * square of the per axis scale.
+	 */
+	double ideal = ratio > 0.0 ? current * sqrt(U_LAYER_RESOLUTION_TARGET_RATIO / ratio) : 1.0;
+
+	// Round down to a step, the epsilon stops exact steps going one down.
+	float scale = floorf((float)ideal / U_LAYER_RESOLUTION_STEP + 0.001f) * U_LAYER_RESOLUTION_STEP;
+
+	if (scale < U_LAYER_RESOLUTION_MIN_SCALE) {
+		scale = U_LAYER_RESOLUTION_MIN_SCALE;
+	}
+	if (scale > 1.0f) {
+		scale = 1.0f;
+	}
+
+	return scale;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+u_layer_resolution_init(struct u_layer_resolution *ulr)
+{
+	u_headroom_init(&ulr->headroom);
+	ulr->scale = 1.0f;
+}
+
+bool
+u_layer_resolution_push(struct u_layer_resolution *ulr, uint64_t used_ns, uint64_t budget_ns, float *out_scale)
+{
+	if (!u_headroom_push(&ulr->headroom, used_ns, budget_ns, U_LAYER_RESOLUTION_MIN_SAMPLES)) {
+		return false;
+	}
+
+	float scale = get_target_scale(&ulr->headroom, ulr->scale);
+	if (fabsf(scale - ulr->scale) < U_LAYER_RESOLUTION_STEP / 2.0f) {
+		return false;
+	}
+
+	*out_scale = scale;
+
+	ulr->scale = scale;
+
+	// Old samples were at another scale.
+	u_headroom_changed(&ulr->headroom, true);
+
+	return true;
+}
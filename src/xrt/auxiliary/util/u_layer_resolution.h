@@ -0,0 +1,99 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Recommended layer resolution scale from measured GPU headroom.
+ * @author agent <agent@local>
+ * @ingroup aux_pacing
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+
+#include "util/u_headroom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Smoothed ratio of GPU time over budget that the scale is steered towards,
+ * leaves some headroom for spikes.
+ *
+ * @ingroup aux_pacing
+ */
+#define U_LAYER_RESOLUTION_TARGET_RATIO (0.8)
+
+/*!
+ * Minimum number of samples between two scale changes, also used as the warm
+ * up period before the first change. Longer than for performance notifications
+ * since the app needs to reallocate or resize to follow a new resolution.
+ *
+ * @ingroup aux_pacing
+ */
+#define U_LAYER_RESOLUTION_MIN_SAMPLES (30)
+
+/*!
+ * Smallest scale per axis that will ever be recommended.
+ *
+ * @ingroup aux_pacing
+ */
+#define U_LAYER_RESOLUTION_MIN_SCALE (0.5f)
+
+/*!
+ * The scale is quantised to multiples of this, so small changes in load does
+ * not produce a stream of slightly different resolutions.
+ *
+ * @ingroup aux_pacing
+ */
+#define U_LAYER_RESOLUTION_STEP (0.05f)
+
+/*!
+ * Tracks the recommended per axis resolution scale of a single client, fed
+ * with how long the GPU work of each frame took compared to its budget. The
+ * scale is left alone while the ratio is within @ref U_HEADROOM_HYSTERESIS of
+ * @ref U_LAYER_RESOLUTION_TARGET_RATIO.
+ *
+ * Not thread safe, the owner is responsible for locking.
+ *
+ * @ingroup aux_pacing
+ */
+struct u_layer_resolution
+{
+	//! Smoothed ratio of used time over budget.
+	struct u_headroom headroom;
+
+	//! The current recommended scale per axis, in the range [min, 1].
+	float scale;
+};
+
+/*!
+ * Reset the tracker to full resolution with no samples.
+ *
+ * @public @memberof u_layer_resolution
+ * @ingroup aux_pacing
+ */
+void
+u_layer_resolution_init(struct u_layer_resolution *ulr);
+
+/*!
+ * Push a new GPU timing sample, returns true if the scale changed.
+ *
+ * @param      ulr       The tracker.
+ * @param[in]  used_ns   How long the GPU work took.
+ * @param[in]  budget_ns How long the work was allowed to take, samples with a
+ *                       zero budget are ignored.
+ * @param[out] out_scale The new scale, only written on change.
+ *
+ * @public @memberof u_layer_resolution
+ * @ingroup aux_pacing
+ */
+bool
+u_layer_resolution_push(struct u_layer_resolution *ulr, uint64_t used_ns, uint64_t budget_ns, float *out_scale);
+
+
+#ifdef __cplusplus
+}
+#endif
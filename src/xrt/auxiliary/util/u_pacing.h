@@ -448,6 +448,17 @@ struct u_pacing_app
 	             uint64_t predicted_display_period_ns,
 	             uint64_t extra_ns);
 
+	/*!
+	 * Set the rate the app should run at as a divisor of the display rate,
+	 * used when the compositor synthesizes the frames in between, like with
+	 * XR_FB_space_warp. A divisor of one, the default, makes the app run at
+	 * the display rate, a divisor of two makes it run at half rate.
+	 *
+	 * @param upa     Self pointer
+	 * @param divisor The display rate divisor, zero is treated as one.
+	 */
+	void (*set_rate_divisor)(struct u_pacing_app *upa, uint32_t divisor);
+
 	/*!
 	 * Destroy this u_pacing_app.
 	 */
@@ -547,6 +558,20 @@ u_pa_info(struct u_pacing_app *upa,
 	upa->info(upa, predicted_display_time_ns, predicted_display_period_ns, extra_ns);
 }
 
+/*!
+ * @copydoc u_pacing_app::set_rate_divisor
+ *
+ * Helper for calling through the function pointer.
+ *
+ * @public @memberof u_pacing_app
+ * @ingroup aux_pacing
+ */
+static inline void
+u_pa_set_rate_divisor(struct u_pacing_app *upa, uint32_t divisor)
+{
+	upa->set_rate_divisor(upa, divisor);
+}
+
 /*!
  * @copydoc u_pacing_app::latched
  *
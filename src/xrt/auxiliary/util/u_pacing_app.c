@@ -152,6 +152,9 @@ struct pacing_app
 	} last_input;
 
 	uint64_t last_returned_ns;
+
+	//! Run the app at the display rate divided by this, always at least one.
+	uint32_t rate_divisor;
 };
 
 
@@ -271,6 +274,9 @@ calc_period(const struct pacing_app *pa)
 		base_period_ns = U_TIME_1MS_IN_NS * 16; // Sure
 	}
 
+	// Keep the app on a multiple of the divided display rate.
+	base_period_ns *= pa->rate_divisor;
+
 	// Calculate the using both values separately.
 	uint64_t period_ns = base_period_ns;
 	while (pa->app.cpu_time_ns > period_ns) {
@@ -658,6 +664,14 @@ pa_info(struct u_pacing_app *upa,
 	pa->last_input.extra_ns = extra_ns;
 }
 
+static void
+pa_set_rate_divisor(struct u_pacing_app *upa, uint32_t divisor)
+{
+	struct pacing_app *pa = pacing_app(upa);
+
+	pa->rate_divisor = divisor > 0 ? divisor : 1;
+}
+
 static void
 pa_destroy(struct u_pacing_app *upa)
 {
@@ -678,8 +692,10 @@ pa_create(int64_t session_id, struct u_pacing_app **out_upa)
 	pa->base.latched = pa_latched;
 	pa->base.retired = pa_retired;
 	pa->base.info = pa_info;
+	pa->base.set_rate_divisor = pa_set_rate_divisor;
 	pa->base.destroy = pa_destroy;
 	pa->session_id = session_id;
+	pa->rate_divisor = 1;
 	pa->app.cpu_time_ns = U_TIME_1MS_IN_NS * 2;
 	pa->app.draw_time_ns = U_TIME_1MS_IN_NS * 2;
 	pa->app.margin_ns = U_TIME_1MS_IN_NS * 2;
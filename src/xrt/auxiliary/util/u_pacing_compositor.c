@@ -363,6 +363,7 @@ adjust_comp_time(struct pacing_compositor *pc, struct frame *f)
 	    !is_within_half_ms(f->actual_present_time_ns, f->desired_present_time_ns)) {
 		double missed_ms = ns_to_ms(f->actual_present_time_ns - f->desired_present_time_ns);
 		UPC_LOG_W("Frame %" PRIu64 " missed by %.2f!", f->frame_id, missed_ms);
+		U_TRACE_REQUEST_DUMP("compositor missed a frame");
 
 		comp_time_ns += pc->adjust_missed_ns;
 		if (comp_time_ns > pc->comp_time_max_ns) {
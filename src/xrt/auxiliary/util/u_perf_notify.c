@@ -0,0 +1,73 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Threshold based performance notification level tracking.
+ * @author agent <agent@local>
+ * @ingroup aux_pacing
+ */
+
+#include "util/u_perf_notify.h"
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static enum xrt_perf_notify_level
+get_target_level(const struct u_headroom *uh, enum xrt_perf_notify_level current)
+{
+	// Stays raised until the ratio is clearly below the threshold.
+	if (u_headroom_is_above(uh, U_PERF_NOTIFY_IMPAIRED_RATIO, current == XRT_PERF_NOTIFY_LEVEL_IMPAIRED)) {
+		return XRT_PERF_NOTIFY_LEVEL_IMPAIRED;
+	}
+
+	if (u_headroom_is_above(uh, U_PERF_NOTIFY_WARNING_RATIO, current != XRT_PERF_NOTIFY_LEVEL_NORMAL)) {
+		return XRT_PERF_NOTIFY_LEVEL_WARNING;
+	}
+
+	return XRT_PERF_NOTIFY_LEVEL_NORMAL;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+u_perf_notify_init(struct u_perf_notify *upn)
+{
+	u_headroom_init(&upn->headroom);
+	upn->level = XRT_PERF_NOTIFY_LEVEL_NORMAL;
+}
+
+bool
+u_perf_notify_push(struct u_perf_notify *upn,
+                   uint64_t used_ns,
+                   uint64_t budget_ns,
+                   enum xrt_perf_notify_level *out_from,
+                   enum xrt_perf_notify_level *out_to)
+{
+	if (!u_headroom_push(&upn->headroom, used_ns, budget_ns, U_PERF_NOTIFY_MIN_SAMPLES)) {
+		return false;
+	}
+
+	enum xrt_perf_notify_level to = get_target_level(&upn->headroom, upn->level);
+	if (to == upn->level) {
+		return false;
+	}
+
+	*out_from = upn->level;
+	*out_to = to;
+
+	upn->level = to;
+
+	// The load didn't change, only our view of it, keep the average.
+	u_headroom_changed(&upn->headroom, false);
+
+	return true;
+}
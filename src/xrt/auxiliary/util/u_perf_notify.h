@@ -0,0 +1,97 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Threshold based performance notification level tracking.
+ * @author agent <agent@local>
+ * @ingroup aux_pacing
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_defines.h"
+
+#include "util/u_headroom.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Smoothed ratio of used time over budget at or above which the level is
+ * raised to @ref XRT_PERF_NOTIFY_LEVEL_WARNING.
+ *
+ * @ingroup aux_pacing
+ */
+#define U_PERF_NOTIFY_WARNING_RATIO (0.85)
+
+/*!
+ * Smoothed ratio of used time over budget at or above which the level is
+ * raised to @ref XRT_PERF_NOTIFY_LEVEL_IMPAIRED.
+ *
+ * @ingroup aux_pacing
+ */
+#define U_PERF_NOTIFY_IMPAIRED_RATIO (1.0)
+
+/*!
+ * Minimum number of samples between two level changes, also used as the warm
+ * up period before the first change.
+ *
+ * @ingroup aux_pacing
+ */
+#define U_PERF_NOTIFY_MIN_SAMPLES (10)
+
+/*!
+ * Tracks the notification level of a single performance domain and
+ * sub-domain pair, fed with how long some work took compared to its budget.
+ * Once raised a level is only lowered when the ratio is
+ * @ref U_HEADROOM_HYSTERESIS below its threshold.
+ *
+ * Not thread safe, the owner is responsible for locking.
+ *
+ * @ingroup aux_pacing
+ */
+struct u_perf_notify
+{
+	//! Smoothed ratio of used time over budget.
+	struct u_headroom headroom;
+
+	//! The current notification level.
+	enum xrt_perf_notify_level level;
+};
+
+/*!
+ * Reset the tracker to the normal level with no samples.
+ *
+ * @public @memberof u_perf_notify
+ * @ingroup aux_pacing
+ */
+void
+u_perf_notify_init(struct u_perf_notify *upn);
+
+/*!
+ * Push a new timing sample, returns true if the level changed.
+ *
+ * @param      upn       The tracker.
+ * @param[in]  used_ns   How long the work took.
+ * @param[in]  budget_ns How long the work was allowed to take, samples with a
+ *                       zero budget are ignored.
+ * @param[out] out_from  The level before the change, only written on change.
+ * @param[out] out_to    The level after the change, only written on change.
+ *
+ * @public @memberof u_perf_notify
+ * @ingroup aux_pacing
+ */
+bool
+u_perf_notify_push(struct u_perf_notify *upn,
+                   uint64_t used_ns,
+                   uint64_t budget_ns,
+                   enum xrt_perf_notify_level *out_from,
+                   enum xrt_perf_notify_level *out_to);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -405,6 +405,45 @@ locate_space(struct xrt_space_overseer *xso,
 	return XRT_SUCCESS;
 }
 
+static xrt_result_t
+locate_spaces(struct xrt_space_overseer *xso,
+              struct xrt_space *base_space,
+              const struct xrt_pose *base_offset,
+              uint64_t at_timestamp_ns,
+              struct xrt_space **spaces,
+              uint32_t space_count,
+              const struct xrt_pose *offsets,
+              struct xrt_space_relation *out_relations)
+{
+	struct u_space_overseer *uso = u_space_overseer(xso);
+
+	struct u_space *ubase_space = u_space(base_space);
+
+	// Only need the read lock, and only take it once for the whole batch.
+	pthread_rwlock_rdlock(&uso->lock);
+
+	for (uint32_t i = 0; i < space_count; i++) {
+		if (spaces[i] == NULL) {
+			out_relations[i] = (struct xrt_space_relation)XRT_SPACE_RELATION_ZERO;
+			continue;
+		}
+
+		struct u_space *uspace = u_space(spaces[i]);
+		struct xrt_relation_chain xrc = {0};
+
+		m_relation_chain_push_pose_if_not_identity(&xrc, &offsets[i]);
+		build_relation_chain_read_locked(uso, &xrc, ubase_space, uspace, at_timestamp_ns);
+		m_relation_chain_push_inverted_pose_if_not_identity(&xrc, base_offset);
+
+		// For base_space =~= space (approx equals).
+		special_resolve(&xrc, &out_relations[i]);
+	}
+
+	pthread_rwlock_unlock(&uso->lock);
+
+	return XRT_SUCCESS;
+}
+
 static xrt_result_t
 locate_device(struct xrt_space_overseer *xso,
               struct xrt_space *base_space,
@@ -435,6 +474,45 @@ locate_device(struct xrt_space_overseer *xso,
 	return XRT_SUCCESS;
 }
 
+static xrt_result_t
+add_device(struct xrt_space_overseer *xso, struct xrt_device *xdev)
+{
+	struct u_space_overseer *uso = u_space_overseer(xso);
+	struct xrt_space *xs = NULL;
+
+	// Not shared with other devices of the same origin, but the offset is the same.
+	u_space_overseer_create_offset_space(uso, uso->base.semantic.root, &xdev->tracking_origin->offset, &xs);
+	u_space_overseer_link_space_to_device(uso, xs, xdev);
+	xrt_space_reference(&xs, NULL);
+
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+remove_device(struct xrt_space_overseer *xso, struct xrt_device *xdev)
+{
+	struct u_space_overseer *uso = u_space_overseer(xso);
+
+	pthread_rwlock_wrlock(&uso->lock);
+
+	void *ptr = NULL;
+	uint64_t key = (uint64_t)(intptr_t)xdev;
+	u_hashmap_int_find(uso->xdev_map, key, &ptr);
+	u_hashmap_int_erase(uso->xdev_map, key);
+
+	pthread_rwlock_unlock(&uso->lock);
+
+	if (ptr == NULL) {
+		U_LOG_W("Device '%s' doesn't have a space attached!", xdev->str);
+	}
+
+	// Dereferrence the space outside of lock.
+	struct xrt_space *xs = (struct xrt_space *)ptr;
+	xrt_space_reference(&xs, NULL);
+
+	return XRT_SUCCESS;
+}
+
 static void
 destroy(struct xrt_space_overseer *xso)
 {
@@ -469,7 +547,10 @@ u_space_overseer_create(void)
 	uso->base.create_offset_space = create_offset_space;
 	uso->base.create_pose_space = create_pose_space;
 	uso->base.locate_space = locate_space;
+	uso->base.locate_spaces = locate_spaces;
 	uso->base.locate_device = locate_device;
+	uso->base.add_device = add_device;
+	uso->base.remove_device = remove_device;
 	uso->base.destroy = destroy;
 
 	XRT_MAYBE_UNUSED int ret = 0;
@@ -12,8 +12,10 @@
 
 #include "util/u_misc.h"
 #include "util/u_device.h"
+#include "util/u_logging.h"
 #include "util/u_system_helpers.h"
 
+#include <string.h>
 #include <assert.h>
 
 
@@ -37,6 +39,22 @@ destroy(struct xrt_system_devices *xsysd)
 	free(usysd);
 }
 
+static void
+set_role_if_free(struct xrt_device **role, struct xrt_device *xdev)
+{
+	if (*role == NULL) {
+		*role = xdev;
+	}
+}
+
+static void
+clear_role_if_set(struct xrt_device **role, struct xrt_device *xdev)
+{
+	if (*role == xdev) {
+		*role = NULL;
+	}
+}
+
 
 /*
  *
@@ -103,3 +121,59 @@ u_system_devices_get_ht_device(struct u_system_devices *usysd, enum xrt_input_na
 
 	return NULL;
 }
+
+bool
+u_system_devices_add_device(struct xrt_system_devices *xsysd, struct xrt_device *xdev)
+{
+	if (xsysd->xdev_count >= ARRAY_SIZE(xsysd->xdevs)) {
+		U_LOG_W("No room for '%s', destroying it", xdev->str);
+		xrt_device_destroy(&xdev);
+		return false;
+	}
+
+	xsysd->xdevs[xsysd->xdev_count++] = xdev;
+
+	switch (xdev->device_type) {
+	case XRT_DEVICE_TYPE_HMD: set_role_if_free(&xsysd->roles.head, xdev); break;
+	case XRT_DEVICE_TYPE_LEFT_HAND_CONTROLLER: set_role_if_free(&xsysd->roles.left, xdev); break;
+	case XRT_DEVICE_TYPE_RIGHT_HAND_CONTROLLER: set_role_if_free(&xsysd->roles.right, xdev); break;
+	case XRT_DEVICE_TYPE_ANY_HAND_CONTROLLER:
+		if (xsysd->roles.left == NULL) {
+			xsysd->roles.left = xdev;
+		} else {
+			set_role_if_free(&xsysd->roles.right, xdev);
+		}
+		break;
+	case XRT_DEVICE_TYPE_EYE_TRACKER: set_role_if_free(&xsysd->roles.eyes, xdev); break;
+	default: break;
+	}
+
+	return true;
+}
+
+void
+u_system_devices_remove_device(struct xrt_system_devices *xsysd, struct xrt_device **xdev_ptr)
+{
+	struct xrt_device *xdev = *xdev_ptr;
+
+	for (size_t i = 0; i < xsysd->xdev_count; i++) {
+		if (xsysd->xdevs[i] != xdev) {
+			continue;
+		}
+
+		xsysd->xdev_count--;
+		memmove(&xsysd->xdevs[i], &xsysd->xdevs[i + 1], sizeof(xsysd->xdevs[0]) * (xsysd->xdev_count - i));
+		xsysd->xdevs[xsysd->xdev_count] = NULL;
+		break;
+	}
+
+	clear_role_if_set(&xsysd->roles.head, xdev);
+	clear_role_if_set(&xsysd->roles.left, xdev);
+	clear_role_if_set(&xsysd->roles.right, xdev);
+	clear_role_if_set(&xsysd->roles.gamepad, xdev);
+	clear_role_if_set(&xsysd->roles.eyes, xdev);
+	clear_role_if_set(&xsysd->roles.hand_tracking.left, xdev);
+	clear_role_if_set(&xsysd->roles.hand_tracking.right, xdev);
+
+	xrt_device_destroy(xdev_ptr);
+}
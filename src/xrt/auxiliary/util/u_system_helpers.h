@@ -85,6 +85,31 @@ u_system_devices_create_from_prober(struct xrt_instance *xinst,
 struct xrt_device *
 u_system_devices_get_ht_device(struct u_system_devices *usysd, enum xrt_input_name name);
 
+/*!
+ * Helper function.
+ *
+ * Adds a device that was created after the system devices were set up, like a
+ * hotplugged one, and gives it any free role that fits its type. Takes
+ * ownership of the device, it is destroyed if there is no room for it.
+ *
+ * @return False if there was no room for the device.
+ *
+ * @ingroup aux_util
+ */
+bool
+u_system_devices_add_device(struct xrt_system_devices *xsysd, struct xrt_device *xdev);
+
+/*!
+ * Helper function.
+ *
+ * Removes a device from the list and from any roles it has and then destroys
+ * it, the list is kept packed so the order of the other devices is kept.
+ *
+ * @ingroup aux_util
+ */
+void
+u_system_devices_remove_device(struct xrt_system_devices *xsysd, struct xrt_device **xdev_ptr);
+
 /*!
  * Destroy an u_system_devices_allocate and owned devices - helper function.
  *
@@ -100,7 +100,28 @@ u_trace_marker_init(void)
 	}
 }
 
-#else // !U_TRACE_PERCETTO
+#elif defined(U_TRACE_RECORDER)
+
+static enum u_trace_which static_which;
+
+
+void
+u_trace_marker_setup(enum u_trace_which which)
+{
+	static_which = which;
+}
+
+void
+u_trace_marker_init(void)
+{
+	/*
+	 * The rings and the key destructor live for as long as the process,
+	 * which the client library can't assume, it might get unloaded.
+	 */
+	u_trace_recorder_init(static_which == U_TRACE_WHICH_SERVICE);
+}
+
+#else // !U_TRACE_PERCETTO && !U_TRACE_RECORDER
 
 void
 u_trace_marker_setup(enum u_trace_which which)
@@ -116,4 +137,4 @@ u_trace_marker_init(void)
 	// Noop
 }
 
-#endif // !U_TRACE_PERCETTO
+#endif // !U_TRACE_PERCETTO && !U_TRACE_RECORDER
@@ -30,6 +30,11 @@
 #include <percetto.h>
 #endif
 
+#if !defined(XRT_FEATURE_TRACING) && defined(XRT_FEATURE_TRACING_RECORDER)
+#define U_TRACE_RECORDER
+#include "util/u_trace_recorder.h"
+#endif
+
 #if !defined(XRT_FEATURE_TRACING) || !defined(XRT_HAVE_TRACY)
 #define U_TRACE_FUNC_COLOR(CATEGORY, COLOR)                                                                            \
 	(void)COLOR;                                                                                                   \
@@ -144,7 +149,7 @@ u_trace_marker_init(void);
  *
  */
 
-#ifndef XRT_FEATURE_TRACING
+#if !defined(XRT_FEATURE_TRACING) && !defined(XRT_FEATURE_TRACING_RECORDER)
 
 
 #define U_TRACE_FUNC(CATEGORY)                                                                                         \
@@ -188,6 +193,17 @@ u_trace_marker_init(void);
 		(void)STRING;                                                                                          \
 	} while (false)
 
+/*!
+ * Ask for the recent events to be saved, only does something with the flight
+ * recorder, see @ref tracing.
+ *
+ * @ingroup aux_util
+ */
+#define U_TRACE_REQUEST_DUMP(REASON)                                                                                   \
+	do {                                                                                                           \
+		(void)REASON;                                                                                          \
+	} while (false)
+
 /*!
  * Add to target c file to enable tracing, see @ref tracing.
  *
@@ -196,6 +212,62 @@ u_trace_marker_init(void);
 #define U_TRACE_TARGET_SETUP(WHICH)
 
 
+/*
+ *
+ * Flight recorder support.
+ *
+ */
+
+#elif !defined(XRT_FEATURE_TRACING) // && XRT_FEATURE_TRACING_RECORDER
+
+#define U_TRACE_RECORDER_SCOPE(CATEGORY, NAME, VAR)                                                                    \
+	static const struct u_trace_recorder_location VAR##_loc = {#CATEGORY, NAME};                                   \
+	const struct u_trace_recorder_location *__attribute__((cleanup(u_trace_recorder_scope_cleanup))) VAR =         \
+	    u_trace_recorder_begin(&VAR##_loc);                                                                        \
+	(void)VAR
+
+#define U_TRACE_FUNC(CATEGORY) U_TRACE_RECORDER_SCOPE(CATEGORY, __func__, __trace_func)
+
+#define U_TRACE_IDENT(CATEGORY, IDENT) U_TRACE_RECORDER_SCOPE(CATEGORY, #IDENT, __trace_scope_##IDENT)
+
+#define U_TRACE_BEGIN(CATEGORY, IDENT)                                                                                 \
+	static const struct u_trace_recorder_location __trace_##IDENT##_loc = {#CATEGORY, #IDENT};                     \
+	const struct u_trace_recorder_location *__trace_##IDENT = u_trace_recorder_begin(&__trace_##IDENT##_loc)
+
+#define U_TRACE_END(CATEGORY, IDENT) u_trace_recorder_end(__trace_##IDENT)
+
+// Events on tracks have their own timestamps, they are not recorded.
+#define U_TRACE_EVENT_BEGIN_ON_TRACK(CATEGORY, TRACK, TIME, NAME)                                                      \
+	do {                                                                                                           \
+	} while (false)
+
+#define U_TRACE_EVENT_BEGIN_ON_TRACK_DATA(CATEGORY, TRACK, TIME, NAME, ...)                                            \
+	do {                                                                                                           \
+	} while (false)
+
+#define U_TRACE_EVENT_END_ON_TRACK(CATEGORY, TRACK, TIME)                                                              \
+	do {                                                                                                           \
+	} while (false)
+
+#define U_TRACE_INSTANT_ON_TRACK(CATEGORY, TRACK, TIME, NAME)                                                          \
+	do {                                                                                                           \
+	} while (false)
+
+#define U_TRACE_CATEGORY_IS_ENABLED(_) (false)
+
+#define U_TRACE_SET_THREAD_NAME(STRING) u_trace_recorder_set_thread_name(STRING)
+
+#define U_TRACE_REQUEST_DUMP(REASON) u_trace_recorder_request_dump(REASON)
+
+#define U_TRACE_TARGET_SETUP(WHICH)                                                                                    \
+	void __attribute__((constructor(101))) u_trace_marker_constructor(void);                                       \
+                                                                                                                       \
+	void u_trace_marker_constructor(void)                                                                          \
+	{                                                                                                              \
+		u_trace_marker_setup(WHICH);                                                                           \
+	}
+
+
 /*
  *
  * Tracy support.
@@ -305,6 +377,11 @@ u_trace_scope_cleanup(TracyCZoneCtx *ctx_ptr)
 		TracyCZoneEnd(created);                                                                                \
 	} while (false)
 
+#define U_TRACE_REQUEST_DUMP(REASON)                                                                                   \
+	do {                                                                                                           \
+		(void)REASON;                                                                                          \
+	} while (false)
+
 #define U_TRACE_TARGET_SETUP(WHICH)
 
 
@@ -365,6 +442,11 @@ PERCETTO_TRACK_DECLARE(pa_wait);
 		(void)STRING;                                                                                          \
 	} while (false)
 
+#define U_TRACE_REQUEST_DUMP(REASON)                                                                                   \
+	do {                                                                                                           \
+		(void)REASON;                                                                                          \
+	} while (false)
+
 #define U_TRACE_TARGET_SETUP(WHICH)                                                                                    \
 	void __attribute__((constructor(101))) u_trace_marker_constructor(void);                                       \
                                                                                                                        \
@@ -0,0 +1,514 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Always-on flight recorder tracing backend, see @ref tracing.
+ * @author agent <agent@local>
+ * @ingroup aux_util
+ */
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_config_os.h"
+
+#include "os/os_threading.h"
+#include "os/os_time.h"
+
+#include "util/u_debug.h"
+#include "util/u_file.h"
+#include "util/u_logging.h"
+#include "util/u_misc.h"
+#include "util/u_time.h"
+#include "util/u_trace_marker.h"
+#include "util/u_trace_recorder.h"
+
+#ifndef XRT_OS_LINUX
+#error "The flight recorder is only supported on Linux"
+#endif
+
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+
+DEBUG_GET_ONCE_TRISTATE_OPTION(trace_recorder, "XRT_TRACE_RECORDER")
+DEBUG_GET_ONCE_BOOL_OPTION(trace_recorder_auto_dump, "XRT_TRACE_RECORDER_AUTO_DUMP", false)
+DEBUG_GET_ONCE_NUM_OPTION(trace_recorder_auto_dump_interval_s, "XRT_TRACE_RECORDER_AUTO_DUMP_INTERVAL_S", 30)
+
+
+/*
+ *
+ * Structs and defines.
+ *
+ */
+
+enum ring_state
+{
+	//! Free to be claimed, the owner has exited.
+	RING_STATE_FREE = 0,
+	RING_STATE_OWNED = 1,
+};
+
+//! Set in @ref event::stamp for the end of a scope, timestamps never get near it.
+#define EVENT_END_BIT (1ull << 63)
+
+//! Kept to 16 bytes, there are a lot of them.
+struct event
+{
+	//! Timestamp in nanoseconds, with @ref EVENT_END_BIT for the end of a scope.
+	uint64_t stamp;
+	const struct u_trace_recorder_location *loc;
+};
+
+/*!
+ * Events of one thread, only the owning thread writes to it so recording is
+ * a plain store and a release of @p head.
+ */
+struct ring
+{
+	struct event events[U_TRACE_RECORDER_RING_SIZE];
+
+	//! Total number of events written, the next is at this modulo the size.
+	uint64_t head;
+
+	//! First event of the current owner, rings are reused.
+	uint64_t first;
+
+	xrt_atomic_s32_t state;
+	int32_t tid;
+	char name[64];
+
+	//! Rings are never removed from the list, only reused.
+	struct ring *next;
+};
+
+struct recorder
+{
+	//! Protects the list of rings, never taken when recording.
+	pthread_mutex_t mutex;
+	struct ring *rings;
+	uint32_t ring_count;
+
+	pthread_once_t key_once;
+	pthread_key_t key;
+
+	bool enabled;
+
+	struct
+	{
+		bool enabled;
+		uint64_t interval_ns;
+		uint64_t last_ns;
+		const char *reason;
+		bool started;
+		struct os_thread_helper oth;
+	} auto_dump;
+
+	xrt_atomic_s32_t dump_count;
+};
+
+static struct recorder g_recorder = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .key_once = PTHREAD_ONCE_INIT,
+};
+
+//! The ring of the calling thread, NULL until it records its first event.
+static __thread struct ring *t_ring = NULL;
+
+//! Set if there were no rings left for the calling thread.
+static __thread bool t_no_ring = false;
+
+
+/*
+ *
+ * Ring functions.
+ *
+ */
+
+static void
+ring_release(void *ptr)
+{
+	struct ring *r = (struct ring *)ptr;
+
+	// Destructors that run after this one must not write to a ring someone else owns.
+	t_ring = NULL;
+	t_no_ring = true;
+
+	// Full barrier, every event is written before the ring can be claimed.
+	xrt_atomic_s32_cmpxchg(&r->state, RING_STATE_OWNED, RING_STATE_FREE);
+}
+
+static void
+create_key(void)
+{
+	pthread_key_create(&g_recorder.key, ring_release);
+}
+
+static struct ring *
+claim_ring(void)
+{
+	struct recorder *rec = &g_recorder;
+	struct ring *r = NULL;
+
+	pthread_once(&rec->key_once, create_key);
+
+	pthread_mutex_lock(&rec->mutex);
+
+	for (struct ring *it = rec->rings; it != NULL; it = it->next) {
+		if (xrt_atomic_s32_cmpxchg(&it->state, RING_STATE_FREE, RING_STATE_OWNED) == RING_STATE_FREE) {
+			r = it;
+			break;
+		}
+	}
+
+	if (r == NULL && rec->ring_count < U_TRACE_RECORDER_MAX_THREADS) {
+		r = U_TYPED_CALLOC(struct ring);
+		if (r != NULL) {
+			r->state = RING_STATE_OWNED;
+			r->next = rec->rings;
+			rec->rings = r;
+			rec->ring_count++;
+		}
+	}
+
+	if (r != NULL) {
+		// Done with the lock held so a dump never sees a half claimed ring.
+		r->first = r->head;
+		r->tid = (int32_t)syscall(SYS_gettid);
+		r->name[0] = '\0';
+	}
+
+	pthread_mutex_unlock(&rec->mutex);
+
+	if (r != NULL) {
+		pthread_setspecific(rec->key, r);
+	}
+
+	return r;
+}
+
+static inline struct ring *
+get_ring(void)
+{
+	struct ring *r = t_ring;
+	if (r != NULL || t_no_ring) {
+		return r;
+	}
+
+	r = claim_ring();
+	t_ring = r;
+	t_no_ring = r == NULL;
+
+	return r;
+}
+
+static inline void
+record(const struct u_trace_recorder_location *loc, uint64_t end_bit)
+{
+	if (!__atomic_load_n(&g_recorder.enabled, __ATOMIC_RELAXED)) {
+		return;
+	}
+
+	struct ring *r = get_ring();
+	if (r == NULL) {
+		return;
+	}
+
+	uint64_t head = r->head;
+	struct event *e = &r->events[head % U_TRACE_RECORDER_RING_SIZE];
+	e->stamp = os_monotonic_get_ns() | end_bit;
+	e->loc = loc;
+
+	// Publishes the event to dumps.
+	__atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/*!
+ * Copies the events of a ring without stopping the owner, returns the index
+ * into @p out of the first event that was not overwritten while copying.
+ */
+static uint32_t
+copy_events(struct ring *r, struct event *out, uint32_t *out_count)
+{
+	uint64_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+	uint64_t start = head > U_TRACE_RECORDER_RING_SIZE ? head - U_TRACE_RECORDER_RING_SIZE : 0;
+	if (start < r->first) {
+		start = r->first;
+	}
+
+	for (uint64_t i = start; i < head; i++) {
+		out[i - start] = r->events[i % U_TRACE_RECORDER_RING_SIZE];
+	}
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	uint64_t new_head = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+
+	// The slots of everything written since, and the one being written, now hold newer events.
+	uint64_t valid = new_head + 1 > U_TRACE_RECORDER_RING_SIZE ? new_head + 1 - U_TRACE_RECORDER_RING_SIZE : 0;
+	uint64_t skip = valid > start ? valid - start : 0;
+
+	*out_count = (uint32_t)(head - start);
+
+	return (uint32_t)(skip < head - start ? skip : head - start);
+}
+
+
+/*
+ *
+ * Json functions.
+ *
+ */
+
+//! Names come from the code, but quotes and backslashes would still break the file.
+static void
+write_string(FILE *file, const char *str)
+{
+	fputc('"', file);
+	for (const char *c = str; *c != '\0'; c++) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', file);
+		} else if ((unsigned char)*c < 0x20) {
+			continue;
+		}
+		fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+static void
+write_ring(FILE *file, struct ring *r, struct event *events, uint64_t cutoff_ns, int pid, bool *first)
+{
+	uint32_t count = 0;
+	uint32_t start = copy_events(r, events, &count);
+
+	fprintf(file, "%s\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%i,\"tid\":%" PRIi32 ",\"args\":{\"name\":",
+	        *first ? "" : ",", pid, r->tid);
+	if (r->name[0] != '\0') {
+		write_string(file, r->name);
+	} else {
+		fprintf(file, "\"Thread %" PRIi32 "\"", r->tid);
+	}
+	fprintf(file, "}}");
+	*first = false;
+
+	// Ends of scopes that began before the window would confuse viewers.
+	uint32_t depth = 0;
+
+	for (uint32_t i = start; i < count; i++) {
+		const struct event *e = &events[i];
+		uint64_t timestamp_ns = e->stamp & ~EVENT_END_BIT;
+		char phase = (e->stamp & EVENT_END_BIT) != 0 ? 'E' : 'B';
+
+		if (timestamp_ns < cutoff_ns) {
+			continue;
+		}
+
+		if (phase == 'E') {
+			if (depth == 0) {
+				continue;
+			}
+			depth--;
+		} else {
+			depth++;
+		}
+
+		fprintf(file, ",\n{\"ph\":\"%c\",\"cat\":", phase);
+		write_string(file, e->loc->category);
+		fprintf(file, ",\"name\":");
+		write_string(file, e->loc->name);
+		fprintf(file, ",\"pid\":%i,\"tid\":%" PRIi32 ",\"ts\":%" PRIu64 ".%03" PRIu64 "}", pid, r->tid,
+		        timestamp_ns / 1000, timestamp_ns % 1000);
+	}
+}
+
+
+/*
+ *
+ * Auto dump functions.
+ *
+ */
+
+static void *
+auto_dump_thread(void *ptr)
+{
+	struct recorder *rec = (struct recorder *)ptr;
+
+	U_TRACE_SET_THREAD_NAME("Trace Recorder");
+
+	os_thread_helper_lock(&rec->auto_dump.oth);
+
+	while (os_thread_helper_is_running_locked(&rec->auto_dump.oth)) {
+		if (rec->auto_dump.reason == NULL) {
+			os_thread_helper_wait_locked(&rec->auto_dump.oth);
+			continue;
+		}
+
+		const char *reason = rec->auto_dump.reason;
+		rec->auto_dump.reason = NULL;
+
+		// Don't hold up requests while writing.
+		os_thread_helper_unlock(&rec->auto_dump.oth);
+
+		char path[PATH_MAX];
+		if (u_trace_recorder_dump(U_TRACE_RECORDER_DEFAULT_WINDOW_NS, path, sizeof(path)) == XRT_SUCCESS) {
+			U_LOG_I("Wrote trace to '%s', because of: %s", path, reason);
+		}
+
+		os_thread_helper_lock(&rec->auto_dump.oth);
+	}
+
+	os_thread_helper_unlock(&rec->auto_dump.oth);
+
+	return NULL;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+u_trace_recorder_init(bool default_enabled)
+{
+	struct recorder *rec = &g_recorder;
+
+	enum debug_tristate_option option = debug_get_tristate_option_trace_recorder();
+	bool enabled = option == DEBUG_TRISTATE_ON || (option == DEBUG_TRISTATE_AUTO && default_enabled);
+
+	pthread_mutex_lock(&rec->mutex);
+
+	__atomic_store_n(&rec->enabled, enabled, __ATOMIC_RELAXED);
+
+	if (rec->enabled && debug_get_bool_option_trace_recorder_auto_dump() && !rec->auto_dump.started) {
+		long interval_s = debug_get_num_option_trace_recorder_auto_dump_interval_s();
+
+		rec->auto_dump.interval_ns = (uint64_t)(interval_s > 0 ? interval_s : 0) * U_TIME_1S_IN_NS;
+		rec->auto_dump.started = os_thread_helper_init(&rec->auto_dump.oth) == 0 &&
+		                         os_thread_helper_start(&rec->auto_dump.oth, auto_dump_thread, rec) == 0;
+		rec->auto_dump.enabled = rec->auto_dump.started;
+
+		// Lives for as long as the process, like the rings.
+	}
+
+	pthread_mutex_unlock(&rec->mutex);
+}
+
+void
+u_trace_recorder_set_enabled(bool enabled)
+{
+	__atomic_store_n(&g_recorder.enabled, enabled, __ATOMIC_RELAXED);
+}
+
+const struct u_trace_recorder_location *
+u_trace_recorder_begin(const struct u_trace_recorder_location *loc)
+{
+	record(loc, 0);
+	return loc;
+}
+
+void
+u_trace_recorder_end(const struct u_trace_recorder_location *loc)
+{
+	record(loc, EVENT_END_BIT);
+}
+
+void
+u_trace_recorder_set_thread_name(const char *name)
+{
+	// Don't claim a ring for a thread that is never going to record.
+	if (!__atomic_load_n(&g_recorder.enabled, __ATOMIC_RELAXED)) {
+		return;
+	}
+
+	struct ring *r = get_ring();
+	if (r == NULL) {
+		return;
+	}
+
+	snprintf(r->name, sizeof(r->name), "%s", name);
+}
+
+bool
+u_trace_recorder_write_json(FILE *file, uint64_t window_ns)
+{
+	struct recorder *rec = &g_recorder;
+
+	struct event *events = U_TYPED_ARRAY_CALLOC(struct event, U_TRACE_RECORDER_RING_SIZE);
+	if (events == NULL) {
+		return false;
+	}
+
+	uint64_t now_ns = os_monotonic_get_ns();
+	uint64_t cutoff_ns = now_ns > window_ns ? now_ns - window_ns : 0;
+	int pid = (int)getpid();
+	bool first = true;
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+	pthread_mutex_lock(&rec->mutex);
+	for (struct ring *r = rec->rings; r != NULL; r = r->next) {
+		write_ring(file, r, events, cutoff_ns, pid, &first);
+	}
+	pthread_mutex_unlock(&rec->mutex);
+
+	fprintf(file, "\n]}\n");
+
+	free(events);
+
+	return ferror(file) == 0;
+}
+
+xrt_result_t
+u_trace_recorder_dump(uint64_t window_ns, char *out_path, size_t out_path_size)
+{
+	char filename[64];
+	snprintf(filename, sizeof(filename), "monado-trace-%i-%" PRIi32 ".json", (int)getpid(),
+	         xrt_atomic_s32_inc_return(&g_recorder.dump_count));
+
+	if (u_file_get_path_in_runtime_dir(filename, out_path, out_path_size) <= 0) {
+		return XRT_ERROR_ALLOCATION;
+	}
+
+	FILE *file = fopen(out_path, "w");
+	if (file == NULL) {
+		U_LOG_E("Could not open '%s' for writing", out_path);
+		return XRT_ERROR_ALLOCATION;
+	}
+
+	bool ok = u_trace_recorder_write_json(file, window_ns);
+	ok = fclose(file) == 0 && ok;
+
+	if (!ok) {
+		U_LOG_E("Failed to write trace to '%s'", out_path);
+		return XRT_ERROR_ALLOCATION;
+	}
+
+	return XRT_SUCCESS;
+}
+
+void
+u_trace_recorder_request_dump(const char *reason)
+{
+	struct recorder *rec = &g_recorder;
+
+	if (!rec->auto_dump.enabled) {
+		return;
+	}
+
+	uint64_t now_ns = os_monotonic_get_ns();
+
+	os_thread_helper_lock(&rec->auto_dump.oth);
+
+	if (rec->auto_dump.last_ns == 0 || now_ns - rec->auto_dump.last_ns >= rec->auto_dump.interval_ns) {
+		rec->auto_dump.last_ns = now_ns;
+		rec->auto_dump.reason = reason;
+		os_thread_helper_signal_locked(&rec->auto_dump.oth);
+	}
+
+	os_thread_helper_unlock(&rec->auto_dump.oth);
+}
@@ -0,0 +1,143 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Always-on flight recorder tracing backend, see @ref tracing.
+ * @author agent <agent@local>
+ * @ingroup aux_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_results.h"
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Number of events kept per thread, older events are overwritten.
+ *
+ * @ingroup aux_util
+ */
+#define U_TRACE_RECORDER_RING_SIZE (16384)
+
+/*!
+ * Maximum number of threads that get a ring, rings of threads that have
+ * exited are reused.
+ *
+ * @ingroup aux_util
+ */
+#define U_TRACE_RECORDER_MAX_THREADS (64)
+
+/*!
+ * Default window, in nanoseconds, for dumps that don't ask for one.
+ *
+ * @ingroup aux_util
+ */
+#define U_TRACE_RECORDER_DEFAULT_WINDOW_NS (5ull * 1000 * 1000 * 1000)
+
+/*!
+ * Where a traced scope is, the event only records a pointer to it so both
+ * strings must have static storage.
+ *
+ * @ingroup aux_util
+ */
+struct u_trace_recorder_location
+{
+	const char *category;
+	const char *name;
+};
+
+/*!
+ * Reads the options and enables recording, called from
+ * @ref u_trace_marker_init, events before that are not recorded.
+ *
+ * @param default_enabled Record if `XRT_TRACE_RECORDER` isn't set, only the
+ *                        service does by default.
+ *
+ * @ingroup aux_util
+ */
+void
+u_trace_recorder_init(bool default_enabled);
+
+/*!
+ * Turn recording on or off, mostly for tests and benchmarks.
+ *
+ * @ingroup aux_util
+ */
+void
+u_trace_recorder_set_enabled(bool enabled);
+
+/*!
+ * Record the start of a scope on the calling thread, returns @p loc so it can
+ * be kept in a scope variable and given to @ref u_trace_recorder_end.
+ *
+ * @ingroup aux_util
+ */
+const struct u_trace_recorder_location *
+u_trace_recorder_begin(const struct u_trace_recorder_location *loc);
+
+/*!
+ * Record the end of a scope on the calling thread.
+ *
+ * @ingroup aux_util
+ */
+void
+u_trace_recorder_end(const struct u_trace_recorder_location *loc);
+
+/*!
+ * Name the calling thread in dumps, the string is copied.
+ *
+ * @ingroup aux_util
+ */
+void
+u_trace_recorder_set_thread_name(const char *name);
+
+/*!
+ * Write the events of all threads from the last @p window_ns nanoseconds as
+ * Chrome trace json, which can be loaded into chrome://tracing or Perfetto.
+ *
+ * Recording threads are never stopped, events that are overwritten while
+ * being copied are left out.
+ *
+ * @ingroup aux_util
+ */
+bool
+u_trace_recorder_write_json(FILE *file, uint64_t window_ns);
+
+/*!
+ * Write the last @p window_ns nanoseconds to a new file in the runtime
+ * directory, the path is returned in @p out_path.
+ *
+ * @ingroup aux_util
+ */
+xrt_result_t
+u_trace_recorder_dump(uint64_t window_ns, char *out_path, size_t out_path_size);
+
+/*!
+ * Ask for a dump from a thread that can't block on writing it, like the
+ * compositor thread after a missed frame. Only does anything if dumps on
+ * request are enabled with `XRT_TRACE_RECORDER_AUTO_DUMP`, and at most once
+ * every `XRT_TRACE_RECORDER_AUTO_DUMP_INTERVAL_S` seconds.
+ *
+ * @ingroup aux_util
+ */
+void
+u_trace_recorder_request_dump(const char *reason);
+
+//! Helper for the scope macros, see @ref tracing.
+static inline void
+u_trace_recorder_scope_cleanup(const struct u_trace_recorder_location *const *loc_ptr)
+{
+	u_trace_recorder_end(*loc_ptr);
+}
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -245,6 +245,54 @@ fill_in_device_features(struct vk_bundle *vk)
 	free(props);
 }
 
+static void
+fill_in_fragment_shading_rate_properties(struct vk_bundle *vk)
+{
+#ifdef VK_KHR_fragment_shading_rate
+	if (!vk->features.attachment_fragment_shading_rate) {
+		return;
+	}
+
+	VkPhysicalDeviceFragmentShadingRatePropertiesKHR fsr_props = {
+	    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_PROPERTIES_KHR,
+	};
+	VkPhysicalDeviceProperties2 props = {
+	    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+	    .pNext = &fsr_props,
+	};
+	vk->vkGetPhysicalDeviceProperties2(vk->physical_device, &props);
+
+	// Use 16x16 texels where possible, small enough for smooth rings.
+	VkExtent2D min = fsr_props.minFragmentShadingRateAttachmentTexelSize;
+	VkExtent2D max = fsr_props.maxFragmentShadingRateAttachmentTexelSize;
+	VkExtent2D texel = {16, 16};
+	texel.width = texel.width < min.width ? min.width : texel.width > max.width ? max.width : texel.width;
+	texel.height = texel.height < min.height ? min.height : texel.height > max.height ? max.height : texel.height;
+	vk->features.fragment_shading_rate_texel_width = texel.width;
+	vk->features.fragment_shading_rate_texel_height = texel.height;
+
+	uint32_t count = 0;
+	vk->vkGetPhysicalDeviceFragmentShadingRatesKHR(vk->physical_device, &count, NULL);
+
+	VkPhysicalDeviceFragmentShadingRateKHR *rates =
+	    U_TYPED_ARRAY_CALLOC(VkPhysicalDeviceFragmentShadingRateKHR, count);
+	for (uint32_t i = 0; i < count; i++) {
+		rates[i].sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_KHR;
+	}
+	vk->vkGetPhysicalDeviceFragmentShadingRatesKHR(vk->physical_device, &count, rates);
+
+	// 2x2 is required by the spec when the feature is supported.
+	vk->features.fragment_shading_rate_max_log2 = 1;
+	for (uint32_t i = 0; i < count; i++) {
+		if (rates[i].fragmentSize.width == 4 && rates[i].fragmentSize.height == 4) {
+			vk->features.fragment_shading_rate_max_log2 = 2;
+		}
+	}
+
+	free(rates);
+#endif
+}
+
 static void
 get_external_image_support(struct vk_bundle *vk,
                            bool depth,
@@ -729,6 +777,7 @@ fill_in_has_device_extensions(struct vk_bundle *vk, struct u_string_list *ext_li
 	vk->has_KHR_external_fence_fd = false;
 	vk->has_KHR_external_semaphore_fd = false;
 	vk->has_KHR_format_feature_flags2 = false;
+	vk->has_KHR_fragment_shading_rate = false;
 	vk->has_KHR_global_priority = false;
 	vk->has_KHR_image_format_list = false;
 	vk->has_KHR_maintenance1 = false;
@@ -772,6 +821,13 @@ fill_in_has_device_extensions(struct vk_bundle *vk, struct u_string_list *ext_li
 		}
 #endif // defined(VK_KHR_format_feature_flags2)
 
+#if defined(VK_KHR_fragment_shading_rate)
+		if (strcmp(ext, VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME) == 0) {
+			vk->has_KHR_fragment_shading_rate = true;
+			continue;
+		}
+#endif // defined(VK_KHR_fragment_shading_rate)
+
 #if defined(VK_KHR_global_priority)
 		if (strcmp(ext, VK_KHR_GLOBAL_PRIORITY_EXTENSION_NAME) == 0) {
 			vk->has_KHR_global_priority = true;
@@ -1271,6 +1327,8 @@ vk_init_from_given(struct vk_bundle *vk,
                    bool external_fence_fd_enabled,
                    bool external_semaphore_fd_enabled,
                    bool timeline_semaphore_enabled,
+                   bool fragment_shading_rate_enabled,
+                   bool image_format_list_enabled,
                    enum u_logging_level log_level)
 {
 	VkResult ret;
@@ -1321,8 +1379,24 @@ vk_init_from_given(struct vk_bundle *vk,
 	}
 #endif
 
+#ifdef VK_KHR_fragment_shading_rate
+	// Has the fragment shading rate extension and attachment feature been enabled?
+	if (fragment_shading_rate_enabled) {
+		vk->has_KHR_fragment_shading_rate = true;
+		vk->features.attachment_fragment_shading_rate = true;
+	}
+#endif
+
+#ifdef VK_KHR_image_format_list
+	// Vulkan does not let us read what extensions was enabled.
+	if (image_format_list_enabled) {
+		vk->has_KHR_image_format_list = true;
+	}
+#endif
+
 	// Fill in the device features we are interested in.
 	fill_in_device_features(vk);
+	fill_in_fragment_shading_rate_properties(vk);
 
 	// Fill in external object properties.
 	fill_in_external_object_properties(vk);
@@ -172,6 +172,35 @@ vk_csci_get_image_view_aspect(VkFormat format, enum xrt_swapchain_usage_bits bit
 #undef CASE_S
 }
 
+uint32_t
+vk_csci_get_image_view_formats(struct vk_bundle *vk,
+                               const struct xrt_swapchain_create_info *info,
+                               VkFormat out_formats[VK_CSCI_MAX_VIEW_FORMATS])
+{
+	if ((info->bits & XRT_SWAPCHAIN_USAGE_MUTABLE_FORMAT) == 0 || info->format_count == 0 ||
+	    info->format_count > XRT_MAX_SWAPCHAIN_CREATE_INFO_FORMAT_LIST_COUNT || !vk->has_KHR_image_format_list) {
+		return 0;
+	}
+
+	uint32_t count = 0;
+	out_formats[count++] = (VkFormat)info->format;
+
+	for (uint32_t i = 0; i < info->format_count; i++) {
+		VkFormat format = (VkFormat)info->formats[i];
+
+		bool found = false;
+		for (uint32_t k = 0; k < count; k++) {
+			found = found || out_formats[k] == format;
+		}
+
+		if (!found) {
+			out_formats[count++] = format;
+		}
+	}
+
+	return count;
+}
+
 VkImageUsageFlags
 vk_csci_get_image_usage_flags(struct vk_bundle *vk, VkFormat format, enum xrt_swapchain_usage_bits bits)
 {
@@ -96,6 +96,11 @@ vk_get_instance_functions(struct vk_bundle *vk)
 
 #endif // defined(VK_EXT_calibrated_timestamps)
 
+#if defined(VK_KHR_fragment_shading_rate)
+	vk->vkGetPhysicalDeviceFragmentShadingRatesKHR        = GET_INS_PROC(vk, vkGetPhysicalDeviceFragmentShadingRatesKHR);
+
+#endif // defined(VK_KHR_fragment_shading_rate)
+
 #if defined(VK_USE_PLATFORM_DISPLAY_KHR)
 	vk->vkCreateDisplayPlaneSurfaceKHR                    = GET_INS_PROC(vk, vkCreateDisplayPlaneSurfaceKHR);
 	vk->vkGetDisplayPlaneCapabilitiesKHR                  = GET_INS_PROC(vk, vkGetDisplayPlaneCapabilitiesKHR);
@@ -284,6 +289,7 @@ vk_get_device_functions(struct vk_bundle *vk)
 
 #if !defined(VK_USE_PLATFORM_WIN32_KHR)
 	vk->vkGetMemoryFdKHR                            = GET_DEV_PROC(vk, vkGetMemoryFdKHR);
+	vk->vkGetMemoryFdPropertiesKHR                  = GET_DEV_PROC(vk, vkGetMemoryFdPropertiesKHR);
 	vk->vkGetFenceFdKHR                             = GET_DEV_PROC(vk, vkGetFenceFdKHR);
 	vk->vkGetSemaphoreFdKHR                         = GET_DEV_PROC(vk, vkGetSemaphoreFdKHR);
 	vk->vkImportFenceFdKHR                          = GET_DEV_PROC(vk, vkImportFenceFdKHR);
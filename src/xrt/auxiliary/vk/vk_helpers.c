@@ -905,6 +905,25 @@ vk_create_image_from_native(struct vk_bundle *vk,
 		vk_info.flags |= VK_IMAGE_CREATE_PROTECTED_BIT;
 	}
 
+	if (0 != (info->bits & XRT_SWAPCHAIN_USAGE_MUTABLE_FORMAT)) {
+		vk_info.flags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT;
+	}
+
+#ifdef VK_KHR_image_format_list
+	// Must match the list the images were allocated with.
+	VkFormat view_formats[VK_CSCI_MAX_VIEW_FORMATS];
+	VkImageFormatListCreateInfoKHR image_format_list_create_info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO_KHR,
+	    .pNext = vk_info.pNext,
+	    .viewFormatCount = vk_csci_get_image_view_formats(vk, info, view_formats),
+	    .pViewFormats = view_formats,
+	};
+
+	if (image_format_list_create_info.viewFormatCount > 0) {
+		vk_info.pNext = &image_format_list_create_info;
+	}
+#endif
+
 	VkImage image = VK_NULL_HANDLE;
 	ret = vk->vkCreateImage(vk->device, &vk_info, NULL, &image);
 	if (ret != VK_SUCCESS) {
@@ -133,6 +133,7 @@ struct vk_bundle
 	bool has_KHR_external_fence_fd;
 	bool has_KHR_external_semaphore_fd;
 	bool has_KHR_format_feature_flags2;
+	bool has_KHR_fragment_shading_rate;
 	bool has_KHR_global_priority;
 	bool has_KHR_image_format_list;
 	bool has_KHR_maintenance1;
@@ -169,6 +170,16 @@ struct vk_bundle
 
 		//! Per stage limit on storage images.
 		uint32_t max_per_stage_descriptor_storage_images;
+
+		//! Was attachment fragment shading rate requested, available, and enabled?
+		bool attachment_fragment_shading_rate;
+
+		//! Size in pixels covered by one texel of a fragment shading rate attachment.
+		uint32_t fragment_shading_rate_texel_width;
+		uint32_t fragment_shading_rate_texel_height;
+
+		//! Largest supported square fragment size as log2, 1 is 2x2 and 2 is 4x4.
+		uint32_t fragment_shading_rate_max_log2;
 	} features;
 
 	//! Is the GPU a tegra device.
@@ -217,6 +228,11 @@ struct vk_bundle
 
 #endif // defined(VK_EXT_calibrated_timestamps)
 
+#if defined(VK_KHR_fragment_shading_rate)
+	PFN_vkGetPhysicalDeviceFragmentShadingRatesKHR vkGetPhysicalDeviceFragmentShadingRatesKHR;
+
+#endif // defined(VK_KHR_fragment_shading_rate)
+
 #if defined(VK_USE_PLATFORM_DISPLAY_KHR)
 	PFN_vkCreateDisplayPlaneSurfaceKHR vkCreateDisplayPlaneSurfaceKHR;
 	PFN_vkGetDisplayPlaneCapabilitiesKHR vkGetDisplayPlaneCapabilitiesKHR;
@@ -396,6 +412,7 @@ struct vk_bundle
 
 #if !defined(VK_USE_PLATFORM_WIN32_KHR)
 	PFN_vkGetMemoryFdKHR vkGetMemoryFdKHR;
+	PFN_vkGetMemoryFdPropertiesKHR vkGetMemoryFdPropertiesKHR;
 	PFN_vkGetFenceFdKHR vkGetFenceFdKHR;
 	PFN_vkGetSemaphoreFdKHR vkGetSemaphoreFdKHR;
 	PFN_vkImportFenceFdKHR vkImportFenceFdKHR;
@@ -810,6 +827,8 @@ vk_init_from_given(struct vk_bundle *vk,
                    bool external_fence_fd_enabled,
                    bool external_semaphore_fd_enabled,
                    bool timeline_semaphore_enabled,
+                   bool fragment_shading_rate_enabled,
+                   bool image_format_list_enabled,
                    enum u_logging_level log_level);
 
 
@@ -1285,6 +1304,29 @@ vk_csci_get_image_usage_flags(struct vk_bundle *vk, VkFormat format, enum xrt_sw
 VkImageAspectFlags
 vk_csci_get_image_view_aspect(VkFormat format, enum xrt_swapchain_usage_bits bits);
 
+/*!
+ * Max formats returned by @ref vk_csci_get_image_view_formats.
+ */
+#define VK_CSCI_MAX_VIEW_FORMATS (XRT_MAX_SWAPCHAIN_CREATE_INFO_FORMAT_LIST_COUNT + 1)
+
+/*!
+ * Fills in the formats to chain as a `VkImageFormatListCreateInfoKHR` when
+ * creating the images and returns how many there are. Zero means no list is
+ * chained: the swapchain isn't mutable, the app gave no formats or the
+ * extension isn't enabled. The format of the swapchain itself is always in
+ * the list, it is what the compositor samples the images as.
+ *
+ * Drivers can only keep the images compressed when they know every view
+ * format, and may pick a different layout depending on the list, so the side
+ * allocating and the side importing the images must chain the same one.
+ *
+ * CSCI = Compositor SwapChain Images.
+ */
+uint32_t
+vk_csci_get_image_view_formats(struct vk_bundle *vk,
+                               const struct xrt_swapchain_create_info *info,
+                               VkFormat out_formats[VK_CSCI_MAX_VIEW_FORMATS]);
+
 /*!
  * Return the extern handle type that a image should be created with.
  *
@@ -64,6 +64,7 @@ create_image(struct vk_bundle *vk, const struct xrt_swapchain_create_info *info,
 	VkImage image = VK_NULL_HANDLE;
 	VkResult ret = VK_SUCCESS;
 	VkDeviceSize size;
+	bool view_format_list_chained = false;
 
 #if defined(XRT_GRAPHICS_BUFFER_HANDLE_IS_AHARDWAREBUFFER)
 	/*
@@ -161,6 +162,7 @@ create_image(struct vk_bundle *vk, const struct xrt_swapchain_create_info *info,
 #ifdef VK_KHR_image_format_list
 		if (vk->has_KHR_image_format_list) {
 			CHAIN(image_format_list_create_info);
+			view_format_list_chained = true;
 		}
 #endif
 	}
@@ -170,6 +172,25 @@ create_image(struct vk_bundle *vk, const struct xrt_swapchain_create_info *info,
 		image_create_flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
 	}
 
+	if ((info->bits & XRT_SWAPCHAIN_USAGE_MUTABLE_FORMAT) != 0) {
+		image_create_flags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT;
+	}
+
+#ifdef VK_KHR_image_format_list
+	// Without a list many drivers turn off compression for mutable images.
+	VkFormat view_formats[VK_CSCI_MAX_VIEW_FORMATS];
+	VkImageFormatListCreateInfoKHR view_format_list_create_info = {
+	    .sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO_KHR,
+	    .viewFormatCount = vk_csci_get_image_view_formats(vk, info, view_formats),
+	    .pViewFormats = view_formats,
+	};
+
+	if (view_format_list_create_info.viewFormatCount > 0 && !view_format_list_chained) {
+		CHAIN(view_format_list_create_info);
+	}
+#endif
+	(void)view_format_list_chained;
+
 	VkImageCreateInfo create_info = {
 	    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
 	    .pNext = next_chain,
@@ -48,16 +48,18 @@ vk_print_opened_device_info(struct vk_bundle *vk, enum u_logging_level log_level
 void
 vk_print_features_info(struct vk_bundle *vk, enum u_logging_level log_level)
 {
-	U_LOG_IFL(log_level, vk->log_level,                                       //
-	          "Features:"                                                     //
-	          "\n\ttimestamp_compute_and_graphics: %s"                        //
-	          "\n\ttimestamp_period: %f"                                      //
-	          "\n\ttimestamp_valid_bits: %u"                                  //
-	          "\n\ttimeline_semaphore: %s",                                   //
-	          vk->features.timestamp_compute_and_graphics ? "true" : "false", //
-	          vk->features.timestamp_period,                                  //
-	          vk->features.timestamp_valid_bits,                              //
-	          vk->features.timeline_semaphore ? "true" : "false");            //
+	U_LOG_IFL(log_level, vk->log_level,                                          //
+	          "Features:"                                                        //
+	          "\n\ttimestamp_compute_and_graphics: %s"                           //
+	          "\n\ttimestamp_period: %f"                                         //
+	          "\n\ttimestamp_valid_bits: %u"                                     //
+	          "\n\ttimeline_semaphore: %s"                                       //
+	          "\n\tattachment_fragment_shading_rate: %s",                        //
+	          vk->features.timestamp_compute_and_graphics ? "true" : "false",    //
+	          vk->features.timestamp_period,                                     //
+	          vk->features.timestamp_valid_bits,                                 //
+	          vk->features.timeline_semaphore ? "true" : "false",                //
+	          vk->features.attachment_fragment_shading_rate ? "true" : "false"); //
 }
 
 void
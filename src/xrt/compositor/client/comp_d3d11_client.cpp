@@ -565,6 +565,37 @@ client_d3d11_compositor_layer_stereo_projection_depth(struct xrt_compositor *xc,
 	return xrt_comp_layer_stereo_projection_depth(&c->xcn->base, xdev, l_xscn, r_xscn, l_d_xscn, r_d_xscn, data);
 }
 
+static xrt_result_t
+client_d3d11_compositor_layer_stereo_projection_space_warp(struct xrt_compositor *xc,
+                                                           struct xrt_device *xdev,
+                                                           struct xrt_swapchain *l_xsc,
+                                                           struct xrt_swapchain *r_xsc,
+                                                           struct xrt_swapchain *l_d_xsc,
+                                                           struct xrt_swapchain *r_d_xsc,
+                                                           struct xrt_swapchain *l_mv_xsc,
+                                                           struct xrt_swapchain *r_mv_xsc,
+                                                           const struct xrt_layer_data *data)
+{
+	struct client_d3d11_compositor *c = as_client_d3d11_compositor(xc);
+
+	assert(data->type == XRT_LAYER_STEREO_PROJECTION_SPACE_WARP);
+
+	struct xrt_swapchain *l_xscn = as_client_d3d11_swapchain(l_xsc)->xsc.get();
+	struct xrt_swapchain *r_xscn = as_client_d3d11_swapchain(r_xsc)->xsc.get();
+	struct xrt_swapchain *l_d_xscn = as_client_d3d11_swapchain(l_d_xsc)->xsc.get();
+	struct xrt_swapchain *r_d_xscn = as_client_d3d11_swapchain(r_d_xsc)->xsc.get();
+	struct xrt_swapchain *l_mv_xscn = as_client_d3d11_swapchain(l_mv_xsc)->xsc.get();
+	struct xrt_swapchain *r_mv_xscn = as_client_d3d11_swapchain(r_mv_xsc)->xsc.get();
+
+	// No flip required: D3D11 swapchain image convention matches Vulkan, but NDC y points up.
+	struct xrt_layer_data d = *data;
+	d.stereo_space_warp.l_sw.ndc_y_up = true;
+	d.stereo_space_warp.r_sw.ndc_y_up = true;
+
+	return xrt_comp_layer_stereo_projection_space_warp(&c->xcn->base, xdev, l_xscn, r_xscn, l_d_xscn, r_d_xscn,
+	                                                   l_mv_xscn, r_mv_xscn, &d);
+}
+
 static xrt_result_t
 client_d3d11_compositor_layer_quad(struct xrt_compositor *xc,
                                    struct xrt_device *xdev,
@@ -645,6 +676,18 @@ client_d3d11_compositor_layer_equirect2(struct xrt_compositor *xc,
 	return xrt_comp_layer_equirect2(&c->xcn->base, xdev, xscfb, data);
 }
 
+static xrt_result_t
+client_d3d11_compositor_layer_passthrough(struct xrt_compositor *xc,
+                                          struct xrt_device *xdev,
+                                          const struct xrt_layer_data *data)
+{
+	struct client_d3d11_compositor *c = as_client_d3d11_compositor(xc);
+
+	assert(data->type == XRT_LAYER_PASSTHROUGH);
+
+	return xrt_comp_layer_passthrough(&c->xcn->base, xdev, data);
+}
+
 static xrt_result_t
 client_d3d11_compositor_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handle_t sync_handle)
 {
@@ -714,6 +757,17 @@ client_d3d11_compositor_get_swapchain_create_properties(struct xrt_compositor *x
 	return xrt_comp_get_swapchain_create_properties(&c->xcn->base, &xinfo, xsccp);
 }
 
+static xrt_result_t
+client_d3d11_compositor_set_performance_level(struct xrt_compositor *xc,
+                                              enum xrt_perf_domain domain,
+                                              enum xrt_perf_set_level level)
+{
+	struct client_d3d11_compositor *c = as_client_d3d11_compositor(xc);
+
+	// Pipe down call into native compositor.
+	return xrt_comp_set_performance_level(&c->xcn->base, domain, level);
+}
+
 static xrt_result_t
 client_d3d11_compositor_poll_events(struct xrt_compositor *xc, union xrt_compositor_event *out_xce)
 {
@@ -846,14 +900,17 @@ try {
 	c->base.base.layer_begin = client_d3d11_compositor_layer_begin;
 	c->base.base.layer_stereo_projection = client_d3d11_compositor_layer_stereo_projection;
 	c->base.base.layer_stereo_projection_depth = client_d3d11_compositor_layer_stereo_projection_depth;
+	c->base.base.layer_stereo_projection_space_warp = client_d3d11_compositor_layer_stereo_projection_space_warp;
 	c->base.base.layer_quad = client_d3d11_compositor_layer_quad;
 	c->base.base.layer_cube = client_d3d11_compositor_layer_cube;
 	c->base.base.layer_cylinder = client_d3d11_compositor_layer_cylinder;
 	c->base.base.layer_equirect1 = client_d3d11_compositor_layer_equirect1;
 	c->base.base.layer_equirect2 = client_d3d11_compositor_layer_equirect2;
+	c->base.base.layer_passthrough = client_d3d11_compositor_layer_passthrough;
 	c->base.base.layer_commit = client_d3d11_compositor_layer_commit;
 	c->base.base.destroy = client_d3d11_compositor_destroy;
 	c->base.base.poll_events = client_d3d11_compositor_poll_events;
+	c->base.base.set_performance_level = client_d3d11_compositor_set_performance_level;
 
 
 	// Passthrough our formats from the native compositor to the client.
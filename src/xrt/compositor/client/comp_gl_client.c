@@ -279,6 +279,43 @@ client_gl_compositor_layer_stereo_projection_depth(struct xrt_compositor *xc,
 	return xrt_comp_layer_stereo_projection_depth(&c->xcn->base, xdev, l_xscn, r_xscn, l_d_xscn, r_d_xscn, &d);
 }
 
+static xrt_result_t
+client_gl_compositor_layer_stereo_projection_space_warp(struct xrt_compositor *xc,
+                                                        struct xrt_device *xdev,
+                                                        struct xrt_swapchain *l_xsc,
+                                                        struct xrt_swapchain *r_xsc,
+                                                        struct xrt_swapchain *l_d_xsc,
+                                                        struct xrt_swapchain *r_d_xsc,
+                                                        struct xrt_swapchain *l_mv_xsc,
+                                                        struct xrt_swapchain *r_mv_xsc,
+                                                        const struct xrt_layer_data *data)
+{
+	struct client_gl_compositor *c = client_gl_compositor(xc);
+	struct xrt_swapchain *l_xscn;
+	struct xrt_swapchain *r_xscn;
+	struct xrt_swapchain *l_d_xscn;
+	struct xrt_swapchain *r_d_xscn;
+	struct xrt_swapchain *l_mv_xscn;
+	struct xrt_swapchain *r_mv_xscn;
+
+	assert(data->type == XRT_LAYER_STEREO_PROJECTION_SPACE_WARP);
+
+	l_xscn = &client_gl_swapchain(l_xsc)->xscn->base;
+	r_xscn = &client_gl_swapchain(r_xsc)->xscn->base;
+	l_d_xscn = &client_gl_swapchain(l_d_xsc)->xscn->base;
+	r_d_xscn = &client_gl_swapchain(r_d_xsc)->xscn->base;
+	l_mv_xscn = &client_gl_swapchain(l_mv_xsc)->xscn->base;
+	r_mv_xscn = &client_gl_swapchain(r_mv_xsc)->xscn->base;
+
+	struct xrt_layer_data d = *data;
+	d.flip_y = !d.flip_y;
+	d.stereo_space_warp.l_sw.ndc_y_up = true;
+	d.stereo_space_warp.r_sw.ndc_y_up = true;
+
+	return xrt_comp_layer_stereo_projection_space_warp(&c->xcn->base, xdev, l_xscn, r_xscn, l_d_xscn, r_d_xscn,
+	                                                   l_mv_xscn, r_mv_xscn, &d);
+}
+
 static xrt_result_t
 client_gl_compositor_layer_quad(struct xrt_compositor *xc,
                                 struct xrt_device *xdev,
@@ -374,6 +411,19 @@ client_gl_compositor_layer_equirect2(struct xrt_compositor *xc,
 	return xrt_comp_layer_equirect2(&c->xcn->base, xdev, xscfb, &d);
 }
 
+static xrt_result_t
+client_gl_compositor_layer_passthrough(struct xrt_compositor *xc,
+                                       struct xrt_device *xdev,
+                                       const struct xrt_layer_data *data)
+{
+	struct client_gl_compositor *c = client_gl_compositor(xc);
+
+	assert(data->type == XRT_LAYER_PASSTHROUGH);
+
+	// Camera images are not rendered by the app, so no flip.
+	return xrt_comp_layer_passthrough(&c->xcn->base, xdev, data);
+}
+
 static xrt_result_t
 client_gl_compositor_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handle_t sync_handle)
 {
@@ -518,6 +568,17 @@ client_gl_swapchain_create(struct xrt_compositor *xc,
 	return XRT_SUCCESS;
 }
 
+static xrt_result_t
+client_gl_compositor_set_performance_level(struct xrt_compositor *xc,
+                                           enum xrt_perf_domain domain,
+                                           enum xrt_perf_set_level level)
+{
+	struct client_gl_compositor *c = client_gl_compositor(xc);
+
+	// Pipe down call into native compositor.
+	return xrt_comp_set_performance_level(&c->xcn->base, domain, level);
+}
+
 static xrt_result_t
 client_gl_compositor_poll_events(struct xrt_compositor *xc, union xrt_compositor_event *out_xce)
 {
@@ -567,14 +628,17 @@ client_gl_compositor_init(struct client_gl_compositor *c,
 	c->base.base.layer_begin = client_gl_compositor_layer_begin;
 	c->base.base.layer_stereo_projection = client_gl_compositor_layer_stereo_projection;
 	c->base.base.layer_stereo_projection_depth = client_gl_compositor_layer_stereo_projection_depth;
+	c->base.base.layer_stereo_projection_space_warp = client_gl_compositor_layer_stereo_projection_space_warp;
 	c->base.base.layer_quad = client_gl_compositor_layer_quad;
 	c->base.base.layer_cube = client_gl_compositor_layer_cube;
 	c->base.base.layer_cylinder = client_gl_compositor_layer_cylinder;
 	c->base.base.layer_equirect1 = client_gl_compositor_layer_equirect1;
 	c->base.base.layer_equirect2 = client_gl_compositor_layer_equirect2;
+	c->base.base.layer_passthrough = client_gl_compositor_layer_passthrough;
 	c->base.base.layer_commit = client_gl_compositor_layer_commit;
 	c->base.base.destroy = client_gl_compositor_destroy;
 	c->base.base.poll_events = client_gl_compositor_poll_events;
+	c->base.base.set_performance_level = client_gl_compositor_set_performance_level;
 	c->context_begin_locked = context_begin_locked;
 	c->context_end_locked = context_end_locked;
 	c->create_swapchain = create_swapchain;
@@ -11,6 +11,7 @@
 #include "util/u_misc.h"
 #include "util/u_handles.h"
 #include "util/u_trace_marker.h"
+#include "util/u_foveation.h"
 
 #include "comp_vk_client.h"
 
@@ -47,24 +48,303 @@ client_vk_compositor(struct xrt_compositor *xc)
  *
  */
 
+/*!
+ * Submits the pending release barriers followed by @p cmd_buffer, if given, in
+ * one batch. If @p submit_info is given it is used for the submit, so the frame
+ * commit can add its signal, and it is submitted even without command buffers.
+ * The pool lock must be held.
+ */
+static VkResult
+submit_barriers_locked(struct client_vk_compositor *c, VkCommandBuffer cmd_buffer, VkSubmitInfo *submit_info)
+{
+	COMP_TRACE_MARKER();
+
+	VkCommandBuffer cmd_buffers[CLIENT_VK_MAX_PENDING_BARRIERS + 1];
+	uint32_t count = 0;
+
+	// Pending ones first, they were recorded before this one.
+	for (uint32_t i = 0; i < c->barriers.count; i++) {
+		cmd_buffers[count++] = c->barriers.cmd_buffers[i];
+	}
+	if (cmd_buffer != VK_NULL_HANDLE) {
+		cmd_buffers[count++] = cmd_buffer;
+	}
+
+	VkSubmitInfo default_submit_info = {
+	    .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+	};
+
+	if (submit_info == NULL) {
+		if (count == 0) {
+			return VK_SUCCESS;
+		}
+		submit_info = &default_submit_info;
+	}
+
+	submit_info->commandBufferCount = count;
+	submit_info->pCommandBuffers = cmd_buffers;
+
+	// Dropped even on failure, the error is returned to the app.
+	c->barriers.count = 0;
+
+	// Note we do not submit a fence here, it's not needed.
+	return vk_cmd_submit_locked(&c->vk, 1, submit_info, VK_NULL_HANDLE);
+}
+
+static xrt_result_t
+submit_barriers(struct client_vk_compositor *c, VkCommandBuffer cmd_buffer)
+{
+	vk_cmd_pool_lock(&c->pool);
+	VkResult ret = submit_barriers_locked(c, cmd_buffer, NULL);
+	vk_cmd_pool_unlock(&c->pool);
+
+	if (ret != VK_SUCCESS) {
+		return XRT_ERROR_FAILED_TO_SUBMIT_VULKAN_COMMANDS;
+	}
+
+	return XRT_SUCCESS;
+}
+
 static xrt_result_t
-submit_image_barrier(struct client_vk_swapchain *sc, VkCommandBuffer cmd_buffer)
+defer_barrier(struct client_vk_compositor *c, VkCommandBuffer cmd_buffer)
+{
+	VkResult ret = VK_SUCCESS;
+
+	vk_cmd_pool_lock(&c->pool);
+
+	if (c->barriers.count >= ARRAY_SIZE(c->barriers.cmd_buffers)) {
+		ret = submit_barriers_locked(c, VK_NULL_HANDLE, NULL);
+	}
+
+	c->barriers.cmd_buffers[c->barriers.count++] = cmd_buffer;
+
+	vk_cmd_pool_unlock(&c->pool);
+
+	if (ret != VK_SUCCESS) {
+		return XRT_ERROR_FAILED_TO_SUBMIT_VULKAN_COMMANDS;
+	}
+
+	return XRT_SUCCESS;
+}
+
+static void
+drop_barriers(struct client_vk_compositor *c, struct client_vk_swapchain *sc)
+{
+	vk_cmd_pool_lock(&c->pool);
+
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < c->barriers.count; i++) {
+		bool ours = false;
+		for (uint32_t k = 0; k < sc->base.base.image_count; k++) {
+			ours = ours || c->barriers.cmd_buffers[i] == sc->release[k];
+		}
+
+		if (!ours) {
+			c->barriers.cmd_buffers[count++] = c->barriers.cmd_buffers[i];
+		}
+	}
+	c->barriers.count = count;
+
+	vk_cmd_pool_unlock(&c->pool);
+}
+
+
+/*
+ *
+ * Foveation helpers.
+ *
+ */
+
+#ifdef VK_KHR_fragment_shading_rate
+static VkResult
+create_foveation_images(struct client_vk_swapchain *sc, const struct xrt_swapchain_create_info *info)
+{
+	struct vk_bundle *vk = &sc->c->vk;
+	VkResult ret;
+
+	uint32_t texel_width = vk->features.fragment_shading_rate_texel_width;
+	uint32_t texel_height = vk->features.fragment_shading_rate_texel_height;
+	uint32_t width = (info->width + texel_width - 1) / texel_width;
+	uint32_t height = (info->height + texel_height - 1) / texel_height;
+
+	for (uint32_t i = 0; i < sc->base.base.image_count; i++) {
+		VkImageCreateInfo image_info = {
+		    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+		    .imageType = VK_IMAGE_TYPE_2D,
+		    .format = VK_FORMAT_R8_UINT,
+		    .extent = {width, height, 1},
+		    .mipLevels = 1,
+		    .arrayLayers = info->array_size,
+		    .samples = VK_SAMPLE_COUNT_1_BIT,
+		    .tiling = VK_IMAGE_TILING_OPTIMAL,
+		    .usage = VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+		    .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+		    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+		};
+
+		ret = vk->vkCreateImage(vk->device, &image_info, NULL, &sc->base.foveation_images[i]);
+		if (ret != VK_SUCCESS) {
+			VK_ERROR(vk, "vkCreateImage: %s", vk_result_string(ret));
+			return ret;
+		}
+
+		ret = vk_alloc_and_bind_image_memory( //
+		    vk,                               // vk_bundle
+		    sc->base.foveation_images[i],     // image
+		    SIZE_MAX,                         // max_size
+		    NULL,                             // pNext_for_allocate
+		    __func__,                         // caller_name
+		    &sc->foveation.mems[i],           // out_mem
+		    NULL);                            // out_size
+		if (ret != VK_SUCCESS) {
+			return ret;
+		}
+	}
+
+	VkDeviceSize size = (VkDeviceSize)width * height * info->array_size;
+	ret = vk_buffer_init(                                                          //
+	    vk,                                                                        // vk_bundle
+	    size,                                                                      // size
+	    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,                                          // usage
+	    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, // properties
+	    &sc->foveation.buffer,                                                     // out_buffer
+	    &sc->foveation.buffer_mem);                                                // out_mem
+	if (ret != VK_SUCCESS) {
+		return ret;
+	}
+
+	ret = vk->vkMapMemory(vk->device, sc->foveation.buffer_mem, 0, VK_WHOLE_SIZE, 0,
+	                      (void **)&sc->foveation.mapped);
+	if (ret != VK_SUCCESS) {
+		VK_ERROR(vk, "vkMapMemory: %s", vk_result_string(ret));
+		return ret;
+	}
+
+	sc->base.foveation_width = width;
+	sc->base.foveation_height = height;
+	sc->foveation.array_size = info->array_size;
+
+	// Images are filled with the full rate pattern on first use.
+	sc->foveation.state.level = XRT_FOVEATION_LEVEL_NONE;
+	sc->foveation.generation = 1;
+
+	return VK_SUCCESS;
+}
+
+/*!
+ * Fills and uploads the current foveation pattern to the image if it is out of
+ * date, waits for the copy so the staging buffer can be reused directly. This
+ * only happens once per image after the app changes the foveation state.
+ */
+static xrt_result_t
+update_foveation_image(struct client_vk_swapchain *sc, uint32_t index)
 {
 	COMP_TRACE_MARKER();
 
 	struct client_vk_compositor *c = sc->c;
 	struct vk_bundle *vk = &c->vk;
+	VkCommandBuffer cmd_buffer;
 	VkResult ret;
 
-	// Note we do not submit a fence here, it's not needed.
-	ret = vk_cmd_pool_submit_cmd_buffer(vk, &c->pool, cmd_buffer);
+	os_mutex_lock(&sc->foveation.mutex);
+
+	if (sc->foveation.uploaded[index] == sc->foveation.generation) {
+		os_mutex_unlock(&sc->foveation.mutex);
+		return XRT_SUCCESS;
+	}
+
+	const struct xrt_foveation_state *state = &sc->foveation.state;
+	uint32_t width = sc->base.foveation_width;
+	uint32_t height = sc->base.foveation_height;
+	uint32_t max_rate_log2 = vk->features.fragment_shading_rate_max_log2;
+
+	for (uint32_t layer = 0; layer < sc->foveation.array_size; layer++) {
+		struct xrt_vec2 center = state->centers[layer < 2 ? layer : 1];
+		if (sc->foveation.array_size == 1) {
+			center.x = (state->centers[0].x + state->centers[1].x) * 0.5f;
+			center.y = (state->centers[0].y + state->centers[1].y) * 0.5f;
+		}
+
+		uint8_t *dst = sc->foveation.mapped + (size_t)layer * width * height;
+		u_foveation_fill_shading_rate(state->level, &center, max_rate_log2, width, height, dst, width);
+	}
+
+	VkImageSubresourceRange subresource_range = {
+	    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+	    .baseMipLevel = 0,
+	    .levelCount = 1,
+	    .baseArrayLayer = 0,
+	    .layerCount = sc->foveation.array_size,
+	};
+
+	VkBufferImageCopy region = {
+	    .imageSubresource =
+	        {
+	            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+	            .mipLevel = 0,
+	            .baseArrayLayer = 0,
+	            .layerCount = sc->foveation.array_size,
+	        },
+	    .imageExtent = {width, height, 1},
+	};
+
+	vk_cmd_pool_lock(&c->pool);
+
+	ret = vk_cmd_pool_create_and_begin_cmd_buffer_locked(vk, &c->pool, 0, &cmd_buffer);
+	if (ret != VK_SUCCESS) {
+		vk_cmd_pool_unlock(&c->pool);
+		os_mutex_unlock(&sc->foveation.mutex);
+		return XRT_ERROR_VULKAN;
+	}
+
+	// The whole image is overwritten, old content can be discarded.
+	vk_cmd_image_barrier_locked(              //
+	    vk,                                   // vk_bundle
+	    cmd_buffer,                           // cmd_buffer
+	    sc->base.foveation_images[index],     // image
+	    0,                                    // src_access_mask
+	    VK_ACCESS_TRANSFER_WRITE_BIT,         // dst_access_mask
+	    VK_IMAGE_LAYOUT_UNDEFINED,            // old_image_layout
+	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // new_image_layout
+	    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,    // src_stage_mask
+	    VK_PIPELINE_STAGE_TRANSFER_BIT,       // dst_stage_mask
+	    subresource_range);                   // subresource_range
+
+	vk->vkCmdCopyBufferToImage(               //
+	    cmd_buffer,                           // commandBuffer
+	    sc->foveation.buffer,                 // srcBuffer
+	    sc->base.foveation_images[index],     // dstImage
+	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // dstImageLayout
+	    1,                                    // regionCount
+	    &region);                             // pRegions
+
+	vk_cmd_image_barrier_locked(                                         //
+	    vk,                                                              // vk_bundle
+	    cmd_buffer,                                                      // cmd_buffer
+	    sc->base.foveation_images[index],                                // image
+	    VK_ACCESS_TRANSFER_WRITE_BIT,                                    // src_access_mask
+	    VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR,         // dst_access_mask
+	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,                            // old_image_layout
+	    VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR,    // new_image_layout
+	    VK_PIPELINE_STAGE_TRANSFER_BIT,                                  // src_stage_mask
+	    VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR,      // dst_stage_mask
+	    subresource_range);                                              // subresource_range
+
+	ret = vk_cmd_pool_end_submit_wait_and_free_cmd_buffer_locked(vk, &c->pool, cmd_buffer);
+	vk_cmd_pool_unlock(&c->pool);
+
 	if (ret != VK_SUCCESS) {
-		VK_ERROR(vk, "vk_cmd_pool_submit_cmd_buffer: %s %u", vk_result_string(ret), ret);
+		os_mutex_unlock(&sc->foveation.mutex);
 		return XRT_ERROR_FAILED_TO_SUBMIT_VULKAN_COMMANDS;
 	}
 
+	sc->foveation.uploaded[index] = sc->foveation.generation;
+
+	os_mutex_unlock(&sc->foveation.mutex);
+
 	return XRT_SUCCESS;
 }
+#endif // VK_KHR_fragment_shading_rate
 
 
 /*
@@ -120,6 +400,32 @@ submit_handle(struct client_vk_compositor *c, xrt_graphics_sync_handle_t sync_ha
 		return false;
 	}
 
+	struct vk_bundle *vk = &c->vk;
+
+	/*
+	 * The handle was made before the pending release barriers were put on
+	 * the queue, so it does not cover them. Wait for them here instead, no
+	 * in tree caller gives the Vulkan client a handle so this isn't hot.
+	 */
+	vk_cmd_pool_lock(&c->pool);
+	bool had_barriers = c->barriers.count > 0;
+	VkResult ret = submit_barriers_locked(c, VK_NULL_HANDLE, NULL);
+	vk_cmd_pool_unlock(&c->pool);
+
+	if (ret != VK_SUCCESS) {
+		u_graphics_sync_unref(&sync_handle);
+		*out_xret = XRT_ERROR_FAILED_TO_SUBMIT_VULKAN_COMMANDS;
+		return true;
+	}
+
+	if (had_barriers) {
+		COMP_TRACE_IDENT(wait_for_barriers);
+
+		os_mutex_lock(&vk->queue_mutex);
+		vk->vkQueueWaitIdle(vk->queue);
+		os_mutex_unlock(&vk->queue_mutex);
+	}
+
 	// Commit consumes the sync_handle.
 	*out_xret = xrt_comp_layer_commit(&c->xcn->base, sync_handle);
 	return true;
@@ -133,7 +439,6 @@ submit_semaphore(struct client_vk_compositor *c, xrt_result_t *out_xret)
 		return false;
 	}
 
-	struct vk_bundle *vk = &c->vk;
 	VkResult ret;
 
 	VkSemaphore semaphores[1] = {
@@ -157,13 +462,11 @@ submit_semaphore(struct client_vk_compositor *c, xrt_result_t *out_xret)
 	    .pSignalSemaphores = semaphores,
 	};
 
-	ret = vk->vkQueueSubmit( //
-	    vk->queue,           // queue
-	    1,                   // submitCount
-	    &submit_info,        // pSubmits
-	    VK_NULL_HANDLE);     // fence
+	// The pending release barriers go in the same submit as the signal.
+	vk_cmd_pool_lock(&c->pool);
+	ret = submit_barriers_locked(c, VK_NULL_HANDLE, &submit_info);
+	vk_cmd_pool_unlock(&c->pool);
 	if (ret != VK_SUCCESS) {
-		VK_ERROR(vk, "vkQueueSubmit: %s", vk_result_string(ret));
 		*out_xret = XRT_ERROR_VULKAN;
 		return true;
 	}
@@ -202,6 +505,11 @@ submit_fence(struct client_vk_compositor *c, xrt_result_t *out_xret)
 		return false;
 	}
 
+	*out_xret = submit_barriers(c, VK_NULL_HANDLE);
+	if (*out_xret != XRT_SUCCESS) {
+		return true;
+	}
+
 	{
 		COMP_TRACE_IDENT(create_and_submit_fence);
 
@@ -223,6 +531,11 @@ submit_fallback(struct client_vk_compositor *c, xrt_result_t *out_xret)
 {
 	struct vk_bundle *vk = &c->vk;
 
+	*out_xret = submit_barriers(c, VK_NULL_HANDLE);
+	if (*out_xret != XRT_SUCCESS) {
+		return true;
+	}
+
 	{
 		COMP_TRACE_IDENT(device_wait_idle);
 
@@ -252,6 +565,9 @@ client_vk_swapchain_destroy(struct xrt_swapchain *xsc)
 	struct client_vk_compositor *c = sc->c;
 	struct vk_bundle *vk = &c->vk;
 
+	// The queue can't be used here, drop any pending barriers on the images.
+	drop_barriers(c, sc);
+
 	// Make sure images are not used anymore.
 	if (BREAK_OPENXR_SPEC_IN_DESTROY_SWAPCHAIN) {
 		os_mutex_lock(&vk->queue_mutex);
@@ -269,8 +585,31 @@ client_vk_swapchain_destroy(struct xrt_swapchain *xsc)
 			vk->vkFreeMemory(vk->device, sc->mems[i], NULL);
 			sc->mems[i] = VK_NULL_HANDLE;
 		}
+
+		if (sc->base.foveation_images[i] != VK_NULL_HANDLE) {
+			vk->vkDestroyImage(vk->device, sc->base.foveation_images[i], NULL);
+			sc->base.foveation_images[i] = VK_NULL_HANDLE;
+		}
+
+		if (sc->foveation.mems[i] != VK_NULL_HANDLE) {
+			vk->vkFreeMemory(vk->device, sc->foveation.mems[i], NULL);
+			sc->foveation.mems[i] = VK_NULL_HANDLE;
+		}
 	}
 
+	if (sc->foveation.buffer != VK_NULL_HANDLE) {
+		vk->vkDestroyBuffer(vk->device, sc->foveation.buffer, NULL);
+		sc->foveation.buffer = VK_NULL_HANDLE;
+	}
+
+	if (sc->foveation.buffer_mem != VK_NULL_HANDLE) {
+		// Implicitly unmapped.
+		vk->vkFreeMemory(vk->device, sc->foveation.buffer_mem, NULL);
+		sc->foveation.buffer_mem = VK_NULL_HANDLE;
+	}
+
+	os_mutex_destroy(&sc->foveation.mutex);
+
 	// Drop our reference, does NULL checking.
 	xrt_swapchain_native_reference(&sc->xscn, NULL);
 
@@ -315,15 +654,29 @@ client_vk_swapchain_barrier_image(struct xrt_swapchain *xsc, enum xrt_barrier_di
 	COMP_TRACE_MARKER();
 
 	struct client_vk_swapchain *sc = client_vk_swapchain(xsc);
-	VkCommandBuffer cmd_buffer = VK_NULL_HANDLE;
 
 	switch (direction) {
-	case XRT_BARRIER_TO_APP: cmd_buffer = sc->acquire[index]; break;
-	case XRT_BARRIER_TO_COMP: cmd_buffer = sc->release[index]; break;
+	case XRT_BARRIER_TO_APP: break;
+	/*
+	 * Can wait, the image is only used by the compositor after the commit,
+	 * which submits them ahead of its sync primitive, see submit_handle for
+	 * the one case where the sync primitive already exists.
+	 */
+	case XRT_BARRIER_TO_COMP: return defer_barrier(sc->c, sc->release[index]);
 	default: assert(false);
 	}
 
-	return submit_image_barrier(sc, cmd_buffer);
+#ifdef VK_KHR_fragment_shading_rate
+	if (direction == XRT_BARRIER_TO_APP && sc->base.foveation_images[index] != VK_NULL_HANDLE) {
+		xrt_result_t xret = update_foveation_image(sc, index);
+		if (xret != XRT_SUCCESS) {
+			return xret;
+		}
+	}
+#endif
+
+	// Has to be on the queue before the app renders, takes pending releases along.
+	return submit_barriers(sc->c, sc->acquire[index]);
 }
 
 static xrt_result_t
@@ -337,6 +690,27 @@ client_vk_swapchain_release_image(struct xrt_swapchain *xsc, uint32_t index)
 	return xrt_swapchain_release_image(&sc->xscn->base, index);
 }
 
+static xrt_result_t
+client_vk_swapchain_set_foveation(struct xrt_swapchain *xsc, const struct xrt_foveation_state *state)
+{
+	COMP_TRACE_MARKER();
+
+	struct client_vk_swapchain *sc = client_vk_swapchain(xsc);
+
+	// Created without foveation or not supported by the device.
+	if (sc->base.foveation_images[0] == VK_NULL_HANDLE) {
+		return XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED;
+	}
+
+	// Uploaded to each image on its next barrier to the app.
+	os_mutex_lock(&sc->foveation.mutex);
+	sc->foveation.state = *state;
+	sc->foveation.generation++;
+	os_mutex_unlock(&sc->foveation.mutex);
+
+	return XRT_SUCCESS;
+}
+
 
 /*
  *
@@ -344,6 +718,19 @@ client_vk_swapchain_release_image(struct xrt_swapchain *xsc, uint32_t index)
  *
  */
 
+static xrt_result_t
+client_vk_compositor_set_performance_level(struct xrt_compositor *xc,
+                                           enum xrt_perf_domain domain,
+                                           enum xrt_perf_set_level level)
+{
+	COMP_TRACE_MARKER();
+
+	struct client_vk_compositor *c = client_vk_compositor(xc);
+
+	// Pipe down call into native compositor.
+	return xrt_comp_set_performance_level(&c->xcn->base, domain, level);
+}
+
 static xrt_result_t
 client_vk_compositor_poll_events(struct xrt_compositor *xc, union xrt_compositor_event *out_xce)
 {
@@ -494,6 +881,38 @@ client_vk_compositor_layer_stereo_projection_depth(struct xrt_compositor *xc,
 	return xrt_comp_layer_stereo_projection_depth(&c->xcn->base, xdev, l_xscn, r_xscn, l_d_xscn, r_d_xscn, data);
 }
 
+static xrt_result_t
+client_vk_compositor_layer_stereo_projection_space_warp(struct xrt_compositor *xc,
+                                                        struct xrt_device *xdev,
+                                                        struct xrt_swapchain *l_xsc,
+                                                        struct xrt_swapchain *r_xsc,
+                                                        struct xrt_swapchain *l_d_xsc,
+                                                        struct xrt_swapchain *r_d_xsc,
+                                                        struct xrt_swapchain *l_mv_xsc,
+                                                        struct xrt_swapchain *r_mv_xsc,
+                                                        const struct xrt_layer_data *data)
+{
+	struct client_vk_compositor *c = client_vk_compositor(xc);
+	struct xrt_swapchain *l_xscn;
+	struct xrt_swapchain *r_xscn;
+	struct xrt_swapchain *l_d_xscn;
+	struct xrt_swapchain *r_d_xscn;
+	struct xrt_swapchain *l_mv_xscn;
+	struct xrt_swapchain *r_mv_xscn;
+
+	assert(data->type == XRT_LAYER_STEREO_PROJECTION_SPACE_WARP);
+
+	l_xscn = &client_vk_swapchain(l_xsc)->xscn->base;
+	r_xscn = &client_vk_swapchain(r_xsc)->xscn->base;
+	l_d_xscn = &client_vk_swapchain(l_d_xsc)->xscn->base;
+	r_d_xscn = &client_vk_swapchain(r_d_xsc)->xscn->base;
+	l_mv_xscn = &client_vk_swapchain(l_mv_xsc)->xscn->base;
+	r_mv_xscn = &client_vk_swapchain(r_mv_xsc)->xscn->base;
+
+	return xrt_comp_layer_stereo_projection_space_warp(&c->xcn->base, xdev, l_xscn, r_xscn, l_d_xscn, r_d_xscn,
+	                                                   l_mv_xscn, r_mv_xscn, data);
+}
+
 static xrt_result_t
 client_vk_compositor_layer_quad(struct xrt_compositor *xc,
                                 struct xrt_device *xdev,
@@ -574,6 +993,18 @@ client_vk_compositor_layer_equirect2(struct xrt_compositor *xc,
 	return xrt_comp_layer_equirect2(&c->xcn->base, xdev, xscfb, data);
 }
 
+static xrt_result_t
+client_vk_compositor_layer_passthrough(struct xrt_compositor *xc,
+                                       struct xrt_device *xdev,
+                                       const struct xrt_layer_data *data)
+{
+	struct client_vk_compositor *c = client_vk_compositor(xc);
+
+	assert(data->type == XRT_LAYER_PASSTHROUGH);
+
+	return xrt_comp_layer_passthrough(&c->xcn->base, xdev, data);
+}
+
 static xrt_result_t
 client_vk_compositor_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handle_t sync_handle)
 {
@@ -629,6 +1060,15 @@ client_vk_swapchain_create(struct xrt_compositor *xc,
 	struct xrt_swapchain_create_info xinfo = *info;
 	xinfo.bits |= xsccp.extra_bits;
 
+	// Foveation images are created here, the native compositor never sees them.
+	bool foveation = (xinfo.create & XRT_SWAPCHAIN_CREATE_FOVEATION) != 0;
+	xinfo.create &= ~XRT_SWAPCHAIN_CREATE_FOVEATION;
+
+	// We can't chain a format list on import, so the images must be allocated without one.
+	if (!vk->has_KHR_image_format_list) {
+		xinfo.format_count = 0;
+	}
+
 	struct xrt_swapchain_native *xscn = NULL; // Has to be NULL.
 	xret = xrt_comp_native_create_swapchain(c->xcn, &xinfo, &xscn);
 
@@ -649,6 +1089,7 @@ client_vk_swapchain_create(struct xrt_compositor *xc,
 	sc->base.base.wait_image = client_vk_swapchain_wait_image;
 	sc->base.base.barrier_image = client_vk_swapchain_barrier_image;
 	sc->base.base.release_image = client_vk_swapchain_release_image;
+	sc->base.base.set_foveation = client_vk_swapchain_set_foveation;
 	sc->base.base.reference.count = 1;
 	sc->base.base.image_count = xsc->image_count; // Fetch the number of images from the native swapchain.
 	sc->c = c;
@@ -750,6 +1191,19 @@ client_vk_swapchain_create(struct xrt_compositor *xc,
 	}
 	vk_cmd_pool_unlock(&c->pool);
 
+	os_mutex_init(&sc->foveation.mutex);
+
+#ifdef VK_KHR_fragment_shading_rate
+	if (foveation && vk->features.attachment_fragment_shading_rate) {
+		ret = create_foveation_images(sc, &xinfo);
+		if (ret != VK_SUCCESS) {
+			client_vk_swapchain_destroy(&sc->base.base);
+			return XRT_ERROR_VULKAN;
+		}
+	}
+#else
+	(void)foveation;
+#endif
 
 	*out_xsc = &sc->base.base;
 
@@ -765,6 +1219,8 @@ client_vk_compositor_create(struct xrt_compositor_native *xcn,
                             bool external_fence_fd_enabled,
                             bool external_semaphore_fd_enabled,
                             bool timeline_semaphore_enabled,
+                            bool fragment_shading_rate_enabled,
+                            bool image_format_list_enabled,
                             uint32_t queueFamilyIndex,
                             uint32_t queueIndex)
 {
@@ -784,14 +1240,17 @@ client_vk_compositor_create(struct xrt_compositor_native *xcn,
 	c->base.base.layer_begin = client_vk_compositor_layer_begin;
 	c->base.base.layer_stereo_projection = client_vk_compositor_layer_stereo_projection;
 	c->base.base.layer_stereo_projection_depth = client_vk_compositor_layer_stereo_projection_depth;
+	c->base.base.layer_stereo_projection_space_warp = client_vk_compositor_layer_stereo_projection_space_warp;
 	c->base.base.layer_quad = client_vk_compositor_layer_quad;
 	c->base.base.layer_cube = client_vk_compositor_layer_cube;
 	c->base.base.layer_cylinder = client_vk_compositor_layer_cylinder;
 	c->base.base.layer_equirect1 = client_vk_compositor_layer_equirect1;
 	c->base.base.layer_equirect2 = client_vk_compositor_layer_equirect2;
+	c->base.base.layer_passthrough = client_vk_compositor_layer_passthrough;
 	c->base.base.layer_commit = client_vk_compositor_layer_commit;
 	c->base.base.destroy = client_vk_compositor_destroy;
 	c->base.base.poll_events = client_vk_compositor_poll_events;
+	c->base.base.set_performance_level = client_vk_compositor_set_performance_level;
 
 	c->xcn = xcn;
 	// passthrough our formats from the native compositor to the client
@@ -815,6 +1274,8 @@ client_vk_compositor_create(struct xrt_compositor_native *xcn,
 	    external_fence_fd_enabled,     // external_fence_fd_enabled
 	    external_semaphore_fd_enabled, // external_semaphore_fd_enabled
 	    timeline_semaphore_enabled,    // timeline_semaphore_enabled
+	    fragment_shading_rate_enabled, // fragment_shading_rate_enabled
+	    image_format_list_enabled,     // image_format_list_enabled
 	    log_level);                    // log_level
 	if (ret != VK_SUCCESS) {
 		goto err_free;
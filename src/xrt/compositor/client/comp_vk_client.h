@@ -25,6 +25,14 @@ extern "C" {
  *
  */
 
+/*!
+ * How many release barriers can be waiting for the next submit, if more
+ * images than this are released in one frame the barriers are submitted early.
+ *
+ * @ingroup comp_client
+ */
+#define CLIENT_VK_MAX_PENDING_BARRIERS 64
+
 struct client_vk_compositor;
 
 /*!
@@ -51,6 +59,30 @@ struct client_vk_swapchain
 	// Prerecorded swapchain image ownership/layout transition barriers
 	VkCommandBuffer acquire[XRT_MAX_SWAPCHAIN_IMAGES];
 	VkCommandBuffer release[XRT_MAX_SWAPCHAIN_IMAGES];
+
+	//! Backing for @ref xrt_swapchain_vk::foveation_images, if created.
+	struct
+	{
+		VkDeviceMemory mems[XRT_MAX_SWAPCHAIN_IMAGES];
+
+		//! Host visible staging buffer, holds the pattern for all layers.
+		VkBuffer buffer;
+		VkDeviceMemory buffer_mem;
+		uint8_t *mapped;
+
+		uint32_t array_size;
+
+		//! Protects the fields below and the staging buffer.
+		struct os_mutex mutex;
+
+		struct xrt_foveation_state state;
+
+		//! Bumped on every new state, compared against @p uploaded.
+		uint64_t generation;
+
+		//! Generation last uploaded to each image.
+		uint64_t uploaded[XRT_MAX_SWAPCHAIN_IMAGES];
+	} foveation;
 };
 
 /*!
@@ -78,6 +110,17 @@ struct client_vk_compositor
 	struct vk_bundle vk;
 
 	struct vk_cmd_pool pool;
+
+	/*!
+	 * Release barriers from @ref xrt_swapchain::barrier_image, submitted
+	 * together with the next acquire barrier or the frame commit instead of
+	 * one submit each. Protected by the pool lock.
+	 */
+	struct
+	{
+		VkCommandBuffer cmd_buffers[CLIENT_VK_MAX_PENDING_BARRIERS];
+		uint32_t count;
+	} barriers;
 };
 
 
@@ -105,6 +148,8 @@ client_vk_compositor_create(struct xrt_compositor_native *xcn,
                             bool external_fence_fd_enabled,
                             bool external_semaphore_fd_enabled,
                             bool timeline_semaphore_enabled,
+                            bool fragment_shading_rate_enabled,
+                            bool image_format_list_enabled,
                             uint32_t queueFamilyIndex,
                             uint32_t queueIndex);
 
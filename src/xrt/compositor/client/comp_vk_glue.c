@@ -78,6 +78,8 @@ xrt_gfx_vk_provider_create(struct xrt_compositor_native *xcn,
                            bool external_fence_fd_enabled,
                            bool external_semaphore_fd_enabled,
                            bool timeline_semaphore_enabled,
+                           bool fragment_shading_rate_enabled,
+                           bool image_format_list_enabled,
                            uint32_t queue_family_index,
                            uint32_t queue_index)
 {
@@ -90,6 +92,8 @@ xrt_gfx_vk_provider_create(struct xrt_compositor_native *xcn,
 	    external_fence_fd_enabled,                                  //
 	    external_semaphore_fd_enabled,                              //
 	    timeline_semaphore_enabled,                                 //
+	    fragment_shading_rate_enabled,                              //
+	    image_format_list_enabled,                                  //
 	    queue_family_index,                                         //
 	    queue_index);                                               //
 
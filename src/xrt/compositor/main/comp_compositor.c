@@ -45,6 +45,7 @@
 #include "xrt/xrt_config_have.h"
 
 #include "os/os_time.h"
+#include "os/os_threading.h"
 
 #include "util/u_var.h"
 #include "util/u_misc.h"
@@ -265,12 +266,24 @@ do_graphics_layers(struct comp_compositor *c)
 		return;
 	}
 
-	comp_renderer_allocate_layers(c->r, layer_count);
-
+	// Passthrough layers are only composited by the compute path.
+	uint32_t render_layer_count = 0;
 	for (uint32_t i = 0; i < layer_count; i++) {
+		if (c->base.slot.layers[i].data.type != XRT_LAYER_PASSTHROUGH) {
+			render_layer_count++;
+		}
+	}
+
+	comp_renderer_allocate_layers(c->r, render_layer_count);
+
+	for (uint32_t i = 0, r_i = 0; i < layer_count; i++) {
 		struct comp_layer *layer = &c->base.slot.layers[i];
 		struct xrt_layer_data *data = &layer->data;
 
+		if (data->type == XRT_LAYER_PASSTHROUGH) {
+			continue;
+		}
+
 		COMP_SPEW(c, "LAYER_COMMIT (%d) predicted display time: %8.3fms", i, ns_to_ms(data->timestamp));
 
 		switch (data->type) {
@@ -278,7 +291,7 @@ do_graphics_layers(struct comp_compositor *c)
 			struct xrt_layer_quad_data *quad = &layer->data.quad;
 			struct comp_swapchain_image *image;
 			image = &layer->sc_array[0]->images[quad->sub.image_index];
-			comp_renderer_set_quad_layer(c->r, i, image, data);
+			comp_renderer_set_quad_layer(c->r, r_i++, image, data);
 		} break;
 		case XRT_LAYER_STEREO_PROJECTION: {
 			struct xrt_layer_stereo_projection_data *stereo = &data->stereo;
@@ -287,7 +300,7 @@ do_graphics_layers(struct comp_compositor *c)
 			left = &layer->sc_array[0]->images[stereo->l.sub.image_index];
 			right = &layer->sc_array[1]->images[stereo->r.sub.image_index];
 
-			comp_renderer_set_projection_layer(c->r, i, left, right, data);
+			comp_renderer_set_projection_layer(c->r, r_i++, left, right, data);
 		} break;
 		case XRT_LAYER_STEREO_PROJECTION_DEPTH: {
 			struct xrt_layer_stereo_projection_depth_data *stereo = &data->stereo_depth;
@@ -298,20 +311,30 @@ do_graphics_layers(struct comp_compositor *c)
 
 			//! @todo: Make use of stereo->l_d and stereo->r_d
 
-			comp_renderer_set_projection_layer(c->r, i, left, right, data);
+			comp_renderer_set_projection_layer(c->r, r_i++, left, right, data);
+		} break;
+		case XRT_LAYER_STEREO_PROJECTION_SPACE_WARP: {
+			struct xrt_layer_stereo_projection_space_warp_data *stereo = &data->stereo_space_warp;
+			struct comp_swapchain_image *right;
+			struct comp_swapchain_image *left;
+			left = &layer->sc_array[0]->images[stereo->l.sub.image_index];
+			right = &layer->sc_array[1]->images[stereo->r.sub.image_index];
+
+			// Frame synthesis is only done in the fast path.
+			comp_renderer_set_projection_layer(c->r, r_i++, left, right, data);
 		} break;
 		case XRT_LAYER_CYLINDER: {
 			struct xrt_layer_cylinder_data *cyl = &layer->data.cylinder;
 			struct comp_swapchain_image *image;
 			image = &layer->sc_array[0]->images[cyl->sub.image_index];
-			comp_renderer_set_cylinder_layer(c->r, i, image, data);
+			comp_renderer_set_cylinder_layer(c->r, r_i++, image, data);
 		} break;
 #ifdef XRT_FEATURE_OPENXR_LAYER_EQUIRECT1
 		case XRT_LAYER_EQUIRECT1: {
 			struct xrt_layer_equirect1_data *eq = &layer->data.equirect1;
 			struct comp_swapchain_image *image;
 			image = &layer->sc_array[0]->images[eq->sub.image_index];
-			comp_renderer_set_equirect1_layer(c->r, i, image, data);
+			comp_renderer_set_equirect1_layer(c->r, r_i++, image, data);
 		} break;
 #endif
 #ifdef XRT_FEATURE_OPENXR_LAYER_EQUIRECT2
@@ -319,7 +342,7 @@ do_graphics_layers(struct comp_compositor *c)
 			struct xrt_layer_equirect2_data *eq = &layer->data.equirect2;
 			struct comp_swapchain_image *image;
 			image = &layer->sc_array[0]->images[eq->sub.image_index];
-			comp_renderer_set_equirect2_layer(c->r, i, image, data);
+			comp_renderer_set_equirect2_layer(c->r, r_i++, image, data);
 		} break;
 #endif
 #ifdef XRT_FEATURE_OPENXR_LAYER_CUBE
@@ -327,7 +350,7 @@ do_graphics_layers(struct comp_compositor *c)
 			struct xrt_layer_cube_data *cu = &layer->data.cube;
 			struct comp_swapchain_image *image;
 			image = &layer->sc_array[0]->images[cu->sub.image_index];
-			comp_renderer_set_cube_layer(c->r, i, image, data);
+			comp_renderer_set_cube_layer(c->r, r_i++, image, data);
 		} break;
 #endif
 
@@ -362,8 +385,9 @@ can_do_one_projection_layer_fast_path(struct comp_compositor *c)
 	enum xrt_layer_type type = layer->data.type;
 
 	// Handled by the distortion shader.
-	if (type != XRT_LAYER_STEREO_PROJECTION && //
-	    type != XRT_LAYER_STEREO_PROJECTION_DEPTH) {
+	if (type != XRT_LAYER_STEREO_PROJECTION &&       //
+	    type != XRT_LAYER_STEREO_PROJECTION_DEPTH && //
+	    type != XRT_LAYER_STEREO_PROJECTION_SPACE_WARP) {
 		return false;
 	}
 
@@ -389,6 +413,15 @@ compositor_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handle_t sy
 
 	u_graphics_sync_unref(&sync_handle);
 
+	bool passthrough_in_use = false;
+	for (uint32_t i = 0; i < c->base.slot.layer_count; i++) {
+		if (c->base.slot.layers[i].data.type == XRT_LAYER_PASSTHROUGH) {
+			passthrough_in_use = true;
+			break;
+		}
+	}
+	comp_passthrough_set_in_use(&c->passthrough, c->xdev, passthrough_in_use, os_monotonic_get_ns());
+
 	if (!c->settings.use_compute) {
 		do_graphics_layers(c);
 	}
@@ -462,6 +495,9 @@ compositor_destroy(struct xrt_compositor *xc)
 
 	comp_renderer_destroy(&c->r);
 
+	// Stops the cameras, needs the device.
+	comp_passthrough_fini(&c->passthrough, c->xdev);
+
 #ifdef XRT_FEATURE_WINDOW_PEEK
 	comp_window_peek_destroy(&c->peek);
 #endif
@@ -670,13 +706,20 @@ static const char *optional_device_extensions[] = {
 #endif
 };
 
+/*!
+ * Brings up the instance and device, @p target_instance_extensions are the
+ * ones the target needs on top of the common ones and
+ * @p target_optional_instance_extensions are enabled where supported.
+ */
 static bool
-compositor_init_vulkan(struct comp_compositor *c)
+compositor_init_vulkan_with_extensions(struct comp_compositor *c,
+                                       const char *const *target_instance_extensions,
+                                       uint32_t target_instance_extension_count,
+                                       const char *const *target_optional_instance_extensions,
+                                       uint32_t target_optional_instance_extension_count)
 {
 	COMP_TRACE_MARKER();
 
-	assert(c->target_factory != NULL);
-
 	struct vk_bundle *vk = get_vk(c);
 
 
@@ -694,10 +737,10 @@ compositor_init_vulkan(struct comp_compositor *c)
 	    ARRAY_SIZE(instance_extensions_common)); //
 
 	// Add per target required extensions.
-	u_string_list_append_array(                                //
-	    required_instance_ext_list,                            //
-	    c->target_factory->required_instance_extensions,       //
-	    c->target_factory->required_instance_extension_count); //
+	u_string_list_append_array(           //
+	    required_instance_ext_list,       //
+	    target_instance_extensions,       //
+	    target_instance_extension_count); //
 
 	// Optional instance extensions.
 	u_string_list_append_array(                    //
@@ -705,6 +748,12 @@ compositor_init_vulkan(struct comp_compositor *c)
 	    optional_instance_extensions,              //
 	    ARRAY_SIZE(optional_instance_extensions)); //
 
+	// Extensions of targets that might be selected later on.
+	u_string_list_append_array(                    //
+	    optional_instance_ext_list,                //
+	    target_optional_instance_extensions,       //
+	    target_optional_instance_extension_count); //
+
 
 	/*
 	 * Device extensions.
@@ -781,6 +830,16 @@ compositor_init_vulkan(struct comp_compositor *c)
 	return true;
 }
 
+static bool
+compositor_init_vulkan(struct comp_compositor *c)
+{
+	const struct comp_target_factory *ctf = c->target_factory;
+	assert(ctf != NULL);
+
+	return compositor_init_vulkan_with_extensions(c, ctf->required_instance_extensions,
+	                                              (uint32_t)ctf->required_instance_extension_count, NULL, 0);
+}
+
 
 /*
  *
@@ -913,16 +972,23 @@ select_target_factory_by_detecting(struct comp_compositor *c, const struct comp_
 	return true; // Didn't detect a target, but that's ok.
 }
 
-static bool
-compositor_init_window_pre_vulkan(struct comp_compositor *c, const struct comp_target_factory *selected_ctf, struct xrt_device *xdev)
+static const struct comp_target_factory *
+select_target_factory_from_xdev(struct comp_compositor *c,
+                                struct xrt_device *xdev,
+                                const struct comp_target_factory *selected_ctf)
 {
-	COMP_TRACE_MARKER();
-
 	if (xdev->create_compositor_target) {
-		struct comp_target *target;
 		xdev->create_compositor_target(xdev, c, &selected_ctf);
 	}
 
+	return selected_ctf;
+}
+
+static bool
+compositor_init_window_pre_vulkan(struct comp_compositor *c, const struct comp_target_factory *selected_ctf)
+{
+	COMP_TRACE_MARKER();
+
 	if (selected_ctf == NULL && !select_target_factory_from_settings(c, &selected_ctf)) {
 		return false; // Error!
 	}
@@ -1010,15 +1076,19 @@ compositor_init_swapchain(struct comp_compositor *c)
 }
 
 static bool
-compositor_init_render_resources(struct comp_compositor *c)
+compositor_init_shaders(struct comp_compositor *c)
 {
 	COMP_TRACE_MARKER();
 
 	struct vk_bundle *vk = get_vk(c);
 
-	if (!render_shaders_load(&c->shaders, vk)) {
-		return false;
-	}
+	return render_shaders_load(&c->shaders, vk);
+}
+
+static bool
+compositor_init_render_resources(struct comp_compositor *c)
+{
+	COMP_TRACE_MARKER();
 
 	if (!render_resources_init(&c->nr, &c->shaders, get_vk(c), c->xdev)) {
 		return false;
@@ -1043,13 +1113,9 @@ compositor_init_renderer(struct comp_compositor *c)
 	return c->r != NULL;
 }
 
-xrt_result_t
-comp_main_create_system_compositor(struct xrt_device *xdev,
-                                   const struct comp_target_factory *ctf,
-                                   struct xrt_system_compositor **out_xsysc)
+static struct comp_compositor *
+compositor_alloc(void)
 {
-	COMP_TRACE_MARKER();
-
 	struct comp_compositor *c = U_TYPED_CALLOC(struct comp_compositor);
 
 	c->base.base.base.begin_session = compositor_begin_session;
@@ -1063,15 +1129,29 @@ comp_main_create_system_compositor(struct xrt_device *xdev,
 	c->base.base.base.destroy = compositor_destroy;
 	c->frame.waited.id = -1;
 	c->frame.rendering.id = -1;
-	c->xdev = xdev;
 
 	COMP_DEBUG(c, "Doing init %p", (void *)c);
 
 	// Do this as early as possible.
 	comp_base_init(&c->base);
 
-	// Init the settings to default.
-	comp_settings_init(&c->settings, xdev);
+	// Init the settings to default, the device dependent ones come later.
+	comp_settings_init_without_device(&c->settings);
+
+	return c;
+}
+
+/*!
+ * Everything that needs the head device, Vulkan and the shaders must have been
+ * initialized and the target backend selected before calling this function.
+ * Takes ownership of the compositor, destroys it on failure.
+ */
+static xrt_result_t
+compositor_init_with_device(struct comp_compositor *c,
+                            struct xrt_device *xdev,
+                            struct xrt_system_compositor **out_xsysc)
+{
+	COMP_TRACE_MARKER();
 
 	c->last_frame_time_ns = os_monotonic_get_ns();
 
@@ -1095,16 +1175,13 @@ comp_main_create_system_compositor(struct xrt_device *xdev,
 	c->view_extents.width = w0;
 	c->view_extents.height = h0;
 
-	// Need to select window backend before creating Vulkan, then
+	// Render resources depend on the distortion of the device, then
 	// swapchain will initialize the window fully and the swapchain,
 	// and finally the renderer is created which renders to
 	// window/swapchain.
 
 	// clang-format off
-	if (!compositor_check_and_prepare_xdev(c, xdev) ||
-	    !compositor_init_window_pre_vulkan(c, ctf, xdev) ||
-	    !compositor_init_vulkan(c) ||
-	    !compositor_init_render_resources(c)) {
+	if (!compositor_init_render_resources(c)) {
 		COMP_ERROR(c, "Failed to init compositor %p", (void *)c);
 		c->base.base.base.destroy(&c->base.base.base);
 
@@ -1124,6 +1201,8 @@ comp_main_create_system_compositor(struct xrt_device *xdev,
 	}
 	// clang-format on
 
+	comp_passthrough_init(&c->passthrough, get_vk(c), c->settings.log_level);
+
 	COMP_DEBUG(c, "Done %p", (void *)c);
 
 	/*!
@@ -1191,6 +1270,12 @@ comp_main_create_system_compositor(struct xrt_device *xdev,
 	}
 	sys_info->supported_blend_mode_count = (uint8_t)xdev->hmd->blend_mode_count;
 
+	// Passthrough layers are only drawn by the compute renderer.
+	sys_info->supports_passthrough = xdev->passthrough_supported && c->settings.use_compute;
+
+	// Only the compute renderer can place inset layers.
+	sys_info->supports_inset_layers = c->settings.use_compute;
+
 	u_var_add_root(c, "Compositor", true);
 
 	float target_frame_time_ms = (float)ns_to_ms(c->settings.nominal_frame_interval_ns);
@@ -1220,3 +1305,309 @@ comp_main_create_system_compositor(struct xrt_device *xdev,
 
 	return comp_multi_create_system_compositor(&c->base.base, upaf, sys_info, !c->deferred_surface, out_xsysc);
 }
+
+
+/*
+ *
+ * Start-up functions.
+ *
+ */
+
+/*!
+ * Brings up the Vulkan instance and device and loads the shaders on a thread of
+ * its own while the devices are being probed. The target is not selected until
+ * the head device is known, as the head device may want a target of its own.
+ */
+struct comp_main_startup
+{
+	struct os_thread thread;
+
+	//! Owned by the thread until it has been joined.
+	struct comp_compositor *c;
+
+	//! Instance extensions of the forced target, the early instance is not created without them.
+	struct u_string_list *required_instance_ext_list;
+
+	/*!
+	 * Instance extensions of every built in target when none was forced,
+	 * enabled where supported. Once the thread is done it holds every
+	 * target extension the early instance was created with.
+	 */
+	struct u_string_list *instance_ext_list;
+
+	//! Did Vulkan and the shaders come up.
+	bool ok;
+};
+
+static void
+startup_append_instance_extensions(struct u_string_list *list, const struct comp_target_factory *ctf)
+{
+	for (size_t i = 0; i < ctf->required_instance_extension_count; i++) {
+		u_string_list_append_unique(list, ctf->required_instance_extensions[i]);
+	}
+}
+
+/*!
+ * The extensions of the forced target are required. Otherwise it is not known
+ * yet which target will be selected, so the extensions of every built in
+ * target are only asked for, a missing one must not stop the instance.
+ */
+static void
+startup_instance_extensions(struct comp_main_startup *cms, const struct comp_target_factory *ctf)
+{
+	cms->required_instance_ext_list = u_string_list_create();
+	cms->instance_ext_list = u_string_list_create();
+
+	if (ctf != NULL) {
+		startup_append_instance_extensions(cms->required_instance_ext_list, ctf);
+		return;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(ctfs); i++) {
+		startup_append_instance_extensions(cms->instance_ext_list, ctfs[i]);
+	}
+}
+
+/*!
+ * Swaps the asked for extensions for the ones the instance was created with,
+ * that is the required ones and the supported optional ones.
+ */
+static void
+startup_keep_enabled_instance_extensions(struct comp_main_startup *cms)
+{
+	struct vk_bundle *vk = get_vk(cms->c);
+	struct u_string_list *list = u_string_list_create_from_list(cms->required_instance_ext_list);
+
+	VkExtensionProperties *props = NULL;
+	uint32_t prop_count = 0;
+	VkResult ret = vk_enumerate_instance_extensions_properties(vk, NULL, &prop_count, &props);
+	if (ret != VK_SUCCESS) {
+		// Already logged, only the required ones are known to be there.
+		prop_count = 0;
+	}
+
+	const char *const *exts = u_string_list_get_data(cms->instance_ext_list);
+	uint32_t ext_count = u_string_list_get_size(cms->instance_ext_list);
+	for (uint32_t i = 0; i < ext_count; i++) {
+		for (uint32_t k = 0; k < prop_count; k++) {
+			if (strcmp(exts[i], props[k].extensionName) == 0) {
+				u_string_list_append_unique(list, exts[i]);
+				break;
+			}
+		}
+	}
+
+	free(props);
+
+	u_string_list_destroy(&cms->instance_ext_list);
+	cms->instance_ext_list = list;
+}
+
+static bool
+startup_has_instance_extensions(struct comp_main_startup *cms, const struct comp_target_factory *ctf)
+{
+	for (size_t i = 0; i < ctf->required_instance_extension_count; i++) {
+		if (!u_string_list_contains(cms->instance_ext_list, ctf->required_instance_extensions[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void *
+startup_thread(void *ptr)
+{
+	struct comp_main_startup *cms = (struct comp_main_startup *)ptr;
+	struct comp_compositor *c = cms->c;
+
+	U_TRACE_SET_THREAD_NAME("Compositor: Start-up");
+
+	const char *const *exts = u_string_list_get_data(cms->required_instance_ext_list);
+	uint32_t ext_count = u_string_list_get_size(cms->required_instance_ext_list);
+	const char *const *optional_exts = u_string_list_get_data(cms->instance_ext_list);
+	uint32_t optional_ext_count = u_string_list_get_size(cms->instance_ext_list);
+
+	if (!compositor_init_vulkan_with_extensions(c, exts, ext_count, optional_exts, optional_ext_count) ||
+	    !compositor_init_shaders(c)) {
+		return NULL;
+	}
+
+	// What the selected target is checked against when the thread is joined.
+	startup_keep_enabled_instance_extensions(cms);
+
+	cms->ok = true;
+
+	return NULL;
+}
+
+static void
+startup_join(struct comp_main_startup *cms)
+{
+	os_thread_join(&cms->thread);
+	os_thread_destroy(&cms->thread);
+}
+
+//! The compositor has to have been handed on or destroyed by now.
+static void
+startup_free(struct comp_main_startup **cms_ptr)
+{
+	u_string_list_destroy(&(*cms_ptr)->required_instance_ext_list);
+	u_string_list_destroy(&(*cms_ptr)->instance_ext_list);
+	free(*cms_ptr);
+	*cms_ptr = NULL;
+}
+
+static xrt_result_t
+compositor_create_serial(struct xrt_device *xdev,
+                         const struct comp_target_factory *ctf,
+                         struct xrt_system_compositor **out_xsysc)
+{
+	struct comp_compositor *c = compositor_alloc();
+	c->xdev = xdev;
+
+	comp_settings_init_from_device(&c->settings, xdev);
+
+	// Need to select window backend before creating Vulkan.
+	const struct comp_target_factory *selected_ctf = select_target_factory_from_xdev(c, xdev, ctf);
+
+	// clang-format off
+	if (!compositor_check_and_prepare_xdev(c, xdev) ||
+	    !compositor_init_window_pre_vulkan(c, selected_ctf) ||
+	    !compositor_init_vulkan(c) ||
+	    !compositor_init_shaders(c)) {
+		COMP_ERROR(c, "Failed to init compositor %p", (void *)c);
+		c->base.base.base.destroy(&c->base.base.base);
+
+		return XRT_ERROR_VULKAN;
+	}
+	// clang-format on
+
+	return compositor_init_with_device(c, xdev, out_xsysc);
+}
+
+xrt_result_t
+comp_main_create_system_compositor(struct xrt_device *xdev,
+                                   const struct comp_target_factory *ctf,
+                                   struct xrt_system_compositor **out_xsysc)
+{
+	COMP_TRACE_MARKER();
+
+	return compositor_create_serial(xdev, ctf, out_xsysc);
+}
+
+xrt_result_t
+comp_main_startup_begin(const struct comp_target_factory *ctf, struct comp_main_startup **out_cms)
+{
+	COMP_TRACE_MARKER();
+
+	struct comp_main_startup *cms = U_TYPED_CALLOC(struct comp_main_startup);
+	struct comp_compositor *c = compositor_alloc();
+	cms->c = c;
+	startup_instance_extensions(cms, ctf);
+
+	int ret = os_thread_init(&cms->thread);
+	if (ret == 0) {
+		ret = os_thread_start(&cms->thread, startup_thread, cms);
+	}
+	if (ret != 0) {
+		COMP_ERROR(c, "Failed to start the start-up thread: %i", ret);
+		c->base.base.base.destroy(&c->base.base.base);
+		startup_free(&cms);
+		return XRT_ERROR_THREADING_INIT_FAILURE;
+	}
+
+	*out_cms = cms;
+
+	return XRT_SUCCESS;
+}
+
+xrt_result_t
+comp_main_startup_finish(struct comp_main_startup **cms_ptr,
+                         struct xrt_device *xdev,
+                         const struct comp_target_factory *ctf,
+                         struct xrt_system_compositor **out_xsysc)
+{
+	COMP_TRACE_MARKER();
+
+	struct comp_main_startup *cms = *cms_ptr;
+	if (cms == NULL) {
+		return compositor_create_serial(xdev, ctf, out_xsysc);
+	}
+
+	struct comp_compositor *c = cms->c;
+
+	// Still overlaps with the start-up thread, only touches the device.
+	bool xdev_ok = compositor_check_and_prepare_xdev(c, xdev);
+
+	startup_join(cms);
+
+	if (!xdev_ok) {
+		COMP_ERROR(c, "Failed to init compositor %p", (void *)c);
+		goto err_destroy;
+	}
+
+	if (!cms->ok) {
+		COMP_INFO(c, "Could not start Vulkan early, starting over.");
+		goto err_serial;
+	}
+
+	c->xdev = xdev;
+
+	comp_settings_init_from_device(&c->settings, xdev);
+
+	// The head device is known now, it might want a target of its own.
+	const struct comp_target_factory *selected_ctf = select_target_factory_from_xdev(c, xdev, ctf);
+
+	if (selected_ctf != NULL && !startup_has_instance_extensions(cms, selected_ctf)) {
+		COMP_INFO(c, "Vulkan was started early without the extensions %s needs, starting over.",
+		          selected_ctf->name);
+		goto err_serial;
+	}
+
+	if (!compositor_init_window_pre_vulkan(c, selected_ctf)) {
+		COMP_ERROR(c, "Failed to init compositor %p", (void *)c);
+		goto err_destroy;
+	}
+
+	// Selected from the settings or by detecting, covered unless another target was forced at begin.
+	if (!startup_has_instance_extensions(cms, c->target_factory)) {
+		COMP_INFO(c, "Vulkan was started early without the extensions %s needs, starting over.",
+		          c->target_factory->name);
+		goto err_serial;
+	}
+
+	startup_free(cms_ptr);
+
+	return compositor_init_with_device(c, xdev, out_xsysc);
+
+err_serial:
+	/*
+	 * Throw away everything that was brought up, the device is asked for
+	 * its target again but only the fresh compositor is kept.
+	 */
+	c->base.base.base.destroy(&c->base.base.base);
+	startup_free(cms_ptr);
+
+	return compositor_create_serial(xdev, ctf, out_xsysc);
+
+err_destroy:
+	c->base.base.base.destroy(&c->base.base.base);
+	startup_free(cms_ptr);
+
+	return XRT_ERROR_VULKAN;
+}
+
+void
+comp_main_startup_destroy(struct comp_main_startup **cms_ptr)
+{
+	struct comp_main_startup *cms = *cms_ptr;
+	if (cms == NULL) {
+		return;
+	}
+
+	startup_join(cms);
+
+	cms->c->base.base.base.destroy(&cms->c->base.base.base);
+	startup_free(cms_ptr);
+}
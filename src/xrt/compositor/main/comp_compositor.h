@@ -28,6 +28,7 @@
 #include "main/comp_window.h"
 #include "main/comp_settings.h"
 #include "main/comp_renderer.h"
+#include "main/comp_passthrough.h"
 
 struct comp_window_peek;
 struct comp_target_factory;
@@ -117,6 +118,9 @@ struct comp_compositor
 	//! Renderer helper.
 	struct comp_renderer *r;
 
+	//! Camera images for passthrough layers.
+	struct comp_passthrough passthrough;
+
 	//! Timestamp of last-rendered (immersive) frame.
 	int64_t last_frame_time_ns;
 
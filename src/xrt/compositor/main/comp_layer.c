@@ -343,6 +343,8 @@ comp_layer_draw(struct comp_render_layer *self,
 	case XRT_LAYER_EQUIRECT2:
 	case XRT_LAYER_CUBE: _update_mvp_matrix(self, eye, vp); break;
 	case XRT_LAYER_STEREO_PROJECTION_DEPTH:
+	case XRT_LAYER_STEREO_PROJECTION_SPACE_WARP:
+	case XRT_LAYER_PASSTHROUGH:
 		// Should never end up here.
 		assert(false);
 	}
@@ -15,6 +15,7 @@
 #include "xrt/xrt_compositor.h"
 
 struct comp_target_factory;
+struct comp_main_startup;
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +39,56 @@ comp_main_create_system_compositor(struct xrt_device *xdev,
                                    const struct comp_target_factory *ctf,
                                    struct xrt_system_compositor **out_xsysc);
 
+/*!
+ * Starts bringing up the Vulkan instance and device and loading the shaders of
+ * the main compositor on a thread of its own, so it can be done while the
+ * devices are being probed. No target is selected here, finish with
+ * @ref comp_main_startup_finish once the head device is known, or
+ * @ref comp_main_startup_destroy if there will be no compositor.
+ *
+ * @ingroup comp_main
+ *
+ * @param ctf The compositor target factory that is going to be forced, the
+ * instance is only created with the extensions it needs. If NULL the instance
+ * is created with those extensions of every built in target that are
+ * supported, the selected target's are checked for at finish.
+ * @param[out] out_cms The start-up state.
+ */
+xrt_result_t
+comp_main_startup_begin(const struct comp_target_factory *ctf, struct comp_main_startup **out_cms);
+
+/*!
+ * Waits for the start-up thread and creates the main compositor from what it
+ * brought up, the target is selected here since the head device may provide
+ * it. Falls back to @ref comp_main_create_system_compositor if the start-up
+ * thread failed, if the selected target needs instance extensions that the
+ * early instance wasn't created with, or if @p cms_ptr points at NULL.
+ * The start-up state is always consumed.
+ *
+ * @ingroup comp_main
+ * @relates xrt_system_compositor
+ *
+ * @param cms_ptr Pointer to the start-up state, set to NULL.
+ * @param xdev The head device
+ * @param ctf A compositor target factory to force the output device, see
+ * @ref comp_main_create_system_compositor.
+ * @param out_xsysc The output compositor
+ */
+xrt_result_t
+comp_main_startup_finish(struct comp_main_startup **cms_ptr,
+                         struct xrt_device *xdev,
+                         const struct comp_target_factory *ctf,
+                         struct xrt_system_compositor **out_xsysc);
+
+/*!
+ * Waits for the start-up thread and throws away what it brought up, does
+ * NULL checking and sets the pointer to NULL.
+ *
+ * @ingroup comp_main
+ */
+void
+comp_main_startup_destroy(struct comp_main_startup **cms_ptr);
+
 
 #ifdef __cplusplus
 }
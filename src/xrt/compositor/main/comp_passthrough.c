@@ -0,0 +1,722 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Passthrough camera images for the main compositor.
+ * @author agent <agent@local>
+ * @ingroup comp_main
+ */
+
+#include "util/u_misc.h"
+#include "util/u_time.h"
+#include "util/u_format.h"
+#include "util/u_handles.h"
+#include "util/u_logging.h"
+#include "util/u_trace_marker.h"
+
+#include "main/comp_passthrough.h"
+
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+
+#ifdef XRT_GRAPHICS_BUFFER_HANDLE_IS_FD
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+/*!
+ * Cameras are stopped after no frame has had a passthrough layer for this
+ * long, so apps toggling passthrough quickly don't restart them every time.
+ */
+#define IDLE_STOP_NS (U_TIME_1S_IN_NS)
+
+#define CP_DEBUG(cp, ...) U_LOG_IFL_D(cp->log_level, __VA_ARGS__)
+#define CP_WARN(cp, ...) U_LOG_IFL_W(cp->log_level, __VA_ARGS__)
+#define CP_ERROR(cp, ...) U_LOG_IFL_E(cp->log_level, __VA_ARGS__)
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+static inline struct comp_passthrough *
+comp_passthrough(struct xrt_frame_sink *xfs)
+{
+	return (struct comp_passthrough *)xfs;
+}
+
+static bool
+is_format_supported(enum xrt_format format)
+{
+	switch (format) {
+	case XRT_FORMAT_R8G8B8A8:
+	case XRT_FORMAT_R8G8B8X8:
+	case XRT_FORMAT_R8G8B8:
+	case XRT_FORMAT_L8: return true;
+	default: return false;
+	}
+}
+
+//! Single channel frames get a single channel image if the device can sample one.
+static VkFormat
+image_format_for(const struct comp_passthrough *cp, enum xrt_format format)
+{
+	// Camera images are sRGB encoded, sample them as linear like the app images.
+	if (format == XRT_FORMAT_L8 && cp->has_r8_srgb) {
+		return VK_FORMAT_R8_SRGB;
+	}
+
+	return VK_FORMAT_R8G8B8A8_SRGB;
+}
+
+static uint32_t
+image_texel_size(VkFormat format)
+{
+	return format == VK_FORMAT_R8_SRGB ? 1 : 4;
+}
+
+static void
+destroy_import(struct comp_passthrough *cp, struct comp_passthrough_import *imp)
+{
+	struct vk_bundle *vk = cp->vk;
+
+	assert(imp->users == 0);
+
+	if (imp->buffer != VK_NULL_HANDLE) {
+		vk->vkDestroyBuffer(vk->device, imp->buffer, NULL);
+	}
+	if (imp->memory != VK_NULL_HANDLE) {
+		vk->vkFreeMemory(vk->device, imp->memory, NULL);
+	}
+
+	U_ZERO(imp);
+}
+
+//! The GPU is done with the last upload into the image, let go of what it read from.
+static void
+release_import(struct comp_passthrough *cp, struct comp_passthrough_image *img)
+{
+	if (img->import != NULL) {
+		assert(img->import->users > 0);
+		img->import->users--;
+		img->import = NULL;
+	}
+
+	xrt_frame_reference(&img->frame, NULL);
+}
+
+static void
+destroy_image(struct comp_passthrough *cp, struct comp_passthrough_image *img)
+{
+	struct vk_bundle *vk = cp->vk;
+
+	release_import(cp, img);
+
+	render_buffer_close(vk, &img->staging);
+
+	if (img->view != VK_NULL_HANDLE) {
+		vk->vkDestroyImageView(vk->device, img->view, NULL);
+		img->view = VK_NULL_HANDLE;
+	}
+	if (img->image != VK_NULL_HANDLE) {
+		vk->vkDestroyImage(vk->device, img->image, NULL);
+		img->image = VK_NULL_HANDLE;
+	}
+	if (img->memory != VK_NULL_HANDLE) {
+		vk->vkFreeMemory(vk->device, img->memory, NULL);
+		img->memory = VK_NULL_HANDLE;
+	}
+
+	img->extent = (VkExtent2D){0, 0};
+	img->format = VK_FORMAT_UNDEFINED;
+}
+
+static bool
+ensure_image(struct comp_passthrough *cp, struct comp_passthrough_image *img, VkExtent2D extent, VkFormat format)
+{
+	struct vk_bundle *vk = cp->vk;
+	VkResult ret;
+
+	if (img->image != VK_NULL_HANDLE && img->extent.width == extent.width && img->extent.height == extent.height &&
+	    img->format == format) {
+		return true;
+	}
+
+	destroy_image(cp, img);
+
+	VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+	ret = vk_create_image_simple(vk, extent, format, usage, &img->memory, &img->image);
+	if (ret != VK_SUCCESS) {
+		CP_ERROR(cp, "vk_create_image_simple: %s", vk_result_string(ret));
+		return false;
+	}
+
+	VkImageSubresourceRange subresource_range = {
+	    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+	    .baseMipLevel = 0,
+	    .levelCount = 1,
+	    .baseArrayLayer = 0,
+	    .layerCount = 1,
+	};
+
+	VkComponentMapping components = {
+	    .r = VK_COMPONENT_SWIZZLE_R,
+	    .g = VK_COMPONENT_SWIZZLE_G,
+	    .b = VK_COMPONENT_SWIZZLE_B,
+	    .a = VK_COMPONENT_SWIZZLE_ONE,
+	};
+
+	// Grey, the one channel goes to all three.
+	if (format == VK_FORMAT_R8_SRGB) {
+		components.g = VK_COMPONENT_SWIZZLE_R;
+		components.b = VK_COMPONENT_SWIZZLE_R;
+	}
+
+	ret = vk_create_view_swizzle(vk, img->image, VK_IMAGE_VIEW_TYPE_2D, format, subresource_range, components,
+	                             &img->view);
+	if (ret != VK_SUCCESS) {
+		CP_ERROR(cp, "vk_create_view_swizzle: %s", vk_result_string(ret));
+		destroy_image(cp, img);
+		return false;
+	}
+
+	VkDeviceSize size = (VkDeviceSize)extent.width * extent.height * image_texel_size(format);
+	VkMemoryPropertyFlags memory_property_flags =
+	    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+	ret = render_buffer_init(vk, &img->staging, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, memory_property_flags, size);
+	if (ret == VK_SUCCESS) {
+		ret = render_buffer_map(vk, &img->staging);
+	}
+	if (ret != VK_SUCCESS) {
+		CP_ERROR(cp, "Failed to create staging buffer: %s", vk_result_string(ret));
+		destroy_image(cp, img);
+		return false;
+	}
+
+	img->extent = extent;
+	img->format = format;
+
+	CP_DEBUG(cp, "Created %ux%u %s passthrough image.", extent.width, extent.height, vk_format_string(format));
+
+	return true;
+}
+
+#if defined(XRT_GRAPHICS_BUFFER_HANDLE_IS_FD) && defined(VK_EXT_external_memory_dma_buf)
+/*!
+ * Imports the whole dma-buf as a buffer into @p imp, the caller has checked
+ * that the slot is free.
+ */
+static bool
+import_dma_buf(struct comp_passthrough *cp, struct comp_passthrough_import *imp, int fd, uint64_t inode)
+{
+	struct vk_bundle *vk = cp->vk;
+	VkResult ret;
+
+	// Frames might only be part of the buffer, import all of it so every frame in it can use the import.
+	off_t size = lseek(fd, 0, SEEK_END);
+	lseek(fd, 0, SEEK_SET);
+	if (size <= 0) {
+		CP_DEBUG(cp, "Could not get the size of the dma-buf.");
+		return false;
+	}
+
+	VkExternalMemoryHandleTypeFlagBits handle_type = VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+
+	VkMemoryFdPropertiesKHR fd_properties = {
+	    .sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR,
+	};
+
+	ret = vk->vkGetMemoryFdPropertiesKHR(vk->device, handle_type, fd, &fd_properties);
+	if (ret != VK_SUCCESS) {
+		CP_DEBUG(cp, "vkGetMemoryFdPropertiesKHR: %s", vk_result_string(ret));
+		return false;
+	}
+
+	VkExternalMemoryBufferCreateInfo external_create_info = {
+	    .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+	    .handleTypes = handle_type,
+	};
+
+	VkBufferCreateInfo buffer_info = {
+	    .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+	    .pNext = &external_create_info,
+	    .size = (VkDeviceSize)size,
+	    .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	    .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+	};
+
+	ret = vk->vkCreateBuffer(vk->device, &buffer_info, NULL, &imp->buffer);
+	if (ret != VK_SUCCESS) {
+		CP_DEBUG(cp, "vkCreateBuffer: %s", vk_result_string(ret));
+		destroy_import(cp, imp);
+		return false;
+	}
+
+	VkMemoryRequirements requirements;
+	vk->vkGetBufferMemoryRequirements(vk->device, imp->buffer, &requirements);
+
+	uint32_t memory_type_index = 0;
+	if (!vk_get_memory_type(vk, requirements.memoryTypeBits & fd_properties.memoryTypeBits, 0,
+	                        &memory_type_index)) {
+		CP_DEBUG(cp, "No memory type to import the dma-buf into.");
+		destroy_import(cp, imp);
+		return false;
+	}
+
+	// Vulkan takes ownership of the fd on success, the frame keeps its own.
+	xrt_graphics_buffer_handle_t handle = u_graphics_buffer_ref(fd);
+
+	VkImportMemoryFdInfoKHR import_info = {
+	    .sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR,
+	    .handleType = handle_type,
+	    .fd = handle,
+	};
+
+	VkMemoryAllocateInfo alloc_info = {
+	    .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+	    .pNext = &import_info,
+	    .allocationSize = requirements.size,
+	    .memoryTypeIndex = memory_type_index,
+	};
+
+	ret = vk->vkAllocateMemory(vk->device, &alloc_info, NULL, &imp->memory);
+	if (ret != VK_SUCCESS) {
+		CP_DEBUG(cp, "vkAllocateMemory: %s", vk_result_string(ret));
+		u_graphics_buffer_unref(&handle);
+		destroy_import(cp, imp);
+		return false;
+	}
+
+	ret = vk->vkBindBufferMemory(vk->device, imp->buffer, imp->memory, 0);
+	if (ret != VK_SUCCESS) {
+		CP_DEBUG(cp, "vkBindBufferMemory: %s", vk_result_string(ret));
+		destroy_import(cp, imp);
+		return false;
+	}
+
+	imp->inode = inode;
+	imp->size = (VkDeviceSize)size;
+
+	CP_DEBUG(cp, "Imported camera dma-buf %" PRIu64 ", %" PRIu64 " bytes.", inode, imp->size);
+
+	return true;
+}
+
+/*!
+ * The import of the dma-buf behind @p fd, cameras cycle through the same
+ * buffers so it is usually imported already. Returns NULL if it can't be.
+ */
+static struct comp_passthrough_import *
+get_import(struct comp_passthrough *cp, int fd)
+{
+	// The fd might be a different one for the same buffer, the inode is what identifies it.
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_ino == 0) {
+		return NULL;
+	}
+
+	uint64_t inode = (uint64_t)st.st_ino;
+	struct comp_passthrough_import *slot = NULL;
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(cp->imports); i++) {
+		struct comp_passthrough_import *imp = &cp->imports[i];
+		if (imp->inode == inode) {
+			imp->last_used = cp->upload_count;
+			return imp;
+		}
+
+		// Free slots first, then the least recently used one the GPU might not be reading.
+		if (imp->users > 0) {
+			continue;
+		}
+		if (slot == NULL || (slot->inode != 0 && (imp->inode == 0 || imp->last_used < slot->last_used))) {
+			slot = imp;
+		}
+	}
+
+	if (slot == NULL) {
+		CP_DEBUG(cp, "All dma-buf imports are in use.");
+		return NULL;
+	}
+
+	if (slot->inode != 0) {
+		destroy_import(cp, slot);
+	}
+
+	if (!import_dma_buf(cp, slot, fd, inode)) {
+		return NULL;
+	}
+
+	slot->last_used = cp->upload_count;
+
+	return slot;
+}
+#endif
+
+/*!
+ * Uses the dma-buf behind the frame as the buffer that the image is copied
+ * from, so the pixels never pass through the CPU.
+ */
+static bool
+try_import(struct comp_passthrough *cp,
+           struct comp_passthrough_image *img,
+           struct xrt_frame *xf,
+           VkDeviceSize *out_offset,
+           uint32_t *out_row_length)
+{
+#if defined(XRT_GRAPHICS_BUFFER_HANDLE_IS_FD) && defined(VK_EXT_external_memory_dma_buf)
+	struct vk_bundle *vk = cp->vk;
+
+	if (!xf->has_buffer_handle || !vk->has_EXT_external_memory_dma_buf) {
+		return false;
+	}
+
+	// Only frames that are laid out like the image, with rows and offset aligned to texels.
+	uint32_t texel_size = image_texel_size(img->format);
+	bool same_layout = false;
+	switch (xf->format) {
+	case XRT_FORMAT_R8G8B8A8:
+	case XRT_FORMAT_R8G8B8X8: same_layout = texel_size == 4; break;
+	case XRT_FORMAT_L8: same_layout = texel_size == 1; break;
+	default: break;
+	}
+
+	if (!same_layout || xf->stride % texel_size != 0 || xf->buffer_offset % texel_size != 0) {
+		return false;
+	}
+
+	struct comp_passthrough_import *imp = get_import(cp, xf->buffer_handle);
+	if (imp == NULL) {
+		return false;
+	}
+
+	if (xf->buffer_offset + (VkDeviceSize)xf->stride * xf->height > imp->size) {
+		CP_DEBUG(cp, "Frame is outside of its dma-buf.");
+		return false;
+	}
+
+	img->import = imp;
+	imp->users++;
+
+	// The GPU reads the memory of the frame, keep it alive until the image is reused.
+	xrt_frame_reference(&img->frame, xf);
+
+	*out_offset = xf->buffer_offset;
+	*out_row_length = xf->stride / texel_size;
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+//! Copies the frame into the staging buffer, expanding it to RGBA unless the image is single channel.
+static void
+copy_to_staging(struct comp_passthrough_image *img, struct xrt_frame *xf)
+{
+	uint8_t *dst = (uint8_t *)img->staging.mapped;
+	uint32_t width = xf->width;
+	uint32_t texel_size = image_texel_size(img->format);
+
+	for (uint32_t y = 0; y < xf->height; y++) {
+		const uint8_t *src = xf->data + y * xf->stride;
+		uint8_t *row = dst + y * width * texel_size;
+
+		// Single channel image, nothing to expand.
+		if (texel_size == 1) {
+			memcpy(row, src, width);
+			continue;
+		}
+
+		switch (xf->format) {
+		case XRT_FORMAT_R8G8B8A8:
+		case XRT_FORMAT_R8G8B8X8: memcpy(row, src, width * 4); break;
+		case XRT_FORMAT_R8G8B8:
+			for (uint32_t x = 0; x < width; x++) {
+				row[x * 4 + 0] = src[x * 3 + 0];
+				row[x * 4 + 1] = src[x * 3 + 1];
+				row[x * 4 + 2] = src[x * 3 + 2];
+				row[x * 4 + 3] = 0xff;
+			}
+			break;
+		case XRT_FORMAT_L8:
+			for (uint32_t x = 0; x < width; x++) {
+				row[x * 4 + 0] = src[x];
+				row[x * 4 + 1] = src[x];
+				row[x * 4 + 2] = src[x];
+				row[x * 4 + 3] = 0xff;
+			}
+			break;
+		default: assert(false);
+		}
+	}
+}
+
+static bool
+upload(struct comp_passthrough *cp, struct comp_passthrough_image *img, struct xrt_frame *xf, VkCommandBuffer cmd)
+{
+	COMP_TRACE_MARKER();
+
+	struct vk_bundle *vk = cp->vk;
+
+	if (!is_format_supported(xf->format)) {
+		uint64_t bit = 1ull << (xf->format % 64);
+		if ((cp->warned_formats & bit) == 0) {
+			CP_WARN(cp, "Passthrough frames in format %s are not supported.", u_format_str(xf->format));
+			cp->warned_formats |= bit;
+		}
+		return false;
+	}
+
+	// The GPU is done with this image, it was last used a whole ring ago.
+	release_import(cp, img);
+
+	if (!ensure_image(cp, img, (VkExtent2D){xf->width, xf->height}, image_format_for(cp, xf->format))) {
+		return false;
+	}
+
+	cp->upload_count++;
+
+	VkBuffer src_buffer = img->staging.buffer;
+	VkDeviceSize src_offset = 0;
+	uint32_t src_row_length = 0;
+
+	if (try_import(cp, img, xf, &src_offset, &src_row_length)) {
+		src_buffer = img->import->buffer;
+	} else {
+		copy_to_staging(img, xf);
+	}
+
+	VkImageSubresourceRange subresource_range = {
+	    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+	    .baseMipLevel = 0,
+	    .levelCount = 1,
+	    .baseArrayLayer = 0,
+	    .layerCount = 1,
+	};
+
+	vk_cmd_image_barrier_locked(              //
+	    vk,                                   // vk_bundle
+	    cmd,                                  // cmd_buffer
+	    img->image,                           // image
+	    0,                                    // src_access_mask
+	    VK_ACCESS_TRANSFER_WRITE_BIT,         // dst_access_mask
+	    VK_IMAGE_LAYOUT_UNDEFINED,            // old_image_layout
+	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // new_image_layout
+	    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,    // src_stage_mask
+	    VK_PIPELINE_STAGE_TRANSFER_BIT,       // dst_stage_mask
+	    subresource_range);                   // subresource_range
+
+	VkBufferImageCopy region = {
+	    .bufferOffset = src_offset,
+	    .bufferRowLength = src_row_length,
+	    .bufferImageHeight = 0,
+	    .imageSubresource =
+	        {
+	            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+	            .mipLevel = 0,
+	            .baseArrayLayer = 0,
+	            .layerCount = 1,
+	        },
+	    .imageOffset = {0, 0, 0},
+	    .imageExtent = {xf->width, xf->height, 1},
+	};
+
+	vk->vkCmdCopyBufferToImage(               //
+	    cmd,                                  // commandBuffer
+	    src_buffer,                           // srcBuffer
+	    img->image,                           // dstImage
+	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // dstImageLayout
+	    1,                                    // regionCount
+	    &region);                             // pRegions
+
+	vk_cmd_image_barrier_locked(                  //
+	    vk,                                       // vk_bundle
+	    cmd,                                      // cmd_buffer
+	    img->image,                               // image
+	    VK_ACCESS_TRANSFER_WRITE_BIT,             // src_access_mask
+	    VK_ACCESS_SHADER_READ_BIT,                // dst_access_mask
+	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,     // old_image_layout
+	    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, // new_image_layout
+	    VK_PIPELINE_STAGE_TRANSFER_BIT,           // src_stage_mask
+	    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,     // dst_stage_mask
+	    subresource_range);                       // subresource_range
+
+	// One camera per half of side by side frames, otherwise both views get the whole image.
+	if (xf->stereo_format == XRT_STEREO_FORMAT_SBS) {
+		img->rects[0] = (struct xrt_normalized_rect){.x = 0.0f, .y = 0.0f, .w = 0.5f, .h = 1.0f};
+		img->rects[1] = (struct xrt_normalized_rect){.x = 0.5f, .y = 0.0f, .w = 0.5f, .h = 1.0f};
+	} else {
+		img->rects[0] = (struct xrt_normalized_rect){.x = 0.0f, .y = 0.0f, .w = 1.0f, .h = 1.0f};
+		img->rects[1] = img->rects[0];
+	}
+
+	img->timestamp_ns = xf->timestamp;
+
+	return true;
+}
+
+static void
+stop(struct comp_passthrough *cp, struct xrt_device *xdev)
+{
+	xrt_device_set_passthrough_sink(xdev, NULL, NULL);
+	cp->running = false;
+
+	// No more frames are pushed, safe to drop the last one.
+	os_mutex_lock(&cp->latest_mutex);
+	xrt_frame_reference(&cp->latest, NULL);
+	os_mutex_unlock(&cp->latest_mutex);
+
+	// Don't show a stale image when started again.
+	cp->current = -1;
+
+	// The camera frees its buffers, don't keep them alive through imports the GPU is done with.
+	for (uint32_t i = 0; i < ARRAY_SIZE(cp->imports); i++) {
+		if (cp->imports[i].users == 0) {
+			destroy_import(cp, &cp->imports[i]);
+		}
+	}
+
+	CP_DEBUG(cp, "Stopped passthrough cameras.");
+}
+
+
+/*
+ *
+ * Sink functions.
+ *
+ */
+
+static void
+passthrough_push_frame(struct xrt_frame_sink *xfs, struct xrt_frame *xf)
+{
+	struct comp_passthrough *cp = comp_passthrough(xfs);
+
+	// Only the newest frame is kept, older ones that were never uploaded are dropped.
+	os_mutex_lock(&cp->latest_mutex);
+	xrt_frame_reference(&cp->latest, xf);
+	os_mutex_unlock(&cp->latest_mutex);
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+comp_passthrough_init(struct comp_passthrough *cp, struct vk_bundle *vk, enum u_logging_level log_level)
+{
+	U_ZERO(cp);
+
+	cp->base.push_frame = passthrough_push_frame;
+	cp->vk = vk;
+	cp->log_level = log_level;
+	cp->current = -1;
+
+	VkFormatProperties prop;
+	VkFormatFeatureFlags needed = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |               //
+	                              VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | //
+	                              VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+	vk->vkGetPhysicalDeviceFormatProperties(vk->physical_device, VK_FORMAT_R8_SRGB, &prop);
+	cp->has_r8_srgb = (prop.optimalTilingFeatures & needed) == needed;
+
+	os_mutex_init(&cp->latest_mutex);
+}
+
+void
+comp_passthrough_set_in_use(struct comp_passthrough *cp, struct xrt_device *xdev, bool in_use, uint64_t now_ns)
+{
+	if (in_use) {
+		cp->last_used_ns = now_ns;
+	}
+
+	if (in_use && !cp->running) {
+		xrt_result_t xret = xrt_device_set_passthrough_sink(xdev, &cp->base, &cp->info);
+		if (xret != XRT_SUCCESS) {
+			// Tried again every frame, only tell about it once.
+			if (!cp->start_failed) {
+				CP_ERROR(cp, "Failed to start passthrough cameras: %d", xret);
+				cp->start_failed = true;
+			}
+			return;
+		}
+
+		cp->running = true;
+		cp->start_failed = false;
+		CP_DEBUG(cp, "Started passthrough cameras.");
+		return;
+	}
+
+	if (!in_use && cp->running && now_ns - cp->last_used_ns > IDLE_STOP_NS) {
+		stop(cp, xdev);
+	}
+}
+
+const struct comp_passthrough_image *
+comp_passthrough_update(struct comp_passthrough *cp, VkCommandBuffer cmd)
+{
+	struct xrt_frame *xf = NULL;
+
+	// Take over the reference, the device thread can push the next one meanwhile.
+	os_mutex_lock(&cp->latest_mutex);
+	xf = cp->latest;
+	cp->latest = NULL;
+	os_mutex_unlock(&cp->latest_mutex);
+
+	if (xf != NULL) {
+		int32_t next = (cp->current + 1) % COMP_PASSTHROUGH_RING_SIZE;
+		if (upload(cp, &cp->images[next], xf, cmd)) {
+			cp->current = next;
+		}
+
+		xrt_frame_reference(&xf, NULL);
+	}
+
+	if (cp->current < 0) {
+		return NULL;
+	}
+
+	return &cp->images[cp->current];
+}
+
+void
+comp_passthrough_fini(struct comp_passthrough *cp, struct xrt_device *xdev)
+{
+	// Never initialised.
+	if (cp->vk == NULL) {
+		return;
+	}
+
+	if (cp->running) {
+		stop(cp, xdev);
+	}
+
+	struct vk_bundle *vk = cp->vk;
+
+	// The last frames might still be sampling the images.
+	os_mutex_lock(&vk->queue_mutex);
+	vk->vkQueueWaitIdle(vk->queue);
+	os_mutex_unlock(&vk->queue_mutex);
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(cp->images); i++) {
+		destroy_image(cp, &cp->images[i]);
+	}
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(cp->imports); i++) {
+		destroy_import(cp, &cp->imports[i]);
+	}
+
+	xrt_frame_reference(&cp->latest, NULL);
+
+	os_mutex_destroy(&cp->latest_mutex);
+
+	cp->vk = NULL;
+}
@@ -0,0 +1,191 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Passthrough camera images for the main compositor.
+ * @author agent <agent@local>
+ * @ingroup comp_main
+ */
+
+#pragma once
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_frame.h"
+
+#include "os/os_threading.h"
+#include "util/u_logging.h"
+
+#include "vk/vk_helpers.h"
+
+#include "render/render_interface.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Number of camera images kept on the GPU, an image is only written again
+ * once the frames that sampled it have finished rendering.
+ *
+ * @ingroup comp_main
+ */
+#define COMP_PASSTHROUGH_RING_SIZE (3)
+
+/*!
+ * Number of camera dma-bufs kept imported, cameras cycle through a small
+ * fixed set of buffers so each is only imported once.
+ *
+ * @ingroup comp_main
+ */
+#define COMP_PASSTHROUGH_IMPORT_COUNT (8)
+
+/*!
+ * A camera dma-buf imported as a buffer that images can be copied from.
+ *
+ * @ingroup comp_main
+ */
+struct comp_passthrough_import
+{
+	//! Inode of the dma-buf, zero if this slot is free.
+	uint64_t inode;
+
+	//! Size of the whole dma-buf.
+	VkDeviceSize size;
+
+	VkDeviceMemory memory;
+	VkBuffer buffer;
+
+	//! Number of images whose last upload was from this buffer.
+	uint32_t users;
+
+	//! Upload count when last used, the least recently used free slot is replaced.
+	uint64_t last_used;
+};
+
+/*!
+ * One camera image on the GPU and what is needed to upload into it.
+ *
+ * @ingroup comp_main
+ */
+struct comp_passthrough_image
+{
+	VkExtent2D extent;
+	VkFormat format;
+	VkDeviceMemory memory;
+	VkImage image;
+
+	//! sRGB view with alpha forced to one, camera images are opaque.
+	VkImageView view;
+
+	//! Host visible buffer that frames without a dma-buf are copied into.
+	struct render_buffer staging;
+
+	//! The imported dma-buf the last upload was from, if any.
+	struct comp_passthrough_import *import;
+
+	//! Kept alive while the GPU might read the dma-buf of it.
+	struct xrt_frame *frame;
+
+	//! Sub-rect of each view, in normalized image coordinates.
+	struct xrt_normalized_rect rects[2];
+
+	//! When the image was captured.
+	uint64_t timestamp_ns;
+};
+
+/*!
+ * Receives the camera frames of the device and gets the latest one onto the
+ * GPU for the passthrough layers. Frames are pushed from the thread of the
+ * device, everything else is only called from the compositor thread.
+ * Embedded in @ref comp_compositor.
+ *
+ * @ingroup comp_main
+ * @implements xrt_frame_sink
+ */
+struct comp_passthrough
+{
+	struct xrt_frame_sink base;
+
+	struct vk_bundle *vk;
+
+	enum u_logging_level log_level;
+
+	//! Protects @ref latest.
+	struct os_mutex latest_mutex;
+
+	//! The newest frame not yet uploaded, NULL if none.
+	struct xrt_frame *latest;
+
+	//! Is the device pushing frames to us.
+	bool running;
+
+	//! Starting failed and has been logged.
+	bool start_failed;
+
+	//! Where the cameras are, set when starting.
+	struct xrt_passthrough_camera_info info;
+
+	//! Last time a passthrough layer was submitted.
+	uint64_t last_used_ns;
+
+	//! Warn only once about each unsupported format.
+	uint64_t warned_formats;
+
+	//! Can L8 frames be kept as single channel images, else they are expanded.
+	bool has_r8_srgb;
+
+	struct comp_passthrough_image images[COMP_PASSTHROUGH_RING_SIZE];
+
+	struct comp_passthrough_import imports[COMP_PASSTHROUGH_IMPORT_COUNT];
+
+	//! Number of uploads so far, for finding the least recently used import.
+	uint64_t upload_count;
+
+	//! Image holding the newest uploaded frame, -1 until there is one.
+	int32_t current;
+};
+
+/*!
+ * Initialise the struct, no Vulkan resources are created until the first
+ * frame arrives.
+ *
+ * @public @memberof comp_passthrough
+ */
+void
+comp_passthrough_init(struct comp_passthrough *cp, struct vk_bundle *vk, enum u_logging_level log_level);
+
+/*!
+ * Starts the cameras of @p xdev when a frame has passthrough layers, and
+ * stops them once no frame has had any for a while. Call once per frame.
+ *
+ * @public @memberof comp_passthrough
+ */
+void
+comp_passthrough_set_in_use(struct comp_passthrough *cp, struct xrt_device *xdev, bool in_use, uint64_t now_ns);
+
+/*!
+ * Records the upload of the latest frame, if a new one has arrived, into
+ * @p cmd. Returns the image to sample for passthrough layers this frame, in
+ * @p VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL once @p cmd has executed, or
+ * NULL if no frame has arrived yet.
+ *
+ * @public @memberof comp_passthrough
+ */
+const struct comp_passthrough_image *
+comp_passthrough_update(struct comp_passthrough *cp, VkCommandBuffer cmd);
+
+/*!
+ * Stops the cameras and frees all resources, the GPU must be done with the
+ * images.
+ *
+ * @public @memberof comp_passthrough
+ */
+void
+comp_passthrough_fini(struct comp_passthrough *cp, struct xrt_device *xdev);
+
+
+#ifdef __cplusplus
+}
+#endif
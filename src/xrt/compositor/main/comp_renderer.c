@@ -85,6 +85,16 @@ struct comp_renderer
 
 	struct comp_mirror_to_debug_gui mirror_to_debug_gui;
 
+	//! Used to know how far to extrapolate space warp frames.
+	struct
+	{
+		//! Display time of the last space warp frame from the app.
+		uint64_t last_display_time_ns;
+
+		//! Time between the last two space warp frames, what the motion vectors cover.
+		uint64_t frame_period_ns;
+	} space_warp;
+
 	//! @}
 
 	//! @name Image-dependent members
@@ -956,6 +966,27 @@ dispatch_graphics(struct comp_renderer *r, struct render_gfx *rr)
 		comp_target_mark_submit(ct, c->frame.rendering.id, os_monotonic_get_ns());
 	} break;
 
+	case XRT_LAYER_STEREO_PROJECTION_SPACE_WARP: {
+		const struct xrt_layer_stereo_projection_space_warp_data *stereo = &layer->data.stereo_space_warp;
+		const struct xrt_layer_projection_view_data *lvd = &stereo->l;
+		const struct xrt_layer_projection_view_data *rvd = &stereo->r;
+
+		m_space_relation_ident(&c->base.slot.head_relation);
+
+		c->base.slot.poses[0] = lvd->pose;
+		c->base.slot.poses[1] = rvd->pose;
+		c->base.slot.fovs[0] = lvd->fov;
+		c->base.slot.fovs[1] = rvd->fov;
+
+		// Frame synthesis is only done by the compute path.
+		do_gfx_mesh_and_proj(r, rr, rtr, layer, lvd, rvd);
+
+		renderer_submit_queue(r, rr->r->cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+		// We mark afterwards to not include CPU time spent.
+		comp_target_mark_submit(ct, c->frame.rendering.id, os_monotonic_get_ns());
+	} break;
+
 	default: COMP_ERROR(c, "Unhandled case: '%u'", layer->data.type); assert(false);
 	}
 }
@@ -1131,6 +1162,14 @@ do_layers(struct comp_renderer *r,
 		ubo_data->layer_type[layer_i].val = data->type;
 		ubo_data->layer_type[layer_i].unpremultiplied =
 		    (data->flags & XRT_LAYER_COMPOSITION_UNPREMULTIPLIED_ALPHA_BIT) != 0;
+		ubo_data->layer_type[layer_i].inset = (data->flags & XRT_LAYER_COMPOSITION_INSET_BIT) != 0;
+		ubo_data->layer_type[layer_i].opacity = 1.0f;
+
+		enum render_layer_filter super_sampling = RENDER_LAYER_FILTER_NONE;
+		enum render_layer_filter sharpening = RENDER_LAYER_FILTER_NONE;
+		render_calc_layer_filters(data->flags, &super_sampling, &sharpening);
+		ubo_data->layer_filter[layer_i].super_sampling = super_sampling;
+		ubo_data->layer_filter[layer_i].sharpening = sharpening;
 
 		// Base index into arrays that have a value per view & per layer.
 		uint32_t view_index_for_layer = layer_i * COMP_VIEWS_PER_LAYER;
@@ -1142,7 +1181,9 @@ do_layers(struct comp_renderer *r,
 		switch (data->type) {
 		case XRT_LAYER_STEREO_PROJECTION: required_image_samplers = 2; break;
 		case XRT_LAYER_STEREO_PROJECTION_DEPTH: required_image_samplers = 4; break;
+		case XRT_LAYER_STEREO_PROJECTION_SPACE_WARP: required_image_samplers = 4; break;
 		case XRT_LAYER_QUAD: required_image_samplers = 1; break;
+		case XRT_LAYER_PASSTHROUGH: required_image_samplers = 1; break;
 		default: required_image_samplers = 0;
 		}
 		//! Exit loop if shader cannot receive more image samplers
@@ -1156,6 +1197,7 @@ do_layers(struct comp_renderer *r,
 
 
 		switch (data->type) {
+		case XRT_LAYER_STEREO_PROJECTION_SPACE_WARP:
 		case XRT_LAYER_STEREO_PROJECTION_DEPTH:
 		case XRT_LAYER_STEREO_PROJECTION: {
 			const struct xrt_layer_projection_view_data *lvd = NULL;
@@ -1167,6 +1209,14 @@ do_layers(struct comp_renderer *r,
 				const struct xrt_layer_stereo_projection_data *stereo = &layer->data.stereo;
 				lvd = &stereo->l;
 				rvd = &stereo->r;
+			} else if (data->type == XRT_LAYER_STEREO_PROJECTION_SPACE_WARP) {
+				// Only the depth is used when squashing layers.
+				const struct xrt_layer_stereo_projection_space_warp_data *stereo =
+				    &layer->data.stereo_space_warp;
+				lvd = &stereo->l;
+				rvd = &stereo->r;
+				l_dvd = &stereo->l_sw.depth;
+				r_dvd = &stereo->r_sw.depth;
 			} else {
 				const struct xrt_layer_stereo_projection_depth_data *stereo = &layer->data.stereo_depth;
 				lvd = &stereo->l;
@@ -1191,7 +1241,7 @@ do_layers(struct comp_renderer *r,
 			ubo_data->images_samplers[view_index_for_layer + 1].images[0] = cur_image++;
 
 			// Depth
-			if (data->type == XRT_LAYER_STEREO_PROJECTION_DEPTH) {
+			if (l_dvd != NULL && r_dvd != NULL) {
 				uint32_t d_left_array_index = lvd->sub.array_index;
 				uint32_t d_right_array_index = rvd->sub.array_index;
 				const struct comp_swapchain_image *d_left =
@@ -1237,6 +1287,18 @@ do_layers(struct comp_renderer *r,
 				    &rvd->fov,                                        //
 				    &world_poses[1],                                  //
 				    &ubo_data->transforms[view_index_for_layer + 1]); //
+			} else if ((data->flags & XRT_LAYER_COMPOSITION_INSET_BIT) != 0) {
+				// The shader always needs the matrix to place the inset, no rotation.
+				render_calc_time_warp_matrix(                         //
+				    &lvd->pose,                                       //
+				    &lvd->fov,                                        //
+				    &lvd->pose,                                       //
+				    &ubo_data->transforms[view_index_for_layer + 0]); //
+				render_calc_time_warp_matrix(                         //
+				    &rvd->pose,                                       //
+				    &rvd->fov,                                        //
+				    &rvd->pose,                                       //
+				    &ubo_data->transforms[view_index_for_layer + 1]); //
 			}
 
 		} break;
@@ -1337,6 +1399,49 @@ do_layers(struct comp_renderer *r,
 			}
 
 		} break;
+		case XRT_LAYER_PASSTHROUGH: {
+			// Records the upload of a new camera frame, before the layers are dispatched.
+			const struct comp_passthrough_image *img =
+			    comp_passthrough_update(&r->c->passthrough, crc->r->cmd);
+			if (img == NULL) {
+				// No camera frame yet, nothing to show.
+				ubo_data->layer_type[layer_i].val = UINT32_MAX;
+				break;
+			}
+
+			// Same image for both views, the post transforms pick the camera.
+			src_samplers[cur_image] = clamp_to_border_black;
+			src_image_views[cur_image] = img->view;
+			ubo_data->images_samplers[view_index_for_layer + 0].images[0] = cur_image;
+			ubo_data->images_samplers[view_index_for_layer + 1].images[0] = cur_image;
+			cur_image++;
+
+			struct xrt_normalized_rect *post_transforms = &ubo_data->post_transforms[view_index_for_layer];
+			post_transforms[0] = img->rects[0];
+			post_transforms[1] = img->rects[1];
+
+			ubo_data->layer_type[layer_i].unpremultiplied = 0;
+			ubo_data->layer_type[layer_i].opacity = data->passthrough.opacity;
+
+			// Where the head was when the image was captured, the cameras move with it.
+			struct xrt_space_relation head_at_capture = XRT_SPACE_RELATION_ZERO;
+			xrt_device_get_tracked_pose(r->c->xdev, XRT_INPUT_GENERIC_HEAD_POSE, img->timestamp_ns,
+			                            &head_at_capture);
+
+			const struct xrt_passthrough_camera_info *info = &r->c->passthrough.info;
+			bool sbs = img->rects[0].x != img->rects[1].x;
+
+			for (uint32_t view_i = 0; view_i < 2; view_i++) {
+				uint32_t camera_i = sbs ? view_i : 0;
+
+				render_calc_passthrough_matrix(                            //
+				    &head_at_capture.pose,                                 //
+				    &info->poses[camera_i],                                //
+				    &info->fovs[camera_i],                                 //
+				    &world_poses[view_i],                                  //
+				    &ubo_data->transforms[view_index_for_layer + view_i]); //
+			}
+		} break;
 		default:
 			COMP_ERROR(r->c, "Layer type %d not supported by compute shader, skipping", data->type);
 			ubo_data->layer_type[layer_i].val = UINT32_MAX;
@@ -1345,6 +1450,8 @@ do_layers(struct comp_renderer *r,
 
 	for (uint32_t i = layer_count; i < COMP_MAX_LAYERS; i++) {
 		ubo_data->layer_type[i].val = UINT32_MAX;
+		ubo_data->layer_filter[i].super_sampling = RENDER_LAYER_FILTER_NONE;
+		ubo_data->layer_filter[i].sharpening = RENDER_LAYER_FILTER_NONE;
 	}
 
 	//! @todo: If Vulkan 1.2, use VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT and skip this
@@ -1405,12 +1512,46 @@ do_distortion(struct comp_renderer *r, struct render_compute *crc, const struct
 	);
 }
 
+/*!
+ * Returns how far to extrapolate the motion vectors of a space warp frame
+ * with the given display time, keeps track of the app frame period.
+ */
+static float
+update_space_warp_extrapolation(struct comp_renderer *r, uint64_t src_display_time_ns)
+{
+	uint64_t last_ns = r->space_warp.last_display_time_ns;
+
+	if (src_display_time_ns != last_ns) {
+		// The motion vectors cover the time since the previous app frame.
+		if (last_ns != 0 && src_display_time_ns > last_ns) {
+			r->space_warp.frame_period_ns = src_display_time_ns - last_ns;
+		}
+		r->space_warp.last_display_time_ns = src_display_time_ns;
+	}
+
+	return render_calc_space_warp_extrapolation(          //
+	    src_display_time_ns,                              //
+	    r->space_warp.frame_period_ns,                    //
+	    r->c->frame.rendering.predicted_display_time_ns); //
+}
+
+/*!
+ * Depth data is optional, if @p ldd and @p rdd are non-NULL the depth images
+ * are used for positional reprojection when timewarp is on. Space warp data
+ * is also optional and needs depth, if @p lsw and @p rsw are non-NULL the
+ * motion vectors are used to extrapolate the frame when it is shown late.
+ * The app space delta pose of the space warp data is not used.
+ */
 static void
 do_projection_layers(struct comp_renderer *r,
                      struct render_compute *crc,
                      const struct comp_layer *layer,
                      const struct xrt_layer_projection_view_data *lvd,
-                     const struct xrt_layer_projection_view_data *rvd)
+                     const struct xrt_layer_projection_view_data *rvd,
+                     const struct xrt_layer_depth_data *ldd,
+                     const struct xrt_layer_depth_data *rdd,
+                     const struct xrt_layer_space_warp_data *lsw,
+                     const struct xrt_layer_space_warp_data *rsw)
 {
 	const struct xrt_layer_data *data = &layer->data;
 	uint32_t left_array_index = lvd->sub.array_index;
@@ -1457,6 +1598,72 @@ do_projection_layers(struct comp_renderer *r,
 	    rvd->fov,
 	};
 
+	// Only used if the layer has depth.
+	VkImageView src_depth_image_views_storage[2];
+	struct render_depth_view_data src_depths_storage[2];
+	VkImageView *src_depth_image_views = NULL;
+	struct render_depth_view_data *src_depths = NULL;
+
+	if (ldd != NULL && rdd != NULL) {
+		const struct xrt_layer_depth_data *dds[2] = {ldd, rdd};
+
+		for (uint32_t i = 0; i < 2; i++) {
+			const struct xrt_layer_depth_data *dd = dds[i];
+			const struct comp_swapchain_image *image = &layer->sc_array[2 + i]->images[dd->sub.image_index];
+
+			src_depth_image_views_storage[i] = get_image_view(image, data->flags, dd->sub.array_index);
+
+			struct render_depth_view_data *d = &src_depths_storage[i];
+			d->norm_rect = dd->sub.norm_rect;
+			if (data->flip_y) {
+				d->norm_rect.h = -d->norm_rect.h;
+				d->norm_rect.y = 1 + d->norm_rect.y;
+			}
+			d->min_depth = dd->min_depth;
+			d->max_depth = dd->max_depth;
+			d->near_z = dd->near_z;
+			d->far_z = dd->far_z;
+		}
+
+		src_depth_image_views = src_depth_image_views_storage;
+		src_depths = src_depths_storage;
+	}
+
+	// Only used if the layer has space warp data.
+	VkImageView src_motion_image_views_storage[2];
+	struct render_space_warp_view_data src_space_warps_storage[2];
+	VkImageView *src_motion_image_views = NULL;
+	struct render_space_warp_view_data *src_space_warps = NULL;
+
+	float extrapolation = 0.0f;
+	if (src_depths != NULL && lsw != NULL && rsw != NULL) {
+		extrapolation = update_space_warp_extrapolation(r, data->timestamp);
+	}
+
+	// Nothing to synthesize if the frame is on time or the app asked us not to.
+	if (extrapolation > 0.0f && !lsw->frame_skip && !rsw->frame_skip) {
+		const struct xrt_layer_space_warp_data *sws[2] = {lsw, rsw};
+
+		for (uint32_t i = 0; i < 2; i++) {
+			const struct xrt_sub_image *sub = &sws[i]->motion_vector_sub;
+			const struct comp_swapchain_image *image = &layer->sc_array[4 + i]->images[sub->image_index];
+
+			src_motion_image_views_storage[i] = get_image_view(image, data->flags, sub->array_index);
+
+			struct render_space_warp_view_data *sw = &src_space_warps_storage[i];
+			sw->norm_rect = sub->norm_rect;
+			if (data->flip_y) {
+				sw->norm_rect.h = -sw->norm_rect.h;
+				sw->norm_rect.y = 1 + sw->norm_rect.y;
+			}
+			sw->extrapolation = extrapolation;
+			sw->ndc_y_up = sws[i]->ndc_y_up;
+		}
+
+		src_motion_image_views = src_motion_image_views_storage;
+		src_space_warps = src_space_warps_storage;
+	}
+
 	if (r->c->debug.atw_off) {
 		render_compute_projection( //
 		    crc,                   //
@@ -1470,18 +1677,38 @@ do_projection_layers(struct comp_renderer *r,
 		// HACK: allow dynamic IPD
 		calc_uv_to_tanangle(r->c->xdev, 0, &r->c->nr.distortion.uv_to_tanangle[0]);
 		calc_uv_to_tanangle(r->c->xdev, 1, &r->c->nr.distortion.uv_to_tanangle[1]);
-		
-		render_compute_projection_timewarp( //
-		    crc,                            //
-		    src_samplers,                   //
-		    src_image_views,                //
-		    src_norm_rects,                 //
-		    src_poses,                      //
-		    src_fovs,                       //
-		    new_world_poses,                //
-		    target_image,                   //
-		    target_image_view,              //
-		    views);                         //
+
+		if (src_space_warps != NULL) {
+			render_compute_projection_space_warp( //
+			    crc,                              //
+			    src_samplers,                     //
+			    src_image_views,                  //
+			    src_norm_rects,                   //
+			    src_poses,                        //
+			    src_fovs,                         //
+			    new_world_poses,                  //
+			    src_depth_image_views,            //
+			    src_depths,                       //
+			    src_motion_image_views,           //
+			    src_space_warps,                  //
+			    target_image,                     //
+			    target_image_view,                //
+			    views);                           //
+		} else {
+			render_compute_projection_timewarp( //
+			    crc,                            //
+			    src_samplers,                   //
+			    src_image_views,                //
+			    src_norm_rects,                 //
+			    src_poses,                      //
+			    src_fovs,                       //
+			    new_world_poses,                //
+			    src_depth_image_views,          //
+			    src_depths,                     //
+			    target_image,                   //
+			    target_image_view,              //
+			    views);                         //
+		}
 	}
 }
 
@@ -1514,15 +1741,27 @@ dispatch_compute(struct comp_renderer *r, struct render_compute *crc)
 		const struct xrt_layer_projection_view_data *lvd = &stereo->l;
 		const struct xrt_layer_projection_view_data *rvd = &stereo->r;
 
-		do_projection_layers(r, crc, layer, lvd, rvd);
+		do_projection_layers(r, crc, layer, lvd, rvd, NULL, NULL, NULL, NULL);
 	} else if (fast_path && c->base.slot.layers[0].data.type == XRT_LAYER_STEREO_PROJECTION_DEPTH) {
 		int i = 0;
 		const struct comp_layer *layer = &c->base.slot.layers[i];
 		const struct xrt_layer_stereo_projection_depth_data *stereo = &layer->data.stereo_depth;
 		const struct xrt_layer_projection_view_data *lvd = &stereo->l;
 		const struct xrt_layer_projection_view_data *rvd = &stereo->r;
+		const struct xrt_layer_depth_data *ldd = &stereo->l_d;
+		const struct xrt_layer_depth_data *rdd = &stereo->r_d;
 
-		do_projection_layers(r, crc, layer, lvd, rvd);
+		do_projection_layers(r, crc, layer, lvd, rvd, ldd, rdd, NULL, NULL);
+	} else if (fast_path && c->base.slot.layers[0].data.type == XRT_LAYER_STEREO_PROJECTION_SPACE_WARP) {
+		int i = 0;
+		const struct comp_layer *layer = &c->base.slot.layers[i];
+		const struct xrt_layer_stereo_projection_space_warp_data *stereo = &layer->data.stereo_space_warp;
+		const struct xrt_layer_projection_view_data *lvd = &stereo->l;
+		const struct xrt_layer_projection_view_data *rvd = &stereo->r;
+		const struct xrt_layer_space_warp_data *lsw = &stereo->l_sw;
+		const struct xrt_layer_space_warp_data *rsw = &stereo->r_sw;
+
+		do_projection_layers(r, crc, layer, lvd, rvd, &lsw->depth, &rsw->depth, lsw, rsw);
 	} else if (layer_count > 0) {
 		do_layers(r, crc, c->base.slot.layers, layer_count);
 
@@ -1685,6 +1924,10 @@ comp_renderer_set_projection_layer(struct comp_renderer *r,
 	l->flags = data->flags;
 	l->view_space = (data->flags & XRT_LAYER_COMPOSITION_VIEW_SPACE_BIT) != 0;
 
+	// Projection layers are drawn over the whole view here, so insets can't be placed, skip them.
+	bool inset = (data->flags & XRT_LAYER_COMPOSITION_INSET_BIT) != 0;
+	l->visibility = inset ? XRT_LAYER_EYE_VISIBILITY_NONE : XRT_LAYER_EYE_VISIBILITY_BOTH;
+
 	l->transformation[0].offset = data->stereo.l.sub.rect.offset;
 	l->transformation[0].extent = data->stereo.l.sub.rect.extent;
 	l->transformation[1].offset = data->stereo.r.sub.rect.offset;
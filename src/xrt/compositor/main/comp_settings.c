@@ -31,15 +31,8 @@ DEBUG_GET_ONCE_BOOL_OPTION(compute, "XRT_COMPOSITOR_COMPUTE", false)
 // clang-format on
 
 void
-comp_settings_init(struct comp_settings *s, struct xrt_device *xdev)
+comp_settings_init_without_device(struct comp_settings *s)
 {
-	int default_framerate = debug_get_num_option_default_framerate();
-
-	uint64_t interval_ns = xdev->hmd->screens[0].nominal_frame_interval_ns;
-	if (interval_ns == 0) {
-		interval_ns = (1000 * 1000 * 1000) / default_framerate;
-	}
-
 	s->use_compute = debug_get_bool_option_compute();
 
 	if (s->use_compute) {
@@ -72,9 +65,6 @@ comp_settings_init(struct comp_settings *s, struct xrt_device *xdev)
 	s->color_space = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
 	s->present_mode = VK_PRESENT_MODE_FIFO_KHR;
 	s->fullscreen = debug_get_bool_option_xcb_fullscreen();
-	s->preferred.width = xdev->hmd->screens[0].w_pixels;
-	s->preferred.height = xdev->hmd->screens[0].h_pixels;
-	s->nominal_frame_interval_ns = interval_ns;
 	s->log_level = debug_get_log_option_log();
 	s->print_modes = debug_get_bool_option_print_modes();
 	s->selected_gpu_index = debug_get_num_option_force_gpu_index();
@@ -103,14 +93,32 @@ comp_settings_init(struct comp_settings *s, struct xrt_device *xdev)
 
 	if (debug_get_bool_option_force_xcb()) {
 		s->target_identifier = "x11";
+	}
+	if (debug_get_bool_option_force_wayland()) {
+		s->target_identifier = "wayland";
+	}
+}
 
+void
+comp_settings_init_from_device(struct comp_settings *s, struct xrt_device *xdev)
+{
+	int default_framerate = debug_get_num_option_default_framerate();
+
+	uint64_t interval_ns = xdev->hmd->screens[0].nominal_frame_interval_ns;
+	if (interval_ns == 0) {
+		interval_ns = (1000 * 1000 * 1000) / default_framerate;
+	}
+
+	s->preferred.width = xdev->hmd->screens[0].w_pixels;
+	s->preferred.height = xdev->hmd->screens[0].h_pixels;
+	s->nominal_frame_interval_ns = interval_ns;
+
+	if (debug_get_bool_option_force_xcb()) {
 		// HMD screen tends to be much larger then monitors.
 		s->preferred.width /= 2;
 		s->preferred.height /= 2;
 	}
 	if (debug_get_bool_option_force_wayland()) {
-		s->target_identifier = "wayland";
-
 		// HMD screen tends to be much larger then monitors.
 		s->preferred.width /= 2;
 		s->preferred.height /= 2;
@@ -109,12 +109,23 @@ struct comp_settings
 };
 
 /*!
- * Initialize the settings struct with either defaults or loaded setting.
+ * Initialize the settings struct with either defaults or loaded setting, only
+ * the ones that do not depend on the head device. Enough to select a target
+ * and bring up Vulkan before the devices have been created.
  *
  * @ingroup comp_main
  */
 void
-comp_settings_init(struct comp_settings *s, struct xrt_device *xdev);
+comp_settings_init_without_device(struct comp_settings *s);
+
+/*!
+ * Initialize the remaining settings from the head device, must be called
+ * after @ref comp_settings_init_without_device.
+ *
+ * @ingroup comp_main
+ */
+void
+comp_settings_init_from_device(struct comp_settings *s, struct xrt_device *xdev);
 
 
 #ifdef __cplusplus
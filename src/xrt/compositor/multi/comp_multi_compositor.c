@@ -141,6 +141,54 @@ drain_events(struct multi_compositor *mc)
 	} while (xce.type != XRT_COMPOSITOR_EVENT_NONE);
 }
 
+/*!
+ * Push a rendering timing sample, need to have the list_and_timing_lock held.
+ */
+static void
+push_perf_sample_locked(struct multi_compositor *mc,
+                        struct u_perf_notify *upn,
+                        enum xrt_perf_domain domain,
+                        uint64_t used_ns)
+{
+	uint64_t budget_ns = mc->msc->last_timings.predicted_display_period_ns;
+	enum xrt_perf_notify_level from_level;
+	enum xrt_perf_notify_level to_level;
+
+	if (!u_perf_notify_push(upn, used_ns, budget_ns, &from_level, &to_level)) {
+		return;
+	}
+
+	union xrt_compositor_event xce = XRT_STRUCT_INIT;
+	xce.type = XRT_COMPOSITOR_EVENT_PERFORMANCE_CHANGE;
+	xce.performance.domain = domain;
+	xce.performance.sub_domain = XRT_PERF_SUB_DOMAIN_RENDERING;
+	xce.performance.from_level = from_level;
+	xce.performance.to_level = to_level;
+
+	multi_compositor_push_event(mc, &xce);
+}
+
+/*!
+ * Push a GPU timing sample to the recommended layer resolution tracker, need
+ * to have the list_and_timing_lock held.
+ */
+static void
+push_resolution_sample_locked(struct multi_compositor *mc, uint64_t used_ns)
+{
+	uint64_t budget_ns = mc->msc->last_timings.predicted_display_period_ns;
+	float scale;
+
+	if (!u_layer_resolution_push(&mc->perf.resolution, used_ns, budget_ns, &scale)) {
+		return;
+	}
+
+	union xrt_compositor_event xce = XRT_STRUCT_INIT;
+	xce.type = XRT_COMPOSITOR_EVENT_RESOLUTION_SCALE_CHANGE;
+	xce.resolution_scale.scale = scale;
+
+	multi_compositor_push_event(mc, &xce);
+}
+
 
 /*
  *
@@ -306,12 +354,14 @@ run_func(void *ptr)
 		}
 
 		int64_t frame_id = mc->wait_thread.frame_id;
+		uint64_t begin_ns = mc->wait_thread.begin_ns;
 		struct xrt_compositor_fence *xcf = mc->wait_thread.xcf;
 		struct xrt_compositor_semaphore *xcsem = mc->wait_thread.xcsem; // No need to ref, a move.
 		uint64_t value = mc->wait_thread.value;
 
 		// Ok to clear these on spurious wakeup as they are empty then anyways.
 		mc->wait_thread.frame_id = 0;
+		mc->wait_thread.begin_ns = 0;
 		mc->wait_thread.xcf = NULL;
 		mc->wait_thread.xcsem = NULL;
 		mc->wait_thread.value = 0;
@@ -338,6 +388,10 @@ run_func(void *ptr)
 
 		os_mutex_lock(&mc->msc->list_and_timing_lock);
 		u_pa_mark_gpu_done(mc->upa, frame_id, now_ns);
+		if (begin_ns != 0 && now_ns > begin_ns) {
+			push_perf_sample_locked(mc, &mc->perf.gpu, XRT_PERF_DOMAIN_GPU, now_ns - begin_ns);
+			push_resolution_sample_locked(mc, now_ns - begin_ns);
+		}
 		os_mutex_unlock(&mc->msc->list_and_timing_lock);
 
 		// Wait for the delivery slot.
@@ -404,6 +458,7 @@ push_fence_to_wait_thread(struct multi_compositor *mc, int64_t frame_id, struct
 	assert(mc->wait_thread.xcf == NULL);
 
 	mc->wait_thread.frame_id = frame_id;
+	mc->wait_thread.begin_ns = mc->perf.begin_ns;
 	mc->wait_thread.xcf = xcf;
 
 	os_thread_helper_signal_locked(&mc->wait_thread.oth);
@@ -426,6 +481,7 @@ push_semaphore_to_wait_thread(struct multi_compositor *mc,
 	assert(mc->wait_thread.xcsem == NULL);
 
 	mc->wait_thread.frame_id = frame_id;
+	mc->wait_thread.begin_ns = mc->perf.begin_ns;
 	xrt_compositor_semaphore_reference(&mc->wait_thread.xcsem, xcsem);
 	mc->wait_thread.value = value;
 
@@ -434,6 +490,25 @@ push_semaphore_to_wait_thread(struct multi_compositor *mc,
 	os_thread_helper_unlock(&mc->wait_thread.oth);
 }
 
+/*!
+ * The app should run at half rate while submitting space warp layers, the main
+ * compositor synthesizes the frames in between. Only called from the client
+ * thread.
+ */
+static void
+update_space_warp_rate_divisor(struct multi_compositor *mc)
+{
+	uint32_t divisor = mc->space_warp.in_progress ? 2 : 1;
+	if (divisor == mc->space_warp.rate_divisor) {
+		return;
+	}
+
+	os_mutex_lock(&mc->msc->list_and_timing_lock);
+	mc->space_warp.rate_divisor = divisor;
+	multi_compositor_update_rate_divisor_locked(mc);
+	os_mutex_unlock(&mc->msc->list_and_timing_lock);
+}
+
 
 /*
  *
@@ -636,6 +711,8 @@ multi_compositor_begin_frame(struct xrt_compositor *xc, int64_t frame_id)
 	u_pa_mark_point(mc->upa, frame_id, U_TIMING_POINT_BEGIN, now_ns);
 	os_mutex_unlock(&mc->msc->list_and_timing_lock);
 
+	mc->perf.begin_ns = now_ns;
+
 	return XRT_SUCCESS;
 }
 
@@ -663,6 +740,9 @@ multi_compositor_layer_begin(struct xrt_compositor *xc, const struct xrt_layer_f
 	uint64_t now_ns = os_monotonic_get_ns();
 	os_mutex_lock(&mc->msc->list_and_timing_lock);
 	u_pa_mark_delivered(mc->upa, data->frame_id, now_ns, data->display_time_ns);
+	if (mc->perf.begin_ns != 0 && now_ns > mc->perf.begin_ns) {
+		push_perf_sample_locked(mc, &mc->perf.cpu, XRT_PERF_DOMAIN_CPU, now_ns - mc->perf.begin_ns);
+	}
 	os_mutex_unlock(&mc->msc->list_and_timing_lock);
 
 	/*
@@ -682,6 +762,7 @@ multi_compositor_layer_begin(struct xrt_compositor *xc, const struct xrt_layer_f
 
 	mc->progress.active = true;
 	mc->progress.data = *data;
+	mc->space_warp.in_progress = false;
 
 	return XRT_SUCCESS;
 }
@@ -696,6 +777,10 @@ multi_compositor_layer_stereo_projection(struct xrt_compositor *xc,
 	struct multi_compositor *mc = multi_compositor(xc);
 	(void)mc;
 
+	if (mc->progress.layer_count >= MULTI_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	size_t index = mc->progress.layer_count++;
 	mc->progress.layers[index].xdev = xdev;
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], l_xsc);
@@ -716,14 +801,50 @@ multi_compositor_layer_stereo_projection_depth(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
+	if (mc->progress.layer_count >= MULTI_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
+	size_t index = mc->progress.layer_count++;
+	mc->progress.layers[index].xdev = xdev;
+	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], l_xsc);
+	xrt_swapchain_reference(&mc->progress.layers[index].xscs[1], r_xsc);
+	xrt_swapchain_reference(&mc->progress.layers[index].xscs[2], l_d_xsc);
+	xrt_swapchain_reference(&mc->progress.layers[index].xscs[3], r_d_xsc);
+	mc->progress.layers[index].data = *data;
+
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+multi_compositor_layer_stereo_projection_space_warp(struct xrt_compositor *xc,
+                                                    struct xrt_device *xdev,
+                                                    struct xrt_swapchain *l_xsc,
+                                                    struct xrt_swapchain *r_xsc,
+                                                    struct xrt_swapchain *l_d_xsc,
+                                                    struct xrt_swapchain *r_d_xsc,
+                                                    struct xrt_swapchain *l_mv_xsc,
+                                                    struct xrt_swapchain *r_mv_xsc,
+                                                    const struct xrt_layer_data *data)
+{
+	struct multi_compositor *mc = multi_compositor(xc);
+
+	if (mc->progress.layer_count >= MULTI_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	size_t index = mc->progress.layer_count++;
 	mc->progress.layers[index].xdev = xdev;
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], l_xsc);
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[1], r_xsc);
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[2], l_d_xsc);
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[3], r_d_xsc);
+	xrt_swapchain_reference(&mc->progress.layers[index].xscs[4], l_mv_xsc);
+	xrt_swapchain_reference(&mc->progress.layers[index].xscs[5], r_mv_xsc);
 	mc->progress.layers[index].data = *data;
 
+	mc->space_warp.in_progress = true;
+
 	return XRT_SUCCESS;
 }
 
@@ -735,6 +856,10 @@ multi_compositor_layer_quad(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
+	if (mc->progress.layer_count >= MULTI_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	size_t index = mc->progress.layer_count++;
 	mc->progress.layers[index].xdev = xdev;
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
@@ -751,6 +876,10 @@ multi_compositor_layer_cube(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
+	if (mc->progress.layer_count >= MULTI_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	size_t index = mc->progress.layer_count++;
 	mc->progress.layers[index].xdev = xdev;
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
@@ -767,6 +896,10 @@ multi_compositor_layer_cylinder(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
+	if (mc->progress.layer_count >= MULTI_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	size_t index = mc->progress.layer_count++;
 	mc->progress.layers[index].xdev = xdev;
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
@@ -783,6 +916,10 @@ multi_compositor_layer_equirect1(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
+	if (mc->progress.layer_count >= MULTI_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	size_t index = mc->progress.layer_count++;
 	mc->progress.layers[index].xdev = xdev;
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
@@ -799,6 +936,10 @@ multi_compositor_layer_equirect2(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
+	if (mc->progress.layer_count >= MULTI_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	size_t index = mc->progress.layer_count++;
 	mc->progress.layers[index].xdev = xdev;
 	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
@@ -807,6 +948,24 @@ multi_compositor_layer_equirect2(struct xrt_compositor *xc,
 	return XRT_SUCCESS;
 }
 
+static xrt_result_t
+multi_compositor_layer_passthrough(struct xrt_compositor *xc,
+                                  struct xrt_device *xdev,
+                                  const struct xrt_layer_data *data)
+{
+	struct multi_compositor *mc = multi_compositor(xc);
+
+	if (mc->progress.layer_count >= MULTI_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
+	size_t index = mc->progress.layer_count++;
+	mc->progress.layers[index].xdev = xdev;
+	mc->progress.layers[index].data = *data;
+
+	return XRT_SUCCESS;
+}
+
 static xrt_result_t
 multi_compositor_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handle_t sync_handle)
 {
@@ -816,6 +975,8 @@ multi_compositor_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handl
 	struct xrt_compositor_fence *xcf = NULL;
 	int64_t frame_id = mc->progress.data.frame_id;
 
+	update_space_warp_rate_divisor(mc);
+
 	do {
 		if (!xrt_graphics_sync_handle_is_valid(sync_handle)) {
 			break;
@@ -845,6 +1006,10 @@ multi_compositor_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handl
 
 		os_mutex_lock(&mc->msc->list_and_timing_lock);
 		u_pa_mark_gpu_done(mc->upa, frame_id, now_ns);
+		if (mc->perf.begin_ns != 0 && now_ns > mc->perf.begin_ns) {
+			push_perf_sample_locked(mc, &mc->perf.gpu, XRT_PERF_DOMAIN_GPU, now_ns - mc->perf.begin_ns);
+			push_resolution_sample_locked(mc, now_ns - mc->perf.begin_ns);
+		}
 		os_mutex_unlock(&mc->msc->list_and_timing_lock);
 
 		wait_for_scheduled_free(mc);
@@ -863,11 +1028,39 @@ multi_compositor_layer_commit_with_semaphore(struct xrt_compositor *xc,
 	struct multi_compositor *mc = multi_compositor(xc);
 	int64_t frame_id = mc->progress.data.frame_id;
 
+	update_space_warp_rate_divisor(mc);
+
 	push_semaphore_to_wait_thread(mc, frame_id, xcsem, value);
 
 	return XRT_SUCCESS;
 }
 
+static xrt_result_t
+multi_compositor_set_performance_level(struct xrt_compositor *xc,
+                                       enum xrt_perf_domain domain,
+                                       enum xrt_perf_set_level level)
+{
+	COMP_TRACE_MARKER();
+
+	struct multi_compositor *mc = multi_compositor(xc);
+
+	os_mutex_lock(&mc->msc->list_and_timing_lock);
+
+	switch (domain) {
+	case XRT_PERF_DOMAIN_CPU: mc->perf.cpu_level = level; break;
+	case XRT_PERF_DOMAIN_GPU: mc->perf.gpu_level = level; break;
+	default: break;
+	}
+
+	multi_compositor_update_rate_divisor_locked(mc);
+
+	os_mutex_unlock(&mc->msc->list_and_timing_lock);
+
+	U_LOG_D("Session performance level hint for domain %u set to %u.", domain, level);
+
+	return XRT_SUCCESS;
+}
+
 static xrt_result_t
 multi_compositor_poll_events(struct xrt_compositor *xc, union xrt_compositor_event *out_xce)
 {
@@ -974,6 +1167,44 @@ multi_compositor_retire_delivered_locked(struct multi_compositor *mc, uint64_t w
 	slot_clear_locked(mc, &mc->delivered);
 }
 
+void
+multi_compositor_update_rate_divisor_locked(struct multi_compositor *mc)
+{
+	struct multi_system_compositor *msc = mc->msc;
+	uint32_t divisor = mc->space_warp.rate_divisor;
+
+	/*
+	 * A session that can't be seen, or isn't the one being interacted
+	 * with, doesn't get to compete for the GPU with the one that is.
+	 */
+	uint32_t state_divisor = 1;
+	if (!mc->state.visible) {
+		state_divisor = msc->rate.invisible_divisor;
+	} else if (!mc->state.focused) {
+		state_divisor = msc->rate.unfocused_divisor;
+	}
+
+	if (state_divisor > divisor) {
+		divisor = state_divisor;
+	}
+
+	// The app is fine with lower performance, so it gets woken up less often.
+	bool power_savings = mc->perf.cpu_level == XRT_PERF_SET_LEVEL_POWER_SAVINGS ||
+	                     mc->perf.gpu_level == XRT_PERF_SET_LEVEL_POWER_SAVINGS;
+	if (power_savings && msc->rate.power_savings_divisor > divisor) {
+		divisor = msc->rate.power_savings_divisor;
+	}
+
+	if (divisor == mc->rate_divisor) {
+		return;
+	}
+
+	u_pa_set_rate_divisor(mc->upa, divisor);
+	mc->rate_divisor = divisor;
+
+	U_LOG_D("App rate divisor set to %u.", divisor);
+}
+
 xrt_result_t
 multi_compositor_create(struct multi_system_compositor *msc,
                         const struct xrt_session_info *xsi,
@@ -998,13 +1229,16 @@ multi_compositor_create(struct multi_system_compositor *msc,
 	mc->base.base.layer_begin = multi_compositor_layer_begin;
 	mc->base.base.layer_stereo_projection = multi_compositor_layer_stereo_projection;
 	mc->base.base.layer_stereo_projection_depth = multi_compositor_layer_stereo_projection_depth;
+	mc->base.base.layer_stereo_projection_space_warp = multi_compositor_layer_stereo_projection_space_warp;
 	mc->base.base.layer_quad = multi_compositor_layer_quad;
 	mc->base.base.layer_cube = multi_compositor_layer_cube;
 	mc->base.base.layer_cylinder = multi_compositor_layer_cylinder;
 	mc->base.base.layer_equirect1 = multi_compositor_layer_equirect1;
 	mc->base.base.layer_equirect2 = multi_compositor_layer_equirect2;
+	mc->base.base.layer_passthrough = multi_compositor_layer_passthrough;
 	mc->base.base.layer_commit = multi_compositor_layer_commit;
 	mc->base.base.layer_commit_with_semaphore = multi_compositor_layer_commit_with_semaphore;
+	mc->base.base.set_performance_level = multi_compositor_set_performance_level;
 	mc->base.base.destroy = multi_compositor_destroy;
 	mc->base.base.poll_events = multi_compositor_poll_events;
 	mc->msc = msc;
@@ -1023,6 +1257,17 @@ multi_compositor_create(struct multi_system_compositor *msc,
 	// Used in scheduled waiting function.
 	os_precise_sleeper_init(&mc->scheduled_sleeper);
 
+	// Performance notifications, the spec says sustained high is the default.
+	u_perf_notify_init(&mc->perf.cpu);
+	u_perf_notify_init(&mc->perf.gpu);
+	u_layer_resolution_init(&mc->perf.resolution);
+	mc->perf.cpu_level = XRT_PERF_SET_LEVEL_SUSTAINED_HIGH;
+	mc->perf.gpu_level = XRT_PERF_SET_LEVEL_SUSTAINED_HIGH;
+
+	// Apps run at the display rate until they submit space warp layers or are hidden.
+	mc->space_warp.rate_divisor = 1;
+	mc->rate_divisor = 1;
+
 	// This is safe to do without a lock since we are not on the list yet.
 	u_paf_create(msc->upaf, &mc->upa);
 
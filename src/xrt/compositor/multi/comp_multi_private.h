@@ -17,6 +17,8 @@
 #include "os/os_threading.h"
 
 #include "util/u_pacing.h"
+#include "util/u_layer_resolution.h"
+#include "util/u_perf_notify.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,7 +54,7 @@ struct multi_layer_entry
 	 *
 	 * How many are actually used depends on the value of @p data.type
 	 */
-	struct xrt_swapchain *xscs[4];
+	struct xrt_swapchain *xscs[6];
 
 	/*!
 	 * All basic (trivially-serializable) data associated with a layer,
@@ -137,6 +139,9 @@ struct multi_compositor
 		//! Frame id of frame being waited on.
 		int64_t frame_id;
 
+		//! When the frame being waited on was begun, for performance notifications.
+		uint64_t begin_ns;
+
 		//! The wait thread itself
 		struct os_thread_helper oth;
 
@@ -179,6 +184,37 @@ struct multi_compositor
 	struct multi_layer_slot delivered;
 
 	struct u_pacing_app *upa;
+
+	struct
+	{
+		//! Application CPU time, begin to delivered, protected by list_and_timing_lock.
+		struct u_perf_notify cpu;
+
+		//! Application GPU time, begin to GPU done, protected by list_and_timing_lock.
+		struct u_perf_notify gpu;
+
+		//! Recommended layer resolution from GPU time, protected by list_and_timing_lock.
+		struct u_layer_resolution resolution;
+
+		//! When the current frame was begun, only touched by the client thread.
+		uint64_t begin_ns;
+
+		//! Performance level hints given by the application, protected by list_and_timing_lock.
+		enum xrt_perf_set_level cpu_level;
+		enum xrt_perf_set_level gpu_level;
+	} perf;
+
+	struct
+	{
+		//! The frame in progress has a space warp layer, only touched by the client thread.
+		bool in_progress;
+
+		//! Rate divisor space warp asks for, written by the client thread with list_and_timing_lock held.
+		uint32_t rate_divisor;
+	} space_warp;
+
+	//! Rate divisor last given to the app pacer, protected by list_and_timing_lock.
+	uint32_t rate_divisor;
 };
 
 static inline struct multi_compositor *
@@ -236,6 +272,17 @@ multi_compositor_latch_frame_locked(struct multi_compositor *mc, uint64_t when_n
 void
 multi_compositor_retire_delivered_locked(struct multi_compositor *mc, uint64_t when_ns);
 
+/*!
+ * Gives the app pacer the rate divisor for the current state, performance
+ * level and space warp use of the client, called when any of them changes.
+ * The list_and_timing_lock is held when this function is called.
+ *
+ * @ingroup comp_multi
+ * @private @memberof multi_compositor
+ */
+void
+multi_compositor_update_rate_divisor_locked(struct multi_compositor *mc);
+
 
 /*
  *
@@ -342,6 +389,31 @@ struct multi_system_compositor
 		uint64_t diff_ns;
 	} last_timings;
 
+	/*!
+	 * Clients that can't be seen, or aren't the one being interacted
+	 * with, run at this fraction of the display rate.
+	 */
+	struct
+	{
+		//! Rate divisor for sessions that are not visible.
+		uint32_t invisible_divisor;
+
+		//! Rate divisor for sessions that are visible but not focused.
+		uint32_t unfocused_divisor;
+
+		//! Rate divisor for sessions that asked for the power savings performance level.
+		uint32_t power_savings_divisor;
+	} rate;
+
+	struct
+	{
+		//! Compositor CPU time, only touched by the render thread.
+		struct u_perf_notify cpu;
+
+		//! Compositor GPU time as predicted by the pacer, only touched by the render thread.
+		struct u_perf_notify gpu;
+	} perf;
+
 	struct multi_compositor *clients[MULTI_MAX_CLIENTS];
 };
 
@@ -41,6 +41,31 @@
 #endif
 
 
+DEBUG_GET_ONCE_NUM_OPTION(invisible_rate_divisor, "XRT_COMPOSITOR_INVISIBLE_RATE_DIVISOR", 4)
+DEBUG_GET_ONCE_NUM_OPTION(unfocused_rate_divisor, "XRT_COMPOSITOR_UNFOCUSED_RATE_DIVISOR", 1)
+DEBUG_GET_ONCE_NUM_OPTION(power_savings_rate_divisor, "XRT_COMPOSITOR_POWER_SAVINGS_RATE_DIVISOR", 2)
+
+
+/*
+ *
+ * Helper functions.
+ *
+ */
+
+static uint32_t
+get_rate_divisor_option(int64_t value)
+{
+	// Keep it to something sensible, a divisor of zero would stop the app.
+	if (value < 1) {
+		return 1;
+	}
+	if (value > 16) {
+		return 16;
+	}
+	return (uint32_t)value;
+}
+
+
 /*
  *
  * Render thread.
@@ -98,6 +123,37 @@ do_projection_layer_depth(struct xrt_compositor *xc,
 	xrt_comp_layer_stereo_projection_depth(xc, xdev, l_xcs, r_xcs, l_d_xcs, r_d_xcs, data);
 }
 
+static void
+do_projection_layer_space_warp(struct xrt_compositor *xc,
+                               struct multi_compositor *mc,
+                               struct multi_layer_entry *layer,
+                               uint32_t i)
+{
+	struct xrt_device *xdev = layer->xdev;
+	struct xrt_swapchain *l_xcs = layer->xscs[0];
+	struct xrt_swapchain *r_xcs = layer->xscs[1];
+	struct xrt_swapchain *l_d_xcs = layer->xscs[2];
+	struct xrt_swapchain *r_d_xcs = layer->xscs[3];
+	struct xrt_swapchain *l_mv_xcs = layer->xscs[4];
+	struct xrt_swapchain *r_mv_xcs = layer->xscs[5];
+
+	if (l_xcs == NULL || r_xcs == NULL || l_d_xcs == NULL || r_d_xcs == NULL || l_mv_xcs == NULL ||
+	    r_mv_xcs == NULL) {
+		U_LOG_E("Invalid swap chain for projection layer #%u!", i);
+		return;
+	}
+
+	if (xdev == NULL) {
+		U_LOG_E("Invalid xdev for projection layer #%u!", i);
+		return;
+	}
+
+	// Cast away
+	struct xrt_layer_data *data = (struct xrt_layer_data *)&layer->data;
+
+	xrt_comp_layer_stereo_projection_space_warp(xc, xdev, l_xcs, r_xcs, l_d_xcs, r_d_xcs, l_mv_xcs, r_mv_xcs, data);
+}
+
 static bool
 do_single(struct xrt_compositor *xc,
           struct multi_compositor *mc,
@@ -201,6 +257,22 @@ do_equirect2_layer(struct xrt_compositor *xc, struct multi_compositor *mc, struc
 	xrt_comp_layer_equirect2(xc, xdev, xcs, data);
 }
 
+static void
+do_passthrough_layer(struct xrt_compositor *xc, struct multi_compositor *mc, struct multi_layer_entry *layer, uint32_t i)
+{
+	struct xrt_device *xdev = layer->xdev;
+
+	if (xdev == NULL) {
+		U_LOG_E("Invalid xdev for passthrough layer #%u!", i);
+		return;
+	}
+
+	// Cast away
+	struct xrt_layer_data *data = (struct xrt_layer_data *)&layer->data;
+
+	xrt_comp_layer_passthrough(xc, xdev, data);
+}
+
 static int
 overlay_sort_func(const void *a, const void *b)
 {
@@ -288,6 +360,10 @@ transfer_layers_locked(struct multi_system_compositor *msc, uint64_t display_tim
 			case XRT_LAYER_CYLINDER: do_cylinder_layer(xc, mc, layer, i); break;
 			case XRT_LAYER_EQUIRECT1: do_equirect1_layer(xc, mc, layer, i); break;
 			case XRT_LAYER_EQUIRECT2: do_equirect2_layer(xc, mc, layer, i); break;
+			case XRT_LAYER_STEREO_PROJECTION_SPACE_WARP:
+				do_projection_layer_space_warp(xc, mc, layer, i);
+				break;
+			case XRT_LAYER_PASSTHROUGH: do_passthrough_layer(xc, mc, layer, i); break;
 			default: U_LOG_E("Unhandled layer type '%i'!", layer->data.type); break;
 			}
 		}
@@ -349,6 +425,42 @@ broadcast_timings_to_pacers(struct multi_system_compositor *msc,
 	os_mutex_unlock(&msc->list_and_timing_lock);
 }
 
+static void
+push_perf_sample(struct multi_system_compositor *msc,
+                 struct u_perf_notify *upn,
+                 enum xrt_perf_domain domain,
+                 uint64_t used_ns,
+                 uint64_t budget_ns)
+{
+	enum xrt_perf_notify_level from_level;
+	enum xrt_perf_notify_level to_level;
+
+	if (!u_perf_notify_push(upn, used_ns, budget_ns, &from_level, &to_level)) {
+		return;
+	}
+
+	union xrt_compositor_event xce = XRT_STRUCT_INIT;
+	xce.type = XRT_COMPOSITOR_EVENT_PERFORMANCE_CHANGE;
+	xce.performance.domain = domain;
+	xce.performance.sub_domain = XRT_PERF_SUB_DOMAIN_COMPOSITING;
+	xce.performance.from_level = from_level;
+	xce.performance.to_level = to_level;
+
+	// Compositing is shared between all clients, so tell all of them.
+	os_mutex_lock(&msc->list_and_timing_lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(msc->clients); i++) {
+		struct multi_compositor *mc = msc->clients[i];
+		if (mc == NULL) {
+			continue;
+		}
+
+		multi_compositor_push_event(mc, &xce);
+	}
+
+	os_mutex_unlock(&msc->list_and_timing_lock);
+}
+
 static void
 wait_frame(struct os_precise_sleeper *sleeper, struct xrt_compositor *xc, int64_t frame_id, uint64_t wake_up_time_ns)
 {
@@ -511,6 +623,17 @@ multi_main_loop(struct multi_system_compositor *msc)
 
 		xrt_comp_layer_commit(xc, XRT_GRAPHICS_SYNC_HANDLE_INVALID);
 
+		// CPU time is from waking up to having committed the frame.
+		uint64_t committed_ns = os_monotonic_get_ns();
+		push_perf_sample(msc, &msc->perf.cpu, XRT_PERF_DOMAIN_CPU, committed_ns - now_ns,
+		                 predicted_display_period_ns);
+
+		// The pacer grows its GPU time estimate when the compositor GPU work is slow.
+		if (predicted_gpu_time_ns > wake_up_time_ns) {
+			push_perf_sample(msc, &msc->perf.gpu, XRT_PERF_DOMAIN_GPU,
+			                 predicted_gpu_time_ns - wake_up_time_ns, predicted_display_period_ns);
+		}
+
 		// Re-lock the thread for check in while statement.
 		os_thread_helper_lock(&msc->oth);
 	}
@@ -551,13 +674,17 @@ system_compositor_set_state(struct xrt_system_compositor *xsc, struct xrt_compos
 {
 	struct multi_system_compositor *msc = multi_system_compositor(xsc);
 	struct multi_compositor *mc = multi_compositor(xc);
-	(void)msc;
 
-	//! @todo Locking?
-	if (mc->state.visible != visible || mc->state.focused != focused) {
-		mc->state.visible = visible;
-		mc->state.focused = focused;
+	bool changed = mc->state.visible != visible || mc->state.focused != focused;
 
+	// Always applied, the first call might be for the state a client starts in.
+	os_mutex_lock(&msc->list_and_timing_lock);
+	mc->state.visible = visible;
+	mc->state.focused = focused;
+	multi_compositor_update_rate_divisor_locked(mc);
+	os_mutex_unlock(&msc->list_and_timing_lock);
+
+	if (changed) {
 		union xrt_compositor_event xce = XRT_STRUCT_INIT;
 		xce.type = XRT_COMPOSITOR_EVENT_STATE_CHANGE;
 		xce.state.visible = visible;
@@ -711,6 +838,9 @@ comp_multi_create_system_compositor(struct xrt_compositor_native *xcn,
 	msc->upaf = upaf;
 	msc->xcn = xcn;
 	msc->sessions.active_count = 0;
+	msc->rate.invisible_divisor = get_rate_divisor_option(debug_get_num_option_invisible_rate_divisor());
+	msc->rate.unfocused_divisor = get_rate_divisor_option(debug_get_num_option_unfocused_rate_divisor());
+	msc->rate.power_savings_divisor = get_rate_divisor_option(debug_get_num_option_power_savings_rate_divisor());
 	msc->sessions.state = do_warm_start ? MULTI_SYSTEM_STATE_INIT_WARM_START : MULTI_SYSTEM_STATE_STOPPED;
 
 	os_mutex_init(&msc->list_and_timing_lock);
@@ -721,6 +851,9 @@ comp_multi_create_system_compositor(struct xrt_compositor_native *xcn,
 	msc->last_timings.predicted_display_period_ns = U_TIME_1MS_IN_NS * 16; // Just a wild guess.
 	msc->last_timings.diff_ns = U_TIME_1MS_IN_NS * 5;                      // Make sure it's not zero at least.
 
+	u_perf_notify_init(&msc->perf.cpu);
+	u_perf_notify_init(&msc->perf.gpu);
+
 	int ret = os_thread_helper_init(&msc->oth);
 	if (ret < 0) {
 		return XRT_ERROR_THREADING_INIT_FAILURE;
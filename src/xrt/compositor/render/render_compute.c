@@ -57,6 +57,26 @@ vk_from_crc(struct render_compute *crc)
 	return crc->r->vk;
 }
 
+/*!
+ * Does any active layer want super-sampling or sharpening, if not the cheaper
+ * pipelines without the filter code are used.
+ */
+static bool
+layers_use_filters(const struct render_compute_layer_ubo_data *ubo_data)
+{
+	for (uint32_t i = 0; i < COMP_MAX_LAYERS; i++) {
+		if (ubo_data->layer_type[i].val == UINT32_MAX) {
+			continue;
+		}
+		if (ubo_data->layer_filter[i].super_sampling != RENDER_LAYER_FILTER_NONE ||
+		    ubo_data->layer_filter[i].sharpening != RENDER_LAYER_FILTER_NONE) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /*
  * For dispatching compute to the view, calculate the number of groups.
  */
@@ -268,6 +288,70 @@ update_compute_distortion_descriptor_set(struct vk_bundle *vk,
 	    NULL);                             // pDescriptorCopies
 }
 
+/*!
+ * Updates one of the optional per view image bindings of the distortion
+ * shader, used for the depth and motion vector images.
+ */
+static void
+update_compute_distortion_view_images_descriptor_set(struct vk_bundle *vk,
+                                                     uint32_t binding,
+                                                     VkSampler samplers[2],
+                                                     VkImageView image_views[2],
+                                                     VkDescriptorSet descriptor_set)
+{
+	VkDescriptorImageInfo image_info[2] = {
+	    {
+	        .sampler = samplers[0],
+	        .imageView = image_views[0],
+	        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	    },
+	    {
+	        .sampler = samplers[1],
+	        .imageView = image_views[1],
+	        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+	    },
+	};
+
+	VkWriteDescriptorSet write_descriptor_sets[1] = {
+	    {
+	        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+	        .dstSet = descriptor_set,
+	        .dstBinding = binding,
+	        .descriptorCount = ARRAY_SIZE(image_info),
+	        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+	        .pImageInfo = image_info,
+	    },
+	};
+
+	vk->vkUpdateDescriptorSets(            //
+	    vk->device,                        //
+	    ARRAY_SIZE(write_descriptor_sets), // descriptorWriteCount
+	    write_descriptor_sets,             // pDescriptorWrites
+	    0,                                 // descriptorCopyCount
+	    NULL);                             // pDescriptorCopies
+}
+
+/*!
+ * The distortion shader statically uses all of its bindings, even the ones
+ * that its specialization constants turn off, so they always need to be valid.
+ */
+static void
+update_compute_distortion_mock_view_images(struct vk_bundle *vk,
+                                           struct render_resources *r,
+                                           uint32_t binding,
+                                           VkDescriptorSet descriptor_set)
+{
+	VkSampler samplers[2] = {r->samplers.mock, r->samplers.mock};
+	VkImageView image_views[2] = {r->mock.color.image_view, r->mock.color.image_view};
+
+	update_compute_distortion_view_images_descriptor_set( //
+	    vk,                                               //
+	    binding,                                          //
+	    samplers,                                         //
+	    image_views,                                      //
+	    descriptor_set);                                  //
+}
+
 XRT_MAYBE_UNUSED static void
 update_compute_discriptor_set_target(struct vk_bundle *vk,
                                      uint32_t target_binding,
@@ -461,10 +545,19 @@ render_compute_layers(struct render_compute *crc,
 	    VK_WHOLE_SIZE,                   //
 	    crc->descriptor_set);            //
 
+	VkPipeline pipeline = VK_NULL_HANDLE;
+	if (layers_use_filters(ubo_data)) {
+		pipeline = timewarp ? r->compute.layer.timewarp_filter_pipeline //
+		                    : r->compute.layer.non_timewarp_filter_pipeline;
+	} else {
+		pipeline = timewarp ? r->compute.layer.timewarp_pipeline //
+		                    : r->compute.layer.non_timewarp_pipeline;
+	}
+
 	vk->vkCmdBindPipeline(              //
 	    crc->r->cmd,                    // commandBuffer
 	    VK_PIPELINE_BIND_POINT_COMPUTE, // pipelineBindPoint
-	    timewarp ? r->compute.layer.timewarp_pipeline : r->compute.layer.non_timewarp_pipeline); // pipeline
+	    pipeline);                      // pipeline
 
 	vk->vkCmdBindDescriptorSets(          //
 	    r->cmd,                           // commandBuffer
@@ -512,23 +605,34 @@ render_compute_layers(struct render_compute *crc,
 	    &memoryBarrier);                      //
 }
 
-void
-render_compute_projection_timewarp(struct render_compute *crc,
-                                   VkSampler src_samplers[2],
-                                   VkImageView src_image_views[2],
-                                   const struct xrt_normalized_rect src_norm_rects[2],
-                                   const struct xrt_pose src_poses[2],
-                                   const struct xrt_fov src_fovs[2],
-                                   const struct xrt_pose new_poses[2],
-                                   VkImage target_image,
-                                   VkImageView target_image_view,
-                                   const struct render_viewport_data views[2])
+/*!
+ * Shared by the timewarp and space warp functions, depth and motion vectors
+ * are optional, motion vectors are only used if there is depth.
+ */
+static void
+do_projection_timewarp(struct render_compute *crc,
+                       VkSampler src_samplers[2],
+                       VkImageView src_image_views[2],
+                       const struct xrt_normalized_rect src_norm_rects[2],
+                       const struct xrt_pose src_poses[2],
+                       const struct xrt_fov src_fovs[2],
+                       const struct xrt_pose new_poses[2],
+                       VkImageView src_depth_image_views[2],
+                       const struct render_depth_view_data src_depths[2],
+                       VkImageView src_motion_image_views[2],
+                       const struct render_space_warp_view_data src_space_warps[2],
+                       VkImage target_image,
+                       VkImageView target_image_view,
+                       const struct render_viewport_data views[2])
 {
 	assert(crc->r != NULL);
 
 	struct vk_bundle *vk = vk_from_crc(crc);
 	struct render_resources *r = crc->r;
 
+	bool do_depth = src_depth_image_views != NULL && src_depths != NULL;
+	bool do_space_warp = do_depth && src_motion_image_views != NULL && src_space_warps != NULL;
+
 
 	/*
 	 * UBO
@@ -557,6 +661,27 @@ render_compute_projection_timewarp(struct render_compute *crc,
 	data->post_transforms[0] = src_norm_rects[0];
 	data->post_transforms[1] = src_norm_rects[1];
 
+	for (uint32_t i = 0; do_depth && i < 2; i++) {
+		const struct render_depth_view_data *d = &src_depths[i];
+
+		render_calc_depth_reprojection_matrix(&src_poses[i], &new_poses[i], &data->depth_transforms[i]);
+		render_calc_tanangle_to_uv(&src_fovs[i], &data->src_tanangle_to_uv[i]);
+
+		data->depth_post_transforms[i] = d->norm_rect;
+		data->depth_ranges[i].inv_near_z = 1.0f / d->near_z; // Infinite planes gives zero.
+		data->depth_ranges[i].inv_far_z = 1.0f / d->far_z;
+		data->depth_ranges[i].min_depth = d->min_depth;
+		data->depth_ranges[i].max_depth = d->max_depth;
+	}
+
+	for (uint32_t i = 0; do_space_warp && i < 2; i++) {
+		const struct render_space_warp_view_data *sw = &src_space_warps[i];
+
+		data->motion_post_transforms[i] = sw->norm_rect;
+		data->space_warps[i].extrapolation = sw->extrapolation;
+		data->space_warps[i].y_sign = sw->ndc_y_up ? -1.0f : 1.0f;
+	}
+
 
 	/*
 	 * Source, target and distortion images.
@@ -600,10 +725,52 @@ render_compute_projection_timewarp(struct render_compute *crc,
 	    VK_WHOLE_SIZE,                        //
 	    crc->distortion_descriptor_set);      //
 
-	vk->vkCmdBindPipeline(                        //
-	    r->cmd,                                   // commandBuffer
-	    VK_PIPELINE_BIND_POINT_COMPUTE,           // pipelineBindPoint
-	    r->compute.distortion.timewarp_pipeline); // pipeline
+	VkPipeline pipeline = r->compute.distortion.timewarp_pipeline;
+
+	if (do_depth) {
+		// Edge to keep depth stable at edges.
+		VkSampler depth_samplers[2] = {sampler, sampler};
+
+		update_compute_distortion_view_images_descriptor_set( //
+		    vk,                                               //
+		    r->compute.depth_binding,                         //
+		    depth_samplers,                                   //
+		    src_depth_image_views,                            //
+		    crc->distortion_descriptor_set);                  //
+
+		pipeline = r->compute.distortion.timewarp_depth_pipeline;
+	} else {
+		update_compute_distortion_mock_view_images( //
+		    vk,                                     //
+		    r,                                      //
+		    r->compute.depth_binding,               //
+		    crc->distortion_descriptor_set);        //
+	}
+
+	if (do_space_warp) {
+		// Edge so that content moving in from outside the view gets the edge motion.
+		VkSampler motion_samplers[2] = {sampler, sampler};
+
+		update_compute_distortion_view_images_descriptor_set( //
+		    vk,                                               //
+		    r->compute.motion_vector_binding,                 //
+		    motion_samplers,                                  //
+		    src_motion_image_views,                           //
+		    crc->distortion_descriptor_set);                  //
+
+		pipeline = r->compute.distortion.timewarp_space_warp_pipeline;
+	} else {
+		update_compute_distortion_mock_view_images( //
+		    vk,                                     //
+		    r,                                      //
+		    r->compute.motion_vector_binding,       //
+		    crc->distortion_descriptor_set);        //
+	}
+
+	vk->vkCmdBindPipeline(              //
+	    r->cmd,                         // commandBuffer
+	    VK_PIPELINE_BIND_POINT_COMPUTE, // pipelineBindPoint
+	    pipeline);                      // pipeline
 
 	vk->vkCmdBindDescriptorSets(               //
 	    r->cmd,                                // commandBuffer
@@ -651,6 +818,73 @@ render_compute_projection_timewarp(struct render_compute *crc,
 	    &memoryBarrier);                      //
 }
 
+void
+render_compute_projection_timewarp(struct render_compute *crc,
+                                   VkSampler src_samplers[2],
+                                   VkImageView src_image_views[2],
+                                   const struct xrt_normalized_rect src_norm_rects[2],
+                                   const struct xrt_pose src_poses[2],
+                                   const struct xrt_fov src_fovs[2],
+                                   const struct xrt_pose new_poses[2],
+                                   VkImageView src_depth_image_views[2],
+                                   const struct render_depth_view_data src_depths[2],
+                                   VkImage target_image,
+                                   VkImageView target_image_view,
+                                   const struct render_viewport_data views[2])
+{
+	do_projection_timewarp(    //
+	    crc,                   //
+	    src_samplers,          //
+	    src_image_views,       //
+	    src_norm_rects,        //
+	    src_poses,             //
+	    src_fovs,              //
+	    new_poses,             //
+	    src_depth_image_views, //
+	    src_depths,            //
+	    NULL,                  //
+	    NULL,                  //
+	    target_image,          //
+	    target_image_view,     //
+	    views);                //
+}
+
+void
+render_compute_projection_space_warp(struct render_compute *crc,
+                                     VkSampler src_samplers[2],
+                                     VkImageView src_image_views[2],
+                                     const struct xrt_normalized_rect src_norm_rects[2],
+                                     const struct xrt_pose src_poses[2],
+                                     const struct xrt_fov src_fovs[2],
+                                     const struct xrt_pose new_poses[2],
+                                     VkImageView src_depth_image_views[2],
+                                     const struct render_depth_view_data src_depths[2],
+                                     VkImageView src_motion_image_views[2],
+                                     const struct render_space_warp_view_data src_space_warps[2],
+                                     VkImage target_image,
+                                     VkImageView target_image_view,
+                                     const struct render_viewport_data views[2])
+{
+	assert(src_depth_image_views != NULL && src_depths != NULL);
+	assert(src_motion_image_views != NULL && src_space_warps != NULL);
+
+	do_projection_timewarp(     //
+	    crc,                    //
+	    src_samplers,           //
+	    src_image_views,        //
+	    src_norm_rects,         //
+	    src_poses,              //
+	    src_fovs,               //
+	    new_poses,              //
+	    src_depth_image_views,  //
+	    src_depths,             //
+	    src_motion_image_views, //
+	    src_space_warps,        //
+	    target_image,           //
+	    target_image_view,      //
+	    views);                 //
+}
+
 void
 render_compute_projection(struct render_compute *crc,
                           VkSampler src_samplers[2],
@@ -720,6 +954,10 @@ render_compute_projection(struct render_compute *crc,
 	    VK_WHOLE_SIZE,                        //
 	    crc->distortion_descriptor_set);      //
 
+	VkDescriptorSet descriptor_set = crc->distortion_descriptor_set;
+	update_compute_distortion_mock_view_images(vk, r, r->compute.depth_binding, descriptor_set);
+	update_compute_distortion_mock_view_images(vk, r, r->compute.motion_vector_binding, descriptor_set);
+
 	vk->vkCmdBindPipeline(               //
 	    r->cmd,                          // commandBuffer
 	    VK_PIPELINE_BIND_POINT_COMPUTE,  // pipelineBindPoint
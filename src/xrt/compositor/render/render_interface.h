@@ -16,6 +16,7 @@
 
 #include "xrt/xrt_compiler.h"
 #include "xrt/xrt_defines.h"
+#include "xrt/xrt_compositor.h"
 
 #include "vk/vk_helpers.h"
 #include "vk/vk_cmd_pool.h"
@@ -67,6 +68,67 @@ render_calc_time_warp_matrix(const struct xrt_pose *src_pose,
                              const struct xrt_pose *new_pose,
                              struct xrt_matrix_4x4 *matrix);
 
+/*!
+ * Calculates a matrix that takes points in the new view space and gives them
+ * in the source view space, includes translation unlike the timewarp matrix.
+ */
+void
+render_calc_depth_reprojection_matrix(const struct xrt_pose *src_pose,
+                                      const struct xrt_pose *new_pose,
+                                      struct xrt_matrix_4x4 *matrix);
+
+/*!
+ * Calculates a transform that takes tangent angles (OpenXR coordinate system)
+ * and gives out uv coordinates in [0, 1] space of a view with the given fov.
+ */
+void
+render_calc_tanangle_to_uv(const struct xrt_fov *fov, struct xrt_normalized_rect *out_rect);
+
+/*!
+ * Calculates how far along the motion vectors of a space warp frame displayed
+ * at @p src_display_time_ns to extrapolate when showing it at
+ * @p new_display_time_ns, in units of @p src_frame_period_ns which is the time
+ * the motion vectors cover. Clamped to [0, 1], zero if the period is unknown.
+ */
+float
+render_calc_space_warp_extrapolation(uint64_t src_display_time_ns,
+                                     uint64_t src_frame_period_ns,
+                                     uint64_t new_display_time_ns);
+
+/*!
+ * Calculates a timewarp matrix, like @ref render_calc_time_warp_matrix, that
+ * takes a view at @p new_pose into a passthrough camera image. The camera is
+ * at @p camera_in_head relative to @p head_at_capture, the head pose when the
+ * image was captured. Only rotation is corrected, the camera image is treated
+ * as being infinitely far away.
+ */
+void
+render_calc_passthrough_matrix(const struct xrt_pose *head_at_capture,
+                               const struct xrt_pose *camera_in_head,
+                               const struct xrt_fov *camera_fov,
+                               const struct xrt_pose *new_pose,
+                               struct xrt_matrix_4x4 *matrix);
+
+/*!
+ * Filters the compute layer shader can apply to a layer, the values are the
+ * FILTER_ defines in layer.comp.
+ */
+enum render_layer_filter
+{
+	RENDER_LAYER_FILTER_NONE = 0,
+	RENDER_LAYER_FILTER_NORMAL = 1,
+	RENDER_LAYER_FILTER_QUALITY = 2,
+};
+
+/*!
+ * Picks the super-sampling and sharpening filters of a layer from its
+ * composition flags, a quality bit wins over the normal one.
+ */
+void
+render_calc_layer_filters(enum xrt_layer_composition_flags flags,
+                          enum render_layer_filter *out_super_sampling,
+                          enum render_layer_filter *out_sharpening);
+
 
 /*
  *
@@ -329,6 +391,12 @@ struct render_resources
 		//! Uniform data binding.
 		uint32_t ubo_binding;
 
+		//! Depth images used for positional reprojection.
+		uint32_t depth_binding;
+
+		//! Motion vector images used for space warp frame synthesis.
+		uint32_t motion_vector_binding;
+
 		struct
 		{
 			//! Descriptor set layout for compute.
@@ -343,6 +411,12 @@ struct render_resources
 			//! Doesn't depend on target so is static.
 			VkPipeline timewarp_pipeline;
 
+			//! Variant of the non timewarp pipeline that applies the layer filters.
+			VkPipeline non_timewarp_filter_pipeline;
+
+			//! Variant of the timewarp pipeline that applies the layer filters.
+			VkPipeline timewarp_filter_pipeline;
+
 			//! Size of combined image sampler array
 			uint32_t image_array_size;
 
@@ -364,6 +438,12 @@ struct render_resources
 			//! Doesn't depend on target so is static.
 			VkPipeline timewarp_pipeline;
 
+			//! Timewarp with depth based positional reprojection, static.
+			VkPipeline timewarp_depth_pipeline;
+
+			//! Timewarp with depth reprojection and motion vector frame synthesis, static.
+			VkPipeline timewarp_space_warp_pipeline;
+
 			//! Target info.
 			struct render_buffer ubo;
 		} distortion;
@@ -762,14 +842,23 @@ struct render_compute_layer_ubo_data
 	struct xrt_normalized_rect pre_transforms[2];
 	struct xrt_normalized_rect post_transforms[COMP_MAX_LAYERS * COMP_VIEWS_PER_LAYER];
 
-	//! std140 uvec2, corresponds to enum xrt_layer_type and unpremultiplied alpha.
+	//! std140 uvec4, corresponds to enum xrt_layer_type, unpremultiplied alpha, inset and passthrough opacity.
 	struct
 	{
 		uint32_t val;
 		uint32_t unpremultiplied;
-		uint32_t padding[2];
+		uint32_t inset;
+		float opacity;
 	} layer_type[COMP_MAX_LAYERS];
 
+	//! std140 uvec4, @ref render_layer_filter for super-sampling and sharpening, only read by the filter pipelines.
+	struct
+	{
+		uint32_t super_sampling;
+		uint32_t sharpening;
+		uint32_t padding[2];
+	} layer_filter[COMP_MAX_LAYERS];
+
 	//! Which image/sampler(s) correspond to each layer.
 	struct
 	{
@@ -823,6 +912,80 @@ struct render_compute_distortion_ubo_data
 	struct xrt_normalized_rect pre_transforms[2];
 	struct xrt_normalized_rect post_transforms[2];
 	struct xrt_matrix_4x4 transforms[2];
+
+
+	/*!
+	 * For depth based positional reprojection.
+	 */
+
+	//! New view space to source view space matrices.
+	struct xrt_matrix_4x4 depth_transforms[2];
+
+	//! Source tangent angles to source uv.
+	struct xrt_normalized_rect src_tanangle_to_uv[2];
+
+	//! Sub image of the depth images.
+	struct xrt_normalized_rect depth_post_transforms[2];
+
+	//! std140 vec4, used to turn depth values into inverse view space depth.
+	struct
+	{
+		float inv_near_z;
+		float inv_far_z;
+		float min_depth;
+		float max_depth;
+	} depth_ranges[2];
+
+
+	/*!
+	 * For space warp frame synthesis.
+	 */
+
+	//! Sub image of the motion vector images.
+	struct xrt_normalized_rect motion_post_transforms[2];
+
+	//! std140 vec4, how far to extrapolate and the direction of y in the motion vectors.
+	struct
+	{
+		float extrapolation;
+		float y_sign;
+		float _pad0;
+		float _pad1;
+	} space_warps[2];
+};
+
+/*!
+ * Depth information for one view of a projection layer, used for positional
+ * reprojection in @ref render_compute_projection_timewarp.
+ */
+struct render_depth_view_data
+{
+	//! Sub image of the depth image, same convention as the colour rects.
+	struct xrt_normalized_rect norm_rect;
+
+	//! Range of depth values written by the app, see XrCompositionLayerDepthInfoKHR.
+	float min_depth;
+	float max_depth;
+
+	//! Distance to the planes that map to min and max depth, may be reversed.
+	float near_z;
+	float far_z;
+};
+
+/*!
+ * Motion vector information for one view of a projection layer, used for
+ * frame synthesis in @ref render_compute_projection_space_warp.
+ */
+struct render_space_warp_view_data
+{
+	//! Sub image of the motion vector image, same convention as the colour rects.
+	struct xrt_normalized_rect norm_rect;
+
+	//! How many source frame periods to move along the motion vectors.
+	float extrapolation;
+
+	//! The y axis of the motion vectors points up, as in OpenGL and D3D NDC.
+	bool ndc_y_up;
 };
 
 /*!
@@ -873,6 +1036,10 @@ render_compute_layers(struct render_compute *crc,                   //
                       bool timewarp);                               //
 
 /*!
+ * Does timewarp of a single projection layer, if @p src_depth_image_views and
+ * @p src_depths are not NULL positional reprojection is also done using the
+ * depth images, otherwise only rotation is corrected.
+ *
  * @public @memberof render_compute
  */
 void
@@ -883,10 +1050,36 @@ render_compute_projection_timewarp(struct render_compute *crc,
                                    const struct xrt_pose src_poses[2],
                                    const struct xrt_fov src_fovs[2],
                                    const struct xrt_pose new_poses[2],
+                                   VkImageView src_depth_image_views[2],
+                                   const struct render_depth_view_data src_depths[2],
                                    VkImage target_image,
                                    VkImageView target_image_view,
                                    const struct render_viewport_data views[2]);
 
+/*!
+ * Synthesizes a new frame from a single projection layer, does timewarp and
+ * positional reprojection with the depth images like
+ * @ref render_compute_projection_timewarp and also moves dynamic content
+ * along the motion vectors from the app, used for XR_FB_space_warp.
+ *
+ * @public @memberof render_compute
+ */
+void
+render_compute_projection_space_warp(struct render_compute *crc,
+                                     VkSampler src_samplers[2],
+                                     VkImageView src_image_views[2],
+                                     const struct xrt_normalized_rect src_rects[2],
+                                     const struct xrt_pose src_poses[2],
+                                     const struct xrt_fov src_fovs[2],
+                                     const struct xrt_pose new_poses[2],
+                                     VkImageView src_depth_image_views[2],
+                                     const struct render_depth_view_data src_depths[2],
+                                     VkImageView src_motion_image_views[2],
+                                     const struct render_space_warp_view_data src_space_warps[2],
+                                     VkImage target_image,
+                                     VkImageView target_image_view,
+                                     const struct render_viewport_data views[2]);
+
 /*!
  * @public @memberof render_compute
  */
@@ -266,11 +266,13 @@ create_compute_distortion_descriptor_set_layout(struct vk_bundle *vk,
                                                 uint32_t distortion_binding,
                                                 uint32_t target_binding,
                                                 uint32_t ubo_binding,
+                                                uint32_t depth_binding,
+                                                uint32_t motion_vector_binding,
                                                 VkDescriptorSetLayout *out_descriptor_set_layout)
 {
 	VkResult ret;
 
-	VkDescriptorSetLayoutBinding set_layout_bindings[4] = {
+	VkDescriptorSetLayoutBinding set_layout_bindings[6] = {
 	    {
 	        .binding = src_binding,
 	        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -295,6 +297,18 @@ create_compute_distortion_descriptor_set_layout(struct vk_bundle *vk,
 	        .descriptorCount = 1,
 	        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
 	    },
+	    {
+	        .binding = depth_binding,
+	        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+	        .descriptorCount = 2,
+	        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+	    },
+	    {
+	        .binding = motion_vector_binding,
+	        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+	        .descriptorCount = 2,
+	        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+	    },
 	};
 
 	VkDescriptorSetLayoutCreateInfo set_layout_info = {
@@ -326,12 +340,15 @@ struct compute_layer_params
 	uint32_t max_layers;
 	uint32_t views_per_layer;
 	uint32_t image_array_size;
+	VkBool32 do_layer_filters;
 };
 
 struct compute_distortion_params
 {
 	uint32_t distortion_texel_count;
 	VkBool32 do_timewarp;
+	VkBool32 do_depth_reprojection;
+	VkBool32 do_space_warp;
 };
 
 static VkResult
@@ -355,6 +372,7 @@ create_compute_layer_pipeline(struct vk_bundle *vk,
 	    ENTRY(3, max_layers),          //
 	    ENTRY(4, views_per_layer),     //
 	    ENTRY(5, image_array_size),    //
+	    ENTRY(6, do_layer_filters),    //
 	};
 #undef ENTRY
 
@@ -394,9 +412,11 @@ create_compute_distortion_pipeline(struct vk_bundle *vk,
 	    sizeof(params->FIELD),                                                                                     \
 	}
 
-	VkSpecializationMapEntry entries[2] = {
+	VkSpecializationMapEntry entries[4] = {
 	    ENTRY(0, distortion_texel_count),
 	    ENTRY(1, do_timewarp),
+	    ENTRY(2, do_depth_reprojection),
+	    ENTRY(3, do_space_warp),
 	};
 #undef ENTRY
 
@@ -578,6 +598,8 @@ render_resources_init(struct render_resources *r,
 	r->compute.distortion_binding = 1;
 	r->compute.target_binding = 2;
 	r->compute.ubo_binding = 3;
+	r->compute.depth_binding = 4;
+	r->compute.motion_vector_binding = 5;
 
 	r->compute.layer.image_array_size = vk->features.max_per_stage_descriptor_sampled_images;
 	if (r->compute.layer.image_array_size > COMP_MAX_IMAGES) {
@@ -749,8 +771,8 @@ render_resources_init(struct render_resources *r,
 
 	struct vk_descriptor_pool_info compute_pool_info = {
 	    .uniform_per_descriptor_count = 1,
-	    // layer images
-	    .sampler_per_descriptor_count = r->compute.layer.image_array_size + 6,
+	    // layer images, distortion images, depth images and motion vector images
+	    .sampler_per_descriptor_count = r->compute.layer.image_array_size + 6 + 2 + 2,
 	    .storage_image_per_descriptor_count = 1,
 	    .storage_buffer_per_descriptor_count = 0,
 	    .descriptor_count = 2,
@@ -786,6 +808,7 @@ render_resources_init(struct render_resources *r,
 	    .max_layers = COMP_MAX_LAYERS,
 	    .views_per_layer = COMP_VIEWS_PER_LAYER,
 	    .image_array_size = r->compute.layer.image_array_size,
+	    .do_layer_filters = false,
 	};
 
 	C(create_compute_layer_pipeline(               //
@@ -802,6 +825,7 @@ render_resources_init(struct render_resources *r,
 	    .max_layers = COMP_MAX_LAYERS,
 	    .views_per_layer = COMP_VIEWS_PER_LAYER,
 	    .image_array_size = r->compute.layer.image_array_size,
+	    .do_layer_filters = false,
 	};
 
 	C(create_compute_layer_pipeline(           //
@@ -812,6 +836,33 @@ render_resources_init(struct render_resources *r,
 	    &layer_timewarp_params,                // params
 	    &r->compute.layer.timewarp_pipeline)); // out_compute_pipeline
 
+	/*
+	 * The filtered variants take a lot more samples per pixel, so they are
+	 * kept separate and only used when a layer asks for super-sampling or
+	 * sharpening.
+	 */
+	struct compute_layer_params layer_filter_params = layer_params;
+	layer_filter_params.do_layer_filters = true;
+
+	C(create_compute_layer_pipeline(                      //
+	    vk,                                               // vk_bundle
+	    r->pipeline_cache,                                // pipeline_cache
+	    r->shaders->layer_comp,                           // shader
+	    r->compute.layer.pipeline_layout,                 // pipeline_layout
+	    &layer_filter_params,                             // params
+	    &r->compute.layer.non_timewarp_filter_pipeline)); // out_compute_pipeline
+
+	struct compute_layer_params layer_timewarp_filter_params = layer_timewarp_params;
+	layer_timewarp_filter_params.do_layer_filters = true;
+
+	C(create_compute_layer_pipeline(                  //
+	    vk,                                           // vk_bundle
+	    r->pipeline_cache,                            // pipeline_cache
+	    r->shaders->layer_comp,                       // shader
+	    r->compute.layer.pipeline_layout,             // pipeline_layout
+	    &layer_timewarp_filter_params,                // params
+	    &r->compute.layer.timewarp_filter_pipeline)); // out_compute_pipeline
+
 	size_t layer_ubo_size = sizeof(struct render_compute_layer_ubo_data);
 
 	C(render_buffer_init(        //
@@ -835,6 +886,8 @@ render_resources_init(struct render_resources *r,
 	    r->compute.distortion_binding,                  // distortion_binding,
 	    r->compute.target_binding,                      // target_binding,
 	    r->compute.ubo_binding,                         // ubo_binding,
+	    r->compute.depth_binding,                       // depth_binding,
+	    r->compute.motion_vector_binding,               // motion_vector_binding,
 	    &r->compute.distortion.descriptor_set_layout)); // out_descriptor_set_layout
 
 	C(vk_create_pipeline_layout(                     //
@@ -845,6 +898,8 @@ render_resources_init(struct render_resources *r,
 	struct compute_distortion_params distortion_params = {
 	    .distortion_texel_count = COMP_DISTORTION_IMAGE_DIMENSIONS,
 	    .do_timewarp = false,
+	    .do_depth_reprojection = false,
+	    .do_space_warp = false,
 	};
 
 	C(create_compute_distortion_pipeline(      //
@@ -858,6 +913,8 @@ render_resources_init(struct render_resources *r,
 	struct compute_distortion_params distortion_timewarp_params = {
 	    .distortion_texel_count = COMP_DISTORTION_IMAGE_DIMENSIONS,
 	    .do_timewarp = true,
+	    .do_depth_reprojection = false,
+	    .do_space_warp = false,
 	};
 
 	C(create_compute_distortion_pipeline(           //
@@ -868,6 +925,36 @@ render_resources_init(struct render_resources *r,
 	    &distortion_timewarp_params,                // params
 	    &r->compute.distortion.timewarp_pipeline)); // out_compute_pipeline
 
+	struct compute_distortion_params distortion_timewarp_depth_params = {
+	    .distortion_texel_count = COMP_DISTORTION_IMAGE_DIMENSIONS,
+	    .do_timewarp = true,
+	    .do_depth_reprojection = true,
+	    .do_space_warp = false,
+	};
+
+	C(create_compute_distortion_pipeline(                 //
+	    vk,                                               // vk_bundle
+	    r->pipeline_cache,                                // pipeline_cache
+	    r->shaders->distortion_comp,                      // shader
+	    r->compute.distortion.pipeline_layout,            // pipeline_layout
+	    &distortion_timewarp_depth_params,                // params
+	    &r->compute.distortion.timewarp_depth_pipeline)); // out_compute_pipeline
+
+	struct compute_distortion_params distortion_timewarp_space_warp_params = {
+	    .distortion_texel_count = COMP_DISTORTION_IMAGE_DIMENSIONS,
+	    .do_timewarp = true,
+	    .do_depth_reprojection = true,
+	    .do_space_warp = true,
+	};
+
+	C(create_compute_distortion_pipeline(                      //
+	    vk,                                                    // vk_bundle
+	    r->pipeline_cache,                                     // pipeline_cache
+	    r->shaders->distortion_comp,                           // shader
+	    r->compute.distortion.pipeline_layout,                 // pipeline_layout
+	    &distortion_timewarp_space_warp_params,                // params
+	    &r->compute.distortion.timewarp_space_warp_pipeline)); // out_compute_pipeline
+
 	size_t distortion_ubo_size = sizeof(struct render_compute_distortion_ubo_data);
 
 	C(render_buffer_init(             //
@@ -1013,11 +1100,15 @@ render_resources_close(struct render_resources *r)
 	D(DescriptorSetLayout, r->compute.layer.descriptor_set_layout);
 	D(Pipeline, r->compute.layer.non_timewarp_pipeline);
 	D(Pipeline, r->compute.layer.timewarp_pipeline);
+	D(Pipeline, r->compute.layer.non_timewarp_filter_pipeline);
+	D(Pipeline, r->compute.layer.timewarp_filter_pipeline);
 	D(PipelineLayout, r->compute.layer.pipeline_layout);
 
 	D(DescriptorSetLayout, r->compute.distortion.descriptor_set_layout);
 	D(Pipeline, r->compute.distortion.pipeline);
 	D(Pipeline, r->compute.distortion.timewarp_pipeline);
+	D(Pipeline, r->compute.distortion.timewarp_depth_pipeline);
+	D(Pipeline, r->compute.distortion.timewarp_space_warp_pipeline);
 	D(PipelineLayout, r->compute.distortion.pipeline_layout);
 
 	D(Pipeline, r->compute.clear.pipeline);
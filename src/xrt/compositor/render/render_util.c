@@ -109,3 +109,90 @@ render_calc_time_warp_matrix(const struct xrt_pose *src_pose,
 		matrix->v[i] = (float)result.v[i];
 	}
 }
+
+void
+render_calc_depth_reprojection_matrix(const struct xrt_pose *src_pose,
+                                      const struct xrt_pose *new_pose,
+                                      struct xrt_matrix_4x4 *matrix)
+{
+	// World to src view.
+	struct xrt_pose src_pose_inv;
+	math_pose_invert(src_pose, &src_pose_inv);
+
+	// New view to world to src view.
+	struct xrt_pose delta;
+	math_pose_transform(&src_pose_inv, new_pose, &delta);
+
+	math_matrix_4x4_isometry_from_pose(&delta, matrix);
+}
+
+void
+render_calc_tanangle_to_uv(const struct xrt_fov *fov, struct xrt_normalized_rect *out_rect)
+{
+	const double tan_left = tan(fov->angle_left);
+	const double tan_right = tan(fov->angle_right);
+
+	const double tan_down = tan(fov->angle_down);
+	const double tan_up = tan(fov->angle_up);
+
+	const double tan_width = tan_right - tan_left;
+	const double tan_height = tan_up - tan_down;
+
+	// uv x goes left to right, uv y goes top to bottom.
+	out_rect->x = (float)(-tan_left / tan_width);
+	out_rect->y = (float)(tan_up / tan_height);
+	out_rect->w = (float)(1.0 / tan_width);
+	out_rect->h = (float)(-1.0 / tan_height);
+}
+
+float
+render_calc_space_warp_extrapolation(uint64_t src_display_time_ns,
+                                     uint64_t src_frame_period_ns,
+                                     uint64_t new_display_time_ns)
+{
+	if (src_frame_period_ns == 0 || new_display_time_ns <= src_display_time_ns) {
+		return 0.0f;
+	}
+
+	double factor = (double)(new_display_time_ns - src_display_time_ns) / (double)src_frame_period_ns;
+
+	// Only extrapolate up to one frame, further out the motion vectors are too unreliable.
+	return (float)(factor > 1.0 ? 1.0 : factor);
+}
+
+void
+render_calc_passthrough_matrix(const struct xrt_pose *head_at_capture,
+                               const struct xrt_pose *camera_in_head,
+                               const struct xrt_fov *camera_fov,
+                               const struct xrt_pose *new_pose,
+                               struct xrt_matrix_4x4 *matrix)
+{
+	// Where the camera was looking when the image was captured.
+	struct xrt_pose camera_at_capture;
+	math_pose_transform(head_at_capture, camera_in_head, &camera_at_capture);
+
+	render_calc_time_warp_matrix(&camera_at_capture, camera_fov, new_pose, matrix);
+}
+
+void
+render_calc_layer_filters(enum xrt_layer_composition_flags flags,
+                          enum render_layer_filter *out_super_sampling,
+                          enum render_layer_filter *out_sharpening)
+{
+	enum render_layer_filter super_sampling = RENDER_LAYER_FILTER_NONE;
+	if ((flags & XRT_LAYER_COMPOSITION_SUPER_SAMPLING_QUALITY_BIT) != 0) {
+		super_sampling = RENDER_LAYER_FILTER_QUALITY;
+	} else if ((flags & XRT_LAYER_COMPOSITION_SUPER_SAMPLING_NORMAL_BIT) != 0) {
+		super_sampling = RENDER_LAYER_FILTER_NORMAL;
+	}
+
+	enum render_layer_filter sharpening = RENDER_LAYER_FILTER_NONE;
+	if ((flags & XRT_LAYER_COMPOSITION_SHARPENING_QUALITY_BIT) != 0) {
+		sharpening = RENDER_LAYER_FILTER_QUALITY;
+	} else if ((flags & XRT_LAYER_COMPOSITION_SHARPENING_NORMAL_BIT) != 0) {
+		sharpening = RENDER_LAYER_FILTER_NORMAL;
+	}
+
+	*out_super_sampling = super_sampling;
+	*out_sharpening = sharpening;
+}
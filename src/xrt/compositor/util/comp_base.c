@@ -8,6 +8,7 @@
  * @ingroup comp_util
  */
 
+#include "util/u_misc.h"
 #include "util/u_wait.h"
 #include "util/u_trace_marker.h"
 
@@ -29,6 +30,10 @@ do_single_layer(struct xrt_compositor *xc,
 {
 	struct comp_base *cb = comp_base(xc);
 
+	if (cb->slot.layer_count >= COMP_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	uint32_t layer_id = cb->slot.layer_count;
 
 	struct comp_layer *layer = &cb->slot.layers[layer_id];
@@ -123,6 +128,10 @@ base_layer_stereo_projection(struct xrt_compositor *xc,
 {
 	struct comp_base *cb = comp_base(xc);
 
+	if (cb->slot.layer_count >= COMP_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	uint32_t layer_id = cb->slot.layer_count;
 
 	struct comp_layer *layer = &cb->slot.layers[layer_id];
@@ -146,6 +155,10 @@ base_layer_stereo_projection_depth(struct xrt_compositor *xc,
 {
 	struct comp_base *cb = comp_base(xc);
 
+	if (cb->slot.layer_count >= COMP_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	uint32_t layer_id = cb->slot.layer_count;
 
 	struct comp_layer *layer = &cb->slot.layers[layer_id];
@@ -160,6 +173,39 @@ base_layer_stereo_projection_depth(struct xrt_compositor *xc,
 	return XRT_SUCCESS;
 }
 
+static xrt_result_t
+base_layer_stereo_projection_space_warp(struct xrt_compositor *xc,
+                                        struct xrt_device *xdev,
+                                        struct xrt_swapchain *l_xsc,
+                                        struct xrt_swapchain *r_xsc,
+                                        struct xrt_swapchain *l_d_xsc,
+                                        struct xrt_swapchain *r_d_xsc,
+                                        struct xrt_swapchain *l_mv_xsc,
+                                        struct xrt_swapchain *r_mv_xsc,
+                                        const struct xrt_layer_data *data)
+{
+	struct comp_base *cb = comp_base(xc);
+
+	if (cb->slot.layer_count >= COMP_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
+	uint32_t layer_id = cb->slot.layer_count;
+
+	struct comp_layer *layer = &cb->slot.layers[layer_id];
+	layer->sc_array[0] = comp_swapchain(l_xsc);
+	layer->sc_array[1] = comp_swapchain(r_xsc);
+	layer->sc_array[2] = comp_swapchain(l_d_xsc);
+	layer->sc_array[3] = comp_swapchain(r_d_xsc);
+	layer->sc_array[4] = comp_swapchain(l_mv_xsc);
+	layer->sc_array[5] = comp_swapchain(r_mv_xsc);
+	layer->data = *data;
+
+	cb->slot.layer_count++;
+
+	return XRT_SUCCESS;
+}
+
 static xrt_result_t
 base_layer_quad(struct xrt_compositor *xc,
                 struct xrt_device *xdev,
@@ -205,6 +251,26 @@ base_layer_equirect2(struct xrt_compositor *xc,
 	return do_single_layer(xc, xdev, xsc, data);
 }
 
+static xrt_result_t
+base_layer_passthrough(struct xrt_compositor *xc, struct xrt_device *xdev, const struct xrt_layer_data *data)
+{
+	struct comp_base *cb = comp_base(xc);
+
+	if (cb->slot.layer_count >= COMP_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
+	uint32_t layer_id = cb->slot.layer_count;
+
+	struct comp_layer *layer = &cb->slot.layers[layer_id];
+	U_ZERO(&layer->sc_array);
+	layer->data = *data;
+
+	cb->slot.layer_count++;
+
+	return XRT_SUCCESS;
+}
+
 static xrt_result_t
 base_wait_frame(struct xrt_compositor *xc,
                 int64_t *out_frame_id,
@@ -258,11 +324,13 @@ comp_base_init(struct comp_base *cb)
 	cb->base.base.layer_begin = base_layer_begin;
 	cb->base.base.layer_stereo_projection = base_layer_stereo_projection;
 	cb->base.base.layer_stereo_projection_depth = base_layer_stereo_projection_depth;
+	cb->base.base.layer_stereo_projection_space_warp = base_layer_stereo_projection_space_warp;
 	cb->base.base.layer_quad = base_layer_quad;
 	cb->base.base.layer_cube = base_layer_cube;
 	cb->base.base.layer_cylinder = base_layer_cylinder;
 	cb->base.base.layer_equirect1 = base_layer_equirect1;
 	cb->base.base.layer_equirect2 = base_layer_equirect2;
+	cb->base.base.layer_passthrough = base_layer_passthrough;
 	cb->base.base.wait_frame = base_wait_frame;
 
 	u_threading_stack_init(&cb->cscs.destroy_swapchains);
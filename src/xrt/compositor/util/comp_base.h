@@ -29,11 +29,11 @@ extern "C" {
 struct comp_layer
 {
 	/*!
-	 * Up to four compositor swapchains referenced per layer.
+	 * Up to six compositor swapchains referenced per layer.
 	 *
 	 * Unused elements should be set to null.
 	 */
-	struct comp_swapchain *sc_array[4];
+	struct comp_swapchain *sc_array[6];
 
 	/*!
 	 * All basic (trivially-serializable) data associated with a layer.
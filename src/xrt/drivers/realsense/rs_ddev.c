@@ -411,6 +411,26 @@ rs_ddev_get_tracked_pose(struct xrt_device *xdev,
 	m_relation_history_get(rs->relation_hist, at_timestamp_ns, out_relation);
 }
 
+static xrt_result_t
+rs_ddev_get_tracked_pose_history(struct xrt_device *xdev,
+                                 enum xrt_input_name name,
+                                 uint32_t max_count,
+                                 uint64_t *out_timestamps_ns,
+                                 struct xrt_space_relation *out_relations,
+                                 uint32_t *out_count)
+{
+	struct rs_ddev *rs = rs_ddev(xdev);
+
+	if (name != XRT_INPUT_GENERIC_TRACKER_POSE) {
+		*out_count = 0;
+		return XRT_ERROR_DEVICE_FUNCTION_NOT_IMPLEMENTED;
+	}
+
+	*out_count = m_relation_history_get_newest(rs->relation_hist, max_count, out_timestamps_ns, out_relations);
+
+	return XRT_SUCCESS;
+}
+
 static void
 rs_ddev_get_view_poses(struct xrt_device *xdev,
                        const struct xrt_vec3 *default_eye_relation,
@@ -468,6 +488,7 @@ rs_ddev_create(int device_idx)
 	        rs->enable_relocalization, rs->enable_pose_prediction, rs->enable_pose_filtering);
 	rs->base.update_inputs = rs_ddev_update_inputs;
 	rs->base.get_tracked_pose = rs_ddev_get_tracked_pose;
+	rs->base.get_tracked_pose_history = rs_ddev_get_tracked_pose_history;
 	rs->base.get_view_poses = rs_ddev_get_view_poses;
 	rs->base.destroy = rs_ddev_destroy;
 	rs->base.name = XRT_DEVICE_REALSENSE;
@@ -56,7 +56,10 @@ r_device_update_inputs(struct xrt_device *xdev)
 	struct r_hub *r = rd->r;
 
 	uint64_t now = os_monotonic_get_ns();
-	struct r_remote_controller_data *latest = rd->is_left ? &r->latest.left : &r->latest.right;
+
+	struct r_remote_data data;
+	r_hub_get_latest(r, &data);
+	struct r_remote_controller_data *latest = rd->is_left ? &data.left : &data.right;
 
 	if (!latest->active) {
 		for (uint32_t i = 0; i < 19; i++) {
@@ -107,27 +110,31 @@ r_device_get_tracked_pose(struct xrt_device *xdev,
 		return;
 	}
 
-	struct r_remote_controller_data *latest = rd->is_left ? &r->latest.left : &r->latest.right;
-
-	/*
-	 * It's easier to reason about angular velocity if it's controlled in
-	 * body space, but the angular velocity returned in the relation is in
-	 * the base space.
-	 */
-	math_quat_rotate_derivative(&latest->pose.orientation, &latest->angular_velocity,
-	                            &out_relation->angular_velocity);
+	// Velocities were moved into base space when the data was pushed.
+	struct m_relation_history *rh = rd->is_left ? r->history.left : r->history.right;
+	r_hub_get_relation(r, rh, at_timestamp_ns, out_relation);
+}
 
-	out_relation->pose = latest->pose;
-	out_relation->linear_velocity = latest->linear_velocity;
+static xrt_result_t
+r_device_get_tracked_pose_history(struct xrt_device *xdev,
+                                  enum xrt_input_name name,
+                                  uint32_t max_count,
+                                  uint64_t *out_timestamps_ns,
+                                  struct xrt_space_relation *out_relations,
+                                  uint32_t *out_count)
+{
+	struct r_device *rd = r_device(xdev);
+	struct r_hub *r = rd->r;
 
-	if (latest->active) {
-		out_relation->relation_flags = (enum xrt_space_relation_flags)(
-		    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_POSITION_VALID_BIT |
-		    XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT | XRT_SPACE_RELATION_POSITION_TRACKED_BIT |
-		    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT | XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT);
-	} else {
-		out_relation->relation_flags = 0;
+	if (name != XRT_INPUT_INDEX_AIM_POSE && name != XRT_INPUT_INDEX_GRIP_POSE) {
+		*out_count = 0;
+		return XRT_ERROR_DEVICE_FUNCTION_NOT_IMPLEMENTED;
 	}
+
+	struct m_relation_history *rh = rd->is_left ? r->history.left : r->history.right;
+	*out_count = m_relation_history_get_newest(rh, max_count, out_timestamps_ns, out_relations);
+
+	return XRT_SUCCESS;
 }
 
 static void
@@ -146,7 +153,9 @@ r_device_get_hand_tracking(struct xrt_device *xdev,
 		return;
 	}
 
-	struct r_remote_controller_data *latest = rd->is_left ? &r->latest.left : &r->latest.right;
+	struct r_remote_data data;
+	r_hub_get_latest(r, &data);
+	struct r_remote_controller_data *latest = rd->is_left ? &data.left : &data.right;
 
 	struct u_hand_tracking_curl_values values = {
 	    .little = latest->hand_curl[0],
@@ -205,6 +214,7 @@ r_device_create(struct r_hub *r, bool is_left)
 	// Setup the basics.
 	rd->base.update_inputs = r_device_update_inputs;
 	rd->base.get_tracked_pose = r_device_get_tracked_pose;
+	rd->base.get_tracked_pose_history = r_device_get_tracked_pose_history;
 	rd->base.get_hand_tracking = r_device_get_hand_tracking;
 	rd->base.get_view_poses = r_device_get_view_poses;
 	rd->base.set_output = r_device_set_output;
@@ -35,15 +35,6 @@ r_hmd(struct xrt_device *xdev)
 	return (struct r_hmd *)xdev;
 }
 
-static inline void
-copy_head_center_to_relation(struct r_hmd *rh, struct xrt_space_relation *out_relation)
-{
-	out_relation->pose = rh->r->latest.head.center;
-	out_relation->relation_flags = (enum xrt_space_relation_flags)(
-	    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_POSITION_VALID_BIT |
-	    XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT | XRT_SPACE_RELATION_POSITION_TRACKED_BIT);
-}
-
 static void
 r_hmd_destroy(struct xrt_device *xdev)
 {
@@ -76,7 +67,27 @@ r_hmd_get_tracked_pose(struct xrt_device *xdev,
 		return;
 	}
 
-	copy_head_center_to_relation(rh, out_relation);
+	r_hub_get_relation(rh->r, rh->r->history.head, at_timestamp_ns, out_relation);
+}
+
+static xrt_result_t
+r_hmd_get_tracked_pose_history(struct xrt_device *xdev,
+                               enum xrt_input_name name,
+                               uint32_t max_count,
+                               uint64_t *out_timestamps_ns,
+                               struct xrt_space_relation *out_relations,
+                               uint32_t *out_count)
+{
+	struct r_hmd *rh = r_hmd(xdev);
+
+	if (name != XRT_INPUT_GENERIC_HEAD_POSE) {
+		*out_count = 0;
+		return XRT_ERROR_DEVICE_FUNCTION_NOT_IMPLEMENTED;
+	}
+
+	*out_count = m_relation_history_get_newest(rh->r->history.head, max_count, out_timestamps_ns, out_relations);
+
+	return XRT_SUCCESS;
 }
 
 static void
@@ -101,7 +112,10 @@ r_hmd_get_view_poses(struct xrt_device *xdev,
 {
 	struct r_hmd *rh = r_hmd(xdev);
 
-	if (!rh->r->latest.head.per_view_data_valid) {
+	struct r_remote_data latest;
+	r_hub_get_latest(rh->r, &latest);
+
+	if (!latest.head.per_view_data_valid) {
 		u_device_get_view_poses(  //
 		    xdev,                 //
 		    default_eye_relation, //
@@ -115,16 +129,16 @@ r_hmd_get_view_poses(struct xrt_device *xdev,
 		return;
 	}
 
-	if (view_count > ARRAY_SIZE(rh->r->latest.head.views)) {
+	if (view_count > ARRAY_SIZE(latest.head.views)) {
 		U_LOG_E("Asking for too many views!");
 		return;
 	}
 
-	copy_head_center_to_relation(rh, out_head_relation);
+	r_hub_get_relation(rh->r, rh->r->history.head, at_timestamp_ns, out_head_relation);
 
 	for (uint32_t i = 0; i < view_count; i++) {
-		out_poses[i] = rh->r->latest.head.views[i].pose;
-		out_fovs[i] = rh->r->latest.head.views[i].fov;
+		out_poses[i] = latest.head.views[i].pose;
+		out_fovs[i] = latest.head.views[i].fov;
 	}
 }
 
@@ -150,6 +164,7 @@ r_hmd_create(struct r_hub *r)
 	// Setup the basics.
 	rh->base.update_inputs = r_hmd_update_inputs;
 	rh->base.get_tracked_pose = r_hmd_get_tracked_pose;
+	rh->base.get_tracked_pose_history = r_hmd_get_tracked_pose_history;
 	rh->base.get_hand_tracking = r_hmd_get_hand_tracking;
 	rh->base.get_view_poses = r_hmd_get_view_poses;
 	rh->base.set_output = r_hmd_set_output;
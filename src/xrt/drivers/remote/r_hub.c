@@ -7,15 +7,20 @@
  * @ingroup drv_remote
  */
 
+#include "os/os_time.h"
+
 #include "util/u_var.h"
 #include "util/u_misc.h"
 #include "util/u_debug.h"
 
+#include "math/m_api.h"
+
 #include "r_interface.h"
 #include "r_internal.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <string.h>
 
 #if defined(XRT_OS_WINDOWS)
@@ -54,6 +59,12 @@
  */
 
 DEBUG_GET_ONCE_LOG_OPTION(remote_log, "REMOTE_LOG", U_LOGGING_INFO)
+DEBUG_GET_ONCE_OPTION(remote_playback, "REMOTE_PLAYBACK", NULL)
+DEBUG_GET_ONCE_NUM_OPTION(remote_playback_hz, "REMOTE_PLAYBACK_HZ", 1000)
+DEBUG_GET_ONCE_BOOL_OPTION(remote_playback_loop, "REMOTE_PLAYBACK_LOOP", true)
+
+//! Faster playback only burns CPU, also keeps the period from rounding to zero.
+#define R_PLAYBACK_MAX_HZ 10000
 
 #define R_TRACE(R, ...) U_LOG_IFL_T((R)->rc.log_level, __VA_ARGS__)
 #define R_DEBUG(R, ...) U_LOG_IFL_D((R)->rc.log_level, __VA_ARGS__)
@@ -68,6 +79,112 @@ DEBUG_GET_ONCE_LOG_OPTION(remote_log, "REMOTE_LOG", U_LOGGING_INFO)
 #define RC_ERROR(RC, ...) U_LOG_IFL_E((RC)->log_level, __VA_ARGS__)
 
 
+/*
+ *
+ * Seqlock helpers.
+ *
+ */
+
+static inline void
+full_barrier(void)
+{
+#if defined(__GNUC__)
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	MemoryBarrier();
+#else
+#error "compiler not supported"
+#endif
+}
+
+static inline int32_t
+read_begin(struct r_hub *r)
+{
+	int32_t seq;
+
+	// Odd while the receiving thread is writing, it never blocks in there.
+	while (((seq = r->latest.seq) & 1) != 0) {
+		full_barrier();
+	}
+	full_barrier();
+
+	return seq;
+}
+
+static inline bool
+read_end(struct r_hub *r, int32_t seq)
+{
+	full_barrier();
+	return r->latest.seq == seq;
+}
+
+
+/*
+ *
+ * Data functions.
+ *
+ */
+
+/*!
+ * The smallest difference seen between our clock and the sender's is the
+ * latency with the least jitter, use that to map sender timestamps.
+ */
+static uint64_t
+map_timestamp(struct r_hub *r, const struct r_remote_data *data, uint64_t now_ns)
+{
+	if (data->timestamp_ns == 0) {
+		return now_ns;
+	}
+
+	int64_t offset_ns = (int64_t)now_ns - (int64_t)data->timestamp_ns;
+	if (!r->clock.valid || offset_ns < r->clock.offset_ns) {
+		r->clock.offset_ns = offset_ns;
+		r->clock.valid = true;
+	}
+
+	return (uint64_t)((int64_t)data->timestamp_ns + r->clock.offset_ns);
+}
+
+static void
+push_controller(struct m_relation_history *rh, const struct r_remote_controller_data *c, uint64_t timestamp_ns)
+{
+	struct xrt_space_relation relation = XRT_SPACE_RELATION_ZERO;
+
+	if (c->active) {
+		relation.pose = c->pose;
+		relation.linear_velocity = c->linear_velocity;
+
+		/*
+		 * It's easier to reason about angular velocity if it's controlled in
+		 * body space, but the angular velocity returned in the relation is in
+		 * the base space.
+		 */
+		math_quat_rotate_derivative(&c->pose.orientation, &c->angular_velocity, &relation.angular_velocity);
+
+		relation.relation_flags = (enum xrt_space_relation_flags)(
+		    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_POSITION_VALID_BIT |
+		    XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT | XRT_SPACE_RELATION_POSITION_TRACKED_BIT |
+		    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT | XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT);
+	}
+
+	m_relation_history_push(rh, &relation, timestamp_ns);
+}
+
+static void
+push_head(struct m_relation_history *rh, const struct r_head_data *head, uint64_t timestamp_ns)
+{
+	struct xrt_space_relation relation = XRT_SPACE_RELATION_ZERO;
+	relation.pose = head->center;
+	relation.relation_flags = (enum xrt_space_relation_flags)(
+	    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_POSITION_VALID_BIT |
+	    XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT | XRT_SPACE_RELATION_POSITION_TRACKED_BIT);
+
+	// No velocities on the wire for the head, estimate them.
+	m_relation_history_estimate_motion(rh, &relation, timestamp_ns, &relation);
+	m_relation_history_push(rh, &relation, timestamp_ns);
+}
+
+
 /*
  *
  * Socket functions.
@@ -315,8 +432,14 @@ run_thread(void *ptr)
 			return NULL;
 		}
 
+		struct r_remote_data latest;
+		r_hub_get_latest(r, &latest);
+
 		r_remote_connection_write_one(&r->rc, &r->reset);
-		r_remote_connection_write_one(&r->rc, &r->latest);
+		r_remote_connection_write_one(&r->rc, &latest);
+
+		// New sender, maybe with a different clock.
+		r->clock.valid = false;
 
 		while (true) {
 			struct r_remote_data data;
@@ -326,7 +449,8 @@ run_thread(void *ptr)
 				break;
 			}
 
-			r->latest = data;
+			uint64_t timestamp_ns = map_timestamp(r, &data, os_monotonic_get_ns());
+			r_hub_push_data(r, &data, timestamp_ns);
 		}
 	}
 
@@ -335,6 +459,46 @@ run_thread(void *ptr)
 	return NULL;
 }
 
+static void *
+run_playback_thread(void *ptr)
+{
+	struct r_hub *r = (struct r_hub *)ptr;
+
+	struct os_precise_sleeper sleeper;
+	os_precise_sleeper_init(&sleeper);
+
+	R_INFO(r, "Playing back %u keyframes at %" PRIu64 "Hz.", r->playback.trajectory.keyframe_count,
+	       U_TIME_1S_IN_NS / r->playback.period_ns);
+
+	uint64_t start_ns = os_monotonic_get_ns();
+	uint64_t next_ns = start_ns;
+
+	while (os_thread_helper_is_running(&r->oth)) {
+		uint64_t now_ns = os_monotonic_get_ns();
+
+		struct r_remote_data data = r->reset;
+		r_trajectory_sample(&r->playback.trajectory, now_ns - start_ns, r->playback.loop, &data);
+		data.timestamp_ns = now_ns;
+
+		r_hub_push_data(r, &data, now_ns);
+
+		// Keep to the rate, but don't try to catch up if we fell behind.
+		next_ns += r->playback.period_ns;
+		now_ns = os_monotonic_get_ns();
+		if (next_ns > now_ns) {
+			os_precise_sleeper_nanosleep(&sleeper, (int32_t)(next_ns - now_ns));
+		} else {
+			next_ns = now_ns;
+		}
+	}
+
+	os_precise_sleeper_deinit(&sleeper);
+
+	R_INFO(r, "Leaving thread");
+
+	return NULL;
+}
+
 static void
 r_hub_system_devices_destroy(struct xrt_system_devices *xsysd)
 {
@@ -350,6 +514,11 @@ r_hub_system_devices_destroy(struct xrt_system_devices *xsysd)
 		xrt_device_destroy(&r->base.xdevs[i]);
 	}
 
+	m_relation_history_destroy(&r->history.head);
+	m_relation_history_destroy(&r->history.left);
+	m_relation_history_destroy(&r->history.right);
+	r_trajectory_fini(&r->playback.trajectory);
+
 	// Should be safe to destroy the sockets now.
 	if (r->accept_fd >= 0) {
 		socket_close(r->accept_fd);
@@ -400,7 +569,8 @@ r_create_devices(uint16_t port, struct xrt_system_devices **out_xsysd)
 	r->reset.right.pose.position.y = 1.3f;
 	r->reset.right.pose.position.z = -0.5f;
 	r->reset.right.pose.orientation.w = 1.0f;
-	r->latest = r->reset;
+	r->latest.data = r->reset;
+	r->gui.data = r->reset;
 	r->rc.log_level = debug_get_log_option_remote_log();
 	r->gui.hmd = true;
 	r->gui.left = true;
@@ -411,6 +581,15 @@ r_create_devices(uint16_t port, struct xrt_system_devices **out_xsysd)
 
 	snprintf(r->origin.name, sizeof(r->origin.name), "Remote Simulator");
 
+	// Start out at the reset position.
+	uint64_t now_ns = os_monotonic_get_ns();
+	m_relation_history_create(&r->history.head);
+	m_relation_history_create(&r->history.left);
+	m_relation_history_create(&r->history.right);
+	push_head(r->history.head, &r->reset.head, now_ns);
+	push_controller(r->history.left, &r->reset.left, now_ns);
+	push_controller(r->history.right, &r->reset.right, now_ns);
+
 	ret = os_thread_helper_init(&r->oth);
 	if (ret != 0) {
 		R_ERROR(r, "Failed to init threading!");
@@ -418,7 +597,25 @@ r_create_devices(uint16_t port, struct xrt_system_devices **out_xsysd)
 		return XRT_ERROR_ALLOCATION;
 	}
 
-	ret = os_thread_helper_start(&r->oth, run_thread, r);
+	const char *playback = debug_get_option_remote_playback();
+	if (playback != NULL) {
+		int64_t hz = debug_get_num_option_remote_playback_hz();
+		if (!r_trajectory_load(&r->playback.trajectory, playback) || hz <= 0) {
+			R_ERROR(r, "Failed to set up playback of '%s'!", playback);
+			r_hub_system_devices_destroy(&r->base);
+			return XRT_ERROR_DEVICE_CREATION_FAILED;
+		}
+
+		if (hz > R_PLAYBACK_MAX_HZ) {
+			R_WARN(r, "Playback rate of %" PRIi64 "Hz is too high, using %dHz.", hz, R_PLAYBACK_MAX_HZ);
+			hz = R_PLAYBACK_MAX_HZ;
+		}
+
+		r->playback.period_ns = U_TIME_1S_IN_NS / (uint64_t)hz;
+		r->playback.loop = debug_get_bool_option_remote_playback_loop();
+	}
+
+	ret = os_thread_helper_start(&r->oth, playback != NULL ? run_playback_thread : run_thread, r);
 	if (ret != 0) {
 		R_ERROR(r, "Failed to start thread!");
 		r_hub_system_devices_destroy(&r->base);
@@ -451,13 +648,17 @@ r_create_devices(uint16_t port, struct xrt_system_devices **out_xsysd)
 
 	u_var_add_root(r, "Remote Hub", true);
 	// u_var_add_gui_header(r, &r->gui.hmd, "MHD");
-	u_var_add_pose(r, &r->latest.head.center, "head.center");
+	u_var_add_ro_vec3_f32(r, &r->gui.data.head.center.position, "head.center.position");
+	u_var_add_ro_quat_f32(r, &r->gui.data.head.center.orientation, "head.center.orientation");
 	// u_var_add_gui_header(r, &r->gui.left, "Left");
-	u_var_add_bool(r, &r->latest.left.active, "left.active");
-	u_var_add_pose(r, &r->latest.left.pose, "left.pose");
+	u_var_add_bool(r, &r->gui.data.left.active, "left.active");
+	u_var_add_ro_vec3_f32(r, &r->gui.data.left.pose.position, "left.pose.position");
+	u_var_add_ro_quat_f32(r, &r->gui.data.left.pose.orientation, "left.pose.orientation");
 	// u_var_add_gui_header(r, &r->gui.right, "Right");
-	u_var_add_bool(r, &r->latest.right.active, "right.active");
-	u_var_add_pose(r, &r->latest.right.pose, "right.pose");
+	u_var_add_bool(r, &r->gui.data.right.active, "right.active");
+	u_var_add_ro_vec3_f32(r, &r->gui.data.right.pose.position, "right.pose.position");
+	u_var_add_ro_quat_f32(r, &r->gui.data.right.pose.orientation, "right.pose.orientation");
+	u_var_add_ro_i64(r, &r->clock.offset_ns, "clock.offset_ns");
 
 	/*
 	 * Done now.
@@ -469,6 +670,63 @@ r_create_devices(uint16_t port, struct xrt_system_devices **out_xsysd)
 }
 
 
+/*
+ *
+ * 'Exported' data functions.
+ *
+ */
+
+void
+r_hub_push_data(struct r_hub *r, const struct r_remote_data *data, uint64_t timestamp_ns)
+{
+	// Full barrier, makes the counter odd before any data is written.
+	xrt_atomic_s32_inc_return(&r->latest.seq);
+	r->latest.data = *data;
+	// Full barrier, all data is written before the counter is even again.
+	xrt_atomic_s32_inc_return(&r->latest.seq);
+
+	// Only written here, the debug GUI never touches the seqlocked data.
+	r->gui.data = *data;
+
+	push_head(r->history.head, &data->head, timestamp_ns);
+	push_controller(r->history.left, &data->left, timestamp_ns);
+	push_controller(r->history.right, &data->right, timestamp_ns);
+}
+
+void
+r_hub_get_latest(struct r_hub *r, struct r_remote_data *out_data)
+{
+	int32_t seq;
+
+	do {
+		seq = read_begin(r);
+		*out_data = r->latest.data;
+	} while (!read_end(r, seq));
+}
+
+void
+r_hub_get_relation(struct r_hub *r,
+                   struct m_relation_history *rh,
+                   uint64_t at_timestamp_ns,
+                   struct xrt_space_relation *out_relation)
+{
+	uint64_t newest_ns = 0;
+	struct xrt_space_relation newest;
+
+	if (!m_relation_history_get_latest(rh, &newest_ns, &newest)) {
+		*out_relation = (struct xrt_space_relation)XRT_SPACE_RELATION_ZERO;
+		return;
+	}
+
+	// Don't run away with the velocities if the sender has stopped.
+	if (at_timestamp_ns > newest_ns + R_MAX_PREDICTION_NS) {
+		at_timestamp_ns = newest_ns + R_MAX_PREDICTION_NS;
+	}
+
+	m_relation_history_get(rh, at_timestamp_ns, out_relation);
+}
+
+
 /*
  *
  * 'Exported' connection functions.
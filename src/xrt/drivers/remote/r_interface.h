@@ -38,7 +38,7 @@ struct xrt_system_devices;
  *
  * @ingroup drv_remote
  */
-#define R_HEADER_VALUE (*(uint64_t *)"mndrmt3\0")
+#define R_HEADER_VALUE (*(uint64_t *)"mndrmt4\0")
 
 /*!
  * Data per controller.
@@ -111,6 +111,12 @@ struct r_remote_data
 {
 	uint64_t header;
 
+	/*!
+	 * When this data was sampled, in the monotonic clock of the sender. The
+	 * hub maps it into its own clock, zero means stamp it on arrival.
+	 */
+	uint64_t timestamp_ns;
+
 	struct r_head_data head;
 
 	struct r_remote_controller_data left, right;
@@ -9,14 +9,18 @@
 
 #pragma once
 
+#include "xrt/xrt_compiler.h"
 #include "xrt/xrt_device.h"
 #include "xrt/xrt_system.h"
 #include "xrt/xrt_tracking.h"
 
 #include "os/os_threading.h"
 
+#include "util/u_time.h"
 #include "util/u_hand_tracking.h"
 
+#include "math/m_relation_history.h"
+
 #include "r_interface.h"
 
 
@@ -25,6 +29,34 @@ extern "C" {
 #endif
 
 
+//! Poses are not extrapolated further than this past the newest sample.
+#define R_MAX_PREDICTION_NS (100 * U_TIME_1MS_IN_NS)
+
+
+/*!
+ * One keyframe of a recorded trajectory.
+ *
+ * @ingroup drv_remote
+ */
+struct r_trajectory_keyframe
+{
+	//! Time relative to the first keyframe.
+	uint64_t time_ns;
+
+	struct xrt_pose head, left, right;
+};
+
+/*!
+ * A recorded trajectory that is played back instead of listening on a socket.
+ *
+ * @ingroup drv_remote
+ */
+struct r_trajectory
+{
+	struct r_trajectory_keyframe *keyframes;
+	uint32_t keyframe_count;
+};
+
 /*!
  * Central object remote object.
  *
@@ -44,8 +76,36 @@ struct r_hub
 	//! The data that the is the reset position.
 	struct r_remote_data reset;
 
-	//! The latest data received.
-	struct r_remote_data latest;
+	/*!
+	 * The latest data received, only written by the receiving thread and
+	 * guarded by a seqlock, so readers never block it or see torn data.
+	 */
+	struct
+	{
+		xrt_atomic_s32_t seq;
+		struct r_remote_data data;
+	} latest;
+
+	//! Pose history of each device, timestamps are in our clock.
+	struct
+	{
+		struct m_relation_history *head, *left, *right;
+	} history;
+
+	//! Maps sender timestamps into our clock.
+	struct
+	{
+		int64_t offset_ns;
+		bool valid;
+	} clock;
+
+	//! Trajectory playback, used instead of the socket if loaded.
+	struct
+	{
+		struct r_trajectory trajectory;
+		uint64_t period_ns;
+		bool loop;
+	} playback;
 
 	//! Incoming connection socket.
 	int accept_fd;
@@ -57,6 +117,9 @@ struct r_hub
 	struct
 	{
 		bool hmd, left, right;
+
+		//! Copy of the latest data for the debug GUI, edits there are not used by anything.
+		struct r_remote_data data;
 	} gui;
 };
 
@@ -89,6 +152,65 @@ struct r_device
 };
 
 
+/*!
+ * Publishes new data, @p timestamp_ns is in our clock. Only to be called
+ * from the receiving thread.
+ *
+ * @public @memberof r_hub
+ */
+void
+r_hub_push_data(struct r_hub *r, const struct r_remote_data *data, uint64_t timestamp_ns);
+
+/*!
+ * Copies out the latest data, never returns a partially written copy.
+ *
+ * @public @memberof r_hub
+ */
+void
+r_hub_get_latest(struct r_hub *r, struct r_remote_data *out_data);
+
+/*!
+ * Interpolates or predicts from one of the pose histories, predictions are
+ * limited to @ref R_MAX_PREDICTION_NS past the newest sample.
+ *
+ * @public @memberof r_hub
+ */
+void
+r_hub_get_relation(struct r_hub *r,
+                   struct m_relation_history *rh,
+                   uint64_t at_timestamp_ns,
+                   struct xrt_space_relation *out_relation);
+
+/*!
+ * Loads a trajectory from a text file, one keyframe per line:
+ *
+ * `time_s head_pose left_pose right_pose`
+ *
+ * Where each pose is `px py pz qx qy qz qw`. Empty lines and lines starting
+ * with `#` are skipped, times must be increasing.
+ *
+ * @public @memberof r_trajectory
+ */
+bool
+r_trajectory_load(struct r_trajectory *t, const char *path);
+
+/*!
+ * Samples the trajectory at @p time_ns after its start, writing the poses and
+ * velocities of @p data and leaving everything else alone.
+ *
+ * @public @memberof r_trajectory
+ */
+void
+r_trajectory_sample(const struct r_trajectory *t, uint64_t time_ns, bool loop, struct r_remote_data *data);
+
+/*!
+ * Frees the keyframes.
+ *
+ * @public @memberof r_trajectory
+ */
+void
+r_trajectory_fini(struct r_trajectory *t);
+
 struct xrt_device *
 r_hmd_create(struct r_hub *r);
 
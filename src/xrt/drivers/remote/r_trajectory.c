@@ -0,0 +1,205 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Trajectory playback for the remote driver.
+ * @author agent <agent@local>
+ * @ingroup drv_remote
+ */
+
+#include "util/u_misc.h"
+#include "util/u_time.h"
+#include "util/u_logging.h"
+
+#include "math/m_api.h"
+#include "math/m_vec3.h"
+
+#include "r_internal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+#define POSE_FMT " %f %f %f %f %f %f %f"
+#define POSE_ARGS(P)                                                                                                   \
+	&(P).position.x, &(P).position.y, &(P).position.z, &(P).orientation.x, &(P).orientation.y, &(P).orientation.z, \
+	    &(P).orientation.w
+
+static bool
+parse_line(const char *line, double *out_time_s, struct r_trajectory_keyframe *out_keyframe)
+{
+	struct r_trajectory_keyframe k = {0};
+
+	int count = sscanf(line, "%lf" POSE_FMT POSE_FMT POSE_FMT, out_time_s, //
+	                   POSE_ARGS(k.head), POSE_ARGS(k.left), POSE_ARGS(k.right));
+	if (count != 22) {
+		return false;
+	}
+
+	math_quat_normalize(&k.head.orientation);
+	math_quat_normalize(&k.left.orientation);
+	math_quat_normalize(&k.right.orientation);
+
+	*out_keyframe = k;
+
+	return true;
+}
+
+static void
+sample_pose(const struct xrt_pose *p0,
+            const struct xrt_pose *p1,
+            float amount,
+            float dt,
+            struct xrt_pose *out_pose,
+            struct xrt_vec3 *out_linear_velocity,
+            struct xrt_vec3 *out_angular_velocity)
+{
+	out_pose->position = m_vec3_lerp(p0->position, p1->position, amount);
+	math_quat_slerp(&p0->orientation, &p1->orientation, amount, &out_pose->orientation);
+
+	if (dt <= 0.0f) {
+		*out_linear_velocity = (struct xrt_vec3)XRT_VEC3_ZERO;
+		*out_angular_velocity = (struct xrt_vec3)XRT_VEC3_ZERO;
+		return;
+	}
+
+	// Constant over the segment, so the hub's interpolation stays exact.
+	*out_linear_velocity = m_vec3_mul_scalar(m_vec3_sub(p1->position, p0->position), 1.0f / dt);
+
+	// The protocol sends angular velocity in body space.
+	struct xrt_vec3 angular_velocity;
+	struct xrt_quat inverse;
+	math_quat_finite_difference(&p0->orientation, &p1->orientation, dt, &angular_velocity);
+	math_quat_invert(&out_pose->orientation, &inverse);
+	math_quat_rotate_vec3(&inverse, &angular_velocity, out_angular_velocity);
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+bool
+r_trajectory_load(struct r_trajectory *t, const char *path)
+{
+	FILE *file = fopen(path, "r");
+	if (file == NULL) {
+		U_LOG_E("Could not open trajectory '%s'", path);
+		return false;
+	}
+
+	struct r_trajectory_keyframe *keyframes = NULL;
+	uint32_t count = 0;
+	double first_s = 0.0;
+	char line[1024];
+	int line_number = 0;
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		line_number++;
+
+		const char *str = line + strspn(line, " \t");
+		if (str[0] == '#' || str[0] == '\n' || str[0] == '\r' || str[0] == '\0') {
+			continue;
+		}
+
+		double time_s = 0.0;
+		struct r_trajectory_keyframe keyframe;
+		if (!parse_line(str, &time_s, &keyframe)) {
+			U_LOG_E("Malformed keyframe on line %i of '%s'", line_number, path);
+			goto err_free;
+		}
+
+		if (count == 0) {
+			first_s = time_s;
+		}
+
+		keyframe.time_ns = (uint64_t)time_s_to_ns(time_s - first_s);
+
+		if (count > 0 && keyframe.time_ns <= keyframes[count - 1].time_ns) {
+			U_LOG_E("Keyframe time is not increasing on line %i of '%s'", line_number, path);
+			goto err_free;
+		}
+
+		U_ARRAY_REALLOC_OR_FREE(keyframes, struct r_trajectory_keyframe, count + 1);
+		keyframes[count++] = keyframe;
+	}
+
+	fclose(file);
+
+	if (count == 0) {
+		U_LOG_E("No keyframes in '%s'", path);
+		return false;
+	}
+
+	t->keyframes = keyframes;
+	t->keyframe_count = count;
+
+	return true;
+
+err_free:
+	free(keyframes);
+	fclose(file);
+	return false;
+}
+
+void
+r_trajectory_sample(const struct r_trajectory *t, uint64_t time_ns, bool loop, struct r_remote_data *data)
+{
+	const struct r_trajectory_keyframe *first = &t->keyframes[0];
+	const struct r_trajectory_keyframe *last = &t->keyframes[t->keyframe_count - 1];
+
+	if (loop && last->time_ns > 0) {
+		time_ns %= last->time_ns;
+	}
+
+	// Past the end or a single keyframe, hold the last pose.
+	const struct r_trajectory_keyframe *k0 = last;
+	const struct r_trajectory_keyframe *k1 = last;
+
+	if (time_ns < last->time_ns) {
+		// Find the last keyframe not after the time.
+		uint32_t low = 0;
+		uint32_t high = t->keyframe_count - 1;
+		while (high - low > 1) {
+			uint32_t mid = low + (high - low) / 2;
+			if (t->keyframes[mid].time_ns <= time_ns) {
+				low = mid;
+			} else {
+				high = mid;
+			}
+		}
+
+		k0 = first + low;
+		k1 = first + high;
+	}
+
+	float amount = 0.0f;
+	float dt = 0.0f;
+	if (k1 != k0) {
+		amount = (float)(time_ns - k0->time_ns) / (float)(k1->time_ns - k0->time_ns);
+		dt = (float)time_ns_to_s(k1->time_ns - k0->time_ns);
+	}
+
+	struct xrt_vec3 unused_linear, unused_angular;
+	sample_pose(&k0->head, &k1->head, amount, dt, &data->head.center, &unused_linear, &unused_angular);
+	sample_pose(&k0->left, &k1->left, amount, dt, &data->left.pose, &data->left.linear_velocity,
+	            &data->left.angular_velocity);
+	sample_pose(&k0->right, &k1->right, amount, dt, &data->right.pose, &data->right.linear_velocity,
+	            &data->right.angular_velocity);
+}
+
+void
+r_trajectory_fini(struct r_trajectory *t)
+{
+	free(t->keyframes);
+	t->keyframes = NULL;
+	t->keyframe_count = 0;
+}
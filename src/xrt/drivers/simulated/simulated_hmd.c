@@ -8,8 +8,10 @@
  */
 
 #include "xrt/xrt_device.h"
+#include "xrt/xrt_frame.h"
 
 #include "os/os_time.h"
+#include "os/os_threading.h"
 
 #include "math/m_api.h"
 #include "math/m_mathinclude.h"
@@ -19,6 +21,7 @@
 #include "util/u_time.h"
 #include "util/u_debug.h"
 #include "util/u_device.h"
+#include "util/u_frame.h"
 #include "util/u_logging.h"
 #include "util/u_distortion_mesh.h"
 
@@ -27,6 +30,15 @@
 #include <stdio.h>
 
 
+//! Size and rate of the simulated passthrough camera.
+#define CAMERA_WIDTH (320)
+#define CAMERA_HEIGHT (240)
+#define CAMERA_INTERVAL_NS (U_TIME_1S_IN_NS / 30)
+
+//! Size of the checker squares of the simulated world, in degrees.
+#define CHECKER_DEG (10.0)
+
+
 /*
  *
  * Structs and defines.
@@ -50,6 +62,17 @@ struct simulated_hmd
 
 	enum u_logging_level log_level;
 	enum simulated_movement movement;
+
+	//! Simulated passthrough camera, renders a world fixed checker pattern.
+	struct
+	{
+		struct os_thread_helper oth;
+
+		//! Only changed while the thread is stopped.
+		struct xrt_frame_sink *sink;
+
+		struct xrt_passthrough_camera_info info;
+	} camera;
 };
 
 
@@ -76,6 +99,9 @@ simulated_hmd_destroy(struct xrt_device *xdev)
 {
 	struct simulated_hmd *dh = simulated_hmd(xdev);
 
+	// Stops the camera thread if running.
+	os_thread_helper_destroy(&dh->camera.oth);
+
 	// Remove the variable tracking.
 	u_var_remove_root(dh);
 
@@ -89,18 +115,8 @@ simulated_hmd_update_inputs(struct xrt_device *xdev)
 }
 
 static void
-simulated_hmd_get_tracked_pose(struct xrt_device *xdev,
-                               enum xrt_input_name name,
-                               uint64_t at_timestamp_ns,
-                               struct xrt_space_relation *out_relation)
+calc_pose(struct simulated_hmd *dh, uint64_t at_timestamp_ns, struct xrt_pose *out_pose)
 {
-	struct simulated_hmd *dh = simulated_hmd(xdev);
-
-	if (name != XRT_INPUT_GENERIC_HEAD_POSE) {
-		DH_ERROR(dh, "unknown input name");
-		return;
-	}
-
 	const double time_s = time_ns_to_s(at_timestamp_ns - dh->created_ns);
 	const double d = dh->diameter_m;
 	const double d2 = d * 2;
@@ -124,22 +140,38 @@ simulated_hmd_get_tracked_pose(struct xrt_device *xdev,
 		math_quat_normalize(&tmp.orientation);
 
 		// Transform with center to set it.
-		math_pose_transform(&dh->center, &tmp, &dh->pose);
+		math_pose_transform(&dh->center, &tmp, out_pose);
 	} break;
 	case SIMULATED_MOVEMENT_ROTATE: {
 		struct xrt_pose tmp = XRT_POSE_IDENTITY;
 
 		// Rotate around the up vector.
-		math_quat_from_angle_vector(time_s / 4, &up, &dh->pose.orientation);
+		math_quat_from_angle_vector(time_s / 4, &up, &out_pose->orientation);
 
 		// Transform with center to set it.
-		math_pose_transform(&dh->center, &tmp, &dh->pose);
+		math_pose_transform(&dh->center, &tmp, out_pose);
 	} break;
 	case SIMULATED_MOVEMENT_STATIONARY:
 		// Reset pose.
-		dh->pose = dh->center;
+		*out_pose = dh->center;
 		break;
 	}
+}
+
+static void
+simulated_hmd_get_tracked_pose(struct xrt_device *xdev,
+                               enum xrt_input_name name,
+                               uint64_t at_timestamp_ns,
+                               struct xrt_space_relation *out_relation)
+{
+	struct simulated_hmd *dh = simulated_hmd(xdev);
+
+	if (name != XRT_INPUT_GENERIC_HEAD_POSE) {
+		DH_ERROR(dh, "unknown input name");
+		return;
+	}
+
+	calc_pose(dh, at_timestamp_ns, &dh->pose);
 
 	out_relation->pose = dh->pose;
 	out_relation->relation_flags = (enum xrt_space_relation_flags)(XRT_SPACE_RELATION_ORIENTATION_VALID_BIT |
@@ -160,6 +192,124 @@ simulated_hmd_get_view_poses(struct xrt_device *xdev,
 	                        out_poses);
 }
 
+static void
+render_camera_frame(struct simulated_hmd *dh, struct xrt_frame *xf)
+{
+	// The camera looks where the head did, at the time of capture.
+	struct xrt_pose head;
+	calc_pose(dh, xf->timestamp, &head);
+
+	struct xrt_quat rot;
+	math_quat_rotate(&head.orientation, &dh->camera.info.poses[0].orientation, &rot);
+
+	const struct xrt_fov *fov = &dh->camera.info.fovs[0];
+	const double tan_left = tan(fov->angle_left);
+	const double tan_right = tan(fov->angle_right);
+	const double tan_up = tan(fov->angle_up);
+	const double tan_down = tan(fov->angle_down);
+
+	for (uint32_t y = 0; y < xf->height; y++) {
+		uint8_t *row = xf->data + y * xf->stride;
+		double v = (y + 0.5) / xf->height;
+
+		for (uint32_t x = 0; x < xf->width; x++) {
+			double u = (x + 0.5) / xf->width;
+
+			struct xrt_vec3 dir = {
+			    (float)(tan_left + u * (tan_right - tan_left)),
+			    (float)(tan_up + v * (tan_down - tan_up)),
+			    -1.0f,
+			};
+			math_vec3_normalize(&dir);
+			math_quat_rotate_vec3(&rot, &dir, &dir);
+
+			// Latitude and longitude of the direction in the world, in checker squares.
+			double lon = atan2(dir.x, -dir.z) * (180.0 / M_PI) / CHECKER_DEG;
+			double lat = asin(dir.y) * (180.0 / M_PI) / CHECKER_DEG;
+			bool odd = (((int)floor(lon) + (int)floor(lat)) & 1) != 0;
+
+			// Floor and ceiling tinted so up is obvious.
+			uint8_t *p = row + x * 3;
+			p[0] = odd ? 200 : 60;
+			p[1] = odd ? 200 : (dir.y < 0 ? 90 : 60);
+			p[2] = odd ? 200 : (dir.y > 0 ? 90 : 60);
+		}
+	}
+}
+
+static void *
+simulated_hmd_camera_thread(void *ptr)
+{
+	struct simulated_hmd *dh = (struct simulated_hmd *)ptr;
+
+	os_thread_helper_name(&dh->camera.oth, "Simulated Camera");
+
+	uint64_t next_ns = os_monotonic_get_ns();
+	uint64_t sequence = 0;
+
+	os_thread_helper_lock(&dh->camera.oth);
+	while (os_thread_helper_is_running_locked(&dh->camera.oth)) {
+		os_thread_helper_unlock(&dh->camera.oth);
+
+		struct xrt_frame *xf = NULL;
+		u_frame_create_one_off(XRT_FORMAT_R8G8B8, CAMERA_WIDTH, CAMERA_HEIGHT, &xf);
+		xf->timestamp = next_ns;
+		xf->source_timestamp = next_ns;
+		xf->source_sequence = sequence++;
+		xf->stereo_format = XRT_STEREO_FORMAT_NONE;
+
+		render_camera_frame(dh, xf);
+		xrt_sink_push_frame(dh->camera.sink, xf);
+		xrt_frame_reference(&xf, NULL);
+
+		next_ns += CAMERA_INTERVAL_NS;
+		int64_t sleep_ns = (int64_t)(next_ns - os_monotonic_get_ns());
+		if (sleep_ns > 0) {
+			os_nanosleep(sleep_ns);
+		} else {
+			// Fell behind, don't try to catch up.
+			next_ns = os_monotonic_get_ns();
+		}
+
+		os_thread_helper_lock(&dh->camera.oth);
+	}
+	os_thread_helper_unlock(&dh->camera.oth);
+
+	return NULL;
+}
+
+static xrt_result_t
+simulated_hmd_set_passthrough_sink(struct xrt_device *xdev,
+                                   struct xrt_frame_sink *sink,
+                                   struct xrt_passthrough_camera_info *out_info)
+{
+	struct simulated_hmd *dh = simulated_hmd(xdev);
+
+	// Always stop, the sink is only changed while stopped.
+	os_thread_helper_stop_and_wait(&dh->camera.oth);
+	dh->camera.sink = sink;
+
+	if (sink == NULL) {
+		DH_DEBUG(dh, "Stopped camera");
+		return XRT_SUCCESS;
+	}
+
+	if (out_info != NULL) {
+		*out_info = dh->camera.info;
+	}
+
+	int ret = os_thread_helper_start(&dh->camera.oth, simulated_hmd_camera_thread, dh);
+	if (ret != 0) {
+		DH_ERROR(dh, "Failed to start camera thread: %d", ret);
+		dh->camera.sink = NULL;
+		return XRT_ERROR_THREADING_INIT_FAILURE;
+	}
+
+	DH_DEBUG(dh, "Started camera");
+
+	return XRT_SUCCESS;
+}
+
 
 /*
  *
@@ -182,6 +332,7 @@ simulated_hmd_create(enum simulated_movement movement, const struct xrt_pose *ce
 	dh->base.update_inputs = simulated_hmd_update_inputs;
 	dh->base.get_tracked_pose = simulated_hmd_get_tracked_pose;
 	dh->base.get_view_poses = simulated_hmd_get_view_poses;
+	dh->base.set_passthrough_sink = simulated_hmd_set_passthrough_sink;
 	dh->base.destroy = simulated_hmd_destroy;
 	dh->base.name = XRT_DEVICE_GENERIC_HMD;
 	dh->base.device_type = XRT_DEVICE_TYPE_HMD;
@@ -191,6 +342,26 @@ simulated_hmd_create(enum simulated_movement movement, const struct xrt_pose *ce
 	dh->diameter_m = 0.05f;
 	dh->log_level = simulated_log_level();
 	dh->movement = movement;
+	dh->base.passthrough_supported = true;
+
+	// One camera between the eyes looking forward, a bit narrower than the displays.
+	const float camera_half_fov_x = 45.0f * ((float)(M_PI) / 180.0f);
+	const float camera_half_fov_y = 36.0f * ((float)(M_PI) / 180.0f);
+	for (uint32_t i = 0; i < ARRAY_SIZE(dh->camera.info.poses); i++) {
+		dh->camera.info.poses[i] = (struct xrt_pose)XRT_POSE_IDENTITY;
+		dh->camera.info.fovs[i] = (struct xrt_fov){
+		    .angle_left = -camera_half_fov_x,
+		    .angle_right = camera_half_fov_x,
+		    .angle_up = camera_half_fov_y,
+		    .angle_down = -camera_half_fov_y,
+		};
+	}
+
+	if (os_thread_helper_init(&dh->camera.oth) != 0) {
+		DH_ERROR(dh, "Failed to init camera thread");
+		u_device_free(&dh->base);
+		return NULL;
+	}
 
 	// Print name.
 	snprintf(dh->base.str, XRT_DEVICE_NAME_LEN, "Simulated HMD");
@@ -29,6 +29,9 @@
 #include <linux/v4l2-common.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <errno.h>
 #include <fcntl.h>
 
 
@@ -58,6 +61,8 @@
 
 DEBUG_GET_ONCE_LOG_OPTION(v4l2_log, "V4L2_LOG", U_LOGGING_WARN)
 DEBUG_GET_ONCE_NUM_OPTION(v4l2_exposure_absolute, "V4L2_EXPOSURE_ABSOLUTE", 10)
+DEBUG_GET_ONCE_NUM_OPTION(v4l2_buffers, "V4L2_BUFFERS", NUM_V4L2_BUFFERS)
+DEBUG_GET_ONCE_BOOL_OPTION(v4l2_dmabuf, "V4L2_DMABUF", false)
 
 /*!
  * Streaming thread entrypoint
@@ -300,6 +305,23 @@ v4l2_setup_mmap_buffer(struct v4l2_fs *vid, struct v4l2_frame *vf, struct v4l2_b
 	return 0;
 }
 
+static void
+v4l2_export_dmabuf(struct v4l2_fs *vid, struct v4l2_frame *vf, struct v4l2_buffer *v_buf)
+{
+	struct v4l2_exportbuffer expbuf = {0};
+	expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	expbuf.index = v_buf->index;
+	expbuf.flags = O_RDONLY | O_CLOEXEC;
+
+	if (ioctl(vid->fd, VIDIOC_EXPBUF, &expbuf) < 0) {
+		V4L2_WARN(vid, "warning: Could not export buffer %u as dmabuf, frames will only have memory.",
+		          v_buf->index);
+		return;
+	}
+
+	vf->dmabuf_fd = expbuf.fd;
+}
+
 static int
 v4l2_setup_userptr_buffer(struct v4l2_fs *vid, struct v4l2_frame *vf, struct v4l2_buffer *v_buf)
 {
@@ -455,11 +477,19 @@ v4l2_set_control_if_diff(struct v4l2_fs *vid, struct v4l2_control_state *state)
 		return;
 	}
 
+	// Nothing changed since we last talked to the device, no ioctls needed.
+	if (state->value_known && state->value == want->value && state->force <= 0) {
+		return;
+	}
+
 	ret = v4l2_control_get(vid, state->id, &value);
 	if (ret != 0) {
 		return;
 	}
 
+	state->value = value;
+	state->value_known = true;
+
 	if (value == want->value && state->force <= 0) {
 		return;
 	}
@@ -479,6 +509,8 @@ v4l2_set_control_if_diff(struct v4l2_fs *vid, struct v4l2_control_state *state)
 		return;
 	}
 
+	state->value = want->value;
+
 	if (state->force > 0) {
 		state->force--;
 	}
@@ -578,6 +610,17 @@ v4l2_fs_stream_start(struct xrt_fs *xfs,
 	vid->is_running = true;
 	vid->capture_type = capture_type;
 
+	// The capture type selects other wanted values, read them back again.
+	for (size_t i = 0; i < vid->num_states; i++) {
+		vid->states[i].value_known = false;
+	}
+
+	// Drain any wakeup left from an earlier stop.
+	uint64_t stop_count = 0;
+	while (read(vid->stop_fd, &stop_count, sizeof(stop_count)) > 0) {
+		continue;
+	}
+
 	if (!v4l2_fs_setup_format(vid)) {
 		vid->is_running = false;
 		return false;
@@ -605,6 +648,13 @@ v4l2_fs_stream_stop(struct xrt_fs *xfs)
 	}
 
 	vid->is_running = false;
+
+	// Wake the capture thread, no need to wait for the next frame.
+	uint64_t stop_count = 1;
+	if (write(vid->stop_fd, &stop_count, sizeof(stop_count)) < 0) {
+		V4L2_ERROR(vid, "error: Failed to wake capture thread!");
+	}
+
 	pthread_join(vid->stream_thread, NULL);
 
 	return true;
@@ -634,6 +684,13 @@ v4l2_fs_destroy(struct v4l2_fs *vid)
 		vid->num_descriptors = 0;
 	}
 
+	for (uint32_t i = 0; i < NUM_V4L2_BUFFERS; i++) {
+		if (vid->frames[i].dmabuf_fd >= 0) {
+			close(vid->frames[i].dmabuf_fd);
+			vid->frames[i].dmabuf_fd = -1;
+		}
+	}
+
 	vid->capture.mmap = false;
 	if (vid->capture.userptr) {
 		vid->capture.userptr = false;
@@ -648,6 +705,11 @@ v4l2_fs_destroy(struct v4l2_fs *vid)
 		vid->fd = -1;
 	}
 
+	if (vid->stop_fd >= 0) {
+		close(vid->stop_fd);
+		vid->stop_fd = -1;
+	}
+
 	free(vid);
 }
 
@@ -681,13 +743,20 @@ v4l2_fs_create(struct xrt_frame_context *xfctx,
 	vid->node.break_apart = v4l2_fs_node_break_apart;
 	vid->node.destroy = v4l2_fs_node_destroy;
 	vid->log_level = debug_get_log_option_v4l2_log();
+	vid->capture.dmabuf = debug_get_bool_option_v4l2_dmabuf();
 	vid->fd = -1;
+	vid->stop_fd = -1;
+
+	for (uint32_t i = 0; i < NUM_V4L2_BUFFERS; i++) {
+		vid->frames[i].dmabuf_fd = -1;
+	}
 
 	snprintf(vid->base.product, sizeof(vid->base.product), "%s", product);
 	snprintf(vid->base.manufacturer, sizeof(vid->base.manufacturer), "%s", manufacturer);
 	snprintf(vid->base.serial, sizeof(vid->base.serial), "%s", serial);
 
-	int fd = open(path, O_RDWR, 0);
+	// Non-blocking, the capture thread polls before dequeuing.
+	int fd = open(path, O_RDWR | O_NONBLOCK, 0);
 	if (fd < 0) {
 		V4L2_ERROR(vid, "Cannot open '%s'", path);
 		free(vid);
@@ -696,6 +765,13 @@ v4l2_fs_create(struct xrt_frame_context *xfctx,
 
 	vid->fd = fd;
 
+	vid->stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (vid->stop_fd < 0) {
+		V4L2_ERROR(vid, "Cannot create stop eventfd");
+		v4l2_fs_destroy(vid);
+		return NULL;
+	}
+
 	int ret = v4l2_query_cap_and_validate(vid);
 	if (ret != 0) {
 		v4l2_fs_destroy(vid);
@@ -721,6 +797,82 @@ v4l2_fs_create(struct xrt_frame_context *xfctx,
 	return &(vid->base);
 }
 
+/*!
+ * Waits until a buffer can be dequeued, returns false if the thread should
+ * stop. Woken up by @ref v4l2_fs::stop_fd so stopping does not have to wait
+ * for the next frame.
+ */
+static bool
+v4l2_wait_for_frame(struct v4l2_fs *vid, int epoll_fd)
+{
+	bool logged = false;
+
+	while (vid->is_running) {
+		struct epoll_event events[2];
+		int count = epoll_wait(epoll_fd, events, ARRAY_SIZE(events), -1);
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count < 0) {
+			V4L2_ERROR(vid, "error: epoll_wait failed!");
+			return false;
+		}
+
+		bool readable = false;
+		for (int i = 0; i < count; i++) {
+			if (events[i].data.fd == vid->stop_fd) {
+				return false;
+			}
+
+			// The device reports an error when there are no buffers queued.
+			if ((events[i].events & EPOLLERR) != 0) {
+				if (!logged) {
+					V4L2_ERROR(vid, "No frames left");
+					logged = true;
+				}
+				os_nanosleep(U_TIME_1MS_IN_NS);
+				continue;
+			}
+
+			readable = readable || (events[i].events & EPOLLIN) != 0;
+		}
+
+		if (readable) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int
+v4l2_create_epoll(struct v4l2_fs *vid)
+{
+	int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd < 0) {
+		V4L2_ERROR(vid, "error: Could not create epoll!");
+		return -1;
+	}
+
+	struct epoll_event event = {0};
+	event.events = EPOLLIN;
+	event.data.fd = vid->fd;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, vid->fd, &event) < 0) {
+		V4L2_ERROR(vid, "error: Could not poll device!");
+		close(epoll_fd);
+		return -1;
+	}
+
+	event.data.fd = vid->stop_fd;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, vid->stop_fd, &event) < 0) {
+		V4L2_ERROR(vid, "error: Could not poll stop eventfd!");
+		close(epoll_fd);
+		return -1;
+	}
+
+	return epoll_fd;
+}
+
 void *
 v4l2_fs_mainloop(void *ptr)
 {
@@ -739,20 +891,40 @@ v4l2_fs_mainloop(void *ptr)
 	struct v4l2_source_descriptor *desc = &vid->descriptors[vid->selected];
 
 	// set up our buffers - prefer userptr (client alloc) vs mmap (kernel
-	// alloc)
+	// alloc), unless we want to export them as dmabufs which needs mmap.
 	// TODO: using buffer caps may be better than 'fallthrough to mmap'
+	long count = debug_get_num_option_v4l2_buffers();
+	if (count < 2 || count > NUM_V4L2_BUFFERS) {
+		V4L2_WARN(vid, "warning: V4L2_BUFFERS must be between 2 and %i.", NUM_V4L2_BUFFERS);
+		count = NUM_V4L2_BUFFERS;
+	}
+
 	struct v4l2_requestbuffers v_bufrequest;
 	U_ZERO(&v_bufrequest);
-	v_bufrequest.count = NUM_V4L2_BUFFERS;
+	v_bufrequest.count = (uint32_t)count;
 	v_bufrequest.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 
-	if (v4l2_try_userptr(vid, &v_bufrequest) != 0 && v4l2_try_mmap(vid, &v_bufrequest) != 0) {
+	int ret;
+	if (vid->capture.dmabuf) {
+		ret = v4l2_try_mmap(vid, &v_bufrequest) == 0 ? 0 : v4l2_try_userptr(vid, &v_bufrequest);
+	} else {
+		ret = v4l2_try_userptr(vid, &v_bufrequest) == 0 ? 0 : v4l2_try_mmap(vid, &v_bufrequest);
+	}
+	if (ret != 0) {
 		V4L2_ERROR(vid, "error: Driver does not support mmap or userptr.");
 		return NULL;
 	}
 
+	// The driver is allowed to change the count.
+	vid->num_buffers = v_bufrequest.count < NUM_V4L2_BUFFERS ? v_bufrequest.count : NUM_V4L2_BUFFERS;
+	if (vid->num_buffers == 0) {
+		V4L2_ERROR(vid, "error: Driver gave us no buffers!");
+		return NULL;
+	}
 
-	for (uint32_t i = 0; i < NUM_V4L2_BUFFERS; i++) {
+	V4L2_DEBUG(vid, "info: Using %u buffers.", vid->num_buffers);
+
+	for (uint32_t i = 0; i < vid->num_buffers; i++) {
 		struct v4l2_frame *vf = &vid->frames[i];
 		struct v4l2_buffer *v_buf = &vf->v_buf;
 
@@ -774,9 +946,14 @@ v4l2_fs_mainloop(void *ptr)
 		if (vid->capture.mmap && v4l2_setup_mmap_buffer(vid, vf, v_buf) != 0) {
 			return NULL;
 		}
+		if (vid->capture.mmap && vid->capture.dmabuf && vf->dmabuf_fd < 0) {
+			v4l2_export_dmabuf(vid, vf, v_buf);
+		}
 
 		// Silence valgrind.
-		memset(vf->mem, 0, v_buf->length);
+		if (vid->capture.userptr) {
+			memset(vf->mem, 0, v_buf->length);
+		}
 
 		// Queue this buffer
 		if (ioctl(vid->fd, VIDIOC_QBUF, v_buf) < 0) {
@@ -785,9 +962,15 @@ v4l2_fs_mainloop(void *ptr)
 		}
 	}
 
+	int epoll_fd = v4l2_create_epoll(vid);
+	if (epoll_fd < 0) {
+		return NULL;
+	}
+
 	int start_capture = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 	if (ioctl(vid->fd, VIDIOC_STREAMON, &start_capture) < 0) {
 		V4L2_ERROR(vid, "error: Could not start capture!");
+		close(epoll_fd);
 		return NULL;
 	}
 
@@ -800,17 +983,18 @@ v4l2_fs_mainloop(void *ptr)
 	v_buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 	v_buf.memory = v_bufrequest.memory;
 
-	while (vid->is_running) {
-		if (vid->used_frames == NUM_V4L2_BUFFERS) {
-			V4L2_ERROR(vid, "No frames left");
-		}
-
+	while (v4l2_wait_for_frame(vid, epoll_fd)) {
 		if (ioctl(vid->fd, VIDIOC_DQBUF, &v_buf) < 0) {
+			if (errno == EAGAIN) {
+				continue;
+			}
+
 			V4L2_ERROR(vid, "error: Dequeue failed!");
 			vid->is_running = false;
 			break;
 		}
 
+		// Only talks to the device if a wanted value changed.
 		v4l2_update_controls(vid);
 
 		SINK_TRACE_IDENT(v4l2_fs_frame);
@@ -836,6 +1020,10 @@ v4l2_fs_mainloop(void *ptr)
 		xf->source_id = vid->base.source_id;
 		xf->source_sequence = v_buf.sequence;
 
+		xf->has_buffer_handle = vf->dmabuf_fd >= 0;
+		xf->buffer_handle = vf->dmabuf_fd;
+		xf->buffer_offset = desc->offset;
+
 		if ((v_buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) != 0) {
 			xf->timestamp = os_timeval_to_ns(&v_buf.timestamp);
 			xf->source_timestamp = xf->timestamp;
@@ -853,6 +1041,8 @@ v4l2_fs_mainloop(void *ptr)
 		xrt_frame_reference(&xf, NULL);
 	}
 
+	close(epoll_fd);
+
 	V4L2_DEBUG(vid, "info: Thread leave!");
 
 	return NULL;
@@ -27,6 +27,7 @@
 #define V4L2_WARN(d, ...) U_LOG_IFL_W(d->log_level, __VA_ARGS__)
 #define V4L2_ERROR(d, ...) U_LOG_IFL_E(d->log_level, __VA_ARGS__)
 
+//! Max number of buffers, the driver might give us fewer.
 #define NUM_V4L2_BUFFERS 32
 
 
@@ -46,6 +47,9 @@ struct v4l2_frame
 
 	void *mem; //!< Data might be at an offset, so we need base memory.
 
+	//! Exported with VIDIOC_EXPBUF, -1 if not exported.
+	int dmabuf_fd;
+
 	struct v4l2_buffer v_buf;
 };
 
@@ -65,8 +69,12 @@ struct v4l2_control_state
 
 	struct v4l2_state_want want[2];
 
+	//! Last value written to or read from the device.
 	int value;
 
+	//! Is @ref value known, reset when a stream is started.
+	bool value_known;
+
 	const char *name;
 };
 
@@ -86,6 +94,9 @@ struct v4l2_fs
 
 	int fd;
 
+	//! Written to wake the capture thread when stopping.
+	int stop_fd;
+
 	struct
 	{
 		bool extended_format;
@@ -102,12 +113,16 @@ struct v4l2_fs
 	} quirks;
 
 	struct v4l2_frame frames[NUM_V4L2_BUFFERS];
+	uint32_t num_buffers;
 	uint32_t used_frames;
 
 	struct
 	{
 		bool mmap;
 		bool userptr;
+
+		//! Prefer mmap and export the buffers as dmabufs.
+		bool dmabuf;
 	} capture;
 
 	struct xrt_frame_sink *sink;
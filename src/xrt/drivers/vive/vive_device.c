@@ -31,11 +31,14 @@
 
 #include "vive.h"
 #include "vive_device.h"
+#include "vive_lighthouse_solver.h"
 #include "vive_protocol.h"
 #include "vive_source.h"
 #include "xrt/xrt_tracking.h"
 
 
+DEBUG_GET_ONCE_BOOL_OPTION(vive_lighthouse, "VIVE_LIGHTHOUSE", false)
+
 static bool
 vive_mainboard_power_off(struct vive_device *d);
 
@@ -63,6 +66,8 @@ vive_device_destroy(struct xrt_device *xdev)
 
 	m_imu_3dof_close(&d->fusion.i3dof);
 
+	lighthouse_solver_destroy(&d->fusion.solver);
+
 	os_mutex_destroy(&d->fusion.mutex);
 
 	if (d->mainboard_dev != NULL) {
@@ -121,9 +126,14 @@ vive_device_get_3dof_tracked_pose(struct xrt_device *xdev,
 	m_relation_history_get(d->fusion.relation_hist, at_timestamp_ns, &relation);
 	os_mutex_unlock(&d->fusion.mutex);
 
+	// Positions only come from the lighthouse solver.
+	bool have_position = (relation.relation_flags & XRT_SPACE_RELATION_POSITION_VALID_BIT) != 0;
+
 	relation.relation_flags = XRT_SPACE_RELATION_BITMASK_ALL; // Needed after history_get
-	relation.pose.position = d->pose.position;
-	relation.linear_velocity = (struct xrt_vec3){0, 0, 0};
+	if (!have_position) {
+		relation.pose.position = d->pose.position;
+		relation.linear_velocity = (struct xrt_vec3){0, 0, 0};
+	}
 
 	*out_relation = relation;
 	d->pose = out_relation->pose;
@@ -443,7 +453,12 @@ update_imu(struct vive_device *d, const void *buffer)
 
 		os_mutex_lock(&d->fusion.mutex);
 		m_imu_3dof_update(&d->fusion.i3dof, d->imu.last_sample_ts_ns, &acceleration, &angular_velocity);
-		rel.pose.orientation = d->fusion.i3dof.rot;
+		if (d->fusion.solver != NULL) {
+			lighthouse_solver_push_imu(d->fusion.solver, d->imu.last_sample_ticks, d->imu.last_sample_ts_ns,
+			                           &d->fusion.i3dof.rot, &rel);
+		} else {
+			rel.pose.orientation = d->fusion.i3dof.rot;
+		}
 		m_relation_history_push(d->fusion.relation_hist, &rel, now_ns);
 		os_mutex_unlock(&d->fusion.mutex);
 
@@ -1115,6 +1130,15 @@ vive_device_create(struct os_hid_device *mainboard_dev,
 		}
 	}
 
+	if (watchman_dev != NULL && debug_get_bool_option_vive_lighthouse()) {
+		if (d->config.lh.sensor_count > 0) {
+			d->fusion.solver = lighthouse_solver_create(d->config.lh.sensors, d->config.lh.sensor_count);
+			d->watchman.solver = d->fusion.solver;
+		} else {
+			VIVE_WARN(d, "No lighthouse sensors in the config, not tracking position.");
+		}
+	}
+
 	if (d->mainboard_dev) {
 		ret = os_thread_helper_start(&d->mainboard_thread, vive_mainboard_run_thread, d);
 		if (ret != 0) {
@@ -81,6 +81,9 @@ struct vive_device
 
 		//! Prediction
 		struct m_relation_history *relation_hist;
+
+		//! Optical tracking from the lighthouse sweeps, NULL if disabled.
+		struct lighthouse_solver *solver;
 	} fusion;
 
 	//! Fields related to camera-based tracking (SLAM and hand tracking)
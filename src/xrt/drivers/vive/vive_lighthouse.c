@@ -19,6 +19,7 @@
 #include "util/u_logging.h"
 
 #include "vive_lighthouse.h"
+#include "vive_lighthouse_solver.h"
 
 static enum u_logging_level log_level;
 
@@ -302,8 +303,6 @@ lighthouse_base_handle_frame(struct lighthouse_watchman *watchman,
 {
 	struct lighthouse_frame *frame = &base->frame[base->active_rotor];
 
-	(void)watchman;
-
 	if (!frame->sweep_ids)
 		return;
 
@@ -316,7 +315,10 @@ lighthouse_base_handle_frame(struct lighthouse_watchman *watchman,
 	if (frame->frame_duration > 1000000)
 		return;
 
-	// telemetry_send_lighthouse_frame(watchman->id, frame);
+	if (watchman->solver != NULL) {
+		uint32_t base_index = (uint32_t)(base - watchman->base);
+		lighthouse_solver_push_frame(watchman->solver, base_index, base, base->active_rotor, frame);
+	}
 }
 
 /*
@@ -538,5 +540,6 @@ lighthouse_watchman_init(struct lighthouse_watchman *watchman, const char *name)
 	watchman->last_timestamp = 0;
 	watchman->last_sync.timestamp = 0;
 	watchman->last_sync.duration = 0;
+	watchman->solver = NULL;
 	log_level = debug_get_log_option_vive_log();
 }
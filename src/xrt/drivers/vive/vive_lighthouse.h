@@ -19,6 +19,8 @@
 
 #include "xrt/xrt_defines.h"
 
+struct lighthouse_solver;
+
 struct lighthouse_rotor_calibration
 {
 	float tilt;
@@ -98,6 +100,9 @@ struct lighthouse_watchman
 	struct lighthouse_sensor sensor[32];
 	struct lighthouse_pulse last_sync;
 	bool sync_lock;
+
+	//! Optional, gets every finished sweep.
+	struct lighthouse_solver *solver;
 };
 
 void
@@ -0,0 +1,726 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Lighthouse pose solver, turns decoded sweeps into 6DoF poses.
+ * @author agent <agent@local>
+ * @ingroup drv_vive
+ */
+
+#include "xrt/xrt_defines.h"
+
+#include "os/os_threading.h"
+
+#include "math/m_api.h"
+#include "math/m_mathinclude.h"
+
+#include "util/u_misc.h"
+#include "util/u_time.h"
+
+#include "vive/vive_config.h"
+
+#include "vive_lighthouse.h"
+#include "vive_lighthouse_solver.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ *
+ * Defines
+ *
+ */
+
+//! The watchman decoder only tracks this many sensors.
+#define MAX_SENSORS (32)
+
+//! Both rotors of every sensor.
+#define MAX_MEASUREMENTS (MAX_SENSORS * 2)
+
+//! A full 6DoF solve needs this many sensors seen by both rotors.
+#define MIN_SENSORS_FULL (4)
+
+//! A full 6DoF solve needs this many angles, a few more than unknowns.
+#define MIN_MEASUREMENTS_FULL (8)
+
+//! With the orientation taken from the IMU only the position is solved for.
+#define MIN_MEASUREMENTS_POSITION (3)
+
+//! Root mean square angle error, in radians, above which a solve is thrown away.
+#define MAX_RESIDUAL (0.01)
+
+//! Sensors closer than this to the base station plane, in meters, are not plausible.
+#define MIN_DEPTH (0.05)
+
+//! Sweeps of the two rotors further apart than this are not combined, two revolutions covers two bases.
+#define MAX_SWEEP_AGE_TICKS (LIGHTHOUSE_TICKS_PER_REVOLUTION * 2)
+
+//! Levenberg-Marquardt iterations per solve.
+#define MAX_ITERATIONS (20)
+
+//! How much of the difference between the optical and IMU orientation is corrected per solve.
+#define ORIENTATION_GAIN (0.05f)
+
+//! How far the position is extrapolated after the last solve before it is dropped.
+#define POSITION_TIMEOUT_NS (100 * U_TIME_1MS_IN_NS)
+
+//! A second base station is only placed using a solve at most this old.
+#define BOOTSTRAP_MAX_AGE_NS (50 * U_TIME_1MS_IN_NS)
+
+//! Same 48 MHz clock as VIVE_CLOCK_FREQ.
+#define NS_PER_TICK ((double)U_TIME_1S_IN_NS / 48e6)
+
+
+/*
+ *
+ * Structs
+ *
+ */
+
+//! One sweep angle of one sensor.
+struct measurement
+{
+	//! Sensor position in device space.
+	struct xrt_vec3 point;
+
+	//! Sensor normal in device space.
+	struct xrt_vec3 normal;
+
+	//! 0 for the horizontal rotor, 1 for the vertical one.
+	uint32_t rotor;
+
+	//! Angle in radians, zero is straight out of the base station.
+	double angle;
+};
+
+struct solver_base
+{
+	//! Pose of the base station in tracking space, valid if @ref known.
+	struct xrt_pose pose;
+	bool known;
+
+	//! Latest angles of each rotor, indexed by sensor.
+	double angles[2][MAX_SENSORS];
+	uint32_t sensor_mask[2];
+	uint32_t sync_ticks[2];
+	bool have_sweep[2];
+};
+
+struct lighthouse_solver
+{
+	struct os_mutex mutex;
+
+	struct xrt_vec3 points[MAX_SENSORS];
+	struct xrt_vec3 normals[MAX_SENSORS];
+	uint32_t sensor_count;
+
+	struct solver_base base[2];
+
+	//! Watchman clock to system time, from the last IMU sample.
+	struct
+	{
+		bool valid;
+		uint32_t ticks;
+		timepoint_ns ns;
+	} clock;
+
+	//! Latest orientation of the IMU 3DoF fusion.
+	struct xrt_quat imu_rot;
+	bool have_imu;
+
+	//! Takes the IMU orientation into tracking space.
+	struct xrt_quat correction;
+
+	//! Latest solved device pose, in tracking space.
+	struct xrt_pose pose;
+	struct xrt_vec3 velocity;
+	timepoint_ns pose_ns;
+	bool have_pose;
+
+	struct lighthouse_solver_stats stats;
+};
+
+
+/*
+ *
+ * Math helpers.
+ *
+ */
+
+static timepoint_ns
+ticks_to_ns(const struct lighthouse_solver *solver, uint32_t ticks)
+{
+	// The sweeps are older than the newest IMU sample, wrapping is handled by the cast.
+	int32_t delta = (int32_t)(ticks - solver->clock.ticks);
+	return solver->clock.ns + (timepoint_ns)((double)delta * NS_PER_TICK);
+}
+
+static double
+ticks_to_angle(double ticks)
+{
+	return (ticks - LIGHTHOUSE_TICKS_CENTER) * (2.0 * M_PI) / LIGHTHOUSE_TICKS_PER_REVOLUTION;
+}
+
+/*!
+ * Solves A x = b for a symmetric positive definite A, only the top left
+ * @p n by @p n part is used.
+ */
+static bool
+solve_cholesky(double A[6][6], const double b[6], uint32_t n, double out_x[6])
+{
+	double L[6][6] = {{0}};
+	double y[6] = {0};
+
+	for (uint32_t i = 0; i < n; i++) {
+		for (uint32_t j = 0; j <= i; j++) {
+			double sum = A[i][j];
+			for (uint32_t k = 0; k < j; k++) {
+				sum -= L[i][k] * L[j][k];
+			}
+
+			if (i != j) {
+				L[i][j] = sum / L[j][j];
+			} else if (sum > 0.0) {
+				L[i][i] = sqrt(sum);
+			} else {
+				return false;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < n; i++) {
+		double sum = b[i];
+		for (uint32_t k = 0; k < i; k++) {
+			sum -= L[i][k] * y[k];
+		}
+		y[i] = sum / L[i][i];
+	}
+
+	for (uint32_t i = n; i-- > 0;) {
+		double sum = y[i];
+		for (uint32_t k = i + 1; k < n; k++) {
+			sum -= L[k][i] * out_x[k];
+		}
+		out_x[i] = sum / L[i][i];
+	}
+
+	return true;
+}
+
+/*!
+ * Sum of the squared angle errors of the device at @p pose in base station
+ * space, the base station looks down -Z. If @p JtJ is not NULL the normal
+ * equations for the first @p n unknowns, translation then rotation, are
+ * accumulated as well. Returns false if a sensor ends up behind the base.
+ */
+static bool
+linearize(const struct measurement *m,
+          uint32_t count,
+          const struct xrt_pose *pose,
+          uint32_t n,
+          double JtJ[6][6],
+          double Jtr[6],
+          double *out_cost)
+{
+	double cost = 0.0;
+
+	for (uint32_t i = 0; i < count; i++) {
+		struct xrt_vec3 a;
+		math_quat_rotate_vec3(&pose->orientation, &m[i].point, &a);
+
+		double x = (double)a.x + pose->position.x;
+		double y = (double)a.y + pose->position.y;
+		double z = (double)a.z + pose->position.z;
+
+		if (-z < MIN_DEPTH) {
+			return false;
+		}
+
+		double predicted;
+		double jq[3];
+		if (m[i].rotor == 0) {
+			double d = x * x + z * z;
+			predicted = atan2(x, -z);
+			jq[0] = -z / d;
+			jq[1] = 0.0;
+			jq[2] = x / d;
+		} else {
+			double d = y * y + z * z;
+			predicted = atan2(y, -z);
+			jq[0] = 0.0;
+			jq[1] = -z / d;
+			jq[2] = y / d;
+		}
+
+		double r = m[i].angle - predicted;
+		cost += r * r;
+
+		if (JtJ == NULL) {
+			continue;
+		}
+
+		// Translation moves the point directly, a small rotation w moves it by w x a.
+		double j[6] = {
+		    jq[0],
+		    jq[1],
+		    jq[2],
+		    a.y * jq[2] - a.z * jq[1],
+		    a.z * jq[0] - a.x * jq[2],
+		    a.x * jq[1] - a.y * jq[0],
+		};
+
+		for (uint32_t row = 0; row < n; row++) {
+			Jtr[row] += j[row] * r;
+			for (uint32_t col = 0; col < n; col++) {
+				JtJ[row][col] += j[row] * j[col];
+			}
+		}
+	}
+
+	*out_cost = cost;
+
+	return true;
+}
+
+static void
+apply_step(const struct xrt_pose *pose, const double step[6], uint32_t n, struct xrt_pose *out_pose)
+{
+	struct xrt_pose result = *pose;
+
+	result.position.x += (float)step[0];
+	result.position.y += (float)step[1];
+	result.position.z += (float)step[2];
+
+	if (n == 6) {
+		// math_quat_exp takes half of the rotation vector.
+		struct xrt_vec3 half = {(float)step[3] * 0.5f, (float)step[4] * 0.5f, (float)step[5] * 0.5f};
+		struct xrt_quat delta;
+		math_quat_exp(&half, &delta);
+		math_quat_rotate(&delta, &pose->orientation, &result.orientation);
+		math_quat_normalize(&result.orientation);
+	}
+
+	*out_pose = result;
+}
+
+/*!
+ * Levenberg-Marquardt refinement of the pose of the device in base station
+ * space, the orientation is only changed if @p rotation is set.
+ */
+static bool
+solve_pose(const struct measurement *m,
+           uint32_t count,
+           bool rotation,
+           struct xrt_pose *inout_pose,
+           double *out_residual)
+{
+	const uint32_t n = rotation ? 6 : 3;
+	struct xrt_pose pose = *inout_pose;
+	double lambda = 1e-3;
+	double cost;
+
+	if (!linearize(m, count, &pose, n, NULL, NULL, &cost)) {
+		return false;
+	}
+
+	for (int iter = 0; iter < MAX_ITERATIONS; iter++) {
+		double JtJ[6][6] = {{0}};
+		double Jtr[6] = {0};
+		double unused;
+		linearize(m, count, &pose, n, JtJ, Jtr, &unused);
+
+		bool accepted = false;
+		double step_size = 0.0;
+
+		for (int tries = 0; tries < 8 && !accepted; tries++) {
+			double A[6][6];
+			memcpy(A, JtJ, sizeof(A));
+			for (uint32_t k = 0; k < n; k++) {
+				A[k][k] += lambda * JtJ[k][k] + 1e-12;
+			}
+
+			double step[6] = {0};
+			if (!solve_cholesky(A, Jtr, n, step)) {
+				lambda *= 10.0;
+				continue;
+			}
+
+			struct xrt_pose candidate;
+			apply_step(&pose, step, n, &candidate);
+
+			double candidate_cost;
+			if (linearize(m, count, &candidate, n, NULL, NULL, &candidate_cost) && candidate_cost < cost) {
+				pose = candidate;
+				cost = candidate_cost;
+				lambda = lambda * 0.1 < 1e-9 ? 1e-9 : lambda * 0.1;
+				accepted = true;
+
+				step_size = 0.0;
+				for (uint32_t k = 0; k < n; k++) {
+					step_size += step[k] * step[k];
+				}
+			} else {
+				lambda *= 10.0;
+			}
+		}
+
+		if (!accepted || step_size < 1e-14) {
+			break;
+		}
+	}
+
+	*inout_pose = pose;
+	*out_residual = sqrt(cost / count);
+
+	return true;
+}
+
+//! The sensors can only see the base station if they are facing it.
+static bool
+facing_base(const struct measurement *m, uint32_t count, const struct xrt_pose *pose)
+{
+	uint32_t facing = 0;
+
+	for (uint32_t i = 0; i < count; i++) {
+		struct xrt_vec3 p;
+		struct xrt_vec3 normal;
+		math_pose_transform_point(pose, &m[i].point, &p);
+		math_quat_rotate_vec3(&pose->orientation, &m[i].normal, &normal);
+
+		// The base station is at the origin.
+		if (-(p.x * normal.x + p.y * normal.y + p.z * normal.z) > 0.0f) {
+			facing++;
+		}
+	}
+
+	return facing * 4 >= count * 3;
+}
+
+/*!
+ * Nothing is known about where the device is relative to a base station, try
+ * a few starting poses around the front of it and keep the best.
+ */
+static bool
+solve_pose_from_scratch(const struct measurement *m,
+                        uint32_t count,
+                        struct xrt_pose *out_pose,
+                        double *out_residual)
+{
+	static const float yaws[4] = {0.0f, (float)M_PI * 0.5f, (float)M_PI, (float)M_PI * 1.5f};
+	static const float distances[2] = {1.5f, 3.5f};
+	const struct xrt_vec3 up = {0.0f, 1.0f, 0.0f};
+
+	bool found = false;
+	double best = MAX_RESIDUAL;
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(yaws); i++) {
+		for (uint32_t k = 0; k < ARRAY_SIZE(distances); k++) {
+			struct xrt_pose pose = XRT_POSE_IDENTITY;
+			math_quat_from_angle_vector(yaws[i], &up, &pose.orientation);
+			pose.position.z = -distances[k];
+
+			double residual;
+			if (!solve_pose(m, count, true, &pose, &residual)) {
+				continue;
+			}
+			if (residual >= best || !facing_base(m, count, &pose)) {
+				continue;
+			}
+
+			best = residual;
+			*out_pose = pose;
+			*out_residual = residual;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+
+/*
+ *
+ * Solver.
+ *
+ */
+
+static uint32_t
+gather_measurements(const struct lighthouse_solver *solver,
+                    const struct solver_base *sb,
+                    uint32_t rotor,
+                    struct measurement out_m[MAX_MEASUREMENTS],
+                    uint32_t *out_sensor_count)
+{
+	uint32_t other = 1 - rotor;
+	uint32_t masks[2] = {0, 0};
+	masks[rotor] = sb->sensor_mask[rotor];
+
+	// The sweeps of the two rotors are 8.3 ms apart, the other one is only used if it is the previous one.
+	uint32_t age = sb->sync_ticks[rotor] - sb->sync_ticks[other];
+	if (sb->have_sweep[other] && age < MAX_SWEEP_AGE_TICKS) {
+		masks[other] = sb->sensor_mask[other];
+	}
+
+	uint32_t count = 0;
+	for (uint32_t r = 0; r < 2; r++) {
+		for (uint32_t id = 0; id < solver->sensor_count; id++) {
+			if ((masks[r] & (1u << id)) == 0) {
+				continue;
+			}
+
+			out_m[count].point = solver->points[id];
+			out_m[count].normal = solver->normals[id];
+			out_m[count].rotor = r;
+			out_m[count].angle = sb->angles[r][id];
+			count++;
+		}
+	}
+
+	// One rotor alone only gives one angle per sensor, far too weak for the orientation.
+	uint32_t seen = masks[0] & masks[1];
+	uint32_t sensors = 0;
+	for (; seen != 0; seen &= seen - 1) {
+		sensors++;
+	}
+
+	*out_sensor_count = sensors;
+
+	return count;
+}
+
+static bool
+other_base_known(const struct lighthouse_solver *solver, uint32_t base_index)
+{
+	return solver->base[1 - base_index].known;
+}
+
+static void
+solve_locked(struct lighthouse_solver *solver, uint32_t base_index, uint32_t rotor)
+{
+	struct solver_base *sb = &solver->base[base_index];
+
+	// Needs the IMU for the clock and to anchor the tracking space.
+	if (!solver->clock.valid || !solver->have_imu) {
+		return;
+	}
+
+	struct measurement m[MAX_MEASUREMENTS];
+	uint32_t sensors = 0;
+	uint32_t count = gather_measurements(solver, sb, rotor, m, &sensors);
+	bool full = sensors >= MIN_SENSORS_FULL && count >= MIN_MEASUREMENTS_FULL;
+
+	// Middle of the sweep.
+	timepoint_ns ts = ticks_to_ns(solver, sb->sync_ticks[rotor] + LIGHTHOUSE_TICKS_CENTER);
+
+	struct xrt_quat rot;
+	math_quat_rotate(&solver->correction, &solver->imu_rot, &rot);
+
+	bool recent = solver->have_pose && (ts - solver->pose_ns) < BOOTSTRAP_MAX_AGE_NS;
+
+	struct xrt_pose in_base = XRT_POSE_IDENTITY;
+	double residual = 0.0;
+	bool ok = false;
+
+	if (sb->known) {
+		// Start from the current estimate, or straight in front of the base if lost.
+		struct xrt_pose inv_base;
+		math_pose_invert(&sb->pose, &inv_base);
+
+		struct xrt_pose device = {rot, solver->pose.position};
+		math_pose_transform(&inv_base, &device, &in_base);
+		if (!recent) {
+			in_base.position = (struct xrt_vec3){0.0f, 0.0f, -2.0f};
+		}
+
+		if (full) {
+			ok = solve_pose(m, count, true, &in_base, &residual);
+		} else if (count >= MIN_MEASUREMENTS_POSITION) {
+			ok = solve_pose(m, count, false, &in_base, &residual);
+		}
+	} else if (full && (!other_base_known(solver, base_index) || recent)) {
+		ok = solve_pose_from_scratch(m, count, &in_base, &residual);
+	}
+
+	if (!ok || residual > MAX_RESIDUAL) {
+		solver->stats.rejected++;
+		return;
+	}
+
+	struct xrt_pose device;
+	if (sb->known) {
+		math_pose_transform(&sb->pose, &in_base, &device);
+	} else {
+		/*
+		 * First solve against this base station, place it relative to
+		 * where the device is. For the very first base station that is
+		 * the origin of the tracking space.
+		 */
+		device.orientation = rot;
+		device.position = recent ? solver->pose.position : (struct xrt_vec3){0.0f, 0.0f, 0.0f};
+
+		struct xrt_pose inv_in_base;
+		math_pose_invert(&in_base, &inv_in_base);
+		math_pose_transform(&device, &inv_in_base, &sb->pose);
+		sb->known = true;
+	}
+
+	if (solver->have_pose && ts > solver->pose_ns && (ts - solver->pose_ns) < POSITION_TIMEOUT_NS) {
+		float dt = (float)time_ns_to_s(ts - solver->pose_ns);
+		struct xrt_vec3 v = device.position;
+		math_vec3_subtract(&solver->pose.position, &v);
+		math_vec3_scalar_mul(1.0f / dt, &v);
+
+		// Light smoothing, the sweeps are noisy and the two rotors are not simultaneous.
+		solver->velocity.x += (v.x - solver->velocity.x) * 0.3f;
+		solver->velocity.y += (v.y - solver->velocity.y) * 0.3f;
+		solver->velocity.z += (v.z - solver->velocity.z) * 0.3f;
+	} else {
+		solver->velocity = (struct xrt_vec3){0.0f, 0.0f, 0.0f};
+	}
+
+	solver->pose = device;
+	solver->pose_ns = ts;
+	solver->have_pose = true;
+
+	// Pull the IMU orientation towards the optical one, mostly fixes yaw drift.
+	struct xrt_quat inv_imu;
+	struct xrt_quat target;
+	math_quat_invert(&solver->imu_rot, &inv_imu);
+	math_quat_rotate(&device.orientation, &inv_imu, &target);
+	math_quat_slerp(&solver->correction, &target, ORIENTATION_GAIN, &solver->correction);
+	math_quat_normalize(&solver->correction);
+
+	solver->stats.solves++;
+	solver->stats.last_residual = (float)residual;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+struct lighthouse_solver *
+lighthouse_solver_create(const struct lh_sensor *sensors, uint32_t sensor_count)
+{
+	struct lighthouse_solver *solver = U_TYPED_CALLOC(struct lighthouse_solver);
+
+	if (os_mutex_init(&solver->mutex) != 0) {
+		free(solver);
+		return NULL;
+	}
+
+	// Sensor ids above 31 are never decoded.
+	solver->sensor_count = sensor_count > MAX_SENSORS ? MAX_SENSORS : sensor_count;
+	for (uint32_t i = 0; i < solver->sensor_count; i++) {
+		solver->points[i] = sensors[i].pos;
+		solver->normals[i] = sensors[i].normal;
+	}
+
+	solver->correction = (struct xrt_quat)XRT_QUAT_IDENTITY;
+	solver->imu_rot = (struct xrt_quat)XRT_QUAT_IDENTITY;
+	solver->pose = (struct xrt_pose)XRT_POSE_IDENTITY;
+
+	return solver;
+}
+
+void
+lighthouse_solver_destroy(struct lighthouse_solver **solver_ptr)
+{
+	struct lighthouse_solver *solver = *solver_ptr;
+	if (solver == NULL) {
+		return;
+	}
+
+	os_mutex_destroy(&solver->mutex);
+	free(solver);
+	*solver_ptr = NULL;
+}
+
+void
+lighthouse_solver_push_frame(struct lighthouse_solver *solver,
+                             uint32_t base_index,
+                             const struct lighthouse_base *base,
+                             uint32_t rotor,
+                             const struct lighthouse_frame *frame)
+{
+	if (base_index > 1 || rotor > 1) {
+		return;
+	}
+
+	os_mutex_lock(&solver->mutex);
+
+	struct solver_base *sb = &solver->base[base_index];
+	double phase = base->calibration.rotor[rotor].phase;
+
+	sb->sensor_mask[rotor] = 0;
+	for (uint32_t id = 0; id < solver->sensor_count; id++) {
+		if ((frame->sweep_ids & (1u << id)) == 0) {
+			continue;
+		}
+
+		// The middle of the pulse is when the laser crossed the sensor.
+		double center = frame->sweep_offset[id] + frame->sweep_duration[id] * 0.5;
+		sb->angles[rotor][id] = ticks_to_angle(center) - phase;
+		sb->sensor_mask[rotor] |= 1u << id;
+	}
+
+	sb->sync_ticks[rotor] = frame->sync_timestamp;
+	sb->have_sweep[rotor] = true;
+
+	solver->stats.sweeps++;
+	solve_locked(solver, base_index, rotor);
+
+	os_mutex_unlock(&solver->mutex);
+}
+
+void
+lighthouse_solver_push_imu(struct lighthouse_solver *solver,
+                           uint32_t ticks,
+                           timepoint_ns timestamp_ns,
+                           const struct xrt_quat *rot,
+                           struct xrt_space_relation *out_relation)
+{
+	os_mutex_lock(&solver->mutex);
+
+	solver->clock.valid = true;
+	solver->clock.ticks = ticks;
+	solver->clock.ns = timestamp_ns;
+	solver->imu_rot = *rot;
+	solver->have_imu = true;
+
+	struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+	rel.relation_flags = XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT;
+	math_quat_rotate(&solver->correction, rot, &rel.pose.orientation);
+
+	time_duration_ns age = timestamp_ns - solver->pose_ns;
+	if (solver->have_pose && age < POSITION_TIMEOUT_NS) {
+		struct xrt_vec3 delta = solver->velocity;
+		math_vec3_scalar_mul((float)time_ns_to_s(age), &delta);
+
+		rel.pose.position = solver->pose.position;
+		math_vec3_accum(&delta, &rel.pose.position);
+		rel.linear_velocity = solver->velocity;
+		rel.relation_flags |= XRT_SPACE_RELATION_POSITION_VALID_BIT |
+		                      XRT_SPACE_RELATION_POSITION_TRACKED_BIT |
+		                      XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT;
+	}
+
+	*out_relation = rel;
+
+	os_mutex_unlock(&solver->mutex);
+}
+
+void
+lighthouse_solver_get_stats(struct lighthouse_solver *solver, struct lighthouse_solver_stats *out_stats)
+{
+	os_mutex_lock(&solver->mutex);
+
+	*out_stats = solver->stats;
+	out_stats->base_known[0] = solver->base[0].known;
+	out_stats->base_known[1] = solver->base[1].known;
+
+	os_mutex_unlock(&solver->mutex);
+}
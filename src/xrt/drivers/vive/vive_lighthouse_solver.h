@@ -0,0 +1,115 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Lighthouse pose solver, turns decoded sweeps into 6DoF poses.
+ * @author agent <agent@local>
+ * @ingroup drv_vive
+ */
+
+#pragma once
+
+#include "xrt/xrt_defines.h"
+
+#include "os/os_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+struct lh_sensor;
+struct lighthouse_base;
+struct lighthouse_frame;
+
+//! Ticks of the 48 MHz watchman clock per rotor revolution, the rotors spin at 60 Hz.
+#define LIGHTHOUSE_TICKS_PER_REVOLUTION (800000)
+
+//! Sweep offset, from the start of the sync pulse, at which a rotor points straight ahead.
+#define LIGHTHOUSE_TICKS_CENTER (200000)
+
+/*!
+ * Counters for the debug UI and the tests.
+ */
+struct lighthouse_solver_stats
+{
+	//! Number of sweeps that has been handed to the solver.
+	uint32_t sweeps;
+
+	//! Number of poses that passed the residual check.
+	uint32_t solves;
+
+	//! Number of solves thrown away, too few sensors or a too large residual.
+	uint32_t rejected;
+
+	//! Root mean square of the angle residuals of the last accepted solve, in radians.
+	float last_residual;
+
+	//! Which base stations has a known pose in the tracking space.
+	bool base_known[2];
+};
+
+/*!
+ * Solves the pose of a device from the sweep angles of the sensors on it.
+ *
+ * The tracking space is the space of the IMU 3DoF fusion with its origin
+ * where the device was when it first saw a base station, the base station
+ * poses are found from that first solve. After that every sweep gives a pose
+ * of the device, the position is used as is and the orientation slowly pulls
+ * the IMU orientation into line, which takes care of yaw drift.
+ *
+ * Thread safe, sweeps and IMU samples may come from different threads.
+ *
+ * @ingroup drv_vive
+ */
+struct lighthouse_solver;
+
+/*!
+ * Create a solver for a device with the given sensors, in IMU space. The
+ * sensors are copied.
+ */
+struct lighthouse_solver *
+lighthouse_solver_create(const struct lh_sensor *sensors, uint32_t sensor_count);
+
+/*!
+ * Destroy the solver and set the pointer to NULL.
+ */
+void
+lighthouse_solver_destroy(struct lighthouse_solver **solver_ptr);
+
+/*!
+ * Hand a finished sweep, of rotor @p rotor of base station @p base_index, to
+ * the solver. Called by the watchman decoder.
+ */
+void
+lighthouse_solver_push_frame(struct lighthouse_solver *solver,
+                             uint32_t base_index,
+                             const struct lighthouse_base *base,
+                             uint32_t rotor,
+                             const struct lighthouse_frame *frame);
+
+/*!
+ * Fuse the orientation @p rot of the IMU 3DoF filter, at watchman clock
+ * @p ticks and time @p timestamp_ns, with the latest solve. The IMU samples
+ * also tell the solver how the watchman clock relates to system time.
+ *
+ * @p out_relation always gets the corrected orientation, position bits are
+ * only set if there has been a recent enough solve.
+ */
+void
+lighthouse_solver_push_imu(struct lighthouse_solver *solver,
+                           uint32_t ticks,
+                           timepoint_ns timestamp_ns,
+                           const struct xrt_quat *rot,
+                           struct xrt_space_relation *out_relation);
+
+/*!
+ * Get a copy of the counters.
+ */
+void
+lighthouse_solver_get_stats(struct lighthouse_solver *solver, struct lighthouse_solver_stats *out_stats);
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,197 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Watches DRM connectors with udev for the WMR HMD display.
+ * @author agent <agent@local>
+ * @ingroup drv_wmr
+ */
+
+#include "util/u_misc.h"
+#include "util/u_logging.h"
+
+#include "wmr_display_watch.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <libudev.h>
+
+
+#define WMR_DISPLAY_WATCH_MAX_CONNECTORS 16
+
+#define DW_DEBUG(w, ...) U_LOG_IFL_D(w->log_level, __VA_ARGS__)
+#define DW_INFO(w, ...) U_LOG_IFL_I(w->log_level, __VA_ARGS__)
+#define DW_ERROR(w, ...) U_LOG_IFL_E(w->log_level, __VA_ARGS__)
+
+
+/*!
+ * @implements wmr_display_watch
+ */
+struct wmr_display_watch_udev
+{
+	struct wmr_display_watch base;
+
+	struct udev *udev;
+	struct udev_monitor *monitor;
+
+	//! Connectors that were connected when the watch was created.
+	char connected[WMR_DISPLAY_WATCH_MAX_CONNECTORS][64];
+	uint32_t connected_count;
+
+	enum u_logging_level log_level;
+};
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static bool
+was_connected(struct wmr_display_watch_udev *w, const char *name)
+{
+	for (uint32_t i = 0; i < w->connected_count; i++) {
+		if (strcmp(w->connected[i], name) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*!
+ * Go over all connected DRM connectors, connectors are the only DRM devices
+ * with a status attribute. When @p record is set they are remembered,
+ * otherwise returns true if there is one that was not remembered.
+ */
+static bool
+scan_connectors(struct wmr_display_watch_udev *w, bool record)
+{
+	struct udev_enumerate *enumerate;
+	struct udev_list_entry *dev_list_entry;
+	bool found_new = false;
+
+	enumerate = udev_enumerate_new(w->udev);
+	udev_enumerate_add_match_subsystem(enumerate, "drm");
+	udev_enumerate_scan_devices(enumerate);
+
+	udev_list_entry_foreach(dev_list_entry, udev_enumerate_get_list_entry(enumerate))
+	{
+		const char *sysfs_path = udev_list_entry_get_name(dev_list_entry);
+		struct udev_device *raw_dev = udev_device_new_from_syspath(w->udev, sysfs_path);
+		if (raw_dev == NULL) {
+			continue;
+		}
+
+		const char *name = udev_device_get_sysname(raw_dev);
+		const char *status = udev_device_get_sysattr_value(raw_dev, "status");
+
+		if (name == NULL || status == NULL || strcmp(status, "connected") != 0) {
+			// Not a connector, or nothing plugged into it.
+		} else if (record) {
+			if (w->connected_count < WMR_DISPLAY_WATCH_MAX_CONNECTORS) {
+				snprintf(w->connected[w->connected_count++], sizeof(w->connected[0]), "%s", name);
+			}
+		} else if (!was_connected(w, name)) {
+			DW_INFO(w, "Display connector '%s' connected", name);
+			found_new = true;
+		}
+
+		udev_device_unref(raw_dev);
+
+		if (found_new) {
+			break;
+		}
+	}
+
+	udev_enumerate_unref(enumerate);
+
+	return found_new;
+}
+
+
+/*
+ *
+ * Member functions.
+ *
+ */
+
+static bool
+udev_watch_poll(struct wmr_display_watch *wdw)
+{
+	struct wmr_display_watch_udev *w = (struct wmr_display_watch_udev *)wdw;
+	bool got_event = false;
+
+	// Non-blocking, returns NULL once drained.
+	struct udev_device *dev;
+	while ((dev = udev_monitor_receive_device(w->monitor)) != NULL) {
+		DW_DEBUG(w, "DRM %s event for '%s'", udev_device_get_action(dev), udev_device_get_sysname(dev));
+		udev_device_unref(dev);
+		got_event = true;
+	}
+
+	// Only look at the connectors when something has changed.
+	if (!got_event) {
+		return false;
+	}
+
+	return scan_connectors(w, false);
+}
+
+static void
+udev_watch_destroy(struct wmr_display_watch *wdw)
+{
+	struct wmr_display_watch_udev *w = (struct wmr_display_watch_udev *)wdw;
+
+	udev_monitor_unref(w->monitor);
+	udev_unref(w->udev);
+	free(w);
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+struct wmr_display_watch *
+wmr_display_watch_create_udev(enum u_logging_level log_level)
+{
+	struct udev *udev = udev_new();
+	if (udev == NULL) {
+		U_LOG_IFL_E(log_level, "Can't create udev");
+		return NULL;
+	}
+
+	struct udev_monitor *monitor = udev_monitor_new_from_netlink(udev, "udev");
+	if (monitor == NULL) {
+		U_LOG_IFL_E(log_level, "Can't create udev monitor");
+		udev_unref(udev);
+		return NULL;
+	}
+
+	udev_monitor_filter_add_match_subsystem_devtype(monitor, "drm", NULL);
+
+	if (udev_monitor_enable_receiving(monitor) < 0) {
+		U_LOG_IFL_E(log_level, "Can't enable receiving on udev monitor");
+		udev_monitor_unref(monitor);
+		udev_unref(udev);
+		return NULL;
+	}
+
+	struct wmr_display_watch_udev *w = U_TYPED_CALLOC(struct wmr_display_watch_udev);
+	w->base.poll = udev_watch_poll;
+	w->base.destroy = udev_watch_destroy;
+	w->udev = udev;
+	w->monitor = monitor;
+	w->log_level = log_level;
+
+	// Monitor first, so nothing is missed between the scan and the first poll.
+	scan_connectors(w, true);
+
+	DW_DEBUG(w, "Watching DRM connectors, %u already connected", w->connected_count);
+
+	return &w->base;
+}
@@ -0,0 +1,85 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Watches for the WMR HMD display showing up on the host.
+ * @author agent <agent@local>
+ * @ingroup drv_wmr
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_config_have.h"
+#include "util/u_logging.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Tells when a display connector gets connected on the host, used to know
+ * when the HMD display has powered up and can be picked by the compositor.
+ *
+ * @ingroup drv_wmr
+ */
+struct wmr_display_watch
+{
+	/*!
+	 * Returns true once a display that was not connected when the watch was
+	 * created is connected. Must not block.
+	 */
+	bool (*poll)(struct wmr_display_watch *wdw);
+
+	void (*destroy)(struct wmr_display_watch *wdw);
+};
+
+/*!
+ * @copydoc wmr_display_watch::poll
+ *
+ * @public @memberof wmr_display_watch
+ */
+static inline bool
+wmr_display_watch_poll(struct wmr_display_watch *wdw)
+{
+	return wdw->poll(wdw);
+}
+
+/*!
+ * Destroy the watch and set the pointer to NULL, handles NULL.
+ *
+ * @public @memberof wmr_display_watch
+ */
+static inline void
+wmr_display_watch_destroy(struct wmr_display_watch **wdw_ptr)
+{
+	struct wmr_display_watch *wdw = *wdw_ptr;
+	if (wdw == NULL) {
+		return;
+	}
+
+	wdw->destroy(wdw);
+	*wdw_ptr = NULL;
+}
+
+#ifdef XRT_HAVE_LIBUDEV
+/*!
+ * Create a watch on the DRM connectors using a udev monitor, the connectors
+ * that are connected at this point are ignored. Returns NULL on failure.
+ *
+ * @ingroup drv_wmr
+ */
+struct wmr_display_watch *
+wmr_display_watch_create_udev(enum u_logging_level log_level);
+#else
+
+/* Stub without udev, only the HMD status reports are used */
+#define wmr_display_watch_create_udev(log_level) NULL
+
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
@@ -54,6 +54,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <inttypes.h>
 #ifndef XRT_OS_WINDOWS
 #include <unistd.h> // for sleep()
 #endif
@@ -71,7 +72,7 @@
 //! Specifies whether the user wants to use a SLAM tracker.
 DEBUG_GET_ONCE_BOOL_OPTION(wmr_slam, "WMR_SLAM", true)
 
-//! Specifies whether the user wants to use a SLAM tracker.
+//! How long to wait at most for the Reverb display to power up.
 DEBUG_GET_ONCE_NUM_OPTION(sleep_seconds, "WMR_DISPLAY_INIT_SLEEP_SECONDS", 4)
 
 //! Specifies whether the user wants to use the hand tracker.
@@ -89,6 +90,9 @@ DEBUG_GET_ONCE_OPTION(slam_submit_from_start, "SLAM_SUBMIT_FROM_START", NULL)
 #define WMR_WARN(d, ...) U_LOG_XDEV_IFL_W(&d->base, d->log_level, __VA_ARGS__)
 #define WMR_ERROR(d, ...) U_LOG_XDEV_IFL_E(&d->base, d->log_level, __VA_ARGS__)
 
+//! How long each read of the companion device blocks while waiting for the display.
+#define WMR_DISPLAY_POLL_MS 5
+
 static int
 wmr_hmd_activate_reverb(struct wmr_hmd *wh);
 static void
@@ -565,15 +569,14 @@ control_ipd_value_decode(struct wmr_hmd *wh, const unsigned char *buffer, int si
 }
 
 static bool
-control_read_packets(struct wmr_hmd *wh)
+control_read_packets(struct wmr_hmd *wh, int timeout_ms)
 {
 	DRV_TRACE_MARKER();
 
 	unsigned char buffer[WMR_FEATURE_BUFFER_SIZE];
 
-	// Do not block
 	os_mutex_lock(&wh->hid_lock);
-	int size = os_hid_read(wh->hid_control_dev, buffer, sizeof(buffer), 0);
+	int size = os_hid_read(wh->hid_control_dev, buffer, sizeof(buffer), timeout_ms);
 	os_mutex_unlock(&wh->hid_lock);
 
 	if (size < 0) {
@@ -630,6 +633,8 @@ control_read_packets(struct wmr_hmd *wh)
 		          "[?] [?] [?] [?] [?] [?]",
 		          buffer[0], buffer[1], buffer[4]);
 
+		wh->display_ready = buffer[1] != 0;
+
 		break;
 	default: //
 		WMR_DEBUG(wh, "Unknown message type: %02x (size %i)", buffer[0], size);
@@ -666,7 +671,7 @@ wmr_run_thread(void *ptr)
 		os_thread_helper_unlock(&wh->oth);
 
 		// Does not block.
-		if (!control_read_packets(wh)) {
+		if (!control_read_packets(wh, 0)) {
 			break;
 		}
 
@@ -730,6 +735,9 @@ wmr_hmd_activate_reverb(struct wmr_hmd *wh)
 
 	WMR_TRACE(wh, "Activating HP Reverb G1/G2 HMD...");
 
+	// Before anything is sent, so the HMD display is not already counted.
+	struct wmr_display_watch *watch = wmr_display_watch_create_udev(wh->log_level);
+
 	// Hack to power up the Reverb G1 display, thanks to OpenHMD contibutors.
 	// Sleep before we start seems to improve reliability.
 	// 300ms is what Windows seems to do, so cargo cult that.
@@ -759,16 +767,21 @@ wmr_hmd_activate_reverb(struct wmr_hmd *wh)
 	// Enable the HMD screen now, if required. Otherwise, if screen should initially be disabled, then
 	// proactively disable it now. Why? Because some cases of irregular termination of Monado will
 	// leave either the 'Hololens Sensors' device or its 'companion' device alive across restarts.
+	wh->display_ready = false;
 	wmr_hmd_screen_enable_reverb(wh, wh->hmd_screen_enable);
 
 	// Allow time for enumeration of available displays by host system, so the compositor can select among them.
-	WMR_INFO(wh,
-	         "Sleep until the HMD display is powered up, so the available displays can be enumerated by the host "
-	         "system.");
+	if (wh->hmd_screen_enable) {
+		WMR_INFO(wh,
+		         "Waiting until the HMD display is powered up, so the available displays can be enumerated by "
+		         "the host system.");
 
-	// Get the sleep amount, then sleep. One or two seconds was not enough.
-	uint64_t seconds = debug_get_num_option_sleep_seconds();
-	os_nanosleep(U_TIME_1S_IN_NS * seconds);
+		// The old fixed sleep is now the timeout. One or two seconds was not enough.
+		uint64_t seconds = debug_get_num_option_sleep_seconds();
+		wmr_hmd_wait_for_display(wh, watch, U_TIME_1S_IN_NS * seconds);
+	}
+
+	wmr_display_watch_destroy(&watch);
 
 	return 0;
 }
@@ -824,6 +837,9 @@ wmr_hmd_activate_odyssey_plus(struct wmr_hmd *wh)
 
 	WMR_TRACE(wh, "Activating Odyssey HMD...");
 
+	// Before anything is sent, so the HMD display is not already counted.
+	struct wmr_display_watch *watch = wmr_display_watch_create_udev(wh->log_level);
+
 	os_nanosleep(U_TIME_1MS_IN_NS * 300);
 
 	unsigned char data[64] = {0x16};
@@ -838,14 +854,19 @@ wmr_hmd_activate_odyssey_plus(struct wmr_hmd *wh)
 	// Enable the HMD screen now, if required. Otherwise, if screen should initially be disabled, then
 	// proactively disable it now. Why? Because some cases of irregular termination of Monado will
 	// leave either the 'Hololens Sensors' device or its 'companion' device alive across restarts.
+	wh->display_ready = false;
 	wmr_hmd_screen_enable_odyssey_plus(wh, wh->hmd_screen_enable);
 
 	// Allow time for enumeration of available displays by host system, so the compositor can select among them.
-	WMR_INFO(wh,
-	         "Sleep until the HMD display is powered up, so the available displays can be enumerated by the host "
-	         "system.");
+	if (wh->hmd_screen_enable) {
+		WMR_INFO(wh,
+		         "Waiting until the HMD display is powered up, so the available displays can be enumerated by "
+		         "the host system.");
 
-	os_nanosleep(3LL * U_TIME_1S_IN_NS);
+		wmr_hmd_wait_for_display(wh, watch, 3LL * U_TIME_1S_IN_NS);
+	}
+
+	wmr_display_watch_destroy(&watch);
 
 	return 0;
 }
@@ -2117,6 +2138,41 @@ wmr_hmd_create(enum wmr_headset_type hmd_type,
 	os_mutex_unlock(&wh->controller_status_lock);
 }
 
+bool
+wmr_hmd_wait_for_display(struct wmr_hmd *wh, struct wmr_display_watch *watch, uint64_t timeout_ns)
+{
+	DRV_TRACE_MARKER();
+
+	uint64_t start_ns = os_monotonic_get_ns();
+	uint64_t now_ns = start_ns;
+
+	while (now_ns - start_ns < timeout_ns) {
+		// Blocks for a bit, decodes any status report from the companion device.
+		if (!control_read_packets(wh, WMR_DISPLAY_POLL_MS)) {
+			return false;
+		}
+
+		now_ns = os_monotonic_get_ns();
+
+		if (wh->display_ready) {
+			WMR_INFO(wh, "HMD reported the display ready after %" PRIu64 "ms",
+			         (now_ns - start_ns) / U_TIME_1MS_IN_NS);
+			return true;
+		}
+
+		if (watch != NULL && wmr_display_watch_poll(watch)) {
+			WMR_INFO(wh, "Host found the display after %" PRIu64 "ms",
+			         (now_ns - start_ns) / U_TIME_1MS_IN_NS);
+			return true;
+		}
+	}
+
+	WMR_WARN(wh, "Display did not come up within %" PRIu64 "ms, continuing anyway",
+	         timeout_ns / U_TIME_1MS_IN_NS);
+
+	return false;
+}
+
 bool
 wmr_hmd_send_controller_packet(struct wmr_hmd *hmd, const uint8_t *buffer, uint32_t buf_size)
 {
@@ -28,6 +28,7 @@
 #include "wmr_config.h"
 #include "wmr_camera.h"
 #include "wmr_common.h"
+#include "wmr_display_watch.h"
 #include "wmr_hmd_controller.h"
 
 
@@ -107,6 +108,8 @@ struct wmr_hmd
 
 	//! Current desired HMD screen state.
 	bool hmd_screen_enable;
+	//! Set when the companion device reports the display as powered up.
+	bool display_ready;
 	//! Latest raw IPD value read from the device.
 	uint16_t raw_ipd;
 	//! Latest proximity sensor value read from the device.
@@ -213,6 +216,21 @@ wmr_hmd_create(enum wmr_headset_type hmd_type,
                struct xrt_device **out_left_controller,
                struct xrt_device **out_right_controller);
 
+/*!
+ * Wait for the display to power up after the screen has been enabled, done
+ * when the companion device reports it or a new display connector shows up
+ * on the host, whichever comes first. Reads from the companion device, so
+ * must not be called once the reading thread has been started.
+ *
+ * @param wh The HMD.
+ * @param watch Watch on the host displays, may be NULL.
+ * @param timeout_ns How long to wait at most.
+ *
+ * @return true if the display came up, false on timeout or error.
+ */
+bool
+wmr_hmd_wait_for_display(struct wmr_hmd *wh, struct wmr_display_watch *watch, uint64_t timeout_ns);
+
 bool
 wmr_hmd_send_controller_packet(struct wmr_hmd *hmd, const uint8_t *buffer, uint32_t buf_size);
 int
@@ -81,6 +81,8 @@ enum xrt_layer_type
 	XRT_LAYER_CYLINDER,
 	XRT_LAYER_EQUIRECT1,
 	XRT_LAYER_EQUIRECT2,
+	XRT_LAYER_STEREO_PROJECTION_SPACE_WARP,
+	XRT_LAYER_PASSTHROUGH,
 };
 
 /*!
@@ -96,6 +98,26 @@ enum xrt_layer_composition_flags
 	 * adjusted for the IPD.
 	 */
 	XRT_LAYER_COMPOSITION_VIEW_SPACE_BIT = 1u << 3u,
+	/*!
+	 * The projection layer is a high resolution inset, only the area
+	 * covered by its fov is composited and its edges are blended into
+	 * the layers below. Used for quad views.
+	 */
+	XRT_LAYER_COMPOSITION_INSET_BIT = 1u << 4u,
+	/*!
+	 * The layer should be filtered when its source is denser than the
+	 * target, the quality variant takes more samples. Only one of the two
+	 * super-sampling bits is expected, quality wins if both are set.
+	 */
+	XRT_LAYER_COMPOSITION_SUPER_SAMPLING_NORMAL_BIT = 1u << 5u,
+	XRT_LAYER_COMPOSITION_SUPER_SAMPLING_QUALITY_BIT = 1u << 6u,
+	/*!
+	 * The layer should be sharpened when its source is sparser than the
+	 * target, the quality variant is stronger but avoids halos. Quality
+	 * wins if both are set.
+	 */
+	XRT_LAYER_COMPOSITION_SHARPENING_NORMAL_BIT = 1u << 7u,
+	XRT_LAYER_COMPOSITION_SHARPENING_QUALITY_BIT = 1u << 8u,
 };
 
 /*!
@@ -185,6 +207,58 @@ struct xrt_layer_stereo_projection_depth_data
 	struct xrt_layer_depth_data l_d, r_d;
 };
 
+/*!
+ * All the pure data values associated with the space warp information
+ * attached to a view of a projection layer, see XR_FB_space_warp.
+ *
+ * The @ref xrt_swapchain references and @ref xrt_device are provided outside of
+ * this struct.
+ */
+struct xrt_layer_space_warp_data
+{
+	/*!
+	 * Motion vectors, per pixel movement of the objects in NDC units since
+	 * the previous frame, not including the movement of the views.
+	 */
+	struct xrt_sub_image motion_vector_sub;
+
+	//! Depth information, required by space warp.
+	struct xrt_layer_depth_data depth;
+
+	/*!
+	 * Movement of the app space between the previous and this frame.
+	 *
+	 * @todo Not used by the main compositor, frame synthesis only follows
+	 * the motion vectors and the view poses, so movement of the app space,
+	 * like artificial locomotion, isn't extrapolated.
+	 */
+	struct xrt_pose app_space_delta_pose;
+
+	//! The app asked for this frame to not be used for frame synthesis.
+	bool frame_skip;
+
+	/*!
+	 * The y axis of the motion vectors points up, true for OpenGL and
+	 * Direct3D NDC. Like @ref xrt_layer_data::flip_y this is set by the
+	 * client compositors depending on the graphics API.
+	 */
+	bool ndc_y_up;
+};
+
+/*!
+ * All the pure data values associated with a stereo projection layer with
+ * space warp motion vector and depth swapchains attached.
+ *
+ * The @ref xrt_swapchain references and @ref xrt_device are provided outside of
+ * this struct.
+ */
+struct xrt_layer_stereo_projection_space_warp_data
+{
+	struct xrt_layer_projection_view_data l, r;
+
+	struct xrt_layer_space_warp_data l_sw, r_sw;
+};
+
 /*!
  * All the pure data values associated with a quad layer.
  *
@@ -271,6 +345,19 @@ struct xrt_layer_equirect2_data
 	float lower_vertical_angle;
 };
 
+/*!
+ * All the pure data values associated with a passthrough layer, the images
+ * come from the passthrough camera of the device and not from a swapchain,
+ * see XR_FB_passthrough.
+ *
+ * The @ref xrt_device is provided outside of this struct.
+ */
+struct xrt_layer_passthrough_data
+{
+	//! How much of the camera image is blended over the layers below.
+	float opacity;
+};
+
 /*!
  * All the pure data values associated with a composition layer.
  *
@@ -327,11 +414,13 @@ struct xrt_layer_data
 	union {
 		struct xrt_layer_stereo_projection_data stereo;
 		struct xrt_layer_stereo_projection_depth_data stereo_depth;
+		struct xrt_layer_stereo_projection_space_warp_data stereo_space_warp;
 		struct xrt_layer_quad_data quad;
 		struct xrt_layer_cube_data cube;
 		struct xrt_layer_cylinder_data cylinder;
 		struct xrt_layer_equirect1_data equirect1;
 		struct xrt_layer_equirect2_data equirect2;
+		struct xrt_layer_passthrough_data passthrough;
 	};
 };
 
@@ -362,6 +451,8 @@ enum xrt_swapchain_create_flags
 	XRT_SWAPCHAIN_CREATE_PROTECTED_CONTENT = (1u << 0u),
 	//! Signals that the allocator should only allocate one image.
 	XRT_SWAPCHAIN_CREATE_STATIC_IMAGE = (1u << 1u),
+	//! Client compositor should create foveation images, not passed on to the native compositor.
+	XRT_SWAPCHAIN_CREATE_FOVEATION = (1u << 2u),
 };
 
 /*!
@@ -388,6 +479,21 @@ enum xrt_barrier_direction
 	XRT_BARRIER_TO_COMP = 2,
 };
 
+/*!
+ * Foveation state of a swapchain, see @ref xrt_swapchain::set_foveation.
+ */
+struct xrt_foveation_state
+{
+	enum xrt_foveation_level level;
+
+	/*!
+	 * Centre of the full resolution region for each view in NDC, x right
+	 * and y up. Array layer 0 and 1 use their own view, swapchains with a
+	 * single layer use the middle of the two.
+	 */
+	struct xrt_vec2 centers[2];
+};
+
 /*!
  * @interface xrt_swapchain
  *
@@ -469,6 +575,16 @@ struct xrt_swapchain
 	 * See xrReleaseSwapchainImage, state tracker needs to track index.
 	 */
 	xrt_result_t (*release_image)(struct xrt_swapchain *xsc, uint32_t index);
+
+	/*!
+	 * Update the foveation images of a swapchain created with
+	 * @ref XRT_SWAPCHAIN_CREATE_FOVEATION, takes effect from the next
+	 * barrier to the app. Optional, only client compositors implement it.
+	 *
+	 * @param xsc   Self pointer
+	 * @param state New foveation state.
+	 */
+	xrt_result_t (*set_foveation)(struct xrt_swapchain *xsc, const struct xrt_foveation_state *state);
 };
 
 /*!
@@ -582,6 +698,25 @@ xrt_swapchain_release_image(struct xrt_swapchain *xsc, uint32_t index)
 	return xsc->release_image(xsc, index);
 }
 
+/*!
+ * @copydoc xrt_swapchain::set_foveation
+ *
+ * Helper for calling through the function pointer, returns
+ * @ref XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED if the swapchain does not
+ * implement the function.
+ *
+ * @public @memberof xrt_swapchain
+ */
+static inline xrt_result_t
+xrt_swapchain_set_foveation(struct xrt_swapchain *xsc, const struct xrt_foveation_state *state)
+{
+	if (xsc->set_foveation == NULL) {
+		return XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED;
+	}
+
+	return xsc->set_foveation(xsc, state);
+}
+
 
 /*
  *
@@ -730,6 +865,8 @@ enum xrt_compositor_event_type
 	XRT_COMPOSITOR_EVENT_OVERLAY_CHANGE = 2,
 	XRT_COMPOSITOR_EVENT_LOSS_PENDING = 3,
 	XRT_COMPOSITOR_EVENT_LOST = 4,
+	XRT_COMPOSITOR_EVENT_PERFORMANCE_CHANGE = 5,
+	XRT_COMPOSITOR_EVENT_RESOLUTION_SCALE_CHANGE = 6,
 };
 
 /*!
@@ -768,6 +905,28 @@ struct xrt_compositor_event_lost
 	enum xrt_compositor_event_type type;
 };
 
+/*!
+ * Performance notification level change event.
+ */
+struct xrt_compositor_event_perf_change
+{
+	enum xrt_compositor_event_type type;
+	enum xrt_perf_domain domain;
+	enum xrt_perf_sub_domain sub_domain;
+	enum xrt_perf_notify_level from_level;
+	enum xrt_perf_notify_level to_level;
+};
+
+/*!
+ * Recommended layer resolution scale change event, the scale is per axis and
+ * relative to the recommended view resolution.
+ */
+struct xrt_compositor_event_resolution_scale
+{
+	enum xrt_compositor_event_type type;
+	float scale;
+};
+
 /*!
  * Compositor events union.
  */
@@ -777,6 +936,8 @@ union xrt_compositor_event {
 	struct xrt_compositor_event_state_change overlay;
 	struct xrt_compositor_event_loss_pending loss_pending;
 	struct xrt_compositor_event_lost lost;
+	struct xrt_compositor_event_perf_change performance;
+	struct xrt_compositor_event_resolution_scale resolution_scale;
 };
 
 
@@ -793,6 +954,8 @@ enum xrt_view_type
 {
 	XRT_VIEW_TYPE_MONO = 1,
 	XRT_VIEW_TYPE_STEREO = 2,
+	//! Stereo wide views with a stereo inset, submitted as two stereo projection layers.
+	XRT_VIEW_TYPE_QUAD = 1000037000,
 };
 
 enum xrt_compositor_frame_point
@@ -814,6 +977,14 @@ struct xrt_swapchain_create_info
 	uint32_t face_count;
 	uint32_t array_size;
 	uint32_t mip_count;
+
+	/*!
+	 * Formats the images will be viewed as, in the same graphics API as
+	 * @ref format. Only used with @ref XRT_SWAPCHAIN_USAGE_MUTABLE_FORMAT,
+	 * zero means any compatible format.
+	 */
+	uint32_t format_count;
+	int64_t formats[XRT_MAX_SWAPCHAIN_CREATE_INFO_FORMAT_LIST_COUNT];
 };
 
 /*!
@@ -1228,8 +1399,63 @@ struct xrt_compositor
 	                                            struct xrt_compositor_semaphore *xcsem,
 	                                            uint64_t value);
 
+	/*!
+	 * Adds a stereo projection layer for submission, has motion vector and
+	 * depth information used for frame synthesis. This function is
+	 * optional and may be NULL, the layer is then submitted through
+	 * @ref xrt_compositor::layer_stereo_projection_depth instead.
+	 *
+	 * @param xc          Self pointer
+	 * @param xdev        The device the layer is relative to.
+	 * @param l_xsc       Swapchain object containing left eye RGB data.
+	 * @param r_xsc       Swapchain object containing right eye RGB data.
+	 * @param l_d_xsc     Swapchain object containing left eye depth data.
+	 * @param r_d_xsc     Swapchain object containing right eye depth data.
+	 * @param l_mv_xsc    Swapchain object containing left eye motion vectors.
+	 * @param r_mv_xsc    Swapchain object containing right eye motion vectors.
+	 * @param data        All of the pure data bits (not pointers/handles),
+	 *                    including what parts of the supplied swapchain
+	 *                    objects to use for each view.
+	 */
+	xrt_result_t (*layer_stereo_projection_space_warp)(struct xrt_compositor *xc,
+	                                                   struct xrt_device *xdev,
+	                                                   struct xrt_swapchain *l_xsc,
+	                                                   struct xrt_swapchain *r_xsc,
+	                                                   struct xrt_swapchain *l_d_xsc,
+	                                                   struct xrt_swapchain *r_d_xsc,
+	                                                   struct xrt_swapchain *l_mv_xsc,
+	                                                   struct xrt_swapchain *r_mv_xsc,
+	                                                   const struct xrt_layer_data *data);
+
+	/*!
+	 * Adds a passthrough layer for submission, the compositor composites
+	 * the latest image from the passthrough camera of the device at this
+	 * point in the layer order. This function is optional and may be
+	 * NULL, check @ref xrt_system_compositor_info::supports_passthrough.
+	 *
+	 * @param xc          Self pointer
+	 * @param xdev        The device the passthrough camera is on.
+	 * @param data        All of the pure data bits (not pointers/handles).
+	 */
+	xrt_result_t (*layer_passthrough)(struct xrt_compositor *xc,
+	                                  struct xrt_device *xdev,
+	                                  const struct xrt_layer_data *data);
+
 	/*! @} */
 
+	/*!
+	 * Set the performance level hint for the given domain, see
+	 * xrPerfSettingsSetPerformanceLevelEXT. This function is optional and
+	 * may be NULL.
+	 *
+	 * @param xc          Self pointer
+	 * @param domain      CPU or GPU domain.
+	 * @param level       The performance level the application wants.
+	 */
+	xrt_result_t (*set_performance_level)(struct xrt_compositor *xc,
+	                                      enum xrt_perf_domain domain,
+	                                      enum xrt_perf_set_level level);
+
 	/*!
 	 * Teardown the compositor.
 	 *
@@ -1520,6 +1746,40 @@ xrt_comp_layer_stereo_projection_depth(struct xrt_compositor *xc,
 	return xc->layer_stereo_projection_depth(xc, xdev, l_xsc, r_xsc, l_d_xsc, r_d_xsc, data);
 }
 
+/*!
+ * @copydoc xrt_compositor::layer_stereo_projection_space_warp
+ *
+ * Helper for calling through the function pointer, if the compositor does not
+ * implement the function the layer is submitted as a layer with depth instead.
+ *
+ * @public @memberof xrt_compositor
+ */
+static inline xrt_result_t
+xrt_comp_layer_stereo_projection_space_warp(struct xrt_compositor *xc,
+                                            struct xrt_device *xdev,
+                                            struct xrt_swapchain *l_xsc,
+                                            struct xrt_swapchain *r_xsc,
+                                            struct xrt_swapchain *l_d_xsc,
+                                            struct xrt_swapchain *r_d_xsc,
+                                            struct xrt_swapchain *l_mv_xsc,
+                                            struct xrt_swapchain *r_mv_xsc,
+                                            const struct xrt_layer_data *data)
+{
+	if (xc->layer_stereo_projection_space_warp != NULL) {
+		return xc->layer_stereo_projection_space_warp(xc, xdev, l_xsc, r_xsc, l_d_xsc, r_d_xsc, l_mv_xsc,
+		                                              r_mv_xsc, data);
+	}
+
+	struct xrt_layer_data d = *data;
+	d.type = XRT_LAYER_STEREO_PROJECTION_DEPTH;
+	d.stereo_depth.l = data->stereo_space_warp.l;
+	d.stereo_depth.r = data->stereo_space_warp.r;
+	d.stereo_depth.l_d = data->stereo_space_warp.l_sw.depth;
+	d.stereo_depth.r_d = data->stereo_space_warp.r_sw.depth;
+
+	return xc->layer_stereo_projection_depth(xc, xdev, l_xsc, r_xsc, l_d_xsc, r_d_xsc, &d);
+}
+
 /*!
  * @copydoc xrt_compositor::layer_quad
  *
@@ -1601,6 +1861,25 @@ xrt_comp_layer_equirect2(struct xrt_compositor *xc,
 	return xc->layer_equirect2(xc, xdev, xsc, data);
 }
 
+/*!
+ * @copydoc xrt_compositor::layer_passthrough
+ *
+ * Helper for calling through the function pointer, returns
+ * @ref XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED if the compositor does not
+ * implement the function.
+ *
+ * @public @memberof xrt_compositor
+ */
+static inline xrt_result_t
+xrt_comp_layer_passthrough(struct xrt_compositor *xc, struct xrt_device *xdev, const struct xrt_layer_data *data)
+{
+	if (xc->layer_passthrough == NULL) {
+		return XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED;
+	}
+
+	return xc->layer_passthrough(xc, xdev, data);
+}
+
 /*!
  * @copydoc xrt_compositor::layer_commit
  *
@@ -1629,6 +1908,25 @@ xrt_comp_layer_commit_with_semaphore(struct xrt_compositor *xc, struct xrt_compo
 
 /*! @} */
 
+/*!
+ * @copydoc xrt_compositor::set_performance_level
+ *
+ * Helper for calling through the function pointer, returns
+ * @ref XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED if the compositor does not
+ * implement the function.
+ *
+ * @public @memberof xrt_compositor
+ */
+static inline xrt_result_t
+xrt_comp_set_performance_level(struct xrt_compositor *xc, enum xrt_perf_domain domain, enum xrt_perf_set_level level)
+{
+	if (xc->set_performance_level == NULL) {
+		return XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED;
+	}
+
+	return xc->set_performance_level(xc, domain, level);
+}
+
 /*!
  * @copydoc xrt_compositor::destroy
  *
@@ -1728,6 +2026,15 @@ struct xrt_swapchain_vk
 
 	//! Images to be used by the caller.
 	VkImage images[XRT_MAX_SWAPCHAIN_IMAGES];
+
+	/*!
+	 * Fragment shading rate attachment images, one per image, only if
+	 * created with @ref XRT_SWAPCHAIN_CREATE_FOVEATION and supported.
+	 */
+	VkImage foveation_images[XRT_MAX_SWAPCHAIN_IMAGES];
+
+	//! Size in texels of the foveation images.
+	uint32_t foveation_width, foveation_height;
 };
 
 /*!
@@ -2048,6 +2355,15 @@ struct xrt_system_compositor_info
 
 	//! Whether @ref client_d3d_deviceLUID is valid
 	bool client_d3d_deviceLUID_valid;
+
+	//! Whether passthrough layers can be submitted, never changes.
+	bool supports_passthrough;
+
+	/*!
+	 * Whether projection layers with @ref XRT_LAYER_COMPOSITION_INSET_BIT
+	 * are placed inside the other projection layers, never changes.
+	 */
+	bool supports_inset_layers;
 };
 
 struct xrt_system_compositor;
@@ -1273,6 +1273,68 @@ enum xrt_form_factor
 	XRT_FORM_FACTOR_HANDHELD, //!< Handheld display.
 };
 
+/*!
+ * Performance domain, values match XR_EXT_performance_settings.
+ *
+ * @ingroup xrt_iface
+ */
+enum xrt_perf_domain
+{
+	XRT_PERF_DOMAIN_CPU = 1,
+	XRT_PERF_DOMAIN_GPU = 2,
+};
+
+/*!
+ * Performance sub-domain, values match XR_EXT_performance_settings.
+ *
+ * @ingroup xrt_iface
+ */
+enum xrt_perf_sub_domain
+{
+	XRT_PERF_SUB_DOMAIN_COMPOSITING = 1,
+	XRT_PERF_SUB_DOMAIN_RENDERING = 2,
+	XRT_PERF_SUB_DOMAIN_THERMAL = 3,
+};
+
+/*!
+ * Performance level hint from the application, values match
+ * XR_EXT_performance_settings.
+ *
+ * @ingroup xrt_iface
+ */
+enum xrt_perf_set_level
+{
+	XRT_PERF_SET_LEVEL_POWER_SAVINGS = 0,
+	XRT_PERF_SET_LEVEL_SUSTAINED_LOW = 25,
+	XRT_PERF_SET_LEVEL_SUSTAINED_HIGH = 50,
+	XRT_PERF_SET_LEVEL_BOOST = 75,
+};
+
+/*!
+ * Performance notification level, values match XR_EXT_performance_settings.
+ *
+ * @ingroup xrt_iface
+ */
+enum xrt_perf_notify_level
+{
+	XRT_PERF_NOTIFY_LEVEL_NORMAL = 0,
+	XRT_PERF_NOTIFY_LEVEL_WARNING = 25,
+	XRT_PERF_NOTIFY_LEVEL_IMPAIRED = 75,
+};
+
+/*!
+ * Foveated rendering level, values match XR_FB_foveation_configuration.
+ *
+ * @ingroup xrt_iface
+ */
+enum xrt_foveation_level
+{
+	XRT_FOVEATION_LEVEL_NONE = 0,
+	XRT_FOVEATION_LEVEL_LOW = 1,
+	XRT_FOVEATION_LEVEL_MEDIUM = 2,
+	XRT_FOVEATION_LEVEL_HIGH = 3,
+};
+
 #ifdef __cplusplus
 }
 #endif
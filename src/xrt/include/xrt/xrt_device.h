@@ -19,6 +19,7 @@ extern "C" {
 
 struct comp_target_factory;
 struct xrt_tracking;
+struct xrt_frame_sink;
 struct comp_compositor;
 struct comp_target;
 
@@ -177,6 +178,9 @@ struct xrt_input
 struct xrt_output
 {
 	enum xrt_output_name name;
+
+	//! Rate PCM haptic samples are played back at, zero if the output does not take PCM samples.
+	float pcm_sample_rate;
 };
 
 
@@ -219,6 +223,21 @@ struct xrt_binding_profile
 	size_t output_count;
 };
 
+/*!
+ * Where the passthrough cameras of a device are, one per view for side by
+ * side frames, otherwise only the first one is used.
+ *
+ * @ingroup xrt_iface
+ */
+struct xrt_passthrough_camera_info
+{
+	//! Pose of each camera relative to @ref XRT_INPUT_GENERIC_HEAD_POSE.
+	struct xrt_pose poses[2];
+
+	//! Field of view of each camera, covering its whole image.
+	struct xrt_fov fovs[2];
+};
+
 /*!
  * @interface xrt_device
  *
@@ -265,6 +284,7 @@ struct xrt_device
 	bool eye_gaze_supported;
 	bool force_feedback_supported;
 	bool form_factor_check_supported;
+	bool passthrough_supported;
 
 	/*!
 	 * Update any attached inputs.
@@ -299,6 +319,26 @@ struct xrt_device
 	                         uint64_t at_timestamp_ns,
 	                         struct xrt_space_relation *out_relation);
 
+	/*!
+	 * Copy out the newest samples of a pose input, oldest first, the ones
+	 * @ref get_tracked_pose interpolates between and predicts from. Lets
+	 * the IPC service replicate them to clients as they are. May be NULL
+	 * if the device keeps no such history.
+	 *
+	 * @param[in] xdev               The device.
+	 * @param[in] name               The pose input.
+	 * @param[in] max_count          Size of the out arrays.
+	 * @param[out] out_timestamps_ns When the samples are from.
+	 * @param[out] out_relations     The samples.
+	 * @param[out] out_count         Number of samples copied.
+	 */
+	xrt_result_t (*get_tracked_pose_history)(struct xrt_device *xdev,
+	                                         enum xrt_input_name name,
+	                                         uint32_t max_count,
+	                                         uint64_t *out_timestamps_ns,
+	                                         struct xrt_space_relation *out_relations,
+	                                         uint32_t *out_count);
+
 	/*!
 	 * @brief Get relationship of hand joints to the tracking origin space as
 	 * the base space.
@@ -338,6 +378,43 @@ struct xrt_device
 	 */
 	void (*set_output)(struct xrt_device *xdev, enum xrt_output_name name, const union xrt_output_value *value);
 
+	/*!
+	 * Queue PCM haptic samples on an output, only called for outputs that
+	 * have a non-zero @ref xrt_output::pcm_sample_rate. The device plays
+	 * them back at that rate and takes as many as it has room for, may be
+	 * NULL if the device has no such outputs.
+	 *
+	 * @param[in] xdev                 The device.
+	 * @param[in] name                 The output component name.
+	 * @param[in] samples              Samples in the range [-1, 1].
+	 * @param[in] sample_count         Number of samples.
+	 * @param[in] append               If false samples queued but not yet
+	 *                                 played are dropped first.
+	 * @param[out] out_samples_consumed How many samples the device took.
+	 * @see xrt_output_name
+	 */
+	void (*queue_haptic_pcm)(struct xrt_device *xdev,
+	                         enum xrt_output_name name,
+	                         const float *samples,
+	                         uint32_t sample_count,
+	                         bool append,
+	                         uint32_t *out_samples_consumed);
+
+	/*!
+	 * Start or stop the passthrough cameras, frames are pushed to @p sink
+	 * from a thread owned by the device and timestamped with when they
+	 * were captured. Passing a NULL sink stops the cameras, no frames are
+	 * pushed after that returns. May be NULL if the device has no
+	 * passthrough cameras, see @ref xrt_device::passthrough_supported.
+	 *
+	 * @param[in] xdev      The device.
+	 * @param[in] sink      Where to push the frames, or NULL to stop.
+	 * @param[out] out_info Where the cameras are, only set when starting.
+	 */
+	xrt_result_t (*set_passthrough_sink)(struct xrt_device *xdev,
+	                                     struct xrt_frame_sink *sink,
+	                                     struct xrt_passthrough_camera_info *out_info);
+
 	/*!
 	 * @brief Get the per-view pose in relation to the view space.
 	 *
@@ -457,6 +534,32 @@ xrt_device_get_tracked_pose(struct xrt_device *xdev,
 	xdev->get_tracked_pose(xdev, name, at_timestamp_ns, out_relation);
 }
 
+/*!
+ * Helper function for @ref xrt_device::get_tracked_pose_history.
+ *
+ * Returns @ref XRT_ERROR_DEVICE_FUNCTION_NOT_IMPLEMENTED for devices that
+ * keep no history.
+ *
+ * @copydoc xrt_device::get_tracked_pose_history
+ *
+ * @public @memberof xrt_device
+ */
+static inline xrt_result_t
+xrt_device_get_tracked_pose_history(struct xrt_device *xdev,
+                                    enum xrt_input_name name,
+                                    uint32_t max_count,
+                                    uint64_t *out_timestamps_ns,
+                                    struct xrt_space_relation *out_relations,
+                                    uint32_t *out_count)
+{
+	if (xdev->get_tracked_pose_history == NULL) {
+		*out_count = 0;
+		return XRT_ERROR_DEVICE_FUNCTION_NOT_IMPLEMENTED;
+	}
+
+	return xdev->get_tracked_pose_history(xdev, name, max_count, out_timestamps_ns, out_relations, out_count);
+}
+
 /*!
  * Helper function for @ref xrt_device::get_hand_tracking.
  *
@@ -487,6 +590,53 @@ xrt_device_set_output(struct xrt_device *xdev, enum xrt_output_name name, const
 	xdev->set_output(xdev, name, value);
 }
 
+/*!
+ * Helper function for @ref xrt_device::queue_haptic_pcm.
+ *
+ * Handles devices without PCM outputs, no samples are consumed.
+ *
+ * @copydoc xrt_device::queue_haptic_pcm
+ *
+ * @public @memberof xrt_device
+ */
+static inline void
+xrt_device_queue_haptic_pcm(struct xrt_device *xdev,
+                            enum xrt_output_name name,
+                            const float *samples,
+                            uint32_t sample_count,
+                            bool append,
+                            uint32_t *out_samples_consumed)
+{
+	if (xdev->queue_haptic_pcm == NULL) {
+		*out_samples_consumed = 0;
+		return;
+	}
+
+	xdev->queue_haptic_pcm(xdev, name, samples, sample_count, append, out_samples_consumed);
+}
+
+/*!
+ * Helper function for @ref xrt_device::set_passthrough_sink.
+ *
+ * Returns @ref XRT_ERROR_DEVICE_FUNCTION_NOT_IMPLEMENTED for devices without
+ * passthrough cameras.
+ *
+ * @copydoc xrt_device::set_passthrough_sink
+ *
+ * @public @memberof xrt_device
+ */
+static inline xrt_result_t
+xrt_device_set_passthrough_sink(struct xrt_device *xdev,
+                                struct xrt_frame_sink *sink,
+                                struct xrt_passthrough_camera_info *out_info)
+{
+	if (xdev->set_passthrough_sink == NULL) {
+		return XRT_ERROR_DEVICE_FUNCTION_NOT_IMPLEMENTED;
+	}
+
+	return xdev->set_passthrough_sink(xdev, sink, out_info);
+}
+
 /*!
  * Helper function for @ref xrt_device::get_view_poses.
  *
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "xrt/xrt_defines.h"
+#include "xrt/xrt_handles.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,6 +41,16 @@ struct xrt_frame
 	uint64_t source_timestamp;
 	uint64_t source_sequence; //!< sequence id
 	uint64_t source_id;       //!< Which @ref xrt_fs this frame originated from.
+
+	/*!
+	 * Optional handle to the memory behind @ref data, lets consumers like
+	 * Vulkan import the frame without a copy. Only valid if
+	 * @ref has_buffer_handle is set, the handle is owned by the producer and
+	 * lives as long as the frame, consumers must duplicate it to keep it.
+	 */
+	xrt_graphics_buffer_handle_t buffer_handle;
+	size_t buffer_offset; //!< Offset of @ref data in the buffer.
+	bool has_buffer_handle;
 };
 
 
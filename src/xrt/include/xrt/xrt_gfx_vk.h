@@ -64,6 +64,8 @@ xrt_gfx_vk_provider_create(struct xrt_compositor_native *xcn,
                            bool external_fence_fd_enabled,
                            bool external_semaphore_fd_enabled,
                            bool timeline_semaphore_enabled,
+                           bool fragment_shading_rate_enabled,
+                           bool image_format_list_enabled,
                            uint32_t queue_family_index,
                            uint32_t queue_index);
 
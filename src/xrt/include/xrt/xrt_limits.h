@@ -34,6 +34,11 @@
  */
 #define XRT_MAX_SWAPCHAIN_FORMATS 16
 
+/*!
+ * Max formats the images of a single swapchain can be viewed as, artificial limit.
+ */
+#define XRT_MAX_SWAPCHAIN_CREATE_INFO_FORMAT_LIST_COUNT 8
+
 /*!
  * @}
  */
@@ -50,6 +50,8 @@ typedef __eglMustCastToProperFunctionPointerType (*PFNEGLGETPROCADDRESSPROC)(con
 #include "openxr/openxr_platform.h"
 #include "openxr/loader_interfaces.h"
 
+#include "openxr/XR_KHR_locate_spaces.h"
 #include "openxr/XR_MNDX_hydra.h"
 #include "openxr/XR_MNDX_system_buttons.h"
 #include "openxr/XR_MNDX_ball_on_a_stick_controller.h"
+#include "openxr/XR_META_recommended_layer_resolution.h"
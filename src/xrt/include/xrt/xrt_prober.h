@@ -121,6 +121,41 @@ typedef void (*xrt_prober_list_video_func_t)(struct xrt_prober *xp,
                                              const char *serial,
                                              void *ptr);
 
+/*!
+ * What happened to a device, see @ref xrt_prober_hotplug_func_t.
+ *
+ * @ingroup xrt_iface
+ */
+enum xrt_prober_hotplug_event
+{
+	//! The device was plugged in, any devices created for it are given.
+	XRT_PROBER_HOTPLUG_ADDED,
+	//! The device was unplugged.
+	XRT_PROBER_HOTPLUG_REMOVED,
+};
+
+/*!
+ * Callback for hotplug events.
+ *
+ * @param xp Prober
+ * @param event What happened to the device
+ * @param xpdev The device, only valid during the call
+ * @param xdevs For an added device the devices created by the matching
+ *              drivers, ownership is transferred to the callee. For a removed
+ *              device the same devices again, the callee should destroy them.
+ *              Devices the callee destroys when added should be set to NULL
+ *              in the array, they are then NULL on removal too
+ * @param xdev_count Number of devices in @p xdevs
+ * @param ptr Your opaque userdata pointer as provided to @ref xrt_prober_handle_hotplug
+ * @ingroup xrt_iface
+ */
+typedef void (*xrt_prober_hotplug_func_t)(struct xrt_prober *xp,
+                                          enum xrt_prober_hotplug_event event,
+                                          struct xrt_prober_device *xpdev,
+                                          struct xrt_device **xdevs,
+                                          size_t xdev_count,
+                                          void *ptr);
+
 /*!
  * The main prober that probes and manages found but not opened HMD devices
  * that are connected to the system.
@@ -317,6 +352,23 @@ struct xrt_prober
 	 */
 	bool (*can_open)(struct xrt_prober *xp, struct xrt_prober_device *xpdev);
 
+	/*!
+	 * Handle devices that have been plugged in or removed since the last
+	 * call, adding and removing them from the device list without doing a
+	 * full @ref xrt_prober::probe. Added devices are given to the drivers
+	 * that match them, and only to those. Only devices created here are
+	 * handed back on removal, not those from @ref xrt_prober::create_system.
+	 * Does not block, cannot be called while the device list is locked. Not
+	 * thread safe.
+	 *
+	 * @param xp Pointer to self
+	 * @param cb Called for each device added or removed
+	 * @param ptr Opaque pointer for your userdata, passed through to the callback.
+	 *
+	 * @see xrt_prober_hotplug_func_t
+	 */
+	xrt_result_t (*handle_hotplug)(struct xrt_prober *xp, xrt_prober_hotplug_func_t cb, void *ptr);
+
 	/*!
 	 * Destroy the prober and set the pointer to null.
 	 *
@@ -516,6 +568,19 @@ xrt_prober_get_entries(struct xrt_prober *xp,
 	return xp->get_entries(xp, out_entry_count, out_entries, out_auto_probers);
 }
 
+/*!
+ * @copydoc xrt_prober::handle_hotplug
+ *
+ * Helper function for @ref xrt_prober::handle_hotplug.
+ *
+ * @public @memberof xrt_prober
+ */
+static inline xrt_result_t
+xrt_prober_handle_hotplug(struct xrt_prober *xp, xrt_prober_hotplug_func_t cb, void *ptr)
+{
+	return xp->handle_hotplug(xp, cb, ptr);
+}
+
 /*!
  * @copydoc xrt_prober::destroy
  *
@@ -158,4 +158,16 @@ typedef enum xrt_result
 	 * Some D3D12 error
 	 */
 	XRT_ERROR_D3D12 = -25,
+	/*!
+	 * The compositor does not implement this optional function.
+	 */
+	XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED = -26,
+	/*!
+	 * The device does not implement this optional function.
+	 */
+	XRT_ERROR_DEVICE_FUNCTION_NOT_IMPLEMENTED = -27,
+	/*!
+	 * More layers were submitted in a frame than the compositor can hold.
+	 */
+	XRT_ERROR_LAYER_LIMIT_EXCEEDED = -28,
 } xrt_result_t;
@@ -158,6 +158,33 @@ struct xrt_space_overseer
 	                             const struct xrt_pose *offset,
 	                             struct xrt_space_relation *out_relation);
 
+	/*!
+	 * Locate many spaces in the same base space at the same time, the
+	 * results are the same as calling @ref locate_space for each space but
+	 * implementations can share work and, in the out of process case, do
+	 * the whole batch in one round trip.
+	 *
+	 * @see xrt_space_overseer::locate_space.
+	 *
+	 * @param[in] xso             Owning space overseer.
+	 * @param[in] base_space      The space that we want the poses in.
+	 * @param[in] base_offset     Offset if any to the base space.
+	 * @param[in] at_timestamp_ns At which time.
+	 * @param[in] spaces          The spaces to be located, entries may be
+	 *                            null in which case the relation is zeroed.
+	 * @param[in] space_count     Number of spaces, offsets and relations.
+	 * @param[in] offsets         Offsets, one for each located space.
+	 * @param[out] out_relations  Resulting poses, one for each space.
+	 */
+	xrt_result_t (*locate_spaces)(struct xrt_space_overseer *xso,
+	                              struct xrt_space *base_space,
+	                              const struct xrt_pose *base_offset,
+	                              uint64_t at_timestamp_ns,
+	                              struct xrt_space **spaces,
+	                              uint32_t space_count,
+	                              const struct xrt_pose *offsets,
+	                              struct xrt_space_relation *out_relations);
+
 	/*!
 	 * Locate a the origin of the tracking space of a device, this is not
 	 * the same as the device position. In other words, what is the position
@@ -181,6 +208,25 @@ struct xrt_space_overseer
 	                              struct xrt_device *xdev,
 	                              struct xrt_space_relation *out_relation);
 
+	/*!
+	 * Start tracking a device that was created after the overseer was set
+	 * up, like a hotplugged one, it is placed at the offset of its
+	 * tracking origin.
+	 *
+	 * @param[in] xso  Owning space overseer.
+	 * @param[in] xdev Device to add.
+	 */
+	xrt_result_t (*add_device)(struct xrt_space_overseer *xso, struct xrt_device *xdev);
+
+	/*!
+	 * Forget a device before it is destroyed, any pose spaces created from
+	 * it must already be gone.
+	 *
+	 * @param[in] xso  Owning space overseer.
+	 * @param[in] xdev Device to remove.
+	 */
+	xrt_result_t (*remove_device)(struct xrt_space_overseer *xso, struct xrt_device *xdev);
+
 	/*!
 	 * Destroy function.
 	 *
@@ -240,6 +286,27 @@ xrt_space_overseer_locate_space(struct xrt_space_overseer *xso,
 	return xso->locate_space(xso, base_space, base_offset, at_timestamp_ns, space, offset, out_relation);
 }
 
+/*!
+ * @copydoc xrt_space_overseer::locate_spaces
+ *
+ * Helper for calling through the function pointer.
+ *
+ * @public @memberof xrt_space_overseer
+ */
+static inline xrt_result_t
+xrt_space_overseer_locate_spaces(struct xrt_space_overseer *xso,
+                                 struct xrt_space *base_space,
+                                 const struct xrt_pose *base_offset,
+                                 uint64_t at_timestamp_ns,
+                                 struct xrt_space **spaces,
+                                 uint32_t space_count,
+                                 const struct xrt_pose *offsets,
+                                 struct xrt_space_relation *out_relations)
+{
+	return xso->locate_spaces(xso, base_space, base_offset, at_timestamp_ns, spaces, space_count, offsets,
+	                          out_relations);
+}
+
 /*!
  * @copydoc xrt_space_overseer::locate_device
  *
@@ -258,6 +325,32 @@ xrt_space_overseer_locate_device(struct xrt_space_overseer *xso,
 	return xso->locate_device(xso, base_space, base_offset, at_timestamp_ns, xdev, out_relation);
 }
 
+/*!
+ * @copydoc xrt_space_overseer::add_device
+ *
+ * Helper for calling through the function pointer.
+ *
+ * @public @memberof xrt_space_overseer
+ */
+static inline xrt_result_t
+xrt_space_overseer_add_device(struct xrt_space_overseer *xso, struct xrt_device *xdev)
+{
+	return xso->add_device(xso, xdev);
+}
+
+/*!
+ * @copydoc xrt_space_overseer::remove_device
+ *
+ * Helper for calling through the function pointer.
+ *
+ * @public @memberof xrt_space_overseer
+ */
+static inline xrt_result_t
+xrt_space_overseer_remove_device(struct xrt_space_overseer *xso, struct xrt_device *xdev)
+{
+	return xso->remove_device(xso, xdev);
+}
+
 /*!
  * Helper for calling through the function pointer: does a null check and sets
  * xc_ptr to null if freed.
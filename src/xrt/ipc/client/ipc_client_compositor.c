@@ -482,6 +482,20 @@ ipc_compositor_poll_events(struct xrt_compositor *xc, union xrt_compositor_event
 	return res;
 }
 
+static xrt_result_t
+ipc_compositor_set_performance_level(struct xrt_compositor *xc,
+                                     enum xrt_perf_domain domain,
+                                     enum xrt_perf_set_level level)
+{
+	struct ipc_client_compositor *icc = ipc_client_compositor(xc);
+
+	IPC_TRACE(icc->ipc_c, "Setting performance level.");
+
+	IPC_CALL_CHK(ipc_call_compositor_set_performance_level(icc->ipc_c, domain, level));
+
+	return res;
+}
+
 static xrt_result_t
 ipc_compositor_begin_session(struct xrt_compositor *xc, const struct xrt_begin_session_info *info)
 {
@@ -577,6 +591,10 @@ ipc_compositor_layer_stereo_projection(struct xrt_compositor *xc,
 
 	assert(data->type == XRT_LAYER_STEREO_PROJECTION);
 
+	if (icc->layers.layer_count >= IPC_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	struct ipc_shared_memory *ism = icc->ipc_c->ism;
 	struct ipc_layer_slot *slot = &ism->slots[icc->layers.slot_id];
 	struct ipc_layer_entry *layer = &slot->layers[icc->layers.layer_count];
@@ -588,6 +606,8 @@ ipc_compositor_layer_stereo_projection(struct xrt_compositor *xc,
 	layer->swapchain_ids[1] = r->id;
 	layer->swapchain_ids[2] = -1;
 	layer->swapchain_ids[3] = -1;
+	layer->swapchain_ids[4] = -1;
+	layer->swapchain_ids[5] = -1;
 	layer->data = *data;
 
 	// Increment the number of layers.
@@ -609,6 +629,52 @@ ipc_compositor_layer_stereo_projection_depth(struct xrt_compositor *xc,
 
 	assert(data->type == XRT_LAYER_STEREO_PROJECTION_DEPTH);
 
+	if (icc->layers.layer_count >= IPC_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
+	struct ipc_shared_memory *ism = icc->ipc_c->ism;
+	struct ipc_layer_slot *slot = &ism->slots[icc->layers.slot_id];
+	struct ipc_layer_entry *layer = &slot->layers[icc->layers.layer_count];
+	struct ipc_client_swapchain *l = ipc_client_swapchain(l_xsc);
+	struct ipc_client_swapchain *r = ipc_client_swapchain(r_xsc);
+	struct ipc_client_swapchain *l_d = ipc_client_swapchain(l_d_xsc);
+	struct ipc_client_swapchain *r_d = ipc_client_swapchain(r_d_xsc);
+
+	layer->xdev_id = 0; //! @todo Real id.
+	layer->swapchain_ids[0] = l->id;
+	layer->swapchain_ids[1] = r->id;
+	layer->swapchain_ids[2] = l_d->id;
+	layer->swapchain_ids[3] = r_d->id;
+	layer->swapchain_ids[4] = -1;
+	layer->swapchain_ids[5] = -1;
+	layer->data = *data;
+
+	// Increment the number of layers.
+	icc->layers.layer_count++;
+
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+ipc_compositor_layer_stereo_projection_space_warp(struct xrt_compositor *xc,
+                                                  struct xrt_device *xdev,
+                                                  struct xrt_swapchain *l_xsc,
+                                                  struct xrt_swapchain *r_xsc,
+                                                  struct xrt_swapchain *l_d_xsc,
+                                                  struct xrt_swapchain *r_d_xsc,
+                                                  struct xrt_swapchain *l_mv_xsc,
+                                                  struct xrt_swapchain *r_mv_xsc,
+                                                  const struct xrt_layer_data *data)
+{
+	struct ipc_client_compositor *icc = ipc_client_compositor(xc);
+
+	assert(data->type == XRT_LAYER_STEREO_PROJECTION_SPACE_WARP);
+
+	if (icc->layers.layer_count >= IPC_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	struct ipc_shared_memory *ism = icc->ipc_c->ism;
 	struct ipc_layer_slot *slot = &ism->slots[icc->layers.slot_id];
 	struct ipc_layer_entry *layer = &slot->layers[icc->layers.layer_count];
@@ -616,12 +682,16 @@ ipc_compositor_layer_stereo_projection_depth(struct xrt_compositor *xc,
 	struct ipc_client_swapchain *r = ipc_client_swapchain(r_xsc);
 	struct ipc_client_swapchain *l_d = ipc_client_swapchain(l_d_xsc);
 	struct ipc_client_swapchain *r_d = ipc_client_swapchain(r_d_xsc);
+	struct ipc_client_swapchain *l_mv = ipc_client_swapchain(l_mv_xsc);
+	struct ipc_client_swapchain *r_mv = ipc_client_swapchain(r_mv_xsc);
 
 	layer->xdev_id = 0; //! @todo Real id.
 	layer->swapchain_ids[0] = l->id;
 	layer->swapchain_ids[1] = r->id;
 	layer->swapchain_ids[2] = l_d->id;
 	layer->swapchain_ids[3] = r_d->id;
+	layer->swapchain_ids[4] = l_mv->id;
+	layer->swapchain_ids[5] = r_mv->id;
 	layer->data = *data;
 
 	// Increment the number of layers.
@@ -641,6 +711,10 @@ handle_layer(struct xrt_compositor *xc,
 
 	assert(data->type == type);
 
+	if (icc->layers.layer_count >= IPC_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
 	struct ipc_shared_memory *ism = icc->ipc_c->ism;
 	struct ipc_layer_slot *slot = &ism->slots[icc->layers.slot_id];
 	struct ipc_layer_entry *layer = &slot->layers[icc->layers.layer_count];
@@ -651,6 +725,8 @@ handle_layer(struct xrt_compositor *xc,
 	layer->swapchain_ids[1] = -1;
 	layer->swapchain_ids[2] = -1;
 	layer->swapchain_ids[3] = -1;
+	layer->swapchain_ids[4] = -1;
+	layer->swapchain_ids[5] = -1;
 	layer->data = *data;
 
 	// Increment the number of layers.
@@ -704,6 +780,37 @@ ipc_compositor_layer_equirect2(struct xrt_compositor *xc,
 	return handle_layer(xc, xdev, xsc, data, XRT_LAYER_EQUIRECT2);
 }
 
+static xrt_result_t
+ipc_compositor_layer_passthrough(struct xrt_compositor *xc, struct xrt_device *xdev, const struct xrt_layer_data *data)
+{
+	struct ipc_client_compositor *icc = ipc_client_compositor(xc);
+
+	assert(data->type == XRT_LAYER_PASSTHROUGH);
+
+	if (icc->layers.layer_count >= IPC_MAX_LAYERS) {
+		return XRT_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
+	struct ipc_shared_memory *ism = icc->ipc_c->ism;
+	struct ipc_layer_slot *slot = &ism->slots[icc->layers.slot_id];
+	struct ipc_layer_entry *layer = &slot->layers[icc->layers.layer_count];
+
+	// The camera images stay in the service, no swapchains.
+	layer->xdev_id = 0; //! @todo Real id.
+	layer->swapchain_ids[0] = -1;
+	layer->swapchain_ids[1] = -1;
+	layer->swapchain_ids[2] = -1;
+	layer->swapchain_ids[3] = -1;
+	layer->swapchain_ids[4] = -1;
+	layer->swapchain_ids[5] = -1;
+	layer->data = *data;
+
+	// Increment the number of layers.
+	icc->layers.layer_count++;
+
+	return XRT_SUCCESS;
+}
+
 static xrt_result_t
 ipc_compositor_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handle_t sync_handle)
 {
@@ -801,15 +908,18 @@ ipc_compositor_init(struct ipc_client_compositor *icc, struct xrt_compositor_nat
 	icc->base.base.layer_begin = ipc_compositor_layer_begin;
 	icc->base.base.layer_stereo_projection = ipc_compositor_layer_stereo_projection;
 	icc->base.base.layer_stereo_projection_depth = ipc_compositor_layer_stereo_projection_depth;
+	icc->base.base.layer_stereo_projection_space_warp = ipc_compositor_layer_stereo_projection_space_warp;
 	icc->base.base.layer_quad = ipc_compositor_layer_quad;
 	icc->base.base.layer_cube = ipc_compositor_layer_cube;
 	icc->base.base.layer_cylinder = ipc_compositor_layer_cylinder;
 	icc->base.base.layer_equirect1 = ipc_compositor_layer_equirect1;
 	icc->base.base.layer_equirect2 = ipc_compositor_layer_equirect2;
+	icc->base.base.layer_passthrough = ipc_compositor_layer_passthrough;
 	icc->base.base.layer_commit = ipc_compositor_layer_commit;
 	icc->base.base.layer_commit_with_semaphore = ipc_compositor_layer_commit_with_semaphore;
 	icc->base.base.destroy = ipc_compositor_destroy;
 	icc->base.base.poll_events = ipc_compositor_poll_events;
+	icc->base.base.set_performance_level = ipc_compositor_set_performance_level;
 
 	// Using in wait frame.
 	os_precise_sleeper_init(&icc->sleeper);
@@ -18,6 +18,8 @@
 #include "util/u_debug.h"
 #include "util/u_device.h"
 
+#include "shared/ipc_haptic_pcm.h"
+#include "shared/ipc_tracking.h"
 #include "client/ipc_client.h"
 #include "ipc_client_generated.h"
 
@@ -91,6 +93,12 @@ ipc_client_device_get_tracked_pose(struct xrt_device *xdev,
 {
 	ipc_client_device_t *icd = ipc_client_device(xdev);
 
+	// Fast path, interpolate from what the service has published.
+	struct ipc_shared_device_tracking *isdt = &icd->ipc_c->ism->tracking[icd->device_id];
+	if (ipc_tracking_get_tracked_pose(isdt, name, at_timestamp_ns, os_monotonic_get_ns(), out_relation)) {
+		return;
+	}
+
 	xrt_result_t r =
 	    ipc_call_device_get_tracked_pose(icd->ipc_c, icd->device_id, name, at_timestamp_ns, out_relation);
 	if (r != XRT_SUCCESS) {
@@ -107,6 +115,13 @@ ipc_client_device_get_hand_tracking(struct xrt_device *xdev,
 {
 	ipc_client_device_t *icd = ipc_client_device(xdev);
 
+	// Fast path, use the latest joint set the service has published.
+	struct ipc_shared_device_tracking *isdt = &icd->ipc_c->ism->tracking[icd->device_id];
+	if (ipc_tracking_get_hand_tracking(isdt, name, at_timestamp_ns, os_monotonic_get_ns(), out_value,
+	                                   out_timestamp_ns)) {
+		return;
+	}
+
 	xrt_result_t r = ipc_call_device_get_hand_tracking(icd->ipc_c, icd->device_id, name, at_timestamp_ns, out_value,
 	                                                   out_timestamp_ns);
 	if (r != XRT_SUCCESS) {
@@ -138,6 +153,21 @@ ipc_client_device_set_output(struct xrt_device *xdev, enum xrt_output_name name,
 	}
 }
 
+static void
+ipc_client_device_queue_haptic_pcm(struct xrt_device *xdev,
+                                   enum xrt_output_name name,
+                                   const float *samples,
+                                   uint32_t sample_count,
+                                   bool append,
+                                   uint32_t *out_samples_consumed)
+{
+	ipc_client_device_t *icd = ipc_client_device(xdev);
+
+	// No round trip, the service drains the ring into the device.
+	struct ipc_shared_haptic_pcm *ishp = &icd->ipc_c->ism->haptic_pcm[icd->device_id];
+	*out_samples_consumed = ipc_haptic_pcm_write(ishp, name, samples, sample_count, append);
+}
+
 /*!
  * @public @memberof ipc_client_device
  */
@@ -157,6 +187,7 @@ ipc_client_device_create(struct ipc_connection *ipc_c, struct xrt_tracking_origi
 	icd->base.get_hand_tracking = ipc_client_device_get_hand_tracking;
 	icd->base.get_view_poses = ipc_client_device_get_view_poses;
 	icd->base.set_output = ipc_client_device_set_output;
+	icd->base.queue_haptic_pcm = ipc_client_device_queue_haptic_pcm;
 	icd->base.destroy = ipc_client_device_destroy;
 
 	// Start copying the information from the isdev.
@@ -20,6 +20,7 @@
 #include "util/u_device.h"
 #include "util/u_distortion_mesh.h"
 
+#include "shared/ipc_tracking.h"
 #include "client/ipc_client.h"
 #include "ipc_client_generated.h"
 
@@ -93,6 +94,12 @@ ipc_client_hmd_get_tracked_pose(struct xrt_device *xdev,
 {
 	ipc_client_hmd_t *ich = ipc_client_hmd(xdev);
 
+	// Fast path, interpolate from what the service has published.
+	struct ipc_shared_device_tracking *isdt = &ich->ipc_c->ism->tracking[ich->device_id];
+	if (ipc_tracking_get_tracked_pose(isdt, name, at_timestamp_ns, os_monotonic_get_ns(), out_relation)) {
+		return;
+	}
+
 	xrt_result_t r =
 	    ipc_call_device_get_tracked_pose(ich->ipc_c, ich->device_id, name, at_timestamp_ns, out_relation);
 	if (r != XRT_SUCCESS) {
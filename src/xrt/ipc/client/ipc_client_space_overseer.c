@@ -9,8 +9,12 @@
 
 #include "xrt/xrt_space.h"
 
+#include "util/u_misc.h"
+
 #include "ipc_client_generated.h"
 
+#include <string.h>
+
 
 struct ipc_client_space
 {
@@ -149,6 +153,56 @@ locate_space(struct xrt_space_overseer *xso,
 	    out_relation);                  //
 }
 
+static xrt_result_t
+locate_spaces(struct xrt_space_overseer *xso,
+              struct xrt_space *base_space,
+              const struct xrt_pose *base_offset,
+              uint64_t at_timestamp_ns,
+              struct xrt_space **spaces,
+              uint32_t space_count,
+              const struct xrt_pose *offsets,
+              struct xrt_space_relation *out_relations)
+{
+	struct ipc_client_space_overseer *icspo = ipc_client_space_overseer(xso);
+
+	struct ipc_client_space *icsp_base_space = ipc_client_space(base_space);
+
+	// Split into as few calls as possible.
+	for (uint32_t first = 0; first < space_count; first += IPC_MAX_LOCATE_SPACES) {
+		struct ipc_arg_space_locate_spaces args;
+		struct ipc_info_space_locate_spaces info;
+
+		uint32_t count = space_count - first;
+		if (count > IPC_MAX_LOCATE_SPACES) {
+			count = IPC_MAX_LOCATE_SPACES;
+		}
+
+		U_ZERO(&args);
+		args.space_count = count;
+
+		for (uint32_t i = 0; i < count; i++) {
+			struct xrt_space *xs = spaces[first + i];
+			args.space_ids[i] = xs != NULL ? ipc_client_space(xs)->id : UINT32_MAX;
+			args.offsets[i] = offsets[first + i];
+		}
+
+		xrt_result_t xret = ipc_call_space_locate_spaces( //
+		    icspo->ipc_c,                                 //
+		    icsp_base_space->id,                          //
+		    base_offset,                                  //
+		    at_timestamp_ns,                              //
+		    &args,                                        //
+		    &info);                                       //
+		if (xret != XRT_SUCCESS) {
+			return xret;
+		}
+
+		memcpy(&out_relations[first], info.relations, sizeof(*out_relations) * count);
+	}
+
+	return XRT_SUCCESS;
+}
+
 static xrt_result_t
 locate_device(struct xrt_space_overseer *xso,
               struct xrt_space *base_space,
@@ -171,6 +225,19 @@ locate_device(struct xrt_space_overseer *xso,
 	    out_relation);                   //
 }
 
+static xrt_result_t
+add_device(struct xrt_space_overseer *xso, struct xrt_device *xdev)
+{
+	// Devices come and go in the service, never from a client.
+	return XRT_ERROR_IPC_FAILURE;
+}
+
+static xrt_result_t
+remove_device(struct xrt_space_overseer *xso, struct xrt_device *xdev)
+{
+	return XRT_ERROR_IPC_FAILURE;
+}
+
 static void
 destroy(struct xrt_space_overseer *xso)
 {
@@ -199,7 +266,10 @@ ipc_client_space_overseer_create(struct ipc_connection *ipc_c)
 	icspo->base.create_offset_space = create_offset_space;
 	icspo->base.create_pose_space = create_pose_space;
 	icspo->base.locate_space = locate_space;
+	icspo->base.locate_spaces = locate_spaces;
 	icspo->base.locate_device = locate_device;
+	icspo->base.add_device = add_device;
+	icspo->base.remove_device = remove_device;
 	icspo->base.destroy = destroy;
 	icspo->ipc_c = ipc_c;
 
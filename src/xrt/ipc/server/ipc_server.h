@@ -322,6 +322,9 @@ struct ipc_server
 	//! System compositor.
 	struct xrt_system_compositor *xsysc;
 
+	//! Hotplugged devices come from here, NULL if the instance has no prober.
+	struct xrt_prober *xp;
+
 	struct ipc_device idevs[XRT_SYSTEM_MAX_DEVICES];
 	struct xrt_tracking_origin *xtracks[XRT_SYSTEM_MAX_DEVICES];
 
@@ -340,6 +343,27 @@ struct ipc_server
 
 	struct ipc_thread threads[IPC_MAX_CLIENTS];
 
+	//! Publishes device tracking state to the shared memory.
+	struct
+	{
+		struct os_thread_helper oth;
+
+		//! How often to sample the devices, zero if disabled.
+		uint64_t period_ns;
+
+		//! Connected clients, nothing is published while there are none, protected by the helper lock.
+		uint32_t client_count;
+	} tracking;
+
+	//! Drains the PCM haptic sample rings of the shared memory into the devices.
+	struct
+	{
+		struct os_thread_helper oth;
+
+		//! How often to drain the rings.
+		uint64_t period_ns;
+	} haptic_pcm;
+
 	volatile uint32_t current_slot_index;
 
 	//! Generator for IDs.
@@ -363,6 +387,20 @@ struct ipc_server
  */
 int
 ipc_server_main(int argc, char **argv);
+
+/*!
+ * Run the server in the calling thread of a process that also does other
+ * things, like a test or load harness that connects clients to it.
+ *
+ * @param ps Pointer to populate with the server struct.
+ * @param startup_complete_callback Function to call upon completing startup and populating *ps, but before entering the
+ * mainloop, also called if startup fails without touching *ps.
+ * @param data user data to pass to your callback.
+ *
+ * @ingroup ipc_server
+ */
+int
+ipc_server_main_in_process(struct ipc_server **ps, void (*startup_complete_callback)(void *data), void *data);
 #endif
 
 #ifdef XRT_OS_ANDROID
@@ -443,6 +481,15 @@ ipc_server_client_thread(void *_ics);
 void
 ipc_server_client_destroy_compositor(volatile struct ipc_client_state *ics);
 
+/*!
+ * Called by client threads when they start and stop, the tracking publisher
+ * only runs while at least one client is connected.
+ *
+ * @ingroup ipc_server
+ */
+void
+ipc_server_tracking_client_changed(struct ipc_server *s, bool connected);
+
 /*!
  * @defgroup ipc_server_internals Server Internals
  * @brief These are only called by the platform-specific mainloop polling code.
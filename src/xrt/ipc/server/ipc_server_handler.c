@@ -11,6 +11,7 @@
 
 #include "util/u_misc.h"
 #include "util/u_handles.h"
+#include "util/u_time.h"
 #include "util/u_trace_marker.h"
 
 #include "server/ipc_server.h"
@@ -180,6 +181,30 @@ ipc_handle_instance_describe_client(volatile struct ipc_client_state *ics,
 	return XRT_SUCCESS;
 }
 
+xrt_result_t
+ipc_handle_system_dump_trace(volatile struct ipc_client_state *ics,
+                             uint32_t window_ms,
+                             struct ipc_trace_dump *out_dump)
+{
+#ifdef U_TRACE_RECORDER
+	uint64_t window_ns = U_TRACE_RECORDER_DEFAULT_WINDOW_NS;
+	if (window_ms > 0) {
+		window_ns = window_ms * (uint64_t)U_TIME_1MS_IN_NS;
+	}
+
+	xrt_result_t xret = u_trace_recorder_dump(window_ns, out_dump->path, sizeof(out_dump->path));
+	if (xret == XRT_SUCCESS) {
+		IPC_INFO(ics->server, "Wrote trace to '%s'.", out_dump->path);
+	}
+
+	return xret;
+#else
+	IPC_WARN(ics->server, "Not built with the flight recorder, XRT_FEATURE_TRACING_RECORDER.");
+
+	return XRT_ERROR_IPC_FAILURE;
+#endif
+}
+
 xrt_result_t
 ipc_handle_system_compositor_get_info(volatile struct ipc_client_state *ics,
                                       struct xrt_system_compositor_info *out_info)
@@ -416,6 +441,57 @@ ipc_handle_space_locate_space(volatile struct ipc_client_state *ics,
 	    out_relation);                      //
 }
 
+xrt_result_t
+ipc_handle_space_locate_spaces(volatile struct ipc_client_state *ics,
+                               uint32_t base_space_id,
+                               const struct xrt_pose *base_offset,
+                               uint64_t at_timestamp,
+                               const struct ipc_arg_space_locate_spaces *spaces,
+                               struct ipc_info_space_locate_spaces *out_relations)
+{
+	IPC_TRACE_MARKER();
+
+	struct xrt_space_overseer *xso = ics->server->xso;
+	struct xrt_space *base_space = NULL;
+	struct xrt_space *xspaces[IPC_MAX_LOCATE_SPACES] = {0};
+	uint32_t space_count = spaces->space_count;
+	xrt_result_t xret;
+
+	if (space_count > IPC_MAX_LOCATE_SPACES) {
+		U_LOG_E("Too many spaces (%u > %u)!", space_count, IPC_MAX_LOCATE_SPACES);
+		return XRT_ERROR_IPC_FAILURE;
+	}
+
+	xret = validate_space_id(ics, base_space_id, &base_space);
+	if (xret != XRT_SUCCESS) {
+		U_LOG_E("Invalid base_space_id!");
+		return xret;
+	}
+
+	for (uint32_t i = 0; i < space_count; i++) {
+		// Null spaces are allowed and gives zero relations.
+		if (spaces->space_ids[i] == UINT32_MAX) {
+			continue;
+		}
+
+		xret = validate_space_id(ics, spaces->space_ids[i], &xspaces[i]);
+		if (xret != XRT_SUCCESS) {
+			U_LOG_E("Invalid space_ids[%u]!", i);
+			return xret;
+		}
+	}
+
+	return xrt_space_overseer_locate_spaces( //
+	    xso,                                 //
+	    base_space,                          //
+	    base_offset,                         //
+	    at_timestamp,                        //
+	    xspaces,                             //
+	    space_count,                         //
+	    spaces->offsets,                     //
+	    out_relations->relations);           //
+}
+
 xrt_result_t
 ipc_handle_space_locate_device(volatile struct ipc_client_state *ics,
                                uint32_t base_space_id,
@@ -629,6 +705,54 @@ _update_projection_layer_depth(struct xrt_compositor *xc,
 	return true;
 }
 
+static bool
+_update_projection_layer_space_warp(struct xrt_compositor *xc,
+                                    volatile struct ipc_client_state *ics,
+                                    volatile struct ipc_layer_entry *layer,
+                                    uint32_t i)
+{
+	// xdev
+	uint32_t xdevi = layer->xdev_id;
+	// left
+	uint32_t l_xsci = layer->swapchain_ids[0];
+	// right
+	uint32_t r_xsci = layer->swapchain_ids[1];
+	// left depth
+	uint32_t l_d_xsci = layer->swapchain_ids[2];
+	// right depth
+	uint32_t r_d_xsci = layer->swapchain_ids[3];
+	// left motion vectors
+	uint32_t l_mv_xsci = layer->swapchain_ids[4];
+	// right motion vectors
+	uint32_t r_mv_xsci = layer->swapchain_ids[5];
+
+	struct xrt_device *xdev = get_xdev(ics, xdevi);
+	struct xrt_swapchain *l_xcs = ics->xscs[l_xsci];
+	struct xrt_swapchain *r_xcs = ics->xscs[r_xsci];
+	struct xrt_swapchain *l_d_xcs = ics->xscs[l_d_xsci];
+	struct xrt_swapchain *r_d_xcs = ics->xscs[r_d_xsci];
+	struct xrt_swapchain *l_mv_xcs = ics->xscs[l_mv_xsci];
+	struct xrt_swapchain *r_mv_xcs = ics->xscs[r_mv_xsci];
+
+	if (l_xcs == NULL || r_xcs == NULL || l_d_xcs == NULL || r_d_xcs == NULL || l_mv_xcs == NULL ||
+	    r_mv_xcs == NULL) {
+		U_LOG_E("Invalid swap chain for projection layer #%u!", i);
+		return false;
+	}
+
+	if (xdev == NULL) {
+		U_LOG_E("Invalid xdev for projection layer #%u!", i);
+		return false;
+	}
+
+	// Cast away volatile.
+	struct xrt_layer_data *data = (struct xrt_layer_data *)&layer->data;
+
+	xrt_comp_layer_stereo_projection_space_warp(xc, xdev, l_xcs, r_xcs, l_d_xcs, r_d_xcs, l_mv_xcs, r_mv_xcs, data);
+
+	return true;
+}
+
 static bool
 do_single(struct xrt_compositor *xc,
           volatile struct ipc_client_state *ics,
@@ -760,6 +884,27 @@ _update_equirect2_layer(struct xrt_compositor *xc,
 	return true;
 }
 
+static bool
+_update_passthrough_layer(struct xrt_compositor *xc,
+                          volatile struct ipc_client_state *ics,
+                          volatile struct ipc_layer_entry *layer,
+                          uint32_t i)
+{
+	struct xrt_device *xdev = get_xdev(ics, layer->xdev_id);
+
+	if (xdev == NULL) {
+		U_LOG_E("Invalid xdev for passthrough layer #%u!", i);
+		return false;
+	}
+
+	// Cast away volatile.
+	struct xrt_layer_data *data = (struct xrt_layer_data *)&layer->data;
+
+	xrt_comp_layer_passthrough(xc, xdev, data);
+
+	return true;
+}
+
 static bool
 _update_layers(volatile struct ipc_client_state *ics, struct xrt_compositor *xc, struct ipc_layer_slot *slot)
 {
@@ -779,6 +924,11 @@ _update_layers(volatile struct ipc_client_state *ics, struct xrt_compositor *xc,
 				return false;
 			}
 			break;
+		case XRT_LAYER_STEREO_PROJECTION_SPACE_WARP:
+			if (!_update_projection_layer_space_warp(xc, ics, layer, i)) {
+				return false;
+			}
+			break;
 		case XRT_LAYER_QUAD:
 			if (!_update_quad_layer(xc, ics, layer, i)) {
 				return false;
@@ -804,6 +954,11 @@ _update_layers(volatile struct ipc_client_state *ics, struct xrt_compositor *xc,
 				return false;
 			}
 			break;
+		case XRT_LAYER_PASSTHROUGH:
+			if (!_update_passthrough_layer(xc, ics, layer, i)) {
+				return false;
+			}
+			break;
 		default: U_LOG_E("Unhandled layer type '%i'!", layer->data.type); break;
 		}
 	}
@@ -937,6 +1092,20 @@ ipc_handle_compositor_poll_events(volatile struct ipc_client_state *ics, union x
 	return xrt_comp_poll_events(ics->xc, out_xce);
 }
 
+xrt_result_t
+ipc_handle_compositor_set_performance_level(volatile struct ipc_client_state *ics,
+                                            enum xrt_perf_domain domain,
+                                            enum xrt_perf_set_level level)
+{
+	IPC_TRACE_MARKER();
+
+	if (ics->xc == NULL) {
+		return XRT_ERROR_IPC_SESSION_NOT_CREATED;
+	}
+
+	return xrt_comp_set_performance_level(ics->xc, domain, level);
+}
+
 xrt_result_t
 ipc_handle_system_get_clients(volatile struct ipc_client_state *_ics, struct ipc_client_list *list)
 {
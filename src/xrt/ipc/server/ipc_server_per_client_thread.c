@@ -388,8 +388,13 @@ void *
 ipc_server_client_thread(void *_ics)
 {
 	volatile struct ipc_client_state *ics = (volatile struct ipc_client_state *)_ics;
+	struct ipc_server *s = ics->server;
+
+	ipc_server_tracking_client_changed(s, true);
 
 	client_loop(ics);
 
+	ipc_server_tracking_client_changed(s, false);
+
 	return NULL;
 }
@@ -10,6 +10,7 @@
  */
 
 #include "xrt/xrt_device.h"
+#include "xrt/xrt_prober.h"
 #include "xrt/xrt_system.h"
 #include "xrt/xrt_instance.h"
 #include "xrt/xrt_compositor.h"
@@ -24,10 +25,13 @@
 #include "util/u_verify.h"
 #include "util/u_process.h"
 #include "util/u_debug_gui.h"
+#include "util/u_system_helpers.h"
 
 #include "util/u_git_tag.h"
 
 #include "shared/ipc_shmem.h"
+#include "shared/ipc_haptic_pcm.h"
+#include "shared/ipc_tracking.h"
 #include "server/ipc_server.h"
 
 #include <stdlib.h>
@@ -50,6 +54,8 @@
 
 DEBUG_GET_ONCE_BOOL_OPTION(exit_on_disconnect, "IPC_EXIT_ON_DISCONNECT", false)
 DEBUG_GET_ONCE_LOG_OPTION(ipc_log, "IPC_LOG", U_LOGGING_WARN)
+DEBUG_GET_ONCE_NUM_OPTION(tracking_publish_ms, "IPC_TRACKING_PUBLISH_MS", 2)
+DEBUG_GET_ONCE_NUM_OPTION(haptic_pcm_drain_ms, "IPC_HAPTIC_PCM_DRAIN_MS", 2)
 
 
 /*
@@ -128,6 +134,10 @@ teardown_all(struct ipc_server *s)
 {
 	u_var_remove_root(s);
 
+	// Stop sampling the devices before they go away.
+	os_thread_helper_destroy(&s->tracking.oth);
+	os_thread_helper_destroy(&s->haptic_pcm.oth);
+
 	xrt_syscomp_destroy(&s->xsysc);
 
 	teardown_idevs(s);
@@ -213,30 +223,138 @@ handle_binding(struct ipc_shared_memory *ism,
 	*output_pair_index_ptr = output_pair_index;
 }
 
+static void *
+tracking_publisher_thread(void *ptr)
+{
+	struct ipc_server *s = (struct ipc_server *)ptr;
+
+	U_TRACE_SET_THREAD_NAME("IPC Server: Tracking");
+	os_thread_helper_name(&s->tracking.oth, "IPC Server: Tracking");
+
+	os_thread_helper_lock(&s->tracking.oth);
+
+	while (os_thread_helper_is_running_locked(&s->tracking.oth)) {
+		// Nobody to read the shared memory, don't keep the devices busy.
+		if (s->tracking.client_count == 0) {
+			os_thread_helper_wait_locked(&s->tracking.oth);
+			continue;
+		}
+
+		os_thread_helper_unlock(&s->tracking.oth);
+
+		uint64_t now_ns = os_monotonic_get_ns();
+
+		// Same indexing as the isdevs, see init_shm.
+		uint32_t count = 0;
+		for (size_t i = 0; i < XRT_SYSTEM_MAX_DEVICES; i++) {
+			struct xrt_device *xdev = s->idevs[i].xdev;
+			if (xdev == NULL) {
+				continue;
+			}
+
+			ipc_tracking_publish(&s->ism->tracking[count++], xdev, now_ns);
+		}
+
+		os_nanosleep((int64_t)s->tracking.period_ns);
+
+		os_thread_helper_lock(&s->tracking.oth);
+	}
+
+	os_thread_helper_unlock(&s->tracking.oth);
+
+	return NULL;
+}
+
 static int
-init_shm(struct ipc_server *s)
+init_tracking_publisher(struct ipc_server *s)
 {
-	const size_t size = sizeof(struct ipc_shared_memory);
-	xrt_shmem_handle_t handle;
-	xrt_result_t result = ipc_shmem_create(size, &handle, (void **)&s->ism);
-	if (result != XRT_SUCCESS) {
-		return -1;
+	long period_ms = debug_get_num_option_tracking_publish_ms();
+	if (period_ms <= 0) {
+		IPC_INFO(s, "Not publishing tracking to clients, all poses go over IPC.");
+		return 0;
 	}
 
-	// we have a filehandle, we will pass this to our client
-	s->ism_handle = handle;
+	s->tracking.period_ns = (uint64_t)period_ms * U_TIME_1MS_IN_NS;
+
+	// Same indexing as the isdevs, see init_shm.
+	uint32_t count = 0;
+	for (size_t i = 0; i < XRT_SYSTEM_MAX_DEVICES; i++) {
+		struct xrt_device *xdev = s->idevs[i].xdev;
+		if (xdev == NULL) {
+			continue;
+		}
+
+		ipc_tracking_init(&s->ism->tracking[count++], xdev);
+	}
+
+	return os_thread_helper_start(&s->tracking.oth, tracking_publisher_thread, s);
+}
+
+static void *
+haptic_pcm_drain_thread(void *ptr)
+{
+	struct ipc_server *s = (struct ipc_server *)ptr;
+
+	U_TRACE_SET_THREAD_NAME("IPC Server: Haptics");
+	os_thread_helper_name(&s->haptic_pcm.oth, "IPC Server: Haptics");
+
+	while (os_thread_helper_is_running(&s->haptic_pcm.oth)) {
+		// Same indexing as the isdevs, see init_shm.
+		uint32_t count = 0;
+		for (size_t i = 0; i < XRT_SYSTEM_MAX_DEVICES; i++) {
+			struct xrt_device *xdev = s->idevs[i].xdev;
+			if (xdev == NULL) {
+				continue;
+			}
+
+			ipc_haptic_pcm_drain(&s->ism->haptic_pcm[count++], xdev);
+		}
+
+		os_nanosleep((int64_t)s->haptic_pcm.period_ns);
+	}
 
+	return NULL;
+}
 
-	/*
-	 *
-	 * Setup the shared memory state.
-	 *
-	 */
+static int
+init_haptic_pcm(struct ipc_server *s)
+{
+	long period_ms = debug_get_num_option_haptic_pcm_drain_ms();
+	if (period_ms <= 0) {
+		period_ms = 1;
+	}
+
+	s->haptic_pcm.period_ns = (uint64_t)period_ms * U_TIME_1MS_IN_NS;
 
+	// Same indexing as the isdevs, see init_shm.
 	uint32_t count = 0;
-	struct ipc_shared_memory *ism = s->ism;
+	bool any = false;
+	for (size_t i = 0; i < XRT_SYSTEM_MAX_DEVICES; i++) {
+		struct xrt_device *xdev = s->idevs[i].xdev;
+		if (xdev == NULL) {
+			continue;
+		}
+
+		any |= ipc_haptic_pcm_init(&s->ism->haptic_pcm[count++], xdev);
+	}
+
+	// No thread if there is nothing to drain, clients see unbound rings.
+	if (!any) {
+		return 0;
+	}
 
-	ism->startup_timestamp = os_monotonic_get_ns();
+	return os_thread_helper_start(&s->haptic_pcm.oth, haptic_pcm_drain_thread, s);
+}
+
+/*!
+ * Everything in the shared memory that follows the devices, also used to
+ * refill it when hotplugged devices come and go.
+ */
+static void
+init_shm_devices(struct ipc_server *s)
+{
+	uint32_t count = 0;
+	struct ipc_shared_memory *ism = s->ism;
 
 	// Setup the tracking origins.
 	count = 0;
@@ -365,6 +483,24 @@ init_shm(struct ipc_server *s)
 	ism->roles.hand_tracking.left = find_xdev_index(s, s->xsysd->roles.hand_tracking.left);
 	ism->roles.hand_tracking.right = find_xdev_index(s, s->xsysd->roles.hand_tracking.right);
 	ism->roles.eyes = find_xdev_index(s, s->xsysd->roles.eyes);
+}
+
+static int
+init_shm(struct ipc_server *s)
+{
+	const size_t size = sizeof(struct ipc_shared_memory);
+	xrt_shmem_handle_t handle;
+	xrt_result_t result = ipc_shmem_create(size, &handle, (void **)&s->ism);
+	if (result != XRT_SUCCESS) {
+		return -1;
+	}
+
+	// we have a filehandle, we will pass this to our client
+	s->ism_handle = handle;
+
+	s->ism->startup_timestamp = os_monotonic_get_ns();
+
+	init_shm_devices(s);
 
 	// Fill out git version info.
 	snprintf(s->ism->u_git_tag, IPC_VERSION_NAME_LEN, "%s", u_git_tag);
@@ -453,12 +589,165 @@ ipc_server_handle_client_connected(struct ipc_server *vs, xrt_ipc_handle_t ipc_h
 	os_mutex_unlock(&vs->global_state.lock);
 }
 
+
+/*
+ *
+ * Hotplug functions.
+ *
+ */
+
+struct hotplug_state
+{
+	struct ipc_server *s;
+
+	//! Set once the threads using the devices have been stopped.
+	bool changed;
+};
+
+static bool
+has_clients_locked(struct ipc_server *s)
+{
+	for (uint32_t i = 0; i < IPC_MAX_CLIENTS; i++) {
+		if (s->threads[i].ics.server_thread_index >= 0) {
+			return true;
+		}
+	}
+
+	// Client threads that are still tearing down count too.
+	os_thread_helper_lock(&s->tracking.oth);
+	bool any = s->tracking.client_count > 0;
+	os_thread_helper_unlock(&s->tracking.oth);
+
+	return any;
+}
+
+static void
+hotplug_cb(struct xrt_prober *xp,
+           enum xrt_prober_hotplug_event event,
+           struct xrt_prober_device *xpdev,
+           struct xrt_device **xdevs,
+           size_t xdev_count,
+           void *ptr)
+{
+	struct hotplug_state *hs = (struct hotplug_state *)ptr;
+	struct ipc_server *s = hs->s;
+
+	if (xdev_count == 0) {
+		return;
+	}
+
+	// Nothing may look at the devices while they change, restarted in handle_hotplug.
+	if (!hs->changed) {
+		os_thread_helper_stop_and_wait(&s->tracking.oth);
+		os_thread_helper_stop_and_wait(&s->haptic_pcm.oth);
+		hs->changed = true;
+	}
+
+	for (size_t i = 0; i < xdev_count; i++) {
+		if (xdevs[i] == NULL) {
+			continue;
+		}
+
+		if (event == XRT_PROBER_HOTPLUG_ADDED) {
+			IPC_INFO(s, "Adding hotplugged device '%s'", xdevs[i]->str);
+
+			if (!u_system_devices_add_device(s->xsysd, xdevs[i])) {
+				xdevs[i] = NULL;
+				continue;
+			}
+
+			xrt_space_overseer_add_device(s->xso, xdevs[i]);
+			continue;
+		}
+
+		// The view space is made from the head device, it has to stay.
+		if (xdevs[i] == s->xsysd->roles.head) {
+			IPC_WARN(s, "Keeping unplugged head device '%s'", xdevs[i]->str);
+			continue;
+		}
+
+		IPC_INFO(s, "Removing unplugged device '%s'", xdevs[i]->str);
+
+		xrt_space_overseer_remove_device(s->xso, xdevs[i]);
+		u_system_devices_remove_device(s->xsysd, &xdevs[i]);
+	}
+}
+
+/*!
+ * Add and remove hotplugged devices, only done while no client is connected
+ * as clients keep the indices of the shared device list they connected with.
+ * Until then the events wait in the prober.
+ */
+static void
+handle_hotplug(struct ipc_server *s)
+{
+	if (s->xp == NULL) {
+		return;
+	}
+
+	// Also keeps clients from connecting, as they are accepted on this thread.
+	os_mutex_lock(&s->global_state.lock);
+
+	if (has_clients_locked(s)) {
+		os_mutex_unlock(&s->global_state.lock);
+		return;
+	}
+
+	struct hotplug_state hs = {.s = s};
+	xrt_result_t xret = xrt_prober_handle_hotplug(s->xp, hotplug_cb, &hs);
+	if (xret != XRT_SUCCESS) {
+		IPC_ERROR(s, "Failed to handle hotplug events: %d", xret);
+	}
+
+	if (hs.changed) {
+		// Everything indexed by the devices is rebuilt from the system devices.
+		U_ZERO_ARRAY(s->idevs);
+		U_ZERO_ARRAY(s->xtracks);
+		init_idevs(s);
+		init_tracking_origins(s);
+
+		U_ZERO_ARRAY(s->ism->itracks);
+		U_ZERO_ARRAY(s->ism->isdevs);
+		U_ZERO_ARRAY(s->ism->tracking);
+		U_ZERO_ARRAY(s->ism->haptic_pcm);
+		U_ZERO(&s->ism->hmd);
+		U_ZERO_ARRAY(s->ism->inputs);
+		U_ZERO_ARRAY(s->ism->outputs);
+		U_ZERO_ARRAY(s->ism->binding_profiles);
+		U_ZERO_ARRAY(s->ism->input_pairs);
+		U_ZERO_ARRAY(s->ism->output_pairs);
+		init_shm_devices(s);
+
+		if (init_tracking_publisher(s) < 0) {
+			IPC_ERROR(s, "Failed to restart tracking publisher!");
+		}
+		if (init_haptic_pcm(s) < 0) {
+			IPC_ERROR(s, "Failed to restart haptics thread!");
+		}
+	}
+
+	os_mutex_unlock(&s->global_state.lock);
+}
+
 static int
 init_all(struct ipc_server *s)
 {
 	xrt_result_t xret;
 	int ret;
 
+	ret = os_thread_helper_init(&s->tracking.oth);
+	if (ret < 0) {
+		U_LOG_E("Tracking thread helper failed to init!");
+		return ret;
+	}
+
+	ret = os_thread_helper_init(&s->haptic_pcm.oth);
+	if (ret < 0) {
+		U_LOG_E("Haptics thread helper failed to init!");
+		os_thread_helper_destroy(&s->tracking.oth);
+		return ret;
+	}
+
 	ret = os_mutex_init(&s->global_state.lock);
 	if (ret < 0) {
 		IPC_ERROR(s, "Global state lock mutex failed to init!");
@@ -493,6 +782,12 @@ init_all(struct ipc_server *s)
 		return -1;
 	}
 
+	// Not all instances have a prober, then there is no hotplug either.
+	xret = xrt_instance_get_prober(s->xinst, &s->xp);
+	if (xret != XRT_SUCCESS) {
+		s->xp = NULL;
+	}
+
 	ret = init_idevs(s);
 	if (ret < 0) {
 		IPC_ERROR(s, "Failed to init idevs!");
@@ -514,6 +809,20 @@ init_all(struct ipc_server *s)
 		return ret;
 	}
 
+	ret = init_tracking_publisher(s);
+	if (ret < 0) {
+		IPC_ERROR(s, "Failed to start tracking publisher!");
+		teardown_all(s);
+		return ret;
+	}
+
+	ret = init_haptic_pcm(s);
+	if (ret < 0) {
+		IPC_ERROR(s, "Failed to start haptics thread!");
+		teardown_all(s);
+		return ret;
+	}
+
 	ret = ipc_server_mainloop_init(&s->ml);
 	if (ret < 0) {
 		IPC_ERROR(s, "Failed to init ipc main loop!");
@@ -537,6 +846,8 @@ main_loop(struct ipc_server *s)
 
 		// Check polling.
 		ipc_server_mainloop_poll(s, &s->ml);
+
+		handle_hotplug(s);
 	}
 
 	return 0;
@@ -833,6 +1144,24 @@ ipc_server_toggle_io_client(struct ipc_server *s, uint32_t client_id)
 	return xret;
 }
 
+void
+ipc_server_tracking_client_changed(struct ipc_server *s, bool connected)
+{
+	os_thread_helper_lock(&s->tracking.oth);
+
+	if (connected) {
+		s->tracking.client_count++;
+	} else {
+		assert(s->tracking.client_count > 0);
+		s->tracking.client_count--;
+	}
+
+	// Wakes the publisher up if this was the first client, harmless otherwise.
+	os_thread_helper_signal_locked(&s->tracking.oth);
+
+	os_thread_helper_unlock(&s->tracking.oth);
+}
+
 void
 ipc_server_activate_session(volatile struct ipc_client_state *ics)
 {
@@ -929,9 +1258,12 @@ ipc_server_main(int argc, char **argv)
 
 #endif // !XRT_OS_ANDROID
 
-#ifdef XRT_OS_ANDROID
-int
-ipc_server_main_android(struct ipc_server **ps, void (*startup_complete_callback)(void *data), void *data)
+/*!
+ * Shared by the entrypoints that hand the server struct back to the caller, so
+ * it can add clients or shut the server down from another thread.
+ */
+static int
+main_with_startup_callback(struct ipc_server **ps, void (*startup_complete_callback)(void *data), void *data)
 {
 	struct ipc_server *s = U_TYPED_CALLOC(struct ipc_server);
 	U_LOG_D("Created IPC server!");
@@ -957,4 +1289,19 @@ ipc_server_main_android(struct ipc_server **ps, void (*startup_complete_callback
 
 	return ret;
 }
+
+#ifndef XRT_OS_ANDROID
+int
+ipc_server_main_in_process(struct ipc_server **ps, void (*startup_complete_callback)(void *data), void *data)
+{
+	return main_with_startup_callback(ps, startup_complete_callback, data);
+}
+#endif // !XRT_OS_ANDROID
+
+#ifdef XRT_OS_ANDROID
+int
+ipc_server_main_android(struct ipc_server **ps, void (*startup_complete_callback)(void *data), void *data)
+{
+	return main_with_startup_callback(ps, startup_complete_callback, data);
+}
 #endif // XRT_OS_ANDROID
@@ -0,0 +1,185 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  PCM haptic sample ring in shared memory.
+ * @author agent <agent@local>
+ * @ingroup ipc_shared
+ */
+
+#include "xrt/xrt_device.h"
+
+#include "util/u_misc.h"
+
+#include "shared/ipc_haptic_pcm.h"
+
+#if defined(_MSC_VER)
+#include "xrt/xrt_windows.h"
+#endif
+
+#include <assert.h>
+
+
+#define RING_MASK (IPC_SHARED_HAPTIC_PCM_RING_SIZE - 1)
+
+static_assert((IPC_SHARED_HAPTIC_PCM_RING_SIZE & RING_MASK) == 0, "Ring size must be a power of two");
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static inline void
+full_barrier(void)
+{
+#if defined(__GNUC__)
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	MemoryBarrier();
+#else
+#error "compiler not supported"
+#endif
+}
+
+/*!
+ * Samples written but not yet given to the device, a client that has written
+ * garbage to the positions can not make the service read out of bounds.
+ */
+static inline uint32_t
+get_used(uint32_t write_pos, uint32_t read_pos)
+{
+	uint32_t used = write_pos - read_pos;
+	if (used > IPC_SHARED_HAPTIC_PCM_RING_SIZE) {
+		return IPC_SHARED_HAPTIC_PCM_RING_SIZE;
+	}
+	return used;
+}
+
+
+/*
+ *
+ * 'Exported' service functions.
+ *
+ */
+
+bool
+ipc_haptic_pcm_init(struct ipc_shared_haptic_pcm *ishp, struct xrt_device *xdev)
+{
+	U_ZERO(ishp);
+
+	for (size_t i = 0; i < xdev->output_count; i++) {
+		if (xdev->outputs[i].pcm_sample_rate > 0.0f) {
+			ishp->name = xdev->outputs[i].name;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void
+ipc_haptic_pcm_drain(struct ipc_shared_haptic_pcm *ishp, struct xrt_device *xdev)
+{
+	if (ishp->name == 0) {
+		return;
+	}
+
+	uint32_t read_pos = ishp->read_pos;
+	bool append = true;
+
+	// The position and the count are not written atomically together, retry next time if they moved.
+	int32_t flush_count = ishp->flush_count;
+	if (flush_count != ishp->flush_seen) {
+		full_barrier();
+		uint32_t flush_pos = ishp->flush_pos;
+		full_barrier();
+		if (flush_count != ishp->flush_count) {
+			return;
+		}
+
+		// Positions wrap around, only ever move forward.
+		if ((int32_t)(flush_pos - read_pos) > 0) {
+			read_pos = flush_pos;
+		}
+
+		ishp->flush_seen = flush_count;
+		append = false;
+	}
+
+	uint32_t write_pos = ishp->write_pos;
+	full_barrier();
+
+	uint32_t count = get_used(write_pos, read_pos);
+	if (count == 0 && append) {
+		return;
+	}
+
+	float samples[IPC_SHARED_HAPTIC_PCM_RING_SIZE];
+	for (uint32_t i = 0; i < count; i++) {
+		samples[i] = ishp->samples[(read_pos + i) & RING_MASK];
+	}
+
+	uint32_t consumed = 0;
+	xrt_device_queue_haptic_pcm(xdev, ishp->name, samples, count, append, &consumed);
+	if (consumed > count) {
+		consumed = count;
+	}
+
+	// All samples are copied out before the clients may overwrite them.
+	full_barrier();
+	ishp->read_pos = read_pos + consumed;
+}
+
+
+/*
+ *
+ * 'Exported' client functions.
+ *
+ */
+
+uint32_t
+ipc_haptic_pcm_write(struct ipc_shared_haptic_pcm *ishp,
+                     enum xrt_output_name name,
+                     const float *samples,
+                     uint32_t sample_count,
+                     bool append)
+{
+	if (ishp->name == 0 || ishp->name != name) {
+		return 0;
+	}
+
+	// Full barrier, another client might be writing, it is done soon so just report no samples taken.
+	if (xrt_atomic_s32_cmpxchg(&ishp->write_lock, 0, 1) != 0) {
+		return 0;
+	}
+
+	uint32_t write_pos = ishp->write_pos;
+
+	// Not appending drops the unread samples, so all of the ring is free.
+	uint32_t free_count = IPC_SHARED_HAPTIC_PCM_RING_SIZE;
+	if (append) {
+		free_count -= get_used(write_pos, ishp->read_pos);
+	}
+	uint32_t count = sample_count < free_count ? sample_count : free_count;
+
+	// Full barrier, the position is visible before the count.
+	if (!append) {
+		ishp->flush_pos = write_pos;
+		xrt_atomic_s32_inc_return(&ishp->flush_count);
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		ishp->samples[(write_pos + i) & RING_MASK] = samples[i];
+	}
+
+	// The samples are visible before the position.
+	full_barrier();
+	ishp->write_pos = write_pos + count;
+
+	full_barrier();
+	ishp->write_lock = 0;
+
+	return count;
+}
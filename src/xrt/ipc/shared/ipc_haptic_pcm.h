@@ -0,0 +1,68 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  PCM haptic sample ring in shared memory.
+ *
+ * Clients write samples into @ref ipc_shared_haptic_pcm without a round trip,
+ * the service drains them into the device at a fixed period. Clients take a
+ * try-lock among themselves, the service never takes it, so neither side can
+ * be blocked by the other.
+ *
+ * @author agent <agent@local>
+ * @ingroup ipc_shared
+ */
+
+#pragma once
+
+#include "shared/ipc_protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * Service side, binds the ring to the first output of the device that takes
+ * PCM samples, must be called before clients connect.
+ *
+ * @return True if the device has such an output.
+ * @ingroup ipc_shared
+ */
+bool
+ipc_haptic_pcm_init(struct ipc_shared_haptic_pcm *ishp, struct xrt_device *xdev);
+
+/*!
+ * Service side, gives the device all samples written since the last call,
+ * those it has no room for are left in the ring for the next call.
+ *
+ * @ingroup ipc_shared
+ */
+void
+ipc_haptic_pcm_drain(struct ipc_shared_haptic_pcm *ishp, struct xrt_device *xdev);
+
+/*!
+ * Client side, writes as many samples as there is room for.
+ *
+ * @param[in] ishp         The ring.
+ * @param[in] name         Output the samples are for, must be the output the
+ *                         ring is bound to.
+ * @param[in] samples      Samples in the range [-1, 1].
+ * @param[in] sample_count Number of samples.
+ * @param[in] append       If false samples not yet given to the device are
+ *                         dropped, and the device drops its queued ones.
+ *
+ * @return How many samples were written, zero if another client is writing.
+ * @ingroup ipc_shared
+ */
+uint32_t
+ipc_haptic_pcm_write(struct ipc_shared_haptic_pcm *ishp,
+                     enum xrt_output_name name,
+                     const float *samples,
+                     uint32_t sample_count,
+                     bool append);
+
+
+#ifdef __cplusplus
+}
+#endif
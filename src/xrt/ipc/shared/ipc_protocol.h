@@ -26,18 +26,24 @@
 
 
 #define IPC_CRED_SIZE 1    // auth not implemented
-#define IPC_BUF_SIZE 512   // must be >= largest message length in bytes
+#define IPC_BUF_SIZE 4096  // must be >= largest message length in bytes
 #define IPC_MAX_VIEWS 8    // max views we will return configs for
 #define IPC_MAX_FORMATS 32 // max formats our server-side compositor supports
 #define IPC_MAX_DEVICES 8  // max number of devices we will map using shared mem
 #define IPC_MAX_LAYERS 16
 #define IPC_MAX_SLOTS 128
 #define IPC_MAX_CLIENTS 8
+#define IPC_MAX_LOCATE_SPACES 64 // max spaces located in one call, larger batches are split
 #define IPC_EVENT_QUEUE_SIZE 32
 
 #define IPC_SHARED_MAX_INPUTS 1024
 #define IPC_SHARED_MAX_OUTPUTS 128
 #define IPC_SHARED_MAX_BINDINGS 64
+#define IPC_SHARED_MAX_TRACKED_POSES 4 // max pose inputs per device replicated to clients
+#define IPC_SHARED_MAX_TRACKED_HANDS 2 // max hand tracking inputs per device replicated to clients
+#define IPC_SHARED_POSE_HISTORY_SIZE 8 // samples kept per replicated pose
+#define IPC_SHARED_HAPTIC_PCM_RING_SIZE 4096 // power of two, fits XR_MAX_HAPTIC_PCM_BUFFER_SIZE_FB
+#define IPC_TRACE_DUMP_PATH_SIZE 512          // path of a flight recorder dump written by the service
 
 // example: v21.0.0-560-g586d33b5
 #define IPC_VERSION_NAME_LEN 64
@@ -132,6 +138,108 @@ struct ipc_shared_device
 	bool form_factor_check_supported;
 };
 
+/*!
+ * A single timestamped pose sample in the shared memory area.
+ *
+ * @ingroup ipc
+ */
+struct ipc_shared_pose_sample
+{
+	uint64_t timestamp_ns;
+	struct xrt_space_relation relation;
+};
+
+/*!
+ * The recent history of a single pose input, a ring buffer of samples.
+ *
+ * @ingroup ipc
+ */
+struct ipc_shared_tracked_pose
+{
+	enum xrt_input_name name;
+
+	//! When the service last published, zero if nothing has been published yet.
+	uint64_t published_ns;
+
+	//! Number of valid samples, up to @ref IPC_SHARED_POSE_HISTORY_SIZE.
+	uint32_t sample_count;
+
+	//! Index of the newest sample in @ref samples.
+	uint32_t newest;
+
+	struct ipc_shared_pose_sample samples[IPC_SHARED_POSE_HISTORY_SIZE];
+};
+
+/*!
+ * The latest joint set of a single hand tracking input.
+ *
+ * @ingroup ipc
+ */
+struct ipc_shared_tracked_hand
+{
+	enum xrt_input_name name;
+
+	//! When the service sampled the device, zero if nothing has been published yet.
+	uint64_t published_ns;
+
+	//! Timestamp of the joint set as returned by the device.
+	uint64_t timestamp_ns;
+
+	struct xrt_hand_joint_set value;
+};
+
+/*!
+ * Tracking state of a device replicated by the service, lets clients answer
+ * pose and hand tracking queries without a round trip. Protected by a seqlock,
+ * see ipc_tracking.h for the functions to access it.
+ *
+ * @ingroup ipc
+ */
+struct ipc_shared_device_tracking
+{
+	//! Odd while the service is writing.
+	xrt_atomic_s32_t seq;
+
+	uint32_t pose_count;
+	struct ipc_shared_tracked_pose poses[IPC_SHARED_MAX_TRACKED_POSES];
+
+	uint32_t hand_count;
+	struct ipc_shared_tracked_hand hands[IPC_SHARED_MAX_TRACKED_HANDS];
+};
+
+/*!
+ * PCM haptic samples for the output of a device, clients write them without a
+ * round trip and the service drains them into the device. A ring with free
+ * running positions, see ipc_haptic_pcm.h for the functions to access it.
+ *
+ * @ingroup ipc
+ */
+struct ipc_shared_haptic_pcm
+{
+	//! The output the samples are for, zero if the device has no PCM output.
+	enum xrt_output_name name;
+
+	//! Non-zero while a client is writing, clients never wait on each other.
+	xrt_atomic_s32_t write_lock;
+
+	//! Bumped by a client that does not append, samples before @ref flush_pos are dropped.
+	xrt_atomic_s32_t flush_count;
+
+	//! Position where the samples of the latest non-appending write start.
+	volatile uint32_t flush_pos;
+
+	//! Position after the newest sample, only moved by clients.
+	volatile uint32_t write_pos;
+
+	//! Position of the next sample to give to the device, only moved by the service.
+	volatile uint32_t read_pos;
+
+	//! The last @ref flush_count the service acted on, only used by the service.
+	int32_t flush_seen;
+
+	float samples[IPC_SHARED_HAPTIC_PCM_RING_SIZE];
+};
+
 /*!
  * Data for a single composition layer.
  *
@@ -145,11 +253,11 @@ struct ipc_layer_entry
 	uint32_t xdev_id;
 
 	/*!
-	 * Up to two indices of swapchains to use.
+	 * Up to six indices of swapchains to use.
 	 *
 	 * How many are actually used depends on the value of @p data.type
 	 */
-	uint32_t swapchain_ids[4];
+	uint32_t swapchain_ids[6];
 
 	/*!
 	 * All basic (trivially-serializable) data associated with a layer,
@@ -216,6 +324,16 @@ struct ipc_shared_memory
 	 */
 	struct ipc_shared_device isdevs[XRT_SYSTEM_MAX_DEVICES];
 
+	/*!
+	 * @brief Replicated tracking state per device, same indexing as @ref isdevs.
+	 */
+	struct ipc_shared_device_tracking tracking[XRT_SYSTEM_MAX_DEVICES];
+
+	/*!
+	 * @brief PCM haptic sample rings per device, same indexing as @ref isdevs.
+	 */
+	struct ipc_shared_haptic_pcm haptic_pcm[XRT_SYSTEM_MAX_DEVICES];
+
 	/*!
 	 * Various roles for the devices.
 	 */
@@ -289,6 +407,16 @@ struct ipc_client_list
 	uint32_t id_count;
 };
 
+/*!
+ * Where the service wrote a flight recorder trace.
+ *
+ * @ingroup ipc
+ */
+struct ipc_trace_dump
+{
+	char path[IPC_TRACE_DUMP_PATH_SIZE];
+};
+
 /*!
  * State for a connected application.
  *
@@ -319,6 +447,25 @@ struct ipc_arg_swapchain_from_native
 	uint32_t sizes[XRT_MAX_SWAPCHAIN_IMAGES];
 };
 
+/*!
+ * Arguments for xrt_space_overseer::locate_spaces, space ids of UINT32_MAX
+ * are null spaces.
+ */
+struct ipc_arg_space_locate_spaces
+{
+	uint32_t space_ids[IPC_MAX_LOCATE_SPACES];
+	struct xrt_pose offsets[IPC_MAX_LOCATE_SPACES];
+	uint32_t space_count;
+};
+
+/*!
+ * Results for xrt_space_overseer::locate_spaces.
+ */
+struct ipc_info_space_locate_spaces
+{
+	struct xrt_space_relation relations[IPC_MAX_LOCATE_SPACES];
+};
+
 /*!
  * Arguments for xrt_device::get_view_poses with two views.
  */
@@ -0,0 +1,375 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Tracking state replicated through shared memory.
+ * @author agent <agent@local>
+ * @ingroup ipc_shared
+ */
+
+#include "xrt/xrt_device.h"
+
+#include "math/m_api.h"
+#include "math/m_vec3.h"
+#include "math/m_predict.h"
+
+#include "util/u_misc.h"
+
+#include "shared/ipc_tracking.h"
+
+#if defined(_MSC_VER)
+#include "xrt/xrt_windows.h"
+#endif
+
+#include <assert.h>
+
+
+/*
+ *
+ * Seqlock helpers.
+ *
+ */
+
+static inline void
+full_barrier(void)
+{
+#if defined(__GNUC__)
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	MemoryBarrier();
+#else
+#error "compiler not supported"
+#endif
+}
+
+static inline void
+write_begin(struct ipc_shared_device_tracking *isdt)
+{
+	// Full barrier, makes the counter odd before any data is written.
+	xrt_atomic_s32_inc_return(&isdt->seq);
+}
+
+static inline void
+write_end(struct ipc_shared_device_tracking *isdt)
+{
+	// Full barrier, all data is written before the counter is even again.
+	xrt_atomic_s32_inc_return(&isdt->seq);
+}
+
+static inline bool
+read_begin(struct ipc_shared_device_tracking *isdt, int32_t *out_seq)
+{
+	int32_t seq = isdt->seq;
+	full_barrier();
+
+	if ((seq & 1) != 0) {
+		return false;
+	}
+
+	*out_seq = seq;
+	return true;
+}
+
+static inline bool
+read_end(struct ipc_shared_device_tracking *isdt, int32_t seq)
+{
+	full_barrier();
+	return isdt->seq == seq;
+}
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+// Names and counts are only written by init, no need to hold the seqlock.
+static int
+find_pose(struct ipc_shared_device_tracking *isdt, enum xrt_input_name name)
+{
+	for (uint32_t i = 0; i < isdt->pose_count && i < IPC_SHARED_MAX_TRACKED_POSES; i++) {
+		if (isdt->poses[i].name == name) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+static int
+find_hand(struct ipc_shared_device_tracking *isdt, enum xrt_input_name name)
+{
+	for (uint32_t i = 0; i < isdt->hand_count && i < IPC_SHARED_MAX_TRACKED_HANDS; i++) {
+		if (isdt->hands[i].name == name) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+static inline const struct ipc_shared_pose_sample *
+get_sample(const struct ipc_shared_tracked_pose *pose, uint32_t age)
+{
+	uint32_t index = (pose->newest + IPC_SHARED_POSE_HISTORY_SIZE - age) % IPC_SHARED_POSE_HISTORY_SIZE;
+	return &pose->samples[index];
+}
+
+/*!
+ * Same as the interpolation in @ref m_relation_history_get, so the client and
+ * the service give the same answer for the same samples.
+ */
+static void
+interpolate(const struct xrt_space_relation *before,
+            const struct xrt_space_relation *after,
+            float amount,
+            struct xrt_space_relation *out_relation)
+{
+	struct xrt_space_relation result = {0};
+	result.relation_flags = (enum xrt_space_relation_flags)(before->relation_flags & after->relation_flags);
+
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_POSITION_VALID_BIT)) {
+		result.pose.position = m_vec3_lerp(before->pose.position, after->pose.position, amount);
+	}
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_ORIENTATION_VALID_BIT)) {
+		math_quat_slerp(&before->pose.orientation, &after->pose.orientation, amount, &result.pose.orientation);
+	}
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT)) {
+		result.angular_velocity = m_vec3_lerp(before->angular_velocity, after->angular_velocity, amount);
+	}
+	if (0 != (result.relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT)) {
+		result.linear_velocity = m_vec3_lerp(before->linear_velocity, after->linear_velocity, amount);
+	}
+
+	*out_relation = result;
+}
+
+
+/*
+ *
+ * 'Exported' service functions.
+ *
+ */
+
+void
+ipc_tracking_init(struct ipc_shared_device_tracking *isdt, struct xrt_device *xdev)
+{
+	U_ZERO(isdt);
+
+	for (uint32_t i = 0; i < xdev->input_count; i++) {
+		enum xrt_input_name name = xdev->inputs[i].name;
+		enum xrt_input_type type = XRT_GET_INPUT_TYPE(name);
+
+		if (type == XRT_INPUT_TYPE_POSE && isdt->pose_count < IPC_SHARED_MAX_TRACKED_POSES) {
+			isdt->poses[isdt->pose_count++].name = name;
+		}
+
+		if (type == XRT_INPUT_TYPE_HAND_TRACKING && xdev->hand_tracking_supported &&
+		    isdt->hand_count < IPC_SHARED_MAX_TRACKED_HANDS) {
+			isdt->hands[isdt->hand_count++].name = name;
+		}
+	}
+}
+
+void
+ipc_tracking_publish(struct ipc_shared_device_tracking *isdt, struct xrt_device *xdev, uint64_t now_ns)
+{
+	uint64_t timestamps[IPC_SHARED_MAX_TRACKED_POSES][IPC_SHARED_POSE_HISTORY_SIZE];
+	struct xrt_space_relation relations[IPC_SHARED_MAX_TRACKED_POSES][IPC_SHARED_POSE_HISTORY_SIZE];
+	uint32_t history_counts[IPC_SHARED_MAX_TRACKED_POSES];
+	struct xrt_hand_joint_set hands[IPC_SHARED_MAX_TRACKED_HANDS];
+	uint64_t hand_timestamps[IPC_SHARED_MAX_TRACKED_HANDS];
+
+	// Talk to the device outside of the write section.
+	for (uint32_t i = 0; i < isdt->pose_count; i++) {
+		enum xrt_input_name name = isdt->poses[i].name;
+
+		xrt_result_t xret = xrt_device_get_tracked_pose_history( //
+		    xdev,                                                 //
+		    name,                                                 //
+		    IPC_SHARED_POSE_HISTORY_SIZE,                         //
+		    timestamps[i],                                        //
+		    relations[i],                                         //
+		    &history_counts[i]);                                  //
+		if (xret == XRT_SUCCESS && history_counts[i] > 0) {
+			continue;
+		}
+
+		// No history to copy, sample it ourselves.
+		history_counts[i] = 0;
+		timestamps[i][0] = now_ns;
+		relations[i][0] = (struct xrt_space_relation)XRT_SPACE_RELATION_ZERO;
+		xrt_device_get_tracked_pose(xdev, name, now_ns, &relations[i][0]);
+	}
+
+	for (uint32_t i = 0; i < isdt->hand_count; i++) {
+		hands[i] = (struct xrt_hand_joint_set){0};
+		hand_timestamps[i] = 0;
+		xrt_device_get_hand_tracking(xdev, isdt->hands[i].name, now_ns, &hands[i], &hand_timestamps[i]);
+	}
+
+	write_begin(isdt);
+
+	for (uint32_t i = 0; i < isdt->pose_count; i++) {
+		struct ipc_shared_tracked_pose *pose = &isdt->poses[i];
+		pose->published_ns = now_ns;
+
+		// The device's own samples replace everything.
+		if (history_counts[i] > 0) {
+			for (uint32_t k = 0; k < history_counts[i]; k++) {
+				pose->samples[k].timestamp_ns = timestamps[i][k];
+				pose->samples[k].relation = relations[i][k];
+			}
+
+			pose->newest = history_counts[i] - 1;
+			pose->sample_count = history_counts[i];
+			continue;
+		}
+
+		uint32_t newest = (pose->newest + 1) % IPC_SHARED_POSE_HISTORY_SIZE;
+		if (pose->sample_count == 0) {
+			newest = 0;
+		}
+
+		pose->samples[newest].timestamp_ns = timestamps[i][0];
+		pose->samples[newest].relation = relations[i][0];
+		pose->newest = newest;
+
+		if (pose->sample_count < IPC_SHARED_POSE_HISTORY_SIZE) {
+			pose->sample_count++;
+		}
+	}
+
+	for (uint32_t i = 0; i < isdt->hand_count; i++) {
+		isdt->hands[i].published_ns = now_ns;
+		isdt->hands[i].timestamp_ns = hand_timestamps[i];
+		isdt->hands[i].value = hands[i];
+	}
+
+	write_end(isdt);
+}
+
+
+/*
+ *
+ * 'Exported' client functions.
+ *
+ */
+
+bool
+ipc_tracking_get_tracked_pose(struct ipc_shared_device_tracking *isdt,
+                              enum xrt_input_name name,
+                              uint64_t at_timestamp_ns,
+                              uint64_t now_ns,
+                              struct xrt_space_relation *out_relation)
+{
+	int index = find_pose(isdt, name);
+	if (index < 0 || at_timestamp_ns == 0) {
+		return false;
+	}
+
+	// Copy out the history, only a few hundred bytes.
+	struct ipc_shared_tracked_pose pose;
+	bool read = false;
+	for (int i = 0; i < IPC_TRACKING_READ_RETRIES && !read; i++) {
+		int32_t seq;
+		if (!read_begin(isdt, &seq)) {
+			continue;
+		}
+
+		pose = isdt->poses[index];
+		read = read_end(isdt, seq);
+	}
+
+	if (!read || pose.sample_count == 0 || pose.sample_count > IPC_SHARED_POSE_HISTORY_SIZE) {
+		return false;
+	}
+
+	const struct ipc_shared_pose_sample *newest = get_sample(&pose, 0);
+	const struct ipc_shared_pose_sample *oldest = get_sample(&pose, pose.sample_count - 1);
+
+	// Stale, the service might have stopped publishing.
+	if (now_ns > pose.published_ns + IPC_TRACKING_MAX_AGE_NS) {
+		return false;
+	}
+
+	// Too far out, or older than our history, the service knows better.
+	if (at_timestamp_ns > newest->timestamp_ns + IPC_TRACKING_MAX_PREDICTION_NS ||
+	    at_timestamp_ns < oldest->timestamp_ns) {
+		return false;
+	}
+
+	if (at_timestamp_ns > newest->timestamp_ns) {
+		int64_t diff_prediction_ns = (int64_t)at_timestamp_ns - (int64_t)newest->timestamp_ns;
+		m_predict_relation(&newest->relation, time_ns_to_s(diff_prediction_ns), out_relation);
+		return true;
+	}
+
+	// Walk from oldest to newest, find the first sample not older than the requested time.
+	const struct ipc_shared_pose_sample *before = NULL;
+	for (uint32_t age = pose.sample_count; age-- > 0;) {
+		const struct ipc_shared_pose_sample *sample = get_sample(&pose, age);
+
+		if (sample->timestamp_ns == at_timestamp_ns) {
+			*out_relation = sample->relation;
+			return true;
+		}
+
+		if (sample->timestamp_ns > at_timestamp_ns) {
+			// Can not be the oldest sample, the time is not older than it.
+			assert(before != NULL);
+
+			int64_t diff_before = (int64_t)at_timestamp_ns - (int64_t)before->timestamp_ns;
+			int64_t diff_after = (int64_t)sample->timestamp_ns - (int64_t)at_timestamp_ns;
+			float amount = (float)diff_before / (float)(diff_before + diff_after);
+
+			interpolate(&before->relation, &sample->relation, amount, out_relation);
+			return true;
+		}
+
+		before = sample;
+	}
+
+	// Not reached, the newest sample is not older than the requested time.
+	return false;
+}
+
+bool
+ipc_tracking_get_hand_tracking(struct ipc_shared_device_tracking *isdt,
+                               enum xrt_input_name name,
+                               uint64_t at_timestamp_ns,
+                               uint64_t now_ns,
+                               struct xrt_hand_joint_set *out_value,
+                               uint64_t *out_timestamp_ns)
+{
+	int index = find_hand(isdt, name);
+	if (index < 0) {
+		return false;
+	}
+
+	struct ipc_shared_tracked_hand hand;
+	bool read = false;
+	for (int i = 0; i < IPC_TRACKING_READ_RETRIES && !read; i++) {
+		int32_t seq;
+		if (!read_begin(isdt, &seq)) {
+			continue;
+		}
+
+		hand = isdt->hands[index];
+		read = read_end(isdt, seq);
+	}
+
+	if (!read || hand.published_ns == 0) {
+		return false;
+	}
+
+	// Joint sets are not extrapolated, only hand out recent ones.
+	if (now_ns > hand.published_ns + IPC_TRACKING_MAX_AGE_NS ||
+	    at_timestamp_ns > hand.published_ns + IPC_TRACKING_MAX_PREDICTION_NS) {
+		return false;
+	}
+
+	*out_value = hand.value;
+	*out_timestamp_ns = hand.timestamp_ns;
+
+	return true;
+}
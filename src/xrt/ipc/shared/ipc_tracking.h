@@ -0,0 +1,92 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Tracking state replicated through shared memory.
+ *
+ * The service publishes the newest samples of each pose input and the latest
+ * hand joint sets to @ref ipc_shared_device_tracking, guarded by a seqlock.
+ * Clients interpolate and extrapolate from it locally, and fall back to an IPC
+ * call when the data is missing, stale or being written.
+ *
+ * @author agent <agent@local>
+ * @ingroup ipc_shared
+ */
+
+#pragma once
+
+#include "util/u_time.h"
+
+#include "shared/ipc_protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//! Published data older than this is not used by clients.
+#define IPC_TRACKING_MAX_AGE_NS (20 * U_TIME_1MS_IN_NS)
+
+//! Clients do not extrapolate further than this past the newest sample.
+#define IPC_TRACKING_MAX_PREDICTION_NS (100 * U_TIME_1MS_IN_NS)
+
+//! How many times a client retries reading while the service is writing.
+#define IPC_TRACKING_READ_RETRIES 8
+
+
+/*!
+ * Service side, sets up which pose and hand tracking inputs of the device are
+ * replicated, must be called before clients connect.
+ *
+ * @ingroup ipc_shared
+ */
+void
+ipc_tracking_init(struct ipc_shared_device_tracking *isdt, struct xrt_device *xdev);
+
+/*!
+ * Service side, publishes all replicated inputs of the device. For pose inputs
+ * these are the samples of @ref xrt_device::get_tracked_pose_history, so
+ * clients interpolate between the same samples the device does. Devices
+ * without a history are sampled at @p now_ns instead and the samples are
+ * added to the published ones, an approximation of the device's own history.
+ * The device is talked to before the seqlock is taken so the write section
+ * only covers the copy.
+ *
+ * @ingroup ipc_shared
+ */
+void
+ipc_tracking_publish(struct ipc_shared_device_tracking *isdt, struct xrt_device *xdev, uint64_t now_ns);
+
+/*!
+ * Client side, interpolates or extrapolates the published history of a pose
+ * input, with the same math as @ref m_relation_history_get.
+ *
+ * @return False if the caller should fall back to asking the service.
+ * @ingroup ipc_shared
+ */
+bool
+ipc_tracking_get_tracked_pose(struct ipc_shared_device_tracking *isdt,
+                              enum xrt_input_name name,
+                              uint64_t at_timestamp_ns,
+                              uint64_t now_ns,
+                              struct xrt_space_relation *out_relation);
+
+/*!
+ * Client side, returns the latest published joint set of a hand tracking
+ * input if it is close enough to @p at_timestamp_ns.
+ *
+ * @return False if the caller should fall back to asking the service.
+ * @ingroup ipc_shared
+ */
+bool
+ipc_tracking_get_hand_tracking(struct ipc_shared_device_tracking *isdt,
+                               enum xrt_input_name name,
+                               uint64_t at_timestamp_ns,
+                               uint64_t now_ns,
+                               struct xrt_hand_joint_set *out_value,
+                               uint64_t *out_timestamp_ns);
+
+
+#ifdef __cplusplus
+}
+#endif
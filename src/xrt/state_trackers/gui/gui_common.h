@@ -76,6 +76,7 @@ struct gui_ogl_texture
 {
 	uint64_t seq;
 	uint64_t dropped;
+	uint64_t skipped;
 	const char *name;
 	uint32_t w, h;
 	uint32_t id;
@@ -18,8 +18,20 @@
 
 #include <pthread.h>
 #include <limits.h>
+#include <string.h>
 
 
+/*!
+ * How a @ref xrt_format is given to OpenGL.
+ */
+struct upload_format
+{
+	GLint internal_format;
+	GLenum format;
+	GLint bytes_per_pixel;
+	bool swizzle_red;
+};
+
 /*!
  * An @ref xrt_frame_sink that shows sunk frames in the GUI.
  * @implements xrt_frame_sink
@@ -37,6 +49,30 @@ struct gui_ogl_sink
 	pthread_mutex_t mutex;
 
 	bool running;
+
+	//! Texture storage, only reallocated when the frame size or format changes.
+	struct
+	{
+		GLint internal_format;
+		GLint w, h;
+	} storage;
+
+	//! Pixel unpack buffers, used in turn so we never write to one being read.
+	struct
+	{
+		GLuint ids[2];
+		GLsizeiptr sizes[2];
+		uint32_t index;
+	} pbo;
+
+	//! The last uploaded frame, to not upload the same frame twice.
+	struct
+	{
+		bool valid;
+		uint64_t source_id;
+		uint64_t source_sequence;
+		uint64_t timestamp;
+	} last;
 };
 
 static void
@@ -49,6 +85,10 @@ push_frame(struct xrt_frame_sink *xs, struct xrt_frame *xf)
 
 	// If we are in the process of shutting down, don't take the reference.
 	if (s->running) {
+		// The GUI did not get to the previous one.
+		if (s->frame != NULL) {
+			s->tex.dropped++;
+		}
 		xrt_frame_reference(&s->frame, xf);
 	}
 
@@ -75,6 +115,7 @@ destroy(struct xrt_frame_node *node)
 {
 	struct gui_ogl_sink *s = container_of(node, struct gui_ogl_sink, node);
 
+	glDeleteBuffers(ARRAY_SIZE(s->pbo.ids), s->pbo.ids);
 	glDeleteTextures(1, &s->tex.id);
 
 	pthread_mutex_destroy(&s->mutex);
@@ -82,32 +123,89 @@ destroy(struct xrt_frame_node *node)
 	free(s);
 }
 
-static void
-update_r8g8b8x8(struct gui_ogl_sink *s, GLint w, GLint h, GLint stride, uint8_t *data)
+static bool
+get_upload_format(enum xrt_format format, struct upload_format *out_uf)
 {
-	glBindTexture(GL_TEXTURE_2D, s->tex.id);
-	glPixelStorei(GL_UNPACK_ROW_LENGTH, stride / 4);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	switch (format) {
+	case XRT_FORMAT_R8G8B8: *out_uf = (struct upload_format){GL_RGBA8, GL_RGB, 3, false}; return true;
+	case XRT_FORMAT_R8G8B8A8:
+	case XRT_FORMAT_R8G8B8X8: *out_uf = (struct upload_format){GL_RGB8, GL_RGBA, 4, false}; return true;
+	case XRT_FORMAT_L8: *out_uf = (struct upload_format){GL_R8, GL_RED, 1, true}; return true;
+	default: return false;
+	}
+}
+
+static bool
+is_same_frame(struct gui_ogl_sink *s, struct xrt_frame *frame)
+{
+	// Sources that do not timestamp their frames can not be told apart.
+	return s->last.valid && frame->timestamp != 0 && s->last.timestamp == frame->timestamp &&
+	       s->last.source_id == frame->source_id && s->last.source_sequence == frame->source_sequence;
 }
 
 static void
-update_r8g8b8(struct gui_ogl_sink *s, GLint w, GLint h, GLint stride, uint8_t *data)
+ensure_storage(struct gui_ogl_sink *s, const struct upload_format *uf, GLint w, GLint h)
 {
-	glBindTexture(GL_TEXTURE_2D, s->tex.id);
-	glPixelStorei(GL_UNPACK_ROW_LENGTH, stride / 3);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	if (s->storage.internal_format == uf->internal_format && s->storage.w == w && s->storage.h == h) {
+		return;
+	}
+
+	glTexImage2D(GL_TEXTURE_2D, 0, uf->internal_format, w, h, 0, uf->format, GL_UNSIGNED_BYTE, NULL);
+
+	GLint swizzle_red[] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+	GLint swizzle_none[] = {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA};
+	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, uf->swizzle_red ? swizzle_red : swizzle_none);
+
+	s->storage.internal_format = uf->internal_format;
+	s->storage.w = w;
+	s->storage.h = h;
 }
 
+/*!
+ * Copies the frame into the next pixel unpack buffer and uploads from it, the
+ * copy out of the buffer into the texture is done asynchronously by the driver.
+ * The frame is not referenced after this returns.
+ */
 static void
-update_l8(struct gui_ogl_sink *s, GLint w, GLint h, GLint stride, uint8_t *data)
+upload(struct gui_ogl_sink *s, const struct upload_format *uf, GLint w, GLint h, GLint stride, const uint8_t *data)
 {
+	// The last row does not need the padding.
+	GLsizeiptr size = (GLsizeiptr)stride * (h - 1) + (GLsizeiptr)w * uf->bytes_per_pixel;
+
 	glBindTexture(GL_TEXTURE_2D, s->tex.id);
-	glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, w, h, 0, GL_RED, GL_UNSIGNED_BYTE, data);
-	GLint swizzleMask[] = {GL_RED, GL_RED, GL_RED, GL_ONE};
-	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+	ensure_storage(s, uf, w, h);
+
+	s->pbo.index = (s->pbo.index + 1) % ARRAY_SIZE(s->pbo.ids);
+	uint32_t index = s->pbo.index;
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s->pbo.ids[index]);
+	if (s->pbo.sizes[index] < size) {
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+		s->pbo.sizes[index] = size;
+	}
+
+	// Invalidating lets the driver hand out new memory if it is still busy.
+	void *ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (ptr == NULL) {
+		U_LOG_E("Failed to map pixel unpack buffer!");
+		goto out;
+	}
+
+	memcpy(ptr, data, size);
+
+	// Contents are undefined if this fails, skip the frame.
+	if (!glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+		goto out;
+	}
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, stride / uf->bytes_per_pixel);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, uf->format, GL_UNSIGNED_BYTE, NULL);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+out:
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
@@ -115,7 +213,6 @@ void
 gui_ogl_sink_update(struct gui_ogl_texture *tex)
 {
 	struct gui_ogl_sink *s = container_of(tex, struct gui_ogl_sink, tex);
-	(void)s;
 
 	// Take the frame no need to adjust reference.
 	pthread_mutex_lock(&s->mutex);
@@ -130,6 +227,14 @@ gui_ogl_sink_update(struct gui_ogl_texture *tex)
 	// To large stride for GLint.
 	if (frame->stride > INT_MAX) {
 		U_LOG_E("Stride unreasonable large!");
+		xrt_frame_reference(&frame, NULL);
+		return;
+	}
+
+	// Nothing to show, or the same frame pushed again.
+	if (frame->width == 0 || frame->height == 0 || is_same_frame(s, frame)) {
+		tex->skipped++;
+		xrt_frame_reference(&frame, NULL);
 		return;
 	}
 
@@ -151,12 +256,14 @@ gui_ogl_sink_update(struct gui_ogl_texture *tex)
 
 	tex->seq = frame->source_sequence;
 
-	switch (frame->format) {
-	case XRT_FORMAT_R8G8B8: update_r8g8b8(s, w, h, stride, data); break;
-	case XRT_FORMAT_R8G8B8A8:
-	case XRT_FORMAT_R8G8B8X8: update_r8g8b8x8(s, w, h, stride, data); break;
-	case XRT_FORMAT_L8: update_l8(s, w, h, stride, data); break;
-	default: break;
+	struct upload_format uf;
+	if (get_upload_format(frame->format, &uf)) {
+		upload(s, &uf, w, h, stride, data);
+
+		s->last.valid = true;
+		s->last.source_id = frame->source_id;
+		s->last.source_sequence = frame->source_sequence;
+		s->last.timestamp = frame->timestamp;
 	}
 
 	xrt_frame_reference(&frame, NULL);
@@ -195,6 +302,8 @@ gui_ogl_sink_create(const char *name, struct xrt_frame_context *xfctx, struct xr
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 
+	glGenBuffers(ARRAY_SIZE(s->pbo.ids), s->pbo.ids);
+
 	xrt_frame_context_add(xfctx, &s->node);
 
 	*out_sink = &s->sink;
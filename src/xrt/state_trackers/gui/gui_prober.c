@@ -12,6 +12,8 @@
 #include "xrt/xrt_instance.h"
 
 #include "util/u_time.h"
+#include "util/u_logging.h"
+#include "util/u_system_helpers.h"
 #include "util/u_trace_marker.h"
 
 #include "gui_common.h"
@@ -30,6 +32,31 @@ do_exit(struct gui_program *p, int ret)
 	return ret;
 }
 
+static void
+hotplug_cb(struct xrt_prober *xp,
+           enum xrt_prober_hotplug_event event,
+           struct xrt_prober_device *xpdev,
+           struct xrt_device **xdevs,
+           size_t xdev_count,
+           void *ptr)
+{
+	struct gui_program *p = (struct gui_program *)ptr;
+
+	if (event == XRT_PROBER_HOTPLUG_REMOVED) {
+		// The devices stay around, they will just stop getting data.
+		U_LOG_I("Device %04x:%04x removed", xpdev->vendor_id, xpdev->product_id);
+		return;
+	}
+
+	U_LOG_I("Device %04x:%04x added, %u new devices", xpdev->vendor_id, xpdev->product_id, (uint32_t)xdev_count);
+
+	for (size_t i = 0; i < xdev_count; i++) {
+		if (!u_system_devices_add_device(p->xsysd, xdevs[i])) {
+			xdevs[i] = NULL;
+		}
+	}
+}
+
 
 /*
  *
@@ -89,6 +116,11 @@ gui_prober_update(struct gui_program *p)
 		return;
 	}
 
+	// Pick up devices plugged in after the system was created.
+	if (p->xp != NULL) {
+		xrt_prober_handle_hotplug(p->xp, hotplug_cb, p);
+	}
+
 	for (size_t i = 0; i < p->xsysd->xdev_count; i++) {
 		if (p->xsysd->xdevs[i] == NULL) {
 			continue;
@@ -9,6 +9,8 @@
 
 #include "xrt/xrt_config_drivers.h"
 
+#include "os/os_time.h"
+
 #include "util/u_misc.h"
 #include "util/u_logging.h"
 
@@ -355,6 +357,9 @@ on_connected(struct gui_remote *gr, struct gui_program *p)
 		render_cheat_menu(gr, p);
 	}
 
+	gr->data.header = R_HEADER_VALUE;
+	gr->data.timestamp_ns = os_monotonic_get_ns();
+
 	r_remote_connection_write_one(&gr->rc, &gr->data);
 }
 
@@ -875,7 +875,22 @@ oxr_xrApplyHapticFeedback(XrSession session,
 	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrApplyHapticFeedback");
 	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
 	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, hapticActionInfo, XR_TYPE_HAPTIC_ACTION_INFO);
-	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, hapticEvent, XR_TYPE_HAPTIC_VIBRATION);
+	OXR_VERIFY_ARG_NOT_NULL(&log, hapticEvent);
+
+#ifdef OXR_HAVE_FB_haptic_pcm
+	if (hapticEvent->type == XR_TYPE_HAPTIC_PCM_VIBRATION_FB && sess->sys->inst->extensions.FB_haptic_pcm) {
+		const XrHapticPcmVibrationFB *pcm = (const XrHapticPcmVibrationFB *)hapticEvent;
+		OXR_VERIFY_ARG_NOT_ZERO(&log, pcm->bufferSize);
+		OXR_VERIFY_ARG_NOT_NULL(&log, pcm->buffer);
+		OXR_VERIFY_ARG_NOT_NULL(&log, pcm->samplesConsumed);
+		if (pcm->sampleRate <= 0.0f) {
+			return oxr_error(&log, XR_ERROR_VALIDATION_FAILURE, "(hapticEvent->sampleRate <= 0)");
+		}
+	} else
+#endif
+	{
+		OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, hapticEvent, XR_TYPE_HAPTIC_VIBRATION);
+	}
 	OXR_VERIFY_ACTION_NOT_NULL(&log, hapticActionInfo->action, act);
 
 	ret = oxr_verify_subaction_path_get(&log, act->act_set->inst, hapticActionInfo->subactionPath,
@@ -918,3 +933,38 @@ oxr_xrStopHapticFeedback(XrSession session, const XrHapticActionInfo *hapticActi
 
 	return oxr_action_stop_haptic_feedback(&log, sess, act->act_key, subaction_paths);
 }
+
+#ifdef OXR_HAVE_FB_haptic_pcm
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGetDeviceSampleRateFB(XrSession session,
+                            const XrHapticActionInfo *hapticActionInfo,
+                            XrDevicePcmSampleRateGetInfoFB *deviceSampleRate)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_session *sess = NULL;
+	struct oxr_action *act = NULL;
+	struct oxr_subaction_paths subaction_paths = {0};
+	struct oxr_logger log;
+	XrResult ret;
+	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrGetDeviceSampleRateFB");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
+	OXR_VERIFY_EXTENSION(&log, sess->sys->inst, FB_haptic_pcm);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, hapticActionInfo, XR_TYPE_HAPTIC_ACTION_INFO);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, deviceSampleRate, XR_TYPE_DEVICE_PCM_SAMPLE_RATE_GET_INFO_FB);
+	OXR_VERIFY_ACTION_NOT_NULL(&log, hapticActionInfo->action, act);
+
+	ret = oxr_verify_subaction_path_get(&log, act->act_set->inst, hapticActionInfo->subactionPath,
+	                                    &act->data->subaction_paths, &subaction_paths, "getInfo->subactionPath");
+	if (ret != XR_SUCCESS) {
+		return ret;
+	}
+
+	if (act->data->action_type != XR_ACTION_TYPE_VIBRATION_OUTPUT) {
+		return oxr_error(&log, XR_ERROR_ACTION_TYPE_MISMATCH, "Not created with output vibration type");
+	}
+
+	return oxr_action_get_haptic_pcm_sample_rate(&log, sess, act->act_key, subaction_paths,
+	                                             &deviceSampleRate->sampleRate);
+}
+#endif
@@ -355,6 +355,12 @@ oxr_xrCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo *
 XRAPI_ATTR XrResult XRAPI_CALL
 oxr_xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation *location);
 
+#ifdef OXR_HAVE_KHR_locate_spaces
+//! OpenXR API function @ep{xrLocateSpacesKHR}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrLocateSpacesKHR(XrSession session, const XrSpacesLocateInfoKHR *locateInfo, XrSpaceLocationsKHR *spaceLocations);
+#endif // OXR_HAVE_KHR_locate_spaces
+
 //! OpenXR API function @ep{xrDestroySpace}
 XRAPI_ATTR XrResult XRAPI_CALL
 oxr_xrDestroySpace(XrSpace space);
@@ -528,6 +534,14 @@ oxr_xrApplyHapticFeedback(XrSession session,
 XRAPI_ATTR XrResult XRAPI_CALL
 oxr_xrStopHapticFeedback(XrSession session, const XrHapticActionInfo *hapticActionInfo);
 
+#ifdef OXR_HAVE_FB_haptic_pcm
+//! OpenXR API function @ep{xrGetDeviceSampleRateFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGetDeviceSampleRateFB(XrSession session,
+                            const XrHapticActionInfo *hapticActionInfo,
+                            XrDevicePcmSampleRateGetInfoFB *deviceSampleRate);
+#endif
+
 //! OpenXR API function @ep{xrCreateHandTrackerEXT}
 XRAPI_ATTR XrResult XRAPI_CALL
 oxr_xrCreateHandTrackerEXT(XrSession session,
@@ -564,6 +578,99 @@ oxr_xrGetDisplayRefreshRateFB(XrSession session, float *displayRefreshRate);
 XRAPI_ATTR XrResult XRAPI_CALL
 oxr_xrRequestDisplayRefreshRateFB(XrSession session, float displayRefreshRate);
 
+#ifdef OXR_HAVE_FB_swapchain_update_state
+//! OpenXR API function @ep{xrUpdateSwapchainFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrUpdateSwapchainFB(XrSwapchain swapchain, const XrSwapchainStateBaseHeaderFB *state);
+
+//! OpenXR API function @ep{xrGetSwapchainStateFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGetSwapchainStateFB(XrSwapchain swapchain, XrSwapchainStateBaseHeaderFB *state);
+#endif // OXR_HAVE_FB_swapchain_update_state
+
+#ifdef OXR_HAVE_FB_foveation
+//! OpenXR API function @ep{xrCreateFoveationProfileFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrCreateFoveationProfileFB(XrSession session,
+                               const XrFoveationProfileCreateInfoFB *createInfo,
+                               XrFoveationProfileFB *profile);
+
+//! OpenXR API function @ep{xrDestroyFoveationProfileFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrDestroyFoveationProfileFB(XrFoveationProfileFB profile);
+#endif // OXR_HAVE_FB_foveation
+
+#ifdef OXR_HAVE_FB_passthrough
+//! OpenXR API function @ep{xrCreatePassthroughFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrCreatePassthroughFB(XrSession session,
+                          const XrPassthroughCreateInfoFB *createInfo,
+                          XrPassthroughFB *outPassthrough);
+
+//! OpenXR API function @ep{xrDestroyPassthroughFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrDestroyPassthroughFB(XrPassthroughFB passthrough);
+
+//! OpenXR API function @ep{xrPassthroughStartFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughStartFB(XrPassthroughFB passthrough);
+
+//! OpenXR API function @ep{xrPassthroughPauseFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughPauseFB(XrPassthroughFB passthrough);
+
+//! OpenXR API function @ep{xrCreatePassthroughLayerFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrCreatePassthroughLayerFB(XrSession session,
+                               const XrPassthroughLayerCreateInfoFB *createInfo,
+                               XrPassthroughLayerFB *outLayer);
+
+//! OpenXR API function @ep{xrDestroyPassthroughLayerFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrDestroyPassthroughLayerFB(XrPassthroughLayerFB layer);
+
+//! OpenXR API function @ep{xrPassthroughLayerPauseFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughLayerPauseFB(XrPassthroughLayerFB layer);
+
+//! OpenXR API function @ep{xrPassthroughLayerResumeFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughLayerResumeFB(XrPassthroughLayerFB layer);
+
+//! OpenXR API function @ep{xrPassthroughLayerSetStyleFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughLayerSetStyleFB(XrPassthroughLayerFB layer, const XrPassthroughStyleFB *style);
+
+//! OpenXR API function @ep{xrCreateGeometryInstanceFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrCreateGeometryInstanceFB(XrSession session,
+                               const XrGeometryInstanceCreateInfoFB *createInfo,
+                               XrGeometryInstanceFB *outGeometryInstance);
+
+//! OpenXR API function @ep{xrDestroyGeometryInstanceFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrDestroyGeometryInstanceFB(XrGeometryInstanceFB instance);
+
+//! OpenXR API function @ep{xrGeometryInstanceSetTransformFB}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGeometryInstanceSetTransformFB(XrGeometryInstanceFB instance,
+                                     const XrGeometryInstanceTransformFB *transformation);
+#endif // OXR_HAVE_FB_passthrough
+
+#ifdef OXR_HAVE_META_foveation_eye_tracked
+//! OpenXR API function @ep{xrGetFoveationEyeTrackedStateMETA}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGetFoveationEyeTrackedStateMETA(XrSession session, XrFoveationEyeTrackedStateMETA *foveationState);
+#endif // OXR_HAVE_META_foveation_eye_tracked
+
+#ifdef OXR_HAVE_META_recommended_layer_resolution
+//! OpenXR API function @ep{xrGetRecommendedLayerResolutionMETA}
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGetRecommendedLayerResolutionMETA(XrSession session,
+                                        const XrRecommendedLayerResolutionGetInfoMETA *info,
+                                        XrRecommendedLayerResolutionMETA *resolution);
+#endif // OXR_HAVE_META_recommended_layer_resolution
+
 /*!
  * @}
  */
@@ -210,6 +210,10 @@ handle_non_null(struct oxr_instance *inst, struct oxr_logger *log, const char *n
 	ENTRY(xrApplyHapticFeedback);
 	ENTRY(xrStopHapticFeedback);
 
+#ifdef OXR_HAVE_KHR_locate_spaces
+	ENTRY_IF_EXT(xrLocateSpacesKHR, KHR_locate_spaces);
+#endif // OXR_HAVE_KHR_locate_spaces
+
 #ifdef OXR_HAVE_KHR_visibility_mask
 	ENTRY_IF_EXT(xrGetVisibilityMaskKHR, KHR_visibility_mask);
 #endif // OXR_HAVE_KHR_visibility_mask
@@ -248,6 +252,43 @@ handle_non_null(struct oxr_instance *inst, struct oxr_logger *log, const char *n
 	ENTRY_IF_EXT(xrRequestDisplayRefreshRateFB, FB_display_refresh_rate);
 #endif
 
+#ifdef OXR_HAVE_FB_haptic_pcm
+	ENTRY_IF_EXT(xrGetDeviceSampleRateFB, FB_haptic_pcm);
+#endif
+
+#ifdef OXR_HAVE_FB_swapchain_update_state
+	ENTRY_IF_EXT(xrUpdateSwapchainFB, FB_swapchain_update_state);
+	ENTRY_IF_EXT(xrGetSwapchainStateFB, FB_swapchain_update_state);
+#endif // OXR_HAVE_FB_swapchain_update_state
+
+#ifdef OXR_HAVE_FB_foveation
+	ENTRY_IF_EXT(xrCreateFoveationProfileFB, FB_foveation);
+	ENTRY_IF_EXT(xrDestroyFoveationProfileFB, FB_foveation);
+#endif // OXR_HAVE_FB_foveation
+
+#ifdef OXR_HAVE_FB_passthrough
+	ENTRY_IF_EXT(xrCreatePassthroughFB, FB_passthrough);
+	ENTRY_IF_EXT(xrDestroyPassthroughFB, FB_passthrough);
+	ENTRY_IF_EXT(xrPassthroughStartFB, FB_passthrough);
+	ENTRY_IF_EXT(xrPassthroughPauseFB, FB_passthrough);
+	ENTRY_IF_EXT(xrCreatePassthroughLayerFB, FB_passthrough);
+	ENTRY_IF_EXT(xrDestroyPassthroughLayerFB, FB_passthrough);
+	ENTRY_IF_EXT(xrPassthroughLayerPauseFB, FB_passthrough);
+	ENTRY_IF_EXT(xrPassthroughLayerResumeFB, FB_passthrough);
+	ENTRY_IF_EXT(xrPassthroughLayerSetStyleFB, FB_passthrough);
+	ENTRY_IF_EXT(xrCreateGeometryInstanceFB, FB_passthrough);
+	ENTRY_IF_EXT(xrDestroyGeometryInstanceFB, FB_passthrough);
+	ENTRY_IF_EXT(xrGeometryInstanceSetTransformFB, FB_passthrough);
+#endif // OXR_HAVE_FB_passthrough
+
+#ifdef OXR_HAVE_META_foveation_eye_tracked
+	ENTRY_IF_EXT(xrGetFoveationEyeTrackedStateMETA, META_foveation_eye_tracked);
+#endif // OXR_HAVE_META_foveation_eye_tracked
+
+#ifdef OXR_HAVE_META_recommended_layer_resolution
+	ENTRY_IF_EXT(xrGetRecommendedLayerResolutionMETA, META_recommended_layer_resolution);
+#endif // OXR_HAVE_META_recommended_layer_resolution
+
 #ifdef OXR_HAVE_EXT_debug_utils
 	ENTRY_IF_EXT(xrSetDebugUtilsObjectNameEXT, EXT_debug_utils);
 	ENTRY_IF_EXT(xrCreateDebugUtilsMessengerEXT, EXT_debug_utils);
@@ -11,12 +11,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <math.h>
 
 #include "xrt/xrt_compiler.h"
 
 #include "util/u_debug.h"
 #include "util/u_trace_marker.h"
 
+#include "math/m_api.h"
+
 #include "oxr_objects.h"
 #include "oxr_logger.h"
 #include "oxr_two_call.h"
@@ -229,7 +232,7 @@ oxr_xrLocateViews(XrSession session,
 		                 viewLocateInfo->displayTime);
 	}
 
-	if (viewLocateInfo->viewConfigurationType != sess->sys->view_config_type) {
+	if (oxr_system_get_view_conf_count(sess->sys, viewLocateInfo->viewConfigurationType) == 0) {
 		return oxr_error(&log, XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED,
 		                 "(viewConfigurationType == 0x%08x) "
 		                 "unsupported view configuration type",
@@ -281,7 +284,7 @@ oxr_xrGetVisibilityMaskKHR(XrSession session,
  *
  */
 
-#ifdef XR_EXT_performance_settings
+#ifdef OXR_HAVE_EXT_performance_settings
 
 XRAPI_ATTR XrResult XRAPI_CALL
 oxr_xrPerfSettingsSetPerformanceLevelEXT(XrSession session,
@@ -294,11 +297,45 @@ oxr_xrPerfSettingsSetPerformanceLevelEXT(XrSession session,
 	struct oxr_logger log;
 	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrPerfSettingsSetPerformanceLevelEXT");
 	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
+	OXR_VERIFY_EXTENSION(&log, sess->sys->inst, EXT_performance_settings);
 
-	return oxr_error(&log, XR_ERROR_HANDLE_INVALID, "Not implemented");
+	if (domain != XR_PERF_SETTINGS_DOMAIN_CPU_EXT && domain != XR_PERF_SETTINGS_DOMAIN_GPU_EXT) {
+		return oxr_error(&log, XR_ERROR_VALIDATION_FAILURE, "(domain == 0x%08x) is not a valid domain",
+		                 domain);
+	}
+
+	switch (level) {
+	case XR_PERF_SETTINGS_LEVEL_POWER_SAVINGS_EXT:
+	case XR_PERF_SETTINGS_LEVEL_SUSTAINED_LOW_EXT:
+	case XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIGH_EXT:
+	case XR_PERF_SETTINGS_LEVEL_BOOST_EXT: break;
+	default: return oxr_error(&log, XR_ERROR_VALIDATION_FAILURE, "(level == 0x%08x) is not a valid level", level);
+	}
+
+	// Headless.
+	if (sess->compositor == NULL) {
+		return oxr_session_success_result(sess);
+	}
+
+	// The xrt enums use the same values as the OpenXR ones.
+	xrt_result_t xret = xrt_comp_set_performance_level( //
+	    sess->compositor,                                //
+	    (enum xrt_perf_domain)domain,                    //
+	    (enum xrt_perf_set_level)level);                 //
+
+	// It is only a hint, so not supporting it is not an error.
+	if (xret == XRT_ERROR_IPC_FAILURE) {
+		sess->has_lost = true;
+		return oxr_error(&log, XR_ERROR_INSTANCE_LOST, "Call to xrt_comp_set_performance_level failed");
+	}
+	if (xret != XRT_SUCCESS && xret != XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED) {
+		return oxr_error(&log, XR_ERROR_RUNTIME_FAILURE, "Call to xrt_comp_set_performance_level failed");
+	}
+
+	return oxr_session_success_result(sess);
 }
 
-#endif
+#endif // OXR_HAVE_EXT_performance_settings
 
 
 /*
@@ -583,3 +620,564 @@ oxr_xrRequestDisplayRefreshRateFB(XrSession session, float displayRefreshRate)
 }
 
 #endif
+
+/*
+ *
+ * XR_FB_foveation
+ *
+ */
+
+#ifdef OXR_HAVE_FB_foveation
+
+static XrResult
+oxr_foveation_profile_destroy_cb(struct oxr_logger *log, struct oxr_handle_base *hb)
+{
+	struct oxr_foveation_profile *profile = (struct oxr_foveation_profile *)hb;
+
+	free(profile);
+
+	return XR_SUCCESS;
+}
+
+XrResult
+oxr_foveation_profile_create(struct oxr_logger *log,
+                             struct oxr_session *sess,
+                             const XrFoveationProfileCreateInfoFB *createInfo,
+                             struct oxr_foveation_profile **out_profile)
+{
+	const XrFoveationLevelProfileCreateInfoFB *level_info = NULL;
+	if (sess->sys->inst->extensions.FB_foveation_configuration) {
+		level_info = OXR_GET_INPUT_FROM_CHAIN(createInfo, XR_TYPE_FOVEATION_LEVEL_PROFILE_CREATE_INFO_FB,
+		                                      XrFoveationLevelProfileCreateInfoFB);
+	}
+
+	const XrFoveationEyeTrackedProfileCreateInfoMETA *eye_tracked_info = NULL;
+#ifdef OXR_HAVE_META_foveation_eye_tracked
+	if (sess->sys->inst->extensions.META_foveation_eye_tracked && level_info != NULL) {
+		eye_tracked_info =
+		    OXR_GET_INPUT_FROM_CHAIN(level_info, XR_TYPE_FOVEATION_EYE_TRACKED_PROFILE_CREATE_INFO_META,
+		                             XrFoveationEyeTrackedProfileCreateInfoMETA);
+	}
+#endif
+
+	if (level_info != NULL && (level_info->level < XR_FOVEATION_LEVEL_NONE_FB ||
+	                           level_info->level > XR_FOVEATION_LEVEL_HIGH_FB)) {
+		return oxr_error(log, XR_ERROR_VALIDATION_FAILURE, "(level == %d) is not a valid level",
+		                 level_info->level);
+	}
+
+	struct oxr_foveation_profile *profile = NULL;
+	OXR_ALLOCATE_HANDLE_OR_RETURN(log, profile, OXR_XR_DEBUG_FOVEATION, oxr_foveation_profile_destroy_cb,
+	                              &sess->handle);
+
+	profile->sess = sess;
+
+	// Without a level the profile turns foveation off.
+	profile->level = XRT_FOVEATION_LEVEL_NONE;
+	if (level_info != NULL) {
+		// The xrt enum use the same values as the OpenXR one.
+		profile->level = (enum xrt_foveation_level)level_info->level;
+		profile->vertical_offset = level_info->verticalOffset;
+		//! @todo Dynamic levels are treated as fixed.
+		profile->dynamic = level_info->dynamic == XR_FOVEATION_DYNAMIC_LEVEL_ENABLED_FB;
+	}
+	profile->eye_tracked = eye_tracked_info != NULL;
+
+	*out_profile = profile;
+
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrCreateFoveationProfileFB(XrSession session,
+                               const XrFoveationProfileCreateInfoFB *createInfo,
+                               XrFoveationProfileFB *profile)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_foveation_profile *foveation_profile = NULL;
+	struct oxr_session *sess = NULL;
+	struct oxr_logger log;
+	XrResult ret;
+	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrCreateFoveationProfileFB");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, createInfo, XR_TYPE_FOVEATION_PROFILE_CREATE_INFO_FB);
+	OXR_VERIFY_ARG_NOT_NULL(&log, profile);
+
+	OXR_VERIFY_EXTENSION(&log, sess->sys->inst, FB_foveation);
+
+	ret = oxr_foveation_profile_create(&log, sess, createInfo, &foveation_profile);
+	if (ret != XR_SUCCESS) {
+		return ret;
+	}
+
+	*profile = oxr_foveation_profile_to_openxr(foveation_profile);
+
+	return oxr_session_success_result(sess);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrDestroyFoveationProfileFB(XrFoveationProfileFB profile)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_foveation_profile *foveation_profile;
+	struct oxr_logger log;
+	OXR_VERIFY_FOVEATION_PROFILE_AND_INIT_LOG(&log, profile, foveation_profile, "xrDestroyFoveationProfileFB");
+
+	return oxr_handle_destroy(&log, &foveation_profile->handle);
+}
+
+#endif // OXR_HAVE_FB_foveation
+
+
+/*
+ *
+ * XR_META_foveation_eye_tracked
+ *
+ */
+
+#ifdef OXR_HAVE_META_foveation_eye_tracked
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGetFoveationEyeTrackedStateMETA(XrSession session, XrFoveationEyeTrackedStateMETA *foveationState)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_session *sess = NULL;
+	struct oxr_logger log;
+	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrGetFoveationEyeTrackedStateMETA");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, foveationState, XR_TYPE_FOVEATION_EYE_TRACKED_STATE_META);
+
+	OXR_VERIFY_EXTENSION(&log, sess->sys->inst, META_foveation_eye_tracked);
+
+	struct xrt_vec2 centers[2] = {{0.0f, 0.0f}, {0.0f, 0.0f}};
+	bool valid = oxr_session_get_foveation_eye_tracked_centers(&log, sess, centers);
+
+	for (uint32_t i = 0; i < XR_FOVEATION_CENTER_SIZE_META; i++) {
+		foveationState->foveationCenter[i].x = centers[i].x;
+		foveationState->foveationCenter[i].y = centers[i].y;
+	}
+	foveationState->flags = valid ? XR_FOVEATION_EYE_TRACKED_STATE_VALID_BIT_META : 0;
+
+	return oxr_session_success_result(sess);
+}
+
+#endif // OXR_HAVE_META_foveation_eye_tracked
+
+
+/*
+ *
+ * XR_FB_passthrough
+ *
+ */
+
+#ifdef OXR_HAVE_FB_passthrough
+
+static XrResult
+oxr_passthrough_destroy_cb(struct oxr_logger *log, struct oxr_handle_base *hb)
+{
+	struct oxr_passthrough *passthrough = (struct oxr_passthrough *)hb;
+
+	free(passthrough);
+
+	return XR_SUCCESS;
+}
+
+static XrResult
+oxr_passthrough_layer_destroy_cb(struct oxr_logger *log, struct oxr_handle_base *hb)
+{
+	struct oxr_passthrough_layer *layer = (struct oxr_passthrough_layer *)hb;
+
+	free(layer);
+
+	return XR_SUCCESS;
+}
+
+XrResult
+oxr_passthrough_create(struct oxr_logger *log,
+                       struct oxr_session *sess,
+                       const XrPassthroughCreateInfoFB *createInfo,
+                       struct oxr_passthrough **out_passthrough)
+{
+	if (sess->sys->xsysc == NULL || !sess->sys->xsysc->info.supports_passthrough) {
+		return oxr_error(log, XR_ERROR_FEATURE_UNSUPPORTED, "System has no passthrough cameras");
+	}
+
+	if ((createInfo->flags & XR_PASSTHROUGH_LAYER_DEPTH_BIT_FB) != 0) {
+		return oxr_error(log, XR_ERROR_FEATURE_UNSUPPORTED, "Passthrough depth is not supported");
+	}
+
+	struct oxr_passthrough *passthrough = NULL;
+	OXR_ALLOCATE_HANDLE_OR_RETURN(log, passthrough, OXR_XR_DEBUG_PASSTHRU, oxr_passthrough_destroy_cb,
+	                              &sess->handle);
+
+	passthrough->sess = sess;
+	passthrough->running = (createInfo->flags & XR_PASSTHROUGH_IS_RUNNING_AT_CREATION_BIT_FB) != 0;
+
+	*out_passthrough = passthrough;
+
+	return XR_SUCCESS;
+}
+
+XrResult
+oxr_passthrough_layer_create(struct oxr_logger *log,
+                             struct oxr_session *sess,
+                             const XrPassthroughLayerCreateInfoFB *createInfo,
+                             struct oxr_passthrough_layer **out_layer)
+{
+	struct oxr_passthrough *passthrough = NULL;
+	OXR_VERIFY_PASSTHROUGH_NOT_NULL(log, createInfo->passthrough, passthrough);
+
+	if (passthrough->sess != sess) {
+		return oxr_error(log, XR_ERROR_VALIDATION_FAILURE,
+		                 "(createInfo->passthrough) was created from another session");
+	}
+
+	// Projected surfaces need geometry instances, which are not supported.
+	if (createInfo->purpose != XR_PASSTHROUGH_LAYER_PURPOSE_RECONSTRUCTION_FB) {
+		return oxr_error(log, XR_ERROR_FEATURE_UNSUPPORTED, "(createInfo->purpose == %d) is not supported",
+		                 createInfo->purpose);
+	}
+
+	// Layers go away with the passthrough, the frame end never sees a dangling one.
+	struct oxr_passthrough_layer *layer = NULL;
+	OXR_ALLOCATE_HANDLE_OR_RETURN(log, layer, OXR_XR_DEBUG_PTLAYER, oxr_passthrough_layer_destroy_cb,
+	                              &passthrough->handle);
+
+	layer->sess = sess;
+	layer->passthrough = passthrough;
+	layer->paused = (createInfo->flags & XR_PASSTHROUGH_IS_RUNNING_AT_CREATION_BIT_FB) == 0;
+	layer->opacity = 1.0f;
+
+	*out_layer = layer;
+
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrCreatePassthroughFB(XrSession session,
+                          const XrPassthroughCreateInfoFB *createInfo,
+                          XrPassthroughFB *outPassthrough)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_passthrough *passthrough = NULL;
+	struct oxr_session *sess = NULL;
+	struct oxr_logger log;
+	XrResult ret;
+	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrCreatePassthroughFB");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, createInfo, XR_TYPE_PASSTHROUGH_CREATE_INFO_FB);
+	OXR_VERIFY_ARG_NOT_NULL(&log, outPassthrough);
+
+	OXR_VERIFY_EXTENSION(&log, sess->sys->inst, FB_passthrough);
+
+	ret = oxr_passthrough_create(&log, sess, createInfo, &passthrough);
+	if (ret != XR_SUCCESS) {
+		return ret;
+	}
+
+	*outPassthrough = oxr_passthrough_to_openxr(passthrough);
+
+	return oxr_session_success_result(sess);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrDestroyPassthroughFB(XrPassthroughFB passthrough)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_passthrough *pt;
+	struct oxr_logger log;
+	OXR_VERIFY_PASSTHROUGH_AND_INIT_LOG(&log, passthrough, pt, "xrDestroyPassthroughFB");
+
+	return oxr_handle_destroy(&log, &pt->handle);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughStartFB(XrPassthroughFB passthrough)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_passthrough *pt;
+	struct oxr_logger log;
+	OXR_VERIFY_PASSTHROUGH_AND_INIT_LOG(&log, passthrough, pt, "xrPassthroughStartFB");
+
+	pt->running = true;
+
+	return oxr_session_success_result(pt->sess);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughPauseFB(XrPassthroughFB passthrough)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_passthrough *pt;
+	struct oxr_logger log;
+	OXR_VERIFY_PASSTHROUGH_AND_INIT_LOG(&log, passthrough, pt, "xrPassthroughPauseFB");
+
+	pt->running = false;
+
+	return oxr_session_success_result(pt->sess);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrCreatePassthroughLayerFB(XrSession session,
+                               const XrPassthroughLayerCreateInfoFB *createInfo,
+                               XrPassthroughLayerFB *outLayer)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_passthrough_layer *layer = NULL;
+	struct oxr_session *sess = NULL;
+	struct oxr_logger log;
+	XrResult ret;
+	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrCreatePassthroughLayerFB");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, createInfo, XR_TYPE_PASSTHROUGH_LAYER_CREATE_INFO_FB);
+	OXR_VERIFY_ARG_NOT_NULL(&log, outLayer);
+
+	OXR_VERIFY_EXTENSION(&log, sess->sys->inst, FB_passthrough);
+
+	ret = oxr_passthrough_layer_create(&log, sess, createInfo, &layer);
+	if (ret != XR_SUCCESS) {
+		return ret;
+	}
+
+	*outLayer = oxr_passthrough_layer_to_openxr(layer);
+
+	return oxr_session_success_result(sess);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrDestroyPassthroughLayerFB(XrPassthroughLayerFB layer)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_passthrough_layer *ptl;
+	struct oxr_logger log;
+	OXR_VERIFY_PASSTHROUGH_LAYER_AND_INIT_LOG(&log, layer, ptl, "xrDestroyPassthroughLayerFB");
+
+	return oxr_handle_destroy(&log, &ptl->handle);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughLayerPauseFB(XrPassthroughLayerFB layer)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_passthrough_layer *ptl;
+	struct oxr_logger log;
+	OXR_VERIFY_PASSTHROUGH_LAYER_AND_INIT_LOG(&log, layer, ptl, "xrPassthroughLayerPauseFB");
+
+	ptl->paused = true;
+
+	return oxr_session_success_result(ptl->sess);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughLayerResumeFB(XrPassthroughLayerFB layer)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_passthrough_layer *ptl;
+	struct oxr_logger log;
+	OXR_VERIFY_PASSTHROUGH_LAYER_AND_INIT_LOG(&log, layer, ptl, "xrPassthroughLayerResumeFB");
+
+	ptl->paused = false;
+
+	return oxr_session_success_result(ptl->sess);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrPassthroughLayerSetStyleFB(XrPassthroughLayerFB layer, const XrPassthroughStyleFB *style)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_passthrough_layer *ptl;
+	struct oxr_logger log;
+	OXR_VERIFY_PASSTHROUGH_LAYER_AND_INIT_LOG(&log, layer, ptl, "xrPassthroughLayerSetStyleFB");
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, style, XR_TYPE_PASSTHROUGH_STYLE_FB);
+
+	if (style->textureOpacityFactor < 0.0f || style->textureOpacityFactor > 1.0f) {
+		return oxr_error(&log, XR_ERROR_VALIDATION_FAILURE,
+		                 "(style->textureOpacityFactor == %f) must be between 0 and 1",
+		                 style->textureOpacityFactor);
+	}
+
+	//! @todo Edge color and color maps are ignored.
+	ptl->opacity = style->textureOpacityFactor;
+
+	return oxr_session_success_result(ptl->sess);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrCreateGeometryInstanceFB(XrSession session,
+                               const XrGeometryInstanceCreateInfoFB *createInfo,
+                               XrGeometryInstanceFB *outGeometryInstance)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_session *sess = NULL;
+	struct oxr_logger log;
+	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrCreateGeometryInstanceFB");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, createInfo, XR_TYPE_GEOMETRY_INSTANCE_CREATE_INFO_FB);
+	OXR_VERIFY_ARG_NOT_NULL(&log, outGeometryInstance);
+
+	OXR_VERIFY_EXTENSION(&log, sess->sys->inst, FB_passthrough);
+
+	// Only projected layers take geometry, and they can't be created.
+	return oxr_error(&log, XR_ERROR_FEATURE_UNSUPPORTED, "Projected passthrough is not supported");
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrDestroyGeometryInstanceFB(XrGeometryInstanceFB instance)
+{
+	OXR_TRACE_MARKER();
+
+	// No geometry instance can ever be created.
+	return XR_ERROR_HANDLE_INVALID;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGeometryInstanceSetTransformFB(XrGeometryInstanceFB instance, const XrGeometryInstanceTransformFB *transformation)
+{
+	OXR_TRACE_MARKER();
+
+	// No geometry instance can ever be created.
+	return XR_ERROR_HANDLE_INVALID;
+}
+
+#endif // OXR_HAVE_FB_passthrough
+
+
+/*
+ *
+ * XR_META_recommended_layer_resolution
+ *
+ */
+
+#ifdef OXR_HAVE_META_recommended_layer_resolution
+
+/*!
+ * Scales each view of the layer to the pixel count of its view in the view
+ * configuration times @p scale squared, keeping the aspect ratio of the sub
+ * image the app submitted. The views of quad views have different sizes, the
+ * largest result is returned since it is a single size for the whole layer.
+ */
+static bool
+calc_projection_layer_dimensions(struct oxr_logger *log,
+                                 struct oxr_session *sess,
+                                 const XrCompositionLayerProjection *proj,
+                                 float scale,
+                                 XrExtent2Di *out_dimensions)
+{
+	XrViewConfigurationView config_views[4];
+	uint32_t config_view_count = oxr_system_get_view_conf_count(sess->sys, sess->view_config_type);
+
+	if (proj->views == NULL || config_view_count == 0 || config_view_count > ARRAY_SIZE(config_views)) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < config_view_count; i++) {
+		config_views[i].type = XR_TYPE_VIEW_CONFIGURATION_VIEW;
+		config_views[i].next = NULL;
+	}
+
+	XrResult ret = oxr_system_enumerate_view_conf_views( //
+	    log,                                             //
+	    sess->sys,                                       //
+	    sess->view_config_type,                          //
+	    config_view_count,                               //
+	    &config_view_count,                              //
+	    config_views);                                   //
+	if (ret != XR_SUCCESS) {
+		return false;
+	}
+
+	uint32_t view_count = MIN(proj->viewCount, config_view_count);
+	int32_t w = 0;
+	int32_t h = 0;
+
+	for (uint32_t i = 0; i < view_count; i++) {
+		const XrExtent2Di *extent = &proj->views[i].subImage.imageRect.extent;
+		const XrViewConfigurationView *view = &config_views[i];
+
+		if (extent->width <= 0 || extent->height <= 0) {
+			continue;
+		}
+
+		// Relative to the recommended size, so following the result doesn't compound.
+		double recommended_area = (double)view->recommendedImageRectWidth * view->recommendedImageRectHeight;
+		double submitted_area = (double)extent->width * extent->height;
+		double factor = scale * sqrt(recommended_area / submitted_area);
+
+		int32_t view_w = (int32_t)(extent->width * factor);
+		int32_t view_h = (int32_t)(extent->height * factor);
+		view_w = MIN(view_w, (int32_t)view->maxImageRectWidth);
+		view_h = MIN(view_h, (int32_t)view->maxImageRectHeight);
+
+		w = MAX(w, view_w);
+		h = MAX(h, view_h);
+	}
+
+	if (w <= 0 || h <= 0) {
+		return false;
+	}
+
+	out_dimensions->width = w;
+	out_dimensions->height = h;
+
+	return true;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGetRecommendedLayerResolutionMETA(XrSession session,
+                                        const XrRecommendedLayerResolutionGetInfoMETA *info,
+                                        XrRecommendedLayerResolutionMETA *resolution)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_session *sess = NULL;
+	struct oxr_logger log;
+	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrGetRecommendedLayerResolutionMETA");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, info, XR_TYPE_RECOMMENDED_LAYER_RESOLUTION_GET_INFO_META);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, resolution, XR_TYPE_RECOMMENDED_LAYER_RESOLUTION_META);
+	OXR_VERIFY_ARG_NOT_NULL(&log, info->layer);
+
+	OXR_VERIFY_EXTENSION(&log, sess->sys->inst, META_recommended_layer_resolution);
+
+	if (info->predictedDisplayTime <= 0) {
+		return oxr_error(&log, XR_ERROR_TIME_INVALID,
+		                 "(info->predictedDisplayTime == %" PRIi64 ") is not a valid time.",
+		                 info->predictedDisplayTime);
+	}
+
+	resolution->recommendedImageDimensions.width = 0;
+	resolution->recommendedImageDimensions.height = 0;
+	resolution->isValid = XR_FALSE;
+
+	/*
+	 * Only projection layers are scaled, the GPU time we measure is
+	 * dominated by rendering the views. Headless sessions have no timing.
+	 */
+	if (sess->compositor == NULL || info->layer->type != XR_TYPE_COMPOSITION_LAYER_PROJECTION) {
+		return oxr_session_success_result(sess);
+	}
+
+	const XrCompositionLayerProjection *proj = (const XrCompositionLayerProjection *)info->layer;
+	float scale = sess->recommended_layer_resolution_scale;
+
+	if (calc_projection_layer_dimensions(&log, sess, proj, scale, &resolution->recommendedImageDimensions)) {
+		resolution->isValid = XR_TRUE;
+	}
+
+	return oxr_session_success_result(sess);
+}
+
+#endif // OXR_HAVE_META_recommended_layer_resolution
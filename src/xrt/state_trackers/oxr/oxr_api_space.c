@@ -20,6 +20,7 @@
 
 #include "oxr_api_funcs.h"
 #include "oxr_api_verify.h"
+#include "oxr_chain.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -147,6 +148,70 @@ oxr_xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation
 	return oxr_space_locate(&log, spc, baseSpc, time, location);
 }
 
+#ifdef OXR_HAVE_KHR_locate_spaces
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrLocateSpacesKHR(XrSession session, const XrSpacesLocateInfoKHR *locateInfo, XrSpaceLocationsKHR *spaceLocations)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_session *sess;
+	struct oxr_space *baseSpc;
+	struct oxr_logger log;
+	OXR_VERIFY_SESSION_AND_INIT_LOG(&log, session, sess, "xrLocateSpacesKHR");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sess);
+	OXR_VERIFY_EXTENSION(&log, sess->sys->inst, KHR_locate_spaces);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, locateInfo, XR_TYPE_SPACES_LOCATE_INFO_KHR);
+	OXR_VERIFY_ARG_TYPE_AND_NOT_NULL(&log, spaceLocations, XR_TYPE_SPACE_LOCATIONS_KHR);
+	OXR_VERIFY_SPACE_NOT_NULL(&log, locateInfo->baseSpace, baseSpc);
+	OXR_VERIFY_ARG_NOT_ZERO(&log, locateInfo->spaceCount);
+	OXR_VERIFY_ARG_NOT_NULL(&log, locateInfo->spaces);
+	OXR_VERIFY_ARG_NOT_NULL(&log, spaceLocations->locations);
+
+	uint32_t space_count = locateInfo->spaceCount;
+
+	if (spaceLocations->locationCount != space_count) {
+		return oxr_error(&log, XR_ERROR_VALIDATION_FAILURE,
+		                 "(spaceLocations->locationCount == %u) must equal (locateInfo->spaceCount == %u)",
+		                 spaceLocations->locationCount, space_count);
+	}
+
+	for (uint32_t i = 0; i < space_count; i++) {
+		struct oxr_space *spc;
+		OXR_VERIFY_SPACE_NOT_NULL(&log, locateInfo->spaces[i], spc);
+		(void)spc;
+	}
+
+	XrSpaceVelocityDataKHR *velocities = NULL;
+	XrSpaceVelocitiesKHR *vels =
+	    OXR_GET_OUTPUT_FROM_CHAIN(spaceLocations->next, XR_TYPE_SPACE_VELOCITIES_KHR, XrSpaceVelocitiesKHR);
+	if (vels != NULL) {
+		OXR_VERIFY_ARG_NOT_NULL(&log, vels->velocities);
+		velocities = vels->velocities;
+
+		if (vels->velocityCount != space_count) {
+			return oxr_error(&log, XR_ERROR_VALIDATION_FAILURE,
+			                 "(velocities->velocityCount == %u) must equal (locateInfo->spaceCount == %u)",
+			                 vels->velocityCount, space_count);
+		}
+	}
+
+	if (locateInfo->time <= (XrTime)0) {
+		return oxr_error(&log, XR_ERROR_TIME_INVALID, "(time == %" PRIi64 ") is not a valid time.",
+		                 locateInfo->time);
+	}
+
+	return oxr_space_locate_spaces( //
+	    &log,                       //
+	    sess,                       //
+	    baseSpc,                    //
+	    locateInfo->time,           //
+	    space_count,                //
+	    locateInfo->spaces,         //
+	    spaceLocations->locations,  //
+	    velocities);                //
+}
+#endif // OXR_HAVE_KHR_locate_spaces
+
 XRAPI_ATTR XrResult XRAPI_CALL
 oxr_xrDestroySpace(XrSpace space)
 {
@@ -194,3 +194,79 @@ oxr_xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageRelease
 
 	return sc->release_image(&log, sc, releaseInfo);
 }
+
+
+/*
+ *
+ * XR_FB_swapchain_update_state
+ *
+ */
+
+#ifdef OXR_HAVE_FB_swapchain_update_state
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrUpdateSwapchainFB(XrSwapchain swapchain, const XrSwapchainStateBaseHeaderFB *state)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_swapchain *sc;
+	struct oxr_logger log;
+	OXR_VERIFY_SWAPCHAIN_AND_INIT_LOG(&log, swapchain, sc, "xrUpdateSwapchainFB");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sc->sess);
+	OXR_VERIFY_EXTENSION(&log, sc->sess->sys->inst, FB_swapchain_update_state);
+	OXR_VERIFY_ARG_NOT_NULL(&log, state);
+
+	switch (state->type) {
+#ifdef OXR_HAVE_FB_foveation
+	case XR_TYPE_SWAPCHAIN_STATE_FOVEATION_FB: {
+		OXR_VERIFY_EXTENSION(&log, sc->sess->sys->inst, FB_foveation);
+
+		const XrSwapchainStateFoveationFB *foveation = (const XrSwapchainStateFoveationFB *)state;
+		struct oxr_foveation_profile *profile;
+		OXR_VERIFY_FOVEATION_PROFILE_NOT_NULL(&log, foveation->profile, profile);
+
+		XrResult ret = oxr_swapchain_update_foveation(&log, sc, profile);
+		if (ret != XR_SUCCESS) {
+			return ret;
+		}
+
+		return oxr_session_success_result(sc->sess);
+	}
+#endif // OXR_HAVE_FB_foveation
+	default:
+		return oxr_error(&log, XR_ERROR_VALIDATION_FAILURE, "(state->type == %u) is not supported",
+		                 state->type);
+	}
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL
+oxr_xrGetSwapchainStateFB(XrSwapchain swapchain, XrSwapchainStateBaseHeaderFB *state)
+{
+	OXR_TRACE_MARKER();
+
+	struct oxr_swapchain *sc;
+	struct oxr_logger log;
+	OXR_VERIFY_SWAPCHAIN_AND_INIT_LOG(&log, swapchain, sc, "xrGetSwapchainStateFB");
+	OXR_VERIFY_SESSION_NOT_LOST(&log, sc->sess);
+	OXR_VERIFY_EXTENSION(&log, sc->sess->sys->inst, FB_swapchain_update_state);
+	OXR_VERIFY_ARG_NOT_NULL(&log, state);
+
+	switch (state->type) {
+#ifdef OXR_HAVE_FB_foveation
+	case XR_TYPE_SWAPCHAIN_STATE_FOVEATION_FB: {
+		OXR_VERIFY_EXTENSION(&log, sc->sess->sys->inst, FB_foveation);
+
+		XrSwapchainStateFoveationFB *foveation = (XrSwapchainStateFoveationFB *)state;
+		foveation->flags = 0;
+		foveation->profile = sc->foveation.profile;
+
+		return oxr_session_success_result(sc->sess);
+	}
+#endif // OXR_HAVE_FB_foveation
+	default:
+		return oxr_error(&log, XR_ERROR_VALIDATION_FAILURE, "(state->type == %u) is not supported",
+		                 state->type);
+	}
+}
+
+#endif // OXR_HAVE_FB_swapchain_update_state
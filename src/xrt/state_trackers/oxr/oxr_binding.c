@@ -19,6 +19,7 @@
 #include "oxr_subaction.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 
 static void
@@ -79,17 +80,12 @@ interaction_profile_find_or_create(struct oxr_logger *log,
 		return true;
 	}
 
+	const char *str = NULL;
+	size_t length = 0;
 	struct profile_template *templ = NULL;
 
-	for (size_t x = 0; x < NUM_PROFILE_TEMPLATES; x++) {
-		XrPath t_path = XR_NULL_PATH;
-
-		oxr_path_get_or_create(log, inst, profile_templates[x].path, strlen(profile_templates[x].path),
-		                       &t_path);
-		if (t_path == path) {
-			templ = &profile_templates[x];
-			break;
-		}
+	if (oxr_path_get_string(log, inst, path, &str, &length) == XR_SUCCESS) {
+		templ = profile_template_find(str);
 	}
 
 	if (templ == NULL) {
@@ -106,6 +102,7 @@ interaction_profile_find_or_create(struct oxr_logger *log,
 	p->dpads = U_TYPED_ARRAY_CALLOC(struct oxr_dpad_emulation, p->dpad_count);
 	p->path = path;
 	p->localized_name = templ->localized_name;
+	p->templ = templ;
 
 	for (size_t x = 0; x < templ->binding_count; x++) {
 		struct binding_template *t = &templ->bindings[x];
@@ -169,33 +166,44 @@ reset_binding_keys(struct oxr_binding *binding)
 }
 
 static void
-reset_all_keys(struct oxr_binding *bindings, size_t binding_count)
+reset_all_keys(struct oxr_interaction_profile *p)
 {
-	for (size_t x = 0; x < binding_count; x++) {
-		reset_binding_keys(&bindings[x]);
+	for (size_t x = 0; x < p->binding_count; x++) {
+		reset_binding_keys(&p->bindings[x]);
 	}
+
+	free(p->binding_keys);
+	p->binding_keys = NULL;
+	p->binding_key_count = 0;
 }
 
 static void
-add_key_to_matching_bindings(struct oxr_binding *bindings, size_t binding_count, XrPath path, uint32_t key)
+add_key_to_matching_bindings(struct oxr_logger *log,
+                             struct oxr_instance *inst,
+                             struct oxr_interaction_profile *p,
+                             XrPath path,
+                             uint32_t key)
 {
-	for (size_t x = 0; x < binding_count; x++) {
-		struct oxr_binding *b = &bindings[x];
-
-		bool found = false;
-		uint32_t preferred_path_index;
-		for (uint32_t y = 0; y < b->path_count; y++) {
-			if (b->paths[y] == path) {
-				found = true;
-				preferred_path_index = y;
-				break;
-			}
-		}
+	const char *str = NULL;
+	size_t length = 0;
+
+	if (oxr_path_get_string(log, inst, path, &str, &length) != XR_SUCCESS) {
+		return;
+	}
 
-		if (!found) {
+	// Sorted by binding, so each binding is visited in order.
+	size_t count = 0;
+	const struct binding_path_lookup *lookups = profile_template_find_binding_paths(p->templ, str, &count);
+
+	for (size_t x = 0; x < count; x++) {
+		// Only the first matching path of a binding is used.
+		if (x > 0 && lookups[x].binding_index == lookups[x - 1].binding_index) {
 			continue;
 		}
 
+		struct oxr_binding *b = &p->bindings[lookups[x].binding_index];
+		uint32_t preferred_path_index = lookups[x].path_index;
+
 		U_ARRAY_REALLOC_OR_FREE(b->keys, uint32_t, (b->key_count + 1));
 		U_ARRAY_REALLOC_OR_FREE(b->preferred_binding_path_index, uint32_t, (b->key_count + 1));
 		b->preferred_binding_path_index[b->key_count] = preferred_path_index;
@@ -203,6 +211,53 @@ add_key_to_matching_bindings(struct oxr_binding *bindings, size_t binding_count,
 	}
 }
 
+static int
+compare_binding_key(const void *a, const void *b)
+{
+	const struct oxr_binding_key *ka = (const struct oxr_binding_key *)a;
+	const struct oxr_binding_key *kb = (const struct oxr_binding_key *)b;
+
+	if (ka->key != kb->key) {
+		return ka->key < kb->key ? -1 : 1;
+	}
+	if (ka->binding_index != kb->binding_index) {
+		return ka->binding_index < kb->binding_index ? -1 : 1;
+	}
+	return 0;
+}
+
+/*!
+ * Collect the keys of all bindings into one array sorted on key, so that
+ * finding the bindings of an action doesn't have to look at every binding.
+ */
+static void
+build_binding_keys(struct oxr_interaction_profile *p)
+{
+	size_t count = 0;
+	for (size_t x = 0; x < p->binding_count; x++) {
+		count += p->bindings[x].key_count;
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	p->binding_keys = U_TYPED_ARRAY_CALLOC(struct oxr_binding_key, count);
+	p->binding_key_count = count;
+
+	size_t i = 0;
+	for (size_t x = 0; x < p->binding_count; x++) {
+		struct oxr_binding *b = &p->bindings[x];
+		for (size_t y = 0; y < b->key_count; y++) {
+			p->binding_keys[i].key = b->keys[y];
+			p->binding_keys[i].binding_index = (uint32_t)x;
+			i++;
+		}
+	}
+
+	qsort(p->binding_keys, count, sizeof(struct oxr_binding_key), compare_binding_key);
+}
+
 static void
 add_string(char *temp, size_t max, ssize_t *current, const char *str)
 {
@@ -295,17 +350,10 @@ get_identifier_str_in_profile(struct oxr_logger *log,
 		return NULL;
 	}
 
-	for (size_t i = 0; i < oip->binding_count; i++) {
-		struct oxr_binding *binding = &oip->bindings[i];
-
-		for (size_t k = 0; k < binding->path_count; k++) {
-			if (binding->paths[k] != path) {
-				continue;
-			}
-			str = binding->localized_name;
-			i = oip->binding_count; // Break the outer loop as well.
-			break;
-		}
+	size_t count = 0;
+	const struct binding_path_lookup *lookups = profile_template_find_binding_paths(oip->templ, str, &count);
+	if (count > 0) {
+		str = oip->bindings[lookups[0].binding_index].localized_name;
 	}
 
 	return str;
@@ -402,23 +450,34 @@ oxr_binding_find_bindings_from_key(struct oxr_logger *log,
 		return;
 	}
 
+	// Lower bound of the key, all of its bindings follow in binding order.
+	size_t low = 0;
+	size_t high = p->binding_key_count;
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		if (p->binding_keys[mid].key < key) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
 	//! @todo This function should be a two call function, or handle more
-	//! then 32 bindings.
+	//! then OXR_MAX_BINDINGS_PER_ACTION bindings.
 	size_t num = 0;
 
-	for (size_t y = 0; y < p->binding_count; y++) {
-		struct oxr_binding *b = &p->bindings[y];
+	for (size_t y = low; y < p->binding_key_count && p->binding_keys[y].key == key; y++) {
+		uint32_t index = p->binding_keys[y].binding_index;
 
-		for (size_t z = 0; z < b->key_count; z++) {
-			if (b->keys[z] == key) {
-				bindings[num++] = b;
-				break;
-			}
+		// The same action can be suggested more then once for a binding.
+		if (y > low && p->binding_keys[y - 1].binding_index == index) {
+			continue;
 		}
 
-		if (num >= 32) {
-			*binding_count = num;
-			return;
+		bindings[num++] = &p->bindings[index];
+
+		if (num >= OXR_MAX_BINDINGS_PER_ACTION) {
+			break;
 		}
 	}
 
@@ -446,6 +505,17 @@ oxr_binding_destroy_all(struct oxr_logger *log, struct oxr_instance *inst)
 		p->bindings = NULL;
 		p->binding_count = 0;
 
+		free(p->binding_keys);
+		p->binding_keys = NULL;
+		p->binding_key_count = 0;
+
+		for (size_t y = 0; y < p->dpad_count; y++) {
+			free(p->dpads[y].paths);
+		}
+		free(p->dpads);
+		p->dpads = NULL;
+		p->dpad_count = 0;
+
 		oxr_dpad_state_deinit(&p->dpad_state);
 
 		free(p);
@@ -480,11 +550,8 @@ oxr_action_suggest_interaction_profile_bindings(struct oxr_logger *log,
 		goto out;
 	}
 
-	struct oxr_binding *bindings = p->bindings;
-	size_t binding_count = p->binding_count;
-
 	// Everything is now valid, reset the keys.
-	reset_all_keys(bindings, binding_count);
+	reset_all_keys(p);
 	// Transfer ownership of dpad state to profile
 	oxr_dpad_state_deinit(&p->dpad_state);
 	p->dpad_state = *dpad_state;
@@ -494,9 +561,11 @@ oxr_action_suggest_interaction_profile_bindings(struct oxr_logger *log,
 		const XrActionSuggestedBinding *s = &suggestedBindings->suggestedBindings[i];
 		struct oxr_action *act = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_action *, s->action);
 
-		add_key_to_matching_bindings(bindings, binding_count, s->binding, act->act_key);
+		add_key_to_matching_bindings(log, inst, p, s->binding, act->act_key);
 	}
 
+	build_binding_keys(p);
+
 out:
 	oxr_dpad_state_deinit(dpad_state); // if it hasn't been moved
 
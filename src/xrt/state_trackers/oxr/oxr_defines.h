@@ -25,6 +25,9 @@
 #define OXR_XR_DEBUG_SOURCESET (*(uint64_t *)"oxrsrcs\0")
 #define OXR_XR_DEBUG_SOURCE    (*(uint64_t *)"oxrsrc_\0")
 #define OXR_XR_DEBUG_HTRACKER  (*(uint64_t *)"oxrhtra\0")
+#define OXR_XR_DEBUG_FOVEATION (*(uint64_t *)"oxrfove\0")
+#define OXR_XR_DEBUG_PASSTHRU  (*(uint64_t *)"oxrpass\0")
+#define OXR_XR_DEBUG_PTLAYER   (*(uint64_t *)"oxrptly\0")
 // clang-format on
 
 /*!
@@ -207,6 +207,35 @@ oxr_event_push_XrEventDataMainSessionVisibilityChangedEXTX(struct oxr_logger *lo
 	return XR_SUCCESS;
 }
 
+#ifdef OXR_HAVE_EXT_performance_settings
+XrResult
+oxr_event_push_XrEventDataPerfSettingsEXT(struct oxr_logger *log,
+                                          struct oxr_session *sess,
+                                          enum xrt_perf_domain domain,
+                                          enum xrt_perf_sub_domain sub_domain,
+                                          enum xrt_perf_notify_level from_level,
+                                          enum xrt_perf_notify_level to_level)
+{
+	struct oxr_instance *inst = sess->sys->inst;
+	XrEventDataPerfSettingsEXT *changed;
+	struct oxr_event *event = NULL;
+
+	ALLOC(log, inst, &event, &changed);
+	changed->type = XR_TYPE_EVENT_DATA_PERF_SETTINGS_EXT;
+	// The xrt enums use the same values as the OpenXR ones.
+	changed->domain = (XrPerfSettingsDomainEXT)domain;
+	changed->subDomain = (XrPerfSettingsSubDomainEXT)sub_domain;
+	changed->fromLevel = (XrPerfSettingsNotificationLevelEXT)from_level;
+	changed->toLevel = (XrPerfSettingsNotificationLevelEXT)to_level;
+	event->result = XR_SUCCESS;
+	lock(inst);
+	push(inst, event);
+	unlock(inst);
+
+	return XR_SUCCESS;
+}
+#endif // OXR_HAVE_EXT_performance_settings
+
 XrResult
 oxr_event_remove_session_events(struct oxr_logger *log, struct oxr_session *sess)
 {
@@ -156,6 +156,17 @@
 #endif
 
 
+/*
+ * XR_KHR_locate_spaces
+ */
+#if defined(XR_KHR_locate_spaces)
+#define OXR_HAVE_KHR_locate_spaces
+#define OXR_EXTENSION_SUPPORT_KHR_locate_spaces(_) _(KHR_locate_spaces, KHR_LOCATE_SPACES)
+#else
+#define OXR_EXTENSION_SUPPORT_KHR_locate_spaces(_)
+#endif
+
+
 /*
  * XR_KHR_opengl_enable
  */
@@ -212,6 +223,18 @@
 #endif
 
 
+/*
+ * XR_KHR_vulkan_swapchain_format_list
+ */
+#if defined(XR_KHR_vulkan_swapchain_format_list) && defined(XR_USE_GRAPHICS_API_VULKAN)
+#define OXR_HAVE_KHR_vulkan_swapchain_format_list
+#define OXR_EXTENSION_SUPPORT_KHR_vulkan_swapchain_format_list(_)                                                      \
+	_(KHR_vulkan_swapchain_format_list, KHR_VULKAN_SWAPCHAIN_FORMAT_LIST)
+#else
+#define OXR_EXTENSION_SUPPORT_KHR_vulkan_swapchain_format_list(_)
+#endif
+
+
 /*
  * XR_KHR_win32_convert_performance_counter_time
  */
@@ -302,6 +325,17 @@
 #endif
 
 
+/*
+ * XR_EXT_performance_settings
+ */
+#if defined(XR_EXT_performance_settings)
+#define OXR_HAVE_EXT_performance_settings
+#define OXR_EXTENSION_SUPPORT_EXT_performance_settings(_) _(EXT_performance_settings, EXT_PERFORMANCE_SETTINGS)
+#else
+#define OXR_EXTENSION_SUPPORT_EXT_performance_settings(_)
+#endif
+
+
 /*
  * XR_EXT_samsung_odyssey_controller
  */
@@ -314,6 +348,18 @@
 #endif
 
 
+/*
+ * XR_FB_composition_layer_settings
+ */
+#if defined(XR_FB_composition_layer_settings)
+#define OXR_HAVE_FB_composition_layer_settings
+#define OXR_EXTENSION_SUPPORT_FB_composition_layer_settings(_)                                                         \
+	_(FB_composition_layer_settings, FB_COMPOSITION_LAYER_SETTINGS)
+#else
+#define OXR_EXTENSION_SUPPORT_FB_composition_layer_settings(_)
+#endif
+
+
 /*
  * XR_FB_display_refresh_rate
  */
@@ -325,6 +371,106 @@
 #endif
 
 
+/*
+ * XR_FB_foveation
+ */
+#if defined(XR_FB_foveation) && defined(XR_USE_GRAPHICS_API_VULKAN)
+#define OXR_HAVE_FB_foveation
+#define OXR_EXTENSION_SUPPORT_FB_foveation(_) _(FB_foveation, FB_FOVEATION)
+#else
+#define OXR_EXTENSION_SUPPORT_FB_foveation(_)
+#endif
+
+
+/*
+ * XR_FB_foveation_configuration
+ */
+#if defined(XR_FB_foveation_configuration) && defined(XR_USE_GRAPHICS_API_VULKAN)
+#define OXR_HAVE_FB_foveation_configuration
+#define OXR_EXTENSION_SUPPORT_FB_foveation_configuration(_) _(FB_foveation_configuration, FB_FOVEATION_CONFIGURATION)
+#else
+#define OXR_EXTENSION_SUPPORT_FB_foveation_configuration(_)
+#endif
+
+
+/*
+ * XR_FB_foveation_vulkan
+ */
+#if defined(XR_FB_foveation_vulkan) && defined(XR_USE_GRAPHICS_API_VULKAN)
+#define OXR_HAVE_FB_foveation_vulkan
+#define OXR_EXTENSION_SUPPORT_FB_foveation_vulkan(_) _(FB_foveation_vulkan, FB_FOVEATION_VULKAN)
+#else
+#define OXR_EXTENSION_SUPPORT_FB_foveation_vulkan(_)
+#endif
+
+
+/*
+ * XR_FB_haptic_pcm
+ */
+#if defined(XR_FB_haptic_pcm)
+#define OXR_HAVE_FB_haptic_pcm
+#define OXR_EXTENSION_SUPPORT_FB_haptic_pcm(_) _(FB_haptic_pcm, FB_HAPTIC_PCM)
+#else
+#define OXR_EXTENSION_SUPPORT_FB_haptic_pcm(_)
+#endif
+
+
+/*
+ * XR_FB_passthrough
+ */
+#if defined(XR_FB_passthrough)
+#define OXR_HAVE_FB_passthrough
+#define OXR_EXTENSION_SUPPORT_FB_passthrough(_) _(FB_passthrough, FB_PASSTHROUGH)
+#else
+#define OXR_EXTENSION_SUPPORT_FB_passthrough(_)
+#endif
+
+
+/*
+ * XR_FB_space_warp
+ */
+#if defined(XR_FB_space_warp) && defined(XRT_FEATURE_OPENXR_LAYER_DEPTH)
+#define OXR_HAVE_FB_space_warp
+#define OXR_EXTENSION_SUPPORT_FB_space_warp(_) _(FB_space_warp, FB_SPACE_WARP)
+#else
+#define OXR_EXTENSION_SUPPORT_FB_space_warp(_)
+#endif
+
+
+/*
+ * XR_FB_swapchain_update_state
+ */
+#if defined(XR_FB_swapchain_update_state)
+#define OXR_HAVE_FB_swapchain_update_state
+#define OXR_EXTENSION_SUPPORT_FB_swapchain_update_state(_) _(FB_swapchain_update_state, FB_SWAPCHAIN_UPDATE_STATE)
+#else
+#define OXR_EXTENSION_SUPPORT_FB_swapchain_update_state(_)
+#endif
+
+
+/*
+ * XR_META_foveation_eye_tracked
+ */
+#if defined(XR_META_foveation_eye_tracked) && defined(XR_USE_GRAPHICS_API_VULKAN)
+#define OXR_HAVE_META_foveation_eye_tracked
+#define OXR_EXTENSION_SUPPORT_META_foveation_eye_tracked(_) _(META_foveation_eye_tracked, META_FOVEATION_EYE_TRACKED)
+#else
+#define OXR_EXTENSION_SUPPORT_META_foveation_eye_tracked(_)
+#endif
+
+
+/*
+ * XR_META_recommended_layer_resolution
+ */
+#if defined(XR_META_recommended_layer_resolution)
+#define OXR_HAVE_META_recommended_layer_resolution
+#define OXR_EXTENSION_SUPPORT_META_recommended_layer_resolution(_)                                                     \
+	_(META_recommended_layer_resolution, META_RECOMMENDED_LAYER_RESOLUTION)
+#else
+#define OXR_EXTENSION_SUPPORT_META_recommended_layer_resolution(_)
+#endif
+
+
 /*
  * XR_ML_ml2_controller_interaction
  */
@@ -382,6 +528,28 @@
 #endif
 
 
+/*
+ * XR_VARJO_foveated_rendering
+ */
+#if defined(XR_VARJO_foveated_rendering)
+#define OXR_HAVE_VARJO_foveated_rendering
+#define OXR_EXTENSION_SUPPORT_VARJO_foveated_rendering(_) _(VARJO_foveated_rendering, VARJO_FOVEATED_RENDERING)
+#else
+#define OXR_EXTENSION_SUPPORT_VARJO_foveated_rendering(_)
+#endif
+
+
+/*
+ * XR_VARJO_quad_views
+ */
+#if defined(XR_VARJO_quad_views)
+#define OXR_HAVE_VARJO_quad_views
+#define OXR_EXTENSION_SUPPORT_VARJO_quad_views(_) _(VARJO_quad_views, VARJO_QUAD_VIEWS)
+#else
+#define OXR_EXTENSION_SUPPORT_VARJO_quad_views(_)
+#endif
+
+
 /*
  * XR_EXTX_overlay
  */
@@ -496,11 +664,13 @@
     OXR_EXTENSION_SUPPORT_KHR_D3D12_enable(_) \
     OXR_EXTENSION_SUPPORT_KHR_loader_init(_) \
     OXR_EXTENSION_SUPPORT_KHR_loader_init_android(_) \
+    OXR_EXTENSION_SUPPORT_KHR_locate_spaces(_) \
     OXR_EXTENSION_SUPPORT_KHR_opengl_enable(_) \
     OXR_EXTENSION_SUPPORT_KHR_opengl_es_enable(_) \
     OXR_EXTENSION_SUPPORT_KHR_swapchain_usage_input_attachment_bit(_) \
     OXR_EXTENSION_SUPPORT_KHR_vulkan_enable(_) \
     OXR_EXTENSION_SUPPORT_KHR_vulkan_enable2(_) \
+    OXR_EXTENSION_SUPPORT_KHR_vulkan_swapchain_format_list(_) \
     OXR_EXTENSION_SUPPORT_KHR_win32_convert_performance_counter_time(_) \
     OXR_EXTENSION_SUPPORT_EXT_debug_utils(_) \
     OXR_EXTENSION_SUPPORT_EXT_dpad_binding(_) \
@@ -509,13 +679,26 @@
     OXR_EXTENSION_SUPPORT_EXT_hand_tracking(_) \
     OXR_EXTENSION_SUPPORT_EXT_hp_mixed_reality_controller(_) \
     OXR_EXTENSION_SUPPORT_EXT_palm_pose(_) \
+    OXR_EXTENSION_SUPPORT_EXT_performance_settings(_) \
     OXR_EXTENSION_SUPPORT_EXT_samsung_odyssey_controller(_) \
+    OXR_EXTENSION_SUPPORT_FB_composition_layer_settings(_) \
     OXR_EXTENSION_SUPPORT_FB_display_refresh_rate(_) \
+    OXR_EXTENSION_SUPPORT_FB_foveation(_) \
+    OXR_EXTENSION_SUPPORT_FB_foveation_configuration(_) \
+    OXR_EXTENSION_SUPPORT_FB_foveation_vulkan(_) \
+    OXR_EXTENSION_SUPPORT_FB_haptic_pcm(_) \
+    OXR_EXTENSION_SUPPORT_FB_passthrough(_) \
+    OXR_EXTENSION_SUPPORT_FB_space_warp(_) \
+    OXR_EXTENSION_SUPPORT_FB_swapchain_update_state(_) \
+    OXR_EXTENSION_SUPPORT_META_foveation_eye_tracked(_) \
+    OXR_EXTENSION_SUPPORT_META_recommended_layer_resolution(_) \
     OXR_EXTENSION_SUPPORT_ML_ml2_controller_interaction(_) \
     OXR_EXTENSION_SUPPORT_MND_headless(_) \
     OXR_EXTENSION_SUPPORT_MND_swapchain_usage_input_attachment_bit(_) \
     OXR_EXTENSION_SUPPORT_MSFT_hand_interaction(_) \
     OXR_EXTENSION_SUPPORT_OPPO_controller_interaction(_) \
+    OXR_EXTENSION_SUPPORT_VARJO_foveated_rendering(_) \
+    OXR_EXTENSION_SUPPORT_VARJO_quad_views(_) \
     OXR_EXTENSION_SUPPORT_EXTX_overlay(_) \
     OXR_EXTENSION_SUPPORT_HTCX_vive_tracker_interaction(_) \
     OXR_EXTENSION_SUPPORT_MNDX_ball_on_a_stick_controller(_) \
@@ -792,6 +792,18 @@ oxr_action_attachment_bind(struct oxr_logger *log,
 	return XR_SUCCESS;
 }
 
+static float
+get_output_pcm_sample_rate(struct xrt_device *xdev, enum xrt_output_name name)
+{
+	for (size_t i = 0; i < xdev->output_count; i++) {
+		if (xdev->outputs[i].name == name) {
+			return xdev->outputs[i].pcm_sample_rate;
+		}
+	}
+
+	return 0.0f;
+}
+
 static void
 oxr_action_cache_stop_output(struct oxr_logger *log, struct oxr_session *sess, struct oxr_action_cache *cache)
 {
@@ -805,6 +817,12 @@ oxr_action_cache_stop_output(struct oxr_logger *log, struct oxr_session *sess, s
 		struct xrt_device *xdev = output->xdev;
 
 		xrt_device_set_output(xdev, output->name, &value);
+
+		// Drop any PCM samples not yet played.
+		if (get_output_pcm_sample_rate(xdev, output->name) > 0.0f) {
+			uint32_t consumed = 0;
+			xrt_device_queue_haptic_pcm(xdev, output->name, NULL, 0, false, &consumed);
+		}
 	}
 }
 
@@ -1034,7 +1052,8 @@ oxr_action_cache_update(struct oxr_logger *log,
 	/* a cache can only have outputs or inputs, not both */
 	if (cache->output_count > 0) {
 		cache->current.active = true;
-		if (cache->stop_output_time < time) {
+		// Zero means already stopped, like above, in service mode every stop is a round trip.
+		if (cache->stop_output_time > 0 && cache->stop_output_time < time) {
 			oxr_action_cache_stop_output(log, sess, cache);
 		}
 	} else if (cache->input_count > 0) {
@@ -1910,6 +1929,116 @@ set_action_output_vibration(struct oxr_session *sess,
 	}
 }
 
+#ifdef OXR_HAVE_FB_haptic_pcm
+/*!
+ * Queues the samples on a PCM output, linearly resampled if the application
+ * did not use the rate of the output.
+ *
+ * @return How many of the application's samples were consumed.
+ */
+static uint32_t
+queue_output_haptic_pcm(struct oxr_action_output *output, float output_rate, const XrHapticPcmVibrationFB *data)
+{
+	uint32_t consumed = 0;
+
+	if (data->sampleRate == output_rate) {
+		xrt_device_queue_haptic_pcm(output->xdev, output->name, data->buffer, data->bufferSize,
+		                            data->append == XR_TRUE, &consumed);
+		return consumed;
+	}
+
+	// Samples of the application per sample of the output, at most one full buffer per call.
+	double step = (double)data->sampleRate / (double)output_rate;
+	float samples[XR_MAX_HAPTIC_PCM_BUFFER_SIZE_FB];
+	uint32_t count = 0;
+
+	while (count < ARRAY_SIZE(samples)) {
+		double pos = (double)count * step;
+		uint32_t index = (uint32_t)pos;
+		if (index >= data->bufferSize) {
+			break;
+		}
+
+		uint32_t next = index + 1 < data->bufferSize ? index + 1 : index;
+		float amount = (float)(pos - (double)index);
+		samples[count++] = data->buffer[index] * (1.0f - amount) + data->buffer[next] * amount;
+	}
+
+	xrt_device_queue_haptic_pcm(output->xdev, output->name, samples, count, data->append == XR_TRUE, &consumed);
+
+	uint32_t app_consumed = (uint32_t)ceil((double)consumed * step);
+	return app_consumed < data->bufferSize ? app_consumed : data->bufferSize;
+}
+
+/*!
+ * Outputs that can not play samples get a plain vibration as long as the
+ * buffer at its peak amplitude, they consume all samples.
+ *
+ * @return How many samples all outputs consumed.
+ */
+static uint32_t
+set_action_output_pcm(struct oxr_action_cache *cache, int64_t now_ns, const XrHapticPcmVibrationFB *data)
+{
+	uint32_t min_consumed = data->bufferSize;
+	float peak = 0.0f;
+	for (uint32_t i = 0; i < data->bufferSize; i++) {
+		float abs_sample = fabsf(data->buffer[i]);
+		peak = abs_sample > peak ? abs_sample : peak;
+	}
+
+	for (uint32_t i = 0; i < cache->output_count; i++) {
+		struct oxr_action_output *output = &cache->outputs[i];
+		struct xrt_device *xdev = output->xdev;
+
+		float output_rate = get_output_pcm_sample_rate(xdev, output->name);
+		if (output_rate <= 0.0f) {
+			union xrt_output_value value = {0};
+			value.vibration.frequency = XR_FREQUENCY_UNSPECIFIED;
+			value.vibration.amplitude = peak;
+			value.vibration.duration_ns = time_s_to_ns((double)data->bufferSize / data->sampleRate);
+			xrt_device_set_output(xdev, output->name, &value);
+			continue;
+		}
+
+		uint32_t consumed = queue_output_haptic_pcm(output, output_rate, data);
+		min_consumed = consumed < min_consumed ? consumed : min_consumed;
+	}
+
+	// Keep the outputs going until the consumed samples have been played.
+	int64_t start_ns = now_ns;
+	if (data->append == XR_TRUE && cache->stop_output_time > now_ns) {
+		start_ns = cache->stop_output_time;
+	}
+	cache->stop_output_time = start_ns + time_s_to_ns((double)min_consumed / data->sampleRate);
+
+	return min_consumed;
+}
+
+static XrResult
+apply_haptic_pcm(struct oxr_session *sess,
+                 struct oxr_action_attachment *act_attached,
+                 struct oxr_subaction_paths subaction_paths,
+                 const XrHapticPcmVibrationFB *data)
+{
+	int64_t now_ns = time_state_get_now(sess->sys->inst->timekeeping);
+	uint32_t consumed = data->bufferSize;
+
+	// With several outputs report the least consumed, the application resends the rest.
+#define SET_OUT_PCM(X)                                                                                                 \
+	if (act_attached->X.current.active && (subaction_paths.X || subaction_paths.any)) {                            \
+		uint32_t X##_consumed = set_action_output_pcm(&act_attached->X, now_ns, data);                         \
+		consumed = X##_consumed < consumed ? X##_consumed : consumed;                                          \
+	}
+
+	OXR_FOR_EACH_SUBACTION_PATH(SET_OUT_PCM)
+#undef SET_OUT_PCM
+
+	*data->samplesConsumed = consumed;
+
+	return oxr_session_success_result(sess);
+}
+#endif // OXR_HAVE_FB_haptic_pcm
+
 XrResult
 oxr_action_apply_haptic_feedback(struct oxr_logger *log,
                                  struct oxr_session *sess,
@@ -1924,6 +2053,13 @@ oxr_action_apply_haptic_feedback(struct oxr_logger *log,
 		return oxr_error(log, XR_ERROR_ACTIONSET_NOT_ATTACHED, "Action has not been attached to this session");
 	}
 
+#ifdef OXR_HAVE_FB_haptic_pcm
+	if (hapticEvent->type == XR_TYPE_HAPTIC_PCM_VIBRATION_FB) {
+		const XrHapticPcmVibrationFB *pcm = (const XrHapticPcmVibrationFB *)hapticEvent;
+		return apply_haptic_pcm(sess, act_attached, subaction_paths, pcm);
+	}
+#endif
+
 	const XrHapticVibration *data = (const XrHapticVibration *)hapticEvent;
 
 	// This should all be moved into the drivers.
@@ -1946,6 +2082,41 @@ oxr_action_apply_haptic_feedback(struct oxr_logger *log,
 	return oxr_session_success_result(sess);
 }
 
+#ifdef OXR_HAVE_FB_haptic_pcm
+XrResult
+oxr_action_get_haptic_pcm_sample_rate(struct oxr_logger *log,
+                                      struct oxr_session *sess,
+                                      uint32_t act_key,
+                                      struct oxr_subaction_paths subaction_paths,
+                                      float *out_sample_rate)
+{
+	struct oxr_action_attachment *act_attached = NULL;
+
+	oxr_session_get_action_attachment(sess, act_key, &act_attached);
+	if (act_attached == NULL) {
+		return oxr_error(log, XR_ERROR_ACTIONSET_NOT_ATTACHED, "Action has not been attached to this session");
+	}
+
+	// The first bound output that plays samples, zero if none of them do.
+	float sample_rate = 0.0f;
+
+#define GET_PCM_SAMPLE_RATE(X)                                                                                         \
+	if (sample_rate <= 0.0f && (subaction_paths.X || subaction_paths.any)) {                                       \
+		for (size_t i = 0; i < act_attached->X.output_count && sample_rate <= 0.0f; i++) {                     \
+			struct oxr_action_output *output = &act_attached->X.outputs[i];                                \
+			sample_rate = get_output_pcm_sample_rate(output->xdev, output->name);                          \
+		}                                                                                                      \
+	}
+
+	OXR_FOR_EACH_SUBACTION_PATH(GET_PCM_SAMPLE_RATE)
+#undef GET_PCM_SAMPLE_RATE
+
+	*out_sample_rate = sample_rate;
+
+	return oxr_session_success_result(sess);
+}
+#endif // OXR_HAVE_FB_haptic_pcm
+
 XrResult
 oxr_action_stop_haptic_feedback(struct oxr_logger *log,
                                 struct oxr_session *sess,
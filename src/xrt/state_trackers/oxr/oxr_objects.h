@@ -120,6 +120,10 @@ struct oxr_interaction_profile;
 struct oxr_action_set_ref;
 struct oxr_action_ref;
 struct oxr_hand_tracker;
+struct oxr_foveation_profile;
+struct oxr_passthrough;
+struct oxr_passthrough_layer;
+struct profile_template;
 
 #define XRT_MAX_HANDLE_CHILDREN 256
 #define OXR_MAX_BINDINGS_PER_ACTION 16
@@ -370,6 +374,43 @@ oxr_hand_tracker_to_openxr(struct oxr_hand_tracker *hand_tracker)
 	return XRT_CAST_PTR_TO_OXR_HANDLE(XrHandTrackerEXT, hand_tracker);
 }
 
+#ifdef OXR_HAVE_FB_foveation
+/*!
+ * To go back to a OpenXR object.
+ *
+ * @relates oxr_foveation_profile
+ */
+static inline XrFoveationProfileFB
+oxr_foveation_profile_to_openxr(struct oxr_foveation_profile *profile)
+{
+	return XRT_CAST_PTR_TO_OXR_HANDLE(XrFoveationProfileFB, profile);
+}
+#endif // OXR_HAVE_FB_foveation
+
+#ifdef OXR_HAVE_FB_passthrough
+/*!
+ * To go back to a OpenXR object.
+ *
+ * @relates oxr_passthrough
+ */
+static inline XrPassthroughFB
+oxr_passthrough_to_openxr(struct oxr_passthrough *passthrough)
+{
+	return XRT_CAST_PTR_TO_OXR_HANDLE(XrPassthroughFB, passthrough);
+}
+
+/*!
+ * To go back to a OpenXR object.
+ *
+ * @relates oxr_passthrough_layer
+ */
+static inline XrPassthroughLayerFB
+oxr_passthrough_layer_to_openxr(struct oxr_passthrough_layer *layer)
+{
+	return XRT_CAST_PTR_TO_OXR_HANDLE(XrPassthroughLayerFB, layer);
+}
+#endif // OXR_HAVE_FB_passthrough
+
 /*!
  * To go back to a OpenXR object.
  *
@@ -514,6 +555,21 @@ oxr_action_apply_haptic_feedback(struct oxr_logger *log,
                                  uint32_t act_key,
                                  struct oxr_subaction_paths subaction_paths,
                                  const XrHapticBaseHeader *hapticEvent);
+#ifdef OXR_HAVE_FB_haptic_pcm
+/*!
+ * Sample rate of the first output bound to the action that plays PCM haptic
+ * samples, zero if there is none.
+ *
+ * @public @memberof oxr_session
+ */
+XrResult
+oxr_action_get_haptic_pcm_sample_rate(struct oxr_logger *log,
+                                      struct oxr_session *sess,
+                                      uint32_t act_key,
+                                      struct oxr_subaction_paths subaction_paths,
+                                      float *out_sample_rate);
+#endif
+
 /*!
  * @public @memberof oxr_session
  */
@@ -532,6 +588,37 @@ oxr_hand_tracker_create(struct oxr_logger *log,
                         const XrHandTrackerCreateInfoEXT *createInfo,
                         struct oxr_hand_tracker **out_hand_tracker);
 
+#ifdef OXR_HAVE_FB_foveation
+/*!
+ * @public @memberof oxr_session
+ */
+XrResult
+oxr_foveation_profile_create(struct oxr_logger *log,
+                             struct oxr_session *sess,
+                             const XrFoveationProfileCreateInfoFB *createInfo,
+                             struct oxr_foveation_profile **out_profile);
+#endif // OXR_HAVE_FB_foveation
+
+#ifdef OXR_HAVE_FB_passthrough
+/*!
+ * @public @memberof oxr_session
+ */
+XrResult
+oxr_passthrough_create(struct oxr_logger *log,
+                       struct oxr_session *sess,
+                       const XrPassthroughCreateInfoFB *createInfo,
+                       struct oxr_passthrough **out_passthrough);
+
+/*!
+ * @public @memberof oxr_session
+ */
+XrResult
+oxr_passthrough_layer_create(struct oxr_logger *log,
+                             struct oxr_session *sess,
+                             const XrPassthroughLayerCreateInfoFB *createInfo,
+                             struct oxr_passthrough_layer **out_layer);
+#endif // OXR_HAVE_FB_passthrough
+
 /*!
  * @}
  */
@@ -726,6 +813,23 @@ oxr_session_frame_begin(struct oxr_logger *log, struct oxr_session *sess);
 XrResult
 oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const XrFrameEndInfo *frameEndInfo);
 
+/*!
+ * Verify all of the layers given to xrEndFrame, done before any of them is
+ * handed to the compositor. Split out of @ref oxr_session_frame_end so it
+ * can be measured on its own, @p sess is only used to check that passthrough
+ * layers belong to it.
+ *
+ * @public @memberof oxr_session
+ */
+XrResult
+oxr_session_frame_end_verify_layers(struct oxr_logger *log,
+                                    struct oxr_session *sess,
+                                    struct xrt_compositor *xc,
+                                    struct xrt_device *head,
+                                    uint32_t view_count,
+                                    uint32_t max_layers,
+                                    const XrFrameEndInfo *frameEndInfo);
+
 XrResult
 oxr_session_hand_joints(struct oxr_logger *log,
                         struct oxr_hand_tracker *hand_tracker,
@@ -737,6 +841,18 @@ oxr_session_apply_force_feedback(struct oxr_logger *log,
                                  struct oxr_hand_tracker *hand_tracker,
                                  const XrForceFeedbackCurlApplyLocationsMNDX *locations);
 
+#if defined(OXR_HAVE_FB_foveation) || defined(OXR_HAVE_META_foveation_eye_tracked) ||                                \
+    defined(OXR_HAVE_VARJO_foveated_rendering)
+/*!
+ * Get the foveation centre of each view in NDC from the eyes role device,
+ * returns false if there is no eye gaze device or the gaze is not valid.
+ */
+bool
+oxr_session_get_foveation_eye_tracked_centers(struct oxr_logger *log,
+                                              struct oxr_session *sess,
+                                              struct xrt_vec2 out_centers[2]);
+#endif
+
 /*
  *
  * oxr_space.c
@@ -769,6 +885,24 @@ XrResult
 oxr_space_locate(
     struct oxr_logger *log, struct oxr_space *spc, struct oxr_space *baseSpc, XrTime time, XrSpaceLocation *location);
 
+#ifdef OXR_HAVE_KHR_locate_spaces
+/*!
+ * Locate many spaces in the same base space at once, all spaces are handed to
+ * the space overseer in a single call.
+ *
+ * @param velocities Optional, filled out if not null.
+ */
+XrResult
+oxr_space_locate_spaces(struct oxr_logger *log,
+                        struct oxr_session *sess,
+                        struct oxr_space *baseSpc,
+                        XrTime time,
+                        uint32_t space_count,
+                        const XrSpace *spaces,
+                        XrSpaceLocationDataKHR *locations,
+                        XrSpaceVelocityDataKHR *velocities);
+#endif // OXR_HAVE_KHR_locate_spaces
+
 /*!
  * Locate the @ref xrt_device in the given base space, useful for implementing
  * hand tracking location look ups and the like.
@@ -804,6 +938,17 @@ oxr_swapchain_to_openxr(struct oxr_swapchain *sc)
 	return XRT_CAST_PTR_TO_OXR_HANDLE(XrSwapchain, sc);
 }
 
+#ifdef OXR_HAVE_FB_foveation
+/*!
+ * Apply the settings of a foveation profile to the swapchain, called from
+ * xrUpdateSwapchainFB.
+ */
+XrResult
+oxr_swapchain_update_foveation(struct oxr_logger *log,
+                               struct oxr_swapchain *sc,
+                               struct oxr_foveation_profile *profile);
+#endif // OXR_HAVE_FB_foveation
+
 
 /*
  *
@@ -886,6 +1031,32 @@ oxr_system_enumerate_view_conf_views(struct oxr_logger *log,
                                      uint32_t *viewCountOutput,
                                      XrViewConfigurationView *views);
 
+/*!
+ * Number of views in the given view configuration, zero if the system does not
+ * support it.
+ */
+uint32_t
+oxr_system_get_view_conf_count(struct oxr_system *sys, XrViewConfigurationType viewConfigurationType);
+
+/*!
+ * Maximum number of layers the compositor takes in a single frame, this is
+ * what is reported as maxLayerCount.
+ */
+uint32_t
+oxr_system_get_max_layer_count(struct oxr_system *sys);
+
+#ifdef OXR_HAVE_VARJO_quad_views
+/*!
+ * Get the fov of the inset view for the given wide view fov, placed where the
+ * view is looking straight ahead or at @p gaze_center if not NULL.
+ */
+void
+oxr_system_get_quad_view_inset_fov(const struct xrt_fov *wide_fov,
+                                   const struct xrt_vec2 *gaze_center,
+                                   bool foveated,
+                                   struct xrt_fov *out_inset_fov);
+#endif
+
 bool
 oxr_system_get_hand_tracking_support(struct oxr_logger *log, struct oxr_instance *inst);
 
@@ -918,6 +1089,16 @@ oxr_event_push_XrEventDataMainSessionVisibilityChangedEXTX(struct oxr_logger *lo
 XrResult
 oxr_event_push_XrEventDataInteractionProfileChanged(struct oxr_logger *log, struct oxr_session *sess);
 
+#ifdef OXR_HAVE_EXT_performance_settings
+XrResult
+oxr_event_push_XrEventDataPerfSettingsEXT(struct oxr_logger *log,
+                                          struct oxr_session *sess,
+                                          enum xrt_perf_domain domain,
+                                          enum xrt_perf_sub_domain sub_domain,
+                                          enum xrt_perf_notify_level from_level,
+                                          enum xrt_perf_notify_level to_level);
+#endif // OXR_HAVE_EXT_performance_settings
+
 /*!
  * This clears all pending events refers to the given session.
  */
@@ -1265,6 +1446,8 @@ struct oxr_system
 		bool external_fence_fd_enabled;
 		bool external_semaphore_fd_enabled;
 		bool timeline_semaphore_enabled;
+		bool fragment_shading_rate_enabled;
+		bool image_format_list_enabled;
 	} vk;
 
 #endif
@@ -1429,6 +1612,8 @@ struct oxr_session
 
 	XrSessionState state;
 	bool has_begun;
+	//! The primary view configuration given to xrBeginSession.
+	XrViewConfigurationType view_config_type;
 	/*!
 	 * There is a extra state between xrBeginSession has been called and
 	 * the first xrEndFrame has been called. These are to track this.
@@ -1520,6 +1705,12 @@ struct oxr_session
 	//! Extra sleep in wait frame.
 	uint32_t frame_timing_wait_sleep_ms;
 
+	/*!
+	 * Per axis scale of the recommended view resolution, updated from
+	 * compositor events based on measured GPU headroom.
+	 */
+	float recommended_layer_resolution_scale;
+
 	/*!
 	 * To pipe swapchain creation to right code.
 	 */
@@ -1625,6 +1816,15 @@ struct oxr_dpad_emulation
 	enum xrt_input_name activate; // Can be zero
 };
 
+/*!
+ * Which binding of an interaction profile an action key is bound to.
+ */
+struct oxr_binding_key
+{
+	uint32_t key;
+	uint32_t binding_index;
+};
+
 /*!
  * A single interaction profile.
  */
@@ -1638,9 +1838,16 @@ struct oxr_interaction_profile
 	//! Name presented to the user.
 	const char *localized_name;
 
+	//! Generated template, has the sorted lookup from binding path to binding.
+	const struct profile_template *templ;
+
 	struct oxr_binding *bindings;
 	size_t binding_count;
 
+	//! The action keys of all bindings, sorted on key, rebuilt when bindings are suggested.
+	struct oxr_binding_key *binding_keys;
+	size_t binding_key_count;
+
 	struct oxr_dpad_emulation *dpads;
 	size_t dpad_count;
 
@@ -2002,6 +2209,24 @@ struct oxr_swapchain
 	// Is this a static swapchain, needed for acquire semantics.
 	bool is_static;
 
+#ifdef OXR_HAVE_FB_foveation
+	//! Foveation state set with xrUpdateSwapchainFB.
+	struct
+	{
+		//! Last applied profile, returned as is by xrGetSwapchainStateFB.
+		XrFoveationProfileFB profile;
+
+		//! Follow the eye gaze, the centres are updated on acquire.
+		bool eye_tracked;
+
+		//! Centres used when the eye gaze is not valid.
+		struct xrt_vec2 fixed_centers[2];
+
+		//! Last state given to the compositor swapchain.
+		struct xrt_foveation_state state;
+	} foveation;
+#endif // OXR_HAVE_FB_foveation
+
 
 	XrResult (*destroy)(struct oxr_logger *, struct oxr_swapchain *);
 
@@ -2249,6 +2474,90 @@ struct oxr_hand_tracker
 	XrHandJointSetEXT hand_joint_set;
 };
 
+#ifdef OXR_HAVE_FB_foveation
+/*!
+ * A foveation profile, only holds settings that are copied into swapchains by
+ * xrUpdateSwapchainFB so it can be destroyed right after.
+ *
+ * Parent type/handle is @ref oxr_session
+ *
+ *
+ * @obj{XrFoveationProfileFB}
+ * @extends oxr_handle_base
+ */
+struct oxr_foveation_profile
+{
+	//! Common structure for things referred to by OpenXR handles.
+	struct oxr_handle_base handle;
+
+	//! Owner of this foveation profile.
+	struct oxr_session *sess;
+
+	enum xrt_foveation_level level;
+
+	//! Vertical offset of the centre in degrees, positive is up.
+	float vertical_offset;
+
+	//! Was XR_FOVEATION_DYNAMIC_LEVEL_ENABLED_FB given.
+	bool dynamic;
+
+	//! Follow the eye gaze, from XR_META_foveation_eye_tracked.
+	bool eye_tracked;
+};
+#endif // OXR_HAVE_FB_foveation
+
+#ifdef OXR_HAVE_FB_passthrough
+/*!
+ * The passthrough feature of a session, the cameras themselves are started
+ * and stopped by the compositor when frames contain passthrough layers.
+ *
+ * Parent type/handle is @ref oxr_session
+ *
+ *
+ * @obj{XrPassthroughFB}
+ * @extends oxr_handle_base
+ */
+struct oxr_passthrough
+{
+	//! Common structure for things referred to by OpenXR handles.
+	struct oxr_handle_base handle;
+
+	//! Owner of this passthrough.
+	struct oxr_session *sess;
+
+	//! Between xrPassthroughStartFB and xrPassthroughPauseFB.
+	bool running;
+};
+
+/*!
+ * A passthrough layer, submitted with XrCompositionLayerPassthroughFB. Only
+ * the reconstruction purpose is supported, which shows the whole camera view.
+ *
+ * Parent type/handle is @ref oxr_passthrough, so it can never outlive it.
+ *
+ *
+ * @obj{XrPassthroughLayerFB}
+ * @extends oxr_handle_base
+ */
+struct oxr_passthrough_layer
+{
+	//! Common structure for things referred to by OpenXR handles.
+	struct oxr_handle_base handle;
+
+	//! Owner of the passthrough.
+	struct oxr_session *sess;
+
+	//! The passthrough this layer shows.
+	struct oxr_passthrough *passthrough;
+
+	//! Between xrPassthroughLayerPauseFB and xrPassthroughLayerResumeFB.
+	bool paused;
+
+	//! From XrPassthroughStyleFB::textureOpacityFactor.
+	float opacity;
+};
+#endif // OXR_HAVE_FB_passthrough
+
 /*!
  * @}
  */
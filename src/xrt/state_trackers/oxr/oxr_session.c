@@ -27,6 +27,7 @@
 
 #include "util/u_debug.h"
 #include "util/u_misc.h"
+#include "util/u_foveation.h"
 #include "util/u_time.h"
 #include "util/u_verify.h"
 
@@ -133,9 +134,7 @@ oxr_session_begin(struct oxr_logger *log, struct oxr_session *sess, const XrSess
 	if (xc != NULL) {
 		XrViewConfigurationType view_type = beginInfo->primaryViewConfigurationType;
 
-		if (view_type != sess->sys->view_config_type) {
-			/*! @todo we only support a single view config type per
-			 * system right now */
+		if (oxr_system_get_view_conf_count(sess->sys, view_type) == 0) {
 			return oxr_error(log, XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED,
 			                 "(beginInfo->primaryViewConfigurationType == "
 			                 "0x%08x) view configuration type not supported",
@@ -156,6 +155,7 @@ oxr_session_begin(struct oxr_logger *log, struct oxr_session *sess, const XrSess
 	}
 
 	sess->has_begun = true;
+	sess->view_config_type = beginInfo->primaryViewConfigurationType;
 
 	return oxr_session_success_result(sess);
 }
@@ -253,6 +253,22 @@ oxr_session_poll(struct oxr_logger *log, struct oxr_session *sess)
 			    time_state_monotonic_to_ts_ns(sess->sys->inst->timekeeping, xce.loss_pending.loss_time_ns));
 			break;
 		case XRT_COMPOSITOR_EVENT_LOST: sess->has_lost = true; break;
+		case XRT_COMPOSITOR_EVENT_PERFORMANCE_CHANGE:
+#ifdef OXR_HAVE_EXT_performance_settings
+			if (sess->sys->inst->extensions.EXT_performance_settings) {
+				oxr_event_push_XrEventDataPerfSettingsEXT( //
+				    log,                                   //
+				    sess,                                  //
+				    xce.performance.domain,                //
+				    xce.performance.sub_domain,            //
+				    xce.performance.from_level,            //
+				    xce.performance.to_level);             //
+			}
+#endif
+			break;
+		case XRT_COMPOSITOR_EVENT_RESOLUTION_SCALE_CHANGE:
+			sess->recommended_layer_resolution_scale = xce.resolution_scale.scale;
+			break;
 		default: U_LOG_W("unhandled event type! %d", xce.type); break;
 		}
 	}
@@ -306,7 +322,7 @@ oxr_session_locate_views(struct oxr_logger *log,
 	bool print = sess->sys->inst->debug_views;
 	struct xrt_device *xdev = GET_XDEV_BY_ROLE(sess->sys, head);
 	struct oxr_space *baseSpc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_space *, viewLocateInfo->space);
-	uint32_t view_count = 2;
+	uint32_t view_count = oxr_system_get_view_conf_count(sess->sys, viewLocateInfo->viewConfigurationType);
 
 	// Start two call handling.
 	if (viewCountOutput != NULL) {
@@ -379,7 +395,7 @@ oxr_session_locate_views(struct oxr_logger *log,
 	m_relation_chain_resolve(&xrc, &T_base_head);
 
 	if (print) {
-		for (uint32_t i = 0; i < view_count; i++) {
+		for (uint32_t i = 0; i < ARRAY_SIZE(fovs); i++) {
 			char tmp[32];
 			snprintf(tmp, 32, "xdev.view[%i]", i);
 			oxr_pp_fov_indented_as_object(&slog, &fovs[i], tmp);
@@ -389,7 +405,8 @@ oxr_session_locate_views(struct oxr_logger *log,
 		oxr_pp_relation_indented(&slog, &T_base_xdev, "T_base_xdev");
 	}
 
-	for (uint32_t i = 0; i < view_count; i++) {
+	// The wide views, or the only views for stereo.
+	for (uint32_t i = 0; i < ARRAY_SIZE(poses); i++) {
 		/*
 		 * Pose
 		 */
@@ -447,6 +464,38 @@ oxr_session_locate_views(struct oxr_logger *log,
 		}
 	}
 
+#ifdef OXR_HAVE_VARJO_quad_views
+	if (view_count == 4) {
+		bool foveated = false;
+		bool have_gaze = false;
+		struct xrt_vec2 gaze_centers[2];
+
+#ifdef OXR_HAVE_VARJO_foveated_rendering
+		const XrViewLocateFoveatedRenderingVARJO *foveated_info = NULL;
+		if (sess->sys->inst->extensions.VARJO_foveated_rendering) {
+			foveated_info = OXR_GET_INPUT_FROM_CHAIN(viewLocateInfo,
+			                                         XR_TYPE_VIEW_LOCATE_FOVEATED_RENDERING_VARJO,
+			                                         XrViewLocateFoveatedRenderingVARJO);
+		}
+		if (foveated_info != NULL && foveated_info->foveatedRenderingActive) {
+			foveated = true;
+			have_gaze = oxr_session_get_foveation_eye_tracked_centers(log, sess, gaze_centers);
+		}
+#endif
+
+		// The insets share the pose of the wide view of the same eye.
+		for (uint32_t i = 2; i < view_count; i++) {
+			views[i].pose = views[i - 2].pose;
+
+			const struct xrt_vec2 *gaze_center = have_gaze ? &gaze_centers[i - 2] : NULL;
+
+			struct xrt_fov inset_fov;
+			oxr_system_get_quad_view_inset_fov(&fovs[i - 2], gaze_center, foveated, &inset_fov);
+			OXR_XRT_FOV_TO_XRFOVF(inset_fov, views[i].fov);
+		}
+	}
+#endif
+
 	if (print) {
 		oxr_log_slog(log, &slog);
 	} else {
@@ -700,6 +749,7 @@ oxr_session_allocate_and_init(struct oxr_logger *log, struct oxr_system *sys, st
 	// Debug and user options.
 	sess->ipd_meters = debug_get_num_option_ipd() / 1000.0f;
 	sess->frame_timing_spew = debug_get_bool_option_frame_timing_spew();
+	sess->recommended_layer_resolution_scale = 1.0f;
 	sess->frame_timing_wait_sleep_ms = debug_get_num_option_wait_frame_sleep();
 
 	// Action system hashmaps.
@@ -1124,3 +1174,43 @@ oxr_session_apply_force_feedback(struct oxr_logger *log,
 
 	return XR_SUCCESS;
 }
+
+#if defined(OXR_HAVE_FB_foveation) || defined(OXR_HAVE_META_foveation_eye_tracked) ||                                \
+    defined(OXR_HAVE_VARJO_foveated_rendering)
+bool
+oxr_session_get_foveation_eye_tracked_centers(struct oxr_logger *log,
+                                              struct oxr_session *sess,
+                                              struct xrt_vec2 out_centers[2])
+{
+	struct xrt_device *head = GET_XDEV_BY_ROLE(sess->sys, head);
+	struct xrt_device *eyes = GET_XDEV_BY_ROLE(sess->sys, eyes);
+	if (eyes == NULL || !eyes->eye_gaze_supported) {
+		return false;
+	}
+
+	uint64_t now_ns = os_monotonic_get_ns();
+
+	struct xrt_space_relation gaze = XRT_SPACE_RELATION_ZERO;
+	xrt_device_get_tracked_pose(eyes, XRT_INPUT_GENERIC_EYE_GAZE_POSE, now_ns, &gaze);
+	if ((gaze.relation_flags & XRT_SPACE_RELATION_ORIENTATION_VALID_BIT) == 0) {
+		return false;
+	}
+
+	// Both are in the same tracking origin, move the gaze into head space.
+	struct xrt_space_relation head_relation = XRT_SPACE_RELATION_ZERO;
+	xrt_device_get_tracked_pose(head, XRT_INPUT_GENERIC_HEAD_POSE, now_ns, &head_relation);
+
+	struct xrt_vec3 forward = {0.0f, 0.0f, -1.0f};
+	struct xrt_quat head_inv;
+	struct xrt_vec3 dir;
+	math_quat_rotate_vec3(&gaze.pose.orientation, &forward, &dir);
+	math_quat_invert(&head_relation.pose.orientation, &head_inv);
+	math_quat_rotate_vec3(&head_inv, &dir, &dir);
+
+	for (uint32_t i = 0; i < 2; i++) {
+		u_foveation_center_from_direction(&head->hmd->distortion.fov[i], &dir, &out_centers[i]);
+	}
+
+	return true;
+}
+#endif
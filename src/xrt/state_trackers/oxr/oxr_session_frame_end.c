@@ -113,6 +113,48 @@ convert_layer_flags(XrSwapchainUsageFlags xr_flags)
 	return flags;
 }
 
+/*!
+ * Picks up XrCompositionLayerSettingsFB from the layer's next chain, if the
+ * app didn't chain one or the extension isn't enabled no bits are set.
+ */
+static enum xrt_layer_composition_flags
+convert_layer_settings(struct oxr_session *sess, const void *layer)
+{
+	enum xrt_layer_composition_flags flags = 0;
+
+#ifdef OXR_HAVE_FB_composition_layer_settings
+	if (!sess->sys->inst->extensions.FB_composition_layer_settings) {
+		return flags;
+	}
+
+	const XrCompositionLayerSettingsFB *settings =
+	    OXR_GET_INPUT_FROM_CHAIN(layer, XR_TYPE_COMPOSITION_LAYER_SETTINGS_FB, XrCompositionLayerSettingsFB);
+	if (settings == NULL) {
+		return flags;
+	}
+
+	XrCompositionLayerSettingsFlagsFB xr_flags = settings->layerFlags;
+
+	if ((xr_flags & XR_COMPOSITION_LAYER_SETTINGS_NORMAL_SUPER_SAMPLING_BIT_FB) != 0) {
+		flags |= XRT_LAYER_COMPOSITION_SUPER_SAMPLING_NORMAL_BIT;
+	}
+	if ((xr_flags & XR_COMPOSITION_LAYER_SETTINGS_QUALITY_SUPER_SAMPLING_BIT_FB) != 0) {
+		flags |= XRT_LAYER_COMPOSITION_SUPER_SAMPLING_QUALITY_BIT;
+	}
+	if ((xr_flags & XR_COMPOSITION_LAYER_SETTINGS_NORMAL_SHARPENING_BIT_FB) != 0) {
+		flags |= XRT_LAYER_COMPOSITION_SHARPENING_NORMAL_BIT;
+	}
+	if ((xr_flags & XR_COMPOSITION_LAYER_SETTINGS_QUALITY_SHARPENING_BIT_FB) != 0) {
+		flags |= XRT_LAYER_COMPOSITION_SHARPENING_QUALITY_BIT;
+	}
+#else
+	(void)sess;
+	(void)layer;
+#endif
+
+	return flags;
+}
+
 static enum xrt_layer_eye_visibility
 convert_eye_visibility(XrSwapchainUsageFlags xr_visibility)
 {
@@ -337,11 +379,119 @@ verify_depth_layer(struct xrt_compositor *xc,
 	return XR_SUCCESS;
 }
 
+#ifdef OXR_HAVE_FB_space_warp
+static XrResult
+verify_space_warp_sub_image(struct oxr_logger *log,
+                            uint32_t layer_index,
+                            uint32_t i,
+                            const char *name,
+                            const XrSwapchainSubImage *sub)
+{
+	if (sub->swapchain == XR_NULL_HANDLE) {
+		return oxr_error(log, XR_ERROR_HANDLE_INVALID,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>.%s."
+		                 "swapchain) is XR_NULL_HANDLE",
+		                 layer_index, i, name);
+	}
+
+	struct oxr_swapchain *sc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_swapchain *, sub->swapchain);
+
+	if (!sc->released.yes) {
+		return oxr_error(log, XR_ERROR_LAYER_INVALID,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>.%s."
+		                 "swapchain) swapchain has not been released",
+		                 layer_index, i, name);
+	}
+
+	if (sc->released.index >= (int)sc->swapchain->image_count) {
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>.%s."
+		                 "swapchain) internal image index out of bounds",
+		                 layer_index, i, name);
+	}
+
+	if (sc->array_layer_count <= sub->imageArrayIndex) {
+		return oxr_error(log, XR_ERROR_VALIDATION_FAILURE,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>.%s."
+		                 "imageArrayIndex == %u) Invalid swapchain array index for projection layer (%u).",
+		                 layer_index, i, name, sub->imageArrayIndex, sc->array_layer_count);
+	}
+
+	if (sc->face_count != 1) {
+		return oxr_error(log, XR_ERROR_VALIDATION_FAILURE,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>.%s."
+		                 "swapchain) Invalid swapchain face count (expected 1, got %u)",
+		                 layer_index, i, name, sc->face_count);
+	}
+
+	if (is_rect_neg(&sub->imageRect)) {
+		return oxr_error(log, XR_ERROR_SWAPCHAIN_RECT_INVALID,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>.%s."
+		                 "imageRect.offset == {%i, %i}) has negative component(s)",
+		                 layer_index, i, name, sub->imageRect.offset.x, sub->imageRect.offset.y);
+	}
+
+	if (is_rect_out_of_bounds(&sub->imageRect, sc)) {
+		return oxr_error(log, XR_ERROR_SWAPCHAIN_RECT_INVALID,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>.%s."
+		                 "imageRect == {{%i, %i}, {%u, %u}}) imageRect out of image bounds (%u, %u)",
+		                 layer_index, i, name, sub->imageRect.offset.x, sub->imageRect.offset.y,
+		                 sub->imageRect.extent.width, sub->imageRect.extent.height, sc->width, sc->height);
+	}
+
+	return XR_SUCCESS;
+}
+
+static XrResult
+verify_space_warp_info(struct oxr_logger *log,
+                       uint32_t layer_index,
+                       uint32_t i,
+                       const XrCompositionLayerSpaceWarpInfoFB *space_warp)
+{
+	XrResult ret = verify_space_warp_sub_image(log, layer_index, i, "motionVectorSubImage",
+	                                           &space_warp->motionVectorSubImage);
+	if (ret != XR_SUCCESS) {
+		return ret;
+	}
+
+	ret = verify_space_warp_sub_image(log, layer_index, i, "depthSubImage", &space_warp->depthSubImage);
+	if (ret != XR_SUCCESS) {
+		return ret;
+	}
+
+	// Only validated and passed on, the compositor doesn't extrapolate app space movement.
+	if (!math_quat_validate_within_1_percent((struct xrt_quat *)&space_warp->appSpaceDeltaPose.orientation)) {
+		const XrQuaternionf *q = &space_warp->appSpaceDeltaPose.orientation;
+		return oxr_error(log, XR_ERROR_POSE_INVALID,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>."
+		                 "appSpaceDeltaPose.orientation == {%f %f %f %f}) is not a valid quat",
+		                 layer_index, i, q->x, q->y, q->z, q->w);
+	}
+
+	if (space_warp->minDepth < 0.0f || space_warp->maxDepth > 1.0f || space_warp->minDepth > space_warp->maxDepth) {
+		return oxr_error(log, XR_ERROR_LAYER_INVALID,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>."
+		                 "minDepth/maxDepth) %f/%f must be in [0.0,1.0] and minDepth <= maxDepth",
+		                 layer_index, i, space_warp->minDepth, space_warp->maxDepth);
+	}
+
+	if (space_warp->nearZ == space_warp->farZ) {
+		return oxr_error(log, XR_ERROR_LAYER_INVALID,
+		                 "(frameEndInfo->layers[%u]->views[%i]->next<XrCompositionLayerSpaceWarpInfoFB>.nearZ) "
+		                 "%f must be != farZ %f ",
+		                 layer_index, i, space_warp->nearZ, space_warp->farZ);
+	}
+
+	return XR_SUCCESS;
+}
+#endif // OXR_HAVE_FB_space_warp
+
 static XrResult
 verify_projection_layer(struct xrt_compositor *xc,
                         struct oxr_logger *log,
                         uint32_t layer_index,
                         XrCompositionLayerProjection *proj,
+                        uint32_t view_count,
                         struct xrt_device *head,
                         uint64_t timestamp)
 {
@@ -350,16 +500,21 @@ verify_projection_layer(struct xrt_compositor *xc,
 		return ret;
 	}
 
-	if (proj->viewCount != 2) {
+	if (proj->viewCount != view_count) {
 		return oxr_error(log, XR_ERROR_VALIDATION_FAILURE,
-		                 "(frameEndInfo->layers[%u]->viewCount == %u) must be 2 for projection layers and the "
+		                 "(frameEndInfo->layers[%u]->viewCount == %u) must be %u for projection layers and the "
 		                 "current view configuration",
-		                 layer_index, proj->viewCount);
+		                 layer_index, proj->viewCount, view_count);
 	}
 
 	// number of depth layers must be 0 or proj->viewCount
 	uint32_t depth_layer_count = 0;
 
+#ifdef OXR_HAVE_FB_space_warp
+	// number of space warp infos must be 0 or proj->viewCount
+	uint32_t space_warp_count = 0;
+#endif
+
 	// Check for valid swapchain states.
 	for (uint32_t i = 0; i < proj->viewCount; i++) {
 		const XrCompositionLayerProjectionView *view = &proj->views[i];
@@ -450,6 +605,19 @@ verify_projection_layer(struct xrt_compositor *xc,
 			depth_layer_count++;
 		}
 #endif // XRT_FEATURE_OPENXR_LAYER_DEPTH
+
+#ifdef OXR_HAVE_FB_space_warp
+		const XrCompositionLayerSpaceWarpInfoFB *space_warp_info = OXR_GET_INPUT_FROM_CHAIN(
+		    view, XR_TYPE_COMPOSITION_LAYER_SPACE_WARP_INFO_FB, XrCompositionLayerSpaceWarpInfoFB);
+
+		if (space_warp_info) {
+			ret = verify_space_warp_info(log, layer_index, i, space_warp_info);
+			if (ret != XR_SUCCESS) {
+				return ret;
+			}
+			space_warp_count++;
+		}
+#endif // OXR_HAVE_FB_space_warp
 	}
 
 #ifdef XRT_FEATURE_OPENXR_LAYER_DEPTH
@@ -461,6 +629,15 @@ verify_projection_layer(struct xrt_compositor *xc,
 	}
 #endif // XRT_FEATURE_OPENXR_LAYER_DEPTH
 
+#ifdef OXR_HAVE_FB_space_warp
+	if (space_warp_count > 0 && space_warp_count != proj->viewCount) {
+		return oxr_error(
+		    log, XR_ERROR_VALIDATION_FAILURE,
+		    "(frameEndInfo->layers[%u] projection layer must have %u space warp infos or none, but has: %u)",
+		    layer_index, proj->viewCount, space_warp_count);
+	}
+#endif // OXR_HAVE_FB_space_warp
+
 	return XR_SUCCESS;
 }
 
@@ -820,6 +997,42 @@ verify_equirect2_layer(struct xrt_compositor *xc,
 #endif
 }
 
+static XrResult
+verify_passthrough_layer(struct oxr_logger *log,
+                         struct oxr_session *sess,
+                         uint32_t layer_index,
+                         const XrCompositionLayerPassthroughFB *passthrough)
+{
+#ifndef OXR_HAVE_FB_passthrough
+	return oxr_error(log, XR_ERROR_LAYER_INVALID,
+	                 "(frameEndInfo->layers[%u]->type) layer type "
+	                 "XrCompositionLayerPassthroughFB not supported",
+	                 layer_index);
+#else
+	struct oxr_passthrough_layer *ptl =
+	    XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_passthrough_layer *, passthrough->layerHandle);
+
+	if (ptl == NULL || ptl->handle.debug != OXR_XR_DEBUG_PTLAYER) {
+		return oxr_error(log, XR_ERROR_HANDLE_INVALID,
+		                 "(frameEndInfo->layers[%u]->layerHandle == %p) is not a valid passthrough layer",
+		                 layer_index, (void *)ptl);
+	}
+
+	if (ptl->sess != sess) {
+		return oxr_error(log, XR_ERROR_HANDLE_INVALID,
+		                 "(frameEndInfo->layers[%u]->layerHandle == %p) was created from another session",
+		                 layer_index, (void *)ptl);
+	}
+
+	if (!ptl->sess->sys->inst->extensions.FB_passthrough) {
+		return oxr_error(log, XR_ERROR_LAYER_INVALID,
+		                 "(frameEndInfo->layers[%u]->type) XR_FB_passthrough not enabled", layer_index);
+	}
+
+	return XR_SUCCESS;
+#endif // OXR_HAVE_FB_passthrough
+}
+
 
 /*
  *
@@ -906,6 +1119,7 @@ submit_quad_layer(struct oxr_session *sess,
 	struct oxr_space *spc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_space *, quad->space);
 
 	enum xrt_layer_composition_flags flags = convert_layer_flags(quad->layerFlags);
+	flags |= convert_layer_settings(sess, quad);
 
 	struct xrt_pose *pose_ptr = (struct xrt_pose *)&quad->pose;
 
@@ -938,6 +1152,32 @@ submit_quad_layer(struct oxr_session *sess,
 	return XR_SUCCESS;
 }
 
+#ifdef OXR_HAVE_FB_space_warp
+static void
+fill_in_space_warp(const XrCompositionLayerSpaceWarpInfoFB *info,
+                   struct oxr_swapchain **out_mv_sc,
+                   struct oxr_swapchain **out_d_sc,
+                   struct xrt_layer_space_warp_data *out_sw)
+{
+	struct oxr_swapchain *mv_sc =
+	    XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_swapchain *, info->motionVectorSubImage.swapchain);
+	struct oxr_swapchain *d_sc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_swapchain *, info->depthSubImage.swapchain);
+
+	fill_in_sub_image(mv_sc, &info->motionVectorSubImage, &out_sw->motion_vector_sub);
+	fill_in_sub_image(d_sc, &info->depthSubImage, &out_sw->depth.sub);
+
+	out_sw->depth.min_depth = info->minDepth;
+	out_sw->depth.max_depth = info->maxDepth;
+	out_sw->depth.near_z = info->nearZ;
+	out_sw->depth.far_z = info->farZ;
+	out_sw->app_space_delta_pose = *(struct xrt_pose *)&info->appSpaceDeltaPose;
+	out_sw->frame_skip = (info->layerFlags & XR_COMPOSITION_LAYER_SPACE_WARP_INFO_FRAME_SKIP_BIT_FB) != 0;
+
+	*out_mv_sc = mv_sc;
+	*out_d_sc = d_sc;
+}
+#endif // OXR_HAVE_FB_space_warp
+
 static XrResult
 submit_projection_layer(struct oxr_session *sess,
                         struct xrt_compositor *xc,
@@ -955,6 +1195,7 @@ submit_projection_layer(struct oxr_session *sess,
 	struct xrt_pose pose[2];
 
 	enum xrt_layer_composition_flags flags = convert_layer_flags(proj->layerFlags);
+	flags |= convert_layer_settings(sess, proj);
 
 	uint32_t swapchain_count = ARRAY_SIZE(scs);
 	for (uint32_t i = 0; i < swapchain_count; i++) {
@@ -1021,6 +1262,36 @@ submit_projection_layer(struct oxr_session *sess,
 	}
 #endif // XRT_FEATURE_OPENXR_LAYER_DEPTH
 
+#ifdef OXR_HAVE_FB_space_warp
+	const XrCompositionLayerSpaceWarpInfoFB *sw_l = OXR_GET_INPUT_FROM_CHAIN(
+	    &proj->views[0], XR_TYPE_COMPOSITION_LAYER_SPACE_WARP_INFO_FB, XrCompositionLayerSpaceWarpInfoFB);
+	const XrCompositionLayerSpaceWarpInfoFB *sw_r = OXR_GET_INPUT_FROM_CHAIN(
+	    &proj->views[1], XR_TYPE_COMPOSITION_LAYER_SPACE_WARP_INFO_FB, XrCompositionLayerSpaceWarpInfoFB);
+
+	if (sess->sys->inst->extensions.FB_space_warp && sw_l != NULL && sw_r != NULL) {
+		struct oxr_swapchain *mv_scs[2];
+		struct oxr_swapchain *sw_d_scs[2];
+
+		fill_in_space_warp(sw_l, &mv_scs[0], &sw_d_scs[0], &data.stereo_space_warp.l_sw);
+		fill_in_space_warp(sw_r, &mv_scs[1], &sw_d_scs[1], &data.stereo_space_warp.r_sw);
+
+		data.type = XRT_LAYER_STEREO_PROJECTION_SPACE_WARP;
+		xrt_result_t xret = xrt_comp_layer_stereo_projection_space_warp( //
+		    xc,                                                          // compositor
+		    head,                                                        // xdev
+		    scs[0]->swapchain,                                           // left
+		    scs[1]->swapchain,                                           // right
+		    sw_d_scs[0]->swapchain,                                      // left depth
+		    sw_d_scs[1]->swapchain,                                      // right depth
+		    mv_scs[0]->swapchain,                                        // left motion vectors
+		    mv_scs[1]->swapchain,                                        // right motion vectors
+		    &data);                                                      // data
+		OXR_CHECK_XRET(log, sess, xret, xrt_comp_layer_stereo_projection_space_warp);
+
+		return XR_SUCCESS;
+	}
+#endif // OXR_HAVE_FB_space_warp
+
 	if (d_scs[0] != NULL && d_scs[1] != NULL) {
 #ifdef XRT_FEATURE_OPENXR_LAYER_DEPTH
 		data.type = XRT_LAYER_STEREO_PROJECTION_DEPTH;
@@ -1049,6 +1320,105 @@ submit_projection_layer(struct oxr_session *sess,
 	return XR_SUCCESS;
 }
 
+#ifdef OXR_HAVE_VARJO_quad_views
+/*!
+ * The inset views of a quad views projection layer are submitted as a second
+ * stereo projection layer, the compositor blends it on top of the wide views.
+ */
+static XrResult
+submit_projection_inset_layer(struct oxr_session *sess,
+                              struct xrt_compositor *xc,
+                              struct oxr_logger *log,
+                              XrCompositionLayerProjection *proj,
+                              struct xrt_device *head,
+                              struct xrt_pose *inv_offset,
+                              uint64_t oxr_timestamp,
+                              uint64_t xrt_timestamp)
+{
+	if (proj->viewCount != 4) {
+		return XR_SUCCESS;
+	}
+
+	struct oxr_space *spc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_space *, proj->space);
+	const XrCompositionLayerProjectionView *inset_views = &proj->views[2];
+	struct oxr_swapchain *scs[2];
+	struct xrt_pose pose[2];
+
+	enum xrt_layer_composition_flags flags = convert_layer_flags(proj->layerFlags);
+	flags |= convert_layer_settings(sess, proj);
+	flags |= XRT_LAYER_COMPOSITION_INSET_BIT;
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(scs); i++) {
+		scs[i] = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_swapchain *, inset_views[i].subImage.swapchain);
+		struct xrt_pose *pose_ptr = (struct xrt_pose *)&inset_views[i].pose;
+
+		if (!handle_space(log, sess, spc, pose_ptr, inv_offset, oxr_timestamp, &pose[i])) {
+			return XR_SUCCESS;
+		}
+	}
+
+	if (spc->space_type == OXR_SPACE_TYPE_REFERENCE_VIEW) {
+		flags |= XRT_LAYER_COMPOSITION_VIEW_SPACE_BIT;
+	}
+
+	// Depth and space warp are only used from the wide views.
+	struct xrt_layer_data data;
+	U_ZERO(&data);
+	data.type = XRT_LAYER_STEREO_PROJECTION;
+	data.name = XRT_INPUT_GENERIC_HEAD_POSE;
+	data.timestamp = xrt_timestamp;
+	data.flags = flags;
+	data.stereo.l.fov = *(struct xrt_fov *)&inset_views[0].fov;
+	data.stereo.l.pose = pose[0];
+	data.stereo.r.fov = *(struct xrt_fov *)&inset_views[1].fov;
+	data.stereo.r.pose = pose[1];
+	fill_in_sub_image(scs[0], &inset_views[0].subImage, &data.stereo.l.sub);
+	fill_in_sub_image(scs[1], &inset_views[1].subImage, &data.stereo.r.sub);
+
+	xrt_result_t xret = xrt_comp_layer_stereo_projection( //
+	    xc,                                               // compositor
+	    head,                                             // xdev
+	    scs[0]->swapchain,                                // left
+	    scs[1]->swapchain,                                // right
+	    &data);                                           // data
+	OXR_CHECK_XRET(log, sess, xret, xrt_comp_layer_stereo_projection);
+
+	return XR_SUCCESS;
+}
+#endif // OXR_HAVE_VARJO_quad_views
+
+#ifdef OXR_HAVE_FB_passthrough
+static XrResult
+submit_passthrough_layer(struct oxr_session *sess,
+                         struct xrt_compositor *xc,
+                         struct oxr_logger *log,
+                         const XrCompositionLayerPassthroughFB *passthrough,
+                         struct xrt_device *head,
+                         uint64_t xrt_timestamp)
+{
+	struct oxr_passthrough_layer *ptl =
+	    XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_passthrough_layer *, passthrough->layerHandle);
+
+	// Paused layers and layers of a paused passthrough are left out.
+	if (ptl->paused || !ptl->passthrough->running) {
+		return XR_SUCCESS;
+	}
+
+	struct xrt_layer_data data = {0};
+
+	data.type = XRT_LAYER_PASSTHROUGH;
+	data.name = XRT_INPUT_GENERIC_HEAD_POSE;
+	data.timestamp = xrt_timestamp;
+	data.flags = convert_layer_flags(passthrough->flags);
+	data.passthrough.opacity = ptl->opacity;
+
+	xrt_result_t xret = xrt_comp_layer_passthrough(xc, head, &data);
+	OXR_CHECK_XRET(log, sess, xret, xrt_comp_layer_passthrough);
+
+	return XR_SUCCESS;
+}
+#endif // OXR_HAVE_FB_passthrough
+
 static XrResult
 submit_cube_layer(struct oxr_session *sess,
                   struct xrt_compositor *xc,
@@ -1068,6 +1438,7 @@ submit_cube_layer(struct oxr_session *sess,
 	data.name = XRT_INPUT_GENERIC_HEAD_POSE;
 	data.timestamp = xrt_timestamp;
 	data.flags = convert_layer_flags(cube->layerFlags);
+	data.flags |= convert_layer_settings(sess, cube);
 
 	if (spc->space_type == OXR_SPACE_TYPE_REFERENCE_VIEW) {
 		data.flags |= XRT_LAYER_COMPOSITION_VIEW_SPACE_BIT;
@@ -1113,6 +1484,7 @@ submit_cylinder_layer(struct oxr_session *sess,
 	struct oxr_space *spc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_space *, cylinder->space);
 
 	enum xrt_layer_composition_flags flags = convert_layer_flags(cylinder->layerFlags);
+	flags |= convert_layer_settings(sess, cylinder);
 	enum xrt_layer_eye_visibility visibility = convert_eye_visibility(cylinder->eyeVisibility);
 
 	struct xrt_pose *pose_ptr = (struct xrt_pose *)&cylinder->pose;
@@ -1160,6 +1532,7 @@ submit_equirect1_layer(struct oxr_session *sess,
 	struct oxr_space *spc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_space *, equirect->space);
 
 	enum xrt_layer_composition_flags flags = convert_layer_flags(equirect->layerFlags);
+	flags |= convert_layer_settings(sess, equirect);
 
 	struct xrt_pose *pose_ptr = (struct xrt_pose *)&equirect->pose;
 
@@ -1219,6 +1592,7 @@ submit_equirect2_layer(struct oxr_session *sess,
 	struct oxr_space *spc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_space *, equirect->space);
 
 	enum xrt_layer_composition_flags flags = convert_layer_flags(equirect->layerFlags);
+	flags |= convert_layer_settings(sess, equirect);
 
 	struct xrt_pose *pose_ptr = (struct xrt_pose *)&equirect->pose;
 
@@ -1251,6 +1625,82 @@ submit_equirect2_layer(struct oxr_session *sess,
 	return XR_SUCCESS;
 }
 
+XrResult
+oxr_session_frame_end_verify_layers(struct oxr_logger *log,
+                                    struct oxr_session *sess,
+                                    struct xrt_compositor *xc,
+                                    struct xrt_device *head,
+                                    uint32_t view_count,
+                                    uint32_t max_layers,
+                                    const XrFrameEndInfo *frameEndInfo)
+{
+	// Layers as handed to the compositor, the insets of quad views are layers of their own.
+	uint32_t xrt_layer_count = 0;
+
+	for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
+		const XrCompositionLayerBaseHeader *layer = frameEndInfo->layers[i];
+		if (layer == NULL) {
+			return oxr_error(log, XR_ERROR_LAYER_INVALID,
+			                 "(frameEndInfo->layers[%u] == NULL) layer cannot be null", i);
+		}
+
+		XrResult res;
+
+		switch (layer->type) {
+		case XR_TYPE_COMPOSITION_LAYER_PROJECTION:
+			res = verify_projection_layer(xc, log, i, (XrCompositionLayerProjection *)layer, view_count,
+			                              head, frameEndInfo->displayTime);
+			break;
+		case XR_TYPE_COMPOSITION_LAYER_QUAD:
+			res = verify_quad_layer(xc, log, i, (XrCompositionLayerQuad *)layer, head,
+			                        frameEndInfo->displayTime);
+			break;
+		case XR_TYPE_COMPOSITION_LAYER_CUBE_KHR:
+			res = verify_cube_layer(xc, log, i, (XrCompositionLayerCubeKHR *)layer, head,
+			                        frameEndInfo->displayTime);
+			break;
+		case XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR:
+			res = verify_cylinder_layer(xc, log, i, (XrCompositionLayerCylinderKHR *)layer, head,
+			                            frameEndInfo->displayTime);
+			break;
+		case XR_TYPE_COMPOSITION_LAYER_EQUIRECT_KHR:
+			res = verify_equirect1_layer(xc, log, i, (XrCompositionLayerEquirectKHR *)layer, head,
+			                             frameEndInfo->displayTime);
+			break;
+		case XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR:
+			res = verify_equirect2_layer(xc, log, i, (XrCompositionLayerEquirect2KHR *)layer, head,
+			                             frameEndInfo->displayTime);
+			break;
+		case XR_TYPE_COMPOSITION_LAYER_PASSTHROUGH_FB:
+			res = verify_passthrough_layer(log, sess, i, (XrCompositionLayerPassthroughFB *)layer);
+			break;
+		default:
+			return oxr_error(log, XR_ERROR_LAYER_INVALID,
+			                 "(frameEndInfo->layers[%u]->type) layer type not supported (%u)", i,
+			                 layer->type);
+		}
+
+		if (res != XR_SUCCESS) {
+			return res;
+		}
+
+		xrt_layer_count++;
+		if (layer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION &&
+		    ((const XrCompositionLayerProjection *)layer)->viewCount == 4) {
+			xrt_layer_count++;
+		}
+	}
+
+	if (xrt_layer_count > max_layers) {
+		return oxr_error(log, XR_ERROR_LAYER_LIMIT_EXCEEDED,
+		                 "(frameEndInfo->layerCount == %u) uses %u layers counting the quad view insets, "
+		                 "only %u are supported",
+		                 frameEndInfo->layerCount, xrt_layer_count, max_layers);
+	}
+
+	return XR_SUCCESS;
+}
+
 XrResult
 oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const XrFrameEndInfo *frameEndInfo)
 {
@@ -1346,49 +1796,13 @@ oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const Xr
 		return oxr_error(log, XR_ERROR_LAYER_INVALID, "(frameEndInfo->layers == NULL)");
 	}
 
-	for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
-		const XrCompositionLayerBaseHeader *layer = frameEndInfo->layers[i];
-		if (layer == NULL) {
-			return oxr_error(log, XR_ERROR_LAYER_INVALID,
-			                 "(frameEndInfo->layers[%u] == NULL) layer cannot be null", i);
-		}
-
-		XrResult res;
+	uint32_t view_count = oxr_system_get_view_conf_count(sess->sys, sess->view_config_type);
 
-		switch (layer->type) {
-		case XR_TYPE_COMPOSITION_LAYER_PROJECTION:
-			res = verify_projection_layer(xc, log, i, (XrCompositionLayerProjection *)layer, xdev,
-			                              frameEndInfo->displayTime);
-			break;
-		case XR_TYPE_COMPOSITION_LAYER_QUAD:
-			res = verify_quad_layer(xc, log, i, (XrCompositionLayerQuad *)layer, xdev,
-			                        frameEndInfo->displayTime);
-			break;
-		case XR_TYPE_COMPOSITION_LAYER_CUBE_KHR:
-			res = verify_cube_layer(xc, log, i, (XrCompositionLayerCubeKHR *)layer, xdev,
-			                        frameEndInfo->displayTime);
-			break;
-		case XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR:
-			res = verify_cylinder_layer(xc, log, i, (XrCompositionLayerCylinderKHR *)layer, xdev,
-			                            frameEndInfo->displayTime);
-			break;
-		case XR_TYPE_COMPOSITION_LAYER_EQUIRECT_KHR:
-			res = verify_equirect1_layer(xc, log, i, (XrCompositionLayerEquirectKHR *)layer, xdev,
-			                             frameEndInfo->displayTime);
-			break;
-		case XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR:
-			res = verify_equirect2_layer(xc, log, i, (XrCompositionLayerEquirect2KHR *)layer, xdev,
-			                             frameEndInfo->displayTime);
-			break;
-		default:
-			return oxr_error(log, XR_ERROR_LAYER_INVALID,
-			                 "(frameEndInfo->layers[%u]->type) layer type not supported (%u)", i,
-			                 layer->type);
-		}
+	uint32_t max_layers = oxr_system_get_max_layer_count(sess->sys);
 
-		if (res != XR_SUCCESS) {
-			return res;
-		}
+	XrResult res = oxr_session_frame_end_verify_layers(log, sess, xc, xdev, view_count, max_layers, frameEndInfo);
+	if (res != XR_SUCCESS) {
+		return res;
 	}
 
 
@@ -1420,6 +1834,10 @@ oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const Xr
 		case XR_TYPE_COMPOSITION_LAYER_PROJECTION:
 			submit_projection_layer(sess, xc, log, (XrCompositionLayerProjection *)layer, xdev, &inv_offset,
 			                        frameEndInfo->displayTime, xrt_display_time_ns);
+#ifdef OXR_HAVE_VARJO_quad_views
+			submit_projection_inset_layer(sess, xc, log, (XrCompositionLayerProjection *)layer, xdev,
+			                              &inv_offset, frameEndInfo->displayTime, xrt_display_time_ns);
+#endif
 			break;
 		case XR_TYPE_COMPOSITION_LAYER_QUAD:
 			submit_quad_layer(sess, xc, log, (XrCompositionLayerQuad *)layer, xdev, &inv_offset,
@@ -1441,6 +1859,12 @@ oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const Xr
 			submit_equirect2_layer(sess, xc, log, (XrCompositionLayerEquirect2KHR *)layer, xdev,
 			                       &inv_offset, frameEndInfo->displayTime, xrt_display_time_ns);
 			break;
+#ifdef OXR_HAVE_FB_passthrough
+		case XR_TYPE_COMPOSITION_LAYER_PASSTHROUGH_FB:
+			submit_passthrough_layer(sess, xc, log, (XrCompositionLayerPassthroughFB *)layer, xdev,
+			                         xrt_display_time_ns);
+			break;
+#endif
 		default: assert(false && "invalid layer type");
 		}
 	}
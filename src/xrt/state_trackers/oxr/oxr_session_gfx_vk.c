@@ -81,6 +81,8 @@ oxr_session_populate_vk(struct oxr_logger *log,
 	bool timeline_semaphore_enabled = sess->sys->vk.timeline_semaphore_enabled;
 	bool external_fence_fd_enabled = sess->sys->vk.external_fence_fd_enabled;
 	bool external_semaphore_fd_enabled = sess->sys->vk.external_semaphore_fd_enabled;
+	bool fragment_shading_rate_enabled = sess->sys->vk.fragment_shading_rate_enabled;
+	bool image_format_list_enabled = sess->sys->vk.image_format_list_enabled;
 
 
 #if defined(XRT_GRAPHICS_BUFFER_HANDLE_IS_FD)
@@ -119,6 +121,8 @@ oxr_session_populate_vk(struct oxr_logger *log,
 	    external_fence_fd_enabled,                               //
 	    external_semaphore_fd_enabled,                           //
 	    timeline_semaphore_enabled,                              //
+	    fragment_shading_rate_enabled,                           //
+	    image_format_list_enabled,                               //
 	    next->queueFamilyIndex,                                  //
 	    next->queueIndex);                                       //
 
@@ -56,6 +56,34 @@ check_reference_space_type(struct oxr_logger *log, XrReferenceSpaceType type)
 }
 
 
+static void
+relation_to_velocity(const struct xrt_space_relation *relation,
+                     XrSpaceVelocityFlags *out_flags,
+                     XrVector3f *out_linear,
+                     XrVector3f *out_angular)
+{
+	*out_flags = 0;
+
+	if ((relation->relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT) != 0) {
+		out_linear->x = relation->linear_velocity.x;
+		out_linear->y = relation->linear_velocity.y;
+		out_linear->z = relation->linear_velocity.z;
+		*out_flags |= XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
+	} else {
+		U_ZERO(out_linear);
+	}
+
+	if ((relation->relation_flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT) != 0) {
+		out_angular->x = relation->angular_velocity.x;
+		out_angular->y = relation->angular_velocity.y;
+		out_angular->z = relation->angular_velocity.z;
+		*out_flags |= XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+	} else {
+		U_ZERO(out_angular);
+	}
+}
+
+
 /*
  *
  * To xrt_space functions.
@@ -307,24 +335,7 @@ oxr_space_locate(
 	}
 
 	if (vel) {
-		vel->velocityFlags = 0;
-		if ((result.relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT) != 0) {
-			vel->linearVelocity.x = result.linear_velocity.x;
-			vel->linearVelocity.y = result.linear_velocity.y;
-			vel->linearVelocity.z = result.linear_velocity.z;
-			vel->velocityFlags |= XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
-		} else {
-			U_ZERO(&vel->linearVelocity);
-		}
-
-		if ((result.relation_flags & XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT) != 0) {
-			vel->angularVelocity.x = result.angular_velocity.x;
-			vel->angularVelocity.y = result.angular_velocity.y;
-			vel->angularVelocity.z = result.angular_velocity.z;
-			vel->velocityFlags |= XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
-		} else {
-			U_ZERO(&vel->angularVelocity);
-		}
+		relation_to_velocity(&result, &vel->velocityFlags, &vel->linearVelocity, &vel->angularVelocity);
 	}
 
 
@@ -342,6 +353,105 @@ oxr_space_locate(
 	return oxr_session_success_result(spc->sess);
 }
 
+#ifdef OXR_HAVE_KHR_locate_spaces
+XrResult
+oxr_space_locate_spaces(struct oxr_logger *log,
+                        struct oxr_session *sess,
+                        struct oxr_space *baseSpc,
+                        XrTime time,
+                        uint32_t space_count,
+                        const XrSpace *spaces,
+                        XrSpaceLocationDataKHR *locations,
+                        XrSpaceVelocityDataKHR *velocities)
+{
+	struct oxr_system *sys = sess->sys;
+
+	struct xrt_space **xspaces = U_TYPED_ARRAY_CALLOC(struct xrt_space *, space_count);
+	struct xrt_pose *offsets = U_TYPED_ARRAY_CALLOC(struct xrt_pose, space_count);
+	struct xrt_space_relation *results = U_TYPED_ARRAY_CALLOC(struct xrt_space_relation, space_count);
+
+
+	/*
+	 * Seek knowledge about the spaces from the space overseer, spaces
+	 * that fails are left null and get invalid locations.
+	 */
+
+	struct xrt_space *xbase = NULL;
+	XrResult ret = get_xrt_space(log, baseSpc, &xbase);
+
+	for (uint32_t i = 0; i < space_count; i++) {
+		struct oxr_space *spc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_space *, spaces[i]);
+
+		XrResult space_ret = get_xrt_space(log, spc, &xspaces[i]);
+		// Make sure not to overwrite error return
+		if (ret == XR_SUCCESS) {
+			ret = space_ret;
+		}
+
+		offsets[i] = spc->pose;
+		results[i] = (struct xrt_space_relation)XRT_SPACE_RELATION_ZERO;
+	}
+
+	// Only locate if we have a base space.
+	if (xbase != NULL) {
+		// Convert at_time to monotonic and give to device.
+		uint64_t at_timestamp_ns = time_state_ts_to_monotonic_ns(sys->inst->timekeeping, time);
+
+		// One call for all of the spaces, one round trip in the out of process case.
+		xrt_space_overseer_locate_spaces( //
+		    sys->xso,                     //
+		    xbase,                        //
+		    &baseSpc->pose,               //
+		    at_timestamp_ns,              //
+		    xspaces,                      //
+		    space_count,                  //
+		    offsets,                      //
+		    results);                     //
+	}
+
+
+	/*
+	 * Combine and copy
+	 */
+
+	for (uint32_t i = 0; i < space_count; i++) {
+		const struct xrt_space_relation *result = &results[i];
+
+		if (result->relation_flags == 0) {
+			locations[i].locationFlags = 0;
+			OXR_XRT_POSE_TO_XRPOSEF(XRT_POSE_IDENTITY, locations[i].pose);
+		} else {
+			OXR_XRT_POSE_TO_XRPOSEF(result->pose, locations[i].pose);
+			locations[i].locationFlags = xrt_to_xr_space_location_flags(result->relation_flags);
+		}
+
+		if (velocities != NULL) {
+			relation_to_velocity(result, &velocities[i].velocityFlags, &velocities[i].linearVelocity,
+			                     &velocities[i].angularVelocity);
+		}
+	}
+
+	if (sys->inst->debug_spaces) {
+		struct oxr_sink_logger slog = {0};
+		oxr_pp_space_indented(&slog, baseSpc, "baseSpace");
+		for (uint32_t i = 0; i < space_count; i++) {
+			oxr_pp_relation_indented(&slog, &results[i], "relation");
+		}
+		oxr_log_slog(log, &slog);
+	}
+
+	free(xspaces);
+	free(offsets);
+	free(results);
+
+	if (ret != XR_SUCCESS) {
+		return ret; // Return any error.
+	}
+
+	return oxr_session_success_result(sess);
+}
+#endif // OXR_HAVE_KHR_locate_spaces
+
 
 /*
  *
@@ -9,10 +9,14 @@
 
 #include "util/u_debug.h"
 #include "util/u_misc.h"
+#include "util/u_foveation.h"
+
+#include "math/m_mathinclude.h"
 
 #include "oxr_objects.h"
 #include "oxr_logger.h"
 #include "oxr_handle.h"
+#include "oxr_chain.h"
 #include "oxr_swapchain_common.h"
 #include "oxr_xret.h"
 
@@ -73,6 +77,71 @@ convert_usage_bits(XrSwapchainUsageFlags xr_usage)
 }
 
 
+/*
+ *
+ * Foveation helpers.
+ *
+ */
+
+#ifdef OXR_HAVE_FB_foveation
+
+/*!
+ * How far in NDC an eye tracked centre has to move before the foveation images
+ * are updated, every update costs an upload of the pattern.
+ */
+#define EYE_TRACKED_UPDATE_THRESHOLD (0.05f)
+
+static bool
+centers_moved(const struct xrt_vec2 a[2], const struct xrt_vec2 b[2])
+{
+	for (uint32_t i = 0; i < 2; i++) {
+		if (fabsf(a[i].x - b[i].x) > EYE_TRACKED_UPDATE_THRESHOLD ||
+		    fabsf(a[i].y - b[i].y) > EYE_TRACKED_UPDATE_THRESHOLD) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static XrResult
+set_foveation_state(struct oxr_logger *log, struct oxr_swapchain *sc, const struct xrt_foveation_state *state)
+{
+	xrt_result_t xret = xrt_swapchain_set_foveation(sc->swapchain, state);
+	if (xret == XRT_ERROR_COMPOSITOR_FUNCTION_NOT_IMPLEMENTED) {
+		// Swapchain has no foveation images, nothing to update.
+		xret = XRT_SUCCESS;
+	}
+	OXR_CHECK_XRET(log, sc->sess, xret, xrt_swapchain_set_foveation);
+
+	sc->foveation.state = *state;
+
+	return XR_SUCCESS;
+}
+
+static XrResult
+update_eye_tracked_foveation(struct oxr_logger *log, struct oxr_swapchain *sc)
+{
+	if (!sc->foveation.eye_tracked || sc->foveation.state.level == XRT_FOVEATION_LEVEL_NONE) {
+		return XR_SUCCESS;
+	}
+
+	struct xrt_foveation_state state = sc->foveation.state;
+	if (!oxr_session_get_foveation_eye_tracked_centers(log, sc->sess, state.centers)) {
+		state.centers[0] = sc->foveation.fixed_centers[0];
+		state.centers[1] = sc->foveation.fixed_centers[1];
+	}
+
+	if (!centers_moved(state.centers, sc->foveation.state.centers)) {
+		return XR_SUCCESS;
+	}
+
+	return set_foveation_state(log, sc, &state);
+}
+
+#endif // OXR_HAVE_FB_foveation
+
+
 /*
  *
  * Internal API functions.
@@ -193,6 +262,11 @@ oxr_swapchain_common_acquire(struct oxr_logger *log, struct oxr_swapchain *sc, u
 
 	struct xrt_swapchain *xsc = (struct xrt_swapchain *)sc->swapchain;
 
+#ifdef OXR_HAVE_FB_foveation
+	// Picked up by the barrier to the app after the acquire.
+	CHECK_OXR_RET(update_eye_tracked_foveation(log, sc));
+#endif
+
 	xrt_result_t xret = xrt_swapchain_acquire_image(xsc, &index);
 	OXR_CHECK_XRET(log, sc->sess, xret, xrt_swapchain_acquire_image);
 
@@ -272,6 +346,8 @@ XrResult
 oxr_swapchain_common_create(struct oxr_logger *log,
                             struct oxr_session *sess,
                             const XrSwapchainCreateInfo *createInfo,
+                            uint32_t format_count,
+                            const int64_t *formats,
                             struct oxr_swapchain **out_swapchain)
 {
 	xrt_result_t xret = XRT_SUCCESS;
@@ -286,6 +362,28 @@ oxr_swapchain_common_create(struct oxr_logger *log,
 	info.face_count = createInfo->faceCount;
 	info.array_size = createInfo->arraySize;
 	info.mip_count = createInfo->mipCount;
+	info.format_count = 0;
+
+	// Views in any other format are only allowed on mutable images.
+	if ((info.bits & XRT_SWAPCHAIN_USAGE_MUTABLE_FORMAT) != 0 &&
+	    format_count <= XRT_MAX_SWAPCHAIN_CREATE_INFO_FORMAT_LIST_COUNT) {
+		for (uint32_t i = 0; i < format_count; i++) {
+			info.formats[i] = formats[i];
+		}
+		info.format_count = format_count;
+	}
+
+#ifdef OXR_HAVE_FB_foveation
+	// The flags only pick the kind of image, all kinds get a shading rate image.
+	const XrSwapchainCreateInfoFoveationFB *foveation_info = NULL;
+	if (sess->sys->inst->extensions.FB_foveation) {
+		foveation_info = OXR_GET_INPUT_FROM_CHAIN(createInfo, XR_TYPE_SWAPCHAIN_CREATE_INFO_FOVEATION_FB,
+		                                          XrSwapchainCreateInfoFoveationFB);
+	}
+	if (foveation_info != NULL) {
+		info.create |= XRT_SWAPCHAIN_CREATE_FOVEATION;
+	}
+#endif
 
 	struct xrt_swapchain *xsc = NULL; // Has to be NULL.
 	xret = xrt_comp_create_swapchain(sess->compositor, &info, &xsc);
@@ -323,3 +421,35 @@ oxr_swapchain_common_create(struct oxr_logger *log,
 
 	return XR_SUCCESS;
 }
+
+#ifdef OXR_HAVE_FB_foveation
+XrResult
+oxr_swapchain_update_foveation(struct oxr_logger *log,
+                               struct oxr_swapchain *sc,
+                               struct oxr_foveation_profile *profile)
+{
+	struct xrt_device *head = GET_XDEV_BY_ROLE(sc->sess->sys, head);
+
+	// The offset moves the centre along the optical axis of each view.
+	float offset = tanf(profile->vertical_offset * (float)(M_PI / 180.0));
+	struct xrt_vec3 dir = {0.0f, offset, -1.0f};
+	for (uint32_t i = 0; i < 2; i++) {
+		u_foveation_center_from_direction(&head->hmd->distortion.fov[i], &dir, &sc->foveation.fixed_centers[i]);
+	}
+
+	sc->foveation.profile = oxr_foveation_profile_to_openxr(profile);
+	sc->foveation.eye_tracked = profile->eye_tracked;
+
+	struct xrt_foveation_state state = {
+	    .level = profile->level,
+	    .centers = {sc->foveation.fixed_centers[0], sc->foveation.fixed_centers[1]},
+	};
+
+	if (profile->eye_tracked) {
+		// Falls back to the fixed centres if the gaze is not valid.
+		oxr_session_get_foveation_eye_tracked_centers(log, sc->sess, state.centers);
+	}
+
+	return set_foveation_state(log, sc, &state);
+}
+#endif // OXR_HAVE_FB_foveation
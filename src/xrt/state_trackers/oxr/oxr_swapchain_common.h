@@ -92,11 +92,14 @@ oxr_swapchain_common_release(struct oxr_logger *log, struct oxr_swapchain *sc);
  * @param      log           Logger set with the current OpenXR function call context.
  * @param      sess          OpenXR session
  * @param      createInfo    Creation info.
- * @param      sc            Swapchain.
+ * @param      format_count  Number of formats in @p formats, zero if unknown.
+ * @param      formats       Formats the app will view the images as.
  * @param[out] out_swapchain Return of the allocated swapchain.
  */
 XrResult
 oxr_swapchain_common_create(struct oxr_logger *log,
                             struct oxr_session *sess,
                             const XrSwapchainCreateInfo *createInfo,
+                            uint32_t format_count,
+                            const int64_t *formats,
                             struct oxr_swapchain **out_swapchain);
@@ -89,7 +89,7 @@ oxr_swapchain_gl_create(struct oxr_logger *log,
 	struct oxr_swapchain *sc;
 	XrResult ret;
 
-	ret = oxr_swapchain_common_create(log, sess, createInfo, &sc);
+	ret = oxr_swapchain_common_create(log, sess, createInfo, 0, NULL, &sc);
 	if (ret != XR_SUCCESS) {
 		return ret;
 	}
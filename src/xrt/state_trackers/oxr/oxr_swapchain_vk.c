@@ -12,6 +12,7 @@
 
 #include "oxr_objects.h"
 #include "oxr_logger.h"
+#include "oxr_chain.h"
 #include "oxr_swapchain_common.h"
 #include "oxr_xret.h"
 #include <stdint.h>
@@ -95,6 +96,21 @@ vk_enumerate_images(struct oxr_logger *log,
 
 	for (uint32_t i = 0; i < count; i++) {
 		vk_imgs[i].image = xscvk->images[i];
+
+#ifdef OXR_HAVE_FB_foveation_vulkan
+		XrSwapchainImageFoveationVulkanFB *foveation = NULL;
+		if (sc->sess->sys->inst->extensions.FB_foveation_vulkan) {
+			foveation = OXR_GET_OUTPUT_FROM_CHAIN(&vk_imgs[i], XR_TYPE_SWAPCHAIN_IMAGE_FOVEATION_VULKAN_FB,
+			                                      XrSwapchainImageFoveationVulkanFB);
+		}
+
+		// Null handle if the swapchain was created without foveation.
+		if (foveation != NULL) {
+			foveation->image = xscvk->foveation_images[i];
+			foveation->width = xscvk->foveation_width;
+			foveation->height = xscvk->foveation_height;
+		}
+#endif
 	}
 
 	return oxr_session_success_result(sc->sess);
@@ -109,7 +125,36 @@ oxr_swapchain_vk_create(struct oxr_logger *log,
 	struct oxr_swapchain *sc;
 	XrResult ret;
 
-	ret = oxr_swapchain_common_create(log, sess, createInfo, &sc);
+	uint32_t format_count = 0;
+	int64_t formats[XRT_MAX_SWAPCHAIN_CREATE_INFO_FORMAT_LIST_COUNT];
+
+#ifdef OXR_HAVE_KHR_vulkan_swapchain_format_list
+	const XrVulkanSwapchainFormatListCreateInfoKHR *format_list = NULL;
+	if (sess->sys->inst->extensions.KHR_vulkan_swapchain_format_list) {
+		format_list = OXR_GET_INPUT_FROM_CHAIN(createInfo, XR_TYPE_VULKAN_SWAPCHAIN_FORMAT_LIST_CREATE_INFO_KHR,
+		                                       XrVulkanSwapchainFormatListCreateInfoKHR);
+	}
+
+	if (format_list != NULL && format_list->viewFormatCount > 0) {
+		if (format_list->pViewFormats == NULL) {
+			return oxr_error(log, XR_ERROR_VALIDATION_FAILURE,
+			                 "(XrVulkanSwapchainFormatListCreateInfoKHR::pViewFormats == NULL)");
+		}
+
+		// A longer list only loses the compression, the images still take any compatible format.
+		if (format_list->viewFormatCount <= XRT_MAX_SWAPCHAIN_CREATE_INFO_FORMAT_LIST_COUNT) {
+			for (uint32_t i = 0; i < format_list->viewFormatCount; i++) {
+				formats[i] = format_list->pViewFormats[i];
+			}
+			format_count = format_list->viewFormatCount;
+		} else {
+			oxr_warn(log, "Ignoring view format list with %u formats, max is %u",
+			         format_list->viewFormatCount, XRT_MAX_SWAPCHAIN_CREATE_INFO_FORMAT_LIST_COUNT);
+		}
+	}
+#endif
+
+	ret = oxr_swapchain_common_create(log, sess, createInfo, format_count, formats, &sc);
 	if (ret != XR_SUCCESS) {
 		return ret;
 	}
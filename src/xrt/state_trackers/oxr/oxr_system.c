@@ -15,6 +15,7 @@
 
 #include "xrt/xrt_device.h"
 #include "util/u_debug.h"
+#include "util/u_foveation.h"
 #include "util/u_verify.h"
 
 #include "oxr_objects.h"
@@ -25,6 +26,20 @@
 
 DEBUG_GET_ONCE_NUM_OPTION(scale_percentage, "OXR_VIEWPORT_SCALE_PERCENTAGE", 100)
 
+#ifdef OXR_HAVE_VARJO_quad_views
+/*!
+ * The wide views of quad views are rendered at this scale of the stereo views,
+ * the insets keep the full pixel density over a smaller part of the view.
+ */
+#define QUAD_VIEWS_WIDE_SCALE (0.5f)
+
+//! How much of the wide view the inset covers, along each axis in tangent space.
+#define QUAD_VIEWS_INSET_SCALE (0.4f)
+
+//! Smaller inset used when foveated rendering is active, it follows the gaze.
+#define QUAD_VIEWS_FOVEATED_INSET_SCALE (0.25f)
+#endif
+
 static enum xrt_form_factor
 convert_form_factor(XrFormFactor form_factor)
 {
@@ -186,6 +201,73 @@ oxr_system_fill_in(struct oxr_logger *log, struct oxr_instance *inst, XrSystemId
 	return XR_SUCCESS;
 }
 
+#ifdef OXR_HAVE_VARJO_quad_views
+/*!
+ * The insets are submitted as extra layers that only some compositors can
+ * place, without that the quad view configuration isn't offered at all.
+ */
+static bool
+supports_quad_views(struct oxr_system *sys)
+{
+	return sys->inst->extensions.VARJO_quad_views && sys->xsysc != NULL &&
+	       sys->xsysc->info.supports_inset_layers;
+}
+#endif
+
+uint32_t
+oxr_system_get_view_conf_count(struct oxr_system *sys, XrViewConfigurationType viewConfigurationType)
+{
+	if (viewConfigurationType == sys->view_config_type) {
+		switch (viewConfigurationType) {
+		case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO: return 1;
+		case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO: return 2;
+		default: return 0;
+		}
+	}
+
+#ifdef OXR_HAVE_VARJO_quad_views
+	if (viewConfigurationType == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO && supports_quad_views(sys)) {
+		return 4;
+	}
+#endif
+
+	return 0;
+}
+
+uint32_t
+oxr_system_get_max_layer_count(struct oxr_system *sys)
+{
+	struct xrt_system_compositor_info *info = sys->xsysc ? &sys->xsysc->info : NULL;
+
+	if (info) {
+		return info->max_layers;
+	}
+
+	// probably using the headless extension, but the extension does not modify the 16 layer minimum.
+	return 16;
+}
+
+#ifdef OXR_HAVE_VARJO_quad_views
+void
+oxr_system_get_quad_view_inset_fov(const struct xrt_fov *wide_fov,
+                                   const struct xrt_vec2 *gaze_center,
+                                   bool foveated,
+                                   struct xrt_fov *out_inset_fov)
+{
+	struct xrt_vec2 center;
+	if (gaze_center != NULL) {
+		center = *gaze_center;
+	} else {
+		// Straight ahead, not the middle of a possibly asymmetric fov.
+		const struct xrt_vec3 forward = {0.0f, 0.0f, -1.0f};
+		u_foveation_center_from_direction(wide_fov, &forward, &center);
+	}
+
+	float scale = foveated ? QUAD_VIEWS_FOVEATED_INSET_SCALE : QUAD_VIEWS_INSET_SCALE;
+	u_foveation_inset_fov(wide_fov, &center, scale, out_inset_fov);
+}
+#endif // OXR_HAVE_VARJO_quad_views
+
 bool
 oxr_system_get_hand_tracking_support(struct oxr_logger *log, struct oxr_instance *inst)
 {
@@ -232,15 +314,11 @@ oxr_system_get_properties(struct oxr_logger *log, struct oxr_system *sys, XrSyst
 	// The magical 247 number, is to silence warnings.
 	snprintf(properties->systemName, XR_MAX_SYSTEM_NAME_SIZE, "Monado: %.*s", 247, xdev->str);
 
-	// Get from compositor.
-	struct xrt_system_compositor_info *info = sys->xsysc ? &sys->xsysc->info : NULL;
-
-	if (info) {
-		properties->graphicsProperties.maxLayerCount = info->max_layers;
-	} else {
-		// probably using the headless extension, but the extension does not modify the 16 layer minimum.
-		properties->graphicsProperties.maxLayerCount = 16;
-	}
+	/*
+	 * Get from compositor, the inset views of quad views layers take up
+	 * layers of their own and are counted against this when verifying.
+	 */
+	properties->graphicsProperties.maxLayerCount = oxr_system_get_max_layer_count(sys);
 	properties->graphicsProperties.maxSwapchainImageWidth = 1024 * 16;
 	properties->graphicsProperties.maxSwapchainImageHeight = 1024 * 16;
 	properties->trackingProperties.orientationTracking = xdev->orientation_tracking_supported;
@@ -279,6 +357,71 @@ oxr_system_get_properties(struct oxr_logger *log, struct oxr_system *sys, XrSyst
 		force_feedback_props->supportsForceFeedbackCurl = oxr_system_get_force_feedback_support(log, sys->inst);
 	}
 
+#ifdef OXR_HAVE_FB_space_warp
+	XrSystemSpaceWarpPropertiesFB *space_warp_props = NULL;
+	if (sys->inst->extensions.FB_space_warp) {
+		space_warp_props = OXR_GET_OUTPUT_FROM_CHAIN(properties, XR_TYPE_SYSTEM_SPACE_WARP_PROPERTIES_FB,
+		                                             XrSystemSpaceWarpPropertiesFB);
+	}
+
+	if (space_warp_props) {
+		// Motion vectors are smooth, a quarter of the view resolution is plenty.
+		space_warp_props->recommendedMotionVectorImageRectWidth = sys->views[0].recommendedImageRectWidth / 4;
+		space_warp_props->recommendedMotionVectorImageRectHeight = sys->views[0].recommendedImageRectHeight / 4;
+	}
+#endif // OXR_HAVE_FB_space_warp
+
+#ifdef OXR_HAVE_FB_passthrough
+	XrSystemPassthroughPropertiesFB *passthrough_props = NULL;
+	XrSystemPassthroughProperties2FB *passthrough_props2 = NULL;
+	if (sys->inst->extensions.FB_passthrough) {
+		passthrough_props = OXR_GET_OUTPUT_FROM_CHAIN(properties, XR_TYPE_SYSTEM_PASSTHROUGH_PROPERTIES_FB,
+		                                              XrSystemPassthroughPropertiesFB);
+		passthrough_props2 = OXR_GET_OUTPUT_FROM_CHAIN(properties, XR_TYPE_SYSTEM_PASSTHROUGH_PROPERTIES2_FB,
+		                                               XrSystemPassthroughProperties2FB);
+	}
+
+	bool supports_passthrough = sys->xsysc != NULL && sys->xsysc->info.supports_passthrough;
+
+	if (passthrough_props) {
+		passthrough_props->supportsPassthrough = supports_passthrough;
+	}
+
+	if (passthrough_props2) {
+		// Colour cameras are shown as is, mono ones as grey.
+		passthrough_props2->capabilities =
+		    supports_passthrough ? (XR_PASSTHROUGH_CAPABILITY_BIT_FB | XR_PASSTHROUGH_CAPABILITY_COLOR_BIT_FB) : 0;
+	}
+#endif // OXR_HAVE_FB_passthrough
+
+#ifdef OXR_HAVE_META_foveation_eye_tracked
+	XrSystemFoveationEyeTrackedPropertiesMETA *foveation_eye_tracked_props = NULL;
+	if (sys->inst->extensions.META_foveation_eye_tracked) {
+		foveation_eye_tracked_props =
+		    OXR_GET_OUTPUT_FROM_CHAIN(properties, XR_TYPE_SYSTEM_FOVEATION_EYE_TRACKED_PROPERTIES_META,
+		                              XrSystemFoveationEyeTrackedPropertiesMETA);
+	}
+
+	if (foveation_eye_tracked_props) {
+		foveation_eye_tracked_props->supportsFoveationEyeTracked =
+		    oxr_system_get_eye_gaze_support(log, sys->inst);
+	}
+#endif // OXR_HAVE_META_foveation_eye_tracked
+
+#ifdef OXR_HAVE_VARJO_foveated_rendering
+	XrSystemFoveatedRenderingPropertiesVARJO *foveated_rendering_props = NULL;
+	if (sys->inst->extensions.VARJO_foveated_rendering) {
+		foveated_rendering_props =
+		    OXR_GET_OUTPUT_FROM_CHAIN(properties, XR_TYPE_SYSTEM_FOVEATED_RENDERING_PROPERTIES_VARJO,
+		                              XrSystemFoveatedRenderingPropertiesVARJO);
+	}
+
+	if (foveated_rendering_props) {
+		// Without eye tracking the inset is still smaller but stays in the middle.
+		foveated_rendering_props->supportsFoveatedRendering = supports_quad_views(sys);
+	}
+#endif // OXR_HAVE_VARJO_foveated_rendering
+
 	return XR_SUCCESS;
 }
 
@@ -289,8 +432,17 @@ oxr_system_enumerate_view_confs(struct oxr_logger *log,
                                 uint32_t *viewConfigurationTypeCountOutput,
                                 XrViewConfigurationType *viewConfigurationTypes)
 {
+	XrViewConfigurationType view_confs[2] = {sys->view_config_type};
+	uint32_t view_conf_count = 1;
+
+#ifdef OXR_HAVE_VARJO_quad_views
+	if (supports_quad_views(sys)) {
+		view_confs[view_conf_count++] = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO;
+	}
+#endif
+
 	OXR_TWO_CALL_HELPER(log, viewConfigurationTypeCapacityInput, viewConfigurationTypeCountOutput,
-	                    viewConfigurationTypes, 1, &sys->view_config_type, XR_SUCCESS);
+	                    viewConfigurationTypes, view_conf_count, view_confs, XR_SUCCESS);
 }
 
 XrResult
@@ -312,11 +464,11 @@ oxr_system_get_view_conf_properties(struct oxr_logger *log,
                                     XrViewConfigurationType viewConfigurationType,
                                     XrViewConfigurationProperties *configurationProperties)
 {
-	if (viewConfigurationType != sys->view_config_type) {
+	if (oxr_system_get_view_conf_count(sys, viewConfigurationType) == 0) {
 		return oxr_error(log, XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED, "Invalid view configuration type");
 	}
 
-	configurationProperties->viewConfigurationType = sys->view_config_type;
+	configurationProperties->viewConfigurationType = viewConfigurationType;
 	configurationProperties->fovMutable = XR_FALSE;
 
 	return XR_SUCCESS;
@@ -335,6 +487,65 @@ view_configuration_view_fill_in(XrViewConfigurationView *target_view, XrViewConf
 	// clang-format on
 }
 
+#ifdef OXR_HAVE_VARJO_quad_views
+static void
+quad_view_fill_in(XrViewConfigurationView *target_view, const XrViewConfigurationView *stereo_view, float scale)
+{
+	// clang-format off
+	target_view->recommendedImageRectWidth       = (uint32_t)(stereo_view->recommendedImageRectWidth * scale);
+	target_view->maxImageRectWidth               = stereo_view->maxImageRectWidth;
+	target_view->recommendedImageRectHeight      = (uint32_t)(stereo_view->recommendedImageRectHeight * scale);
+	target_view->maxImageRectHeight              = stereo_view->maxImageRectHeight;
+	target_view->recommendedSwapchainSampleCount = stereo_view->recommendedSwapchainSampleCount;
+	target_view->maxSwapchainSampleCount         = stereo_view->maxSwapchainSampleCount;
+	// clang-format on
+}
+
+static XrResult
+enumerate_quad_views(struct oxr_logger *log,
+                     struct oxr_system *sys,
+                     uint32_t viewCapacityInput,
+                     uint32_t *viewCountOutput,
+                     XrViewConfigurationView *views)
+{
+	const uint32_t view_count = 4;
+
+	// Can't use the helper, the size of the insets depends on the chain of each view.
+	if (viewCountOutput == NULL) {
+		return oxr_error(log, XR_ERROR_VALIDATION_FAILURE, "viewCountOutput");
+	}
+	*viewCountOutput = view_count;
+
+	if (viewCapacityInput == 0) {
+		return XR_SUCCESS;
+	}
+	if (viewCapacityInput < view_count) {
+		return oxr_error(log, XR_ERROR_SIZE_INSUFFICIENT, "(viewCapacityInput == %u) need %u",
+		                 viewCapacityInput, view_count);
+	}
+
+	// Left wide, right wide, left inset and right inset.
+	for (uint32_t i = 0; i < view_count; i++) {
+		float scale = i < 2 ? QUAD_VIEWS_WIDE_SCALE : QUAD_VIEWS_INSET_SCALE;
+
+#ifdef OXR_HAVE_VARJO_foveated_rendering
+		const XrFoveatedViewConfigurationViewVARJO *foveated = NULL;
+		if (i >= 2 && sys->inst->extensions.VARJO_foveated_rendering) {
+			foveated = OXR_GET_INPUT_FROM_CHAIN(&views[i], XR_TYPE_FOVEATED_VIEW_CONFIGURATION_VIEW_VARJO,
+			                                    XrFoveatedViewConfigurationViewVARJO);
+		}
+		if (foveated != NULL && foveated->foveatedRenderingActive) {
+			scale = QUAD_VIEWS_FOVEATED_INSET_SCALE;
+		}
+#endif
+
+		quad_view_fill_in(&views[i], &sys->views[i % 2], scale);
+	}
+
+	return XR_SUCCESS;
+}
+#endif // OXR_HAVE_VARJO_quad_views
+
 XrResult
 oxr_system_enumerate_view_conf_views(struct oxr_logger *log,
                                      struct oxr_system *sys,
@@ -343,10 +554,17 @@ oxr_system_enumerate_view_conf_views(struct oxr_logger *log,
                                      uint32_t *viewCountOutput,
                                      XrViewConfigurationView *views)
 {
-	if (viewConfigurationType != sys->view_config_type) {
+	uint32_t view_count = oxr_system_get_view_conf_count(sys, viewConfigurationType);
+	if (view_count == 0) {
 		return oxr_error(log, XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED, "Invalid view configuration type");
 	}
 
+#ifdef OXR_HAVE_VARJO_quad_views
+	if (view_count == 4) {
+		return enumerate_quad_views(log, sys, viewCapacityInput, viewCountOutput, views);
+	}
+#endif
+
 	OXR_TWO_CALL_FILL_IN_HELPER(log, viewCapacityInput, viewCountOutput, views, 2, view_configuration_view_fill_in,
 	                            sys->views, XR_SUCCESS);
 }
@@ -424,6 +424,13 @@ oxr_verify_extensions(struct oxr_logger *log, const struct oxr_extension_status
 		                 "XR_EXT_dpad_binding requires XR_KHR_binding_modification");
 	}
 
+#ifdef OXR_HAVE_VARJO_foveated_rendering
+	if (extensions->VARJO_foveated_rendering && !extensions->VARJO_quad_views) {
+		return oxr_error(log, XR_ERROR_VALIDATION_FAILURE,
+		                 "XR_VARJO_foveated_rendering requires XR_VARJO_quad_views");
+	}
+#endif
+
 	return XR_SUCCESS;
 }
 
@@ -439,6 +446,12 @@ oxr_verify_view_config_type(struct oxr_logger *log,
 		return XR_SUCCESS;
 	}
 
+#ifdef OXR_HAVE_VARJO_quad_views
+	if (view_conf == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO && inst->extensions.VARJO_quad_views) {
+		return XR_SUCCESS;
+	}
+#endif
+
 	return oxr_error(log, XR_ERROR_VALIDATION_FAILURE, "(%s == 0x%08x) invalid view configuration type",
 	                 view_conf_name, view_conf);
 }
@@ -377,6 +377,12 @@ oxr_vk_create_vulkan_device(struct oxr_logger *log,
 
 	free(props);
 
+#ifdef VK_KHR_image_format_list
+	// Either the app or us enabled it, needed to chain view format lists on swapchain images.
+	bool image_format_list_enabled =
+	    u_string_list_contains(device_extension_list, VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME);
+#endif
+
 
 	VkPhysicalDeviceFeatures2 physical_device_features = {
 	    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
@@ -434,6 +440,21 @@ oxr_vk_create_vulkan_device(struct oxr_logger *log,
 	}
 #endif
 
+#ifdef VK_KHR_fragment_shading_rate
+	/*
+	 * Foveation images are only useful if the app can attach them, so only
+	 * create them if the app has enabled both the extension and the feature.
+	 */
+	bool fragment_shading_rate_enabled = false;
+	const VkBaseInStructure *fsr = vk_find_struct_in_chain(
+	    (VkBaseInStructure *)&modified_info, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR);
+	if (fsr != NULL &&
+	    u_string_list_contains(device_extension_list, VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME)) {
+		fragment_shading_rate_enabled =
+		    ((const VkPhysicalDeviceFragmentShadingRateFeaturesKHR *)fsr)->attachmentFragmentShadingRate;
+	}
+#endif
+
 	*vulkanResult = CreateDevice(physical_device, &modified_info, createInfo->vulkanAllocator, vulkanDevice);
 
 
@@ -452,6 +473,10 @@ oxr_vk_create_vulkan_device(struct oxr_logger *log,
 #ifdef VK_KHR_timeline_semaphore
 		oxr_slog(&slog, "\n\ttimelineSemaphore: %s",
 		         timeline_semaphore_info.timelineSemaphore ? "true" : "false");
+#endif
+#ifdef VK_KHR_fragment_shading_rate
+		oxr_slog(&slog, "\n\tattachmentFragmentShadingRate: %s",
+		         fragment_shading_rate_enabled ? "true" : "false");
 #endif
 		oxr_slog(&slog, "\n\textensions:");
 		for (uint32_t i = 0; i < modified_info.enabledExtensionCount; i++) {
@@ -476,6 +501,18 @@ oxr_vk_create_vulkan_device(struct oxr_logger *log,
 	}
 #endif
 
+#ifdef VK_KHR_fragment_shading_rate
+	if (*vulkanResult == VK_SUCCESS) {
+		sys->vk.fragment_shading_rate_enabled = fragment_shading_rate_enabled;
+	}
+#endif
+
+#ifdef VK_KHR_image_format_list
+	if (*vulkanResult == VK_SUCCESS) {
+		sys->vk.image_format_list_enabled = image_format_list_enabled;
+	}
+#endif
+
 	u_string_list_destroy(&device_extension_list);
 
 	return XR_SUCCESS;
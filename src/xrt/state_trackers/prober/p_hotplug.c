@@ -0,0 +1,347 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Incremental hotplug handling for the prober.
+ * @author agent <agent@local>
+ * @ingroup st_prober
+ */
+
+#include "xrt/xrt_device.h"
+
+#include "util/u_misc.h"
+#include "util/u_trace_marker.h"
+
+#include "p_prober.h"
+
+#include <string.h>
+#include <assert.h>
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static void
+set_string_if_missing(const char **dst, const char *src)
+{
+	if (*dst == NULL && src != NULL) {
+		*dst = strdup(src);
+	}
+}
+
+static void
+remove_device(struct prober *p, size_t index, xrt_prober_hotplug_func_t cb, void *ptr)
+{
+	struct prober_device *pdev = &p->devices[index];
+
+	// The drivers never saw it, so nobody needs to know it is gone.
+	if (!pdev->hotplug.pending) {
+		cb(&p->base, XRT_PROBER_HOTPLUG_REMOVED, &pdev->base, pdev->hotplug.xdevs, pdev->hotplug.xdev_count,
+		   ptr);
+	}
+
+	p_dev_fini(pdev);
+
+	p->device_count--;
+	memmove(pdev, pdev + 1, sizeof(*pdev) * (p->device_count - index));
+}
+
+/*!
+ * Give a single device to the drivers that match it, only those drivers are
+ * asked so that already opened devices are left alone.
+ */
+static size_t
+create_for_device(struct prober *p, size_t index, struct xrt_device **xdevs)
+{
+	struct xrt_prober_device **dev_list = NULL;
+	size_t dev_count = 0;
+	size_t xdev_count = 0;
+	xrt_result_t xret;
+
+	xret = xrt_prober_lock_list(&p->base, &dev_list, &dev_count);
+	if (xret != XRT_SUCCESS) {
+		P_ERROR(p, "Failed to lock list!");
+		return 0;
+	}
+
+	struct prober_device *pdev = &p->devices[index];
+
+	for (size_t k = 0; k < p->num_entries; k++) {
+		struct xrt_prober_entry *entry = p->entries[k];
+		if (pdev->base.vendor_id != entry->vendor_id || pdev->base.product_id != entry->product_id) {
+			continue;
+		}
+
+		if (p_driver_is_disabled(p, entry->driver_name)) {
+			P_INFO(p, "Skipping disabled driver %s", entry->driver_name);
+			continue;
+		}
+
+		struct xrt_device *new_xdevs[XRT_MAX_DEVICES_PER_PROBE] = {NULL};
+		int num_found = entry->found(&p->base, dev_list, dev_count, index, NULL, &(new_xdevs[0]));
+
+		for (int created_idx = 0; created_idx < num_found; created_idx++) {
+			if (new_xdevs[created_idx] == NULL) {
+				continue;
+			}
+
+			if (xdev_count >= XRT_MAX_DEVICES_PER_PROBE) {
+				P_WARN(p, "Too many devices for one hotplug event, dropping '%s'",
+				       new_xdevs[created_idx]->str);
+				xrt_device_destroy(&new_xdevs[created_idx]);
+				continue;
+			}
+
+			xdevs[xdev_count++] = new_xdevs[created_idx];
+		}
+	}
+
+	xret = xrt_prober_unlock_list(&p->base, &dev_list);
+	if (xret != XRT_SUCCESS) {
+		P_ERROR(p, "Failed to unlock list!");
+	}
+
+	return xdev_count;
+}
+
+
+/*
+ *
+ * Event handling.
+ *
+ */
+
+static void
+apply_added(struct prober *p, const struct p_hotplug_event *ev, uint64_t now_ns)
+{
+	struct prober_device *pdev = NULL;
+	size_t old_count = p->device_count;
+	int ret;
+
+	// Both get functions return the existing device if already known.
+	if (ev->bus == XRT_BUS_TYPE_BLUETOOTH) {
+		ret = p_dev_get_bluetooth_dev(p, ev->bluetooth.id, ev->vendor_id, ev->product_id,
+		                              ev->bluetooth.product, &pdev);
+	} else {
+		ret = p_dev_get_usb_dev(p, ev->usb.bus, ev->usb.addr, ev->vendor_id, ev->product_id, &pdev);
+	}
+	if (ret != 0) {
+		P_ERROR(p, "Failed to get device for hotplug event!");
+		return;
+	}
+
+	if (p->device_count != old_count) {
+		P_DEBUG(p, "Hotplugged %04x:%04x", ev->vendor_id, ev->product_id);
+		pdev->hotplug.pending = true;
+	}
+
+	// Interfaces show up one by one, wait until they have all arrived.
+	if (pdev->hotplug.pending) {
+		pdev->hotplug.last_event_ns = now_ns;
+	}
+
+	if (ev->bus == XRT_BUS_TYPE_USB) {
+		pdev->base.usb_dev_class = ev->usb.dev_class;
+		set_string_if_missing(&pdev->usb.product, ev->usb.product);
+		set_string_if_missing(&pdev->usb.manufacturer, ev->usb.manufacturer);
+		set_string_if_missing(&pdev->usb.serial, ev->usb.serial);
+	}
+
+	switch (ev->type) {
+	case P_HOTPLUG_TYPE_USB:
+		set_string_if_missing(&pdev->usb.path, ev->path);
+
+		if (ev->usb.num_ports > 0) {
+			pdev->usb.num_ports = ev->usb.num_ports;
+			memcpy(pdev->usb.ports, ev->usb.ports, sizeof(pdev->usb.ports));
+		}
+
+#ifdef XRT_HAVE_LIBUSB
+		if (pdev->usb.dev == NULL && ev->usb.dev != NULL) {
+			pdev->usb.dev = libusb_ref_device(ev->usb.dev);
+		}
+#endif
+		break;
+	case P_HOTPLUG_TYPE_HIDRAW:
+#ifdef XRT_OS_LINUX
+		for (size_t i = 0; i < pdev->num_hidraws; i++) {
+			if (strcmp(pdev->hidraws[i].path, ev->path) == 0) {
+				return;
+			}
+		}
+		p_dev_add_hidraw(pdev, ev->interface, ev->path);
+#endif
+		break;
+	case P_HOTPLUG_TYPE_V4L:
+#ifdef XRT_HAVE_V4L2
+		for (size_t i = 0; i < pdev->num_v4ls; i++) {
+			if (strcmp(pdev->v4ls[i].path, ev->path) == 0) {
+				return;
+			}
+		}
+		p_dev_add_v4l(pdev, ev->v4l_index, ev->interface, ev->path);
+#endif
+		break;
+	}
+}
+
+static void
+apply_removed(struct prober *p, const struct p_hotplug_event *ev, xrt_prober_hotplug_func_t cb, void *ptr)
+{
+	for (size_t i = 0; i < p->device_count; i++) {
+		struct prober_device *pdev = &p->devices[i];
+
+		switch (ev->type) {
+		case P_HOTPLUG_TYPE_USB:
+			if (pdev->base.bus == XRT_BUS_TYPE_USB && pdev->usb.bus == ev->usb.bus &&
+			    pdev->usb.addr == ev->usb.addr) {
+				remove_device(p, i, cb, ptr);
+				return;
+			}
+			break;
+		case P_HOTPLUG_TYPE_HIDRAW:
+#ifdef XRT_OS_LINUX
+			for (size_t j = 0; j < pdev->num_hidraws; j++) {
+				if (strcmp(pdev->hidraws[j].path, ev->path) != 0) {
+					continue;
+				}
+
+				free((char *)pdev->hidraws[j].path);
+				pdev->num_hidraws--;
+				memmove(&pdev->hidraws[j], &pdev->hidraws[j + 1],
+				        sizeof(pdev->hidraws[0]) * (pdev->num_hidraws - j));
+
+				// Bluetooth devices are only known through their hidraw nodes.
+				if (pdev->base.bus == XRT_BUS_TYPE_BLUETOOTH && pdev->num_hidraws == 0) {
+					remove_device(p, i, cb, ptr);
+				}
+				return;
+			}
+#endif
+			break;
+		case P_HOTPLUG_TYPE_V4L:
+#ifdef XRT_HAVE_V4L2
+			for (size_t j = 0; j < pdev->num_v4ls; j++) {
+				if (strcmp(pdev->v4ls[j].path, ev->path) != 0) {
+					continue;
+				}
+
+				free((char *)pdev->v4ls[j].path);
+				pdev->num_v4ls--;
+				memmove(&pdev->v4ls[j], &pdev->v4ls[j + 1],
+				        sizeof(pdev->v4ls[0]) * (pdev->num_v4ls - j));
+				return;
+			}
+#endif
+			break;
+		}
+	}
+
+	// Already gone, or something we never knew about.
+}
+
+static void
+create_settled(struct prober *p, uint64_t now_ns, xrt_prober_hotplug_func_t cb, void *ptr)
+{
+	for (size_t i = 0; i < p->device_count; i++) {
+		struct prober_device *pdev = &p->devices[i];
+
+		if (!pdev->hotplug.pending || now_ns < pdev->hotplug.last_event_ns + p->hotplug.settle_ns) {
+			continue;
+		}
+
+		pdev->hotplug.pending = false;
+
+		struct xrt_device *xdevs[XRT_MAX_DEVICES_PER_PROBE] = {NULL};
+		size_t xdev_count = create_for_device(p, i, xdevs);
+
+		P_DEBUG(p, "Settled %04x:%04x, created %u devices", pdev->base.vendor_id, pdev->base.product_id,
+		        (uint32_t)xdev_count);
+
+		cb(&p->base, XRT_PROBER_HOTPLUG_ADDED, &pdev->base, xdevs, xdev_count, ptr);
+
+		// After the callback, so devices it destroyed right away are not handed back.
+		memcpy(pdev->hotplug.xdevs, xdevs, sizeof(xdevs));
+		pdev->hotplug.xdev_count = xdev_count;
+	}
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+p_hotplug_init(struct prober *p)
+{
+#ifdef XRT_HAVE_LIBUDEV
+	p_hotplug_add_source(p, p_udev_hotplug_create(p));
+#endif
+
+#ifdef XRT_HAVE_LIBUSB
+	// Covers systems without udev, both reporting the same device is fine.
+	p_hotplug_add_source(p, p_libusb_hotplug_create(p));
+#endif
+}
+
+void
+p_hotplug_add_source(struct prober *p, struct p_hotplug_source *src)
+{
+	if (src == NULL) {
+		return;
+	}
+
+	if (p->hotplug.source_count >= ARRAY_SIZE(p->hotplug.sources)) {
+		P_ERROR(p, "Too many hotplug sources!");
+		src->destroy(src);
+		return;
+	}
+
+	p->hotplug.sources[p->hotplug.source_count++] = src;
+}
+
+void
+p_hotplug_teardown(struct prober *p)
+{
+	for (uint32_t i = 0; i < p->hotplug.source_count; i++) {
+		struct p_hotplug_source *src = p->hotplug.sources[i];
+		src->destroy(src);
+		p->hotplug.sources[i] = NULL;
+	}
+
+	p->hotplug.source_count = 0;
+}
+
+xrt_result_t
+p_hotplug_handle(struct prober *p, uint64_t now_ns, xrt_prober_hotplug_func_t cb, void *ptr)
+{
+	XRT_TRACE_MARKER();
+
+	assert(cb != NULL);
+
+	if (p->list_locked) {
+		return XRT_ERROR_PROBER_LIST_LOCKED;
+	}
+
+	for (uint32_t i = 0; i < p->hotplug.source_count; i++) {
+		struct p_hotplug_source *src = p->hotplug.sources[i];
+		struct p_hotplug_event ev;
+
+		while (src->next_event(src, &ev)) {
+			if (ev.removed) {
+				apply_removed(p, &ev, cb, ptr);
+			} else {
+				apply_added(p, &ev, now_ns);
+			}
+		}
+	}
+
+	create_settled(p, now_ns, cb, ptr);
+
+	return XRT_SUCCESS;
+}
@@ -15,6 +15,41 @@
 #include <string.h>
 
 
+/*
+ *
+ * Structs
+ *
+ */
+
+#define P_LIBUSB_HOTPLUG_QUEUE_SIZE 16
+
+/*!
+ * Hotplug source using libusb's own hotplug callbacks, the devices are
+ * queued by the callback and handed out by @ref p_hotplug_source::next_event.
+ *
+ * @implements p_hotplug_source
+ */
+struct p_libusb_hotplug
+{
+	struct p_hotplug_source base;
+
+	struct prober *p;
+
+	libusb_hotplug_callback_handle handle;
+
+	struct
+	{
+		//! Referenced devices, unreferenced once handed out.
+		libusb_device *dev;
+		bool removed;
+	} queue[P_LIBUSB_HOTPLUG_QUEUE_SIZE];
+	uint32_t queue_count;
+
+	//! The device of the last event, unreferenced on the next call.
+	libusb_device *current;
+};
+
+
 int
 p_libusb_init(struct prober *p)
 {
@@ -87,13 +122,127 @@ p_libusb_probe(struct prober *p)
 		pdev->usb.num_ports = num;
 		memcpy(pdev->usb.ports, ports, sizeof(uint8_t) * num);
 
-		// Attach the libusb device to it.
-		pdev->usb.dev = device;
+		// Attach the libusb device to it, the prober owns a reference.
+		if (pdev->usb.dev != device) {
+			if (pdev->usb.dev != NULL) {
+				libusb_unref_device(pdev->usb.dev);
+			}
+			pdev->usb.dev = libusb_ref_device(device);
+		}
 	}
 
 	return 0;
 }
 
+static int LIBUSB_CALL
+p_libusb_hotplug_callback(libusb_context *ctx, libusb_device *device, libusb_hotplug_event event, void *user_data)
+{
+	struct p_libusb_hotplug *lh = (struct p_libusb_hotplug *)user_data;
+
+	if (lh->queue_count >= ARRAY_SIZE(lh->queue)) {
+		P_ERROR(lh->p, "Hotplug queue full, dropping event!");
+		return 0;
+	}
+
+	lh->queue[lh->queue_count].dev = libusb_ref_device(device);
+	lh->queue[lh->queue_count].removed = event == LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT;
+	lh->queue_count++;
+
+	// Keep the callback registered.
+	return 0;
+}
+
+static bool
+p_libusb_hotplug_next_event(struct p_hotplug_source *src, struct p_hotplug_event *out_event)
+{
+	struct p_libusb_hotplug *lh = (struct p_libusb_hotplug *)src;
+
+	if (lh->current != NULL) {
+		libusb_unref_device(lh->current);
+		lh->current = NULL;
+	}
+
+	// Dispatch without waiting, this is what calls the callback.
+	if (lh->queue_count == 0) {
+		struct timeval zero = {0};
+		libusb_handle_events_timeout_completed(lh->p->usb.ctx, &zero, NULL);
+	}
+
+	if (lh->queue_count == 0) {
+		return false;
+	}
+
+	libusb_device *device = lh->queue[0].dev;
+	bool removed = lh->queue[0].removed;
+	lh->queue_count--;
+	memmove(&lh->queue[0], &lh->queue[1], sizeof(lh->queue[0]) * lh->queue_count);
+	lh->current = device;
+
+	struct libusb_device_descriptor desc;
+	libusb_get_device_descriptor(device, &desc);
+
+	U_ZERO(out_event);
+	out_event->removed = removed;
+	out_event->type = P_HOTPLUG_TYPE_USB;
+	out_event->bus = XRT_BUS_TYPE_USB;
+	out_event->vendor_id = desc.idVendor;
+	out_event->product_id = desc.idProduct;
+	out_event->usb.bus = libusb_get_bus_number(device);
+	out_event->usb.addr = libusb_get_device_address(device);
+	out_event->usb.dev_class = desc.bDeviceClass;
+	out_event->usb.dev = device;
+
+	int num = libusb_get_port_numbers(device, out_event->usb.ports, ARRAY_SIZE(out_event->usb.ports));
+	out_event->usb.num_ports = num > 0 ? (uint32_t)num : 0;
+
+	return true;
+}
+
+static void
+p_libusb_hotplug_destroy(struct p_hotplug_source *src)
+{
+	struct p_libusb_hotplug *lh = (struct p_libusb_hotplug *)src;
+
+	libusb_hotplug_deregister_callback(lh->p->usb.ctx, lh->handle);
+
+	for (uint32_t i = 0; i < lh->queue_count; i++) {
+		libusb_unref_device(lh->queue[i].dev);
+	}
+
+	if (lh->current != NULL) {
+		libusb_unref_device(lh->current);
+	}
+
+	free(lh);
+}
+
+struct p_hotplug_source *
+p_libusb_hotplug_create(struct prober *p)
+{
+	if (p->usb.ctx == NULL || !libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) {
+		P_DEBUG(p, "libusb hotplug not supported");
+		return NULL;
+	}
+
+	struct p_libusb_hotplug *lh = U_TYPED_CALLOC(struct p_libusb_hotplug);
+	lh->base.next_event = p_libusb_hotplug_next_event;
+	lh->base.destroy = p_libusb_hotplug_destroy;
+	lh->p = p;
+
+	int events = LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT;
+	int ret = libusb_hotplug_register_callback(p->usb.ctx, (libusb_hotplug_event)events, LIBUSB_HOTPLUG_NO_FLAGS,
+	                                           LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
+	                                           LIBUSB_HOTPLUG_MATCH_ANY, p_libusb_hotplug_callback, lh,
+	                                           &lh->handle);
+	if (ret != LIBUSB_SUCCESS) {
+		P_ERROR(p, "libusb_hotplug_register_callback failed: %i", ret);
+		free(lh);
+		return NULL;
+	}
+
+	return &lh->base;
+}
+
 #define ENUM_TO_STR(r)                                                                                                 \
 	case r: return #r
 
@@ -19,6 +19,7 @@
 #include "util/u_trace_marker.h"
 
 #include "os/os_hid.h"
+#include "os/os_time.h"
 #include "p_prober.h"
 
 #ifdef XRT_HAVE_V4L2
@@ -132,6 +133,9 @@ p_find_interface(struct xrt_prober *xp,
 static bool
 p_can_open(struct xrt_prober *xp, struct xrt_prober_device *xpdev);
 
+static xrt_result_t
+p_handle_hotplug(struct xrt_prober *xp, xrt_prober_hotplug_func_t cb, void *ptr);
+
 static void
 p_destroy(struct xrt_prober **xp);
 
@@ -243,6 +247,112 @@ p_dev_get_bluetooth_dev(struct prober *p,
 	return 0;
 }
 
+void
+p_dev_fini(struct prober_device *pdev)
+{
+	if (pdev->usb.product != NULL) {
+		free((char *)pdev->usb.product);
+		pdev->usb.product = NULL;
+	}
+
+	if (pdev->usb.manufacturer != NULL) {
+		free((char *)pdev->usb.manufacturer);
+		pdev->usb.manufacturer = NULL;
+	}
+
+	if (pdev->usb.serial != NULL) {
+		free((char *)pdev->usb.serial);
+		pdev->usb.serial = NULL;
+	}
+
+	if (pdev->usb.path != NULL) {
+		free((char *)pdev->usb.path);
+		pdev->usb.path = NULL;
+	}
+
+#ifdef XRT_HAVE_LIBUSB
+	if (pdev->usb.dev != NULL) {
+		libusb_unref_device(pdev->usb.dev);
+		pdev->usb.dev = NULL;
+	}
+#endif
+
+#ifdef XRT_HAVE_LIBUVC
+	if (pdev->uvc.dev != NULL) {
+		//! @todo Free somewhere else
+	}
+#endif
+
+#ifdef XRT_HAVE_V4L2
+	for (size_t j = 0; j < pdev->num_v4ls; j++) {
+		struct prober_v4l *v4l = &pdev->v4ls[j];
+		free((char *)v4l->path);
+		v4l->path = NULL;
+	}
+
+	if (pdev->v4ls != NULL) {
+		free(pdev->v4ls);
+		pdev->v4ls = NULL;
+		pdev->num_v4ls = 0;
+	}
+#endif
+
+#ifdef XRT_OS_LINUX
+	for (size_t j = 0; j < pdev->num_hidraws; j++) {
+		struct prober_hidraw *hidraw = &pdev->hidraws[j];
+		free((char *)hidraw->path);
+		hidraw->path = NULL;
+	}
+
+	if (pdev->hidraws != NULL) {
+		free(pdev->hidraws);
+		pdev->hidraws = NULL;
+		pdev->num_hidraws = 0;
+	}
+#endif
+}
+
+bool
+p_driver_is_disabled(struct prober *p, const char *driver_name)
+{
+	for (size_t disabled = 0; disabled < p->num_disabled_drivers; disabled++) {
+		if (strcmp(driver_name, p->disabled_drivers[disabled]) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#ifdef XRT_OS_LINUX
+void
+p_dev_add_hidraw(struct prober_device *pdev, uint32_t interface, const char *path)
+{
+	U_ARRAY_REALLOC_OR_FREE(pdev->hidraws, struct prober_hidraw, (pdev->num_hidraws + 1));
+
+	struct prober_hidraw *hidraw = &pdev->hidraws[pdev->num_hidraws++];
+	U_ZERO(hidraw);
+
+	hidraw->interface = interface;
+	hidraw->path = strdup(path);
+}
+#endif
+
+#ifdef XRT_HAVE_V4L2
+void
+p_dev_add_v4l(struct prober_device *pdev, uint32_t v4l_index, uint32_t usb_iface, const char *path)
+{
+	U_ARRAY_REALLOC_OR_FREE(pdev->v4ls, struct prober_v4l, (pdev->num_v4ls + 1));
+
+	struct prober_v4l *v4l = &pdev->v4ls[pdev->num_v4ls++];
+	U_ZERO(v4l);
+
+	v4l->usb_iface = usb_iface;
+	v4l->v4l_index = v4l_index;
+	v4l->path = strdup(path);
+}
+#endif
+
 
 /*
  *
@@ -450,9 +560,11 @@ initialize(struct prober *p, struct xrt_prober_entry_lists *lists)
 	p->base.get_string_descriptor = p_get_string_descriptor;
 	p->base.find_interface = p_find_interface;
 	p->base.can_open = p_can_open;
+	p->base.handle_hotplug = p_handle_hotplug;
 	p->base.destroy = p_destroy;
 	p->lists = lists;
 	p->log_level = debug_get_log_option_prober_log();
+	p->hotplug.settle_ns = P_HOTPLUG_SETTLE_NS;
 
 	p->json.file_loaded = false;
 	p->json.root = NULL;
@@ -486,6 +598,9 @@ initialize(struct prober *p, struct xrt_prober_entry_lists *lists)
 	}
 #endif
 
+	// Started before any probing, so no device is missed in between.
+	p_hotplug_init(p);
+
 	ret = p_tracking_init(p);
 	if (ret != 0) {
 		teardown(p);
@@ -511,67 +626,7 @@ teardown_devices(struct prober *p)
 
 	// Need to free all devices.
 	for (size_t i = 0; i < p->device_count; i++) {
-		struct prober_device *pdev = &p->devices[i];
-
-		if (pdev->usb.product != NULL) {
-			free((char *)pdev->usb.product);
-			pdev->usb.product = NULL;
-		}
-
-		if (pdev->usb.manufacturer != NULL) {
-			free((char *)pdev->usb.manufacturer);
-			pdev->usb.manufacturer = NULL;
-		}
-
-		if (pdev->usb.serial != NULL) {
-			free((char *)pdev->usb.serial);
-			pdev->usb.serial = NULL;
-		}
-
-		if (pdev->usb.path != NULL) {
-			free((char *)pdev->usb.path);
-			pdev->usb.path = NULL;
-		}
-
-#ifdef XRT_HAVE_LIBUSB
-		if (pdev->usb.dev != NULL) {
-			//! @todo Free somewhere else
-		}
-#endif
-
-#ifdef XRT_HAVE_LIBUVC
-		if (pdev->uvc.dev != NULL) {
-			//! @todo Free somewhere else
-		}
-#endif
-
-#ifdef XRT_HAVE_V4L2
-		for (size_t j = 0; j < pdev->num_v4ls; j++) {
-			struct prober_v4l *v4l = &pdev->v4ls[j];
-			free((char *)v4l->path);
-			v4l->path = NULL;
-		}
-
-		if (pdev->v4ls != NULL) {
-			free(pdev->v4ls);
-			pdev->v4ls = NULL;
-			pdev->num_v4ls = 0;
-		}
-#endif
-
-#ifdef XRT_OS_LINUX
-		for (size_t j = 0; j < pdev->num_hidraws; j++) {
-			struct prober_hidraw *hidraw = &pdev->hidraws[j];
-			free((char *)hidraw->path);
-			hidraw->path = NULL;
-		}
-
-		if (pdev->hidraws != NULL) {
-			free(pdev->hidraws);
-			pdev->hidraws = NULL;
-			pdev->num_hidraws = 0;
-		}
-#endif
+		p_dev_fini(&p->devices[i]);
 	}
 
 	if (p->devices != NULL) {
@@ -613,6 +668,9 @@ teardown(struct prober *p)
 		p->num_entries = 0;
 	}
 
+	// Holds references to libusb devices.
+	p_hotplug_teardown(p);
+
 	teardown_devices(p);
 
 #ifdef XRT_HAVE_LIBUVC
@@ -682,15 +740,8 @@ add_from_devices(struct prober *p, struct xrt_device **xdevs, size_t xdev_count,
 				continue;
 			}
 
-			bool skip = false;
-			for (size_t disabled = 0; disabled < p->num_disabled_drivers; disabled++) {
-				if (strcmp(entry->driver_name, p->disabled_drivers[disabled]) == 0) {
-					P_INFO(p, "Skipping disabled driver %s", entry->driver_name);
-					skip = true;
-					break;
-				}
-			}
-			if (skip) {
+			if (p_driver_is_disabled(p, entry->driver_name)) {
+				P_INFO(p, "Skipping disabled driver %s", entry->driver_name);
 				continue;
 			}
 
@@ -725,15 +776,8 @@ add_from_auto_probers(struct prober *p, struct xrt_device **xdevs, size_t xdev_c
 {
 	for (int i = 0; i < XRT_MAX_AUTO_PROBERS && p->auto_probers[i]; i++) {
 
-		bool skip = false;
-		for (size_t disabled = 0; disabled < p->num_disabled_drivers; disabled++) {
-			if (strcmp(p->auto_probers[i]->name, p->disabled_drivers[disabled]) == 0) {
-				P_INFO(p, "Skipping disabled driver %s", p->auto_probers[i]->name);
-				skip = true;
-				break;
-			}
-		}
-		if (skip) {
+		if (p_driver_is_disabled(p, p->auto_probers[i]->name)) {
+			P_INFO(p, "Skipping disabled driver %s", p->auto_probers[i]->name);
 			continue;
 		}
 
@@ -1423,6 +1467,16 @@ p_can_open(struct xrt_prober *xp, struct xrt_prober_device *xpdev)
 	return false;
 }
 
+static xrt_result_t
+p_handle_hotplug(struct xrt_prober *xp, xrt_prober_hotplug_func_t cb, void *ptr)
+{
+	XRT_TRACE_MARKER();
+
+	struct prober *p = (struct prober *)xp;
+
+	return p_hotplug_handle(p, os_monotonic_get_ns(), cb, ptr);
+}
+
 static void
 p_destroy(struct xrt_prober **xp)
 {
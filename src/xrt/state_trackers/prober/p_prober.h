@@ -30,6 +30,10 @@
 #include <sys/types.h>
 #endif
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /*
  *
  * Struct and defines
@@ -38,6 +42,11 @@
 
 #define P_PROBER_BLUETOOTH_PRODUCT_COUNT 64
 
+#define P_HOTPLUG_MAX_SOURCES 4
+
+//! How long a plugged in device has to be quiet before given to the drivers.
+#define P_HOTPLUG_SETTLE_NS (200 * 1000 * 1000)
+
 #define P_TRACE(d, ...) U_LOG_IFL_T(d->log_level, __VA_ARGS__)
 #define P_DEBUG(d, ...) U_LOG_IFL_D(d->log_level, __VA_ARGS__)
 #define P_INFO(d, ...) U_LOG_IFL_I(d->log_level, __VA_ARGS__)
@@ -115,6 +124,89 @@ struct prober_device
 	size_t num_hidraws;
 	struct prober_hidraw *hidraws;
 #endif
+
+	struct
+	{
+		//! Added by a hotplug event, but not yet given to the drivers.
+		bool pending;
+
+		//! When the last hotplug event for this device was handled.
+		uint64_t last_event_ns;
+
+		//! Devices given out when it was added, not owned, handed back on removal.
+		struct xrt_device *xdevs[XRT_MAX_DEVICES_PER_PROBE];
+		size_t xdev_count;
+	} hotplug;
+};
+
+/*!
+ * What part of a device a @ref p_hotplug_event is about.
+ */
+enum p_hotplug_type
+{
+	P_HOTPLUG_TYPE_USB,
+	P_HOTPLUG_TYPE_HIDRAW,
+	P_HOTPLUG_TYPE_V4L,
+};
+
+/*!
+ * A single device or interface being added or removed, the strings are owned
+ * by the @ref p_hotplug_source and only valid until it is called again.
+ *
+ * Removal events only need the fields that identify what was removed: the
+ * address for USB devices and the path for interfaces.
+ */
+struct p_hotplug_event
+{
+	bool removed;
+	enum p_hotplug_type type;
+
+	enum xrt_bus_type bus;
+	uint16_t vendor_id;
+	uint16_t product_id;
+
+	struct
+	{
+		uint16_t bus;
+		uint16_t addr;
+		uint8_t dev_class;
+
+		const char *product;
+		const char *manufacturer;
+		const char *serial;
+
+		uint8_t ports[8];
+		uint32_t num_ports;
+
+#ifdef XRT_HAVE_LIBUSB
+		//! The prober takes its own reference.
+		libusb_device *dev;
+#endif
+	} usb;
+
+	struct
+	{
+		uint64_t id;
+		const char *product;
+	} bluetooth;
+
+	//! Device node of the USB device or the interface.
+	const char *path;
+
+	uint32_t interface;
+	uint32_t v4l_index;
+};
+
+/*!
+ * Something that reports devices being plugged in or removed, like a udev
+ * monitor. Must not block.
+ */
+struct p_hotplug_source
+{
+	//! Returns the next pending event, false if there are none.
+	bool (*next_event)(struct p_hotplug_source *src, struct p_hotplug_event *out_event);
+
+	void (*destroy)(struct p_hotplug_source *src);
 };
 
 /*!
@@ -162,6 +254,15 @@ struct prober
 #endif
 
 
+	struct
+	{
+		struct p_hotplug_source *sources[P_HOTPLUG_MAX_SOURCES];
+		uint32_t source_count;
+
+		//! @see P_HOTPLUG_SETTLE_NS
+		uint64_t settle_ns;
+	} hotplug;
+
 	struct xrt_auto_prober *auto_probers[XRT_MAX_AUTO_PROBERS];
 
 	size_t device_count;
@@ -218,6 +319,83 @@ p_dev_get_bluetooth_dev(struct prober *p,
                         const char *product_name,
                         struct prober_device **out_pdev);
 
+/*!
+ * Free everything the device holds, does not remove it from the list.
+ *
+ * @public @memberof prober
+ */
+void
+p_dev_fini(struct prober_device *pdev);
+
+/*!
+ * Is the named driver disabled by the config or a conflicting driver.
+ *
+ * @public @memberof prober
+ */
+bool
+p_driver_is_disabled(struct prober *p, const char *driver_name);
+
+#ifdef XRT_OS_LINUX
+/*!
+ * Add a hidraw interface to the device, copies the path.
+ *
+ * @public @memberof prober
+ */
+void
+p_dev_add_hidraw(struct prober_device *pdev, uint32_t interface, const char *path);
+#endif
+
+#ifdef XRT_HAVE_V4L2
+/*!
+ * Add a v4l interface to the device, copies the path.
+ *
+ * @public @memberof prober
+ */
+void
+p_dev_add_v4l(struct prober_device *pdev, uint32_t v4l_index, uint32_t usb_iface, const char *path);
+#endif
+
+/*!
+ * @name Hotplug
+ * @{
+ */
+/*!
+ * Create the hotplug sources that are available on this system.
+ *
+ * @private @memberof prober
+ */
+void
+p_hotplug_init(struct prober *p);
+
+/*!
+ * Add a source, ownership is transferred to the prober.
+ *
+ * @private @memberof prober
+ */
+void
+p_hotplug_add_source(struct prober *p, struct p_hotplug_source *src);
+
+/*!
+ * Destroy all hotplug sources.
+ *
+ * @private @memberof prober
+ */
+void
+p_hotplug_teardown(struct prober *p);
+
+/*!
+ * Apply all pending events to the device list, then give the devices that
+ * have settled to the drivers.
+ *
+ * @private @memberof prober
+ * @see xrt_prober::handle_hotplug
+ */
+xrt_result_t
+p_hotplug_handle(struct prober *p, uint64_t now_ns, xrt_prober_hotplug_func_t cb, void *ptr);
+/*!
+ * @}
+ */
+
 /*!
  * @name Tracking systems
  * @{
@@ -293,6 +471,14 @@ p_libusb_find_interface(struct prober *p,
 bool
 p_libusb_can_open(struct prober *p, struct prober_device *pdev);
 
+/*!
+ * Create a source for libusb hotplug events, NULL if not supported.
+ *
+ * @private @memberof prober
+ */
+struct p_hotplug_source *
+p_libusb_hotplug_create(struct prober *p);
+
 /*!
  * @}
  */
@@ -336,7 +522,19 @@ p_libuvc_probe(struct prober *p);
  */
 int
 p_udev_probe(struct prober *p);
+
+/*!
+ * Create a source for udev monitor events, NULL on failure.
+ *
+ * @private @memberof prober
+ */
+struct p_hotplug_source *
+p_udev_hotplug_create(struct prober *p);
 /*!
  * @}
  */
 #endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -29,6 +29,33 @@
 #define HIDRAW_BUS_I2C_MAYBE_QUESTION_MARK 24
 
 
+/*
+ *
+ * Structs
+ *
+ */
+
+/*!
+ * Hotplug source reading from a udev monitor.
+ *
+ * @implements p_hotplug_source
+ */
+struct p_udev_hotplug
+{
+	struct p_hotplug_source base;
+
+	struct prober *p;
+
+	struct udev *udev;
+	struct udev_monitor *monitor;
+
+	//! The device of the last event, keeps the strings of that event alive.
+	struct udev_device *current;
+
+	char product_name[P_PROBER_BLUETOOTH_PRODUCT_COUNT];
+};
+
+
 /*
  *
  * Pre-declare functions.
@@ -49,15 +76,9 @@ p_udev_add_usb(struct prober_device *pdev,
 static void
 p_udev_enumerate_v4l2(struct prober *p, struct udev *udev);
 
-static void
-p_udev_add_v4l(struct prober_device *pdev, uint32_t v4l_index, uint32_t usb_iface, const char *path);
-
 static void
 p_udev_enumerate_hidraw(struct prober *p, struct udev *udev);
 
-static void
-p_udev_add_hidraw(struct prober_device *pdev, uint32_t interface, const char *path);
-
 static int
 p_udev_get_interface_number(struct udev_device *raw_dev, uint16_t *interface_number);
 
@@ -111,6 +132,12 @@ p_udev_get_sysattr_u32_base10(struct udev_device *dev, const char *name, uint32_
 XRT_MAYBE_UNUSED static void
 p_udev_dump_device(struct udev_device *udev_dev, const char *name);
 
+static bool
+p_udev_hotplug_next_event(struct p_hotplug_source *src, struct p_hotplug_event *out_event);
+
+static void
+p_udev_hotplug_destroy(struct p_hotplug_source *src);
+
 
 /*
  *
@@ -138,6 +165,44 @@ p_udev_probe(struct prober *p)
 	return 0;
 }
 
+struct p_hotplug_source *
+p_udev_hotplug_create(struct prober *p)
+{
+	struct udev *udev = udev_new();
+	if (!udev) {
+		P_ERROR(p, "Can't create udev");
+		return NULL;
+	}
+
+	struct udev_monitor *monitor = udev_monitor_new_from_netlink(udev, "udev");
+	if (monitor == NULL) {
+		P_ERROR(p, "Can't create udev monitor");
+		udev_unref(udev);
+		return NULL;
+	}
+
+	udev_monitor_filter_add_match_subsystem_devtype(monitor, "usb", "usb_device");
+	udev_monitor_filter_add_match_subsystem_devtype(monitor, "hidraw", NULL);
+	udev_monitor_filter_add_match_subsystem_devtype(monitor, "video4linux", NULL);
+
+	// The socket is non-blocking, so receiving never waits.
+	if (udev_monitor_enable_receiving(monitor) < 0) {
+		P_ERROR(p, "Can't enable receiving on udev monitor");
+		udev_monitor_unref(monitor);
+		udev_unref(udev);
+		return NULL;
+	}
+
+	struct p_udev_hotplug *uh = U_TYPED_CALLOC(struct p_udev_hotplug);
+	uh->base.next_event = p_udev_hotplug_next_event;
+	uh->base.destroy = p_udev_hotplug_destroy;
+	uh->p = p;
+	uh->udev = udev;
+	uh->monitor = monitor;
+
+	return &uh->base;
+}
+
 
 /*
  *
@@ -345,8 +410,10 @@ p_udev_enumerate_v4l2(struct prober *p, struct udev *udev)
 			goto next;
 		}
 
+#ifdef XRT_HAVE_V4L2
 		// Add this interface to the usb device.
-		p_udev_add_v4l(pdev, v4l_index, usb_iface, dev_path);
+		p_dev_add_v4l(pdev, v4l_index, usb_iface, dev_path);
+#endif
 
 	next:
 		udev_device_unref(raw_dev);
@@ -355,21 +422,6 @@ p_udev_enumerate_v4l2(struct prober *p, struct udev *udev)
 	udev_enumerate_unref(enumerate);
 }
 
-static void
-p_udev_add_v4l(struct prober_device *pdev, uint32_t v4l_index, uint32_t usb_iface, const char *path)
-{
-#ifdef XRT_HAVE_V4L2
-	U_ARRAY_REALLOC_OR_FREE(pdev->v4ls, struct prober_v4l, (pdev->num_v4ls + 1));
-
-	struct prober_v4l *v4l = &pdev->v4ls[pdev->num_v4ls++];
-	U_ZERO(v4l);
-
-	v4l->usb_iface = usb_iface;
-	v4l->v4l_index = v4l_index;
-	v4l->path = strdup(path);
-#endif
-}
-
 static void
 p_udev_enumerate_hidraw(struct prober *p, struct udev *udev)
 {
@@ -474,7 +526,7 @@ p_udev_enumerate_hidraw(struct prober *p, struct udev *udev)
 		}
 
 		// Add this interface to the usb device.
-		p_udev_add_hidraw(pdev, interface, dev_path);
+		p_dev_add_hidraw(pdev, interface, dev_path);
 
 	next:
 		udev_device_unref(raw_dev);
@@ -483,18 +535,6 @@ p_udev_enumerate_hidraw(struct prober *p, struct udev *udev)
 	udev_enumerate_unref(enumerate);
 }
 
-static void
-p_udev_add_hidraw(struct prober_device *pdev, uint32_t interface, const char *path)
-{
-	U_ARRAY_REALLOC_OR_FREE(pdev->hidraws, struct prober_hidraw, (pdev->num_hidraws + 1));
-
-	struct prober_hidraw *hidraw = &pdev->hidraws[pdev->num_hidraws++];
-	U_ZERO(hidraw);
-
-	hidraw->interface = interface;
-	hidraw->path = strdup(path);
-}
-
 static int
 p_udev_get_usb_hid_address(struct udev_device *raw_dev,
                            uint32_t bus_type,
@@ -828,3 +868,197 @@ p_udev_dump_device(struct udev_device *udev_dev, const char *name)
 	U_LOG_I("\t\tsubsystem: %s", udev_device_get_subsystem(udev_dev));
 	U_LOG_I("\t\tsysfs.product: %s", udev_device_get_sysattr_value(udev_dev, "product"));
 }
+
+static bool
+p_udev_hotplug_fill_usb(struct p_udev_hotplug *uh, struct udev_device *raw_dev, struct p_hotplug_event *ev)
+{
+	struct prober *p = uh->p;
+	int ret;
+
+	ev->type = P_HOTPLUG_TYPE_USB;
+	ev->bus = XRT_BUS_TYPE_USB;
+
+	// Only the device node is left when removed, it has the address.
+	if (ev->removed) {
+		return p_udev_get_usb_device_address_path(raw_dev, &ev->usb.bus, &ev->usb.addr) == 0;
+	}
+
+	ret = p_udev_get_usb_device_info(raw_dev, &ev->usb.dev_class, &ev->vendor_id, &ev->product_id, &ev->usb.bus,
+	                                 &ev->usb.addr);
+	if (ret != 0) {
+		P_ERROR(p, "Failed to get usb device info");
+		return false;
+	}
+
+	ev->usb.serial = udev_device_get_sysattr_value(raw_dev, "serial");
+	ev->usb.product = udev_device_get_sysattr_value(raw_dev, "product");
+	ev->usb.manufacturer = udev_device_get_sysattr_value(raw_dev, "manufacturer");
+
+	return true;
+}
+
+static bool
+p_udev_hotplug_fill_v4l(struct p_udev_hotplug *uh, struct udev_device *raw_dev, struct p_hotplug_event *ev)
+{
+	struct prober *p = uh->p;
+	struct udev_device *usb_device = NULL;
+	uint16_t usb_iface = 0;
+	int ret;
+
+	ev->type = P_HOTPLUG_TYPE_V4L;
+	ev->bus = XRT_BUS_TYPE_USB;
+
+	// Interfaces are found by their path when removed.
+	if (ev->removed) {
+		return true;
+	}
+
+	ret = p_udev_try_usb_relation_get_address(raw_dev, &ev->usb.dev_class, &ev->vendor_id, &ev->product_id,
+	                                          &ev->usb.bus, &ev->usb.addr, &usb_device);
+	if (ret != 0) {
+		P_DEBUG(p, "skipping non-usb v4l device '%s'", ev->path);
+		return false;
+	}
+
+	ret = p_udev_get_interface_number(raw_dev, &usb_iface);
+	if (ret != 0) {
+		P_ERROR(p, "Failed to get interface number for '%s'", ev->path);
+		return false;
+	}
+
+	ret = p_udev_get_sysattr_u32_base10(raw_dev, "index", &ev->v4l_index);
+	if (ret != 0) {
+		P_ERROR(p, "Failed to get v4l index.");
+		return false;
+	}
+
+	ev->interface = usb_iface;
+	ev->usb.serial = udev_device_get_sysattr_value(usb_device, "serial");
+	ev->usb.product = udev_device_get_sysattr_value(usb_device, "product");
+	ev->usb.manufacturer = udev_device_get_sysattr_value(usb_device, "manufacturer");
+
+	return true;
+}
+
+static bool
+p_udev_hotplug_fill_hidraw(struct p_udev_hotplug *uh, struct udev_device *raw_dev, struct p_hotplug_event *ev)
+{
+	struct prober *p = uh->p;
+	uint32_t bus_type = 0;
+	uint16_t interface = 0;
+	int ret;
+
+	ev->type = P_HOTPLUG_TYPE_HIDRAW;
+
+	// Interfaces are found by their path when removed.
+	if (ev->removed) {
+		return true;
+	}
+
+	ret = p_udev_get_and_parse_uevent(raw_dev, &bus_type, &ev->vendor_id, &ev->product_id, &uh->product_name,
+	                                  &ev->bluetooth.id);
+	if (ret != 0) {
+		P_ERROR(p, "Failed to get uevent info from device");
+		return false;
+	}
+
+	switch (bus_type) {
+	case HIDRAW_BUS_USB: ev->bus = XRT_BUS_TYPE_USB; break;
+	case HIDRAW_BUS_BLUETOOTH: ev->bus = XRT_BUS_TYPE_BLUETOOTH; break;
+	case HIDRAW_BUS_I2C_MAYBE_QUESTION_MARK: return false;
+	default: P_ERROR(p, "Unknown hidraw bus_type: '%i', ignoring.", bus_type); return false;
+	}
+
+	ret = p_udev_get_usb_hid_address(raw_dev, bus_type, &ev->usb.dev_class, &ev->usb.bus, &ev->usb.addr);
+	if (ret != 0) {
+		P_ERROR(p, "Failed to get USB bus and addr.");
+		return false;
+	}
+
+	ret = p_udev_get_interface_number(raw_dev, &interface);
+	if (ret != 0) {
+		P_ERROR(p, "Failed to get interface number for '%s'", ev->path);
+		return false;
+	}
+
+	ev->interface = interface;
+	ev->bluetooth.product = uh->product_name;
+
+	return true;
+}
+
+static bool
+p_udev_hotplug_fill_event(struct p_udev_hotplug *uh, struct udev_device *raw_dev, struct p_hotplug_event *ev)
+{
+	const char *action = udev_device_get_action(raw_dev);
+	const char *subsystem = udev_device_get_subsystem(raw_dev);
+	const char *dev_path = udev_device_get_devnode(raw_dev);
+
+	if (action == NULL || subsystem == NULL || dev_path == NULL) {
+		return false;
+	}
+
+	U_ZERO(ev);
+	ev->path = dev_path;
+
+	// Bind, change and the like does not change what the prober knows.
+	if (strcmp(action, "add") == 0) {
+		ev->removed = false;
+	} else if (strcmp(action, "remove") == 0) {
+		ev->removed = true;
+	} else {
+		return false;
+	}
+
+	P_TRACE(uh->p, "udev %s %s '%s'", action, subsystem, dev_path);
+
+	if (strcmp(subsystem, "usb") == 0) {
+		return p_udev_hotplug_fill_usb(uh, raw_dev, ev);
+	}
+	if (strcmp(subsystem, "video4linux") == 0) {
+		return p_udev_hotplug_fill_v4l(uh, raw_dev, ev);
+	}
+	if (strcmp(subsystem, "hidraw") == 0) {
+		return p_udev_hotplug_fill_hidraw(uh, raw_dev, ev);
+	}
+
+	return false;
+}
+
+static bool
+p_udev_hotplug_next_event(struct p_hotplug_source *src, struct p_hotplug_event *out_event)
+{
+	struct p_udev_hotplug *uh = (struct p_udev_hotplug *)src;
+
+	while (true) {
+		if (uh->current != NULL) {
+			udev_device_unref(uh->current);
+			uh->current = NULL;
+		}
+
+		// Returns NULL straight away if there is nothing to receive.
+		uh->current = udev_monitor_receive_device(uh->monitor);
+		if (uh->current == NULL) {
+			return false;
+		}
+
+		if (p_udev_hotplug_fill_event(uh, uh->current, out_event)) {
+			return true;
+		}
+	}
+}
+
+static void
+p_udev_hotplug_destroy(struct p_hotplug_source *src)
+{
+	struct p_udev_hotplug *uh = (struct p_udev_hotplug *)src;
+
+	if (uh->current != NULL) {
+		udev_device_unref(uh->current);
+		uh->current = NULL;
+	}
+
+	udev_monitor_unref(uh->monitor);
+	udev_unref(uh->udev);
+	free(uh);
+}
@@ -0,0 +1,151 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Common things for the microbenchmarks.
+ * @author agent <agent@local>
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_config_build.h"
+#include "xrt/xrt_config_drivers.h"
+#include "xrt/xrt_config_have.h"
+#include "xrt/xrt_config_os.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * A single microbenchmark, @p run is called with a growing number of
+ * iterations until one call takes long enough to be timed reliably.
+ */
+struct bench_case
+{
+	//! Name, as "group/name", used for filtering and the baseline.
+	const char *name;
+
+	//! Create what is needed for @p run, returns NULL on failure.
+	void *(*setup)(void);
+
+	//! Do the thing being measured @p iterations times.
+	void (*run)(void *ctx, uint64_t iterations);
+
+	//! Free what was created by @p setup.
+	void (*teardown)(void *ctx);
+};
+
+/*!
+ * How samples are taken.
+ */
+struct bench_config
+{
+	//! Run for at least this long before starting to take samples.
+	uint64_t warmup_ns;
+
+	//! Each sample is made to take at least this long.
+	uint64_t sample_ns;
+
+	//! Stop early once the 95% confidence interval of the median is within this fraction of it.
+	double precision;
+
+	uint32_t min_samples;
+	uint32_t max_samples;
+
+	//! Stop taking samples after this, unless less than @p min_samples have been taken.
+	uint64_t max_time_ns;
+};
+
+/*!
+ * Results for one benchmark, all times are per iteration.
+ */
+struct bench_stats
+{
+	uint64_t iterations_per_sample;
+	uint32_t sample_count;
+
+	double median_ns;
+	double mean_ns;
+	double stddev_ns;
+	//! Median absolute deviation.
+	double mad_ns;
+	double min_ns;
+	double max_ns;
+
+	//! 95% confidence interval of the median.
+	double ci_low_ns;
+	double ci_high_ns;
+
+	//! Samples outside of 1.5 times the interquartile range.
+	uint32_t outlier_count;
+};
+
+/*!
+ * Run a single benchmark, returns false if the setup failed.
+ */
+bool
+bench_run_case(const struct bench_config *config, const struct bench_case *bc, struct bench_stats *out_stats);
+
+/*!
+ * Compute the statistics from the per iteration times, sorts @p samples.
+ */
+void
+bench_compute_stats(double *samples, uint32_t sample_count, struct bench_stats *out_stats);
+
+
+/*!
+ * Sort samples in ascending order.
+ */
+void
+bench_sort_samples(double *samples, uint32_t sample_count);
+
+/*!
+ * Linearly interpolated percentile, @p p in [0, 1], of already sorted samples.
+ */
+double
+bench_percentile_sorted(const double *sorted, uint32_t count, double p);
+
+
+/*
+ *
+ * Benchmarks, all lists end with an entry with a NULL name.
+ *
+ */
+
+extern const struct bench_case bench_math_cases[];
+extern const struct bench_case bench_util_cases[];
+
+#ifdef XRT_FEATURE_OPENXR
+extern const struct bench_case bench_oxr_cases[];
+#endif
+
+#if defined(XRT_MODULE_COMPOSITOR) && defined(XRT_HAVE_VULKAN)
+extern const struct bench_case bench_comp_vk_cases[];
+#endif
+
+#if defined(XRT_FEATURE_SERVICE) && !defined(XRT_OS_WINDOWS)
+extern const struct bench_case bench_ipc_cases[];
+#endif
+
+#if defined(XRT_HAVE_OPENGL) && defined(XRT_HAVE_EGL)
+extern const struct bench_case bench_gui_ogl_cases[];
+#endif
+
+#ifdef XRT_BUILD_DRIVER_REMOTE
+extern const struct bench_case bench_remote_cases[];
+#endif
+
+#ifdef XRT_BUILD_DRIVER_VIVE
+extern const struct bench_case bench_vive_cases[];
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
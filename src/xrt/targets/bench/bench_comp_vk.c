@@ -0,0 +1,332 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Microbenchmarks for the Vulkan client compositor, a frame loop
+ *         against the mock native compositor.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_gfx_vk.h"
+#include "util/u_handles.h"
+#include "util/u_misc.h"
+#include "util/u_string_list.h"
+#include "util/comp_vulkan.h"
+#include "vk/vk_helpers.h"
+#include "vk/vk_image_allocator.h"
+#include "mock/mock_compositor.h"
+
+#include "bench_common.h"
+
+#include <stdlib.h>
+
+
+//! A projection layer per eye, a quad and a cylinder.
+#define LAYER_COUNT 4
+
+
+/*
+ *
+ * Vulkan setup.
+ *
+ */
+
+static const char *instance_extensions[] = {
+    VK_KHR_EXTERNAL_FENCE_CAPABILITIES_EXTENSION_NAME,      //
+    VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME,     //
+    VK_KHR_EXTERNAL_SEMAPHORE_CAPABILITIES_EXTENSION_NAME,  //
+    VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, //
+};
+
+static const char *required_device_extensions[] = {
+    VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME,      //
+    VK_KHR_EXTERNAL_FENCE_EXTENSION_NAME,            //
+    VK_KHR_EXTERNAL_MEMORY_EXTENSION_NAME,           //
+    VK_KHR_EXTERNAL_SEMAPHORE_EXTENSION_NAME,        //
+    VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME, //
+
+// Platform version of "external_memory"
+#if defined(XRT_GRAPHICS_BUFFER_HANDLE_IS_FD)
+    VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME,
+
+#elif defined(XRT_GRAPHICS_BUFFER_HANDLE_IS_XPC)
+    // TODO?
+
+#elif defined(XRT_GRAPHICS_BUFFER_HANDLE_IS_AHARDWAREBUFFER)
+    VK_ANDROID_EXTERNAL_MEMORY_ANDROID_HARDWARE_BUFFER_EXTENSION_NAME,
+
+#elif defined(XRT_GRAPHICS_BUFFER_HANDLE_IS_WIN32_HANDLE)
+    VK_KHR_EXTERNAL_MEMORY_WIN32_EXTENSION_NAME,
+
+#else
+#error "Need port!"
+#endif
+
+// Platform version of "external_fence" and "external_semaphore"
+#if defined(XRT_GRAPHICS_SYNC_HANDLE_IS_FD) // Optional
+
+#elif defined(XRT_GRAPHICS_BUFFER_HANDLE_IS_XPC)
+    // TODO?
+
+#elif defined(XRT_GRAPHICS_SYNC_HANDLE_IS_WIN32_HANDLE)
+    VK_KHR_EXTERNAL_SEMAPHORE_WIN32_EXTENSION_NAME, //
+    VK_KHR_EXTERNAL_FENCE_WIN32_EXTENSION_NAME,     //
+
+#else
+#error "Need port!"
+#endif
+};
+
+static const char *optional_device_extensions[] = {
+// Platform version of "external_fence" and "external_semaphore"
+#if defined(XRT_GRAPHICS_SYNC_HANDLE_IS_FD)      // Optional
+    VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME, //
+    VK_KHR_EXTERNAL_FENCE_FD_EXTENSION_NAME,     //
+#endif
+
+#ifdef VK_KHR_image_format_list
+    VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME,
+#endif
+};
+
+static bool
+init_vk(struct vk_bundle *vk)
+{
+	struct u_string_list *required_instance_ext_list =
+	    u_string_list_create_from_array(instance_extensions, ARRAY_SIZE(instance_extensions));
+	struct u_string_list *optional_instance_ext_list = u_string_list_create();
+	struct u_string_list *required_device_ext_list =
+	    u_string_list_create_from_array(required_device_extensions, ARRAY_SIZE(required_device_extensions));
+	struct u_string_list *optional_device_ext_list =
+	    u_string_list_create_from_array(optional_device_extensions, ARRAY_SIZE(optional_device_extensions));
+
+	struct comp_vulkan_arguments vk_args = {
+	    .get_instance_proc_address = vkGetInstanceProcAddr,
+	    .required_instance_version = VK_MAKE_VERSION(1, 0, 0),
+	    .required_instance_extensions = required_instance_ext_list,
+	    .optional_instance_extensions = optional_instance_ext_list,
+	    .required_device_extensions = required_device_ext_list,
+	    .optional_device_extensions = optional_device_ext_list,
+	    .log_level = U_LOGGING_WARN,
+	    .only_compute_queue = false, // Regular GFX
+	    .selected_gpu_index = -1,    // Auto
+	    .client_gpu_index = -1,      // Auto
+	    .timeline_semaphore = true,  // Flag is optional, not a hard requirement.
+	};
+
+	struct comp_vulkan_results vk_res = {0};
+	bool ret = comp_vulkan_init_bundle(vk, &vk_args, &vk_res);
+
+	u_string_list_destroy(&required_instance_ext_list);
+	u_string_list_destroy(&optional_instance_ext_list);
+	u_string_list_destroy(&required_device_ext_list);
+	u_string_list_destroy(&optional_device_ext_list);
+
+	return ret;
+}
+
+static void
+fini_vk(struct vk_bundle *vk)
+{
+	if (vk->device != VK_NULL_HANDLE) {
+		vk->vkDestroyDevice(vk->device, NULL);
+		vk->device = VK_NULL_HANDLE;
+	}
+
+	vk_deinit_mutex(vk);
+
+	if (vk->instance != VK_NULL_HANDLE) {
+		vk->vkDestroyInstance(vk->instance, NULL);
+		vk->instance = VK_NULL_HANDLE;
+	}
+}
+
+
+/*
+ *
+ * Client compositor frame loop.
+ *
+ */
+
+struct client_vk_ctx
+{
+	struct vk_bundle vk;
+	struct xrt_compositor_native *xcn;
+	struct xrt_compositor_vk *xcvk;
+
+	//! Real exportable images backing the mock swapchains.
+	struct vk_image_collection collections[LAYER_COUNT];
+	uint32_t collection_count;
+
+	struct xrt_swapchain *xscs[LAYER_COUNT];
+};
+
+static xrt_result_t
+mock_create_swapchain(struct mock_compositor *mc,
+                      struct mock_compositor_swapchain *mcsc,
+                      const struct xrt_swapchain_create_info *info,
+                      struct xrt_swapchain **out_xsc)
+{
+	struct client_vk_ctx *ctx = (struct client_vk_ctx *)mc->userdata;
+	struct vk_bundle *vk = &ctx->vk;
+	uint32_t image_count = mcsc->base.base.image_count;
+
+	if (ctx->collection_count >= ARRAY_SIZE(ctx->collections)) {
+		return XRT_ERROR_ALLOCATION;
+	}
+
+	struct vk_image_collection *vkic = &ctx->collections[ctx->collection_count];
+	if (vk_ic_allocate(vk, info, image_count, vkic) != VK_SUCCESS) {
+		return XRT_ERROR_VULKAN;
+	}
+
+	xrt_graphics_buffer_handle_t handles[XRT_MAX_SWAPCHAIN_IMAGES];
+	if (vk_ic_get_handles(vk, vkic, image_count, handles) != VK_SUCCESS) {
+		vk_ic_destroy(vk, vkic);
+		return XRT_ERROR_VULKAN;
+	}
+
+	for (uint32_t i = 0; i < image_count; i++) {
+		mcsc->base.images[i].handle = handles[i];
+		mcsc->base.images[i].size = vkic->images[i].size;
+		mcsc->base.images[i].use_dedicated_allocation = vkic->images[i].use_dedicated_allocation;
+	}
+
+	ctx->collection_count++;
+
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+mock_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handle_t sync_handle)
+{
+	u_graphics_sync_unref(&sync_handle);
+	return XRT_SUCCESS;
+}
+
+static void
+client_vk_teardown(void *ptr)
+{
+	struct client_vk_ctx *ctx = (struct client_vk_ctx *)ptr;
+	struct vk_bundle *vk = &ctx->vk;
+
+	for (uint32_t i = 0; i < LAYER_COUNT; i++) {
+		xrt_swapchain_reference(&ctx->xscs[i], NULL);
+	}
+
+	if (ctx->xcvk != NULL) {
+		struct xrt_compositor *xc = &ctx->xcvk->base;
+		xrt_comp_destroy(&xc);
+	}
+
+	if (vk->device != VK_NULL_HANDLE) {
+		vk->vkDeviceWaitIdle(vk->device);
+	}
+
+	for (uint32_t i = 0; i < ctx->collection_count; i++) {
+		vk_ic_destroy(vk, &ctx->collections[i]);
+	}
+
+	fini_vk(vk);
+	xrt_comp_native_destroy(&ctx->xcn);
+
+	free(ctx);
+}
+
+static void *
+client_vk_setup(void)
+{
+	struct client_vk_ctx *ctx = U_TYPED_CALLOC(struct client_vk_ctx);
+	struct vk_bundle *vk = &ctx->vk;
+
+	ctx->xcn = mock_create_native_compositor();
+
+	struct mock_compositor *mc = (struct mock_compositor *)ctx->xcn;
+	mc->userdata = ctx;
+	mc->compositor_hooks.create_swapchain = mock_create_swapchain;
+	ctx->xcn->base.layer_commit = mock_layer_commit;
+
+	if (!init_vk(vk)) {
+		client_vk_teardown(ctx);
+		return NULL;
+	}
+
+	ctx->xcvk = xrt_gfx_vk_provider_create( //
+	    ctx->xcn,                           //
+	    vk->instance,                       //
+	    vkGetInstanceProcAddr,              //
+	    vk->physical_device,                //
+	    vk->device,                         //
+#if defined(XRT_GRAPHICS_SYNC_HANDLE_IS_FD)
+	    vk->external.fence_sync_fd,              //
+	    vk->external.binary_semaphore_sync_fd,   //
+	    vk->external.timeline_semaphore_sync_fd, //
+#elif defined(XRT_GRAPHICS_SYNC_HANDLE_IS_WIN32_HANDLE)
+	    vk->external.fence_win32_handle,              //
+	    vk->external.binary_semaphore_win32_handle,   //
+	    vk->external.timeline_semaphore_win32_handle, //
+#else
+	    false, false, false, // TODO
+#endif
+	    false,                         // fragment_shading_rate_enabled
+	    vk->has_KHR_image_format_list, // image_format_list_enabled
+	    vk->queue_family_index,        //
+	    vk->queue_index);              //
+	if (ctx->xcvk == NULL) {
+		client_vk_teardown(ctx);
+		return NULL;
+	}
+
+	struct xrt_swapchain_create_info xsci = {
+	    .bits = XRT_SWAPCHAIN_USAGE_COLOR | XRT_SWAPCHAIN_USAGE_SAMPLED,
+	    .format = VK_FORMAT_R8G8B8A8_UNORM,
+	    .sample_count = 1,
+	    .width = 256,
+	    .height = 256,
+	    .face_count = 1,
+	    .array_size = 1,
+	    .mip_count = 1,
+	};
+
+	for (uint32_t i = 0; i < LAYER_COUNT; i++) {
+		if (xrt_comp_create_swapchain(&ctx->xcvk->base, &xsci, &ctx->xscs[i]) != XRT_SUCCESS) {
+			client_vk_teardown(ctx);
+			return NULL;
+		}
+	}
+
+	return ctx;
+}
+
+static void
+client_vk_frame_run(void *ptr, uint64_t iterations)
+{
+	struct client_vk_ctx *ctx = (struct client_vk_ctx *)ptr;
+
+	for (uint64_t n = 0; n < iterations; n++) {
+		for (uint32_t i = 0; i < LAYER_COUNT; i++) {
+			struct xrt_swapchain *xsc = ctx->xscs[i];
+			uint32_t index = 0;
+
+			xrt_swapchain_acquire_image(xsc, &index);
+			xrt_swapchain_barrier_image(xsc, XRT_BARRIER_TO_APP, index);
+			xrt_swapchain_wait_image(xsc, XRT_INFINITE_DURATION, index);
+			xrt_swapchain_barrier_image(xsc, XRT_BARRIER_TO_COMP, index);
+			xrt_swapchain_release_image(xsc, index);
+		}
+
+		xrt_comp_layer_commit(&ctx->xcvk->base, XRT_GRAPHICS_SYNC_HANDLE_INVALID);
+	}
+}
+
+
+/*
+ *
+ * 'Exported' list.
+ *
+ */
+
+const struct bench_case bench_comp_vk_cases[] = {
+    {"comp/client_vk_frame_4_layers", client_vk_setup, client_vk_frame_run, client_vk_teardown},
+    {NULL, NULL, NULL, NULL},
+};
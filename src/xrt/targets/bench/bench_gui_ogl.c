@@ -0,0 +1,216 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Microbenchmarks for the GUI texture sink, on a headless EGL context.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_frame.h"
+#include "util/u_frame.h"
+#include "util/u_misc.h"
+#include "ogl/ogl_api.h"
+#include "gui/gui_common.h"
+
+#define EGL_NO_X11              // libglvnd
+#define MESA_EGL_NO_X11_HEADERS // mesa
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "bench_common.h"
+
+#include <stdlib.h>
+
+
+//! A typical tracking camera frame.
+#define FRAME_WIDTH 1280
+#define FRAME_HEIGHT 800
+
+
+struct gui_ogl_ctx
+{
+	EGLDisplay display;
+	EGLContext context;
+
+	struct xrt_frame_context xfctx;
+	struct xrt_frame_sink *sink;
+	struct gui_ogl_texture *tex;
+
+	//! Two frames, so each upload has new contents.
+	struct xrt_frame *frames[2];
+	uint64_t timestamp;
+
+	//! What the sink used to do, re-specify this texture every frame.
+	GLuint old_tex;
+};
+
+/*!
+ * A surfaceless OpenGL 3.3 core context, same version as the GUI uses.
+ */
+static bool
+init_egl(struct gui_ogl_ctx *ctx)
+{
+	PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+	    (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (get_platform_display != NULL) {
+		ctx->display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (ctx->display == EGL_NO_DISPLAY) {
+		ctx->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	if (ctx->display == EGL_NO_DISPLAY || !eglInitialize(ctx->display, NULL, NULL)) {
+		ctx->display = EGL_NO_DISPLAY;
+		return false;
+	}
+
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		return false;
+	}
+
+	EGLint attrs[] = {
+	    EGL_CONTEXT_MAJOR_VERSION,
+	    3,
+	    EGL_CONTEXT_MINOR_VERSION,
+	    3,
+	    EGL_CONTEXT_OPENGL_PROFILE_MASK,
+	    EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+	    EGL_NONE,
+	};
+
+	// Needs EGL_KHR_no_config_context and EGL_KHR_surfaceless_context, Mesa has both.
+	ctx->context = eglCreateContext(ctx->display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attrs);
+	if (ctx->context == EGL_NO_CONTEXT) {
+		return false;
+	}
+
+	if (!eglMakeCurrent(ctx->display, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx->context)) {
+		return false;
+	}
+
+	return gladLoadGL((GLADloadfunc)eglGetProcAddress) != 0;
+}
+
+static struct xrt_frame *
+make_frame(uint64_t sequence)
+{
+	struct xrt_frame *xf = NULL;
+	u_frame_create_one_off(XRT_FORMAT_R8G8B8, FRAME_WIDTH, FRAME_HEIGHT, &xf);
+
+	for (uint32_t y = 0; y < FRAME_HEIGHT; y++) {
+		for (uint32_t x = 0; x < FRAME_WIDTH * 3; x++) {
+			xf->data[y * xf->stride + x] = (uint8_t)(x + y * 7 + sequence * 13);
+		}
+	}
+
+	xf->source_sequence = sequence;
+
+	return xf;
+}
+
+static void
+gui_ogl_teardown(void *ptr)
+{
+	struct gui_ogl_ctx *ctx = (struct gui_ogl_ctx *)ptr;
+
+	xrt_frame_reference(&ctx->frames[0], NULL);
+	xrt_frame_reference(&ctx->frames[1], NULL);
+
+	// The sink has GL objects, destroy it while the context is current.
+	xrt_frame_context_destroy_nodes(&ctx->xfctx);
+
+	if (ctx->old_tex != 0) {
+		glDeleteTextures(1, &ctx->old_tex);
+	}
+
+	if (ctx->context != EGL_NO_CONTEXT) {
+		eglMakeCurrent(ctx->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(ctx->display, ctx->context);
+	}
+	if (ctx->display != EGL_NO_DISPLAY) {
+		eglTerminate(ctx->display);
+	}
+
+	free(ctx);
+}
+
+static void *
+gui_ogl_setup(void)
+{
+	struct gui_ogl_ctx *ctx = U_TYPED_CALLOC(struct gui_ogl_ctx);
+	ctx->display = EGL_NO_DISPLAY;
+	ctx->context = EGL_NO_CONTEXT;
+
+	if (!init_egl(ctx)) {
+		gui_ogl_teardown(ctx);
+		return NULL;
+	}
+
+	ctx->tex = gui_ogl_sink_create("Bench", &ctx->xfctx, &ctx->sink);
+	if (ctx->tex == NULL) {
+		gui_ogl_teardown(ctx);
+		return NULL;
+	}
+
+	ctx->frames[0] = make_frame(1);
+	ctx->frames[1] = make_frame(2);
+
+	glGenTextures(1, &ctx->old_tex);
+
+	return ctx;
+}
+
+
+/*
+ *
+ * Uploads, glFinish at the end so the GPU side is part of the time.
+ *
+ */
+
+static void
+tex_image_run(void *ptr, uint64_t iterations)
+{
+	struct gui_ogl_ctx *ctx = (struct gui_ogl_ctx *)ptr;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		struct xrt_frame *xf = ctx->frames[i % 2];
+
+		glBindTexture(GL_TEXTURE_2D, ctx->old_tex);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, xf->stride / 3);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, FRAME_WIDTH, FRAME_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE,
+		             xf->data);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glFinish();
+}
+
+static void
+sink_run(void *ptr, uint64_t iterations)
+{
+	struct gui_ogl_ctx *ctx = (struct gui_ogl_ctx *)ptr;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		struct xrt_frame *xf = ctx->frames[i % 2];
+
+		// A new timestamp each time, or the sink skips it as already uploaded.
+		xf->timestamp = ++ctx->timestamp;
+		xrt_sink_push_frame(ctx->sink, xf);
+		gui_ogl_sink_update(ctx->tex);
+	}
+
+	glFinish();
+}
+
+
+/*
+ *
+ * 'Exported' list.
+ *
+ */
+
+const struct bench_case bench_gui_ogl_cases[] = {
+    {"gui/upload_tex_image_1280x800", gui_ogl_setup, tex_image_run, gui_ogl_teardown},
+    {"gui/upload_ogl_sink_1280x800", gui_ogl_setup, sink_run, gui_ogl_teardown},
+    {NULL, NULL, NULL, NULL},
+};
@@ -0,0 +1,340 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Microbenchmarks for the IPC calls, over a socket pair with a
+ *         minimal service thread on the other end.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_space.h"
+#include "os/os_threading.h"
+#include "math/m_relation_history.h"
+#include "util/u_misc.h"
+#include "util/u_space_overseer.h"
+#include "util/u_time.h"
+
+#include "shared/ipc_tracking.h"
+#include "ipc_client_generated.h"
+
+#include "bench_common.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <stdlib.h>
+
+
+//! Number of spaces located each frame, a handful of controllers and a lot of anchors.
+#define SPACE_COUNT 64
+
+//! Device sample rate and how often the service publishes them, same as the defaults.
+#define IMU_PERIOD_NS (1 * U_TIME_1MS_IN_NS)
+#define PUBLISH_PERIOD_NS (2 * U_TIME_1MS_IN_NS)
+
+//! How far ahead of the newest sample poses are asked for, about a frame and a half.
+#define PREDICTION_NS (20 * U_TIME_1MS_IN_NS)
+
+
+/*
+ *
+ * Service side.
+ *
+ */
+
+struct ipc_ctx
+{
+	int fds[2];
+	struct ipc_connection ipc_c;
+
+	//! Service side end of the socket pair.
+	struct ipc_message_channel imc;
+	struct os_thread thread;
+	bool thread_started;
+
+	struct xrt_space_overseer *xso;
+	//! Space id zero is the root space, used as the base space.
+	struct xrt_space *spaces[SPACE_COUNT + 1];
+
+	struct ipc_arg_space_locate_spaces args;
+	struct xrt_space_relation singles[SPACE_COUNT];
+	struct ipc_info_space_locate_spaces batched;
+
+	//! A device that keeps a relation history, like most drivers do.
+	struct xrt_device xdev;
+	struct xrt_input inputs[1];
+	struct m_relation_history *rh;
+
+	//! What the service publishes for the device.
+	struct ipc_shared_device_tracking isdt;
+	uint64_t newest_ns;
+	struct xrt_space_relation relation;
+};
+
+static void
+device_get_tracked_pose(struct xrt_device *xdev,
+                        enum xrt_input_name name,
+                        uint64_t at_timestamp_ns,
+                        struct xrt_space_relation *out_relation)
+{
+	struct ipc_ctx *ctx = container_of(xdev, struct ipc_ctx, xdev);
+
+	m_relation_history_get(ctx->rh, at_timestamp_ns, out_relation);
+}
+
+//! Fill the history and the shared tracking with a constant velocity motion.
+static void
+device_init(struct ipc_ctx *ctx)
+{
+	ctx->inputs[0].name = XRT_INPUT_GENERIC_HEAD_POSE;
+	ctx->xdev.inputs = ctx->inputs;
+	ctx->xdev.input_count = ARRAY_SIZE(ctx->inputs);
+	ctx->xdev.get_tracked_pose = device_get_tracked_pose;
+	m_relation_history_create(&ctx->rh);
+
+	ipc_tracking_init(&ctx->isdt, &ctx->xdev);
+
+	// Enough publishes that the shared history has wrapped.
+	const uint64_t start_ns = U_TIME_1S_IN_NS;
+	const uint64_t end_ns = start_ns + IPC_SHARED_POSE_HISTORY_SIZE * 3 * PUBLISH_PERIOD_NS;
+
+	for (uint64_t t = start_ns; t <= end_ns; t += IMU_PERIOD_NS) {
+		float dt = (float)time_ns_to_s((int64_t)(t - start_ns));
+
+		struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+		rel.relation_flags = XRT_SPACE_RELATION_BITMASK_ALL;
+		rel.pose.position.x = 0.5f * dt;
+		rel.pose.position.y = 1.6f;
+		rel.pose.orientation.w = 1.0f;
+		rel.linear_velocity.x = 0.5f;
+		m_relation_history_push(ctx->rh, &rel, t);
+
+		if ((t - start_ns) % PUBLISH_PERIOD_NS == 0) {
+			ipc_tracking_publish(&ctx->isdt, &ctx->xdev, t);
+			ctx->newest_ns = t;
+		}
+	}
+}
+
+static void
+service_locate_space(struct ipc_ctx *ctx, const struct ipc_space_locate_space_msg *msg)
+{
+	struct ipc_space_locate_space_reply reply = {0};
+	reply.result = xrt_space_overseer_locate_space( //
+	    ctx->xso,                                   //
+	    ctx->spaces[msg->base_space_id],            //
+	    &msg->base_offset,                          //
+	    msg->at_timestamp,                          //
+	    ctx->spaces[msg->space_id],                 //
+	    &msg->offset,                               //
+	    &reply.relation);                           //
+	ipc_send(&ctx->imc, &reply, sizeof(reply));
+}
+
+static void
+service_locate_spaces(struct ipc_ctx *ctx, const struct ipc_space_locate_spaces_msg *msg)
+{
+	struct xrt_space *xspaces[IPC_MAX_LOCATE_SPACES] = {0};
+	for (uint32_t i = 0; i < msg->spaces.space_count; i++) {
+		xspaces[i] = ctx->spaces[msg->spaces.space_ids[i]];
+	}
+
+	struct ipc_space_locate_spaces_reply reply = {0};
+	reply.result = xrt_space_overseer_locate_spaces( //
+	    ctx->xso,                                    //
+	    ctx->spaces[msg->base_space_id],             //
+	    &msg->base_offset,                           //
+	    msg->at_timestamp,                           //
+	    xspaces,                                     //
+	    msg->spaces.space_count,                     //
+	    msg->spaces.offsets,                         //
+	    reply.relations.relations);                  //
+	ipc_send(&ctx->imc, &reply, sizeof(reply));
+}
+
+static void
+service_get_tracked_pose(struct ipc_ctx *ctx, const struct ipc_device_get_tracked_pose_msg *msg)
+{
+	struct ipc_device_get_tracked_pose_reply reply = {0};
+	reply.result = XRT_SUCCESS;
+	xrt_device_get_tracked_pose(&ctx->xdev, msg->name, msg->at_timestamp, &reply.relation);
+	ipc_send(&ctx->imc, &reply, sizeof(reply));
+}
+
+static void *
+service_run(void *ptr)
+{
+	struct ipc_ctx *ctx = (struct ipc_ctx *)ptr;
+	_Alignas(8) uint8_t buf[IPC_BUF_SIZE];
+
+	while (true) {
+		ssize_t len = recv(ctx->imc.ipc_handle, buf, IPC_BUF_SIZE, 0);
+		if (len < 4) {
+			break; // Client closed the connection.
+		}
+
+		switch (*(ipc_command_t *)buf) {
+		case IPC_SPACE_LOCATE_SPACE:
+			service_locate_space(ctx, (struct ipc_space_locate_space_msg *)buf);
+			break;
+		case IPC_SPACE_LOCATE_SPACES:
+			service_locate_spaces(ctx, (struct ipc_space_locate_spaces_msg *)buf);
+			break;
+		case IPC_DEVICE_GET_TRACKED_POSE:
+			service_get_tracked_pose(ctx, (struct ipc_device_get_tracked_pose_msg *)buf);
+			break;
+		default: return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+static void
+ipc_teardown(void *ptr)
+{
+	struct ipc_ctx *ctx = (struct ipc_ctx *)ptr;
+
+	// Stops the service thread.
+	shutdown(ctx->fds[0], SHUT_RDWR);
+	if (ctx->thread_started) {
+		os_thread_join(&ctx->thread);
+	}
+	os_thread_destroy(&ctx->thread);
+
+	close(ctx->fds[0]);
+	close(ctx->fds[1]);
+	os_mutex_destroy(&ctx->ipc_c.mutex);
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(ctx->spaces); i++) {
+		xrt_space_reference(&ctx->spaces[i], NULL);
+	}
+	xrt_space_overseer_destroy(&ctx->xso);
+	m_relation_history_destroy(&ctx->rh);
+
+	free(ctx);
+}
+
+static void *
+ipc_setup(void)
+{
+	struct ipc_ctx *ctx = U_TYPED_CALLOC(struct ipc_ctx);
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, ctx->fds) != 0) {
+		free(ctx);
+		return NULL;
+	}
+
+	ctx->ipc_c.imc.ipc_handle = ctx->fds[0];
+	ctx->ipc_c.imc.log_level = U_LOGGING_WARN;
+	ctx->ipc_c.log_level = U_LOGGING_WARN;
+	os_mutex_init(&ctx->ipc_c.mutex);
+
+	ctx->imc.ipc_handle = ctx->fds[1];
+	ctx->imc.log_level = U_LOGGING_WARN;
+
+	ctx->xso = (struct xrt_space_overseer *)u_space_overseer_create();
+	xrt_space_reference(&ctx->spaces[0], ctx->xso->semantic.root);
+
+	const struct xrt_pose identity = XRT_POSE_IDENTITY;
+	ctx->args.space_count = SPACE_COUNT;
+
+	for (uint32_t i = 0; i < SPACE_COUNT; i++) {
+		struct xrt_pose offset = XRT_POSE_IDENTITY;
+		offset.position.x = (float)i * 0.1f;
+		offset.position.y = 1.0f;
+		xrt_space_overseer_create_offset_space(ctx->xso, ctx->spaces[0], &offset, &ctx->spaces[i + 1]);
+
+		ctx->args.space_ids[i] = i + 1;
+		ctx->args.offsets[i] = identity;
+	}
+
+	device_init(ctx);
+
+	os_thread_init(&ctx->thread);
+	ctx->thread_started = os_thread_start(&ctx->thread, service_run, ctx) == 0;
+	if (!ctx->thread_started) {
+		ipc_teardown(ctx);
+		return NULL;
+	}
+
+	return ctx;
+}
+
+
+/*
+ *
+ * Locate spaces, one call per space against one batched call per frame.
+ *
+ */
+
+static void
+locate_space_single_run(void *ptr, uint64_t iterations)
+{
+	struct ipc_ctx *ctx = (struct ipc_ctx *)ptr;
+	const struct xrt_pose identity = XRT_POSE_IDENTITY;
+
+	for (uint64_t n = 0; n < iterations; n++) {
+		for (uint32_t i = 0; i < SPACE_COUNT; i++) {
+			ipc_call_space_locate_space( //
+			    &ctx->ipc_c, 0, &identity, n + 1, i + 1, &identity, &ctx->singles[i]);
+		}
+	}
+}
+
+static void
+locate_spaces_batched_run(void *ptr, uint64_t iterations)
+{
+	struct ipc_ctx *ctx = (struct ipc_ctx *)ptr;
+	const struct xrt_pose identity = XRT_POSE_IDENTITY;
+
+	for (uint64_t n = 0; n < iterations; n++) {
+		ipc_call_space_locate_spaces(&ctx->ipc_c, 0, &identity, n + 1, &ctx->args, &ctx->batched);
+	}
+}
+
+
+/*
+ *
+ * Tracked pose, a round trip to the service against reading what it published.
+ *
+ */
+
+static void
+tracked_pose_call_run(void *ptr, uint64_t iterations)
+{
+	struct ipc_ctx *ctx = (struct ipc_ctx *)ptr;
+	const uint64_t at_ns = ctx->newest_ns + PREDICTION_NS;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		ipc_call_device_get_tracked_pose(&ctx->ipc_c, 0, XRT_INPUT_GENERIC_HEAD_POSE, at_ns, &ctx->relation);
+	}
+}
+
+static void
+tracked_pose_shared_run(void *ptr, uint64_t iterations)
+{
+	struct ipc_ctx *ctx = (struct ipc_ctx *)ptr;
+	const uint64_t at_ns = ctx->newest_ns + PREDICTION_NS;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		ipc_tracking_get_tracked_pose( //
+		    &ctx->isdt, XRT_INPUT_GENERIC_HEAD_POSE, at_ns, ctx->newest_ns, &ctx->relation);
+	}
+}
+
+
+/*
+ *
+ * 'Exported' list.
+ *
+ */
+
+const struct bench_case bench_ipc_cases[] = {
+    {"ipc/locate_space_single_64_spaces", ipc_setup, locate_space_single_run, ipc_teardown},
+    {"ipc/locate_spaces_batched_64_spaces", ipc_setup, locate_spaces_batched_run, ipc_teardown},
+    {"ipc/tracked_pose_call", ipc_setup, tracked_pose_call_run, ipc_teardown},
+    {"ipc/tracked_pose_shared_memory", ipc_setup, tracked_pose_shared_run, ipc_teardown},
+    {NULL, NULL, NULL, NULL},
+};
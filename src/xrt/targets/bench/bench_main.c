@@ -0,0 +1,454 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Microbenchmarks of the runtime hot paths.
+ * @author agent <agent@local>
+ */
+
+#include "util/u_file.h"
+#include "util/u_git_tag.h"
+#include "util/u_json.h"
+#include "util/u_misc.h"
+#include "util/u_time.h"
+
+#include "bench_common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define P(...) fprintf(stderr, __VA_ARGS__)
+
+//! Bumped when the layout of the json output changes.
+#define BENCH_JSON_VERSION 1
+
+//! Exit code used when the comparison finds a regression.
+#define BENCH_EXIT_REGRESSION 2
+
+
+struct bench_options
+{
+	struct bench_config config;
+
+	const char *filter;
+	const char *json_path;
+	const char *baseline_path;
+
+	//! How much slower, as a fraction, a result must be to count as a regression.
+	double threshold;
+
+	bool list;
+	bool help;
+};
+
+enum bench_verdict
+{
+	BENCH_VERDICT_NONE,
+	BENCH_VERDICT_UNCHANGED,
+	BENCH_VERDICT_IMPROVED,
+	BENCH_VERDICT_REGRESSED,
+};
+
+static const struct bench_case *bench_lists[] = {
+    bench_math_cases,
+    bench_util_cases,
+#ifdef XRT_FEATURE_OPENXR
+    bench_oxr_cases,
+#endif
+#if defined(XRT_MODULE_COMPOSITOR) && defined(XRT_HAVE_VULKAN)
+    bench_comp_vk_cases,
+#endif
+#if defined(XRT_FEATURE_SERVICE) && !defined(XRT_OS_WINDOWS)
+    bench_ipc_cases,
+#endif
+#if defined(XRT_HAVE_OPENGL) && defined(XRT_HAVE_EGL)
+    bench_gui_ogl_cases,
+#endif
+#ifdef XRT_BUILD_DRIVER_REMOTE
+    bench_remote_cases,
+#endif
+#ifdef XRT_BUILD_DRIVER_VIVE
+    bench_vive_cases,
+#endif
+};
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static int
+print_help(const char *name)
+{
+	P("Monado-Bench\n");
+	P("Usage: %s [options]\n", name);
+	P("\n");
+	P("Options:\n");
+	P("  --help, -h         - Print this help and exit.\n");
+	P("  --list             - List the benchmarks and exit.\n");
+	P("  --filter <str>     - Only run benchmarks with <str> in their name.\n");
+	P("  --json <file>      - Write results as json to <file>, '-' for stdout.\n");
+	P("  --baseline <file>  - Compare against json results from an earlier run.\n");
+	P("  --threshold <pct>  - Slowdown in percent counted as a regression (default 5).\n");
+	P("  --sample-ms <ms>   - Minimum time per sample (default 5).\n");
+	P("  --min-samples <n>  - Minimum number of samples (default 32).\n");
+	P("  --max-samples <n>  - Maximum number of samples (default 512).\n");
+	P("  --max-time-ms <ms> - Time after which sampling stops (default 2000).\n");
+	P("  --precision <pct>  - Stop early once the median is known to this (default 1).\n");
+	P("\n");
+	P("Exits with %i if the comparison found a regression.\n", BENCH_EXIT_REGRESSION);
+
+	return 1;
+}
+
+static bool
+parse_u32(const char *str, uint32_t *out_value)
+{
+	char *end = NULL;
+	unsigned long value = strtoul(str, &end, 10);
+	if (end == str || *end != '\0' || value == 0 || value > UINT32_MAX) {
+		return false;
+	}
+
+	*out_value = (uint32_t)value;
+	return true;
+}
+
+static bool
+parse_double(const char *str, double *out_value)
+{
+	char *end = NULL;
+	double value = strtod(str, &end);
+	if (end == str || *end != '\0' || value < 0.0) {
+		return false;
+	}
+
+	*out_value = value;
+	return true;
+}
+
+static bool
+parse_args(int argc, const char **argv, struct bench_options *opts)
+{
+	uint32_t sample_ms = 5;
+	uint32_t max_time_ms = 2000;
+	double precision_pct = 1.0;
+	double threshold_pct = 5.0;
+
+	opts->config.warmup_ns = 100 * (uint64_t)U_TIME_1MS_IN_NS;
+	opts->config.min_samples = 32;
+	opts->config.max_samples = 512;
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+		bool ok = true;
+
+		if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+			opts->help = true;
+			return true;
+		}
+
+		if (strcmp(arg, "--list") == 0) {
+			opts->list = true;
+			continue;
+		}
+
+		if (value == NULL) {
+			P("Missing value for '%s'\n\n", arg);
+			return false;
+		}
+
+		if (strcmp(arg, "--filter") == 0) {
+			opts->filter = value;
+		} else if (strcmp(arg, "--json") == 0) {
+			opts->json_path = value;
+		} else if (strcmp(arg, "--baseline") == 0) {
+			opts->baseline_path = value;
+		} else if (strcmp(arg, "--threshold") == 0) {
+			ok = parse_double(value, &threshold_pct);
+		} else if (strcmp(arg, "--sample-ms") == 0) {
+			ok = parse_u32(value, &sample_ms);
+		} else if (strcmp(arg, "--min-samples") == 0) {
+			ok = parse_u32(value, &opts->config.min_samples);
+		} else if (strcmp(arg, "--max-samples") == 0) {
+			ok = parse_u32(value, &opts->config.max_samples);
+		} else if (strcmp(arg, "--max-time-ms") == 0) {
+			ok = parse_u32(value, &max_time_ms);
+		} else if (strcmp(arg, "--precision") == 0) {
+			ok = parse_double(value, &precision_pct);
+		} else {
+			P("Unknown option '%s'\n\n", arg);
+			return false;
+		}
+
+		if (!ok) {
+			P("Invalid value '%s' for '%s'\n\n", value, arg);
+			return false;
+		}
+
+		i++;
+	}
+
+	if (opts->config.min_samples > opts->config.max_samples) {
+		P("--min-samples can not be larger than --max-samples\n\n");
+		return false;
+	}
+
+	opts->config.sample_ns = sample_ms * (uint64_t)U_TIME_1MS_IN_NS;
+	opts->config.max_time_ns = max_time_ms * (uint64_t)U_TIME_1MS_IN_NS;
+	opts->config.precision = precision_pct / 100.0;
+	opts->threshold = threshold_pct / 100.0;
+
+	return true;
+}
+
+static const char *
+verdict_to_string(enum bench_verdict verdict)
+{
+	switch (verdict) {
+	case BENCH_VERDICT_NONE: return "none";
+	case BENCH_VERDICT_UNCHANGED: return "unchanged";
+	case BENCH_VERDICT_IMPROVED: return "improved";
+	case BENCH_VERDICT_REGRESSED: return "regressed";
+	default: return "unknown";
+	}
+}
+
+static double
+get_number(const cJSON *obj, const char *name)
+{
+	const cJSON *item = cJSON_GetObjectItemCaseSensitive(obj, name);
+	return cJSON_IsNumber(item) ? item->valuedouble : 0.0;
+}
+
+static const cJSON *
+find_baseline(const cJSON *baseline, const char *name)
+{
+	const cJSON *results = cJSON_GetObjectItemCaseSensitive(baseline, "results");
+	const cJSON *result = NULL;
+
+	cJSON_ArrayForEach(result, results)
+	{
+		const cJSON *item = cJSON_GetObjectItemCaseSensitive(result, "name");
+		if (cJSON_IsString(item) && strcmp(item->valuestring, name) == 0) {
+			return result;
+		}
+	}
+
+	return NULL;
+}
+
+/*!
+ * Only a change that is both larger than the threshold and outside of the
+ * confidence intervals of both runs counts, so noise is not reported.
+ */
+static enum bench_verdict
+compare(const struct bench_stats *stats, const cJSON *base, double threshold, double *out_ratio)
+{
+	double base_median = get_number(base, "median_ns");
+	double base_ci_low = get_number(base, "ci_low_ns");
+	double base_ci_high = get_number(base, "ci_high_ns");
+
+	if (base_median <= 0.0) {
+		return BENCH_VERDICT_NONE;
+	}
+
+	double ratio = stats->median_ns / base_median;
+	*out_ratio = ratio;
+
+	if (ratio > 1.0 + threshold && stats->ci_low_ns > base_ci_high) {
+		return BENCH_VERDICT_REGRESSED;
+	}
+	if (ratio < 1.0 - threshold && stats->ci_high_ns < base_ci_low) {
+		return BENCH_VERDICT_IMPROVED;
+	}
+
+	return BENCH_VERDICT_UNCHANGED;
+}
+
+static cJSON *
+stats_to_json(const char *name, const struct bench_stats *stats)
+{
+	cJSON *obj = cJSON_CreateObject();
+	cJSON_AddStringToObject(obj, "name", name);
+	cJSON_AddNumberToObject(obj, "iterations_per_sample", (double)stats->iterations_per_sample);
+	cJSON_AddNumberToObject(obj, "samples", stats->sample_count);
+	cJSON_AddNumberToObject(obj, "median_ns", stats->median_ns);
+	cJSON_AddNumberToObject(obj, "mean_ns", stats->mean_ns);
+	cJSON_AddNumberToObject(obj, "stddev_ns", stats->stddev_ns);
+	cJSON_AddNumberToObject(obj, "mad_ns", stats->mad_ns);
+	cJSON_AddNumberToObject(obj, "min_ns", stats->min_ns);
+	cJSON_AddNumberToObject(obj, "max_ns", stats->max_ns);
+	cJSON_AddNumberToObject(obj, "ci_low_ns", stats->ci_low_ns);
+	cJSON_AddNumberToObject(obj, "ci_high_ns", stats->ci_high_ns);
+	cJSON_AddNumberToObject(obj, "outliers", stats->outlier_count);
+
+	return obj;
+}
+
+static cJSON *
+config_to_json(const struct bench_options *opts)
+{
+	cJSON *obj = cJSON_CreateObject();
+	cJSON_AddNumberToObject(obj, "warmup_ns", (double)opts->config.warmup_ns);
+	cJSON_AddNumberToObject(obj, "sample_ns", (double)opts->config.sample_ns);
+	cJSON_AddNumberToObject(obj, "precision", opts->config.precision);
+	cJSON_AddNumberToObject(obj, "min_samples", opts->config.min_samples);
+	cJSON_AddNumberToObject(obj, "max_samples", opts->config.max_samples);
+	cJSON_AddNumberToObject(obj, "max_time_ns", (double)opts->config.max_time_ns);
+
+	return obj;
+}
+
+static bool
+write_json(const char *path, cJSON *root)
+{
+	char *str = cJSON_Print(root);
+	if (str == NULL) {
+		return false;
+	}
+
+	bool ret = true;
+	if (strcmp(path, "-") == 0) {
+		printf("%s\n", str);
+	} else {
+		FILE *file = fopen(path, "w");
+		if (file == NULL) {
+			P("Could not open '%s' for writing\n", path);
+			ret = false;
+		} else {
+			fprintf(file, "%s\n", str);
+			fclose(file);
+		}
+	}
+
+	cJSON_free(str);
+
+	return ret;
+}
+
+
+/*
+ *
+ * Main.
+ *
+ */
+
+int
+main(int argc, const char **argv)
+{
+	struct bench_options opts = {0};
+	if (!parse_args(argc, argv, &opts)) {
+		return print_help(argv[0]);
+	}
+
+	if (opts.help) {
+		print_help(argv[0]);
+		return 0;
+	}
+
+	if (opts.list) {
+		for (size_t l = 0; l < ARRAY_SIZE(bench_lists); l++) {
+			for (const struct bench_case *bc = bench_lists[l]; bc->name != NULL; bc++) {
+				printf("%s\n", bc->name);
+			}
+		}
+		return 0;
+	}
+
+	cJSON *baseline = NULL;
+	if (opts.baseline_path != NULL) {
+		char *content = u_file_read_content_from_path(opts.baseline_path);
+		if (content == NULL) {
+			P("Could not read baseline '%s'\n", opts.baseline_path);
+			return 1;
+		}
+
+		baseline = cJSON_Parse(content);
+		free(content);
+
+		if (baseline == NULL) {
+			P("Could not parse baseline '%s'\n", opts.baseline_path);
+			return 1;
+		}
+	}
+
+	// Keep stdout clean for the json.
+	FILE *text = opts.json_path != NULL && strcmp(opts.json_path, "-") == 0 ? stderr : stdout;
+
+	cJSON *root = cJSON_CreateObject();
+	cJSON_AddNumberToObject(root, "version", BENCH_JSON_VERSION);
+	cJSON_AddStringToObject(root, "git_tag", u_git_tag);
+	cJSON_AddItemToObject(root, "config", config_to_json(&opts));
+	cJSON *results = cJSON_AddArrayToObject(root, "results");
+
+	fprintf(text, "%-48s %12s %12s %12s %8s %8s\n", "name", "median ns", "ci low", "ci high", "samples",
+	        baseline != NULL ? "vs base" : "");
+
+	uint32_t regressions = 0;
+
+	for (size_t l = 0; l < ARRAY_SIZE(bench_lists); l++) {
+		for (const struct bench_case *bc = bench_lists[l]; bc->name != NULL; bc++) {
+			if (opts.filter != NULL && strstr(bc->name, opts.filter) == NULL) {
+				continue;
+			}
+
+			struct bench_stats stats;
+			if (!bench_run_case(&opts.config, bc, &stats)) {
+				P("Setup failed for '%s', skipping\n", bc->name);
+				continue;
+			}
+
+			cJSON *obj = stats_to_json(bc->name, &stats);
+			cJSON_AddItemToArray(results, obj);
+
+			fprintf(text, "%-48s %12.1f %12.1f %12.1f %8u", bc->name, stats.median_ns, stats.ci_low_ns,
+			        stats.ci_high_ns, stats.sample_count);
+
+			const cJSON *base = baseline != NULL ? find_baseline(baseline, bc->name) : NULL;
+			if (base != NULL) {
+				double ratio = 0.0;
+				enum bench_verdict verdict = compare(&stats, base, opts.threshold, &ratio);
+
+				cJSON *cmp = cJSON_AddObjectToObject(obj, "baseline");
+				cJSON_AddNumberToObject(cmp, "median_ns", get_number(base, "median_ns"));
+				cJSON_AddNumberToObject(cmp, "ratio", ratio);
+				cJSON_AddStringToObject(cmp, "verdict", verdict_to_string(verdict));
+
+				fprintf(text, " %+7.1f%% %s", (ratio - 1.0) * 100.0,
+				        verdict == BENCH_VERDICT_REGRESSED ? "REGRESSED" : "");
+
+				if (verdict == BENCH_VERDICT_REGRESSED) {
+					regressions++;
+				}
+			} else if (baseline != NULL) {
+				fprintf(text, " %8s", "new");
+			}
+
+			fprintf(text, "\n");
+		}
+	}
+
+	bool written = true;
+	if (opts.json_path != NULL) {
+		written = write_json(opts.json_path, root);
+	}
+
+	cJSON_Delete(root);
+	cJSON_Delete(baseline);
+
+	if (!written) {
+		return 1;
+	}
+	if (regressions > 0) {
+		P("%u benchmark(s) regressed by more than %.1f%%\n", regressions, opts.threshold * 100.0);
+		return BENCH_EXIT_REGRESSION;
+	}
+
+	return 0;
+}
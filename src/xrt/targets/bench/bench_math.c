@@ -0,0 +1,206 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Microbenchmarks for the math helpers.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_defines.h"
+#include "math/m_api.h"
+#include "math/m_imu_3dof.h"
+#include "math/m_relation_history.h"
+#include "math/m_space.h"
+#include "util/u_misc.h"
+#include "util/u_time.h"
+
+#include "bench_common.h"
+
+#include <stdlib.h>
+
+
+//! Samples pushed into the history, it keeps the newest ones only.
+#define HISTORY_PUSH_COUNT 4096
+
+//! Time between samples, a 1000Hz IMU driven tracker.
+#define HISTORY_PERIOD_NS ((uint64_t)U_TIME_1MS_IN_NS)
+
+
+/*
+ *
+ * m_relation_history_get
+ *
+ */
+
+struct relation_history_ctx
+{
+	struct m_relation_history *rh;
+	uint64_t newest_ns;
+	struct xrt_space_relation out;
+};
+
+static void *
+relation_history_setup(void)
+{
+	struct relation_history_ctx *ctx = U_TYPED_CALLOC(struct relation_history_ctx);
+	m_relation_history_create(&ctx->rh);
+
+	for (uint64_t i = 1; i <= HISTORY_PUSH_COUNT; i++) {
+		struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+		rel.relation_flags = XRT_SPACE_RELATION_BITMASK_ALL;
+		rel.pose.orientation.w = 1.0f;
+		rel.pose.position.x = (float)i * 0.001f;
+		rel.linear_velocity.x = 1.0f;
+
+		ctx->newest_ns = i * HISTORY_PERIOD_NS;
+		m_relation_history_push(ctx->rh, &rel, ctx->newest_ns);
+	}
+
+	return ctx;
+}
+
+static void
+relation_history_run_interpolated(void *ptr, uint64_t iterations)
+{
+	struct relation_history_ctx *ctx = (struct relation_history_ctx *)ptr;
+	uint32_t size = m_relation_history_get_size(ctx->rh);
+
+	// Walk backwards through the history, half way between samples.
+	for (uint64_t i = 0; i < iterations; i++) {
+		uint64_t back = (i % (size - 1)) + 1;
+		uint64_t at_ns = ctx->newest_ns - back * HISTORY_PERIOD_NS + HISTORY_PERIOD_NS / 2;
+		m_relation_history_get(ctx->rh, at_ns, &ctx->out);
+	}
+}
+
+static void
+relation_history_run_predicted(void *ptr, uint64_t iterations)
+{
+	struct relation_history_ctx *ctx = (struct relation_history_ctx *)ptr;
+
+	// What the compositor does, a frame or two into the future.
+	for (uint64_t i = 0; i < iterations; i++) {
+		uint64_t at_ns = ctx->newest_ns + (i % 32) * HISTORY_PERIOD_NS;
+		m_relation_history_get(ctx->rh, at_ns, &ctx->out);
+	}
+}
+
+static void
+relation_history_teardown(void *ptr)
+{
+	struct relation_history_ctx *ctx = (struct relation_history_ctx *)ptr;
+	m_relation_history_destroy(&ctx->rh);
+	free(ctx);
+}
+
+
+/*
+ *
+ * m_relation_chain_resolve
+ *
+ */
+
+struct relation_chain_ctx
+{
+	struct xrt_relation_chain xrc;
+	struct xrt_space_relation out;
+};
+
+static void *
+relation_chain_setup(void)
+{
+	struct relation_chain_ctx *ctx = U_TYPED_CALLOC(struct relation_chain_ctx);
+
+	// Device pose, tracking origin offset, stage offset and the space offset.
+	for (uint32_t i = 0; i < 4; i++) {
+		struct xrt_space_relation *rel = &ctx->xrc.steps[ctx->xrc.step_count++];
+		rel->relation_flags = XRT_SPACE_RELATION_BITMASK_ALL;
+		rel->pose.position.y = 0.1f * (float)(i + 1);
+		rel->linear_velocity.x = 0.5f;
+		rel->angular_velocity.y = 0.25f;
+
+		struct xrt_vec3 axis = {0.0f, 1.0f, 0.0f};
+		math_quat_from_angle_vector(0.1f * (float)(i + 1), &axis, &rel->pose.orientation);
+	}
+
+	return ctx;
+}
+
+static void
+relation_chain_run(void *ptr, uint64_t iterations)
+{
+	struct relation_chain_ctx *ctx = (struct relation_chain_ctx *)ptr;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		m_relation_chain_resolve(&ctx->xrc, &ctx->out);
+	}
+}
+
+static void
+simple_teardown(void *ptr)
+{
+	free(ptr);
+}
+
+
+/*
+ *
+ * m_imu_3dof_update
+ *
+ */
+
+struct imu_3dof_ctx
+{
+	struct m_imu_3dof fusion;
+	uint64_t timestamp_ns;
+};
+
+static void *
+imu_3dof_setup(void)
+{
+	struct imu_3dof_ctx *ctx = U_TYPED_CALLOC(struct imu_3dof_ctx);
+	m_imu_3dof_init(&ctx->fusion, M_IMU_3DOF_USE_GRAVITY_DUR_20MS);
+
+	return ctx;
+}
+
+static void
+imu_3dof_run(void *ptr, uint64_t iterations)
+{
+	struct imu_3dof_ctx *ctx = (struct imu_3dof_ctx *)ptr;
+
+	// Slowly rotating about up, with gravity and a bit of noise like pattern.
+	for (uint64_t i = 0; i < iterations; i++) {
+		float wobble = (float)(i % 7) * 0.01f;
+		struct xrt_vec3 accel = {wobble, 9.81f, -wobble};
+		struct xrt_vec3 gyro = {0.0f, 0.5f + wobble, 0.0f};
+
+		ctx->timestamp_ns += HISTORY_PERIOD_NS;
+		m_imu_3dof_update(&ctx->fusion, ctx->timestamp_ns, &accel, &gyro);
+	}
+}
+
+static void
+imu_3dof_teardown(void *ptr)
+{
+	struct imu_3dof_ctx *ctx = (struct imu_3dof_ctx *)ptr;
+	m_imu_3dof_close(&ctx->fusion);
+	free(ctx);
+}
+
+
+/*
+ *
+ * 'Exported' list.
+ *
+ */
+
+const struct bench_case bench_math_cases[] = {
+    {"math/relation_history_get_interpolated", relation_history_setup, relation_history_run_interpolated,
+     relation_history_teardown},
+    {"math/relation_history_get_predicted", relation_history_setup, relation_history_run_predicted,
+     relation_history_teardown},
+    {"math/relation_chain_resolve", relation_chain_setup, relation_chain_run, simple_teardown},
+    {"math/imu_3dof_update", imu_3dof_setup, imu_3dof_run, imu_3dof_teardown},
+    {NULL, NULL, NULL, NULL},
+};
@@ -0,0 +1,285 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Microbenchmarks for the OpenXR state tracker.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_compositor.h"
+#include "util/u_misc.h"
+#include "bindings/b_generated_bindings.h"
+
+#include "oxr_objects.h"
+#include "oxr_logger.h"
+
+#include "bench_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+#define VIEW_COUNT 2
+
+//! The minimum OpenXR requires.
+#define MAX_LAYERS 16
+
+//! Actions in the synthetic manifest, bound round robin to every binding of every profile.
+#define MANIFEST_ACTION_COUNT 512
+
+
+/*
+ *
+ * oxr_session_frame_end_verify_layers
+ *
+ */
+
+struct verify_layers_ctx
+{
+	struct oxr_logger log;
+
+	struct xrt_swapchain xsc;
+	struct oxr_swapchain color[VIEW_COUNT];
+	struct oxr_swapchain quad_sc;
+	//! Only the handle value is looked at, never dereferenced.
+	int space;
+
+	XrCompositionLayerProjectionView views[VIEW_COUNT];
+	XrCompositionLayerProjection proj;
+	XrCompositionLayerQuad quad;
+	const XrCompositionLayerBaseHeader *layers[2];
+	XrFrameEndInfo frame_end_info;
+
+	XrResult result;
+};
+
+static void
+init_swapchain(struct verify_layers_ctx *ctx, struct oxr_swapchain *sc)
+{
+	sc->swapchain = &ctx->xsc;
+	sc->width = 2048;
+	sc->height = 2048;
+	sc->array_layer_count = 1;
+	sc->face_count = 1;
+	sc->released.yes = true;
+	sc->released.index = 1;
+}
+
+static void *
+verify_layers_setup(void)
+{
+	struct verify_layers_ctx *ctx = U_TYPED_CALLOC(struct verify_layers_ctx);
+	XrSpace space = XRT_CAST_PTR_TO_OXR_HANDLE(XrSpace, &ctx->space);
+
+	oxr_log_init(&ctx->log, "bench");
+
+	// Only what the verification looks at is filled in.
+	ctx->xsc.image_count = 3;
+	for (uint32_t i = 0; i < VIEW_COUNT; i++) {
+		init_swapchain(ctx, &ctx->color[i]);
+
+		XrCompositionLayerProjectionView *view = &ctx->views[i];
+		view->type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW;
+		view->pose.orientation.w = 1.0f;
+		view->pose.position.x = i == 0 ? -0.032f : 0.032f;
+		view->fov.angleLeft = -0.8f;
+		view->fov.angleRight = 0.8f;
+		view->fov.angleUp = 0.8f;
+		view->fov.angleDown = -0.8f;
+		view->subImage.swapchain = XRT_CAST_PTR_TO_OXR_HANDLE(XrSwapchain, &ctx->color[i]);
+		view->subImage.imageRect.extent.width = 2048;
+		view->subImage.imageRect.extent.height = 2048;
+	}
+
+	ctx->proj.type = XR_TYPE_COMPOSITION_LAYER_PROJECTION;
+	ctx->proj.space = space;
+	ctx->proj.viewCount = VIEW_COUNT;
+	ctx->proj.views = ctx->views;
+
+	init_swapchain(ctx, &ctx->quad_sc);
+	ctx->quad.type = XR_TYPE_COMPOSITION_LAYER_QUAD;
+	ctx->quad.space = space;
+	ctx->quad.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+	ctx->quad.subImage.swapchain = XRT_CAST_PTR_TO_OXR_HANDLE(XrSwapchain, &ctx->quad_sc);
+	ctx->quad.subImage.imageRect.extent.width = 1024;
+	ctx->quad.subImage.imageRect.extent.height = 512;
+	ctx->quad.pose.orientation.w = 1.0f;
+	ctx->quad.pose.position.z = -1.0f;
+	ctx->quad.size.width = 1.0f;
+	ctx->quad.size.height = 0.5f;
+
+	ctx->layers[0] = (const XrCompositionLayerBaseHeader *)&ctx->proj;
+	ctx->layers[1] = (const XrCompositionLayerBaseHeader *)&ctx->quad;
+
+	ctx->frame_end_info.type = XR_TYPE_FRAME_END_INFO;
+	ctx->frame_end_info.displayTime = 1;
+	ctx->frame_end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+	ctx->frame_end_info.layerCount = 2;
+	ctx->frame_end_info.layers = ctx->layers;
+
+	// Make sure we are measuring the success path.
+	XrResult ret = oxr_session_frame_end_verify_layers( //
+	    &ctx->log,                                      //
+	    NULL,                                           //
+	    NULL,                                           //
+	    NULL,                                           //
+	    VIEW_COUNT,                                     //
+	    MAX_LAYERS,                                     //
+	    &ctx->frame_end_info);                          //
+	if (ret != XR_SUCCESS) {
+		free(ctx);
+		return NULL;
+	}
+
+	return ctx;
+}
+
+static void
+verify_layers_run(void *ptr, uint64_t iterations)
+{
+	struct verify_layers_ctx *ctx = (struct verify_layers_ctx *)ptr;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		ctx->frame_end_info.displayTime++;
+		ctx->result = oxr_session_frame_end_verify_layers( //
+		    &ctx->log,                                     //
+		    NULL,                                          //
+		    NULL,                                          //
+		    NULL,                                          //
+		    VIEW_COUNT,                                    //
+		    MAX_LAYERS,                                    //
+		    &ctx->frame_end_info);                         //
+	}
+}
+
+static void
+verify_layers_teardown(void *ptr)
+{
+	free(ptr);
+}
+
+
+/*
+ *
+ * Suggest bindings and attach, the startup cost of a large action manifest.
+ *
+ */
+
+struct manifest_ctx
+{
+	struct oxr_logger log;
+	struct oxr_instance inst;
+
+	struct oxr_action actions[MANIFEST_ACTION_COUNT];
+
+	XrInteractionProfileSuggestedBinding suggested[NUM_PROFILE_TEMPLATES];
+	XrActionSuggestedBinding *bindings;
+
+	size_t found;
+};
+
+static void
+manifest_teardown(void *ptr)
+{
+	struct manifest_ctx *ctx = (struct manifest_ctx *)ptr;
+
+	oxr_binding_destroy_all(&ctx->log, &ctx->inst);
+	oxr_path_destroy(&ctx->log, &ctx->inst);
+	free(ctx->bindings);
+	free(ctx);
+}
+
+static XrPath
+manifest_path(struct manifest_ctx *ctx, const char *str)
+{
+	XrPath path = XR_NULL_PATH;
+	oxr_path_get_or_create(&ctx->log, &ctx->inst, str, strlen(str), &path);
+	return path;
+}
+
+static void *
+manifest_setup(void)
+{
+	struct manifest_ctx *ctx = U_TYPED_CALLOC(struct manifest_ctx);
+
+	oxr_log_init(&ctx->log, "bench");
+	if (oxr_path_init(&ctx->log, &ctx->inst) != XR_SUCCESS) {
+		free(ctx);
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < MANIFEST_ACTION_COUNT; i++) {
+		ctx->actions[i].act_key = i + 1;
+	}
+
+	size_t total = 0;
+	for (size_t x = 0; x < NUM_PROFILE_TEMPLATES; x++) {
+		total += profile_templates[x].binding_count;
+	}
+	ctx->bindings = U_TYPED_ARRAY_CALLOC(XrActionSuggestedBinding, total);
+
+	// Every binding of every profile gets an action, like an engine that supports all controllers.
+	size_t b = 0;
+	for (size_t x = 0; x < NUM_PROFILE_TEMPLATES; x++) {
+		struct profile_template *templ = &profile_templates[x];
+		XrInteractionProfileSuggestedBinding *s = &ctx->suggested[x];
+
+		s->type = XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING;
+		s->interactionProfile = manifest_path(ctx, templ->path);
+		s->suggestedBindings = &ctx->bindings[b];
+		s->countSuggestedBindings = (uint32_t)templ->binding_count;
+
+		for (size_t y = 0; y < templ->binding_count; y++, b++) {
+			struct oxr_action *act = &ctx->actions[b % MANIFEST_ACTION_COUNT];
+
+			ctx->bindings[b].action = XRT_CAST_PTR_TO_OXR_HANDLE(XrAction, act);
+			ctx->bindings[b].binding = manifest_path(ctx, templ->bindings[y].paths[0]);
+		}
+	}
+
+	return ctx;
+}
+
+static void
+manifest_run(void *ptr, uint64_t iterations)
+{
+	struct manifest_ctx *ctx = (struct manifest_ctx *)ptr;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		// xrSuggestInteractionProfileBindings for every profile.
+		for (size_t x = 0; x < NUM_PROFILE_TEMPLATES; x++) {
+			struct oxr_dpad_state dpad_state;
+			oxr_dpad_state_init(&dpad_state);
+			oxr_action_suggest_interaction_profile_bindings(&ctx->log, &ctx->inst, &ctx->suggested[x],
+			                                                &dpad_state);
+		}
+
+		// xrAttachSessionActionSets looks up the bindings of every action in every profile.
+		for (size_t x = 0; x < ctx->inst.profile_count; x++) {
+			struct oxr_interaction_profile *p = ctx->inst.profiles[x];
+
+			for (uint32_t k = 0; k < MANIFEST_ACTION_COUNT; k++) {
+				struct oxr_binding *found[OXR_MAX_BINDINGS_PER_ACTION];
+				size_t num = 0;
+				oxr_binding_find_bindings_from_key(&ctx->log, p, k + 1, found, &num);
+				ctx->found += num;
+			}
+		}
+
+		// Next instance starts from scratch, the path store is kept.
+		oxr_binding_destroy_all(&ctx->log, &ctx->inst);
+	}
+}
+
+
+/*
+ *
+ * 'Exported' list.
+ *
+ */
+
+const struct bench_case bench_oxr_cases[] = {
+    {"oxr/frame_end_verify_projection_and_quad", verify_layers_setup, verify_layers_run, verify_layers_teardown},
+    {"oxr/suggest_and_attach_all_profiles", manifest_setup, manifest_run, manifest_teardown},
+    {NULL, NULL, NULL, NULL},
+};
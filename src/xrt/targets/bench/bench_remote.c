@@ -0,0 +1,145 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Microbenchmarks for the remote driver, playing back a trajectory.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_system.h"
+#include "os/os_time.h"
+#include "util/u_misc.h"
+#include "util/u_time.h"
+#include "remote/r_interface.h"
+#include "remote/r_internal.h"
+
+#include "bench_common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+//! One keyframe every 100ms, ten seconds long, looped.
+#define KEYFRAME_COUNT 101
+
+//! Let the playback thread get going before measuring.
+#define SETTLE_NS (50 * U_TIME_1MS_IN_NS)
+
+
+struct remote_ctx
+{
+	struct xrt_system_devices *xsysd;
+	struct r_hub *r;
+
+	struct xrt_space_relation relation;
+	struct r_remote_data data;
+};
+
+/*!
+ * The driver reads the options only once, so every setup writes the file to
+ * the same path, it is removed again once the driver has loaded it.
+ */
+static bool
+write_trajectory(void)
+{
+	static char path[64] = "";
+
+	if (path[0] == '\0') {
+		snprintf(path, sizeof(path), "/tmp/monado_bench_remote_%i", (int)getpid());
+	}
+
+	FILE *file = fopen(path, "w");
+	if (file == NULL) {
+		return false;
+	}
+
+	// The head moves along x and y at one meter per second, the left controller along -z.
+	fprintf(file, "# time head left right\n");
+	for (int i = 0; i < KEYFRAME_COUNT; i++) {
+		float t = (float)i * 0.1f;
+		fprintf(file, "%f  %f %f 0 0 0 0 1  -0.2 1.3 %f 0 0 0 1  0.2 1.3 -0.5 0 0 0 1\n", t, t, t, -t);
+	}
+	fclose(file);
+
+	setenv("REMOTE_PLAYBACK", path, 1);
+	setenv("REMOTE_PLAYBACK_HZ", "1000", 1);
+	setenv("REMOTE_PLAYBACK_LOOP", "true", 1);
+
+	return true;
+}
+
+static void
+remote_teardown(void *ptr)
+{
+	struct remote_ctx *ctx = (struct remote_ctx *)ptr;
+
+	xrt_system_devices_destroy(&ctx->xsysd);
+	free(ctx);
+}
+
+static void *
+remote_setup(void)
+{
+	if (!write_trajectory()) {
+		return NULL;
+	}
+
+	struct remote_ctx *ctx = U_TYPED_CALLOC(struct remote_ctx);
+	xrt_result_t xret = r_create_devices(0, &ctx->xsysd);
+
+	unlink(getenv("REMOTE_PLAYBACK"));
+
+	if (xret != XRT_SUCCESS) {
+		free(ctx);
+		return NULL;
+	}
+
+	ctx->r = (struct r_hub *)ctx->xsysd;
+	os_nanosleep(SETTLE_NS);
+
+	return ctx;
+}
+
+
+/*
+ *
+ * Pose queries while the playback thread is pushing samples.
+ *
+ */
+
+static void
+head_pose_run(void *ptr, uint64_t iterations)
+{
+	struct remote_ctx *ctx = (struct remote_ctx *)ptr;
+	struct xrt_device *head = ctx->xsysd->roles.head;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		uint64_t now_ns = os_monotonic_get_ns();
+		xrt_device_get_tracked_pose(head, XRT_INPUT_GENERIC_HEAD_POSE, now_ns, &ctx->relation);
+	}
+}
+
+static void
+hub_get_latest_run(void *ptr, uint64_t iterations)
+{
+	struct remote_ctx *ctx = (struct remote_ctx *)ptr;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		r_hub_get_latest(ctx->r, &ctx->data);
+	}
+}
+
+
+/*
+ *
+ * 'Exported' list.
+ *
+ */
+
+const struct bench_case bench_remote_cases[] = {
+    {"remote/playback_head_pose", remote_setup, head_pose_run, remote_teardown},
+    {"remote/hub_get_latest", remote_setup, hub_get_latest_run, remote_teardown},
+    {NULL, NULL, NULL, NULL},
+};
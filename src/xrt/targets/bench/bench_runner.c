@@ -0,0 +1,228 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Iteration control and statistics for the microbenchmarks.
+ * @author agent <agent@local>
+ */
+
+#include "os/os_time.h"
+#include "util/u_misc.h"
+
+#include "bench_common.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//! Two sided 95% quantile of the normal distribution.
+#define BENCH_Z_95 1.959964
+
+//! Never grow the batch by more than this in one step, timings of tiny batches are noisy.
+#define BENCH_MAX_GROWTH 10.0
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static int
+compare_double(const void *a, const void *b)
+{
+	double da = *(const double *)a;
+	double db = *(const double *)b;
+
+	return (da > db) - (da < db);
+}
+
+static uint64_t
+time_batch(const struct bench_case *bc, void *ctx, uint64_t iterations)
+{
+	uint64_t then_ns = os_monotonic_get_ns();
+	bc->run(ctx, iterations);
+	return os_monotonic_get_ns() - then_ns;
+}
+
+/*!
+ * Scale the batch so that it takes about @p target_ns, based on how long the
+ * last one took.
+ */
+static uint64_t
+next_batch_size(uint64_t iterations, uint64_t took_ns, uint64_t target_ns)
+{
+	double scale = BENCH_MAX_GROWTH;
+	if (took_ns > 0) {
+		// Aim a bit higher so we do not end up just under the target.
+		scale = fmin(1.2 * (double)target_ns / (double)took_ns, BENCH_MAX_GROWTH);
+	}
+
+	uint64_t next = (uint64_t)ceil((double)iterations * scale);
+	return next > iterations ? next : iterations + 1;
+}
+
+/*!
+ * Is the confidence interval of the median narrow enough, avoids sorting for
+ * every sample by only checking now and then.
+ */
+static bool
+is_precise_enough(const struct bench_config *config, const double *samples, uint32_t count, double *scratch)
+{
+	if (count < config->min_samples || count % 8 != 0) {
+		return false;
+	}
+
+	struct bench_stats stats;
+	memcpy(scratch, samples, sizeof(double) * count);
+	bench_compute_stats(scratch, count, &stats);
+
+	return (stats.ci_high_ns - stats.ci_low_ns) * 0.5 <= stats.median_ns * config->precision;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+void
+bench_sort_samples(double *samples, uint32_t sample_count)
+{
+	qsort(samples, sample_count, sizeof(double), compare_double);
+}
+
+double
+bench_percentile_sorted(const double *sorted, uint32_t count, double p)
+{
+	if (count == 0) {
+		return 0.0;
+	}
+
+	double pos = p * (double)(count - 1);
+	uint32_t i = (uint32_t)pos;
+	if (i + 1 >= count) {
+		return sorted[count - 1];
+	}
+
+	double frac = pos - (double)i;
+	return sorted[i] + (sorted[i + 1] - sorted[i]) * frac;
+}
+
+void
+bench_compute_stats(double *samples, uint32_t sample_count, struct bench_stats *out_stats)
+{
+	U_ZERO(out_stats);
+	out_stats->sample_count = sample_count;
+
+	if (sample_count == 0) {
+		return;
+	}
+
+	bench_sort_samples(samples, sample_count);
+
+	double sum = 0.0;
+	for (uint32_t i = 0; i < sample_count; i++) {
+		sum += samples[i];
+	}
+	double mean = sum / (double)sample_count;
+
+	double sq_sum = 0.0;
+	for (uint32_t i = 0; i < sample_count; i++) {
+		sq_sum += (samples[i] - mean) * (samples[i] - mean);
+	}
+
+	double median = bench_percentile_sorted(samples, sample_count, 0.5);
+	double q1 = bench_percentile_sorted(samples, sample_count, 0.25);
+	double q3 = bench_percentile_sorted(samples, sample_count, 0.75);
+	double fence = 1.5 * (q3 - q1);
+
+	uint32_t outliers = 0;
+	for (uint32_t i = 0; i < sample_count; i++) {
+		if (samples[i] < q1 - fence || samples[i] > q3 + fence) {
+			outliers++;
+		}
+	}
+
+	/*
+	 * Distribution free confidence interval for the median, from the order
+	 * statistics, the rank of the median is binomially distributed.
+	 */
+	double half_width = BENCH_Z_95 * sqrt((double)sample_count) * 0.5;
+	double low_rank = floor((double)sample_count * 0.5 - half_width);
+	double high_rank = ceil((double)sample_count * 0.5 + half_width);
+	uint32_t low = (uint32_t)fmax(low_rank, 0.0);
+	uint32_t high = (uint32_t)fmin(high_rank, (double)(sample_count - 1));
+
+	out_stats->median_ns = median;
+	out_stats->mean_ns = mean;
+	out_stats->stddev_ns = sample_count > 1 ? sqrt(sq_sum / (double)(sample_count - 1)) : 0.0;
+	out_stats->min_ns = samples[0];
+	out_stats->max_ns = samples[sample_count - 1];
+	out_stats->ci_low_ns = samples[low];
+	out_stats->ci_high_ns = samples[high];
+	out_stats->outlier_count = outliers;
+
+	// Reuse the samples for the absolute deviations, they are not needed anymore.
+	for (uint32_t i = 0; i < sample_count; i++) {
+		samples[i] = fabs(samples[i] - median);
+	}
+	bench_sort_samples(samples, sample_count);
+	out_stats->mad_ns = bench_percentile_sorted(samples, sample_count, 0.5);
+}
+
+bool
+bench_run_case(const struct bench_config *config, const struct bench_case *bc, struct bench_stats *out_stats)
+{
+	void *ctx = bc->setup();
+	if (ctx == NULL) {
+		return false;
+	}
+
+	/*
+	 * Warm up caches, branch predictors and CPU clocks, this also finds how
+	 * many iterations are needed to fill out a sample.
+	 */
+	uint64_t iterations = 1;
+	uint64_t warmup_start_ns = os_monotonic_get_ns();
+	while (true) {
+		uint64_t took_ns = time_batch(bc, ctx, iterations);
+		bool warm = os_monotonic_get_ns() - warmup_start_ns >= config->warmup_ns;
+
+		if (took_ns >= config->sample_ns && warm) {
+			break;
+		}
+		if (took_ns < config->sample_ns) {
+			iterations = next_batch_size(iterations, took_ns, config->sample_ns);
+		}
+	}
+
+	double *samples = U_TYPED_ARRAY_CALLOC(double, config->max_samples);
+	double *scratch = U_TYPED_ARRAY_CALLOC(double, config->max_samples);
+	uint32_t count = 0;
+
+	uint64_t start_ns = os_monotonic_get_ns();
+	while (count < config->max_samples) {
+		uint64_t took_ns = time_batch(bc, ctx, iterations);
+		samples[count++] = (double)took_ns / (double)iterations;
+
+		if (is_precise_enough(config, samples, count, scratch)) {
+			break;
+		}
+		if (count >= config->min_samples && os_monotonic_get_ns() - start_ns >= config->max_time_ns) {
+			break;
+		}
+	}
+
+	bc->teardown(ctx);
+
+	bench_compute_stats(samples, count, out_stats);
+	out_stats->iterations_per_sample = iterations;
+
+	free(scratch);
+	free(samples);
+
+	return true;
+}
@@ -0,0 +1,457 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Microbenchmarks for the util helpers.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_frame.h"
+#include "xrt/xrt_space.h"
+#include "xrt/xrt_tracking.h"
+#include "util/u_frame.h"
+#include "util/u_hashset.h"
+#include "util/u_misc.h"
+#include "util/u_pacing.h"
+#include "util/u_sink.h"
+#include "util/u_space_overseer.h"
+#include "util/u_time.h"
+#include "util/u_trace_marker.h"
+
+#include "bench_common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//! Display period used for the pacing benchmarks, 90Hz.
+#define FRAME_PERIOD_NS ((uint64_t)(U_TIME_1S_IN_NS / 90))
+
+//! Number of strings in the hashset, about the number of paths in a few interaction profiles.
+#define HASHSET_ITEM_COUNT 256
+
+
+/*
+ *
+ * u_space_overseer
+ *
+ */
+
+struct space_overseer_ctx
+{
+	struct xrt_device xdev;
+	struct xrt_tracking_origin origin;
+	struct xrt_space_overseer *xso;
+	struct xrt_space_relation out;
+	uint64_t at_ns;
+};
+
+static void
+space_overseer_get_tracked_pose(struct xrt_device *xdev,
+                                enum xrt_input_name name,
+                                uint64_t at_timestamp_ns,
+                                struct xrt_space_relation *out_relation)
+{
+	struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+	rel.relation_flags = XRT_SPACE_RELATION_BITMASK_ALL;
+	rel.pose.orientation.w = 1.0f;
+	rel.pose.position.y = 1.6f;
+
+	*out_relation = rel;
+}
+
+static void *
+space_overseer_setup(void)
+{
+	struct space_overseer_ctx *ctx = U_TYPED_CALLOC(struct space_overseer_ctx);
+
+	// Just enough of a device for the space overseer.
+	snprintf(ctx->origin.name, sizeof(ctx->origin.name), "Bench");
+	ctx->origin.type = XRT_TRACKING_TYPE_OTHER;
+	ctx->origin.offset.orientation.w = 1.0f;
+	ctx->origin.offset.position.z = -0.5f;
+
+	snprintf(ctx->xdev.str, sizeof(ctx->xdev.str), "Bench HMD");
+	ctx->xdev.device_type = XRT_DEVICE_TYPE_HMD;
+	ctx->xdev.tracking_origin = &ctx->origin;
+	ctx->xdev.get_tracked_pose = space_overseer_get_tracked_pose;
+
+	struct u_space_overseer *uso = u_space_overseer_create();
+	struct xrt_device *xdevs[1] = {&ctx->xdev};
+	struct xrt_pose local_offset = {{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 1.6f, 0.0f}};
+	u_space_overseer_legacy_setup(uso, xdevs, 1, &ctx->xdev, &local_offset);
+
+	ctx->xso = (struct xrt_space_overseer *)uso;
+
+	return ctx;
+}
+
+static void
+space_overseer_run_view_in_local(void *ptr, uint64_t iterations)
+{
+	struct space_overseer_ctx *ctx = (struct space_overseer_ctx *)ptr;
+	struct xrt_pose identity = XRT_POSE_IDENTITY;
+
+	// What xrLocateViews does, the view space in the local space.
+	for (uint64_t i = 0; i < iterations; i++) {
+		ctx->at_ns += FRAME_PERIOD_NS;
+		xrt_space_overseer_locate_space( //
+		    ctx->xso,                    //
+		    ctx->xso->semantic.local,    //
+		    &identity,                   //
+		    ctx->at_ns,                  //
+		    ctx->xso->semantic.view,     //
+		    &identity,                   //
+		    &ctx->out);                  //
+	}
+}
+
+static void
+space_overseer_teardown(void *ptr)
+{
+	struct space_overseer_ctx *ctx = (struct space_overseer_ctx *)ptr;
+	xrt_space_overseer_destroy(&ctx->xso);
+	free(ctx);
+}
+
+
+/*
+ *
+ * u_pacing_app
+ *
+ */
+
+struct pacing_app_ctx
+{
+	struct u_pacing_app_factory *upaf;
+	struct u_pacing_app *upa;
+	uint64_t now_ns;
+};
+
+static void *
+pacing_app_setup(void)
+{
+	struct pacing_app_ctx *ctx = U_TYPED_CALLOC(struct pacing_app_ctx);
+
+	if (u_pa_factory_create(&ctx->upaf) != XRT_SUCCESS) {
+		free(ctx);
+		return NULL;
+	}
+
+	u_paf_create(ctx->upaf, &ctx->upa);
+
+	ctx->now_ns = U_TIME_1S_IN_NS;
+
+	return ctx;
+}
+
+static void
+pacing_app_run_frame(void *ptr, uint64_t iterations)
+{
+	struct pacing_app_ctx *ctx = (struct pacing_app_ctx *)ptr;
+
+	// One whole app frame per iteration, on a simulated clock.
+	for (uint64_t i = 0; i < iterations; i++) {
+		int64_t frame_id = -1;
+		uint64_t wake_up_time_ns = 0;
+		uint64_t predicted_display_time_ns = 0;
+		uint64_t predicted_display_period_ns = 0;
+
+		// What the compositor tells the app pacer every frame.
+		u_pa_info(ctx->upa, ctx->now_ns + FRAME_PERIOD_NS * 2, FRAME_PERIOD_NS, U_TIME_1MS_IN_NS);
+
+		u_pa_predict(ctx->upa, ctx->now_ns, &frame_id, &wake_up_time_ns, &predicted_display_time_ns,
+		             &predicted_display_period_ns);
+
+		ctx->now_ns = wake_up_time_ns > ctx->now_ns ? wake_up_time_ns : ctx->now_ns;
+		u_pa_mark_point(ctx->upa, frame_id, U_TIMING_POINT_WAKE_UP, ctx->now_ns);
+
+		ctx->now_ns += U_TIME_1MS_IN_NS;
+		u_pa_mark_point(ctx->upa, frame_id, U_TIMING_POINT_BEGIN, ctx->now_ns);
+
+		ctx->now_ns += U_TIME_1MS_IN_NS * 4;
+		u_pa_mark_delivered(ctx->upa, frame_id, ctx->now_ns, predicted_display_time_ns);
+
+		ctx->now_ns += U_TIME_1MS_IN_NS * 2;
+		u_pa_mark_gpu_done(ctx->upa, frame_id, ctx->now_ns);
+		u_pa_latched(ctx->upa, frame_id, ctx->now_ns, frame_id);
+		u_pa_retired(ctx->upa, frame_id, ctx->now_ns);
+	}
+}
+
+static void
+pacing_app_teardown(void *ptr)
+{
+	struct pacing_app_ctx *ctx = (struct pacing_app_ctx *)ptr;
+	u_pa_destroy(&ctx->upa);
+	u_paf_destroy(&ctx->upaf);
+	free(ctx);
+}
+
+
+/*
+ *
+ * u_pacing_compositor
+ *
+ */
+
+struct pacing_compositor_ctx
+{
+	struct u_pacing_compositor *upc;
+	uint64_t now_ns;
+};
+
+static void *
+pacing_compositor_setup(void)
+{
+	struct pacing_compositor_ctx *ctx = U_TYPED_CALLOC(struct pacing_compositor_ctx);
+	ctx->now_ns = U_TIME_1S_IN_NS;
+
+	if (u_pc_fake_create(FRAME_PERIOD_NS, ctx->now_ns, &ctx->upc) != XRT_SUCCESS) {
+		free(ctx);
+		return NULL;
+	}
+
+	return ctx;
+}
+
+static void
+pacing_compositor_run_frame(void *ptr, uint64_t iterations)
+{
+	struct pacing_compositor_ctx *ctx = (struct pacing_compositor_ctx *)ptr;
+
+	// One whole compositor frame per iteration, on a simulated clock.
+	for (uint64_t i = 0; i < iterations; i++) {
+		int64_t frame_id = -1;
+		uint64_t wake_up_time_ns = 0;
+		uint64_t desired_present_time_ns = 0;
+		uint64_t present_slop_ns = 0;
+		uint64_t predicted_display_time_ns = 0;
+		uint64_t predicted_display_period_ns = 0;
+		uint64_t min_display_period_ns = 0;
+
+		u_pc_predict(ctx->upc, ctx->now_ns, &frame_id, &wake_up_time_ns, &desired_present_time_ns,
+		             &present_slop_ns, &predicted_display_time_ns, &predicted_display_period_ns,
+		             &min_display_period_ns);
+
+		ctx->now_ns = wake_up_time_ns > ctx->now_ns ? wake_up_time_ns : ctx->now_ns;
+		u_pc_mark_point(ctx->upc, U_TIMING_POINT_WAKE_UP, frame_id, ctx->now_ns);
+
+		ctx->now_ns += U_TIME_1MS_IN_NS / 2;
+		u_pc_mark_point(ctx->upc, U_TIMING_POINT_BEGIN, frame_id, ctx->now_ns);
+
+		ctx->now_ns += U_TIME_1MS_IN_NS;
+		u_pc_mark_point(ctx->upc, U_TIMING_POINT_SUBMIT, frame_id, ctx->now_ns);
+
+		ctx->now_ns = desired_present_time_ns > ctx->now_ns ? desired_present_time_ns : ctx->now_ns;
+		u_pc_info(ctx->upc, frame_id, desired_present_time_ns, ctx->now_ns, ctx->now_ns, 0, ctx->now_ns);
+
+		// Like a target with display control, without it the fake pacer steps from the first frame.
+		u_pc_update_vblank_from_display_control(ctx->upc, ctx->now_ns);
+	}
+}
+
+static void
+pacing_compositor_teardown(void *ptr)
+{
+	struct pacing_compositor_ctx *ctx = (struct pacing_compositor_ctx *)ptr;
+	u_pc_destroy(&ctx->upc);
+	free(ctx);
+}
+
+
+/*
+ *
+ * u_sink_converter
+ *
+ */
+
+struct sink_converter_ctx
+{
+	struct xrt_frame_context xfctx;
+	struct xrt_frame_sink downstream;
+	struct xrt_frame_sink *converter;
+	struct xrt_frame *frame;
+	uint64_t received;
+};
+
+static void
+sink_converter_downstream_push(struct xrt_frame_sink *xfs, struct xrt_frame *xf)
+{
+	struct sink_converter_ctx *ctx = container_of(xfs, struct sink_converter_ctx, downstream);
+	ctx->received++;
+}
+
+static void *
+sink_converter_setup(void)
+{
+	struct sink_converter_ctx *ctx = U_TYPED_CALLOC(struct sink_converter_ctx);
+	ctx->downstream.push_frame = sink_converter_downstream_push;
+
+	// What a typical UVC camera gives us, converted for the trackers.
+	u_sink_create_to_r8g8b8_or_l8(&ctx->xfctx, &ctx->downstream, &ctx->converter);
+	u_frame_create_one_off(XRT_FORMAT_YUYV422, 1280, 720, &ctx->frame);
+
+	for (uint32_t y = 0; y < ctx->frame->height; y++) {
+		memset(ctx->frame->data + y * ctx->frame->stride, (int)(y & 0xff), ctx->frame->stride);
+	}
+
+	return ctx;
+}
+
+static void
+sink_converter_run_yuyv_to_rgb(void *ptr, uint64_t iterations)
+{
+	struct sink_converter_ctx *ctx = (struct sink_converter_ctx *)ptr;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		ctx->frame->timestamp += FRAME_PERIOD_NS;
+		xrt_sink_push_frame(ctx->converter, ctx->frame);
+	}
+}
+
+static void
+sink_converter_teardown(void *ptr)
+{
+	struct sink_converter_ctx *ctx = (struct sink_converter_ctx *)ptr;
+	xrt_frame_reference(&ctx->frame, NULL);
+	xrt_frame_context_destroy_nodes(&ctx->xfctx);
+	free(ctx);
+}
+
+
+/*
+ *
+ * u_hashset
+ *
+ */
+
+struct hashset_ctx
+{
+	struct u_hashset *hs;
+	char names[HASHSET_ITEM_COUNT][64];
+	struct u_hashset_item *found;
+};
+
+static void
+hashset_free_item(struct u_hashset_item *item, void *priv)
+{
+	free(item);
+}
+
+static void *
+hashset_setup(void)
+{
+	struct hashset_ctx *ctx = U_TYPED_CALLOC(struct hashset_ctx);
+
+	if (u_hashset_create(&ctx->hs) != 0) {
+		free(ctx);
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < HASHSET_ITEM_COUNT; i++) {
+		snprintf(ctx->names[i], sizeof(ctx->names[i]), "/user/hand/%s/input/button_%u/click",
+		         (i & 1) ? "left" : "right", i);
+
+		struct u_hashset_item *item = NULL;
+		u_hashset_create_and_insert_str_c(ctx->hs, ctx->names[i], &item);
+	}
+
+	return ctx;
+}
+
+static void
+hashset_run_find(void *ptr, uint64_t iterations)
+{
+	struct hashset_ctx *ctx = (struct hashset_ctx *)ptr;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		u_hashset_find_c_str(ctx->hs, ctx->names[i % HASHSET_ITEM_COUNT], &ctx->found);
+	}
+}
+
+static void
+hashset_teardown(void *ptr)
+{
+	struct hashset_ctx *ctx = (struct hashset_ctx *)ptr;
+	u_hashset_clear_and_call_for_each(ctx->hs, hashset_free_item, NULL);
+	u_hashset_destroy(&ctx->hs);
+	free(ctx);
+}
+
+
+#ifdef XRT_FEATURE_TRACING_RECORDER
+
+/*
+ *
+ * u_trace_recorder
+ *
+ */
+
+struct trace_recorder_ctx
+{
+	bool enabled;
+};
+
+static void *
+trace_recorder_setup_enabled(void)
+{
+	struct trace_recorder_ctx *ctx = U_TYPED_CALLOC(struct trace_recorder_ctx);
+	ctx->enabled = true;
+	return ctx;
+}
+
+static void *
+trace_recorder_setup_disabled(void)
+{
+	return U_TYPED_CALLOC(struct trace_recorder_ctx);
+}
+
+static void
+trace_recorder_run_scope(void *ptr, uint64_t iterations)
+{
+	struct trace_recorder_ctx *ctx = (struct trace_recorder_ctx *)ptr;
+
+	u_trace_recorder_set_enabled(ctx->enabled);
+
+	// What every COMP_TRACE_MARKER and friends cost.
+	for (uint64_t i = 0; i < iterations; i++) {
+		U_TRACE_IDENT(bench, scope);
+	}
+}
+
+static void
+trace_recorder_teardown(void *ptr)
+{
+	// Like the other benchmarks, u_trace_marker_init is never called.
+	u_trace_recorder_set_enabled(false);
+	free(ptr);
+}
+
+#endif
+
+
+/*
+ *
+ * 'Exported' list.
+ *
+ */
+
+const struct bench_case bench_util_cases[] = {
+    {"util/space_overseer_locate_view_in_local", space_overseer_setup, space_overseer_run_view_in_local,
+     space_overseer_teardown},
+    {"util/pacing_app_frame", pacing_app_setup, pacing_app_run_frame, pacing_app_teardown},
+    {"util/pacing_compositor_frame", pacing_compositor_setup, pacing_compositor_run_frame,
+     pacing_compositor_teardown},
+    {"util/sink_converter_yuyv_to_r8g8b8_720p", sink_converter_setup, sink_converter_run_yuyv_to_rgb,
+     sink_converter_teardown},
+    {"util/hashset_find", hashset_setup, hashset_run_find, hashset_teardown},
+#ifdef XRT_FEATURE_TRACING_RECORDER
+    {"util/trace_recorder_scope", trace_recorder_setup_enabled, trace_recorder_run_scope, trace_recorder_teardown},
+    {"util/trace_recorder_scope_disabled", trace_recorder_setup_disabled, trace_recorder_run_scope,
+     trace_recorder_teardown},
+#endif
+    {NULL, NULL, NULL, NULL},
+};
@@ -0,0 +1,188 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Microbenchmarks for the lighthouse solver, one base station
+ *         sweeping a device that holds still.
+ * @author agent <agent@local>
+ */
+
+#include "math/m_api.h"
+#include "math/m_mathinclude.h"
+#include "util/u_misc.h"
+#include "util/u_time.h"
+#include "vive/vive_config.h"
+#include "vive/vive_lighthouse.h"
+#include "vive/vive_lighthouse_solver.h"
+
+#include "bench_common.h"
+
+#include <stdlib.h>
+
+
+//! Sensors on the front of the device, like a headset.
+#define SENSOR_COUNT 20
+
+//! Ticks between two sync pulses of a base station, each sweeps one rotor.
+#define SYNC_PERIOD_TICKS 400000
+
+#define NS_PER_TICK (1e9 / 48e6)
+
+
+struct vive_ctx
+{
+	struct lh_sensor sensors[SENSOR_COUNT];
+	struct lighthouse_solver *solver;
+
+	//! Zero calibration, the solver only reads the rotor phase.
+	struct lighthouse_base base;
+
+	//! What the decoder hands over for each rotor.
+	struct lighthouse_frame frames[2];
+
+	//! Watchman clock, wraps like the real one, and system time of the next sync.
+	uint32_t ticks;
+	timepoint_ns ns;
+
+	struct xrt_space_relation relation;
+};
+
+static void
+make_sensors(struct vive_ctx *ctx)
+{
+	for (uint32_t i = 0; i < SENSOR_COUNT; i++) {
+		double theta = (-80.0 + 160.0 * i / (SENSOR_COUNT - 1)) * M_PI / 180.0;
+		double phi = ((i % 2) ? 25.0 : -25.0) * M_PI / 180.0;
+
+		struct xrt_vec3 dir = {
+		    (float)(sin(theta) * cos(phi)),
+		    (float)sin(phi),
+		    (float)(-cos(theta) * cos(phi)),
+		};
+
+		ctx->sensors[i].pos = (struct xrt_vec3){dir.x * 0.09f, dir.y * 0.09f, dir.z * 0.09f};
+		ctx->sensors[i].normal = dir;
+	}
+}
+
+/*!
+ * The sweeps of a device at the origin, seen by a base station 2.5 meters in
+ * front of it and turned around to face it.
+ */
+static void
+make_frames(struct vive_ctx *ctx)
+{
+	struct xrt_pose base = {{0.0f, 1.0f, 0.0f, 0.0f}, {0.3f, 0.2f, -2.5f}};
+	struct xrt_pose inv_base;
+	math_pose_invert(&base, &inv_base);
+
+	for (uint32_t rotor = 0; rotor < 2; rotor++) {
+		struct lighthouse_frame *frame = &ctx->frames[rotor];
+
+		for (uint32_t id = 0; id < SENSOR_COUNT; id++) {
+			struct xrt_vec3 p;
+			struct xrt_vec3 n;
+			math_pose_transform_point(&inv_base, &ctx->sensors[id].pos, &p);
+			math_quat_rotate_vec3(&inv_base.orientation, &ctx->sensors[id].normal, &n);
+
+			// Facing the base station, which is at the origin of its own space.
+			if (n.x * -p.x + n.y * -p.y + n.z * -p.z <= 0.0f) {
+				continue;
+			}
+
+			double angle = rotor == 0 ? atan2(p.x, -p.z) : atan2(p.y, -p.z);
+			uint16_t duration = (uint16_t)(150 + (id % 5) * 20);
+			double ticks_per_rad = LIGHTHOUSE_TICKS_PER_REVOLUTION / (2.0 * M_PI);
+			double center = LIGHTHOUSE_TICKS_CENTER + angle * ticks_per_rad;
+
+			frame->sweep_ids |= 1u << id;
+			frame->sweep_offset[id] = (uint32_t)(center - duration / 2.0);
+			frame->sweep_duration[id] = duration;
+		}
+	}
+}
+
+//! One IMU sample in the middle of the sweep and then the sweep itself.
+static void
+push_sweep(struct vive_ctx *ctx, uint32_t rotor)
+{
+	struct xrt_quat identity = XRT_QUAT_IDENTITY;
+	uint32_t imu_ticks = ctx->ticks + LIGHTHOUSE_TICKS_CENTER;
+	timepoint_ns imu_ns = ctx->ns + (timepoint_ns)(LIGHTHOUSE_TICKS_CENTER * NS_PER_TICK);
+
+	lighthouse_solver_push_imu(ctx->solver, imu_ticks, imu_ns, &identity, &ctx->relation);
+
+	ctx->frames[rotor].sync_timestamp = ctx->ticks;
+	lighthouse_solver_push_frame(ctx->solver, 0, &ctx->base, rotor, &ctx->frames[rotor]);
+
+	ctx->ticks += SYNC_PERIOD_TICKS;
+	ctx->ns += (timepoint_ns)(SYNC_PERIOD_TICKS * NS_PER_TICK);
+}
+
+static void
+vive_teardown(void *ptr)
+{
+	struct vive_ctx *ctx = (struct vive_ctx *)ptr;
+
+	lighthouse_solver_destroy(&ctx->solver);
+	free(ctx);
+}
+
+static void *
+vive_setup(void)
+{
+	struct vive_ctx *ctx = U_TYPED_CALLOC(struct vive_ctx);
+
+	make_sensors(ctx);
+	make_frames(ctx);
+
+	ctx->solver = lighthouse_solver_create(ctx->sensors, SENSOR_COUNT);
+	if (ctx->solver == NULL) {
+		free(ctx);
+		return NULL;
+	}
+
+	// Both rotors once, the second sweep places the base station.
+	ctx->ticks = 1000000;
+	ctx->ns = U_TIME_1S_IN_NS;
+	push_sweep(ctx, 0);
+	push_sweep(ctx, 1);
+
+	struct lighthouse_solver_stats stats;
+	lighthouse_solver_get_stats(ctx->solver, &stats);
+	if (!stats.base_known[0]) {
+		vive_teardown(ctx);
+		return NULL;
+	}
+
+	return ctx;
+}
+
+
+/*
+ *
+ * Solves, the rotors take turns like they do with a single base station.
+ *
+ */
+
+static void
+solver_sweep_run(void *ptr, uint64_t iterations)
+{
+	struct vive_ctx *ctx = (struct vive_ctx *)ptr;
+
+	for (uint64_t i = 0; i < iterations; i++) {
+		push_sweep(ctx, (uint32_t)(i % 2));
+	}
+}
+
+
+/*
+ *
+ * 'Exported' list.
+ *
+ */
+
+const struct bench_case bench_vive_cases[] = {
+    {"vive/solver_sweep_20_sensors", vive_setup, solver_sweep_run, vive_teardown},
+    {NULL, NULL, NULL, NULL},
+};
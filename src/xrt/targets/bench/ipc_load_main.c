@@ -0,0 +1,737 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Multi-client frame loop load harness over the real IPC transport,
+ *         the service runs in-process with the null compositor.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_compositor.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_instance.h"
+#include "xrt/xrt_space.h"
+#include "xrt/xrt_system.h"
+
+#include "os/os_threading.h"
+#include "os/os_time.h"
+
+#include "util/u_git_tag.h"
+#include "util/u_json.h"
+#include "util/u_misc.h"
+#include "util/u_time.h"
+
+#include "server/ipc_server.h"
+#include "shared/ipc_protocol.h"
+
+#include "bench_common.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+#define P(...) fprintf(stderr, __VA_ARGS__)
+
+//! Bumped when the layout of the json output changes.
+#define LOAD_JSON_VERSION 1
+
+//! How many different client counts can be given to --clients.
+#define LOAD_MAX_ROUNDS 16
+
+
+xrt_result_t
+ipc_instance_create(struct xrt_instance_info *i_info, struct xrt_instance **out_xinst);
+
+
+/*
+ *
+ * Structs.
+ *
+ */
+
+//! The calls an application makes every frame, each one is timed separately.
+enum load_call
+{
+	LOAD_CALL_WAIT_FRAME,
+	LOAD_CALL_BEGIN_FRAME,
+	LOAD_CALL_POLL_EVENTS,
+	LOAD_CALL_SYNC_ACTIONS,
+	LOAD_CALL_LOCATE,
+	LOAD_CALL_END_FRAME,
+	LOAD_CALL_COUNT,
+};
+
+static const char *load_call_names[LOAD_CALL_COUNT] = {
+    "wait_frame", "begin_frame", "poll_events", "sync_actions", "locate", "end_frame",
+};
+
+struct load_options
+{
+	uint32_t client_counts[LOAD_MAX_ROUNDS];
+	uint32_t round_count;
+
+	//! How long each round runs the frame loop for.
+	uint64_t duration_ns;
+
+	//! Simulated application work between begin and end frame.
+	uint64_t work_ns;
+
+	const char *json_path;
+};
+
+//! Growable array of latencies in nanoseconds.
+struct load_samples
+{
+	double *ns;
+	uint32_t count;
+	uint32_t capacity;
+};
+
+//! One synthetic application, with its own connection to the service.
+struct load_client
+{
+	uint32_t index;
+
+	struct xrt_instance *xinst;
+	struct xrt_system_devices *xsysd;
+	struct xrt_space_overseer *xso;
+	struct xrt_system_compositor *xsysc;
+	struct xrt_compositor_native *xcn;
+
+	struct os_thread thread;
+
+	//! Run the frame loop until this time.
+	uint64_t end_ns;
+
+	//! Simulated application work per frame.
+	uint64_t work_ns;
+
+	struct load_samples samples[LOAD_CALL_COUNT];
+
+	uint64_t frame_count;
+	//! Display periods that passed without a frame from this client.
+	uint64_t missed_count;
+
+	bool failed;
+};
+
+//! The in-process service.
+struct load_server
+{
+	struct ipc_server *server;
+	struct os_thread thread;
+	struct os_semaphore started;
+	int ret;
+};
+
+//! Results of one call type for one round, times in nanoseconds.
+struct load_call_stats
+{
+	uint32_t count;
+	double p50_ns;
+	double p90_ns;
+	double p99_ns;
+	double max_ns;
+};
+
+struct load_round
+{
+	uint32_t client_count;
+	uint64_t frame_count;
+	uint64_t missed_count;
+	double duration_s;
+
+	struct load_call_stats calls[LOAD_CALL_COUNT];
+};
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static int
+print_help(const char *name)
+{
+	P("Monado-IPC-Load\n");
+	P("Usage: %s [options]\n", name);
+	P("\n");
+	P("Starts the service in-process with the null compositor and runs the frame\n");
+	P("loop of N synthetic clients against it over the real IPC transport.\n");
+	P("\n");
+	P("Options:\n");
+	P("  --clients <list>  - Comma separated client counts, one round each (default 1,2,4,8).\n");
+	P("  --seconds <s>     - How long each round runs (default 5).\n");
+	P("  --work-ms <ms>    - Simulated application work per frame (default 0).\n");
+	P("  --json <file>     - Write results as json to <file>, '-' for stdout.\n");
+
+	return 1;
+}
+
+static bool
+parse_u32(const char *str, uint32_t *out_value)
+{
+	char *end = NULL;
+	unsigned long value = strtoul(str, &end, 10);
+	if (end == str || *end != '\0' || value > UINT32_MAX) {
+		return false;
+	}
+
+	*out_value = (uint32_t)value;
+	return true;
+}
+
+static bool
+parse_client_counts(const char *str, struct load_options *opts)
+{
+	char buf[256];
+	snprintf(buf, sizeof(buf), "%s", str);
+
+	opts->round_count = 0;
+
+	char *saveptr = NULL;
+	for (char *tok = strtok_r(buf, ",", &saveptr); tok != NULL; tok = strtok_r(NULL, ",", &saveptr)) {
+		uint32_t count = 0;
+		if (opts->round_count >= LOAD_MAX_ROUNDS || !parse_u32(tok, &count)) {
+			return false;
+		}
+		if (count == 0 || count > IPC_MAX_CLIENTS) {
+			P("Client count must be between 1 and %i\n", IPC_MAX_CLIENTS);
+			return false;
+		}
+
+		opts->client_counts[opts->round_count++] = count;
+	}
+
+	return opts->round_count > 0;
+}
+
+static bool
+parse_args(int argc, const char **argv, struct load_options *opts)
+{
+	uint32_t seconds = 5;
+	uint32_t work_ms = 0;
+
+	parse_client_counts("1,2,4,8", opts);
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+		bool ok = true;
+
+		if (value == NULL) {
+			P("Missing value for '%s'\n\n", arg);
+			return false;
+		}
+
+		if (strcmp(arg, "--clients") == 0) {
+			ok = parse_client_counts(value, opts);
+		} else if (strcmp(arg, "--seconds") == 0) {
+			ok = parse_u32(value, &seconds) && seconds > 0;
+		} else if (strcmp(arg, "--work-ms") == 0) {
+			ok = parse_u32(value, &work_ms);
+		} else if (strcmp(arg, "--json") == 0) {
+			opts->json_path = value;
+		} else {
+			P("Unknown option '%s'\n\n", arg);
+			return false;
+		}
+
+		if (!ok) {
+			P("Invalid value '%s' for '%s'\n\n", value, arg);
+			return false;
+		}
+
+		i++;
+	}
+
+	opts->duration_ns = seconds * (uint64_t)U_TIME_1S_IN_NS;
+	opts->work_ns = work_ms * (uint64_t)U_TIME_1MS_IN_NS;
+
+	return true;
+}
+
+static void
+samples_push(struct load_samples *s, uint64_t ns)
+{
+	if (s->count >= s->capacity) {
+		s->capacity = s->capacity == 0 ? 1024 : s->capacity * 2;
+		U_ARRAY_REALLOC_OR_FREE(s->ns, double, s->capacity);
+	}
+
+	s->ns[s->count++] = (double)ns;
+}
+
+static bool
+write_json(const char *path, cJSON *root)
+{
+	char *str = cJSON_Print(root);
+	if (str == NULL) {
+		return false;
+	}
+
+	bool ret = true;
+	if (strcmp(path, "-") == 0) {
+		printf("%s\n", str);
+	} else {
+		FILE *file = fopen(path, "w");
+		if (file == NULL) {
+			P("Could not open '%s' for writing\n", path);
+			ret = false;
+		} else {
+			fprintf(file, "%s\n", str);
+			fclose(file);
+		}
+	}
+
+	cJSON_free(str);
+
+	return ret;
+}
+
+
+/*
+ *
+ * Server.
+ *
+ */
+
+static void
+server_startup_complete(void *ptr)
+{
+	struct load_server *ls = (struct load_server *)ptr;
+	os_semaphore_release(&ls->started);
+}
+
+static void *
+server_thread(void *ptr)
+{
+	struct load_server *ls = (struct load_server *)ptr;
+	ls->ret = ipc_server_main_in_process(&ls->server, server_startup_complete, ls);
+
+	return NULL;
+}
+
+static bool
+server_start(struct load_server *ls)
+{
+	os_semaphore_init(&ls->started, 0);
+	os_thread_init(&ls->thread);
+	os_thread_start(&ls->thread, server_thread, ls);
+
+	// The callback is always called, even if the startup failed.
+	os_semaphore_wait(&ls->started, 0);
+
+	// Set before the callback is called on success, never touched on failure.
+	return ls->server != NULL;
+}
+
+static void
+server_stop(struct load_server *ls)
+{
+	if (ls->server != NULL) {
+		ipc_server_handle_shutdown_signal(ls->server);
+	}
+
+	os_thread_join(&ls->thread);
+	os_thread_destroy(&ls->thread);
+	os_semaphore_destroy(&ls->started);
+}
+
+
+/*
+ *
+ * Client.
+ *
+ */
+
+static void
+client_destroy(struct load_client *lc)
+{
+	if (lc->xcn != NULL) {
+		xrt_comp_end_session(&lc->xcn->base);
+	}
+
+	xrt_comp_native_destroy(&lc->xcn);
+	xrt_space_overseer_destroy(&lc->xso);
+	xrt_syscomp_destroy(&lc->xsysc);
+	xrt_system_devices_destroy(&lc->xsysd);
+	xrt_instance_destroy(&lc->xinst);
+
+	for (uint32_t i = 0; i < LOAD_CALL_COUNT; i++) {
+		free(lc->samples[i].ns);
+	}
+	U_ZERO(lc);
+}
+
+/*!
+ * Does what the OpenXR state tracker does when an application creates an
+ * instance, system and session and then begins the session.
+ */
+static bool
+client_create(struct load_client *lc, uint32_t index)
+{
+	U_ZERO(lc);
+	lc->index = index;
+
+	struct xrt_instance_info ii = {0};
+	snprintf(ii.application_name, sizeof(ii.application_name), "ipc-load-%u", index);
+
+	xrt_result_t xret = ipc_instance_create(&ii, &lc->xinst);
+	if (xret != XRT_SUCCESS) {
+		P("Client %u: failed to connect to the service (%i)\n", index, xret);
+		return false;
+	}
+
+	xret = xrt_instance_create_system(lc->xinst, &lc->xsysd, &lc->xso, &lc->xsysc);
+	if (xret != XRT_SUCCESS) {
+		P("Client %u: failed to create system (%i)\n", index, xret);
+		client_destroy(lc);
+		return false;
+	}
+
+	struct xrt_session_info xsi = {0};
+	xret = xrt_syscomp_create_native_compositor(lc->xsysc, &xsi, &lc->xcn);
+	if (xret != XRT_SUCCESS) {
+		P("Client %u: failed to create session (%i)\n", index, xret);
+		client_destroy(lc);
+		return false;
+	}
+
+	struct xrt_begin_session_info begin_info = {0};
+	begin_info.view_type = XRT_VIEW_TYPE_STEREO;
+
+	xret = xrt_comp_begin_session(&lc->xcn->base, &begin_info);
+	if (xret != XRT_SUCCESS) {
+		P("Client %u: failed to begin session (%i)\n", index, xret);
+		client_destroy(lc);
+		return false;
+	}
+
+	return true;
+}
+
+static void
+client_locate(struct load_client *lc, uint64_t at_timestamp_ns)
+{
+	struct xrt_space_overseer *xso = lc->xso;
+	struct xrt_pose identity = XRT_POSE_IDENTITY;
+	struct xrt_space_relation rel;
+
+	// xrLocateViews is a locate of view in the application's base space.
+	xrt_space_overseer_locate_space(xso, xso->semantic.local, &identity, at_timestamp_ns, xso->semantic.view,
+	                                &identity, &rel);
+
+	// And the hand poses of the two controllers, if there are any.
+	struct xrt_device *hands[2] = {lc->xsysd->roles.left, lc->xsysd->roles.right};
+	for (uint32_t i = 0; i < ARRAY_SIZE(hands); i++) {
+		if (hands[i] == NULL) {
+			continue;
+		}
+		xrt_space_overseer_locate_device(xso, xso->semantic.local, &identity, at_timestamp_ns, hands[i],
+		                                 &rel);
+	}
+}
+
+static void
+client_sync_actions(struct load_client *lc)
+{
+	// xrSyncActions updates the inputs of all devices.
+	for (uint32_t i = 0; i < lc->xsysd->xdev_count; i++) {
+		xrt_device_update_inputs(lc->xsysd->xdevs[i]);
+	}
+}
+
+static void
+client_poll_events(struct load_client *lc)
+{
+	union xrt_compositor_event xce;
+
+	do {
+		U_ZERO(&xce);
+		if (xrt_comp_poll_events(&lc->xcn->base, &xce) != XRT_SUCCESS) {
+			break;
+		}
+	} while (xce.type != XRT_COMPOSITOR_EVENT_NONE);
+}
+
+static xrt_result_t
+client_end_frame(struct load_client *lc, int64_t frame_id, uint64_t display_time_ns)
+{
+	struct xrt_layer_frame_data data = {0};
+	data.frame_id = frame_id;
+	data.display_time_ns = display_time_ns;
+	data.env_blend_mode = XRT_BLEND_MODE_OPAQUE;
+
+	// No layers, the service does the same work per frame for the null compositor either way.
+	xrt_result_t xret = xrt_comp_layer_begin(&lc->xcn->base, &data);
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	return xrt_comp_layer_commit(&lc->xcn->base, XRT_GRAPHICS_SYNC_HANDLE_INVALID);
+}
+
+#define TIME_CALL(CALL, ...)                                                                                           \
+	do {                                                                                                           \
+		uint64_t then_ns = os_monotonic_get_ns();                                                              \
+		__VA_ARGS__;                                                                                           \
+		samples_push(&lc->samples[CALL], os_monotonic_get_ns() - then_ns);                                     \
+	} while (false)
+
+static void *
+client_thread(void *ptr)
+{
+	struct load_client *lc = (struct load_client *)ptr;
+	struct xrt_compositor *xc = &lc->xcn->base;
+	uint64_t last_display_time_ns = 0;
+	xrt_result_t xret = XRT_SUCCESS;
+
+	while (os_monotonic_get_ns() < lc->end_ns) {
+		int64_t frame_id = -1;
+		uint64_t display_time_ns = 0;
+		uint64_t display_period_ns = 0;
+
+		TIME_CALL(LOAD_CALL_WAIT_FRAME,
+		          xret = xrt_comp_wait_frame(xc, &frame_id, &display_time_ns, &display_period_ns));
+		if (xret != XRT_SUCCESS) {
+			break;
+		}
+
+		/*
+		 * Any display period skipped between two predicted display times
+		 * is a frame this client did not get out in time.
+		 */
+		if (last_display_time_ns != 0 && display_period_ns > 0 && display_time_ns > last_display_time_ns) {
+			uint64_t delta_ns = display_time_ns - last_display_time_ns;
+			uint64_t periods = (delta_ns + display_period_ns / 2) / display_period_ns;
+			lc->missed_count += periods > 1 ? periods - 1 : 0;
+		}
+		last_display_time_ns = display_time_ns;
+
+		TIME_CALL(LOAD_CALL_BEGIN_FRAME, xret = xrt_comp_begin_frame(xc, frame_id));
+		if (xret != XRT_SUCCESS) {
+			break;
+		}
+
+		TIME_CALL(LOAD_CALL_POLL_EVENTS, client_poll_events(lc));
+		TIME_CALL(LOAD_CALL_SYNC_ACTIONS, client_sync_actions(lc));
+		TIME_CALL(LOAD_CALL_LOCATE, client_locate(lc, display_time_ns));
+
+		// Rendering, as far as the service can tell.
+		if (lc->work_ns > 0) {
+			os_nanosleep((int64_t)lc->work_ns);
+		}
+
+		TIME_CALL(LOAD_CALL_END_FRAME, xret = client_end_frame(lc, frame_id, display_time_ns));
+		if (xret != XRT_SUCCESS) {
+			break;
+		}
+
+		lc->frame_count++;
+	}
+
+	if (xret != XRT_SUCCESS) {
+		P("Client %u: frame loop failed (%i)\n", lc->index, xret);
+		lc->failed = true;
+	}
+
+	return NULL;
+}
+
+#undef TIME_CALL
+
+
+/*
+ *
+ * Rounds.
+ *
+ */
+
+static void
+compute_call_stats(struct load_samples *all, struct load_call_stats *out_stats)
+{
+	bench_sort_samples(all->ns, all->count);
+
+	out_stats->count = all->count;
+	out_stats->p50_ns = bench_percentile_sorted(all->ns, all->count, 0.50);
+	out_stats->p90_ns = bench_percentile_sorted(all->ns, all->count, 0.90);
+	out_stats->p99_ns = bench_percentile_sorted(all->ns, all->count, 0.99);
+	out_stats->max_ns = all->count > 0 ? all->ns[all->count - 1] : 0.0;
+}
+
+static bool
+run_round(const struct load_options *opts, uint32_t client_count, struct load_round *out_round)
+{
+	struct load_client clients[IPC_MAX_CLIENTS];
+	uint32_t created = 0;
+	bool ok = true;
+
+	// Connect everybody first, so that all clients load the service for the whole round.
+	for (; created < client_count; created++) {
+		if (!client_create(&clients[created], created)) {
+			ok = false;
+			break;
+		}
+	}
+
+	uint64_t start_ns = os_monotonic_get_ns();
+	for (uint32_t i = 0; ok && i < client_count; i++) {
+		clients[i].end_ns = start_ns + opts->duration_ns;
+		clients[i].work_ns = opts->work_ns;
+		os_thread_init(&clients[i].thread);
+		os_thread_start(&clients[i].thread, client_thread, &clients[i]);
+	}
+
+	for (uint32_t i = 0; ok && i < client_count; i++) {
+		os_thread_join(&clients[i].thread);
+		os_thread_destroy(&clients[i].thread);
+	}
+
+	U_ZERO(out_round);
+	out_round->client_count = client_count;
+	out_round->duration_s = time_ns_to_s((int64_t)(os_monotonic_get_ns() - start_ns));
+
+	// Pool the samples of all clients per call.
+	for (uint32_t c = 0; ok && c < LOAD_CALL_COUNT; c++) {
+		struct load_samples all = {0};
+		for (uint32_t i = 0; i < client_count; i++) {
+			for (uint32_t k = 0; k < clients[i].samples[c].count; k++) {
+				samples_push(&all, (uint64_t)clients[i].samples[c].ns[k]);
+			}
+		}
+
+		compute_call_stats(&all, &out_round->calls[c]);
+		free(all.ns);
+	}
+
+	for (uint32_t i = 0; i < created; i++) {
+		out_round->frame_count += clients[i].frame_count;
+		out_round->missed_count += clients[i].missed_count;
+		ok = ok && !clients[i].failed;
+		client_destroy(&clients[i]);
+	}
+
+	return ok;
+}
+
+static double
+missed_rate(const struct load_round *round)
+{
+	uint64_t total = round->frame_count + round->missed_count;
+	return total > 0 ? (double)round->missed_count / (double)total : 0.0;
+}
+
+static void
+print_round(FILE *text, const struct load_round *round)
+{
+	double fps = (double)round->frame_count / (round->duration_s * (double)round->client_count);
+
+	fprintf(text, "\n%u client(s): %" PRIu64 " frames, %.1f fps per client, %" PRIu64 " missed (%.2f%%)\n",
+	        round->client_count, round->frame_count, fps, round->missed_count, missed_rate(round) * 100.0);
+	fprintf(text, "  %-14s %10s %10s %10s %10s %10s\n", "call", "count", "p50 us", "p90 us", "p99 us", "max us");
+
+	for (uint32_t c = 0; c < LOAD_CALL_COUNT; c++) {
+		const struct load_call_stats *cs = &round->calls[c];
+		fprintf(text, "  %-14s %10u %10.1f %10.1f %10.1f %10.1f\n", load_call_names[c], cs->count,
+		        cs->p50_ns / 1000.0, cs->p90_ns / 1000.0, cs->p99_ns / 1000.0, cs->max_ns / 1000.0);
+	}
+}
+
+static cJSON *
+round_to_json(const struct load_round *round)
+{
+	cJSON *obj = cJSON_CreateObject();
+	cJSON_AddNumberToObject(obj, "clients", round->client_count);
+	cJSON_AddNumberToObject(obj, "duration_s", round->duration_s);
+	cJSON_AddNumberToObject(obj, "frames", (double)round->frame_count);
+	cJSON_AddNumberToObject(obj, "missed_frames", (double)round->missed_count);
+	cJSON_AddNumberToObject(obj, "missed_rate", missed_rate(round));
+
+	cJSON *calls = cJSON_AddObjectToObject(obj, "calls");
+	for (uint32_t c = 0; c < LOAD_CALL_COUNT; c++) {
+		const struct load_call_stats *cs = &round->calls[c];
+		cJSON *call = cJSON_AddObjectToObject(calls, load_call_names[c]);
+		cJSON_AddNumberToObject(call, "count", cs->count);
+		cJSON_AddNumberToObject(call, "p50_ns", cs->p50_ns);
+		cJSON_AddNumberToObject(call, "p90_ns", cs->p90_ns);
+		cJSON_AddNumberToObject(call, "p99_ns", cs->p99_ns);
+		cJSON_AddNumberToObject(call, "max_ns", cs->max_ns);
+	}
+
+	return obj;
+}
+
+
+/*
+ *
+ * Main.
+ *
+ */
+
+int
+main(int argc, const char **argv)
+{
+	struct load_options opts = {0};
+	if (!parse_args(argc, argv, &opts)) {
+		return print_help(argv[0]);
+	}
+
+	/*
+	 * Use a private runtime dir so the socket and pid file do not clash with
+	 * a service that is already running, and always use the null compositor.
+	 */
+	char runtime_dir[] = "/tmp/monado-ipc-load-XXXXXX";
+	if (mkdtemp(runtime_dir) == NULL) {
+		P("Could not create a runtime dir\n");
+		return 1;
+	}
+	setenv("XDG_RUNTIME_DIR", runtime_dir, 1);
+	setenv("XRT_COMPOSITOR_NULL", "true", 1);
+
+	struct load_server ls = {0};
+	if (!server_start(&ls)) {
+		P("Failed to start the service (%i)\n", ls.ret);
+		server_stop(&ls);
+		rmdir(runtime_dir);
+		return 1;
+	}
+
+	// Keep stdout clean for the json.
+	FILE *text = opts.json_path != NULL && strcmp(opts.json_path, "-") == 0 ? stderr : stdout;
+
+	cJSON *root = cJSON_CreateObject();
+	cJSON_AddNumberToObject(root, "version", LOAD_JSON_VERSION);
+	cJSON_AddStringToObject(root, "git_tag", u_git_tag);
+	cJSON_AddNumberToObject(root, "duration_ns", (double)opts.duration_ns);
+	cJSON_AddNumberToObject(root, "work_ns", (double)opts.work_ns);
+	cJSON *rounds = cJSON_AddArrayToObject(root, "rounds");
+
+	bool ok = true;
+	for (uint32_t r = 0; ok && r < opts.round_count; r++) {
+		struct load_round round;
+		ok = run_round(&opts, opts.client_counts[r], &round);
+		if (!ok) {
+			P("Round with %u client(s) failed\n", opts.client_counts[r]);
+			break;
+		}
+
+		print_round(text, &round);
+		cJSON_AddItemToArray(rounds, round_to_json(&round));
+	}
+
+	if (ok && opts.json_path != NULL) {
+		ok = write_json(opts.json_path, root);
+	}
+
+	cJSON_Delete(root);
+
+	server_stop(&ls);
+	rmdir(runtime_dir);
+
+	return ok ? 0 : 1;
+}
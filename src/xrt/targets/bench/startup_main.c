@@ -0,0 +1,388 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Start-up timeline of the main compositor, created after a simulated
+ *         slow device driver either serially or overlapped with it.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_compositor.h"
+#include "xrt/xrt_device.h"
+
+#include "os/os_time.h"
+
+#include "util/u_git_tag.h"
+#include "util/u_json.h"
+#include "util/u_misc.h"
+#include "util/u_time.h"
+
+#include "main/comp_window.h"
+#include "main/comp_main_interface.h"
+
+#include "simulated/simulated_interface.h"
+
+#include "bench_common.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define P(...) fprintf(stderr, __VA_ARGS__)
+
+//! Bumped when the layout of the json output changes.
+#define STARTUP_JSON_VERSION 1
+
+
+/*
+ *
+ * Structs.
+ *
+ */
+
+enum startup_mode
+{
+	STARTUP_MODE_SERIAL,
+	STARTUP_MODE_OVERLAPPED,
+	STARTUP_MODE_COUNT,
+};
+
+static const char *startup_mode_names[STARTUP_MODE_COUNT] = {"serial", "overlapped"};
+
+struct startup_options
+{
+	uint32_t runs;
+
+	//! How long the simulated driver takes to probe and open the head.
+	uint64_t device_ns;
+
+	bool lavapipe;
+
+	const char *json_path;
+};
+
+//! One start-up, times are from the start of it.
+struct startup_timeline
+{
+	uint64_t devices_ready_ns;
+	uint64_t compositor_ready_ns;
+};
+
+//! Medians over all runs of one mode, in nanoseconds.
+struct startup_stats
+{
+	double devices_ready_ns;
+	double compositor_ready_ns;
+	//! How long the compositor kept start-up going after the devices were ready.
+	double compositor_after_devices_ns;
+};
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static int
+print_help(const char *name)
+{
+	P("Monado-Startup-Bench\n");
+	P("Usage: %s [options]\n", name);
+	P("\n");
+	P("Creates the main compositor, with the headless target, after a simulated\n");
+	P("slow device driver. Once serially and once with Vulkan brought up while\n");
+	P("the driver is still busy, and prints the timeline of both.\n");
+	P("\n");
+	P("Options:\n");
+	P("  --runs <n>        - Start-ups per mode, medians are reported (default 5).\n");
+	P("  --device-ms <ms>  - How long the simulated driver takes (default 500).\n");
+	P("  --lavapipe        - Use the lavapipe software Vulkan driver.\n");
+	P("  --json <file>     - Write results as json to <file>, '-' for stdout.\n");
+
+	return 1;
+}
+
+static bool
+parse_u32(const char *str, uint32_t *out_value)
+{
+	char *end = NULL;
+	unsigned long value = strtoul(str, &end, 10);
+	if (end == str || *end != '\0' || value > UINT32_MAX) {
+		return false;
+	}
+
+	*out_value = (uint32_t)value;
+	return true;
+}
+
+static bool
+parse_args(int argc, const char **argv, struct startup_options *opts)
+{
+	uint32_t device_ms = 500;
+
+	opts->runs = 5;
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+
+		if (strcmp(arg, "--lavapipe") == 0) {
+			opts->lavapipe = true;
+			continue;
+		}
+
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+		bool ok = true;
+
+		if (value == NULL) {
+			P("Missing value for '%s'\n\n", arg);
+			return false;
+		}
+
+		if (strcmp(arg, "--runs") == 0) {
+			ok = parse_u32(value, &opts->runs) && opts->runs > 0;
+		} else if (strcmp(arg, "--device-ms") == 0) {
+			ok = parse_u32(value, &device_ms);
+		} else if (strcmp(arg, "--json") == 0) {
+			opts->json_path = value;
+		} else {
+			P("Unknown option '%s'\n\n", arg);
+			return false;
+		}
+
+		if (!ok) {
+			P("Invalid value '%s' for '%s'\n\n", value, arg);
+			return false;
+		}
+
+		i++;
+	}
+
+	opts->device_ns = device_ms * (uint64_t)U_TIME_1MS_IN_NS;
+
+	return true;
+}
+
+//! Points the Vulkan loader at the lavapipe ICD, if one can be found.
+static bool
+use_lavapipe(void)
+{
+	static const char *dirs[] = {
+	    "/usr/share/vulkan/icd.d",
+	    "/usr/local/share/vulkan/icd.d",
+	    "/etc/vulkan/icd.d",
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(dirs); i++) {
+		DIR *dir = opendir(dirs[i]);
+		if (dir == NULL) {
+			continue;
+		}
+
+		struct dirent *entry = NULL;
+		while ((entry = readdir(dir)) != NULL) {
+			if (strncmp(entry->d_name, "lvp_icd", strlen("lvp_icd")) != 0) {
+				continue;
+			}
+
+			char path[1024];
+			snprintf(path, sizeof(path), "%s/%s", dirs[i], entry->d_name);
+			setenv("VK_ICD_FILENAMES", path, 1);
+			closedir(dir);
+
+			P("Using '%s'\n", path);
+			return true;
+		}
+
+		closedir(dir);
+	}
+
+	return false;
+}
+
+static bool
+write_json(const char *path, cJSON *root)
+{
+	char *str = cJSON_Print(root);
+	if (str == NULL) {
+		return false;
+	}
+
+	bool ret = true;
+	if (strcmp(path, "-") == 0) {
+		printf("%s\n", str);
+	} else {
+		FILE *file = fopen(path, "w");
+		if (file == NULL) {
+			P("Could not open '%s' for writing\n", path);
+			ret = false;
+		} else {
+			fprintf(file, "%s\n", str);
+			fclose(file);
+		}
+	}
+
+	cJSON_free(str);
+
+	return ret;
+}
+
+
+/*
+ *
+ * Start-up.
+ *
+ */
+
+//! The slow part of a driver, like waiting for a USB device to show up.
+static struct xrt_device *
+slow_device_create(const struct startup_options *opts)
+{
+	os_nanosleep((int64_t)opts->device_ns);
+
+	struct xrt_pose center = XRT_POSE_IDENTITY;
+	return simulated_hmd_create(SIMULATED_MOVEMENT_STATIONARY, &center);
+}
+
+static bool
+run_startup(const struct startup_options *opts, enum startup_mode mode, struct startup_timeline *out_timeline)
+{
+	const struct comp_target_factory *ctf = &comp_target_factory_none;
+	struct comp_main_startup *cms = NULL;
+	struct xrt_system_compositor *xsysc = NULL;
+
+	uint64_t start_ns = os_monotonic_get_ns();
+
+	if (mode == STARTUP_MODE_OVERLAPPED && comp_main_startup_begin(ctf, &cms) != XRT_SUCCESS) {
+		return false;
+	}
+
+	struct xrt_device *xdev = slow_device_create(opts);
+	out_timeline->devices_ready_ns = os_monotonic_get_ns() - start_ns;
+
+	if (xdev == NULL) {
+		comp_main_startup_destroy(&cms);
+		return false;
+	}
+
+	// Without a start-up state this is the same as the serial creation.
+	xrt_result_t xret = comp_main_startup_finish(&cms, xdev, ctf, &xsysc);
+	out_timeline->compositor_ready_ns = os_monotonic_get_ns() - start_ns;
+
+	xrt_syscomp_destroy(&xsysc);
+	xrt_device_destroy(&xdev);
+
+	if (xret != XRT_SUCCESS) {
+		P("Failed to create the %s compositor (%i)\n", startup_mode_names[mode], xret);
+		return false;
+	}
+
+	return true;
+}
+
+static bool
+run_mode(const struct startup_options *opts, enum startup_mode mode, struct startup_stats *out_stats)
+{
+	double *devices = U_TYPED_ARRAY_CALLOC(double, opts->runs);
+	double *compositor = U_TYPED_ARRAY_CALLOC(double, opts->runs);
+	double *after = U_TYPED_ARRAY_CALLOC(double, opts->runs);
+	bool ok = true;
+
+	for (uint32_t i = 0; ok && i < opts->runs; i++) {
+		struct startup_timeline tl = {0};
+		ok = run_startup(opts, mode, &tl);
+
+		devices[i] = (double)tl.devices_ready_ns;
+		compositor[i] = (double)tl.compositor_ready_ns;
+		after[i] = (double)(tl.compositor_ready_ns - tl.devices_ready_ns);
+	}
+
+	bench_sort_samples(devices, opts->runs);
+	bench_sort_samples(compositor, opts->runs);
+	bench_sort_samples(after, opts->runs);
+
+	out_stats->devices_ready_ns = bench_percentile_sorted(devices, opts->runs, 0.5);
+	out_stats->compositor_ready_ns = bench_percentile_sorted(compositor, opts->runs, 0.5);
+	out_stats->compositor_after_devices_ns = bench_percentile_sorted(after, opts->runs, 0.5);
+
+	free(devices);
+	free(compositor);
+	free(after);
+
+	return ok;
+}
+
+static void
+print_stats(FILE *text, enum startup_mode mode, const struct startup_stats *stats)
+{
+	fprintf(text, "  %-12s %16.1f %16.1f %16.1f\n", startup_mode_names[mode], stats->devices_ready_ns / 1e6,
+	        stats->compositor_ready_ns / 1e6, stats->compositor_after_devices_ns / 1e6);
+}
+
+static cJSON *
+stats_to_json(enum startup_mode mode, const struct startup_stats *stats)
+{
+	cJSON *obj = cJSON_CreateObject();
+	cJSON_AddStringToObject(obj, "mode", startup_mode_names[mode]);
+	cJSON_AddNumberToObject(obj, "devices_ready_ns", stats->devices_ready_ns);
+	cJSON_AddNumberToObject(obj, "compositor_ready_ns", stats->compositor_ready_ns);
+	cJSON_AddNumberToObject(obj, "compositor_after_devices_ns", stats->compositor_after_devices_ns);
+
+	return obj;
+}
+
+
+/*
+ *
+ * Main.
+ *
+ */
+
+int
+main(int argc, const char **argv)
+{
+	struct startup_options opts = {0};
+	if (!parse_args(argc, argv, &opts)) {
+		return print_help(argv[0]);
+	}
+
+	if (opts.lavapipe && !use_lavapipe()) {
+		P("Could not find the lavapipe ICD\n");
+		return 1;
+	}
+
+	// Keep stdout clean for the json.
+	FILE *text = opts.json_path != NULL && strcmp(opts.json_path, "-") == 0 ? stderr : stdout;
+
+	cJSON *root = cJSON_CreateObject();
+	cJSON_AddNumberToObject(root, "version", STARTUP_JSON_VERSION);
+	cJSON_AddStringToObject(root, "git_tag", u_git_tag);
+	cJSON_AddNumberToObject(root, "runs", opts.runs);
+	cJSON_AddNumberToObject(root, "device_ns", (double)opts.device_ns);
+	cJSON *modes = cJSON_AddArrayToObject(root, "modes");
+
+	fprintf(text, "Medians of %u run(s), device takes %.1f ms\n", opts.runs, opts.device_ns / 1e6);
+	fprintf(text, "  %-12s %16s %16s %16s\n", "mode", "devices (ms)", "compositor (ms)", "after dev (ms)");
+
+	bool ok = true;
+	for (uint32_t m = 0; ok && m < STARTUP_MODE_COUNT; m++) {
+		struct startup_stats stats = {0};
+		ok = run_mode(&opts, (enum startup_mode)m, &stats);
+		if (!ok) {
+			break;
+		}
+
+		print_stats(text, (enum startup_mode)m, &stats);
+		cJSON_AddItemToArray(modes, stats_to_json((enum startup_mode)m, &stats));
+	}
+
+	if (ok && opts.json_path != NULL) {
+		ok = write_json(opts.json_path, root);
+	}
+
+	cJSON_Delete(root);
+
+	return ok ? 0 : 1;
+}
@@ -32,6 +32,7 @@
 #endif
 
 DEBUG_GET_ONCE_BOOL_OPTION(use_null, "XRT_COMPOSITOR_NULL", USE_NULL_DEFAULT)
+DEBUG_GET_ONCE_BOOL_OPTION(early_start, "XRT_COMPOSITOR_EARLY_START", true)
 
 xrt_result_t
 null_compositor_create_system(struct xrt_device *xdev, struct xrt_system_compositor **out_xsysc);
@@ -63,8 +64,25 @@ t_instance_create_system(struct xrt_instance *xinst,
 	struct xrt_system_devices *xsysd = NULL;
 	xrt_result_t xret = XRT_SUCCESS;
 
+	bool use_null = debug_get_bool_option_use_null();
+
+#ifdef XRT_MODULE_COMPOSITOR_MAIN
+	/*
+	 * Bringing up Vulkan does not need the devices, so do it while they
+	 * are being probed, only the parts needing the head waits for them.
+	 */
+	struct comp_main_startup *cms = NULL;
+	if (out_xsysc != NULL && !use_null && debug_get_bool_option_early_start()) {
+		// Not fatal, the compositor is created without it.
+		comp_main_startup_begin(NULL, &cms);
+	}
+#endif
+
 	xret = u_system_devices_create_from_prober(xinst, &xsysd, &xso);
 	if (xret != XRT_SUCCESS) {
+#ifdef XRT_MODULE_COMPOSITOR_MAIN
+		comp_main_startup_destroy(&cms);
+#endif
 		return xret;
 	}
 
@@ -76,8 +94,6 @@ t_instance_create_system(struct xrt_instance *xinst,
 
 	struct xrt_device *head = xsysd->roles.head;
 
-	bool use_null = debug_get_bool_option_use_null();
-
 #ifdef XRT_MODULE_COMPOSITOR_NULL
 	if (use_null) {
 		xret = null_compositor_create_system(head, &xsysc);
@@ -91,8 +107,9 @@ t_instance_create_system(struct xrt_instance *xinst,
 
 #ifdef XRT_MODULE_COMPOSITOR_MAIN
 	if (xret == XRT_SUCCESS && xsysc == NULL) {
-		xret = comp_main_create_system_compositor(head, NULL, &xsysc);
+		xret = comp_main_startup_finish(&cms, head, NULL, &xsysc);
 	}
+	comp_main_startup_destroy(&cms);
 #else
 	if (!use_null) {
 		U_LOG_E("Explicitly didn't request the null compositor, but the main compositor hasn't been built!");
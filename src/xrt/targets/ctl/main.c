@@ -26,6 +26,7 @@ typedef enum op_mode
 	MODE_SET_PRIMARY,
 	MODE_SET_FOCUSED,
 	MODE_TOGGLE_IO,
+	MODE_DUMP_TRACE,
 } op_mode_t;
 
 
@@ -129,6 +130,23 @@ toggle_io(struct ipc_connection *ipc_c, int client_id)
 	return 0;
 }
 
+int
+dump_trace(struct ipc_connection *ipc_c, int window_ms)
+{
+	struct ipc_trace_dump dump = {0};
+	xrt_result_t r;
+
+	r = ipc_call_system_dump_trace(ipc_c, window_ms > 0 ? (uint32_t)window_ms : 0, &dump);
+	if (r != XRT_SUCCESS) {
+		PE("Failed to dump trace, is the service built with the flight recorder?\n");
+		return 1;
+	}
+
+	P("Trace written to '%s'\n", dump.path);
+
+	return 0;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -139,7 +157,7 @@ main(int argc, char *argv[])
 	int s_val = 0;
 
 	opterr = 0;
-	while ((c = getopt(argc, argv, "p:f:i:")) != -1) {
+	while ((c = getopt(argc, argv, "p:f:i:t:")) != -1) {
 		switch (c) {
 		case 'p':
 			s_val = atoi(optarg);
@@ -153,6 +171,10 @@ main(int argc, char *argv[])
 			s_val = atoi(optarg);
 			op_mode = MODE_TOGGLE_IO;
 			break;
+		case 't':
+			s_val = atoi(optarg);
+			op_mode = MODE_DUMP_TRACE;
+			break;
 		case '?':
 			if (optopt == 's') {
 				PE("Option -s requires an id to set.\n");
@@ -161,6 +183,7 @@ main(int argc, char *argv[])
 				PE("    -f <id>: Set focused client\n");
 				PE("    -p <id>: Set primary client\n");
 				PE("    -i <id>: Toggle whether client receives input\n");
+				PE("    -t <ms>: Write a trace of the last <ms> milliseconds, 0 for the default\n");
 			} else {
 				PE("Option `\\x%x' unknown.\n", optopt);
 			}
@@ -187,6 +210,7 @@ main(int argc, char *argv[])
 	case MODE_SET_PRIMARY: exit(set_primary(&ipc_c, s_val)); break;
 	case MODE_SET_FOCUSED: exit(set_focused(&ipc_c, s_val)); break;
 	case MODE_TOGGLE_IO: exit(toggle_io(&ipc_c, s_val)); break;
+	case MODE_DUMP_TRACE: exit(dump_trace(&ipc_c, s_val)); break;
 	default: P("Unrecognised operation mode.\n"); exit(1);
 	}
 
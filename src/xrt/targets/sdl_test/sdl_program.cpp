@@ -115,7 +115,8 @@ sdl_program_plus_render(struct sdl_program_plus *spp_ptr)
 		glClearColor(0.2f, 0.2f, 0.2f, 0.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 	} else if (spp.c.base.slot.layers[0].data.type == XRT_LAYER_STEREO_PROJECTION ||
-	           spp.c.base.slot.layers[0].data.type == XRT_LAYER_STEREO_PROJECTION_DEPTH) {
+	           spp.c.base.slot.layers[0].data.type == XRT_LAYER_STEREO_PROJECTION_DEPTH ||
+	           spp.c.base.slot.layers[0].data.type == XRT_LAYER_STEREO_PROJECTION_SPACE_WARP) {
 
 		auto &l = spp.c.base.slot.layers[0];
 		auto &ssc = *(sdl_swapchain *)l.sc_array[0];
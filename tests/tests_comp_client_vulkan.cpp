@@ -17,14 +17,17 @@
 
 #include "catch/catch.hpp"
 #include "util/comp_vulkan.h"
+#include "util/u_handles.h"
 #include "util/u_logging.h"
 #include "util/u_string_list.h"
 #include "vk/vk_helpers.h"
+#include "vk/vk_image_allocator.h"
 #include "xrt/xrt_compositor.h"
 #include <xrt/xrt_deleters.hpp>
 
+#include <atomic>
 #include <memory>
-#include <iostream>
+#include <vector>
 
 using unique_native_compositor =
     std::unique_ptr<xrt_compositor_native,
@@ -101,6 +104,60 @@ using unique_compositor_vk =
     std::unique_ptr<struct xrt_compositor_vk,
                     xrt::deleters::ptr_ptr_deleter<struct xrt_compositor_vk, &xrt_comp_vk_destroy>>;
 
+/*!
+ * Backs mock swapchains with real exportable images, so the client compositor
+ * can import them.
+ */
+struct MockImages
+{
+	vk_bundle *vk;
+	std::vector<vk_image_collection> collections;
+
+	xrt_result_t
+	create(struct mock_compositor_swapchain *mcsc, const struct xrt_swapchain_create_info *info)
+	{
+		uint32_t image_count = mcsc->base.base.image_count;
+
+		vk_image_collection vkic{};
+		if (vk_ic_allocate(vk, info, image_count, &vkic) != VK_SUCCESS) {
+			return XRT_ERROR_VULKAN;
+		}
+
+		xrt_graphics_buffer_handle_t handles[XRT_MAX_SWAPCHAIN_IMAGES];
+		if (vk_ic_get_handles(vk, &vkic, image_count, handles) != VK_SUCCESS) {
+			vk_ic_destroy(vk, &vkic);
+			return XRT_ERROR_VULKAN;
+		}
+
+		for (uint32_t i = 0; i < image_count; i++) {
+			mcsc->base.images[i].handle = handles[i];
+			mcsc->base.images[i].size = vkic.images[i].size;
+			mcsc->base.images[i].use_dedicated_allocation = vkic.images[i].use_dedicated_allocation;
+		}
+
+		collections.push_back(vkic);
+		return XRT_SUCCESS;
+	}
+
+	~MockImages()
+	{
+		vk->vkDeviceWaitIdle(vk->device);
+		for (vk_image_collection &vkic : collections) {
+			vk_ic_destroy(vk, &vkic);
+		}
+	}
+};
+
+static std::atomic<int> submit_count{0};
+static PFN_vkQueueSubmit real_queue_submit = nullptr;
+
+static VKAPI_ATTR VkResult VKAPI_CALL
+counting_queue_submit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence)
+{
+	submit_count++;
+	return real_queue_submit(queue, submitCount, pSubmits, fence);
+}
+
 TEST_CASE("client_compositor", "[.][needgpu]")
 {
 	xrt_compositor_native *xcn = mock_create_native_compositor();
@@ -116,6 +173,9 @@ TEST_CASE("client_compositor", "[.][needgpu]")
 	    u_string_list_create_from_array(required_device_extensions, ARRAY_SIZE(required_device_extensions))};
 
 	unique_string_list optional_device_extension_list{u_string_list_create()};
+#ifdef VK_KHR_image_format_list
+	u_string_list_append(optional_device_extension_list.get(), VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME);
+#endif
 
 	comp_vulkan_arguments args{VK_MAKE_VERSION(1, 0, 0),
 	                           vkGetInstanceProcAddr,
@@ -151,7 +211,9 @@ TEST_CASE("client_compositor", "[.][needgpu]")
 #else
 #error "Need port for fence sync handles checkers"
 #endif
-	    vk->queue_family_index, //
+	    false,                         // fragment_shading_rate_enabled
+	    vk->has_KHR_image_format_list, // image_format_list_enabled
+	    vk->queue_family_index,        //
 	    vk->queue_index);
 	struct xrt_compositor *xc = &xcvk->base;
 
@@ -183,9 +245,169 @@ TEST_CASE("client_compositor", "[.][needgpu]")
 		xrt_swapchain_reference(&xsc, nullptr);
 	}
 
+	SECTION("Release barriers are batched into the commit")
+	{
+		constexpr uint32_t layer_count = 4;
+		constexpr int frame_count = 100;
+
+		MockImages images{vk, {}};
+		mc->userdata = &images;
+		mc->compositor_hooks.create_swapchain =
+		    [](struct mock_compositor *mc, struct mock_compositor_swapchain *mcsc,
+		       const struct xrt_swapchain_create_info *info, struct xrt_swapchain **out_xsc) {
+			    return static_cast<MockImages *>(mc->userdata)->create(mcsc, info);
+		    };
+		xcn->base.layer_commit = [](struct xrt_compositor *xc, xrt_graphics_sync_handle_t sync_handle) {
+			u_graphics_sync_unref(&sync_handle);
+			return XRT_SUCCESS;
+		};
+
+		// Count every submit the client compositor does on the app's queue.
+		struct client_vk_compositor *c = (struct client_vk_compositor *)xcvk;
+		real_queue_submit = c->vk.vkQueueSubmit;
+		c->vk.vkQueueSubmit = counting_queue_submit;
+
+		xrt_swapchain_create_info xsci{};
+		xsci.format = VK_FORMAT_R8G8B8A8_UNORM;
+		xsci.bits = (xrt_swapchain_usage_bits)(XRT_SWAPCHAIN_USAGE_COLOR | XRT_SWAPCHAIN_USAGE_SAMPLED);
+		xsci.sample_count = 1;
+		xsci.width = 256;
+		xsci.height = 256;
+		xsci.face_count = 1;
+		xsci.array_size = 1;
+		xsci.mip_count = 1;
+
+		struct xrt_swapchain *xscs[layer_count] = {};
+		for (struct xrt_swapchain *&xsc : xscs) {
+			REQUIRE(xrt_comp_create_swapchain(xc, &xsci, &xsc) == XRT_SUCCESS);
+		}
+
+		int release_submits = 0;
+		int frame_submits = 0;
+
+		for (int frame = 0; frame < frame_count; frame++) {
+			int before = submit_count;
+
+			for (struct xrt_swapchain *xsc : xscs) {
+				uint32_t index = 0;
+				REQUIRE(xrt_swapchain_acquire_image(xsc, &index) == XRT_SUCCESS);
+				REQUIRE(xrt_swapchain_barrier_image(xsc, XRT_BARRIER_TO_APP, index) == XRT_SUCCESS);
+				REQUIRE(xrt_swapchain_wait_image(xsc, XRT_INFINITE_DURATION, index) == XRT_SUCCESS);
+
+				int before_release = submit_count;
+				REQUIRE(xrt_swapchain_barrier_image(xsc, XRT_BARRIER_TO_COMP, index) == XRT_SUCCESS);
+				REQUIRE(xrt_swapchain_release_image(xsc, index) == XRT_SUCCESS);
+				release_submits += submit_count - before_release;
+			}
+
+			REQUIRE(xrt_comp_layer_commit(xc, XRT_GRAPHICS_SYNC_HANDLE_INVALID) == XRT_SUCCESS);
+			CHECK(c->barriers.count == 0);
+
+			frame_submits += submit_count - before;
+		}
+
+		// One submit per acquire, releases ride along with the next acquire or commit.
+		CHECK(release_submits == 0);
+		CHECK(frame_submits <= frame_count * (int)(layer_count + 2));
+
+		for (struct xrt_swapchain *&xsc : xscs) {
+			xrt_swapchain_reference(&xsc, nullptr);
+		}
+
+		c->vk.vkQueueSubmit = real_queue_submit;
+	}
+
+	SECTION("Mutable swapchain with a view format list")
+	{
+		MockImages images{vk, {}};
+		mc->userdata = &images;
+		mc->compositor_hooks.create_swapchain =
+		    [](struct mock_compositor *mc, struct mock_compositor_swapchain *mcsc,
+		       const struct xrt_swapchain_create_info *info, struct xrt_swapchain **out_xsc) {
+			    return static_cast<MockImages *>(mc->userdata)->create(mcsc, info);
+		    };
+
+		xrt_swapchain_create_info xsci{};
+		xsci.format = VK_FORMAT_R8G8B8A8_SRGB;
+		xsci.bits = (xrt_swapchain_usage_bits)(XRT_SWAPCHAIN_USAGE_COLOR | XRT_SWAPCHAIN_USAGE_SAMPLED |
+		                                       XRT_SWAPCHAIN_USAGE_MUTABLE_FORMAT);
+		xsci.sample_count = 1;
+		xsci.width = 256;
+		xsci.height = 256;
+		xsci.face_count = 1;
+		xsci.array_size = 1;
+		xsci.mip_count = 1;
+		xsci.format_count = 1;
+		xsci.formats[0] = VK_FORMAT_R8G8B8A8_UNORM;
+
+		// Allocated and imported with the same list, or the import fails.
+		struct xrt_swapchain *xsc = nullptr;
+		REQUIRE(xrt_comp_create_swapchain(xc, &xsci, &xsc) == XRT_SUCCESS);
+		REQUIRE(images.collections.size() == 1);
+		CHECK(images.collections[0].info.format_count == (vk->has_KHR_image_format_list ? 1 : 0));
+
+		// The app renders through a view in the listed format.
+		VkImageSubresourceRange subresource_range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+		VkImageView view = VK_NULL_HANDLE;
+		VkImage image = ((struct xrt_swapchain_vk *)xsc)->images[0];
+		CHECK(vk_create_view(vk, image, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R8G8B8A8_UNORM, subresource_range,
+		                     &view) == VK_SUCCESS);
+		vk->vkDestroyImageView(vk->device, view, nullptr);
+
+		xrt_swapchain_reference(&xsc, nullptr);
+	}
+
 	xrt_comp_destroy(&xc);
 
 	vk_deinit_mutex(vk);
 
 	xrt_comp_native_destroy(&xcn);
 }
+
+TEST_CASE("csci_image_view_formats")
+{
+	vk_bundle vk{};
+	vk.has_KHR_image_format_list = true;
+
+	xrt_swapchain_create_info xsci{};
+	xsci.format = VK_FORMAT_R8G8B8A8_SRGB;
+	xsci.bits = (xrt_swapchain_usage_bits)(XRT_SWAPCHAIN_USAGE_COLOR | XRT_SWAPCHAIN_USAGE_MUTABLE_FORMAT);
+	xsci.format_count = 2;
+	xsci.formats[0] = VK_FORMAT_R8G8B8A8_UNORM;
+	xsci.formats[1] = VK_FORMAT_R8G8B8A8_SRGB;
+
+	VkFormat formats[VK_CSCI_MAX_VIEW_FORMATS];
+
+	SECTION("Swapchain format comes first, duplicates are dropped")
+	{
+		REQUIRE(vk_csci_get_image_view_formats(&vk, &xsci, formats) == 2);
+		CHECK(formats[0] == VK_FORMAT_R8G8B8A8_SRGB);
+		CHECK(formats[1] == VK_FORMAT_R8G8B8A8_UNORM);
+	}
+
+	SECTION("Swapchain format is added when the app left it out")
+	{
+		xsci.format_count = 1;
+		REQUIRE(vk_csci_get_image_view_formats(&vk, &xsci, formats) == 2);
+		CHECK(formats[0] == VK_FORMAT_R8G8B8A8_SRGB);
+		CHECK(formats[1] == VK_FORMAT_R8G8B8A8_UNORM);
+	}
+
+	SECTION("No list without the mutable bit")
+	{
+		xsci.bits = XRT_SWAPCHAIN_USAGE_COLOR;
+		CHECK(vk_csci_get_image_view_formats(&vk, &xsci, formats) == 0);
+	}
+
+	SECTION("No list when the app gave none")
+	{
+		xsci.format_count = 0;
+		CHECK(vk_csci_get_image_view_formats(&vk, &xsci, formats) == 0);
+	}
+
+	SECTION("No list without the extension")
+	{
+		vk.has_KHR_image_format_list = false;
+		CHECK(vk_csci_get_image_view_formats(&vk, &xsci, formats) == 0);
+	}
+}
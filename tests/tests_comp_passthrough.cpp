@@ -0,0 +1,220 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Passthrough camera path tests, a frame from the simulated camera is
+ *        uploaded by the compositor and drawn by the compute layer shader.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_device.h"
+#include "os/os_time.h"
+#include "util/u_time.h"
+#include "main/comp_passthrough.h"
+#include "simulated/simulated_interface.h"
+
+#include "vktest_render.hpp"
+
+#include "catch/catch.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+
+namespace {
+
+//! Size of each target view.
+constexpr uint32_t size = 64;
+
+//! Narrower than the simulated camera, so all of the view is covered by it.
+const struct xrt_fov view_fov = {-0.6f, 0.6f, 0.6f, -0.6f};
+
+//! Allowed difference per channel, sRGB is decoded and encoded again on the way.
+constexpr int byte_tolerance = 2;
+
+//! Allowed difference of linear values when blending.
+constexpr float linear_tolerance = 0.01f;
+
+/*!
+ * Owns the simulated head and the compositor side of the camera path, stops
+ * the camera before anything else goes away even if a check failed.
+ */
+struct TestPassthrough
+{
+	struct xrt_device *xdev{nullptr};
+	struct comp_passthrough cp{};
+	struct xrt_frame *frame{nullptr};
+
+	TestPassthrough(struct vk_bundle *vk)
+	{
+		const struct xrt_pose identity = XRT_POSE_IDENTITY;
+		xdev = simulated_hmd_create(SIMULATED_MOVEMENT_STATIONARY, &identity);
+		comp_passthrough_init(&cp, vk, U_LOGGING_WARN);
+	}
+
+	~TestPassthrough()
+	{
+		comp_passthrough_fini(&cp, xdev);
+		xrt_frame_reference(&frame, NULL);
+		xrt_device_destroy(&xdev);
+	}
+
+	//! Starts the camera like the compositor does, then stops it once a frame has arrived.
+	bool
+	captureOneFrame()
+	{
+		comp_passthrough_set_in_use(&cp, xdev, true, os_monotonic_get_ns());
+		if (!cp.running) {
+			return false;
+		}
+
+		for (uint32_t i = 0; i < 2000 && !hasLatest(); i++) {
+			os_nanosleep(U_TIME_1MS_IN_NS);
+		}
+
+		// No more frames after this, so the one kept is the one uploaded.
+		xrt_device_set_passthrough_sink(xdev, NULL, NULL);
+
+		os_mutex_lock(&cp.latest_mutex);
+		xrt_frame_reference(&frame, cp.latest);
+		os_mutex_unlock(&cp.latest_mutex);
+
+		return frame != nullptr;
+	}
+
+	bool
+	hasLatest()
+	{
+		os_mutex_lock(&cp.latest_mutex);
+		bool ret = cp.latest != nullptr;
+		os_mutex_unlock(&cp.latest_mutex);
+		return ret;
+	}
+
+	/*!
+	 * The camera texels that the view texel at @p x, @p y is filtered from,
+	 * the head doesn't move so the camera and the views look the same way.
+	 */
+	void
+	cameraBlock(uint32_t x, uint32_t y, uint32_t &out_x, uint32_t &out_y) const
+	{
+		const struct xrt_fov &fov = cp.info.fovs[0];
+
+		double tan_x = std::tan(view_fov.angle_left) +
+		               (x + 0.5) / size * (std::tan(view_fov.angle_right) - std::tan(view_fov.angle_left));
+		double tan_y = std::tan(view_fov.angle_up) -
+		               (y + 0.5) / size * (std::tan(view_fov.angle_up) - std::tan(view_fov.angle_down));
+
+		double u = (tan_x - std::tan(fov.angle_left)) / (std::tan(fov.angle_right) - std::tan(fov.angle_left));
+		double v = (std::tan(fov.angle_up) - tan_y) / (std::tan(fov.angle_up) - std::tan(fov.angle_down));
+
+		// Top left of the 2x2 texels that bilinear filtering reads.
+		out_x = (uint32_t)std::floor(u * frame->width - 0.5);
+		out_y = (uint32_t)std::floor(v * frame->height - 0.5);
+	}
+
+	//! Is the 2x2 block of camera texels at @p x, @p y all one colour.
+	bool
+	isFlat(uint32_t x, uint32_t y) const
+	{
+		const uint8_t *first = cameraTexel(x, y);
+		for (uint32_t dy = 0; dy < 2; dy++) {
+			for (uint32_t dx = 0; dx < 2; dx++) {
+				const uint8_t *texel = cameraTexel(x + dx, y + dy);
+				if (texel[0] != first[0] || texel[1] != first[1] || texel[2] != first[2]) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	const uint8_t *
+	cameraTexel(uint32_t x, uint32_t y) const
+	{
+		return frame->data + y * frame->stride + x * 3;
+	}
+};
+
+} // namespace
+
+
+TEST_CASE("comp_passthrough_simulated_camera", "[.][needgpu]")
+{
+	VkTestRender t;
+	REQUIRE(t.init(view_fov));
+
+	TestPassthrough tp(t.vk);
+	REQUIRE(tp.captureOneFrame());
+
+	// Both views see the whole camera image.
+	const struct xrt_fov &camera_fov = tp.cp.info.fovs[0];
+	REQUIRE(camera_fov.angle_left < view_fov.angle_left);
+	REQUIRE(camera_fov.angle_right > view_fov.angle_right);
+	REQUIRE(camera_fov.angle_up > view_fov.angle_up);
+	REQUIRE(camera_fov.angle_down < view_fov.angle_down);
+
+	VkTestImage &target = t.createImage(size * 2, size, VK_FORMAT_R8G8B8A8_UNORM, 4, VK_IMAGE_USAGE_STORAGE_BIT);
+
+	const float opacities[] = {1.0f, 0.5f};
+	for (float opacity : opacities) {
+		INFO("opacity " << opacity);
+
+		t.begin();
+
+		// Records the upload, into the same command buffer as the layers like the renderer does.
+		const struct comp_passthrough_image *img = comp_passthrough_update(&tp.cp, t.r.cmd);
+		REQUIRE(img != nullptr);
+
+		struct xrt_space_relation head = XRT_SPACE_RELATION_ZERO;
+		xrt_device_get_tracked_pose(tp.xdev, XRT_INPUT_GENERIC_HEAD_POSE, img->timestamp_ns, &head);
+
+		struct render_compute_layer_ubo_data *ubo = t.resetLayerUbo(size, size);
+		ubo->layer_type[0].val = XRT_LAYER_PASSTHROUGH;
+		ubo->layer_type[0].opacity = opacity;
+
+		for (uint32_t view = 0; view < 2; view++) {
+			ubo->images_samplers[view].images[0] = 0;
+			ubo->post_transforms[view] = img->rects[view];
+			render_calc_passthrough_matrix(&head.pose, &tp.cp.info.poses[0], &tp.cp.info.fovs[0], &head.pose,
+			                               &ubo->transforms[view]);
+		}
+
+		t.computeLayers({img->view}, target, true);
+		t.endAndReadBack(target, VkTestRender::layers_layout);
+
+		uint32_t checked = 0;
+
+		for (uint32_t view = 0; view < 2; view++) {
+			for (uint32_t y = 0; y < size; y++) {
+				for (uint32_t x = 0; x < size; x++) {
+					uint32_t cx, cy;
+					tp.cameraBlock(x, y, cx, cy);
+
+					// The bilinear filter blends the edges of the checker squares.
+					if (!tp.isFlat(cx, cy)) {
+						continue;
+					}
+
+					INFO("at " << x << ", " << y << " in view " << view);
+					const uint8_t *expected = tp.cameraTexel(cx, cy);
+					const uint8_t *texel = target.texel<uint8_t>(view * size + x, y);
+
+					for (uint32_t c = 0; c < 3; c++) {
+						if (opacity == 1.0f) {
+							CHECK(std::abs((int)texel[c] - (int)expected[c]) <= byte_tolerance);
+						} else {
+							float want = vktest_srgb_to_linear(expected[c]) * opacity;
+							CHECK(vktest_srgb_to_linear(texel[c]) ==
+							      Approx(want).margin(linear_tolerance));
+						}
+					}
+					checked++;
+				}
+			}
+		}
+
+		// Most of the image is inside the checker squares.
+		CHECK(checked > size * size);
+	}
+}
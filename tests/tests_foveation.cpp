@@ -0,0 +1,193 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Foveation pattern tests.
+ * @author agent <agent@local>
+ */
+
+#include <util/u_foveation.h>
+
+#include "catch/catch.hpp"
+
+#include <cmath>
+#include <vector>
+
+
+static constexpr float tolerance = 0.0001f;
+
+static const struct xrt_fov fov = {-0.8f, 0.8f, 0.7f, -0.7f};
+
+TEST_CASE("u_foveation_rate_for_distance")
+{
+	SECTION("None is always full rate")
+	{
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_NONE, 0.0f, 2) == U_FOVEATION_RATE_1X1);
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_NONE, 2.0f, 2) == U_FOVEATION_RATE_1X1);
+	}
+
+	SECTION("Centre is always full rate")
+	{
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_LOW, 0.0f, 2) == U_FOVEATION_RATE_1X1);
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_HIGH, 0.0f, 2) == U_FOVEATION_RATE_1X1);
+	}
+
+	SECTION("Low never goes below 2x2")
+	{
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_LOW, 1.4f, 2) == U_FOVEATION_RATE_2X2);
+	}
+
+	SECTION("Higher levels shrink the full rate region")
+	{
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_LOW, 0.6f, 2) == U_FOVEATION_RATE_1X1);
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_MEDIUM, 0.6f, 2) == U_FOVEATION_RATE_2X2);
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_HIGH, 0.6f, 2) == U_FOVEATION_RATE_2X2);
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_HIGH, 0.7f, 2) == U_FOVEATION_RATE_4X4);
+	}
+
+	SECTION("Clamped to the device maximum")
+	{
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_HIGH, 1.0f, 1) == U_FOVEATION_RATE_2X2);
+		CHECK(u_foveation_rate_for_distance(XRT_FOVEATION_LEVEL_HIGH, 1.0f, 0) == U_FOVEATION_RATE_1X1);
+	}
+}
+
+TEST_CASE("u_foveation_fill_shading_rate")
+{
+	constexpr uint32_t width = 16;
+	constexpr uint32_t height = 8;
+	constexpr size_t stride = 20;
+	std::vector<uint8_t> image(stride * height, 0xff);
+
+	SECTION("Centred pattern is symmetric")
+	{
+		xrt_vec2 center = {0.0f, 0.0f};
+		u_foveation_fill_shading_rate(XRT_FOVEATION_LEVEL_HIGH, &center, 2, width, height, image.data(),
+		                              stride);
+
+		CHECK(image[(height / 2) * stride + width / 2] == U_FOVEATION_RATE_1X1);
+		CHECK(image[0] == U_FOVEATION_RATE_4X4);
+		for (uint32_t y = 0; y < height; y++) {
+			for (uint32_t x = 0; x < width; x++) {
+				CHECK(image[y * stride + x] == image[(height - 1 - y) * stride + (width - 1 - x)]);
+			}
+			// Padding is not touched.
+			CHECK(image[y * stride + width] == 0xff);
+		}
+	}
+
+	SECTION("Y up centre moves the region to the first rows")
+	{
+		xrt_vec2 center = {-1.0f, 1.0f};
+		u_foveation_fill_shading_rate(XRT_FOVEATION_LEVEL_HIGH, &center, 2, width, height, image.data(),
+		                              stride);
+
+		CHECK(image[0] == U_FOVEATION_RATE_1X1);
+		CHECK(image[(height - 1) * stride + width - 1] == U_FOVEATION_RATE_4X4);
+	}
+}
+
+TEST_CASE("u_foveation_center_from_direction")
+{
+	xrt_vec2 center;
+
+	SECTION("Forward is the middle of a symmetric fov")
+	{
+		xrt_vec3 dir = {0.0f, 0.0f, -1.0f};
+		u_foveation_center_from_direction(&fov, &dir, &center);
+		CHECK(center.x == Approx(0.0f).margin(tolerance));
+		CHECK(center.y == Approx(0.0f).margin(tolerance));
+	}
+
+	SECTION("Looking at the right and top edges")
+	{
+		xrt_vec3 dir = {std::tan(fov.angle_right), std::tan(fov.angle_up), -1.0f};
+		u_foveation_center_from_direction(&fov, &dir, &center);
+		CHECK(center.x == Approx(1.0f).margin(tolerance));
+		CHECK(center.y == Approx(1.0f).margin(tolerance));
+	}
+
+	SECTION("Outside the fov is clamped")
+	{
+		xrt_vec3 dir = {-10.0f, 0.0f, -1.0f};
+		u_foveation_center_from_direction(&fov, &dir, &center);
+		CHECK(center.x == Approx(-1.0f).margin(tolerance));
+	}
+
+	SECTION("Behind the view gives the middle")
+	{
+		xrt_vec3 dir = {0.5f, 0.5f, 1.0f};
+		u_foveation_center_from_direction(&fov, &dir, &center);
+		CHECK(center.x == 0.0f);
+		CHECK(center.y == 0.0f);
+	}
+}
+
+TEST_CASE("u_foveation_inset_fov")
+{
+	xrt_fov inset;
+
+	SECTION("Centred inset scales the tangent extent")
+	{
+		xrt_vec2 center = {0.0f, 0.0f};
+		u_foveation_inset_fov(&fov, &center, 0.5f, &inset);
+		CHECK(std::tan(inset.angle_left) == Approx(std::tan(fov.angle_left) * 0.5f).margin(tolerance));
+		CHECK(std::tan(inset.angle_right) == Approx(std::tan(fov.angle_right) * 0.5f).margin(tolerance));
+		CHECK(std::tan(inset.angle_up) == Approx(std::tan(fov.angle_up) * 0.5f).margin(tolerance));
+		CHECK(std::tan(inset.angle_down) == Approx(std::tan(fov.angle_down) * 0.5f).margin(tolerance));
+	}
+
+	SECTION("Follows the centre")
+	{
+		xrt_vec2 center = {0.5f, 0.0f};
+		u_foveation_inset_fov(&fov, &center, 0.25f, &inset);
+
+		float tan_left = std::tan(fov.angle_left);
+		float width = std::tan(fov.angle_right) - tan_left;
+		float middle = (std::tan(inset.angle_left) + std::tan(inset.angle_right)) * 0.5f;
+		CHECK(middle == Approx(tan_left + 0.75f * width).margin(tolerance));
+	}
+
+	SECTION("Kept inside the view at the edges")
+	{
+		xrt_vec2 center = {1.0f, -1.0f};
+		u_foveation_inset_fov(&fov, &center, 0.4f, &inset);
+		CHECK(inset.angle_right == Approx(fov.angle_right).margin(tolerance));
+		CHECK(inset.angle_down == Approx(fov.angle_down).margin(tolerance));
+		CHECK(inset.angle_left > fov.angle_left);
+		CHECK(inset.angle_up < fov.angle_up);
+	}
+}
+
+TEST_CASE("quad_views_inset_blend")
+{
+	// Same as INSET_FEATHER in layer.comp.
+	constexpr float feather = 0.05f;
+
+	// CPU version of the inset weight in layer.comp, from a wide view tan angle.
+	auto weight = [&](const xrt_fov &inset, float tan_x, float tan_y) {
+		float l = std::tan(inset.angle_left);
+		float r = std::tan(inset.angle_right);
+		float u = std::tan(inset.angle_up);
+		float d = std::tan(inset.angle_down);
+		float uv_x = (tan_x - l) / (r - l);
+		float uv_y = (u - tan_y) / (u - d);
+		float edge = std::fmin(std::fmin(uv_x, 1.0f - uv_x), std::fmin(uv_y, 1.0f - uv_y));
+		float t = std::fmin(std::fmax(edge / feather, 0.0f), 1.0f);
+		return t * t * (3.0f - 2.0f * t);
+	};
+
+	xrt_vec2 center = {0.0f, 0.0f};
+	xrt_fov inset;
+	u_foveation_inset_fov(&fov, &center, 0.4f, &inset);
+
+	float r = std::tan(inset.angle_right);
+
+	CHECK(weight(inset, 0.0f, 0.0f) == Approx(1.0f));
+	CHECK(weight(inset, std::tan(fov.angle_right), 0.0f) == 0.0f);
+	CHECK(weight(inset, r, 0.0f) == Approx(0.0f).margin(tolerance));
+
+	// Half way through the feathered edge.
+	float half = r - (r - std::tan(inset.angle_left)) * feather * 0.5f;
+	CHECK(weight(inset, half, 0.0f) == Approx(0.5f).margin(tolerance));
+}
@@ -0,0 +1,192 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief GUI texture sink tests, runs on a headless EGL context.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_frame.h"
+#include "util/u_frame.h"
+#include "ogl/ogl_api.h"
+#include "gui/gui_common.h"
+
+#define EGL_NO_X11              // libglvnd
+#define MESA_EGL_NO_X11_HEADERS // mesa
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "catch/catch.hpp"
+
+#include <cstring>
+#include <vector>
+
+
+static constexpr uint32_t width = 1280;
+static constexpr uint32_t height = 800;
+
+namespace {
+
+/*!
+ * A surfaceless OpenGL 3.3 core context, same version as the GUI uses.
+ */
+struct EglContext
+{
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLContext context = EGL_NO_CONTEXT;
+
+	bool
+	init()
+	{
+		auto get_platform_display =
+		    (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if (get_platform_display != nullptr) {
+			display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		}
+		if (display == EGL_NO_DISPLAY) {
+			display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		}
+		if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+			return false;
+		}
+
+		if (!eglBindAPI(EGL_OPENGL_API)) {
+			return false;
+		}
+
+		EGLint attrs[] = {
+		    EGL_CONTEXT_MAJOR_VERSION,
+		    3,
+		    EGL_CONTEXT_MINOR_VERSION,
+		    3,
+		    EGL_CONTEXT_OPENGL_PROFILE_MASK,
+		    EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		    EGL_NONE,
+		};
+
+		// Needs EGL_KHR_no_config_context and EGL_KHR_surfaceless_context, Mesa has both.
+		context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attrs);
+		if (context == EGL_NO_CONTEXT) {
+			return false;
+		}
+
+		if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+			return false;
+		}
+
+		return gladLoadGL((GLADloadfunc)eglGetProcAddress) != 0;
+	}
+
+	~EglContext()
+	{
+		if (context != EGL_NO_CONTEXT) {
+			eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			eglDestroyContext(display, context);
+		}
+		if (display != EGL_NO_DISPLAY) {
+			eglTerminate(display);
+		}
+	}
+};
+
+struct xrt_frame *
+makeFrame(uint64_t sequence)
+{
+	struct xrt_frame *xf = nullptr;
+	u_frame_create_one_off(XRT_FORMAT_R8G8B8, width, height, &xf);
+
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width * 3; x++) {
+			xf->data[y * xf->stride + x] = (uint8_t)(x + y * 7 + sequence * 13);
+		}
+	}
+
+	xf->source_sequence = sequence;
+	xf->timestamp = sequence + 1;
+
+	return xf;
+}
+
+bool
+textureMatches(struct gui_ogl_texture *tex, struct xrt_frame *xf)
+{
+	GLuint fbo = 0;
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex->id, 0);
+
+	std::vector<uint8_t> pixels(width * height * 3);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glDeleteFramebuffers(1, &fbo);
+
+	for (uint32_t y = 0; y < height; y++) {
+		if (memcmp(&pixels[y * width * 3], &xf->data[y * xf->stride], width * 3) != 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+} // namespace
+
+TEST_CASE("gui_ogl_sink")
+{
+	EglContext egl;
+	if (!egl.init()) {
+		WARN("No headless EGL context, skipping");
+		return;
+	}
+
+	struct xrt_frame_context xfctx = {};
+	struct xrt_frame_sink *sink = nullptr;
+	struct gui_ogl_texture *tex = gui_ogl_sink_create("Test", &xfctx, &sink);
+	REQUIRE(tex != nullptr);
+
+	struct xrt_frame *frames[2] = {makeFrame(1), makeFrame(2)};
+
+	SECTION("Frames are uploaded")
+	{
+		// Two frames, so both pixel unpack buffers are used.
+		for (struct xrt_frame *xf : frames) {
+			xrt_sink_push_frame(sink, xf);
+			gui_ogl_sink_update(tex);
+
+			CHECK(tex->w == width);
+			CHECK(tex->h == height);
+			CHECK(tex->seq == xf->source_sequence);
+			CHECK(textureMatches(tex, xf));
+		}
+	}
+
+	SECTION("The same frame is only uploaded once")
+	{
+		xrt_sink_push_frame(sink, frames[0]);
+		gui_ogl_sink_update(tex);
+		xrt_sink_push_frame(sink, frames[0]);
+		gui_ogl_sink_update(tex);
+		CHECK(tex->skipped == 1);
+
+		xrt_sink_push_frame(sink, frames[1]);
+		gui_ogl_sink_update(tex);
+		CHECK(tex->skipped == 1);
+		CHECK(textureMatches(tex, frames[1]));
+	}
+
+	SECTION("Frames replaced before the update are dropped")
+	{
+		xrt_sink_push_frame(sink, frames[0]);
+		xrt_sink_push_frame(sink, frames[1]);
+		gui_ogl_sink_update(tex);
+		CHECK(tex->dropped == 1);
+		CHECK(textureMatches(tex, frames[1]));
+	}
+
+	xrt_frame_reference(&frames[0], nullptr);
+	xrt_frame_reference(&frames[1], nullptr);
+
+	xrt_frame_context_destroy_nodes(&xfctx);
+}
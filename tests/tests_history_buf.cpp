@@ -115,6 +115,20 @@ TEST_CASE("m_relation_history")
 		CHECK(m_relation_history_get(rh, T2 + (uint64_t)U_TIME_1S_IN_NS, &out_relation) ==
 		      M_RELATION_HISTORY_RESULT_PREDICTED);
 		CHECK(out_relation.pose.position.x > 2.f);
+
+		// The newest entries, oldest first.
+		uint64_t times[4] = {};
+		xrt_space_relation relations[4] = {};
+		CHECK(m_relation_history_get_newest(rh, 2, times, relations) == 2);
+		CHECK(times[0] == T1);
+		CHECK(times[1] == T2);
+		CHECK(relations[0].pose.position.x == 1.f);
+		CHECK(relations[1].pose.position.x == 2.f);
+
+		CHECK(m_relation_history_get_newest(rh, 4, times, relations) == 3);
+		CHECK(times[0] == T0);
+		CHECK(times[2] == T2);
+		CHECK(relations[0].pose.position.x == 0.f);
 	}
 
 
@@ -0,0 +1,320 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief PCM haptic sample ring tests, a client writes samples into the shared
+ *        memory ring and the service drains them into a mock output device.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_device.h"
+#include "util/u_time.h"
+
+#include "shared/ipc_haptic_pcm.h"
+
+#include "catch/catch.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+static constexpr float sample_rate = 1000.0f;
+static constexpr uint64_t sample_period_ns = U_TIME_1MS_IN_NS;
+static constexpr uint64_t drain_period_ns = 2 * U_TIME_1MS_IN_NS;
+static constexpr uint32_t device_capacity = 16;
+static constexpr enum xrt_output_name name = XRT_OUTPUT_NAME_SIMPLE_VIBRATION;
+
+namespace {
+
+/*!
+ * An output device with a small queue of its own, like a controller that is
+ * sent a few milliseconds of samples at a time. Playback is driven by the test
+ * and records every sample played, and every time it ran dry while playing.
+ */
+struct MockPcmDevice
+{
+	struct xrt_device base = {};
+	struct xrt_output outputs[1] = {};
+
+	std::deque<float> queue;
+	std::vector<float> played;
+	uint32_t underrun_count = 0;
+	uint32_t flush_count = 0;
+
+	//! Time of the next sample to play, zero while idle.
+	uint64_t next_ns = 0;
+
+	MockPcmDevice()
+	{
+		outputs[0].name = name;
+		outputs[0].pcm_sample_rate = sample_rate;
+		base.outputs = outputs;
+		base.output_count = 1;
+		base.queue_haptic_pcm = queueHapticPcm;
+	}
+
+	void
+	playUntil(uint64_t now_ns)
+	{
+		while (next_ns != 0 && next_ns <= now_ns) {
+			if (queue.empty()) {
+				underrun_count++;
+				next_ns = 0;
+				break;
+			}
+
+			played.push_back(queue.front());
+			queue.pop_front();
+			next_ns += sample_period_ns;
+		}
+	}
+
+	void
+	start(uint64_t now_ns)
+	{
+		if (next_ns == 0 && !queue.empty()) {
+			next_ns = now_ns;
+		}
+	}
+
+	static void
+	queueHapticPcm(struct xrt_device *xdev,
+	               enum xrt_output_name name,
+	               const float *samples,
+	               uint32_t sample_count,
+	               bool append,
+	               uint32_t *out_samples_consumed)
+	{
+		MockPcmDevice *d = (MockPcmDevice *)xdev;
+
+		if (!append) {
+			d->queue.clear();
+			d->flush_count++;
+		}
+
+		uint32_t count = 0;
+		while (count < sample_count && d->queue.size() < device_capacity) {
+			d->queue.push_back(samples[count++]);
+		}
+
+		*out_samples_consumed = count;
+	}
+};
+
+std::vector<float>
+ramp(uint32_t count, float offset = 0.0f)
+{
+	std::vector<float> samples(count);
+	for (uint32_t i = 0; i < count; i++) {
+		samples[i] = offset + (float)i / (float)count;
+	}
+	return samples;
+}
+
+//! Drains the ring and plays samples on the device, in steps of the drain period.
+void
+run(MockPcmDevice &device, struct ipc_shared_haptic_pcm &ishp, uint64_t &now_ns, uint64_t duration_ns)
+{
+	uint64_t end_ns = now_ns + duration_ns;
+	for (; now_ns < end_ns; now_ns += drain_period_ns) {
+		ipc_haptic_pcm_drain(&ishp, &device.base);
+		device.start(now_ns);
+		device.playUntil(now_ns + drain_period_ns - 1);
+	}
+}
+
+} // namespace
+
+TEST_CASE("ipc_haptic_pcm")
+{
+	MockPcmDevice device;
+	auto ishp_ptr = std::make_unique<struct ipc_shared_haptic_pcm>();
+	struct ipc_shared_haptic_pcm &ishp = *ishp_ptr;
+
+	REQUIRE(ipc_haptic_pcm_init(&ishp, &device.base));
+	REQUIRE(ishp.name == name);
+
+	uint64_t now_ns = 1000 * U_TIME_1MS_IN_NS;
+
+	SECTION("Devices without PCM outputs are not bound")
+	{
+		device.outputs[0].pcm_sample_rate = 0.0f;
+		CHECK_FALSE(ipc_haptic_pcm_init(&ishp, &device.base));
+
+		std::vector<float> samples = ramp(8);
+		CHECK(ipc_haptic_pcm_write(&ishp, name, samples.data(), 8, true) == 0);
+	}
+
+	SECTION("Other outputs are not written")
+	{
+		std::vector<float> samples = ramp(8);
+		CHECK(ipc_haptic_pcm_write(&ishp, XRT_OUTPUT_NAME_INDEX_HAPTIC, samples.data(), 8, true) == 0);
+	}
+
+	SECTION("Samples are played in order without underruns")
+	{
+		std::vector<float> samples = ramp(500);
+		REQUIRE(ipc_haptic_pcm_write(&ishp, name, samples.data(), 500, true) == 500);
+
+		run(device, ishp, now_ns, 600 * U_TIME_1MS_IN_NS);
+
+		CHECK(device.played == samples);
+		// The only underrun is when the buffer has been played out.
+		CHECK(device.underrun_count == 1);
+	}
+
+	SECTION("Only what fits is taken")
+	{
+		std::vector<float> samples = ramp(IPC_SHARED_HAPTIC_PCM_RING_SIZE + 100);
+		uint32_t count = (uint32_t)samples.size();
+		CHECK(ipc_haptic_pcm_write(&ishp, name, samples.data(), count, true) == IPC_SHARED_HAPTIC_PCM_RING_SIZE);
+		CHECK(ipc_haptic_pcm_write(&ishp, name, samples.data(), count, true) == 0);
+
+		// The device takes its queue worth, that much room is freed.
+		ipc_haptic_pcm_drain(&ishp, &device.base);
+		CHECK(device.queue.size() == device_capacity);
+		CHECK(ipc_haptic_pcm_write(&ishp, name, samples.data(), count, true) == device_capacity);
+	}
+
+	SECTION("Not appending drops samples in the ring and in the device")
+	{
+		std::vector<float> first = ramp(100);
+		std::vector<float> second = ramp(50, 10.0f);
+
+		REQUIRE(ipc_haptic_pcm_write(&ishp, name, first.data(), 100, true) == 100);
+		run(device, ishp, now_ns, 10 * U_TIME_1MS_IN_NS);
+		size_t played_first = device.played.size();
+		REQUIRE(played_first > 0);
+		REQUIRE(played_first < 100);
+
+		REQUIRE(ipc_haptic_pcm_write(&ishp, name, second.data(), 50, false) == 50);
+		run(device, ishp, now_ns, 100 * U_TIME_1MS_IN_NS);
+
+		CHECK(device.flush_count == 1);
+		REQUIRE(device.played.size() == played_first + 50);
+		CHECK(std::vector<float>(device.played.begin(), device.played.begin() + played_first) ==
+		      std::vector<float>(first.begin(), first.begin() + played_first));
+		CHECK(std::vector<float>(device.played.begin() + played_first, device.played.end()) == second);
+	}
+
+	SECTION("Not appending to a full ring takes the whole buffer")
+	{
+		std::vector<float> first = ramp(IPC_SHARED_HAPTIC_PCM_RING_SIZE);
+		std::vector<float> second = ramp(IPC_SHARED_HAPTIC_PCM_RING_SIZE, 10.0f);
+		uint32_t count = IPC_SHARED_HAPTIC_PCM_RING_SIZE;
+
+		REQUIRE(ipc_haptic_pcm_write(&ishp, name, first.data(), count, true) == count);
+		REQUIRE(ipc_haptic_pcm_write(&ishp, name, first.data(), 1, true) == 0);
+
+		// The old samples are dropped, the new ones replace them.
+		CHECK(ipc_haptic_pcm_write(&ishp, name, second.data(), count, false) == count);
+
+		run(device, ishp, now_ns, (count + 100) * U_TIME_1MS_IN_NS);
+
+		CHECK(device.flush_count == 1);
+		CHECK(device.played == second);
+	}
+
+	SECTION("Not appending to an empty ring still flushes the device")
+	{
+		std::vector<float> first = ramp(10);
+		std::vector<float> second = ramp(10, 10.0f);
+
+		REQUIRE(ipc_haptic_pcm_write(&ishp, name, first.data(), 10, true) == 10);
+		ipc_haptic_pcm_drain(&ishp, &device.base);
+		REQUIRE(device.queue.size() == 10);
+
+		REQUIRE(ipc_haptic_pcm_write(&ishp, name, second.data(), 10, false) == 10);
+		ipc_haptic_pcm_drain(&ishp, &device.base);
+		CHECK(std::vector<float>(device.queue.begin(), device.queue.end()) == second);
+	}
+
+	SECTION("Stopping drops everything")
+	{
+		std::vector<float> samples = ramp(100);
+		REQUIRE(ipc_haptic_pcm_write(&ishp, name, samples.data(), 100, true) == 100);
+		ipc_haptic_pcm_drain(&ishp, &device.base);
+
+		CHECK(ipc_haptic_pcm_write(&ishp, name, nullptr, 0, false) == 0);
+		run(device, ishp, now_ns, 200 * U_TIME_1MS_IN_NS);
+
+		CHECK(device.played.empty());
+		CHECK(device.queue.empty());
+	}
+
+	SECTION("A client that falls behind causes an underrun")
+	{
+		// 20ms of samples every 30ms.
+		for (uint32_t i = 0; i < 5; i++) {
+			std::vector<float> samples = ramp(20, (float)i);
+			REQUIRE(ipc_haptic_pcm_write(&ishp, name, samples.data(), 20, true) == 20);
+			run(device, ishp, now_ns, 30 * U_TIME_1MS_IN_NS);
+		}
+
+		CHECK(device.played.size() == 100);
+		CHECK(device.underrun_count == 5);
+	}
+
+	SECTION("A client that keeps ahead never underruns")
+	{
+		// 20ms of samples every 10ms, more than the device can queue.
+		uint32_t written = 0;
+		for (uint32_t i = 0; i < 50; i++) {
+			std::vector<float> samples = ramp(20, (float)i);
+			written += ipc_haptic_pcm_write(&ishp, name, samples.data(), 20, true);
+			run(device, ishp, now_ns, 10 * U_TIME_1MS_IN_NS);
+		}
+
+		CHECK(written == 50 * 20);
+		CHECK(device.underrun_count == 0);
+		CHECK(device.played.size() == 500);
+	}
+
+	SECTION("Another client writing does not block")
+	{
+		ishp.write_lock = 1;
+		std::vector<float> samples = ramp(8);
+		CHECK(ipc_haptic_pcm_write(&ishp, name, samples.data(), 8, true) == 0);
+		ishp.write_lock = 0;
+		CHECK(ipc_haptic_pcm_write(&ishp, name, samples.data(), 8, true) == 8);
+	}
+
+	SECTION("Concurrent writer and drainer keep the order")
+	{
+		constexpr uint32_t total = 200000;
+		std::atomic<bool> done{false};
+
+		// Each sample is its index, the device only ever sees increasing values.
+		std::thread client([&] {
+			std::vector<float> samples(64);
+			uint32_t next = 0;
+			while (next < total) {
+				uint32_t count = std::min<uint32_t>(64, total - next);
+				for (uint32_t i = 0; i < count; i++) {
+					samples[i] = (float)(next + i);
+				}
+				next += ipc_haptic_pcm_write(&ishp, name, samples.data(), count, true);
+			}
+			done = true;
+		});
+
+		while (!done || ishp.read_pos != ishp.write_pos) {
+			ipc_haptic_pcm_drain(&ishp, &device.base);
+			while (!device.queue.empty()) {
+				device.played.push_back(device.queue.front());
+				device.queue.pop_front();
+			}
+		}
+		client.join();
+
+		REQUIRE(device.played.size() == total);
+		bool in_order = true;
+		for (uint32_t i = 0; i < total && in_order; i++) {
+			in_order = device.played[i] == (float)i;
+		}
+		CHECK(in_order);
+	}
+}
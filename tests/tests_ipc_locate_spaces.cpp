@@ -0,0 +1,186 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Batched space locate tests, compares single and batched locates over
+ *        a real socket using the generated IPC client calls.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_space.h"
+#include "util/u_space_overseer.h"
+
+#include "ipc_client_generated.h"
+
+#include "catch/catch.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+
+static constexpr uint32_t space_count = 64;
+static constexpr float tolerance = 0.0001f;
+
+namespace {
+
+/*!
+ * Minimal service side, answers the locate calls with a real space overseer.
+ * Space id zero is the root space, used as the base space.
+ */
+struct FakeService
+{
+	struct xrt_space_overseer *xso = nullptr;
+	std::vector<struct xrt_space *> spaces;
+	struct ipc_message_channel imc = {};
+	std::thread thread;
+
+	FakeService(xrt_ipc_handle_t handle)
+	{
+		xso = (struct xrt_space_overseer *)u_space_overseer_create();
+		imc.ipc_handle = handle;
+		imc.log_level = U_LOGGING_WARN;
+
+		struct xrt_space *root = nullptr;
+		xrt_space_reference(&root, xso->semantic.root);
+		spaces.push_back(root);
+
+		for (uint32_t i = 0; i < space_count; i++) {
+			struct xrt_pose offset = XRT_POSE_IDENTITY;
+			offset.position.x = (float)i * 0.1f;
+			offset.position.y = 1.0f;
+
+			struct xrt_space *xs = nullptr;
+			xrt_space_overseer_create_offset_space(xso, root, &offset, &xs);
+			spaces.push_back(xs);
+		}
+
+		thread = std::thread([this] { run(); });
+	}
+
+	~FakeService()
+	{
+		thread.join();
+		for (struct xrt_space *&xs : spaces) {
+			xrt_space_reference(&xs, nullptr);
+		}
+		xrt_space_overseer_destroy(&xso);
+	}
+
+	void
+	locateSpace(const struct ipc_space_locate_space_msg *msg)
+	{
+		struct ipc_space_locate_space_reply reply = {};
+		reply.result = xrt_space_overseer_locate_space( //
+		    xso,                                        //
+		    spaces[msg->base_space_id],                 //
+		    &msg->base_offset,                          //
+		    msg->at_timestamp,                          //
+		    spaces[msg->space_id],                      //
+		    &msg->offset,                               //
+		    &reply.relation);                           //
+		ipc_send(&imc, &reply, sizeof(reply));
+	}
+
+	void
+	locateSpaces(const struct ipc_space_locate_spaces_msg *msg)
+	{
+		struct xrt_space *xspaces[IPC_MAX_LOCATE_SPACES] = {};
+		for (uint32_t i = 0; i < msg->spaces.space_count; i++) {
+			xspaces[i] = spaces[msg->spaces.space_ids[i]];
+		}
+
+		struct ipc_space_locate_spaces_reply reply = {};
+		reply.result = xrt_space_overseer_locate_spaces( //
+		    xso,                                         //
+		    spaces[msg->base_space_id],                  //
+		    &msg->base_offset,                           //
+		    msg->at_timestamp,                           //
+		    xspaces,                                     //
+		    msg->spaces.space_count,                     //
+		    msg->spaces.offsets,                         //
+		    reply.relations.relations);                  //
+		ipc_send(&imc, &reply, sizeof(reply));
+	}
+
+	void
+	run()
+	{
+		alignas(8) uint8_t buf[IPC_BUF_SIZE];
+
+		while (true) {
+			ssize_t len = recv(imc.ipc_handle, buf, IPC_BUF_SIZE, 0);
+			if (len < 4) {
+				break; // Client closed the connection.
+			}
+
+			switch (*(ipc_command_t *)buf) {
+			case IPC_SPACE_LOCATE_SPACE: locateSpace((struct ipc_space_locate_space_msg *)buf); break;
+			case IPC_SPACE_LOCATE_SPACES: locateSpaces((struct ipc_space_locate_spaces_msg *)buf); break;
+			default: return;
+			}
+		}
+	}
+};
+
+} // namespace
+
+TEST_CASE("ipc_locate_spaces")
+{
+	int fds[2] = {-1, -1};
+	REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+	struct ipc_connection ipc_c = {};
+	ipc_c.imc.ipc_handle = fds[0];
+	ipc_c.imc.log_level = U_LOGGING_WARN;
+	ipc_c.log_level = U_LOGGING_WARN;
+	os_mutex_init(&ipc_c.mutex);
+
+	{
+		FakeService service(fds[1]);
+
+		const struct xrt_pose identity = XRT_POSE_IDENTITY;
+		const uint64_t at_timestamp_ns = 1000000;
+
+		struct ipc_arg_space_locate_spaces args = {};
+		args.space_count = space_count;
+		for (uint32_t i = 0; i < space_count; i++) {
+			args.space_ids[i] = i + 1;
+			args.offsets[i] = identity;
+		}
+
+		struct xrt_space_relation singles[space_count] = {};
+		struct ipc_info_space_locate_spaces batched = {};
+
+		SECTION("Batched results match single locates")
+		{
+			for (uint32_t i = 0; i < space_count; i++) {
+				REQUIRE(ipc_call_space_locate_space(&ipc_c, 0, &identity, at_timestamp_ns, i + 1,
+				                                    &identity, &singles[i]) == XRT_SUCCESS);
+			}
+
+			REQUIRE(ipc_call_space_locate_spaces(&ipc_c, 0, &identity, at_timestamp_ns, &args, &batched) ==
+			        XRT_SUCCESS);
+
+			for (uint32_t i = 0; i < space_count; i++) {
+				const struct xrt_space_relation &a = singles[i];
+				const struct xrt_space_relation &b = batched.relations[i];
+
+				CHECK(a.relation_flags == b.relation_flags);
+				CHECK(b.pose.position.x == Approx((float)i * 0.1f).margin(tolerance));
+				CHECK(b.pose.position.x == Approx(a.pose.position.x).margin(tolerance));
+				CHECK(b.pose.position.y == Approx(a.pose.position.y).margin(tolerance));
+				CHECK(b.pose.orientation.w == Approx(a.pose.orientation.w).margin(tolerance));
+			}
+		}
+
+		// Stops the service thread.
+		shutdown(fds[0], SHUT_RDWR);
+	}
+
+	close(fds[0]);
+	close(fds[1]);
+	os_mutex_destroy(&ipc_c.mutex);
+}
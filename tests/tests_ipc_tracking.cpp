@@ -0,0 +1,353 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Replicated tracking tests, compares the client side interpolation
+ *        against the service side relation history, and against an IPC call.
+ *        Devices with a history publish their own samples and must match
+ *        exactly, devices without one are resampled by the publisher.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_device.h"
+#include "math/m_relation_history.h"
+
+#include "shared/ipc_tracking.h"
+#include "ipc_client_generated.h"
+
+#include "catch/catch.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+
+static constexpr uint64_t start_ns = 1000 * U_TIME_1MS_IN_NS;
+static constexpr uint64_t imu_period_ns = 1 * U_TIME_1MS_IN_NS;
+static constexpr uint64_t publish_period_ns = 2 * U_TIME_1MS_IN_NS;
+static constexpr float speed = 0.5f;                // m/s along x.
+static constexpr float acceleration = 4.0f;         // m/s^2 along x.
+static constexpr float angular_speed = 2.0f;        // rad/s around y.
+static constexpr float angular_acceleration = 8.0f; // rad/s^2 around y.
+static constexpr float tolerance = 0.0001f;
+
+//! Same samples and the same math on both sides, only rounding may differ.
+static constexpr float exact_tolerance = 0.000001f;
+
+namespace {
+
+//! An accelerating motion, what the device tracks.
+xrt_space_relation
+motion(uint64_t timestamp_ns)
+{
+	float t = (float)time_ns_to_s((int64_t)(timestamp_ns - start_ns));
+	float half_angle = (angular_speed * t + 0.5f * angular_acceleration * t * t) * 0.5f;
+
+	xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+	rel.relation_flags = (enum xrt_space_relation_flags)(
+	    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT | XRT_SPACE_RELATION_POSITION_VALID_BIT |
+	    XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT | XRT_SPACE_RELATION_POSITION_TRACKED_BIT |
+	    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT | XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT);
+	rel.pose.position = {speed * t + 0.5f * acceleration * t * t, 1.6f, 0.0f};
+	rel.pose.orientation = {0.0f, std::sin(half_angle), 0.0f, std::cos(half_angle)};
+	rel.linear_velocity = {speed + acceleration * t, 0.0f, 0.0f};
+	rel.angular_velocity = {0.0f, angular_speed + angular_acceleration * t, 0.0f};
+	return rel;
+}
+
+/*!
+ * A device that keeps a relation history of its samples, like most drivers do,
+ * this is the service side path. It hands the history out unless told not to.
+ */
+struct FakeDevice
+{
+	struct xrt_device base = {};
+	struct xrt_input inputs[2] = {};
+	struct m_relation_history *rh = nullptr;
+
+	FakeDevice(bool with_history = true)
+	{
+		inputs[0].name = XRT_INPUT_GENERIC_HEAD_POSE;
+		inputs[1].name = XRT_INPUT_GENERIC_HAND_TRACKING_LEFT;
+		base.inputs = inputs;
+		base.input_count = 2;
+		base.hand_tracking_supported = true;
+		base.get_tracked_pose = getTrackedPose;
+		base.get_tracked_pose_history = with_history ? getTrackedPoseHistory : nullptr;
+		base.get_hand_tracking = getHandTracking;
+		m_relation_history_create(&rh);
+	}
+
+	~FakeDevice()
+	{
+		m_relation_history_destroy(&rh);
+	}
+
+	void
+	sampleUntil(uint64_t timestamp_ns)
+	{
+		uint64_t latest_ns = start_ns;
+		xrt_space_relation latest = {};
+		m_relation_history_get_latest(rh, &latest_ns, &latest);
+
+		for (uint64_t t = latest_ns; t <= timestamp_ns; t += imu_period_ns) {
+			xrt_space_relation rel = motion(t);
+			m_relation_history_push(rh, &rel, t);
+		}
+	}
+
+	static void
+	getTrackedPose(struct xrt_device *xdev,
+	               enum xrt_input_name name,
+	               uint64_t at_timestamp_ns,
+	               struct xrt_space_relation *out_relation)
+	{
+		m_relation_history_get(((FakeDevice *)xdev)->rh, at_timestamp_ns, out_relation);
+	}
+
+	static xrt_result_t
+	getTrackedPoseHistory(struct xrt_device *xdev,
+	                      enum xrt_input_name name,
+	                      uint32_t max_count,
+	                      uint64_t *out_timestamps_ns,
+	                      struct xrt_space_relation *out_relations,
+	                      uint32_t *out_count)
+	{
+		*out_count = m_relation_history_get_newest(((FakeDevice *)xdev)->rh, max_count, out_timestamps_ns,
+		                                           out_relations);
+		return XRT_SUCCESS;
+	}
+
+	static void
+	getHandTracking(struct xrt_device *xdev,
+	                enum xrt_input_name name,
+	                uint64_t at_timestamp_ns,
+	                struct xrt_hand_joint_set *out_value,
+	                uint64_t *out_timestamp_ns)
+	{
+		out_value->is_active = true;
+		out_value->hand_pose = motion(at_timestamp_ns);
+		*out_timestamp_ns = at_timestamp_ns - imu_period_ns;
+	}
+};
+
+/*!
+ * Minimal service side, answers pose calls from the fake device.
+ */
+struct FakeService
+{
+	FakeDevice &device;
+	struct ipc_message_channel imc = {};
+	std::thread thread;
+
+	FakeService(FakeDevice &device, xrt_ipc_handle_t handle) : device(device)
+	{
+		imc.ipc_handle = handle;
+		imc.log_level = U_LOGGING_WARN;
+		thread = std::thread([this] { run(); });
+	}
+
+	~FakeService()
+	{
+		thread.join();
+	}
+
+	void
+	run()
+	{
+		alignas(8) uint8_t buf[IPC_BUF_SIZE];
+
+		while (true) {
+			ssize_t len = recv(imc.ipc_handle, buf, IPC_BUF_SIZE, 0);
+			if (len < 4 || *(ipc_command_t *)buf != IPC_DEVICE_GET_TRACKED_POSE) {
+				break; // Client closed the connection.
+			}
+
+			const auto *msg = (const struct ipc_device_get_tracked_pose_msg *)buf;
+			struct ipc_device_get_tracked_pose_reply reply = {};
+			reply.result = XRT_SUCCESS;
+			xrt_device_get_tracked_pose(&device.base, msg->name, msg->at_timestamp, &reply.relation);
+			ipc_send(&imc, &reply, sizeof(reply));
+		}
+	}
+};
+
+void
+checkRelation(const xrt_space_relation &a, const xrt_space_relation &b, float margin = tolerance)
+{
+	CHECK(a.relation_flags == b.relation_flags);
+	CHECK(a.pose.position.x == Approx(b.pose.position.x).margin(margin));
+	CHECK(a.pose.position.y == Approx(b.pose.position.y).margin(margin));
+	CHECK(a.pose.orientation.y == Approx(b.pose.orientation.y).margin(margin));
+	CHECK(a.pose.orientation.w == Approx(b.pose.orientation.w).margin(margin));
+	CHECK(a.linear_velocity.x == Approx(b.linear_velocity.x).margin(margin));
+	CHECK(a.angular_velocity.y == Approx(b.angular_velocity.y).margin(margin));
+}
+
+//! Runs the device and publisher for @p sample_count publishes, returns the last publish time.
+uint64_t
+publish(FakeDevice &device, struct ipc_shared_device_tracking &isdt, uint32_t sample_count)
+{
+	uint64_t now_ns = start_ns;
+	for (uint32_t i = 0; i < sample_count; i++) {
+		now_ns = start_ns + i * publish_period_ns;
+		device.sampleUntil(now_ns);
+		ipc_tracking_publish(&isdt, &device.base, now_ns);
+	}
+	return now_ns;
+}
+
+} // namespace
+
+TEST_CASE("ipc_tracking")
+{
+	FakeDevice device;
+	struct ipc_shared_device_tracking isdt = {};
+	ipc_tracking_init(&isdt, &device.base);
+
+	REQUIRE(isdt.pose_count == 1);
+	REQUIRE(isdt.hand_count == 1);
+
+	const enum xrt_input_name name = XRT_INPUT_GENERIC_HEAD_POSE;
+	xrt_space_relation local = {};
+	xrt_space_relation service = {};
+
+	SECTION("Nothing published falls back")
+	{
+		CHECK_FALSE(ipc_tracking_get_tracked_pose(&isdt, name, start_ns, start_ns, &local));
+	}
+
+	// More publishes than the history holds.
+	const uint64_t newest_ns = publish(device, isdt, IPC_SHARED_POSE_HISTORY_SIZE * 3);
+	const uint64_t oldest_ns = newest_ns - (IPC_SHARED_POSE_HISTORY_SIZE - 1) * imu_period_ns;
+	REQUIRE(isdt.poses[0].sample_count == IPC_SHARED_POSE_HISTORY_SIZE);
+
+	SECTION("Publishes the samples of the device")
+	{
+		uint64_t timestamps[IPC_SHARED_POSE_HISTORY_SIZE];
+		xrt_space_relation relations[IPC_SHARED_POSE_HISTORY_SIZE];
+		REQUIRE(m_relation_history_get_newest(device.rh, IPC_SHARED_POSE_HISTORY_SIZE, timestamps, relations) ==
+		        IPC_SHARED_POSE_HISTORY_SIZE);
+
+		const struct ipc_shared_tracked_pose &pose = isdt.poses[0];
+		CHECK(pose.published_ns == newest_ns);
+		for (uint32_t i = 0; i < IPC_SHARED_POSE_HISTORY_SIZE; i++) {
+			uint32_t index = (pose.newest + 1 + i) % IPC_SHARED_POSE_HISTORY_SIZE;
+			CHECK(pose.samples[index].timestamp_ns == timestamps[i]);
+			CHECK(memcmp(&pose.samples[index].relation, &relations[i], sizeof(relations[i])) == 0);
+		}
+	}
+
+	SECTION("Matches the service side relation history")
+	{
+		// Exact, interpolated, and predicted up to the limit, in 0.25ms steps.
+		const uint64_t step_ns = U_TIME_1MS_IN_NS / 4;
+		for (uint64_t t = oldest_ns; t <= newest_ns + IPC_TRACKING_MAX_PREDICTION_NS; t += step_ns) {
+			REQUIRE(ipc_tracking_get_tracked_pose(&isdt, name, t, newest_ns, &local));
+			xrt_device_get_tracked_pose(&device.base, name, t, &service);
+			checkRelation(local, service, exact_tolerance);
+		}
+	}
+
+	SECTION("Falls back outside of the published data")
+	{
+		CHECK_FALSE(ipc_tracking_get_tracked_pose(&isdt, name, oldest_ns - 1, newest_ns, &local));
+		CHECK_FALSE(ipc_tracking_get_tracked_pose(
+		    &isdt, name, newest_ns + IPC_TRACKING_MAX_PREDICTION_NS + 1, newest_ns, &local));
+		CHECK_FALSE(ipc_tracking_get_tracked_pose(&isdt, name, 0, newest_ns, &local));
+		CHECK_FALSE(ipc_tracking_get_tracked_pose(&isdt, XRT_INPUT_GENERIC_HAND_TRACKING_LEFT, newest_ns,
+		                                          newest_ns, &local));
+	}
+
+	SECTION("Falls back when the service stopped publishing")
+	{
+		uint64_t now_ns = newest_ns + IPC_TRACKING_MAX_AGE_NS + 1;
+		CHECK_FALSE(ipc_tracking_get_tracked_pose(&isdt, name, newest_ns, now_ns, &local));
+	}
+
+	SECTION("Falls back while the service is writing")
+	{
+		isdt.seq++;
+		CHECK_FALSE(ipc_tracking_get_tracked_pose(&isdt, name, newest_ns, newest_ns, &local));
+		isdt.seq++;
+		CHECK(ipc_tracking_get_tracked_pose(&isdt, name, newest_ns, newest_ns, &local));
+	}
+
+	SECTION("Hand tracking")
+	{
+		const enum xrt_input_name hand = XRT_INPUT_GENERIC_HAND_TRACKING_LEFT;
+		struct xrt_hand_joint_set value = {};
+		uint64_t timestamp_ns = 0;
+
+		REQUIRE(ipc_tracking_get_hand_tracking(&isdt, hand, newest_ns, newest_ns, &value, &timestamp_ns));
+		CHECK(value.is_active);
+		CHECK(timestamp_ns == newest_ns - imu_period_ns);
+		checkRelation(value.hand_pose, motion(newest_ns));
+
+		uint64_t stale_ns = newest_ns + IPC_TRACKING_MAX_AGE_NS + 1;
+		CHECK_FALSE(ipc_tracking_get_hand_tracking(&isdt, hand, stale_ns, stale_ns, &value, &timestamp_ns));
+	}
+
+	SECTION("Matches an IPC call")
+	{
+		int fds[2] = {-1, -1};
+		REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+		struct ipc_connection ipc_c = {};
+		ipc_c.imc.ipc_handle = fds[0];
+		ipc_c.imc.log_level = U_LOGGING_WARN;
+		ipc_c.log_level = U_LOGGING_WARN;
+		os_mutex_init(&ipc_c.mutex);
+
+		{
+			FakeService fake_service(device, fds[1]);
+
+			// Interpolated and predicted.
+			const uint64_t step_ns = 5 * U_TIME_1MS_IN_NS / 4;
+			for (uint64_t t = oldest_ns; t <= newest_ns + 20 * U_TIME_1MS_IN_NS; t += step_ns) {
+				REQUIRE(ipc_call_device_get_tracked_pose(&ipc_c, 0, name, t, &service) == XRT_SUCCESS);
+				REQUIRE(ipc_tracking_get_tracked_pose(&isdt, name, t, newest_ns, &local));
+				checkRelation(local, service, exact_tolerance);
+			}
+
+			// Stops the service thread.
+			shutdown(fds[0], SHUT_RDWR);
+		}
+
+		close(fds[0]);
+		close(fds[1]);
+		os_mutex_destroy(&ipc_c.mutex);
+	}
+}
+
+TEST_CASE("ipc_tracking_resampled")
+{
+	FakeDevice device(false);
+	struct ipc_shared_device_tracking isdt = {};
+	ipc_tracking_init(&isdt, &device.base);
+
+	const enum xrt_input_name name = XRT_INPUT_GENERIC_HEAD_POSE;
+	xrt_space_relation local = {};
+	xrt_space_relation service = {};
+
+	// More publishes than the history holds, so the ring buffer has wrapped.
+	const uint64_t newest_ns = publish(device, isdt, IPC_SHARED_POSE_HISTORY_SIZE * 3);
+	const uint64_t oldest_ns = newest_ns - (IPC_SHARED_POSE_HISTORY_SIZE - 1) * publish_period_ns;
+	REQUIRE(isdt.poses[0].sample_count == IPC_SHARED_POSE_HISTORY_SIZE);
+
+	// The publisher sampled at its own times, not at those of the device.
+	const struct ipc_shared_tracked_pose &pose = isdt.poses[0];
+	CHECK(pose.samples[pose.newest].timestamp_ns == newest_ns);
+	CHECK(pose.samples[(pose.newest + 1) % IPC_SHARED_POSE_HISTORY_SIZE].timestamp_ns == oldest_ns);
+
+	// Every other device sample is skipped, close but not exact.
+	const uint64_t step_ns = U_TIME_1MS_IN_NS / 4;
+	for (uint64_t t = oldest_ns; t <= newest_ns + IPC_TRACKING_MAX_PREDICTION_NS; t += step_ns) {
+		REQUIRE(ipc_tracking_get_tracked_pose(&isdt, name, t, newest_ns, &local));
+		xrt_device_get_tracked_pose(&device.base, name, t, &service);
+		checkRelation(local, service);
+	}
+}
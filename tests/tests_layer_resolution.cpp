@@ -0,0 +1,134 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Recommended layer resolution tests, feeds synthetic GPU timing
+ *        histories and checks the scale follows the headroom.
+ * @author agent <agent@local>
+ */
+
+#include <util/u_layer_resolution.h>
+
+#include "catch/catch.hpp"
+
+#include <cmath>
+
+
+static constexpr uint64_t budget_ns = 11111111; // 90Hz.
+
+namespace {
+
+/*!
+ * Synthetic GPU whose frame time scales with the pixel count, @p full_ratio is
+ * how much of the budget a full resolution frame uses. Returns the number of
+ * scale changes over @p count frames.
+ */
+int
+renderFrames(struct u_layer_resolution &ulr, double full_ratio, int count)
+{
+	int changes = 0;
+	for (int i = 0; i < count; i++) {
+		double pixels = (double)ulr.scale * (double)ulr.scale;
+		uint64_t used_ns = (uint64_t)(full_ratio * pixels * (double)budget_ns);
+
+		float scale = 0.0f;
+		if (u_layer_resolution_push(&ulr, used_ns, budget_ns, &scale)) {
+			CHECK(scale == ulr.scale);
+			changes++;
+		}
+	}
+	return changes;
+}
+
+} // namespace
+
+TEST_CASE("u_layer_resolution")
+{
+	struct u_layer_resolution ulr;
+	u_layer_resolution_init(&ulr);
+
+	CHECK(ulr.scale == 1.0f);
+
+	SECTION("Stays at full resolution with headroom")
+	{
+		CHECK(renderFrames(ulr, 0.4, 300) == 0);
+		CHECK(ulr.scale == 1.0f);
+	}
+
+	SECTION("Zero budget is ignored")
+	{
+		float scale = 0.0f;
+		for (int i = 0; i < 100; i++) {
+			CHECK_FALSE(u_layer_resolution_push(&ulr, budget_ns * 2, 0, &scale));
+		}
+		CHECK(ulr.headroom.samples_since_change == 0);
+		CHECK(ulr.scale == 1.0f);
+	}
+
+	SECTION("No change during warm up")
+	{
+		CHECK(renderFrames(ulr, 1.5, U_LAYER_RESOLUTION_MIN_SAMPLES - 1) == 0);
+		CHECK(ulr.scale == 1.0f);
+
+		CHECK(renderFrames(ulr, 1.5, 1) == 1);
+		CHECK(ulr.scale < 1.0f);
+	}
+
+	SECTION("Overloaded GPU settles within the target band")
+	{
+		renderFrames(ulr, 1.5, 300);
+
+		// sqrt(0.8 / 1.5) is about 0.73, quantised down to a step.
+		CHECK(ulr.scale == Approx(0.7f).margin(0.001f));
+
+		// Settled, no more changes.
+		CHECK(renderFrames(ulr, 1.5, 300) == 0);
+
+		double ratio = 1.5 * ulr.scale * ulr.scale;
+		CHECK(std::fabs(ratio - U_LAYER_RESOLUTION_TARGET_RATIO) < U_HEADROOM_HYSTERESIS);
+	}
+
+	SECTION("Never goes below the minimum scale")
+	{
+		renderFrames(ulr, 10.0, 300);
+		CHECK(ulr.scale == U_LAYER_RESOLUTION_MIN_SCALE);
+	}
+
+	SECTION("Scale is always a multiple of the step")
+	{
+		renderFrames(ulr, 1.23, 300);
+		float steps = ulr.scale / U_LAYER_RESOLUTION_STEP;
+		CHECK(steps == Approx(std::round(steps)).margin(0.001f));
+	}
+
+	SECTION("Hysteresis holds the scale with a small load change")
+	{
+		renderFrames(ulr, 1.5, 300);
+		float settled = ulr.scale;
+
+		// A few percent more or less work stays within the dead band.
+		CHECK(renderFrames(ulr, 1.5 * 1.05, 300) == 0);
+		CHECK(renderFrames(ulr, 1.5 * 0.95, 300) == 0);
+		CHECK(ulr.scale == settled);
+	}
+
+	SECTION("Recovers to full resolution when the load goes away")
+	{
+		renderFrames(ulr, 1.5, 300);
+		REQUIRE(ulr.scale < 1.0f);
+
+		renderFrames(ulr, 0.3, 300);
+		CHECK(ulr.scale == 1.0f);
+	}
+
+	SECTION("Single spikes are smoothed out")
+	{
+		float scale = 0.0f;
+		for (int i = 0; i < 300; i++) {
+			// Every tenth frame takes twice the budget, average is ~0.64.
+			uint64_t used_ns = (i % 10) == 0 ? budget_ns * 2 : budget_ns / 2;
+			CHECK_FALSE(u_layer_resolution_push(&ulr, used_ns, budget_ns, &scale));
+		}
+		CHECK(ulr.scale == 1.0f);
+	}
+}
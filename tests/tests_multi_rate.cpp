@@ -0,0 +1,289 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Multi compositor rate policy tests, counts the frames that sessions
+ *        in the background produce on top of a null native compositor.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_compositor.h"
+#include "os/os_time.h"
+#include "util/u_pacing.h"
+#include "util/u_time.h"
+
+#include "multi/comp_multi_interface.h"
+
+#include "catch/catch.hpp"
+
+#include <atomic>
+#include <stdlib.h>
+#include <thread>
+
+
+static constexpr uint64_t period_ns = 10 * U_TIME_1MS_IN_NS;
+static constexpr uint64_t run_ns = 600 * U_TIME_1MS_IN_NS;
+
+namespace {
+
+/*!
+ * A native compositor that displays nothing, it only paces the frames of the
+ * multi compositor at a fixed display rate.
+ */
+struct NullCompositor
+{
+	struct xrt_compositor_native base = {};
+	struct u_pacing_compositor *upc = nullptr;
+
+	NullCompositor()
+	{
+		u_pc_fake_create(period_ns, os_monotonic_get_ns(), &upc);
+
+		base.base.begin_session = beginSession;
+		base.base.end_session = endSession;
+		base.base.predict_frame = predictFrame;
+		base.base.mark_frame = markFrame;
+		base.base.begin_frame = beginFrame;
+		base.base.discard_frame = discardFrame;
+		base.base.layer_begin = layerBegin;
+		base.base.layer_commit = layerCommit;
+		base.base.destroy = destroy;
+	}
+
+	~NullCompositor()
+	{
+		u_pc_destroy(&upc);
+	}
+
+	static xrt_result_t
+	beginSession(struct xrt_compositor *xc, const struct xrt_begin_session_info *info)
+	{
+		return XRT_SUCCESS;
+	}
+
+	static xrt_result_t
+	endSession(struct xrt_compositor *xc)
+	{
+		return XRT_SUCCESS;
+	}
+
+	static xrt_result_t
+	predictFrame(struct xrt_compositor *xc,
+	             int64_t *out_frame_id,
+	             uint64_t *out_wake_time_ns,
+	             uint64_t *out_predicted_gpu_time_ns,
+	             uint64_t *out_predicted_display_time_ns,
+	             uint64_t *out_predicted_display_period_ns)
+	{
+		NullCompositor *c = (NullCompositor *)xc;
+		uint64_t desired_present_time_ns = 0;
+		uint64_t present_slop_ns = 0;
+		uint64_t min_display_period_ns = 0;
+
+		u_pc_predict(c->upc, os_monotonic_get_ns(), out_frame_id, out_wake_time_ns, &desired_present_time_ns,
+		             &present_slop_ns, out_predicted_display_time_ns, out_predicted_display_period_ns,
+		             &min_display_period_ns);
+		*out_predicted_gpu_time_ns = *out_wake_time_ns;
+
+		return XRT_SUCCESS;
+	}
+
+	static xrt_result_t
+	markFrame(struct xrt_compositor *xc, int64_t frame_id, enum xrt_compositor_frame_point point, uint64_t when_ns)
+	{
+		NullCompositor *c = (NullCompositor *)xc;
+		u_pc_mark_point(c->upc, U_TIMING_POINT_WAKE_UP, frame_id, when_ns);
+		return XRT_SUCCESS;
+	}
+
+	static xrt_result_t
+	beginFrame(struct xrt_compositor *xc, int64_t frame_id)
+	{
+		return XRT_SUCCESS;
+	}
+
+	static xrt_result_t
+	discardFrame(struct xrt_compositor *xc, int64_t frame_id)
+	{
+		return XRT_SUCCESS;
+	}
+
+	static xrt_result_t
+	layerBegin(struct xrt_compositor *xc, const struct xrt_layer_frame_data *data)
+	{
+		return XRT_SUCCESS;
+	}
+
+	static xrt_result_t
+	layerCommit(struct xrt_compositor *xc, xrt_graphics_sync_handle_t sync_handle)
+	{
+		return XRT_SUCCESS;
+	}
+
+	static void
+	destroy(struct xrt_compositor *xc)
+	{
+		delete (NullCompositor *)xc;
+	}
+};
+
+//! A session that does no work, it submits a frame as soon as it has been woken up.
+struct Client
+{
+	struct xrt_compositor_native *xcn = nullptr;
+	std::atomic<uint32_t> frame_count{0};
+
+	explicit Client(struct xrt_system_compositor *xsysc)
+	{
+		struct xrt_session_info xsi = {};
+		REQUIRE(xrt_syscomp_create_native_compositor(xsysc, &xsi, &xcn) == XRT_SUCCESS);
+
+		struct xrt_begin_session_info begin_info = {};
+		begin_info.view_type = XRT_VIEW_TYPE_STEREO;
+		REQUIRE(xrt_comp_begin_session(&xcn->base, &begin_info) == XRT_SUCCESS);
+	}
+
+	~Client()
+	{
+		xrt_comp_end_session(&xcn->base);
+		xrt_comp_native_destroy(&xcn);
+	}
+
+	void
+	run(uint64_t end_ns)
+	{
+		struct xrt_compositor *xc = &xcn->base;
+
+		while (os_monotonic_get_ns() < end_ns) {
+			int64_t frame_id = -1;
+			uint64_t display_time_ns = 0;
+			uint64_t display_period_ns = 0;
+
+			if (xrt_comp_wait_frame(xc, &frame_id, &display_time_ns, &display_period_ns) != XRT_SUCCESS ||
+			    xrt_comp_begin_frame(xc, frame_id) != XRT_SUCCESS) {
+				break;
+			}
+
+			struct xrt_layer_frame_data data = {};
+			data.frame_id = frame_id;
+			data.display_time_ns = display_time_ns;
+			data.env_blend_mode = XRT_BLEND_MODE_OPAQUE;
+
+			if (xrt_comp_layer_begin(xc, &data) != XRT_SUCCESS ||
+			    xrt_comp_layer_commit(xc, XRT_GRAPHICS_SYNC_HANDLE_INVALID) != XRT_SUCCESS) {
+				break;
+			}
+
+			frame_count++;
+		}
+	}
+};
+
+//! Runs the frame loops of both clients at the same time, like two apps would.
+void
+runBoth(Client &foreground, Client &background)
+{
+	foreground.frame_count = 0;
+	background.frame_count = 0;
+
+	uint64_t end_ns = os_monotonic_get_ns() + run_ns;
+	std::thread fg([&] { foreground.run(end_ns); });
+	std::thread bg([&] { background.run(end_ns); });
+	fg.join();
+	bg.join();
+}
+
+} // namespace
+
+TEST_CASE("multi_rate_policy")
+{
+	// Read once, when the first system compositor is created.
+	setenv("XRT_COMPOSITOR_INVISIBLE_RATE_DIVISOR", "4", 1);
+	setenv("XRT_COMPOSITOR_UNFOCUSED_RATE_DIVISOR", "2", 1);
+	setenv("XRT_COMPOSITOR_POWER_SAVINGS_RATE_DIVISOR", "2", 1);
+
+	struct u_pacing_app_factory *upaf = nullptr;
+	REQUIRE(u_pa_factory_create(&upaf) == XRT_SUCCESS);
+
+	struct xrt_system_compositor_info xsci = {};
+	struct xrt_system_compositor *xsysc = nullptr;
+	NullCompositor *nc = new NullCompositor();
+	REQUIRE(comp_multi_create_system_compositor(&nc->base, upaf, &xsci, false, &xsysc) == XRT_SUCCESS);
+
+	{
+		Client foreground(xsysc);
+		Client background(xsysc);
+		REQUIRE(xrt_syscomp_set_state(xsysc, &foreground.xcn->base, true, true) == XRT_SUCCESS);
+
+		SECTION("Invisible sessions are throttled")
+		{
+			REQUIRE(xrt_syscomp_set_state(xsysc, &background.xcn->base, false, false) == XRT_SUCCESS);
+			runBoth(foreground, background);
+
+			uint32_t fg = foreground.frame_count;
+			uint32_t bg = background.frame_count;
+			CAPTURE(fg, bg);
+
+			// Close to the display rate, and around a quarter of that.
+			CHECK(fg > run_ns / period_ns / 2);
+			CHECK(bg > 0);
+			CHECK(bg * 2 < fg);
+		}
+
+		SECTION("Unfocused sessions run at a reduced rate")
+		{
+			REQUIRE(xrt_syscomp_set_state(xsysc, &background.xcn->base, true, false) == XRT_SUCCESS);
+			runBoth(foreground, background);
+
+			uint32_t fg = foreground.frame_count;
+			uint32_t bg = background.frame_count;
+			CAPTURE(fg, bg);
+
+			// Around half the display rate.
+			CHECK(bg * 4 < fg * 3);
+			CHECK(bg * 4 > fg);
+		}
+
+		SECTION("The power savings performance level halves the rate")
+		{
+			REQUIRE(xrt_syscomp_set_state(xsysc, &background.xcn->base, true, true) == XRT_SUCCESS);
+			REQUIRE(xrt_comp_set_performance_level(&background.xcn->base, XRT_PERF_DOMAIN_GPU,
+			                                       XRT_PERF_SET_LEVEL_POWER_SAVINGS) == XRT_SUCCESS);
+			runBoth(foreground, background);
+
+			uint32_t fg = foreground.frame_count;
+			uint32_t bg = background.frame_count;
+			CAPTURE(fg, bg);
+
+			CHECK(bg * 4 < fg * 3);
+			CHECK(bg * 4 > fg);
+
+			// Back to full rate once the app asks for more again.
+			REQUIRE(xrt_comp_set_performance_level(&background.xcn->base, XRT_PERF_DOMAIN_GPU,
+			                                       XRT_PERF_SET_LEVEL_SUSTAINED_HIGH) == XRT_SUCCESS);
+			runBoth(foreground, background);
+
+			fg = foreground.frame_count;
+			bg = background.frame_count;
+			CHECK(bg * 4 > fg * 3);
+		}
+
+		SECTION("Sessions that become visible and focused go back to full rate")
+		{
+			REQUIRE(xrt_syscomp_set_state(xsysc, &background.xcn->base, false, false) == XRT_SUCCESS);
+			runBoth(foreground, background);
+			REQUIRE(background.frame_count * 2 < foreground.frame_count);
+
+			REQUIRE(xrt_syscomp_set_state(xsysc, &background.xcn->base, true, true) == XRT_SUCCESS);
+			runBoth(foreground, background);
+
+			uint32_t fg = foreground.frame_count;
+			uint32_t bg = background.frame_count;
+			CAPTURE(fg, bg);
+
+			CHECK(bg * 4 > fg * 3);
+		}
+	}
+
+	xrt_syscomp_destroy(&xsysc);
+}
@@ -386,3 +386,45 @@ TEST_CASE("u_pacing_compositor_fake")
 	}
 	u_pc_destroy(&upc);
 }
+
+TEST_CASE("u_pacing_app_rate_divisor")
+{
+	MockClock clock;
+	u_pacing_app_factory *upaf = nullptr;
+	REQUIRE(XRT_SUCCESS == u_pa_factory_create(&upaf));
+	u_pacing_app *upa = nullptr;
+	u_paf_create(upaf, &upa);
+	REQUIRE(upa != nullptr);
+
+	clock.advance(1s);
+	u_pa_info(upa, clock.now() + frame_interval_ns.count(), frame_interval_ns.count(), 0);
+
+	int64_t frame_id = -1;
+	uint64_t wake_up_time_ns = 0;
+	uint64_t first_display_time_ns = 0;
+	uint64_t display_time_ns = 0;
+	uint64_t display_period_ns = 0;
+
+	u_pa_predict(upa, clock.now(), &frame_id, &wake_up_time_ns, &first_display_time_ns, &display_period_ns);
+	CHECK(unanoseconds(display_period_ns) == frame_interval_ns);
+
+	SECTION("Half rate")
+	{
+		u_pa_set_rate_divisor(upa, 2);
+		u_pa_predict(upa, clock.now(), &frame_id, &wake_up_time_ns, &display_time_ns, &display_period_ns);
+		CHECK(unanoseconds(display_period_ns) == frame_interval_ns * 2);
+		CHECK(display_time_ns > first_display_time_ns + frame_interval_ns.count());
+		CHECK(wake_up_time_ns < display_time_ns);
+	}
+
+	SECTION("Zero is full rate")
+	{
+		u_pa_set_rate_divisor(upa, 2);
+		u_pa_set_rate_divisor(upa, 0);
+		u_pa_predict(upa, clock.now(), &frame_id, &wake_up_time_ns, &display_time_ns, &display_period_ns);
+		CHECK(unanoseconds(display_period_ns) == frame_interval_ns);
+	}
+
+	u_pa_destroy(&upa);
+	u_paf_destroy(&upaf);
+}
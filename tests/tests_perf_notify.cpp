@@ -0,0 +1,123 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Performance notification level tests.
+ * @author agent <agent@local>
+ */
+
+#include <util/u_perf_notify.h>
+
+#include "catch/catch.hpp"
+
+
+static constexpr uint64_t budget_ns = 10000000;
+
+namespace {
+
+/*!
+ * Push the same sample @p count times, returns how many times the level
+ * changed and stores the last change in @p out_from and @p out_to.
+ */
+int
+pushSamples(struct u_perf_notify &upn,
+            double ratio,
+            int count,
+            enum xrt_perf_notify_level &out_from,
+            enum xrt_perf_notify_level &out_to)
+{
+	int changes = 0;
+	for (int i = 0; i < count; i++) {
+		uint64_t used_ns = (uint64_t)(ratio * (double)budget_ns);
+		if (u_perf_notify_push(&upn, used_ns, budget_ns, &out_from, &out_to)) {
+			changes++;
+		}
+	}
+	return changes;
+}
+
+} // namespace
+
+TEST_CASE("u_perf_notify")
+{
+	struct u_perf_notify upn;
+	u_perf_notify_init(&upn);
+
+	enum xrt_perf_notify_level from = XRT_PERF_NOTIFY_LEVEL_NORMAL;
+	enum xrt_perf_notify_level to = XRT_PERF_NOTIFY_LEVEL_NORMAL;
+
+	CHECK(upn.level == XRT_PERF_NOTIFY_LEVEL_NORMAL);
+
+	SECTION("Stays normal when within budget")
+	{
+		CHECK(pushSamples(upn, 0.5, 100, from, to) == 0);
+		CHECK(upn.level == XRT_PERF_NOTIFY_LEVEL_NORMAL);
+	}
+
+	SECTION("Zero budget is ignored")
+	{
+		for (int i = 0; i < 100; i++) {
+			CHECK_FALSE(u_perf_notify_push(&upn, budget_ns * 2, 0, &from, &to));
+		}
+		CHECK(upn.headroom.sample_count == 0);
+		CHECK(upn.level == XRT_PERF_NOTIFY_LEVEL_NORMAL);
+	}
+
+	SECTION("No change during warm up")
+	{
+		CHECK(pushSamples(upn, 2.0, U_PERF_NOTIFY_MIN_SAMPLES - 1, from, to) == 0);
+		CHECK(upn.level == XRT_PERF_NOTIFY_LEVEL_NORMAL);
+
+		CHECK(pushSamples(upn, 2.0, 1, from, to) == 1);
+		CHECK(from == XRT_PERF_NOTIFY_LEVEL_NORMAL);
+		CHECK(to == XRT_PERF_NOTIFY_LEVEL_IMPAIRED);
+	}
+
+	SECTION("Escalates to warning")
+	{
+		CHECK(pushSamples(upn, 0.9, 100, from, to) == 1);
+		CHECK(from == XRT_PERF_NOTIFY_LEVEL_NORMAL);
+		CHECK(to == XRT_PERF_NOTIFY_LEVEL_WARNING);
+		CHECK(upn.level == XRT_PERF_NOTIFY_LEVEL_WARNING);
+
+		SECTION("Then to impaired")
+		{
+			CHECK(pushSamples(upn, 1.5, 100, from, to) == 1);
+			CHECK(from == XRT_PERF_NOTIFY_LEVEL_WARNING);
+			CHECK(to == XRT_PERF_NOTIFY_LEVEL_IMPAIRED);
+		}
+
+		SECTION("Hysteresis keeps warning just below the threshold")
+		{
+			CHECK(pushSamples(upn, U_PERF_NOTIFY_WARNING_RATIO - U_HEADROOM_HYSTERESIS / 2, 100, from,
+			                  to) == 0);
+			CHECK(upn.level == XRT_PERF_NOTIFY_LEVEL_WARNING);
+		}
+
+		SECTION("Goes back to normal when clearly within budget")
+		{
+			CHECK(pushSamples(upn, 0.5, 100, from, to) == 1);
+			CHECK(from == XRT_PERF_NOTIFY_LEVEL_WARNING);
+			CHECK(to == XRT_PERF_NOTIFY_LEVEL_NORMAL);
+		}
+	}
+
+	SECTION("Impaired de-escalates through warning")
+	{
+		CHECK(pushSamples(upn, 2.0, 100, from, to) == 1);
+		CHECK(upn.level == XRT_PERF_NOTIFY_LEVEL_IMPAIRED);
+
+		// Just below the impaired threshold, held by hysteresis.
+		CHECK(pushSamples(upn, U_PERF_NOTIFY_IMPAIRED_RATIO - U_HEADROOM_HYSTERESIS / 2, 100, from, to) ==
+		      0);
+		CHECK(upn.level == XRT_PERF_NOTIFY_LEVEL_IMPAIRED);
+
+		CHECK(pushSamples(upn, 0.8, 100, from, to) == 1);
+		CHECK(from == XRT_PERF_NOTIFY_LEVEL_IMPAIRED);
+		CHECK(to == XRT_PERF_NOTIFY_LEVEL_WARNING);
+
+		CHECK(pushSamples(upn, 0.1, 100, from, to) == 1);
+		CHECK(from == XRT_PERF_NOTIFY_LEVEL_WARNING);
+		CHECK(to == XRT_PERF_NOTIFY_LEVEL_NORMAL);
+	}
+}
@@ -0,0 +1,311 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Prober hotplug tests, feeds events from a mocked source in place of
+ *        the udev monitor and checks which drivers get to see which devices.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_prober.h"
+#include "prober/p_prober.h"
+
+#include "catch/catch.hpp"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+
+static constexpr uint16_t vendor_id = 0x1234;
+static constexpr uint16_t product_id = 0x0001;
+static constexpr uint16_t other_product_id = 0x0002;
+static constexpr uint64_t settle_ns = 1000;
+
+namespace {
+
+/*!
+ * Stands in for the udev monitor, events are handed out in order.
+ */
+struct MockSource
+{
+	struct p_hotplug_source base = {};
+	std::deque<struct p_hotplug_event> events;
+
+	MockSource()
+	{
+		base.next_event = nextEvent;
+		base.destroy = destroy;
+	}
+
+	static bool
+	nextEvent(struct p_hotplug_source *src, struct p_hotplug_event *out_event)
+	{
+		auto *mock = (MockSource *)src;
+		if (mock->events.empty()) {
+			return false;
+		}
+		*out_event = mock->events.front();
+		mock->events.pop_front();
+		return true;
+	}
+
+	static void
+	destroy(struct p_hotplug_source *src)
+	{
+		// Owned by the test.
+	}
+
+	void
+	plug(uint16_t addr, uint16_t product)
+	{
+		struct p_hotplug_event ev = {};
+		ev.type = P_HOTPLUG_TYPE_USB;
+		ev.bus = XRT_BUS_TYPE_USB;
+		ev.vendor_id = vendor_id;
+		ev.product_id = product;
+		ev.usb.bus = 1;
+		ev.usb.addr = addr;
+		ev.usb.product = "Test Device";
+		events.push_back(ev);
+	}
+
+	void
+	plugHidraw(uint16_t addr, uint16_t product, const char *path)
+	{
+		plug(addr, product);
+		events.back().type = P_HOTPLUG_TYPE_HIDRAW;
+		events.back().path = path;
+	}
+
+	void
+	unplug(uint16_t addr)
+	{
+		struct p_hotplug_event ev = {};
+		ev.removed = true;
+		ev.type = P_HOTPLUG_TYPE_USB;
+		ev.bus = XRT_BUS_TYPE_USB;
+		ev.usb.bus = 1;
+		ev.usb.addr = addr;
+		events.push_back(ev);
+	}
+};
+
+struct TestDevice
+{
+	struct xrt_device base = {};
+
+	TestDevice()
+	{
+		base.destroy = destroy;
+		snprintf(base.str, sizeof(base.str), "Test Device");
+	}
+
+	static void
+	destroy(struct xrt_device *xdev)
+	{
+		delete (TestDevice *)xdev;
+	}
+};
+
+struct Event
+{
+	enum xrt_prober_hotplug_event event;
+	uint16_t product_id;
+	size_t xdev_count;
+};
+
+std::vector<uint16_t> found_products;
+std::vector<Event> events;
+
+//! Devices handed out by added events that have not been removed yet.
+std::vector<struct xrt_device *> owned;
+
+int
+testFound(struct xrt_prober *xp,
+          struct xrt_prober_device **devices,
+          size_t num_devices,
+          size_t index,
+          cJSON *attached_data,
+          struct xrt_device **out_xdevs)
+{
+	found_products.push_back(devices[index]->product_id);
+	out_xdevs[0] = &(new TestDevice())->base;
+	return 1;
+}
+
+void
+hotplugCb(struct xrt_prober *xp,
+          enum xrt_prober_hotplug_event event,
+          struct xrt_prober_device *xpdev,
+          struct xrt_device **xdevs,
+          size_t xdev_count,
+          void *ptr)
+{
+	events.push_back({event, xpdev->product_id, xdev_count});
+
+	for (size_t i = 0; i < xdev_count; i++) {
+		if (event == XRT_PROBER_HOTPLUG_ADDED) {
+			owned.push_back(xdevs[i]);
+			continue;
+		}
+
+		// Removal hands back the same devices, which are ours to destroy.
+		auto it = std::find(owned.begin(), owned.end(), xdevs[i]);
+		REQUIRE(it != owned.end());
+		owned.erase(it);
+		xrt_device_destroy(&xdevs[i]);
+	}
+}
+
+struct xrt_prober_entry test_entries[] = {
+    {vendor_id, product_id, testFound, "Test Device", "test"},
+    {0x0000, 0x0000, nullptr, nullptr, nullptr}, // Terminate
+};
+
+struct xrt_prober_entry *entries[] = {test_entries, nullptr};
+
+xrt_builder_create_func_t builders[] = {nullptr};
+
+xrt_auto_prober_create_func_t auto_probers[] = {nullptr};
+
+struct xrt_prober_entry_lists lists = {builders, entries, auto_probers, nullptr};
+
+} // namespace
+
+TEST_CASE("prober_hotplug")
+{
+	// Keep the prober away from the user's config.
+	char config_dir[] = "/tmp/tests_prober_hotplug_XXXXXX";
+	REQUIRE(mkdtemp(config_dir) != nullptr);
+	setenv("XDG_CONFIG_HOME", config_dir, 1);
+
+	found_products.clear();
+	events.clear();
+	owned.clear();
+
+	struct xrt_prober *xp = nullptr;
+	REQUIRE(xrt_prober_create_with_lists(&xp, &lists) == 0);
+
+	// Swap the system sources for the mocked one.
+	struct prober *p = (struct prober *)xp;
+	MockSource mock;
+	p_hotplug_teardown(p);
+	p_hotplug_add_source(p, &mock.base);
+	p->hotplug.settle_ns = settle_ns;
+
+	SECTION("Added devices are only given to their driver once settled")
+	{
+		mock.plug(5, product_id);
+		mock.plug(6, other_product_id);
+		REQUIRE(p_hotplug_handle(p, 0, hotplugCb, nullptr) == XRT_SUCCESS);
+		CHECK(p->device_count == 2);
+		CHECK(found_products.empty());
+		CHECK(events.empty());
+
+		REQUIRE(p_hotplug_handle(p, settle_ns, hotplugCb, nullptr) == XRT_SUCCESS);
+		REQUIRE(found_products.size() == 1);
+		CHECK(found_products[0] == product_id);
+
+		// Both are reported, only the one with a driver got devices.
+		REQUIRE(events.size() == 2);
+		CHECK(events[0].event == XRT_PROBER_HOTPLUG_ADDED);
+		CHECK(events[0].product_id == product_id);
+		CHECK(events[0].xdev_count == 1);
+		CHECK(events[1].product_id == other_product_id);
+		CHECK(events[1].xdev_count == 0);
+
+		// Nothing happens again for the same devices.
+		REQUIRE(p_hotplug_handle(p, settle_ns * 2, hotplugCb, nullptr) == XRT_SUCCESS);
+		CHECK(found_products.size() == 1);
+		CHECK(events.size() == 2);
+	}
+
+	SECTION("New events for a device push back settling")
+	{
+		mock.plug(5, product_id);
+		REQUIRE(p_hotplug_handle(p, 0, hotplugCb, nullptr) == XRT_SUCCESS);
+
+		mock.plugHidraw(5, product_id, "/dev/hidraw7");
+		REQUIRE(p_hotplug_handle(p, settle_ns - 1, hotplugCb, nullptr) == XRT_SUCCESS);
+		REQUIRE(p_hotplug_handle(p, settle_ns, hotplugCb, nullptr) == XRT_SUCCESS);
+		CHECK(found_products.empty());
+
+		REQUIRE(p_hotplug_handle(p, settle_ns * 2 - 1, hotplugCb, nullptr) == XRT_SUCCESS);
+		CHECK(found_products.size() == 1);
+	}
+
+	SECTION("Interfaces of the same device are merged")
+	{
+		mock.plug(5, product_id);
+		mock.plugHidraw(5, product_id, "/dev/hidraw7");
+		mock.plugHidraw(5, product_id, "/dev/hidraw7");
+		mock.plugHidraw(5, product_id, "/dev/hidraw8");
+		mock.plug(5, product_id);
+		REQUIRE(p_hotplug_handle(p, 0, hotplugCb, nullptr) == XRT_SUCCESS);
+
+		REQUIRE(p->device_count == 1);
+		CHECK(p->devices[0].num_hidraws == 2);
+		CHECK(std::string(p->devices[0].usb.product) == "Test Device");
+	}
+
+	SECTION("Removed devices are reported")
+	{
+		mock.plug(5, product_id);
+		REQUIRE(p_hotplug_handle(p, 0, hotplugCb, nullptr) == XRT_SUCCESS);
+		REQUIRE(p_hotplug_handle(p, settle_ns, hotplugCb, nullptr) == XRT_SUCCESS);
+
+		mock.unplug(5);
+		mock.unplug(5);
+		REQUIRE(p_hotplug_handle(p, settle_ns * 2, hotplugCb, nullptr) == XRT_SUCCESS);
+		CHECK(p->device_count == 0);
+		REQUIRE(events.size() == 2);
+		CHECK(events[1].event == XRT_PROBER_HOTPLUG_REMOVED);
+		CHECK(events[1].product_id == product_id);
+		CHECK(events[1].xdev_count == 1);
+		CHECK(owned.empty());
+	}
+
+	SECTION("Devices removed before settling are never seen")
+	{
+		mock.plug(5, product_id);
+		mock.plug(6, product_id);
+		REQUIRE(p_hotplug_handle(p, 0, hotplugCb, nullptr) == XRT_SUCCESS);
+
+		mock.unplug(5);
+		REQUIRE(p_hotplug_handle(p, settle_ns, hotplugCb, nullptr) == XRT_SUCCESS);
+
+		// Only the remaining device is created, and nothing is removed.
+		CHECK(p->device_count == 1);
+		CHECK(found_products.size() == 1);
+		REQUIRE(events.size() == 1);
+		CHECK(events[0].event == XRT_PROBER_HOTPLUG_ADDED);
+	}
+
+	SECTION("Not handled while the list is locked")
+	{
+		struct xrt_prober_device **devices = nullptr;
+		size_t device_count = 0;
+		REQUIRE(xrt_prober_lock_list(xp, &devices, &device_count) == XRT_SUCCESS);
+
+		mock.plug(5, product_id);
+		CHECK(xrt_prober_handle_hotplug(xp, hotplugCb, nullptr) == XRT_ERROR_PROBER_LIST_LOCKED);
+		CHECK(p->device_count == 0);
+		CHECK(mock.events.size() == 1);
+
+		REQUIRE(xrt_prober_unlock_list(xp, &devices) == XRT_SUCCESS);
+		CHECK(xrt_prober_handle_hotplug(xp, hotplugCb, nullptr) == XRT_SUCCESS);
+		CHECK(p->device_count == 1);
+	}
+
+	xrt_prober_destroy(&xp);
+
+	for (struct xrt_device *xdev : owned) {
+		xrt_device_destroy(&xdev);
+	}
+}
@@ -0,0 +1,146 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Remote driver tests, plays back a trajectory file and checks what
+ *        the devices report.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_system.h"
+#include "os/os_time.h"
+#include "remote/r_interface.h"
+#include "remote/r_internal.h"
+
+#include "catch/catch.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+
+
+static constexpr int keyframe_count = 101; // One every 100ms, ten seconds long.
+static constexpr float tolerance = 0.002f; // Two milliseconds at one meter per second.
+static constexpr int iterations = 100000;
+
+namespace {
+
+/*!
+ * The head moves along x and y at one meter per second, the left controller
+ * along -z, the right one stays put. The driver only reads the options once,
+ * so the same file is used for all sections.
+ */
+struct TrajectoryFile
+{
+	char path[64] = "/tmp/tests_remote_playback_XXXXXX";
+
+	TrajectoryFile()
+	{
+		int fd = mkstemp(path);
+		FILE *file = fdopen(fd, "w");
+		fprintf(file, "# time head left right\n");
+		for (int i = 0; i < keyframe_count; i++) {
+			float t = (float)i * 0.1f;
+			fprintf(file, "%f  %f %f 0 0 0 0 1  -0.2 1.3 %f 0 0 0 1  0.2 1.3 -0.5 0 0 0 1\n", t, t, t, -t);
+		}
+		fclose(file);
+	}
+
+	~TrajectoryFile()
+	{
+		unlink(path);
+	}
+};
+
+TrajectoryFile trajectory_file;
+
+struct xrt_space_relation
+getPose(struct xrt_device *xdev, enum xrt_input_name name, uint64_t at_timestamp_ns)
+{
+	struct xrt_space_relation relation = XRT_SPACE_RELATION_ZERO;
+	xrt_device_get_tracked_pose(xdev, name, at_timestamp_ns, &relation);
+	return relation;
+}
+
+} // namespace
+
+TEST_CASE("remote_playback")
+{
+	setenv("REMOTE_PLAYBACK", trajectory_file.path, 1);
+	setenv("REMOTE_PLAYBACK_HZ", "1000", 1);
+	setenv("REMOTE_PLAYBACK_LOOP", "false", 1);
+
+	struct xrt_system_devices *xsysd = nullptr;
+	REQUIRE(r_create_devices(0, &xsysd) == XRT_SUCCESS);
+
+	struct r_hub *r = (struct r_hub *)xsysd;
+	struct xrt_device *head = xsysd->roles.head;
+	struct xrt_device *left = xsysd->roles.left;
+
+	// Let the playback thread get going.
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	SECTION("Sampling the trajectory")
+	{
+		struct r_remote_data data = r->reset;
+		r_trajectory_sample(&r->playback.trajectory, (uint64_t)2500 * U_TIME_1MS_IN_NS, false, &data);
+
+		CHECK(data.head.center.position.x == Approx(2.5f).margin(tolerance));
+		CHECK(data.head.center.position.y == Approx(2.5f).margin(tolerance));
+		CHECK(data.left.pose.position.z == Approx(-2.5f).margin(tolerance));
+		CHECK(data.left.linear_velocity.z == Approx(-1.0f).margin(tolerance));
+		CHECK(data.right.linear_velocity.z == Approx(0.0f).margin(tolerance));
+
+		// Holds the last keyframe when not looping.
+		r_trajectory_sample(&r->playback.trajectory, (uint64_t)20 * U_TIME_1S_IN_NS, false, &data);
+		CHECK(data.head.center.position.x == Approx(10.0f).margin(tolerance));
+	}
+
+	SECTION("Poses are interpolated and predicted")
+	{
+		uint64_t now_ns = os_monotonic_get_ns();
+		uint64_t past_ns = now_ns - 20 * U_TIME_1MS_IN_NS;
+		uint64_t future_ns = now_ns + 20 * U_TIME_1MS_IN_NS;
+
+		struct xrt_space_relation past = getPose(head, XRT_INPUT_GENERIC_HEAD_POSE, past_ns);
+		struct xrt_space_relation now = getPose(head, XRT_INPUT_GENERIC_HEAD_POSE, now_ns);
+		struct xrt_space_relation future = getPose(head, XRT_INPUT_GENERIC_HEAD_POSE, future_ns);
+
+		CHECK((past.relation_flags & XRT_SPACE_RELATION_POSITION_TRACKED_BIT) != 0);
+		CHECK(past.pose.position.x == Approx(past.pose.position.y).margin(tolerance));
+		CHECK(now.pose.position.x - past.pose.position.x == Approx(0.02f).margin(tolerance));
+		CHECK(future.pose.position.x - now.pose.position.x == Approx(0.02f).margin(tolerance));
+		CHECK(now.linear_velocity.x == Approx(1.0f).margin(0.01f));
+
+		// Far out predictions are limited.
+		uint64_t newest_ns = 0;
+		struct xrt_space_relation newest;
+		REQUIRE(m_relation_history_get_latest(r->history.head, &newest_ns, &newest));
+		struct xrt_space_relation far = getPose(head, XRT_INPUT_GENERIC_HEAD_POSE, now_ns + U_TIME_1S_IN_NS);
+		CHECK(far.pose.position.x - newest.pose.position.x == Approx(0.1f).margin(0.01f));
+
+		struct xrt_space_relation grip = getPose(left, XRT_INPUT_INDEX_GRIP_POSE, past_ns);
+		CHECK((grip.relation_flags & XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT) != 0);
+		CHECK(grip.pose.position.z == Approx(-past.pose.position.x).margin(tolerance));
+		CHECK(grip.linear_velocity.z == Approx(-1.0f).margin(tolerance));
+	}
+
+	SECTION("Latest data is never torn")
+	{
+		int torn = 0;
+		for (int i = 0; i < iterations; i++) {
+			struct r_remote_data data;
+			r_hub_get_latest(r, &data);
+			if (data.head.center.position.x != data.head.center.position.y ||
+			    data.left.pose.position.z != -data.head.center.position.x) {
+				torn++;
+			}
+		}
+		CHECK(torn == 0);
+	}
+
+	xrt_system_devices_destroy(&xsysd);
+}
@@ -0,0 +1,287 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Depth based positional reprojection tests, runs the compute
+ *        distortion shader against a depth buffer of a curved scene and
+ *        compares with ray casting that scene directly.
+ * @author agent <agent@local>
+ */
+
+#include "math/m_api.h"
+#include "render/render_interface.h"
+
+#include "vktest_render.hpp"
+
+#include "catch/catch.hpp"
+
+#include <cmath>
+#include <vector>
+
+
+static constexpr float tolerance = 0.0001f;
+
+static const struct xrt_fov fov = {-0.5f, 0.5f, 0.5f, -0.5f};
+
+namespace {
+
+//! Size of the source images and of each target view.
+constexpr uint32_t size = 64;
+
+//! Less than a quarter of a source texel.
+constexpr double uv_tolerance = 0.003;
+
+/*!
+ * Direction of the view ray through @p u, @p v of a view with @ref fov, in
+ * view space, uv y goes down while view space y goes up.
+ */
+void
+uvToDir(double u, double v, double out_dir[3])
+{
+	const double tan_left = std::tan(fov.angle_left);
+	const double tan_right = std::tan(fov.angle_right);
+	const double tan_up = std::tan(fov.angle_up);
+	const double tan_down = std::tan(fov.angle_down);
+
+	out_dir[0] = tan_left + u * (tan_right - tan_left);
+	out_dir[1] = tan_up - v * (tan_up - tan_down);
+	out_dir[2] = -1.0;
+}
+
+//! Inverse of @ref uvToDir for a point in view space.
+xrt_vec2
+pointToUv(const double p[3])
+{
+	const double tan_left = std::tan(fov.angle_left);
+	const double tan_right = std::tan(fov.angle_right);
+	const double tan_up = std::tan(fov.angle_up);
+	const double tan_down = std::tan(fov.angle_down);
+
+	double tan_x = p[0] / -p[2];
+	double tan_y = p[1] / -p[2];
+
+	return {
+	    (float)((tan_x - tan_left) / (tan_right - tan_left)),
+	    (float)((tan_up - tan_y) / (tan_up - tan_down)),
+	};
+}
+
+/*!
+ * A sphere in front of the source view that covers all of it, so the depth
+ * is different for every texel and a single depth sample is never enough.
+ */
+struct SphereScene
+{
+	double centre[3] = {0.0, 0.0, -3.0};
+	double radius = 2.0;
+
+	//! How far along @p dir the ray from @p origin hits the front of the sphere, @p dir isn't normalized.
+	double
+	intersect(const double origin[3], const double dir[3]) const
+	{
+		double dd = 0.0, dm = 0.0, mm = 0.0;
+		for (int i = 0; i < 3; i++) {
+			double m = origin[i] - centre[i];
+			dd += dir[i] * dir[i];
+			dm += dir[i] * m;
+			mm += m * m;
+		}
+
+		double discriminant = dm * dm - dd * (mm - radius * radius);
+		REQUIRE(discriminant > 0.0);
+
+		return (-dm - std::sqrt(discriminant)) / dd;
+	}
+};
+
+//! What an app would write into its depth buffer for the scene, seen from the source view.
+std::vector<float>
+makeDepthImage(const SphereScene &scene, const render_depth_view_data &range)
+{
+	std::vector<float> depth(size * size);
+	const double origin[3] = {0.0, 0.0, 0.0};
+
+	for (uint32_t y = 0; y < size; y++) {
+		for (uint32_t x = 0; x < size; x++) {
+			double dir[3];
+			uvToDir((x + 0.5) / size, (y + 0.5) / size, dir);
+
+			// The z of dir is minus one, so this is the view space depth.
+			double z = scene.intersect(origin, dir);
+
+			// Standard projection, inverse depth is linear in the depth buffer.
+			double inv_near = 1.0 / range.near_z;
+			double inv_far = 1.0 / range.far_z;
+			double d = (1.0 / z - inv_near) / (inv_far - inv_near);
+
+			depth[y * size + x] = (float)(range.min_depth + d * (range.max_depth - range.min_depth));
+		}
+	}
+
+	return depth;
+}
+
+//! The source uv that the new view at @p position sees at @p u, @p v, the source view is at the origin.
+xrt_vec2
+castRay(const SphereScene &scene, const xrt_vec3 &position, double u, double v)
+{
+	const double origin[3] = {position.x, position.y, position.z};
+	double dir[3];
+	uvToDir(u, v, dir);
+
+	double t = scene.intersect(origin, dir);
+
+	const double p[3] = {
+	    origin[0] + t * dir[0],
+	    origin[1] + t * dir[1],
+	    origin[2] + t * dir[2],
+	};
+
+	return pointToUv(p);
+}
+
+} // namespace
+
+TEST_CASE("render_calc_tanangle_to_uv")
+{
+	xrt_normalized_rect to_uv;
+	render_calc_tanangle_to_uv(&fov, &to_uv);
+
+	// Left edge and top edge are zero, y is flipped from OpenXR.
+	CHECK(std::tan(fov.angle_left) * to_uv.w + to_uv.x == Approx(0.0f).margin(tolerance));
+	CHECK(std::tan(fov.angle_right) * to_uv.w + to_uv.x == Approx(1.0f).margin(tolerance));
+	CHECK(std::tan(fov.angle_up) * to_uv.h + to_uv.y == Approx(0.0f).margin(tolerance));
+	CHECK(std::tan(fov.angle_down) * to_uv.h + to_uv.y == Approx(1.0f).margin(tolerance));
+}
+
+TEST_CASE("render_compute_projection_timewarp_depth", "[.][needgpu]")
+{
+	VkTestRender t;
+	REQUIRE(t.init(fov));
+
+	if (!t.supportsFormat(VK_FORMAT_R32G32B32A32_SFLOAT, false) || //
+	    !t.supportsFormat(VK_FORMAT_R32_SFLOAT, false) ||          //
+	    !t.supportsFormat(VK_FORMAT_R32G32B32A32_SFLOAT, true)) {
+		WARN("Float images can't be filtered or stored, skipping");
+		return;
+	}
+
+	SphereScene scene;
+	xrt_vec3 position = {0.1f, 0.05f, 0.0f};
+	bool with_depth = true;
+
+	render_depth_view_data depth_data = {};
+	depth_data.norm_rect = {0.0f, 0.0f, 1.0f, 1.0f};
+	depth_data.min_depth = 0.0f;
+	depth_data.max_depth = 1.0f;
+	depth_data.near_z = 0.1f;
+	depth_data.far_z = 100.0f;
+
+	SECTION("Standard depth") {}
+
+	SECTION("Reversed depth with an infinite far plane")
+	{
+		depth_data.near_z = INFINITY;
+		depth_data.far_z = 0.1f;
+	}
+
+	SECTION("Depth values in a sub range")
+	{
+		depth_data.min_depth = 0.25f;
+		depth_data.max_depth = 0.75f;
+	}
+
+	SECTION("Moving forward")
+	{
+		position = {0.0f, 0.0f, -0.3f};
+	}
+
+	SECTION("Without depth only rotation is corrected")
+	{
+		with_depth = false;
+	}
+
+	// Each source texel holds its own uv, so the target shows where it was sampled.
+	std::vector<float> colour(size * size * 4);
+	for (uint32_t y = 0; y < size; y++) {
+		for (uint32_t x = 0; x < size; x++) {
+			float *texel = &colour[(y * size + x) * 4];
+			texel[0] = (x + 0.5f) / size;
+			texel[1] = (y + 0.5f) / size;
+			texel[2] = 0.0f;
+			texel[3] = 1.0f;
+		}
+	}
+	std::vector<float> depth = makeDepthImage(scene, depth_data);
+
+	VkImageUsageFlags sampled = VK_IMAGE_USAGE_SAMPLED_BIT;
+	VkImageUsageFlags storage = VK_IMAGE_USAGE_STORAGE_BIT;
+	VkTestImage &colour_image = t.createImage(size, size, VK_FORMAT_R32G32B32A32_SFLOAT, 16, sampled);
+	VkTestImage &depth_image = t.createImage(size, size, VK_FORMAT_R32_SFLOAT, 4, sampled);
+	VkTestImage &target = t.createImage(size * 2, size, VK_FORMAT_R32G32B32A32_SFLOAT, 16, storage);
+	t.upload(colour_image, colour.data());
+	t.upload(depth_image, depth.data());
+
+	VkSampler samplers[2] = {t.r.samplers.clamp_to_edge, t.r.samplers.clamp_to_edge};
+	VkImageView colour_views[2] = {colour_image.view, colour_image.view};
+	VkImageView depth_views[2] = {depth_image.view, depth_image.view};
+	const xrt_normalized_rect rects[2] = {{0.0f, 0.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f, 1.0f}};
+	const xrt_fov fovs[2] = {fov, fov};
+	const xrt_pose src_poses[2] = {XRT_POSE_IDENTITY, XRT_POSE_IDENTITY};
+	const render_depth_view_data depths[2] = {depth_data, depth_data};
+	const render_viewport_data views[2] = {{0, 0, size, size}, {size, 0, size, size}};
+
+	xrt_pose new_poses[2] = {XRT_POSE_IDENTITY, XRT_POSE_IDENTITY};
+	new_poses[0].position = position;
+	new_poses[1].position = position;
+
+	t.begin();
+	render_compute_projection_timewarp(        //
+	    &t.crc,                                //
+	    samplers,                              //
+	    colour_views,                          //
+	    rects,                                 //
+	    src_poses,                             //
+	    fovs,                                  //
+	    new_poses,                             //
+	    with_depth ? depth_views : nullptr,    //
+	    with_depth ? depths : nullptr,         //
+	    target.image,                          //
+	    target.view,                           //
+	    views);                                //
+	t.endAndReadBack(target, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+	// Only the left view, away from where the source is clamped.
+	const double margin = 1.0 / size;
+	double max_error = 0.0;
+	double max_moved = 0.0;
+	uint32_t checked = 0;
+
+	for (uint32_t y = 0; y < size; y++) {
+		for (uint32_t x = 0; x < size; x++) {
+			double u = (x + 0.5) / size;
+			double v = (y + 0.5) / size;
+
+			// Without depth the orientation is the same, so the view uv is used as is.
+			xrt_vec2 expected = with_depth ? castRay(scene, position, u, v) : xrt_vec2{(float)u, (float)v};
+			if (expected.x < margin || expected.x > 1.0 - margin || //
+			    expected.y < margin || expected.y > 1.0 - margin) {
+				continue;
+			}
+
+			const float *texel = target.texel<float>(x, y);
+			max_error = std::fmax(max_error, std::fabs(texel[0] - expected.x));
+			max_error = std::fmax(max_error, std::fabs(texel[1] - expected.y));
+			max_moved = std::fmax(max_moved, std::fabs(expected.x - u) + std::fabs(expected.y - v));
+			checked++;
+		}
+	}
+
+	CHECK(checked > size * size / 2);
+	CHECK(max_error < uv_tolerance);
+
+	if (with_depth) {
+		// Make sure the scene is close enough that rotation only would have been wrong.
+		CHECK(max_moved > 10 * uv_tolerance);
+	}
+}
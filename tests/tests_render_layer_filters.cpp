@@ -0,0 +1,270 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Layer filter tests, the composition flags of a layer must select the
+ *        super-sampling and sharpening modes the layer shader applies, and
+ *        the shader must smooth minified and sharpen magnified layers.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_compositor.h"
+#include "render/render_interface.h"
+
+#include "vktest_render.hpp"
+
+#include "catch/catch.hpp"
+
+#include <vector>
+
+
+namespace {
+
+struct Filters
+{
+	render_layer_filter super_sampling;
+	render_layer_filter sharpening;
+};
+
+Filters
+calcFilters(uint32_t flags)
+{
+	Filters f = {RENDER_LAYER_FILTER_QUALITY, RENDER_LAYER_FILTER_QUALITY};
+	render_calc_layer_filters((xrt_layer_composition_flags)flags, &f.super_sampling, &f.sharpening);
+	return f;
+}
+
+const struct xrt_fov view_fov = {-0.6f, 0.6f, 0.6f, -0.6f};
+
+//! Allowed difference of linear values, the output is 8 bit sRGB.
+constexpr float linear_tolerance = 0.01f;
+
+//! Grey level of a single channel image, every channel gets the same value.
+std::vector<uint8_t>
+makeImage(uint32_t width, uint32_t height, uint8_t (*value)(uint32_t x, uint32_t y))
+{
+	std::vector<uint8_t> pixels(width * height * 4);
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			uint8_t *p = &pixels[(y * width + x) * 4];
+			p[0] = p[1] = p[2] = value(x, y);
+			p[3] = 255;
+		}
+	}
+	return pixels;
+}
+
+/*!
+ * Draws @p source as a projection layer into both views of @p target,
+ * without timewarp so the views map straight onto the source through
+ * @p post_transform.
+ */
+void
+drawProjection(VkTestRender &t,
+               VkTestImage &source,
+               VkTestImage &target,
+               const struct xrt_normalized_rect &post_transform,
+               render_layer_filter super_sampling,
+               render_layer_filter sharpening)
+{
+	struct render_compute_layer_ubo_data *ubo = t.resetLayerUbo(target.extent.width / 2, target.extent.height);
+
+	ubo->layer_type[0].val = XRT_LAYER_STEREO_PROJECTION;
+	ubo->layer_filter[0].super_sampling = super_sampling;
+	ubo->layer_filter[0].sharpening = sharpening;
+	for (uint32_t view = 0; view < 2; view++) {
+		ubo->images_samplers[view].images[0] = 0;
+		ubo->post_transforms[view] = post_transform;
+	}
+
+	t.begin();
+	t.computeLayers({source.view}, target, false);
+	t.endAndReadBack(target, VkTestRender::layers_layout);
+}
+
+//! Linear value of the red channel of the target texel.
+float
+linearAt(const VkTestImage &target, uint32_t x, uint32_t y)
+{
+	return vktest_srgb_to_linear(target.texel<uint8_t>(x, y)[0]);
+}
+
+} // namespace
+
+TEST_CASE("render_calc_layer_filters")
+{
+	SECTION("No settings is plain bilinear")
+	{
+		Filters f = calcFilters(0);
+		CHECK(f.super_sampling == RENDER_LAYER_FILTER_NONE);
+		CHECK(f.sharpening == RENDER_LAYER_FILTER_NONE);
+	}
+
+	SECTION("Other composition flags don't enable filters")
+	{
+		Filters f = calcFilters(XRT_LAYER_COMPOSITION_UNPREMULTIPLIED_ALPHA_BIT | //
+		                        XRT_LAYER_COMPOSITION_VIEW_SPACE_BIT |            //
+		                        XRT_LAYER_COMPOSITION_INSET_BIT);
+		CHECK(f.super_sampling == RENDER_LAYER_FILTER_NONE);
+		CHECK(f.sharpening == RENDER_LAYER_FILTER_NONE);
+	}
+
+	SECTION("Normal super-sampling")
+	{
+		Filters f = calcFilters(XRT_LAYER_COMPOSITION_SUPER_SAMPLING_NORMAL_BIT);
+		CHECK(f.super_sampling == RENDER_LAYER_FILTER_NORMAL);
+		CHECK(f.sharpening == RENDER_LAYER_FILTER_NONE);
+	}
+
+	SECTION("Quality super-sampling")
+	{
+		Filters f = calcFilters(XRT_LAYER_COMPOSITION_SUPER_SAMPLING_QUALITY_BIT);
+		CHECK(f.super_sampling == RENDER_LAYER_FILTER_QUALITY);
+		CHECK(f.sharpening == RENDER_LAYER_FILTER_NONE);
+	}
+
+	SECTION("Normal sharpening")
+	{
+		Filters f = calcFilters(XRT_LAYER_COMPOSITION_SHARPENING_NORMAL_BIT);
+		CHECK(f.super_sampling == RENDER_LAYER_FILTER_NONE);
+		CHECK(f.sharpening == RENDER_LAYER_FILTER_NORMAL);
+	}
+
+	SECTION("Quality sharpening")
+	{
+		Filters f = calcFilters(XRT_LAYER_COMPOSITION_SHARPENING_QUALITY_BIT);
+		CHECK(f.super_sampling == RENDER_LAYER_FILTER_NONE);
+		CHECK(f.sharpening == RENDER_LAYER_FILTER_QUALITY);
+	}
+
+	SECTION("Quality wins over normal")
+	{
+		Filters f = calcFilters(XRT_LAYER_COMPOSITION_SUPER_SAMPLING_NORMAL_BIT |  //
+		                        XRT_LAYER_COMPOSITION_SUPER_SAMPLING_QUALITY_BIT | //
+		                        XRT_LAYER_COMPOSITION_SHARPENING_NORMAL_BIT |      //
+		                        XRT_LAYER_COMPOSITION_SHARPENING_QUALITY_BIT);
+		CHECK(f.super_sampling == RENDER_LAYER_FILTER_QUALITY);
+		CHECK(f.sharpening == RENDER_LAYER_FILTER_QUALITY);
+	}
+
+	SECTION("Both filters on one layer")
+	{
+		// The shader picks one per pixel, depending on the source density.
+		Filters f = calcFilters(XRT_LAYER_COMPOSITION_SUPER_SAMPLING_NORMAL_BIT | //
+		                        XRT_LAYER_COMPOSITION_SHARPENING_QUALITY_BIT);
+		CHECK(f.super_sampling == RENDER_LAYER_FILTER_NORMAL);
+		CHECK(f.sharpening == RENDER_LAYER_FILTER_QUALITY);
+	}
+}
+
+TEST_CASE("render_compute_layers_super_sampling", "[.][needgpu]")
+{
+	VkTestRender t;
+	REQUIRE(t.init(view_fov));
+
+	// One texel checkerboard, minified 2:1 into each view.
+	constexpr uint32_t src_size = 64;
+	constexpr uint32_t size = 32;
+
+	std::vector<uint8_t> pixels = makeImage(src_size, src_size, [](uint32_t x, uint32_t y) -> uint8_t {
+		return ((x + y) & 1) != 0 ? 255 : 0;
+	});
+
+	VkTestImage &source = t.createImage(src_size, src_size, VK_FORMAT_R8G8B8A8_UNORM, 4, VK_IMAGE_USAGE_SAMPLED_BIT);
+	VkTestImage &target = t.createImage(size * 2, size, VK_FORMAT_R8G8B8A8_UNORM, 4, VK_IMAGE_USAGE_STORAGE_BIT);
+	t.upload(source, pixels.data());
+
+	// Half a texel over, so every target pixel centre lands on a texel centre and plain bilinear aliases.
+	const struct xrt_normalized_rect post_transform = {0.5f / src_size, 0.5f / src_size, 1.0f, 1.0f};
+
+	// Skip the edges of the views, there taps are clamped to the edge of the source.
+	auto forInterior = [&](auto func) {
+		for (uint32_t view = 0; view < 2; view++) {
+			for (uint32_t y = 1; y < size - 1; y++) {
+				for (uint32_t x = 1; x < size - 1; x++) {
+					INFO("at " << x << ", " << y << " in view " << view);
+					func(linearAt(target, view * size + x, y));
+				}
+			}
+		}
+	};
+
+	SECTION("Without a filter every other texel is picked")
+	{
+		drawProjection(t, source, target, post_transform, RENDER_LAYER_FILTER_NONE, RENDER_LAYER_FILTER_NONE);
+
+		forInterior([](float value) { CHECK((value < 0.1f || value > 0.9f)); });
+	}
+
+	for (render_layer_filter mode : {RENDER_LAYER_FILTER_NORMAL, RENDER_LAYER_FILTER_QUALITY}) {
+		DYNAMIC_SECTION("Super-sampling mode " << (int)mode << " averages the texels")
+		{
+			drawProjection(t, source, target, post_transform, mode, RENDER_LAYER_FILTER_NONE);
+
+			forInterior([](float value) {
+				CHECK(value > 0.3f);
+				CHECK(value < 0.7f);
+			});
+		}
+	}
+}
+
+TEST_CASE("render_compute_layers_sharpening", "[.][needgpu]")
+{
+	VkTestRender t;
+	REQUIRE(t.init(view_fov));
+
+	// A vertical edge between two grey levels, magnified 1:2 into each view.
+	constexpr uint32_t src_size = 16;
+	constexpr uint32_t size = 32;
+	constexpr float dark = 0.2f;
+	constexpr float light = 0.8f;
+
+	std::vector<uint8_t> pixels = makeImage(src_size, src_size, [](uint32_t x, uint32_t y) -> uint8_t {
+		return x < src_size / 2 ? (uint8_t)(dark * 255.0f + 0.5f) : (uint8_t)(light * 255.0f + 0.5f);
+	});
+
+	VkTestImage &source = t.createImage(src_size, src_size, VK_FORMAT_R8G8B8A8_UNORM, 4, VK_IMAGE_USAGE_SAMPLED_BIT);
+	VkTestImage &target = t.createImage(size * 2, size, VK_FORMAT_R8G8B8A8_UNORM, 4, VK_IMAGE_USAGE_STORAGE_BIT);
+	t.upload(source, pixels.data());
+
+	const struct xrt_normalized_rect post_transform = {0.0f, 0.0f, 1.0f, 1.0f};
+	const uint32_t y = size / 2;
+
+	// The two target pixels either side of the edge.
+	const uint32_t before = size / 2 - 1;
+	const uint32_t after = size / 2;
+
+	drawProjection(t, source, target, post_transform, RENDER_LAYER_FILTER_NONE, RENDER_LAYER_FILTER_NONE);
+	float plain_step = linearAt(target, after, y) - linearAt(target, before, y);
+
+	// Bilinear, a quarter of the way into the ramp on either side.
+	CHECK(plain_step == Approx((light - dark) / 2.0f).margin(linear_tolerance * 2.0f));
+
+	for (render_layer_filter mode : {RENDER_LAYER_FILTER_NORMAL, RENDER_LAYER_FILTER_QUALITY}) {
+		INFO("sharpening mode " << (int)mode);
+
+		drawProjection(t, source, target, post_transform, RENDER_LAYER_FILTER_NONE, mode);
+
+		for (uint32_t view = 0; view < 2; view++) {
+			INFO("view " << view);
+			uint32_t x = view * size;
+			float step = linearAt(target, x + after, y) - linearAt(target, x + before, y);
+			CHECK(step > plain_step + 0.1f);
+		}
+
+		// Normal doesn't clamp to the neighbourhood, only quality promises no halos.
+		if (mode != RENDER_LAYER_FILTER_QUALITY) {
+			continue;
+		}
+
+		for (uint32_t view = 0; view < 2; view++) {
+			for (uint32_t x = 0; x < size; x++) {
+				INFO("at " << x << " in view " << view);
+				float value = linearAt(target, view * size + x, y);
+				CHECK(value >= dark - linear_tolerance);
+				CHECK(value <= light + linear_tolerance);
+			}
+		}
+	}
+}
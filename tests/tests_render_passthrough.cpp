@@ -0,0 +1,152 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Passthrough reprojection tests, a direction fixed in the world must
+ *        land on the pixel of the camera image that saw it.
+ * @author agent <agent@local>
+ */
+
+#include "math/m_api.h"
+#include "render/render_interface.h"
+
+#include "catch/catch.hpp"
+
+#include <cmath>
+
+
+static constexpr float tolerance = 0.0001f;
+
+/*
+ * The timewarp matrix has no perspective divide, so rotated views are only
+ * close to exact for the small rotations between capture and display.
+ */
+static constexpr float reprojection_tolerance = 0.01f;
+
+namespace {
+
+const xrt_vec3 up = {0.0f, 1.0f, 0.0f};
+const xrt_vec3 right = {1.0f, 0.0f, 0.0f};
+
+xrt_pose
+rotated(float angle, const xrt_vec3 &axis)
+{
+	xrt_pose pose = XRT_POSE_IDENTITY;
+	math_quat_from_angle_vector(angle, &axis, &pose.orientation);
+	return pose;
+}
+
+//! Camera with the same half angle in every direction.
+xrt_fov
+symmetricFov(float half_angle)
+{
+	return xrt_fov{-half_angle, half_angle, half_angle, -half_angle};
+}
+
+//! Does what the layer shader does, from a tangent of the view to uv in the camera image.
+xrt_vec2
+viewToCamera(const xrt_matrix_4x4 &m, float tan_x, float tan_y)
+{
+	const float in[4] = {tan_x, tan_y, -1.0f, 1.0f};
+	float out[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+	// Column major, like GLSL.
+	for (int row = 0; row < 4; row++) {
+		for (int col = 0; col < 4; col++) {
+			out[row] += m.v[col * 4 + row] * in[col];
+		}
+	}
+
+	return {out[0] / out[3] * 0.5f + 0.5f, out[1] / out[3] * 0.5f + 0.5f};
+}
+
+//! Where a direction in the space of a camera ends up in its image, top left is zero.
+xrt_vec2
+cameraUv(const xrt_fov &fov, xrt_vec3 dir)
+{
+	float tan_x = dir.x / -dir.z;
+	float tan_y = dir.y / -dir.z;
+	float tan_left = tanf(fov.angle_left);
+	float tan_right = tanf(fov.angle_right);
+	float tan_up = tanf(fov.angle_up);
+	float tan_down = tanf(fov.angle_down);
+
+	return {(tan_x - tan_left) / (tan_right - tan_left), (tan_up - tan_y) / (tan_up - tan_down)};
+}
+
+//! Tangent of a world direction as seen from a view at @p pose.
+void
+viewTangent(const xrt_pose &pose, xrt_vec3 world_dir, float &out_x, float &out_y)
+{
+	xrt_quat inv;
+	math_quat_invert(&pose.orientation, &inv);
+	xrt_vec3 dir;
+	math_quat_rotate_vec3(&inv, &world_dir, &dir);
+	out_x = dir.x / -dir.z;
+	out_y = dir.y / -dir.z;
+}
+
+} // namespace
+
+TEST_CASE("render_calc_passthrough_matrix")
+{
+	const xrt_fov fov = symmetricFov(0.7f);
+	const xrt_pose identity = XRT_POSE_IDENTITY;
+	xrt_matrix_4x4 m;
+
+	SECTION("Aligned view looks at the centre of the image")
+	{
+		render_calc_passthrough_matrix(&identity, &identity, &fov, &identity, &m);
+
+		xrt_vec2 uv = viewToCamera(m, 0.0f, 0.0f);
+		CHECK(uv.x == Approx(0.5f).margin(tolerance));
+		CHECK(uv.y == Approx(0.5f).margin(tolerance));
+	}
+
+	SECTION("World fixed directions stay put when the head turns")
+	{
+		const xrt_pose head_at_capture = rotated(0.05f, up);
+		const xrt_vec3 targets[] = {
+		    {0.1f, 0.2f, -1.0f},
+		    {-0.3f, -0.1f, -1.0f},
+		    {0.2f, 0.0f, -1.0f},
+		};
+
+		for (const xrt_pose &new_pose : {rotated(0.1f, up), rotated(-0.05f, up), rotated(0.08f, right)}) {
+			render_calc_passthrough_matrix(&head_at_capture, &identity, &fov, &new_pose, &m);
+
+			for (xrt_vec3 target : targets) {
+				math_vec3_normalize(&target);
+
+				float tan_x = 0.0f;
+				float tan_y = 0.0f;
+				viewTangent(new_pose, target, tan_x, tan_y);
+				xrt_vec2 uv = viewToCamera(m, tan_x, tan_y);
+
+				// Where the camera saw the target.
+				xrt_quat inv;
+				math_quat_invert(&head_at_capture.orientation, &inv);
+				xrt_vec3 in_camera;
+				math_quat_rotate_vec3(&inv, &target, &in_camera);
+				xrt_vec2 expected = cameraUv(fov, in_camera);
+
+				CHECK(uv.x == Approx(expected.x).margin(reprojection_tolerance));
+				CHECK(uv.y == Approx(expected.y).margin(reprojection_tolerance));
+			}
+		}
+	}
+
+	SECTION("Camera mounted rotated on the head")
+	{
+		// Camera pitched down a bit, the view looking level sees the upper half of the image.
+		const xrt_pose camera_in_head = rotated(-0.1f, right);
+		render_calc_passthrough_matrix(&identity, &camera_in_head, &fov, &identity, &m);
+
+		xrt_vec2 uv = viewToCamera(m, 0.0f, 0.0f);
+		CHECK(uv.x == Approx(0.5f).margin(tolerance));
+		CHECK(uv.y < 0.5f);
+
+		xrt_vec2 expected = cameraUv(fov, {0.0f, sinf(0.1f), -cosf(0.1f)});
+		CHECK(uv.y == Approx(expected.y).margin(reprojection_tolerance));
+	}
+}
@@ -0,0 +1,165 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Quad views tests, runs the compute layer shader with a wide
+ *        projection layer and an inset layer on top of it.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_compositor.h"
+#include "render/render_interface.h"
+
+#include "vktest_render.hpp"
+
+#include "catch/catch.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+
+namespace {
+
+//! Size of each target view.
+constexpr uint32_t size = 64;
+
+//! Allowed difference per channel, the colours are exact in sRGB too.
+constexpr int byte_tolerance = 2;
+
+const struct xrt_fov view_fov = {-0.6f, 0.6f, 0.6f, -0.6f};
+
+//! Off centre on purpose, so a wrongly placed inset doesn't line up by accident.
+const struct xrt_fov inset_fov = {-0.1f, 0.35f, 0.3f, -0.15f};
+
+const uint8_t blue[4] = {0, 0, 255, 255};
+const uint8_t red[4] = {255, 0, 0, 255};
+const uint8_t green[4] = {0, 255, 0, 255};
+
+std::vector<uint8_t>
+makeImage(uint32_t width, uint32_t height, const uint8_t top[4], const uint8_t bottom[4])
+{
+	std::vector<uint8_t> pixels(width * height * 4);
+	for (uint32_t y = 0; y < height; y++) {
+		const uint8_t *colour = y < height / 2 ? top : bottom;
+		for (uint32_t x = 0; x < width; x++) {
+			for (uint32_t c = 0; c < 4; c++) {
+				pixels[(y * width + x) * 4 + c] = colour[c];
+			}
+		}
+	}
+	return pixels;
+}
+
+//! Where the view pixel centre at @p x, @p y lands in the uv space of the inset.
+void
+viewPixelToInsetUv(uint32_t x, uint32_t y, double &out_u, double &out_v)
+{
+	double u = (x + 0.5) / size;
+	double v = (y + 0.5) / size;
+
+	double view_left = std::tan(view_fov.angle_left);
+	double view_right = std::tan(view_fov.angle_right);
+	double view_up = std::tan(view_fov.angle_up);
+	double view_down = std::tan(view_fov.angle_down);
+
+	double tan_x = view_left + u * (view_right - view_left);
+	double tan_y = view_up - v * (view_up - view_down);
+
+	double left = std::tan(inset_fov.angle_left);
+	double right = std::tan(inset_fov.angle_right);
+	double up = std::tan(inset_fov.angle_up);
+	double down = std::tan(inset_fov.angle_down);
+
+	out_u = (tan_x - left) / (right - left);
+	out_v = (up - tan_y) / (up - down);
+}
+
+bool
+isColour(const uint8_t *texel, const uint8_t colour[4])
+{
+	for (uint32_t c = 0; c < 3; c++) {
+		if (std::abs((int)texel[c] - (int)colour[c]) > byte_tolerance) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+
+TEST_CASE("render_compute_layers_quad_views_inset", "[.][needgpu]")
+{
+	VkTestRender t;
+	REQUIRE(t.init(view_fov));
+
+	// The wide views are a single colour, the inset is red on top and green below.
+	std::vector<uint8_t> wide_pixels = makeImage(16, 16, blue, blue);
+	std::vector<uint8_t> inset_pixels = makeImage(32, 32, red, green);
+
+	VkImageUsageFlags sampled = VK_IMAGE_USAGE_SAMPLED_BIT;
+	VkImageUsageFlags storage = VK_IMAGE_USAGE_STORAGE_BIT;
+	VkTestImage &wide = t.createImage(16, 16, VK_FORMAT_R8G8B8A8_UNORM, 4, sampled);
+	VkTestImage &inset = t.createImage(32, 32, VK_FORMAT_R8G8B8A8_UNORM, 4, sampled);
+	VkTestImage &target = t.createImage(size * 2, size, VK_FORMAT_R8G8B8A8_UNORM, 4, storage);
+	t.upload(wide, wide_pixels.data());
+	t.upload(inset, inset_pixels.data());
+
+	const struct xrt_pose identity = XRT_POSE_IDENTITY;
+	struct render_compute_layer_ubo_data *ubo = t.resetLayerUbo(size, size);
+
+	// Same as the state tracker submits them, the inset layer follows the wide one.
+	for (uint32_t view = 0; view < 2; view++) {
+		ubo->layer_type[0].val = XRT_LAYER_STEREO_PROJECTION;
+		ubo->images_samplers[0 * 2 + view].images[0] = 0;
+		ubo->post_transforms[0 * 2 + view] = {0.0f, 0.0f, 1.0f, 1.0f};
+		render_calc_time_warp_matrix(&identity, &view_fov, &identity, &ubo->transforms[0 * 2 + view]);
+
+		ubo->layer_type[1].val = XRT_LAYER_STEREO_PROJECTION;
+		ubo->layer_type[1].inset = 1;
+		ubo->images_samplers[1 * 2 + view].images[0] = 1;
+		ubo->post_transforms[1 * 2 + view] = {0.0f, 0.0f, 1.0f, 1.0f};
+		render_calc_time_warp_matrix(&identity, &inset_fov, &identity, &ubo->transforms[1 * 2 + view]);
+	}
+
+	t.begin();
+	t.computeLayers({wide.view, inset.view}, target, true);
+	t.endAndReadBack(target, VkTestRender::layers_layout);
+
+	// The feathered edge is 5% of the inset, give it some slack on both sides.
+	const double feather = 0.05;
+	const double margin = 0.01;
+	// Half a texel of the inset on either side of its colour split.
+	const double split_margin = 1.0 / 32.0;
+
+	uint32_t outside = 0;
+	uint32_t inside = 0;
+
+	for (uint32_t view = 0; view < 2; view++) {
+		for (uint32_t y = 0; y < size; y++) {
+			for (uint32_t x = 0; x < size; x++) {
+				double u, v;
+				viewPixelToInsetUv(x, y, u, v);
+
+				double edge = std::fmin(std::fmin(u, 1.0 - u), std::fmin(v, 1.0 - v));
+				const uint8_t *texel = target.texel<uint8_t>(view * size + x, y);
+
+				if (edge < -margin) {
+					INFO("outside the inset at " << x << ", " << y << " in view " << view);
+					CHECK(isColour(texel, blue));
+					outside++;
+				} else if (edge > feather + margin && std::fabs(v - 0.5) > split_margin) {
+					INFO("inside the inset at " << x << ", " << y << " in view " << view);
+					CHECK(isColour(texel, v < 0.5 ? red : green));
+					inside++;
+				}
+			}
+		}
+	}
+
+	// Make sure both parts were actually looked at.
+	CHECK(outside > size * size);
+	CHECK(inside > size * size / 8);
+}
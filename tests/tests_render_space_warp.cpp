@@ -0,0 +1,257 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Space warp frame synthesis tests, runs the compute distortion shader
+ *        with the motion vectors of a moving box and checks where the box
+ *        ends up in the extrapolated frame.
+ * @author agent <agent@local>
+ */
+
+#include "render/render_interface.h"
+
+#include "vktest_render.hpp"
+
+#include "catch/catch.hpp"
+
+#include <cmath>
+#include <vector>
+
+
+static constexpr float tolerance = 0.0001f;
+static constexpr uint64_t period_ns = 22222222; // 45Hz app.
+
+static const struct xrt_fov fov = {-0.5f, 0.5f, 0.5f, -0.5f};
+
+namespace {
+
+//! Size of the source images and of each target view.
+constexpr uint32_t size = 64;
+
+//! Less than a quarter of a source texel.
+constexpr double uv_tolerance = 0.003;
+
+/*!
+ * A box moving with a constant NDC velocity over a static background, the
+ * box edges are on texel edges. Motion vectors are stored where the object
+ * is in the source frame.
+ */
+struct MovingBox
+{
+	//! First and one past the last texel of the box, the same on both axes.
+	uint32_t min = 24;
+	uint32_t max = 40;
+
+	//! NDC motion of the box over one app frame.
+	xrt_vec2 ndc_motion = {0.0f, 0.0f};
+
+	//! Is @p u, @p v inside the box moved by @p offset uv, @p grow pushes out the edges.
+	bool
+	inside(double u, double v, const xrt_vec2 &offset, double grow) const
+	{
+		double lo = (double)min / size - grow;
+		double hi = (double)max / size + grow;
+		u -= offset.x;
+		v -= offset.y;
+		return u > lo && u < hi && v > lo && v < hi;
+	}
+};
+
+std::vector<float>
+makeMotionImage(const MovingBox &box)
+{
+	std::vector<float> motion(size * size * 4, 0.0f);
+
+	for (uint32_t y = box.min; y < box.max; y++) {
+		for (uint32_t x = box.min; x < box.max; x++) {
+			float *texel = &motion[(y * size + x) * 4];
+			texel[0] = box.ndc_motion.x;
+			texel[1] = box.ndc_motion.y;
+		}
+	}
+
+	return motion;
+}
+
+} // namespace
+
+TEST_CASE("render_calc_space_warp_extrapolation")
+{
+	SECTION("Same time is no extrapolation")
+	{
+		CHECK(render_calc_space_warp_extrapolation(1000, period_ns, 1000) == 0.0f);
+	}
+
+	SECTION("Older frame is not extrapolated backwards")
+	{
+		CHECK(render_calc_space_warp_extrapolation(period_ns * 2, period_ns, period_ns) == 0.0f);
+	}
+
+	SECTION("Unknown period")
+	{
+		CHECK(render_calc_space_warp_extrapolation(0, 0, period_ns) == 0.0f);
+	}
+
+	SECTION("Half a frame at 90Hz display")
+	{
+		float e = render_calc_space_warp_extrapolation(period_ns, period_ns, period_ns + period_ns / 2);
+		CHECK(e == Approx(0.5f).margin(tolerance));
+	}
+
+	SECTION("Clamped to one frame")
+	{
+		CHECK(render_calc_space_warp_extrapolation(0, period_ns, period_ns * 3) == 1.0f);
+	}
+}
+
+TEST_CASE("render_compute_projection_space_warp", "[.][needgpu]")
+{
+	VkTestRender t;
+	REQUIRE(t.init(fov));
+
+	if (!t.supportsFormat(VK_FORMAT_R32G32B32A32_SFLOAT, false) || //
+	    !t.supportsFormat(VK_FORMAT_R32_SFLOAT, false) ||          //
+	    !t.supportsFormat(VK_FORMAT_R32G32B32A32_SFLOAT, true)) {
+		WARN("Float images can't be filtered or stored, skipping");
+		return;
+	}
+
+	// Right by 0.25 NDC per frame, that is 0.125 uv or eight texels.
+	MovingBox box;
+	box.ndc_motion = {0.25f, 0.0f};
+	float extrapolation = 1.0f;
+	bool ndc_y_up = false;
+
+	SECTION("One frame") {}
+
+	SECTION("Half a frame")
+	{
+		extrapolation = 0.5f;
+	}
+
+	SECTION("On time frame is not moved")
+	{
+		extrapolation = 0.0f;
+	}
+
+	SECTION("Y down NDC")
+	{
+		box.ndc_motion = {0.0f, 0.25f};
+	}
+
+	SECTION("Y up NDC")
+	{
+		box.ndc_motion = {0.0f, 0.25f};
+		ndc_y_up = true;
+	}
+
+	// Each source texel holds its own uv, so the target shows where it was sampled.
+	std::vector<float> colour(size * size * 4);
+	for (uint32_t y = 0; y < size; y++) {
+		for (uint32_t x = 0; x < size; x++) {
+			float *texel = &colour[(y * size + x) * 4];
+			texel[0] = (x + 0.5f) / size;
+			texel[1] = (y + 0.5f) / size;
+			texel[2] = 0.0f;
+			texel[3] = 1.0f;
+		}
+	}
+
+	// The views don't move, so the depth only needs to be valid.
+	std::vector<float> depth(size * size, 0.5f);
+	std::vector<float> motion = makeMotionImage(box);
+
+	VkImageUsageFlags sampled = VK_IMAGE_USAGE_SAMPLED_BIT;
+	VkImageUsageFlags storage = VK_IMAGE_USAGE_STORAGE_BIT;
+	VkTestImage &colour_image = t.createImage(size, size, VK_FORMAT_R32G32B32A32_SFLOAT, 16, sampled);
+	VkTestImage &depth_image = t.createImage(size, size, VK_FORMAT_R32_SFLOAT, 4, sampled);
+	VkTestImage &motion_image = t.createImage(size, size, VK_FORMAT_R32G32B32A32_SFLOAT, 16, sampled);
+	VkTestImage &target = t.createImage(size * 2, size, VK_FORMAT_R32G32B32A32_SFLOAT, 16, storage);
+	t.upload(colour_image, colour.data());
+	t.upload(depth_image, depth.data());
+	t.upload(motion_image, motion.data());
+
+	render_depth_view_data depth_data = {};
+	depth_data.norm_rect = {0.0f, 0.0f, 1.0f, 1.0f};
+	depth_data.min_depth = 0.0f;
+	depth_data.max_depth = 1.0f;
+	depth_data.near_z = 0.1f;
+	depth_data.far_z = 100.0f;
+
+	render_space_warp_view_data space_warp_data = {};
+	space_warp_data.norm_rect = {0.0f, 0.0f, 1.0f, 1.0f};
+	space_warp_data.extrapolation = extrapolation;
+	space_warp_data.ndc_y_up = ndc_y_up;
+
+	VkSampler samplers[2] = {t.r.samplers.clamp_to_edge, t.r.samplers.clamp_to_edge};
+	VkImageView colour_views[2] = {colour_image.view, colour_image.view};
+	VkImageView depth_views[2] = {depth_image.view, depth_image.view};
+	VkImageView motion_views[2] = {motion_image.view, motion_image.view};
+	const xrt_normalized_rect rects[2] = {{0.0f, 0.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f, 1.0f}};
+	const xrt_fov fovs[2] = {fov, fov};
+	const xrt_pose poses[2] = {XRT_POSE_IDENTITY, XRT_POSE_IDENTITY};
+	const render_depth_view_data depths[2] = {depth_data, depth_data};
+	const render_space_warp_view_data space_warps[2] = {space_warp_data, space_warp_data};
+	const render_viewport_data views[2] = {{0, 0, size, size}, {size, 0, size, size}};
+
+	t.begin();
+	render_compute_projection_space_warp( //
+	    &t.crc,                           //
+	    samplers,                         //
+	    colour_views,                     //
+	    rects,                            //
+	    poses,                            //
+	    fovs,                             //
+	    poses,                            //
+	    depth_views,                      //
+	    depths,                           //
+	    motion_views,                     //
+	    space_warps,                      //
+	    target.image,                     //
+	    target.view,                      //
+	    views);                           //
+	t.endAndReadBack(target, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+	// NDC is two units across the view, and y up NDC points against uv.
+	const float y_sign = ndc_y_up ? -1.0f : 1.0f;
+	const xrt_vec2 move = {
+	    box.ndc_motion.x * 0.5f * extrapolation,
+	    box.ndc_motion.y * 0.5f * y_sign * extrapolation,
+	};
+	const xrt_vec2 still = {0.0f, 0.0f};
+
+	// One texel off the edges, where the motion vectors are filtered.
+	const double edge = 1.0 / size;
+	double max_error = 0.0;
+	uint32_t box_checked = 0;
+	uint32_t background_checked = 0;
+
+	// Only the left view, the right one is the same.
+	for (uint32_t y = 0; y < size; y++) {
+		for (uint32_t x = 0; x < size; x++) {
+			double u = (x + 0.5) / size;
+			double v = (y + 0.5) / size;
+			xrt_vec2 expected;
+
+			if (box.inside(u, v, still, -edge) && box.inside(u, v, move, -edge)) {
+				// Where the box was and still is it has moved along with its motion.
+				expected = {(float)(u - move.x), (float)(v - move.y)};
+				box_checked++;
+			} else if (!box.inside(u, v, still, edge) && !box.inside(u, v, move, edge)) {
+				expected = {(float)u, (float)v};
+				background_checked++;
+			} else {
+				// What is uncovered or covered by the box isn't known from the motion vectors.
+				continue;
+			}
+
+			const float *texel = target.texel<float>(x, y);
+			max_error = std::fmax(max_error, std::fabs(texel[0] - expected.x));
+			max_error = std::fmax(max_error, std::fabs(texel[1] - expected.y));
+		}
+	}
+
+	CHECK(box_checked > 0);
+	CHECK(background_checked > size * size / 2);
+	CHECK(max_error < uv_tolerance);
+}
@@ -0,0 +1,140 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Adding and removing devices after the system is set up, like the
+ *        service does with hotplugged devices.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_space.h"
+#include "xrt/xrt_tracking.h"
+
+#include "util/u_system_helpers.h"
+#include "util/u_space_overseer.h"
+
+#include "catch/catch.hpp"
+
+
+static constexpr float tolerance = 0.0001f;
+
+namespace {
+
+int destroyed = 0;
+
+struct TestDevice
+{
+	struct xrt_device base = {};
+
+	TestDevice(enum xrt_device_type type, struct xrt_tracking_origin *origin)
+	{
+		base.device_type = type;
+		base.tracking_origin = origin;
+		base.destroy = destroy;
+		snprintf(base.str, sizeof(base.str), "Test Device");
+	}
+
+	static void
+	destroy(struct xrt_device *xdev)
+	{
+		destroyed++;
+		delete (TestDevice *)xdev;
+	}
+};
+
+struct xrt_device *
+makeDevice(enum xrt_device_type type, struct xrt_tracking_origin *origin)
+{
+	return &(new TestDevice(type, origin))->base;
+}
+
+} // namespace
+
+TEST_CASE("u_system_devices_hotplug")
+{
+	struct u_system_devices *usysd = u_system_devices_allocate();
+	struct xrt_system_devices *xsysd = &usysd->base;
+	destroyed = 0;
+
+	struct xrt_tracking_origin origin = {};
+	origin.offset = XRT_POSE_IDENTITY;
+
+	struct xrt_device *head = makeDevice(XRT_DEVICE_TYPE_HMD, &origin);
+	struct xrt_device *first = makeDevice(XRT_DEVICE_TYPE_ANY_HAND_CONTROLLER, &origin);
+	struct xrt_device *second = makeDevice(XRT_DEVICE_TYPE_ANY_HAND_CONTROLLER, &origin);
+
+	SECTION("Added devices get free roles")
+	{
+		CHECK(u_system_devices_add_device(xsysd, head));
+		CHECK(u_system_devices_add_device(xsysd, first));
+		CHECK(u_system_devices_add_device(xsysd, second));
+
+		CHECK(xsysd->xdev_count == 3);
+		CHECK(xsysd->roles.head == head);
+		CHECK(xsysd->roles.left == first);
+		CHECK(xsysd->roles.right == second);
+	}
+
+	SECTION("Removed devices lose their roles and the list stays packed")
+	{
+		u_system_devices_add_device(xsysd, head);
+		u_system_devices_add_device(xsysd, first);
+		u_system_devices_add_device(xsysd, second);
+
+		u_system_devices_remove_device(xsysd, &first);
+		CHECK(first == nullptr);
+		CHECK(destroyed == 1);
+
+		REQUIRE(xsysd->xdev_count == 2);
+		CHECK(xsysd->xdevs[0] == head);
+		CHECK(xsysd->xdevs[1] == second);
+		CHECK(xsysd->xdevs[2] == nullptr);
+		CHECK(xsysd->roles.left == nullptr);
+		CHECK(xsysd->roles.right == second);
+
+		// The next controller takes the free role.
+		struct xrt_device *third = makeDevice(XRT_DEVICE_TYPE_ANY_HAND_CONTROLLER, &origin);
+		CHECK(u_system_devices_add_device(xsysd, third));
+		CHECK(xsysd->roles.left == third);
+	}
+
+	SECTION("Devices without room are destroyed")
+	{
+		for (size_t i = 0; i < XRT_SYSTEM_MAX_DEVICES; i++) {
+			REQUIRE(u_system_devices_add_device(xsysd, makeDevice(XRT_DEVICE_TYPE_GENERIC_TRACKER, &origin)));
+		}
+
+		CHECK_FALSE(u_system_devices_add_device(xsysd, head));
+		CHECK(destroyed == 1);
+
+		xrt_device_destroy(&first);
+		xrt_device_destroy(&second);
+	}
+
+	xrt_system_devices_destroy(&xsysd);
+}
+
+TEST_CASE("u_space_overseer_hotplug")
+{
+	struct xrt_space_overseer *xso = (struct xrt_space_overseer *)u_space_overseer_create();
+
+	struct xrt_tracking_origin origin = {};
+	origin.offset = XRT_POSE_IDENTITY;
+	origin.offset.position.x = 1.0f;
+
+	struct xrt_device *xdev = makeDevice(XRT_DEVICE_TYPE_GENERIC_TRACKER, &origin);
+
+	REQUIRE(xrt_space_overseer_add_device(xso, xdev) == XRT_SUCCESS);
+
+	// The device is placed at the offset of its tracking origin.
+	struct xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+	struct xrt_pose identity = XRT_POSE_IDENTITY;
+	REQUIRE(xrt_space_overseer_locate_device(xso, xso->semantic.root, &identity, 0, xdev, &rel) == XRT_SUCCESS);
+	CHECK(rel.pose.position.x == Approx(1.0f).margin(tolerance));
+
+	CHECK(xrt_space_overseer_remove_device(xso, xdev) == XRT_SUCCESS);
+
+	xrt_device_destroy(&xdev);
+	xrt_space_overseer_destroy(&xso);
+}
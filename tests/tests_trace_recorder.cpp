@@ -0,0 +1,236 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Flight recorder tests, threads record scopes and the Chrome trace
+ *        json that is written is parsed back.
+ * @author agent <agent@local>
+ */
+
+#include "os/os_time.h"
+#include "util/u_file.h"
+#include "util/u_json.h"
+#include "util/u_time.h"
+#include "util/u_trace_marker.h"
+#include "util/u_trace_recorder.h"
+
+#include "catch/catch.hpp"
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+
+
+namespace {
+
+//! Parsed dump, freed when it goes out of scope.
+struct Dump
+{
+	cJSON *root = nullptr;
+
+	explicit Dump(uint64_t window_ns)
+	{
+		FILE *file = tmpfile();
+		REQUIRE(file != nullptr);
+		REQUIRE(u_trace_recorder_write_json(file, window_ns));
+
+		char *content = u_file_read_content(file);
+		fclose(file);
+		REQUIRE(content != nullptr);
+
+		root = cJSON_Parse(content);
+		free(content);
+		REQUIRE(root != nullptr);
+	}
+
+	~Dump()
+	{
+		cJSON_Delete(root);
+	}
+
+	//! Thread id of the thread with the given name, -1 if not in the dump.
+	int
+	findThread(const std::string &name) const
+	{
+		const cJSON *event = nullptr;
+		cJSON_ArrayForEach(event, cJSON_GetObjectItem(root, "traceEvents"))
+		{
+			const cJSON *args = cJSON_GetObjectItem(event, "args");
+			if (getString(event, "ph") == "M" && args != nullptr && getString(args, "name") == name) {
+				return cJSON_GetObjectItem(event, "tid")->valueint;
+			}
+		}
+		return -1;
+	}
+
+	//! Events of one thread as a string of phases and names, like "B:outer B:inner E:inner".
+	std::string
+	events(int tid) const
+	{
+		std::string str;
+		const cJSON *event = nullptr;
+		cJSON_ArrayForEach(event, cJSON_GetObjectItem(root, "traceEvents"))
+		{
+			std::string ph = getString(event, "ph");
+			if (ph == "M" || cJSON_GetObjectItem(event, "tid")->valueint != tid) {
+				continue;
+			}
+
+			str += (str.empty() ? "" : " ") + ph + ":" + getString(event, "name");
+		}
+		return str;
+	}
+
+	size_t
+	count(int tid) const
+	{
+		size_t count = 0;
+		const cJSON *event = nullptr;
+		cJSON_ArrayForEach(event, cJSON_GetObjectItem(root, "traceEvents"))
+		{
+			if (getString(event, "ph") != "M" && cJSON_GetObjectItem(event, "tid")->valueint == tid) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	static std::string
+	getString(const cJSON *obj, const char *name)
+	{
+		const cJSON *item = cJSON_GetObjectItem(obj, name);
+		return cJSON_IsString(item) ? item->valuestring : "";
+	}
+};
+
+void
+nested(void)
+{
+	U_TRACE_IDENT(test, outer);
+
+	U_TRACE_BEGIN(test, inner);
+	U_TRACE_END(test, inner);
+}
+
+//! Runs @p func on a new thread with the given name.
+template <typename Func>
+void
+runOnThread(const char *name, Func func)
+{
+	std::thread t([&] {
+		U_TRACE_SET_THREAD_NAME(name);
+		func();
+	});
+	t.join();
+}
+
+} // namespace
+
+TEST_CASE("trace_recorder")
+{
+	u_trace_recorder_set_enabled(true);
+
+	SECTION("Scopes are written as begin and end events")
+	{
+		runOnThread("Nested", [] { nested(); });
+
+		Dump dump(U_TRACE_RECORDER_DEFAULT_WINDOW_NS);
+		int tid = dump.findThread("Nested");
+		REQUIRE(tid > 0);
+		CHECK(dump.events(tid) == "B:outer B:inner E:inner E:outer");
+	}
+
+	SECTION("Only the newest events are kept")
+	{
+		runOnThread("Wrapped", [] {
+			for (uint32_t i = 0; i < U_TRACE_RECORDER_RING_SIZE + 11; i++) {
+				U_TRACE_IDENT(test, repeated);
+			}
+		});
+
+		Dump dump(U_TRACE_RECORDER_DEFAULT_WINDOW_NS);
+		int tid = dump.findThread("Wrapped");
+		REQUIRE(tid > 0);
+		// The oldest slot is the next to be written so it is left out, and the end event after it.
+		CHECK(dump.count(tid) == U_TRACE_RECORDER_RING_SIZE - 2);
+	}
+
+	SECTION("Events before the window are left out")
+	{
+		runOnThread("Window", [] {
+			{
+				U_TRACE_IDENT(test, old);
+			}
+			os_nanosleep(100 * U_TIME_1MS_IN_NS);
+			{
+				U_TRACE_IDENT(test, recent);
+			}
+		});
+
+		Dump dump(50 * U_TIME_1MS_IN_NS);
+		int tid = dump.findThread("Window");
+		REQUIRE(tid > 0);
+		CHECK(dump.events(tid) == "B:recent E:recent");
+	}
+
+	SECTION("Nothing is recorded when disabled")
+	{
+		runOnThread("Disabled", [] {
+			u_trace_recorder_set_enabled(false);
+			nested();
+			u_trace_recorder_set_enabled(true);
+		});
+
+		Dump dump(U_TRACE_RECORDER_DEFAULT_WINDOW_NS);
+		int tid = dump.findThread("Disabled");
+		REQUIRE(tid > 0);
+		CHECK(dump.count(tid) == 0);
+	}
+
+	SECTION("Rings of exited threads are reused")
+	{
+		for (uint32_t i = 0; i < U_TRACE_RECORDER_MAX_THREADS * 2; i++) {
+			runOnThread("Short lived", [] { nested(); });
+		}
+
+		runOnThread("Last", [] { nested(); });
+
+		Dump dump(U_TRACE_RECORDER_DEFAULT_WINDOW_NS);
+		int tid = dump.findThread("Last");
+		REQUIRE(tid > 0);
+		CHECK(dump.events(tid) == "B:outer B:inner E:inner E:outer");
+	}
+
+	SECTION("Recording while dumping")
+	{
+		std::atomic<bool> named{false};
+		std::atomic<bool> done{false};
+		std::thread writer([&] {
+			U_TRACE_SET_THREAD_NAME("Busy");
+			named = true;
+			while (!done) {
+				nested();
+			}
+		});
+
+		while (!named) {
+			std::this_thread::yield();
+		}
+
+		for (uint32_t i = 0; i < 20; i++) {
+			Dump dump(U_TRACE_RECORDER_DEFAULT_WINDOW_NS);
+			int tid = dump.findThread("Busy");
+			REQUIRE(tid > 0);
+
+			// Whatever was kept is still balanced and in order.
+			std::string events = dump.events(tid);
+			CHECK(events.find("E:outer E:outer") == std::string::npos);
+			CHECK(events.find("B:outer B:outer") == std::string::npos);
+		}
+
+		done = true;
+		writer.join();
+	}
+}
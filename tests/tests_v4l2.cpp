@@ -0,0 +1,321 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief V4L2 frameserver tests, runs the capture thread against a mocked
+ *        ioctl layer with a pipe standing in for the device.
+ * @author agent <agent@local>
+ */
+
+#include "xrt/xrt_frame.h"
+#include "v4l2/v4l2_interface.h"
+#include "v4l2/v4l2_driver.h"
+
+#include "catch/catch.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdarg.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+static constexpr uint32_t width = 64;
+static constexpr uint32_t height = 32;
+static constexpr uint32_t frame_size = width * height * 2;
+static constexpr uint32_t driver_buffer_count = 4; // What the mocked driver hands out.
+
+namespace {
+
+/*!
+ * The mocked device, frames are made available by writing a byte to the pipe
+ * that the frameserver has opened, this makes the fd poll like a real device.
+ */
+struct MockDevice
+{
+	std::mutex mutex;
+	int pipe_fds[2] = {-1, -1};
+	int device_fd = -1;
+
+	std::deque<uint32_t> queued;
+	uint32_t sequence = 0;
+	uint32_t memory = 0;
+	uint8_t mmap_memory[driver_buffer_count][frame_size] = {};
+	int exported[driver_buffer_count] = {-1, -1, -1, -1};
+
+	std::atomic<int> control_ioctls{0};
+	int controls[64] = {};
+
+	void
+	reset()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		queued.clear();
+		sequence = 0;
+		memory = 0;
+		device_fd = -1;
+		control_ioctls = 0;
+		for (int &fd : exported) {
+			fd = -1;
+		}
+	}
+
+	int
+	handle(int fd, unsigned long request, void *arg)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		device_fd = fd;
+
+		switch (request) {
+		case VIDIOC_QUERYCAP: {
+			auto *cap = (struct v4l2_capability *)arg;
+			*cap = {};
+			snprintf((char *)cap->card, sizeof(cap->card), "3D USB Camera: 3D USB Camera");
+			cap->capabilities = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+			return 0;
+		}
+		case VIDIOC_G_PARM: ((struct v4l2_streamparm *)arg)->parm.capture.capability = 0; return 0;
+		case VIDIOC_ENUM_FMT: {
+			auto *desc = (struct v4l2_fmtdesc *)arg;
+			if (desc->index > 0) {
+				return -1;
+			}
+			desc->pixelformat = V4L2_PIX_FMT_YUYV;
+			snprintf((char *)desc->description, sizeof(desc->description), "YUYV");
+			return 0;
+		}
+		case VIDIOC_ENUM_FRAMESIZES: {
+			auto *size = (struct v4l2_frmsizeenum *)arg;
+			if (size->index > 0) {
+				return -1;
+			}
+			size->type = V4L2_FRMSIZE_TYPE_DISCRETE;
+			size->discrete.width = width;
+			size->discrete.height = height;
+			return 0;
+		}
+		case VIDIOC_ENUM_FRAMEINTERVALS: {
+			auto *interval = (struct v4l2_frmivalenum *)arg;
+			if (interval->index > 0) {
+				return -1;
+			}
+			interval->discrete.numerator = 1;
+			interval->discrete.denominator = 30;
+			return 0;
+		}
+		case VIDIOC_S_FMT: return 0;
+		case VIDIOC_REQBUFS: {
+			auto *req = (struct v4l2_requestbuffers *)arg;
+			memory = req->memory;
+			req->count = driver_buffer_count;
+			return 0;
+		}
+		case VIDIOC_QUERYBUF: {
+			auto *buf = (struct v4l2_buffer *)arg;
+			buf->length = frame_size;
+			buf->m.offset = buf->index * frame_size;
+			return 0;
+		}
+		case VIDIOC_EXPBUF: {
+			auto *expbuf = (struct v4l2_exportbuffer *)arg;
+			expbuf->fd = eventfd(0, EFD_CLOEXEC);
+			exported[expbuf->index] = expbuf->fd;
+			return 0;
+		}
+		case VIDIOC_QBUF: queued.push_back(((struct v4l2_buffer *)arg)->index); return 0;
+		case VIDIOC_DQBUF: {
+			uint8_t byte;
+			if (queued.empty() || read(fd, &byte, 1) != 1) {
+				errno = EAGAIN;
+				return -1;
+			}
+			auto *buf = (struct v4l2_buffer *)arg;
+			buf->index = queued.front();
+			buf->bytesused = frame_size;
+			buf->sequence = sequence++;
+			buf->flags = 0;
+			queued.pop_front();
+			return 0;
+		}
+		case VIDIOC_STREAMON: return 0;
+		case VIDIOC_G_CTRL: {
+			auto *control = (struct v4l2_control *)arg;
+			control_ioctls++;
+			control->value = controls[control->id % 64];
+			return 0;
+		}
+		case VIDIOC_S_CTRL: {
+			auto *control = (struct v4l2_control *)arg;
+			control_ioctls++;
+			controls[control->id % 64] = control->value;
+			return 0;
+		}
+		default: errno = EINVAL; return -1;
+		}
+	}
+};
+
+MockDevice mock;
+
+/*!
+ * Counts the frames it gets, does not hold on to them.
+ */
+struct CountingSink
+{
+	struct xrt_frame_sink base = {};
+	std::atomic<int> count{0};
+	std::atomic<bool> has_buffer_handle{false};
+	std::atomic<int> buffer_handle{-1};
+
+	CountingSink()
+	{
+		base.push_frame = pushFrame;
+	}
+
+	static void
+	pushFrame(struct xrt_frame_sink *xfs, struct xrt_frame *xf)
+	{
+		auto *sink = (CountingSink *)xfs;
+		sink->has_buffer_handle = xf->has_buffer_handle;
+		sink->buffer_handle = xf->buffer_handle;
+		sink->count++;
+	}
+
+	bool
+	waitFor(int wanted)
+	{
+		for (int i = 0; i < 1000 && count < wanted; i++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return count >= wanted;
+	}
+};
+
+void
+sendFrames(int frame_count)
+{
+	for (int i = 0; i < frame_count; i++) {
+		uint8_t byte = 0;
+		REQUIRE(write(mock.pipe_fds[1], &byte, 1) == 1);
+	}
+}
+
+} // namespace
+
+/*
+ * Mocked libc entry points, everything that is not for the device is passed
+ * straight to the kernel.
+ */
+
+extern "C" int
+ioctl(int fd, unsigned long request, ...) __THROW
+{
+	va_list args;
+	va_start(args, request);
+	void *arg = va_arg(args, void *);
+	va_end(args);
+
+	if (_IOC_TYPE(request) == 'V') {
+		return mock.handle(fd, request, arg);
+	}
+	return (int)syscall(SYS_ioctl, fd, request, arg);
+}
+
+extern "C" void *
+mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset) __THROW
+{
+	if (fd >= 0 && fd == mock.device_fd) {
+		return mock.mmap_memory[offset / frame_size];
+	}
+	return (void *)syscall(SYS_mmap, addr, length, prot, flags, fd, offset);
+}
+
+TEST_CASE("v4l2_fs")
+{
+	mock.reset();
+	REQUIRE(pipe(mock.pipe_fds) == 0);
+
+	std::string path = "/proc/self/fd/" + std::to_string(mock.pipe_fds[0]);
+
+	struct xrt_frame_context xfctx = {};
+	struct xrt_fs *xfs = v4l2_fs_create(&xfctx, path.c_str(), "product", "manufacturer", "serial");
+	REQUIRE(xfs != nullptr);
+
+	CountingSink sink;
+
+	SECTION("Stopping does not wait for a frame")
+	{
+		REQUIRE(xrt_fs_stream_start(xfs, &sink.base, XRT_FS_CAPTURE_TYPE_TRACKING, 0));
+
+		// Give the thread time to reach the wait.
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		auto start = std::chrono::steady_clock::now();
+		CHECK(xrt_fs_stream_stop(xfs));
+		auto stop_time = std::chrono::steady_clock::now() - start;
+
+		CHECK(stop_time < std::chrono::milliseconds(100));
+		CHECK(sink.count == 0);
+	}
+
+	SECTION("Controls are only touched when they change")
+	{
+		REQUIRE(xrt_fs_stream_start(xfs, &sink.base, XRT_FS_CAPTURE_TYPE_TRACKING, 0));
+
+		// The wanted values are forced twice, at start and on the first frame.
+		sendFrames(2);
+		REQUIRE(sink.waitFor(2));
+		int after_start = mock.control_ioctls;
+		CHECK(after_start > 0);
+
+		sendFrames(20);
+		REQUIRE(sink.waitFor(22));
+		CHECK(mock.control_ioctls == after_start);
+
+		// Changing a wanted value is picked up on the next frame.
+		v4l2_fs(xfs)->states[0].want[XRT_FS_CAPTURE_TYPE_TRACKING].value += 1;
+		sendFrames(1);
+		REQUIRE(sink.waitFor(23));
+		CHECK(xrt_fs_stream_stop(xfs));
+		CHECK(mock.control_ioctls > after_start);
+	}
+
+	SECTION("Uses the buffer count the driver gave")
+	{
+		REQUIRE(xrt_fs_stream_start(xfs, &sink.base, XRT_FS_CAPTURE_TYPE_TRACKING, 0));
+		sendFrames(driver_buffer_count * 3);
+		REQUIRE(sink.waitFor(driver_buffer_count * 3));
+		CHECK(xrt_fs_stream_stop(xfs));
+
+		CHECK(v4l2_fs(xfs)->num_buffers == driver_buffer_count);
+		CHECK(mock.memory == V4L2_MEMORY_USERPTR);
+		CHECK_FALSE(sink.has_buffer_handle);
+	}
+
+	SECTION("Frames carry the exported dmabuf")
+	{
+		v4l2_fs(xfs)->capture.dmabuf = true;
+
+		REQUIRE(xrt_fs_stream_start(xfs, &sink.base, XRT_FS_CAPTURE_TYPE_TRACKING, 0));
+		sendFrames(1);
+		REQUIRE(sink.waitFor(1));
+		CHECK(xrt_fs_stream_stop(xfs));
+
+		CHECK(mock.memory == V4L2_MEMORY_MMAP);
+		CHECK(sink.has_buffer_handle);
+		CHECK(sink.buffer_handle == mock.exported[0]);
+	}
+
+	xrt_frame_context_destroy_nodes(&xfctx);
+	close(mock.pipe_fds[0]);
+	close(mock.pipe_fds[1]);
+}
@@ -0,0 +1,507 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Lighthouse solver tests, replays a recording of watchman pulses
+ *        through the decoder and the solver and compares with the truth.
+ * @author agent <agent@local>
+ */
+
+#include "math/m_api.h"
+#include "math/m_mathinclude.h"
+#include "math/m_vec3.h"
+#include "os/os_time.h"
+#include "util/u_time.h"
+#include "vive/vive_config.h"
+
+extern "C" {
+#include "vive/vive_lighthouse.h"
+}
+#include "vive/vive_lighthouse_solver.h"
+
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <vector>
+
+
+static constexpr uint32_t sensor_count = 20;
+static constexpr uint32_t sync_period = 400000;
+static constexpr uint32_t imu_period = 48000; // 1 ms
+static constexpr double ns_per_tick = 1e9 / 48e6;
+
+//! The device holds still this long, the first solve defines the tracking space.
+static constexpr double still_s = 0.5;
+
+namespace {
+
+/*!
+ * Something the watchman or the IMU reported, in the order of the watchman clock.
+ */
+struct Event
+{
+	uint32_t ticks;
+	bool imu;
+	uint8_t id;
+	uint16_t duration;
+};
+
+struct BaseStation
+{
+	struct xrt_pose pose;
+	//! Channel offset of the sync pulse, 0 for B and 20000 for C.
+	uint32_t sync_offset;
+};
+
+/*!
+ * Sensors spread over the front of a sphere, roughly like a headset.
+ */
+std::vector<struct lh_sensor>
+make_sensors()
+{
+	std::vector<struct lh_sensor> sensors(sensor_count);
+
+	for (uint32_t i = 0; i < sensor_count; i++) {
+		double theta = (-80.0 + 160.0 * i / (sensor_count - 1)) * M_PI / 180.0;
+		double phi = ((i % 2) ? 25.0 : -25.0) * M_PI / 180.0;
+
+		struct xrt_vec3 dir = {
+		    (float)(sin(theta) * cos(phi)),
+		    (float)sin(phi),
+		    (float)(-cos(theta) * cos(phi)),
+		};
+
+		sensors[i] = {};
+		sensors[i].pos = m_vec3_mul_scalar(dir, 0.09f);
+		sensors[i].normal = dir;
+	}
+
+	return sensors;
+}
+
+//! A base station at @p position looking at the origin, down its own -Z.
+struct xrt_pose
+make_base_pose(struct xrt_vec3 position)
+{
+	struct xrt_vec3 plus_z = m_vec3_normalize(position);
+	struct xrt_vec3 up = {0.0f, 1.0f, 0.0f};
+	struct xrt_vec3 plus_x;
+	math_vec3_cross(&up, &plus_z, &plus_x);
+	plus_x = m_vec3_normalize(plus_x);
+
+	struct xrt_pose pose;
+	pose.position = position;
+	math_quat_from_plus_x_z(&plus_x, &plus_z, &pose.orientation);
+
+	return pose;
+}
+
+//! Where the device truly is, still at the origin at first and then moving slowly.
+struct xrt_pose
+true_pose(double t)
+{
+	double m = t > still_s ? t - still_s : 0.0;
+
+	struct xrt_pose pose;
+	pose.position.x = (float)(0.15 * sin(0.8 * m));
+	pose.position.y = (float)(0.05 * sin(1.1 * m));
+	pose.position.z = (float)(0.10 * sin(0.6 * m));
+
+	struct xrt_quat yaw;
+	struct xrt_quat pitch;
+	struct xrt_vec3 y_axis = {0.0f, 1.0f, 0.0f};
+	struct xrt_vec3 x_axis = {1.0f, 0.0f, 0.0f};
+	math_quat_from_angle_vector((float)(0.3 * sin(0.5 * m)), &y_axis, &yaw);
+	math_quat_from_angle_vector((float)(0.1 * sin(0.7 * m)), &x_axis, &pitch);
+	math_quat_rotate(&yaw, &pitch, &pose.orientation);
+
+	return pose;
+}
+
+//! The IMU 3DoF fusion, which drifts slowly in yaw once the device moves.
+struct xrt_quat
+imu_rot(double t)
+{
+	double m = t > still_s ? t - still_s : 0.0;
+
+	struct xrt_quat drift;
+	struct xrt_vec3 y_axis = {0.0f, 1.0f, 0.0f};
+	math_quat_from_angle_vector((float)(0.02 * m), &y_axis, &drift);
+
+	struct xrt_pose pose = true_pose(t);
+	struct xrt_quat rot;
+	math_quat_rotate(&drift, &pose.orientation, &rot);
+
+	return rot;
+}
+
+float
+angle_between(const struct xrt_quat &a, const struct xrt_quat &b)
+{
+	float dot = fabsf(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+	return 2.0f * acosf(std::min(dot, 1.0f));
+}
+
+/*!
+ * Sweep offset at which the laser plane of @p rotor of a base station at
+ * @p base passes through a point, @p point_at gives the point in world space
+ * at an offset. The plane is turned until the point changes side, so nothing
+ * is shared with how the solver projects points into angles.
+ *
+ * The first rotor turns its plane about the Y axis of the base station and
+ * the second about the X axis, both are in the -Z direction at the center.
+ */
+template <typename PointAt>
+double
+plane_crossing_offset(const struct xrt_pose &base, uint32_t rotor, PointAt point_at)
+{
+	struct xrt_pose inv_base;
+	math_pose_invert(&base, &inv_base);
+
+	auto side = [&](double offset) {
+		double turned = (offset - LIGHTHOUSE_TICKS_CENTER) / LIGHTHOUSE_TICKS_PER_REVOLUTION * 2.0 * M_PI;
+		struct xrt_vec3 world = point_at(offset);
+		struct xrt_vec3 p;
+		math_pose_transform_point(&inv_base, &world, &p);
+
+		// Normal of the plane, it starts out along the axis that the plane sweeps over.
+		double across = rotor == 0 ? p.x : p.y;
+		return across * cos(turned) + p.z * sin(turned);
+	};
+
+	// Quarter of a turn either side of the center, the point is in front of the base station.
+	double lo = LIGHTHOUSE_TICKS_CENTER - LIGHTHOUSE_TICKS_PER_REVOLUTION / 4.0;
+	double hi = LIGHTHOUSE_TICKS_CENTER + LIGHTHOUSE_TICKS_PER_REVOLUTION / 4.0;
+	for (int i = 0; i < 48; i++) {
+		double mid = (lo + hi) / 2.0;
+		if (side(mid) > 0.0) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return (lo + hi) / 2.0;
+}
+
+/*!
+ * Generates the pulses a watchman sees, with sync floods and sweeps in the
+ * LH1 timing, and IMU samples every millisecond.
+ */
+struct Recording
+{
+	std::vector<struct lh_sensor> sensors = make_sensors();
+	std::vector<BaseStation> bases;
+	uint32_t start_ticks = 1000000;
+	timepoint_ns start_ns = 1000 * U_TIME_1MS_IN_NS;
+
+	//! Only these sensors ever see the lasers.
+	uint32_t sensor_mask = ~0u;
+
+	double
+	ticks_to_s(uint32_t ticks) const
+	{
+		return (ticks - start_ticks) * ns_per_tick / 1e9;
+	}
+
+	//! Find the sweeps by turning the laser planes instead of from the angle of each sensor.
+	bool turn_rotors = false;
+
+	bool
+	visible(const BaseStation &base, const struct xrt_pose &device, uint32_t id) const
+	{
+		if ((sensor_mask & (1u << id)) == 0) {
+			return false;
+		}
+
+		struct xrt_vec3 p;
+		struct xrt_vec3 normal;
+		math_pose_transform_point(&device, &sensors[id].pos, &p);
+		math_quat_rotate_vec3(&device.orientation, &sensors[id].normal, &normal);
+
+		return m_vec3_dot(normal, base.pose.position - p) > 0.0f;
+	}
+
+	//! Angle of @p id in the sweep of @p rotor, the same model the solver uses.
+	double
+	sweep_angle(const BaseStation &base, const struct xrt_pose &device, uint32_t id, uint32_t rotor) const
+	{
+		struct xrt_pose inv_base;
+		struct xrt_vec3 world;
+		struct xrt_vec3 p;
+		math_pose_invert(&base.pose, &inv_base);
+		math_pose_transform_point(&device, &sensors[id].pos, &world);
+		math_pose_transform_point(&inv_base, &world, &p);
+
+		return rotor == 0 ? atan2(p.x, -p.z) : atan2(p.y, -p.z);
+	}
+
+	void
+	add_sweeps(std::vector<Event> &events, const BaseStation &base, uint32_t sync_ticks, uint32_t rotor, uint32_t k)
+	{
+		for (uint32_t id = 0; id < sensor_count; id++) {
+			uint16_t duration = (uint16_t)(150 + (id % 5) * 20);
+
+			double offset = LIGHTHOUSE_TICKS_CENTER;
+			struct xrt_pose device;
+			if (turn_rotors) {
+				offset = plane_crossing_offset(base.pose, rotor, [&](double at) {
+					struct xrt_pose moved = true_pose(ticks_to_s(sync_ticks + (uint32_t)at));
+					struct xrt_vec3 world;
+					math_pose_transform_point(&moved, &sensors[id].pos, &world);
+					return world;
+				});
+				device = true_pose(ticks_to_s(sync_ticks + (uint32_t)offset));
+			} else {
+				// Refine the time the laser crosses the sensor once.
+				for (int i = 0; i < 2; i++) {
+					device = true_pose(ticks_to_s(sync_ticks + (uint32_t)offset));
+					double angle = sweep_angle(base, device, id, rotor);
+					double ticks_per_rad = LIGHTHOUSE_TICKS_PER_REVOLUTION / (2.0 * M_PI);
+					offset = LIGHTHOUSE_TICKS_CENTER + angle * ticks_per_rad;
+				}
+			}
+
+			if (!visible(base, device, id)) {
+				continue;
+			}
+
+			// A couple of ticks of timing noise.
+			int32_t noise = (int32_t)((k * 7 + id * 13) % 5) - 2;
+			uint32_t start = (uint32_t)(offset - duration / 2.0) + noise;
+			events.push_back({sync_ticks + start, false, (uint8_t)id, duration});
+		}
+	}
+
+	void
+	add_sync(std::vector<Event> &events, const BaseStation &base, uint32_t sync_ticks, uint32_t code)
+	{
+		struct xrt_pose device = true_pose(ticks_to_s(sync_ticks));
+		for (uint32_t id = 0; id < sensor_count; id++) {
+			if (visible(base, device, id)) {
+				events.push_back({sync_ticks, false, (uint8_t)id, (uint16_t)(3000 + 500 * code)});
+			}
+		}
+	}
+
+	/*!
+	 * With one base it sweeps every period, alternating rotors. With two
+	 * both send syncs every period but they take turns sweeping.
+	 */
+	std::vector<Event>
+	generate(double seconds)
+	{
+		std::vector<Event> events;
+		uint32_t periods = (uint32_t)(seconds * 120.0);
+
+		for (uint32_t k = 0; k < periods; k++) {
+			uint32_t period_ticks = start_ticks + k * sync_period;
+
+			for (uint32_t b = 0; b < bases.size(); b++) {
+				uint32_t active = bases.size() == 1 ? k : k / 2;
+				uint32_t next = bases.size() == 1 ? k + 1 : (k + 1) / 2;
+				bool sweeping = bases.size() == 1 || (k % 2) == b;
+
+				uint32_t sync_ticks = period_ticks + bases[b].sync_offset;
+				uint32_t rotor = (sweeping ? active : next) % 2;
+				uint32_t code = (sweeping ? 0 : 4) | rotor;
+
+				add_sync(events, bases[b], sync_ticks, code);
+				if (sweeping) {
+					add_sweeps(events, bases[b], sync_ticks, rotor, k);
+				}
+			}
+		}
+
+		uint32_t end_ticks = start_ticks + periods * sync_period;
+		for (uint32_t ticks = start_ticks; ticks < end_ticks; ticks += imu_period) {
+			events.push_back({ticks, true, 0, 0});
+		}
+
+		std::stable_sort(events.begin(), events.end(),
+		                 [](const Event &a, const Event &b) { return a.ticks < b.ticks; });
+
+		return events;
+	}
+};
+
+struct ReplayResult
+{
+	struct lighthouse_solver_stats stats;
+	double max_position_error = 0.0;
+	double max_angle_error = 0.0;
+	uint32_t checked = 0;
+	uint32_t without_position = 0;
+};
+
+/*!
+ * Feeds the recording to the decoder and the solver, like the watchman and
+ * IMU threads of the driver, and compares every fused pose after @p settle_s.
+ */
+ReplayResult
+replay(Recording &recording, double seconds, double settle_s)
+{
+	std::vector<Event> events = recording.generate(seconds);
+
+	struct lighthouse_solver *solver =
+	    lighthouse_solver_create(recording.sensors.data(), (uint32_t)recording.sensors.size());
+	REQUIRE(solver != nullptr);
+
+	struct lighthouse_watchman watchman = {};
+	lighthouse_watchman_init(&watchman, "test");
+	watchman.solver = solver;
+
+	ReplayResult result;
+	std::vector<struct xrt_space_relation> relations;
+	std::vector<uint32_t> relation_ticks;
+	relations.reserve(events.size());
+	relation_ticks.reserve(events.size());
+
+	for (const Event &e : events) {
+		if (!e.imu) {
+			lighthouse_watchman_handle_pulse(&watchman, e.id, e.duration, e.ticks);
+			continue;
+		}
+
+		timepoint_ns ts = recording.start_ns + (timepoint_ns)((e.ticks - recording.start_ticks) * ns_per_tick);
+		struct xrt_quat rot = imu_rot(recording.ticks_to_s(e.ticks));
+
+		struct xrt_space_relation rel;
+		lighthouse_solver_push_imu(solver, e.ticks, ts, &rot, &rel);
+		relations.push_back(rel);
+		relation_ticks.push_back(e.ticks);
+	}
+
+	lighthouse_solver_get_stats(solver, &result.stats);
+	lighthouse_solver_destroy(&solver);
+	CHECK(solver == nullptr);
+
+	for (size_t i = 0; i < relations.size(); i++) {
+		double t = recording.ticks_to_s(relation_ticks[i]);
+		if (t < settle_s) {
+			continue;
+		}
+
+		const struct xrt_space_relation &rel = relations[i];
+		if ((rel.relation_flags & XRT_SPACE_RELATION_POSITION_VALID_BIT) == 0) {
+			result.without_position++;
+			continue;
+		}
+
+		struct xrt_pose truth = true_pose(t);
+		double position_error = m_vec3_len(rel.pose.position - truth.position);
+		double angle_error = angle_between(rel.pose.orientation, truth.orientation);
+
+		result.max_position_error = std::max(result.max_position_error, position_error);
+		result.max_angle_error = std::max(result.max_angle_error, angle_error);
+		result.checked++;
+	}
+
+	return result;
+}
+
+} // namespace
+
+
+TEST_CASE("lighthouse_solver")
+{
+	Recording recording;
+
+	SECTION("single base station")
+	{
+		recording.bases.push_back({make_base_pose({0.3f, 0.6f, -2.5f}), 0});
+
+		ReplayResult result = replay(recording, 4.0, 1.5);
+
+		CHECK(result.stats.base_known[0]);
+		CHECK_FALSE(result.stats.base_known[1]);
+		CHECK(result.stats.solves > 300);
+		CHECK(result.stats.last_residual < 1e-3f);
+		CHECK(result.checked > 2000);
+		CHECK(result.without_position == 0);
+
+		// The yaw drift of the IMU is corrected as well.
+		CHECK(result.max_position_error < 0.01);
+		CHECK(result.max_angle_error < 1.0 * M_PI / 180.0);
+	}
+
+	SECTION("two base stations")
+	{
+		recording.bases.push_back({make_base_pose({0.3f, 0.6f, -2.5f}), 0});
+		recording.bases.push_back({make_base_pose({-2.0f, 0.5f, -1.2f}), 20000});
+
+		ReplayResult result = replay(recording, 4.0, 1.5);
+
+		CHECK(result.stats.base_known[0]);
+		CHECK(result.stats.base_known[1]);
+		CHECK(result.stats.solves > 300);
+		CHECK(result.checked > 2000);
+		CHECK(result.without_position == 0);
+
+		CHECK(result.max_position_error < 0.01);
+		CHECK(result.max_angle_error < 1.0 * M_PI / 180.0);
+	}
+
+	SECTION("too few sensors")
+	{
+		recording.bases.push_back({make_base_pose({0.3f, 0.6f, -2.5f}), 0});
+		recording.sensor_mask = 0x7;
+
+		ReplayResult result = replay(recording, 1.0, 0.0);
+
+		CHECK(result.stats.sweeps > 0);
+		CHECK(result.stats.solves == 0);
+		CHECK(result.stats.rejected > 0);
+		CHECK_FALSE(result.stats.base_known[0]);
+		CHECK(result.checked == 0);
+		CHECK(result.without_position > 900);
+	}
+}
+
+TEST_CASE("lighthouse_solver_turning_rotors")
+{
+	const struct xrt_pose at_origin = XRT_POSE_IDENTITY;
+	const double ticks_per_degree = LIGHTHOUSE_TICKS_PER_REVOLUTION / 360.0;
+
+	SECTION("plane crossings")
+	{
+		// 45 degrees to the right, and 30 degrees down.
+		struct xrt_vec3 right = {1.0f, 0.0f, -1.0f};
+		struct xrt_vec3 down = {0.0f, -1.0f, (float)-sqrt(3.0)};
+
+		double right_offset = plane_crossing_offset(at_origin, 0, [&](double) { return right; });
+		double down_offset = plane_crossing_offset(at_origin, 1, [&](double) { return down; });
+
+		CHECK(right_offset == Approx(LIGHTHOUSE_TICKS_CENTER + 45.0 * ticks_per_degree).margin(0.01));
+		CHECK(down_offset == Approx(LIGHTHOUSE_TICKS_CENTER - 30.0 * ticks_per_degree).margin(0.01));
+
+		// The horizontal sweep doesn't care about height, nor the vertical one about sideways.
+		double right_high = plane_crossing_offset(at_origin, 0, [&](double) {
+			return xrt_vec3{1.0f, 0.7f, -1.0f};
+		});
+		double down_aside = plane_crossing_offset(at_origin, 1, [&](double) {
+			return xrt_vec3{0.6f, -1.0f, (float)-sqrt(3.0)};
+		});
+
+		CHECK(right_high == Approx(right_offset).margin(0.01));
+		CHECK(down_aside == Approx(down_offset).margin(0.01));
+	}
+
+	SECTION("replay")
+	{
+		Recording recording;
+		recording.turn_rotors = true;
+		recording.bases.push_back({make_base_pose({0.3f, 0.6f, -2.5f}), 0});
+		recording.bases.push_back({make_base_pose({-2.0f, 0.5f, -1.2f}), 20000});
+
+		ReplayResult result = replay(recording, 4.0, 1.5);
+
+		CHECK(result.stats.base_known[0]);
+		CHECK(result.stats.base_known[1]);
+		CHECK(result.checked > 2000);
+		CHECK(result.without_position == 0);
+
+		CHECK(result.max_position_error < 0.01);
+		CHECK(result.max_angle_error < 1.0 * M_PI / 180.0);
+	}
+}
@@ -0,0 +1,179 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief WMR display bring-up tests, the companion device and the udev
+ *        display watch are mocked and signal readiness at set times.
+ * @author agent <agent@local>
+ */
+
+#include "os/os_hid.h"
+#include "os/os_time.h"
+#include "util/u_misc.h"
+#include "wmr/wmr_hmd.h"
+
+#include "catch/catch.hpp"
+
+#include <string.h>
+
+#include <deque>
+
+
+static constexpr uint64_t timeout_ns = 4000 * (uint64_t)U_TIME_1MS_IN_NS;
+static constexpr uint64_t short_timeout_ns = 100 * (uint64_t)U_TIME_1MS_IN_NS;
+static constexpr uint64_t quick_ns = 1000 * (uint64_t)U_TIME_1MS_IN_NS;
+
+namespace {
+
+/*!
+ * A status report from the companion device, handed out once its time has come.
+ */
+struct Report
+{
+	uint64_t at_ns;
+	bool display_ready;
+};
+
+/*!
+ * Stands in for the companion device, only reads are used.
+ */
+struct MockHid
+{
+	struct os_hid_device base = {};
+	std::deque<Report> reports;
+	uint64_t start_ns = 0;
+
+	MockHid()
+	{
+		base.read = read;
+		base.destroy = destroy;
+		start_ns = os_monotonic_get_ns();
+	}
+
+	static int
+	read(struct os_hid_device *hid_dev, uint8_t *data, size_t size, int milliseconds)
+	{
+		auto *mock = (MockHid *)hid_dev;
+		uint64_t now_ns = os_monotonic_get_ns();
+		uint64_t until_ns = now_ns + (uint64_t)milliseconds * U_TIME_1MS_IN_NS;
+
+		if (!mock->reports.empty()) {
+			uint64_t at_ns = mock->start_ns + mock->reports.front().at_ns;
+			if (at_ns < until_ns) {
+				until_ns = at_ns;
+			}
+		}
+
+		if (until_ns > now_ns) {
+			os_nanosleep((int64_t)(until_ns - now_ns));
+		}
+
+		if (mock->reports.empty() || mock->start_ns + mock->reports.front().at_ns > os_monotonic_get_ns()) {
+			return 0;
+		}
+
+		Report report = mock->reports.front();
+		mock->reports.pop_front();
+
+		// Same layout as seen from the HMD, 05 xx 01 01 xx ...
+		memset(data, 0, size);
+		data[0] = WMR_CONTROL_MSG_DEVICE_STATUS;
+		data[1] = report.display_ready ? 1 : 0;
+		data[2] = 1;
+		data[3] = 1;
+		data[4] = report.display_ready ? 1 : 0;
+
+		return 11;
+	}
+
+	static void
+	destroy(struct os_hid_device *hid_dev)
+	{
+		// Owned by the test.
+	}
+};
+
+/*!
+ * Stands in for the udev monitor, signals after a set time.
+ */
+struct MockWatch
+{
+	struct wmr_display_watch base = {};
+	uint64_t at_ns;
+	uint64_t start_ns;
+
+	MockWatch(uint64_t at_ns) : at_ns(at_ns)
+	{
+		base.poll = poll;
+		base.destroy = destroy;
+		start_ns = os_monotonic_get_ns();
+	}
+
+	static bool
+	poll(struct wmr_display_watch *wdw)
+	{
+		auto *mock = (MockWatch *)wdw;
+		return os_monotonic_get_ns() >= mock->start_ns + mock->at_ns;
+	}
+
+	static void
+	destroy(struct wmr_display_watch *wdw)
+	{
+		// Owned by the test.
+	}
+};
+
+} // namespace
+
+TEST_CASE("wmr_display_ready")
+{
+	struct wmr_hmd *wh = U_TYPED_CALLOC(struct wmr_hmd);
+	REQUIRE(os_mutex_init(&wh->hid_lock) == 0);
+	wh->log_level = U_LOGGING_WARN;
+
+	MockHid hid;
+	wh->hid_control_dev = &hid.base;
+
+	uint64_t start_ns = os_monotonic_get_ns();
+
+	SECTION("Done as soon as the HMD reports the display ready")
+	{
+		hid.reports.push_back({20 * (uint64_t)U_TIME_1MS_IN_NS, false});
+		hid.reports.push_back({50 * (uint64_t)U_TIME_1MS_IN_NS, true});
+
+		CHECK(wmr_hmd_wait_for_display(wh, NULL, timeout_ns));
+		CHECK(wh->display_ready);
+		CHECK(os_monotonic_get_ns() - start_ns < quick_ns);
+		CHECK(hid.reports.empty());
+	}
+
+	SECTION("Done as soon as the host sees a new display")
+	{
+		MockWatch watch(50 * (uint64_t)U_TIME_1MS_IN_NS);
+
+		CHECK(wmr_hmd_wait_for_display(wh, &watch.base, timeout_ns));
+		CHECK_FALSE(wh->display_ready);
+		CHECK(os_monotonic_get_ns() - start_ns < quick_ns);
+	}
+
+	SECTION("The first status report is not enough")
+	{
+		hid.reports.push_back({20 * (uint64_t)U_TIME_1MS_IN_NS, false});
+
+		CHECK_FALSE(wmr_hmd_wait_for_display(wh, NULL, short_timeout_ns));
+		CHECK_FALSE(wh->display_ready);
+		CHECK(hid.reports.empty());
+	}
+
+	SECTION("Gives up at the timeout")
+	{
+		MockWatch watch(timeout_ns);
+
+		CHECK_FALSE(wmr_hmd_wait_for_display(wh, &watch.base, short_timeout_ns));
+		CHECK(os_monotonic_get_ns() - start_ns >= short_timeout_ns);
+		CHECK(os_monotonic_get_ns() - start_ns < quick_ns);
+	}
+
+	os_mutex_destroy(&wh->hid_lock);
+	free(wh);
+}
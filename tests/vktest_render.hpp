@@ -0,0 +1,372 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Runs the compute renderer on a Vulkan device, lavapipe is enough,
+ *        so tests can check the images that the shaders produce.
+ * @author agent <agent@local>
+ */
+#pragma once
+
+#include "vktest_init_bundle.hpp"
+
+#include "xrt/xrt_device.h"
+#include "util/u_device.h"
+#include "util/u_distortion_mesh.h"
+#include "render/render_interface.h"
+
+#include "catch/catch.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+
+/*!
+ * An image on the device together with a host visible buffer of the same
+ * size, used both to upload into the image and to read it back.
+ */
+struct VkTestImage
+{
+	VkExtent2D extent{};
+	VkFormat format{VK_FORMAT_UNDEFINED};
+	uint32_t texel_size{0};
+
+	VkDeviceMemory memory{VK_NULL_HANDLE};
+	VkImage image{VK_NULL_HANDLE};
+	VkImageView view{VK_NULL_HANDLE};
+
+	struct render_buffer buffer{};
+
+	VkDeviceSize
+	byteSize() const
+	{
+		return (VkDeviceSize)extent.width * extent.height * texel_size;
+	}
+
+	//! The texel at @p x, @p y of the buffer, after an upload or read back.
+	template <typename T>
+	T *
+	texel(uint32_t x, uint32_t y) const
+	{
+		return (T *)((uint8_t *)buffer.mapped + ((size_t)y * extent.width + x) * texel_size);
+	}
+};
+
+/*!
+ * Owns a Vulkan bundle, a headset with no distortion and the shaders,
+ * resources and compute renderer that the main compositor would create.
+ *
+ * Record with @ref begin, the render_compute functions on @ref crc and then
+ * @ref endAndReadBack, which waits for the device.
+ */
+struct VkTestRender
+{
+	unique_vk_bundle vk_storage{makeVkBundle()};
+	struct vk_bundle *vk{vk_storage.get()};
+
+	struct xrt_device *xdev{nullptr};
+
+	bool shaders_loaded{false};
+	struct render_shaders shaders{};
+	struct render_resources r{};
+	struct render_compute crc{};
+
+	std::vector<std::unique_ptr<VkTestImage>> images;
+
+
+	/*!
+	 * Both views of the headset get @p fov, the distortion images map each
+	 * view uv straight to the same source uv.
+	 */
+	bool
+	init(const struct xrt_fov &fov)
+	{
+		if (!vktest_init_bundle(vk)) {
+			return false;
+		}
+
+		xdev = U_DEVICE_ALLOCATE(struct xrt_device, U_DEVICE_ALLOC_HMD, 1, 0);
+		for (uint32_t i = 0; i < 2; i++) {
+			xdev->hmd->distortion.fov[i] = fov;
+			xdev->hmd->views[i].rot = u_device_rotation_ident;
+		}
+		u_distortion_mesh_set_none(xdev);
+
+		shaders_loaded = render_shaders_load(&shaders, vk);
+
+		return shaders_loaded &&                                       //
+		       render_resources_init(&r, &shaders, vk, xdev) &&        //
+		       render_distortion_images_ensure(&r, vk, xdev, false) && //
+		       render_compute_init(&crc, &r);
+	}
+
+	~VkTestRender()
+	{
+		if (vk->device != VK_NULL_HANDLE) {
+			vk->vkDeviceWaitIdle(vk->device);
+		}
+
+		for (std::unique_ptr<VkTestImage> &img : images) {
+			render_buffer_close(vk, &img->buffer);
+			vk->vkDestroyImageView(vk->device, img->view, NULL);
+			vk->vkDestroyImage(vk->device, img->image, NULL);
+			vk->vkFreeMemory(vk->device, img->memory, NULL);
+		}
+
+		if (crc.r != NULL) {
+			render_compute_close(&crc);
+		}
+		render_resources_close(&r);
+		if (shaders_loaded) {
+			render_shaders_close(&shaders, vk);
+		}
+		if (xdev != nullptr) {
+			u_device_free(xdev);
+		}
+	}
+
+	//! Can images of @p format be sampled with linear filtering and, if @p storage, written by the shaders.
+	bool
+	supportsFormat(VkFormat format, bool storage) const
+	{
+		VkFormatProperties props{};
+		vk->vkGetPhysicalDeviceFormatProperties(vk->physical_device, format, &props);
+
+		VkFormatFeatureFlags wanted = storage ? VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT //
+		                                      : VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+		return (props.optimalTilingFeatures & wanted) == wanted;
+	}
+
+	/*!
+	 * Creates an image that can be uploaded to and read back, add
+	 * VK_IMAGE_USAGE_SAMPLED_BIT or VK_IMAGE_USAGE_STORAGE_BIT to @p usage.
+	 */
+	VkTestImage &
+	createImage(uint32_t width, uint32_t height, VkFormat format, uint32_t texel_size, VkImageUsageFlags usage)
+	{
+		images.emplace_back(new VkTestImage{});
+		VkTestImage &img = *images.back();
+
+		img.extent = {width, height};
+		img.format = format;
+		img.texel_size = texel_size;
+
+		usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		REQUIRE(vk_create_image_simple(vk, img.extent, format, usage, &img.memory, &img.image) == VK_SUCCESS);
+		REQUIRE(vk_create_view(vk, img.image, VK_IMAGE_VIEW_TYPE_2D, format, colorRange(), &img.view) ==
+		        VK_SUCCESS);
+
+		VkBufferUsageFlags buffer_usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		VkMemoryPropertyFlags properties =
+		    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		REQUIRE(render_buffer_init(vk, &img.buffer, buffer_usage, properties, img.byteSize()) == VK_SUCCESS);
+		REQUIRE(render_buffer_map(vk, &img.buffer) == VK_SUCCESS);
+
+		return img;
+	}
+
+	//! Copies tightly packed texels into @p img and leaves it ready for sampling.
+	void
+	upload(VkTestImage &img, const void *data)
+	{
+		memcpy(img.buffer.mapped, data, img.byteSize());
+
+		VkCommandBuffer cmd = VK_NULL_HANDLE;
+		REQUIRE(vk_cmd_create_and_begin_cmd_buffer_locked(vk, r.cmd_pool, 0, &cmd) == VK_SUCCESS);
+
+		vk_cmd_image_barrier_locked(              //
+		    vk,                                   // vk_bundle
+		    cmd,                                  // cmd_buffer
+		    img.image,                            // image
+		    0,                                    // src_access_mask
+		    VK_ACCESS_TRANSFER_WRITE_BIT,         // dst_access_mask
+		    VK_IMAGE_LAYOUT_UNDEFINED,            // old_image_layout
+		    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // new_image_layout
+		    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,    // src_stage_mask
+		    VK_PIPELINE_STAGE_TRANSFER_BIT,       // dst_stage_mask
+		    colorRange());                        // subresource_range
+
+		VkBufferImageCopy region = copyRegion(img);
+		vk->vkCmdCopyBufferToImage(               //
+		    cmd,                                  // commandBuffer
+		    img.buffer.buffer,                    // srcBuffer
+		    img.image,                            // dstImage
+		    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // dstImageLayout
+		    1,                                    // regionCount
+		    &region);                             // pRegions
+
+		vk_cmd_image_barrier_locked(                  //
+		    vk,                                       // vk_bundle
+		    cmd,                                      // cmd_buffer
+		    img.image,                                // image
+		    VK_ACCESS_TRANSFER_WRITE_BIT,             // src_access_mask
+		    VK_ACCESS_SHADER_READ_BIT,                // dst_access_mask
+		    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,     // old_image_layout
+		    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, // new_image_layout
+		    VK_PIPELINE_STAGE_TRANSFER_BIT,           // src_stage_mask
+		    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,     // dst_stage_mask
+		    colorRange());                            // subresource_range
+
+		REQUIRE(vk_cmd_end_submit_wait_and_free_cmd_buffer_locked(vk, r.cmd_pool, cmd) == VK_SUCCESS);
+	}
+
+	void
+	begin()
+	{
+		REQUIRE(render_compute_begin(&crc));
+	}
+
+	/*!
+	 * Copies @p target, left in @p layout by the renderer, into its buffer,
+	 * then submits everything recorded since @ref begin and waits for it.
+	 */
+	void
+	endAndReadBack(VkTestImage &target, VkImageLayout layout)
+	{
+		vk_cmd_image_barrier_locked(              //
+		    vk,                                   // vk_bundle
+		    r.cmd,                                // cmd_buffer
+		    target.image,                         // image
+		    VK_ACCESS_SHADER_WRITE_BIT,           // src_access_mask
+		    VK_ACCESS_TRANSFER_READ_BIT,          // dst_access_mask
+		    layout,                               // old_image_layout
+		    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, // new_image_layout
+		    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // src_stage_mask
+		    VK_PIPELINE_STAGE_TRANSFER_BIT,       // dst_stage_mask
+		    colorRange());                        // subresource_range
+
+		VkBufferImageCopy region = copyRegion(target);
+		vk->vkCmdCopyImageToBuffer(               //
+		    r.cmd,                                // commandBuffer
+		    target.image,                         // srcImage
+		    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, // srcImageLayout
+		    target.buffer.buffer,                 // dstBuffer
+		    1,                                    // regionCount
+		    &region);                             // pRegions
+
+		VkMemoryBarrier to_host = {};
+		to_host.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		to_host.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		to_host.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+		vk->vkCmdPipelineBarrier(           //
+		    r.cmd,                          // commandBuffer
+		    VK_PIPELINE_STAGE_TRANSFER_BIT, // srcStageMask
+		    VK_PIPELINE_STAGE_HOST_BIT,     // dstStageMask
+		    0,                              // dependencyFlags
+		    1,                              // memoryBarrierCount
+		    &to_host,                       // pMemoryBarriers
+		    0,                              // bufferMemoryBarrierCount
+		    NULL,                           // pBufferMemoryBarriers
+		    0,                              // imageMemoryBarrierCount
+		    NULL);                          // pImageMemoryBarriers
+
+		REQUIRE(render_compute_end(&crc));
+
+		VkSubmitInfo submit_info = {};
+		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit_info.commandBufferCount = 1;
+		submit_info.pCommandBuffers = &r.cmd;
+		REQUIRE(vk_cmd_submit_locked(vk, 1, &submit_info, VK_NULL_HANDLE) == VK_SUCCESS);
+
+		os_mutex_lock(&vk->queue_mutex);
+		VkResult ret = vk->vkQueueWaitIdle(vk->queue);
+		os_mutex_unlock(&vk->queue_mutex);
+		REQUIRE(ret == VK_SUCCESS);
+	}
+
+	//! Layout that @ref computeLayers leaves the target in.
+	static constexpr VkImageLayout layers_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	/*!
+	 * Records the layer shader into @p target for the layers in the UBO,
+	 * @p views are the images that the UBO indexes, sampled clamped to the
+	 * edge, the rest of the image array gets the mock image.
+	 */
+	void
+	computeLayers(const std::vector<VkImageView> &views, VkTestImage &target, bool timewarp)
+	{
+		uint32_t image_count = r.compute.layer.image_array_size;
+		REQUIRE(views.size() <= image_count);
+
+		VkSampler samplers[COMP_MAX_IMAGES];
+		VkImageView image_views[COMP_MAX_IMAGES];
+		for (uint32_t i = 0; i < image_count; i++) {
+			samplers[i] = r.samplers.clamp_to_edge;
+			image_views[i] = i < views.size() ? views[i] : r.mock.color.image_view;
+		}
+
+		render_compute_layers( //
+		    &crc,              //
+		    samplers,          //
+		    image_views,       //
+		    image_count,       //
+		    target.image,      //
+		    target.view,       //
+		    layers_layout,     //
+		    timewarp);         //
+	}
+
+	//! The layer UBO, filled in by the test before calling render_compute_layers.
+	struct render_compute_layer_ubo_data *
+	layerUbo()
+	{
+		return (struct render_compute_layer_ubo_data *)r.compute.layer.ubo.mapped;
+	}
+
+	/*!
+	 * Resets the layer UBO for two side by side views of @p width by
+	 * @p height, with no layers enabled.
+	 */
+	struct render_compute_layer_ubo_data *
+	resetLayerUbo(uint32_t width, uint32_t height)
+	{
+		struct render_compute_layer_ubo_data *ubo = layerUbo();
+		memset(ubo, 0, sizeof(*ubo));
+
+		ubo->views[0] = {0, 0, width, height};
+		ubo->views[1] = {width, 0, width, height};
+		ubo->pre_transforms[0] = r.distortion.uv_to_tanangle[0];
+		ubo->pre_transforms[1] = r.distortion.uv_to_tanangle[1];
+
+		for (uint32_t i = 0; i < COMP_MAX_LAYERS; i++) {
+			ubo->layer_type[i].val = UINT32_MAX;
+		}
+
+		return ubo;
+	}
+
+	static VkImageSubresourceRange
+	colorRange()
+	{
+		VkImageSubresourceRange range = {};
+		range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		range.levelCount = 1;
+		range.layerCount = 1;
+		return range;
+	}
+
+	static VkBufferImageCopy
+	copyRegion(const VkTestImage &img)
+	{
+		VkBufferImageCopy region = {};
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.layerCount = 1;
+		region.imageExtent = {img.extent.width, img.extent.height, 1};
+		return region;
+	}
+};
+
+//! Decodes an sRGB encoded 8 bit value, the layer shader encodes what it writes.
+static inline float
+vktest_srgb_to_linear(uint8_t value)
+{
+	float c = value / 255.0f;
+	if (c <= 0.04045f) {
+		return c / 12.92f;
+	}
+	return std::pow((c + 0.055f) / 1.055f, 2.4f);
+}